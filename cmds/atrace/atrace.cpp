@@ -30,8 +30,13 @@
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <binder/IBinder.h>
 #include <binder/IServiceManager.h>
@@ -285,6 +290,18 @@ static const char* g_outputFile = nullptr;
 static bool g_tracePdx = false;
 static bool g_traceAborted = false;
 static bool g_categoryEnables[arraysize(k_categories)] = {};
+
+// The enable-file set of a category, resolved and validated once at startup so
+// that enabling and disabling categories does not re-stat() /sys for every
+// file on every pass over the category table.
+struct CategoryFiles {
+    // The enable files that are writable with the current rootness.
+    std::vector<const char*> writable;
+
+    // Required enable files that are not writable; enabling the category must fail.
+    std::vector<const char*> missingRequired;
+};
+static CategoryFiles g_categoryFiles[arraysize(k_categories)];
 static std::string g_traceFolder;
 static sp<IAtraceDevice> g_atraceHal;
 static std::vector<TracingVendorCategory> g_vendorCategories;
@@ -434,6 +451,62 @@ static bool setKernelOptionEnable(const char* filename, bool enable)
     return writeStr(filename, enable ? "1" : "0");
 }
 
+// Apply a batch of kernel option writes, spreading them over a few threads.
+// Each write is dominated by the open()/write()/close() syscalls on a control
+// file, so with dozens of categories enabled the sequential loop alone can
+// push trace start beyond our latency budget.
+static bool writeKernelOptionsParallel(const std::vector<std::pair<const char*, bool>>& options)
+{
+    constexpr size_t kMaxThreads = 4;
+    const size_t numThreads = std::min(kMaxThreads, options.size() / 8);
+    if (numThreads <= 1) {
+        bool ok = true;
+        for (const auto& option : options) {
+            ok &= setKernelOptionEnable(option.first, option.second);
+        }
+        return ok;
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (size_t t = 0; t < numThreads; t++) {
+        threads.emplace_back([&]() {
+            for (size_t i; (i = nextIndex.fetch_add(1)) < options.size();) {
+                if (!setKernelOptionEnable(options[i].first, options[i].second)) {
+                    ok = false;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return ok;
+}
+
+// Resolve the enable-file set of every category. This performs the per-file
+// writability checks exactly once, instead of on every pass over the category
+// table while setting up or tearing down a trace.
+static void precompileCategoryFileSets()
+{
+    for (size_t i = 0; i < arraysize(k_categories); i++) {
+        const TracingCategory& c = k_categories[i];
+        for (int j = 0; j < MAX_SYS_FILES; j++) {
+            const char* path = c.sysfiles[j].path;
+            if (path == nullptr) {
+                continue;
+            }
+            if (fileIsWritable(path)) {
+                g_categoryFiles[i].writable.push_back(path);
+            } else if (c.sysfiles[j].required == REQ) {
+                g_categoryFiles[i].missingRequired.push_back(path);
+            }
+        }
+    }
+}
+
 // Check whether the category is supported on the device with the current
 // rootness.  A category is supported only if all its required /sys/ files are
 // writable and if enabling the category will enable one or more tracing tags
@@ -634,17 +707,13 @@ static bool setAppCmdlineProperty(char* cmdline)
 
 // Disable all /sys/ enable files.
 static bool disableKernelTraceEvents() {
-    bool ok = true;
+    std::vector<std::pair<const char*, bool>> writes;
     for (size_t i = 0; i < arraysize(k_categories); i++) {
-        const TracingCategory &c = k_categories[i];
-        for (int j = 0; j < MAX_SYS_FILES; j++) {
-            const char* path = c.sysfiles[j].path;
-            if (path != nullptr && fileIsWritable(path)) {
-                ok &= setKernelOptionEnable(path, false);
-            }
+        for (const char* path : g_categoryFiles[i].writable) {
+            writes.emplace_back(path, false);
         }
     }
-    return ok;
+    return writeKernelOptionsParallel(writes);
 }
 
 // Verify that the comma separated list of functions are being traced by the
@@ -851,23 +920,19 @@ static bool setUpKernelTracing()
     ok &= disableKernelTraceEvents();
 
     // Enable all the sysfs enables that are in an enabled category.
+    std::vector<std::pair<const char*, bool>> enables;
     for (size_t i = 0; i < arraysize(k_categories); i++) {
         if (g_categoryEnables[i]) {
-            const TracingCategory &c = k_categories[i];
-            for (int j = 0; j < MAX_SYS_FILES; j++) {
-                const char* path = c.sysfiles[j].path;
-                bool required = c.sysfiles[j].required == REQ;
-                if (path != nullptr) {
-                    if (fileIsWritable(path)) {
-                        ok &= setKernelOptionEnable(path, true);
-                    } else if (required) {
-                        fprintf(stderr, "error writing file %s\n", path);
-                        ok = false;
-                    }
-                }
+            for (const char* path : g_categoryFiles[i].writable) {
+                enables.emplace_back(path, true);
+            }
+            for (const char* path : g_categoryFiles[i].missingRequired) {
+                fprintf(stderr, "error writing file %s\n", path);
+                ok = false;
             }
         }
     }
+    ok &= writeKernelOptionsParallel(enables);
 
     return ok;
 }
@@ -1079,6 +1144,9 @@ static void showHelp(const char *cmd)
                     "  --async_dump    dump the current contents of circular trace buffer\n"
                     "  --async_stop    stop tracing and dump the current contents of circular\n"
                     "                    trace buffer\n"
+                    "  --daemon        set up the categories once, then read start/stop/dump/quit\n"
+                    "                    commands from stdin; tracing toggles with a single write\n"
+                    "                    to the already open control file\n"
                     "  --stream        stream trace to stdout as it enters the trace buffer\n"
                     "                    Note: this can take significant CPU time, and is best\n"
                     "                    used for measuring things that are not affected by\n"
@@ -1186,6 +1254,82 @@ static bool cleanUpVendorTracing()
     return true;
 }
 
+// Daemon mode: perform the expensive trace configuration once, then hold the
+// tracing_on control file open and service commands from stdin, so that
+// toggling tracing in the field is a single write() on an already open fd
+// rather than a full category setup pass.
+static int runTraceDaemon()
+{
+    bool ok = setUpUserspaceTracing();
+    ok &= setUpKernelTracing();
+    ok &= setUpVendorTracing();
+
+    int tracingOnFd = -1;
+    if (ok) {
+        tracingOnFd = open((g_traceFolder + k_tracingOnPath).c_str(), O_WRONLY);
+        if (tracingOnFd == -1) {
+            fprintf(stderr, "error opening %s: %s (%d)\n", k_tracingOnPath,
+                    strerror(errno), errno);
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        fprintf(stderr, "unable to start tracing\n");
+        cleanUpUserspaceTracing();
+        cleanUpVendorTracing();
+        cleanUpKernelTracing();
+        return 1;
+    }
+
+    printf("ready\n");
+    fflush(stdout);
+
+    char line[64];
+    while (!g_traceAborted && fgets(line, sizeof(line), stdin) != nullptr) {
+        line[strcspn(line, "\n")] = '\0';
+        if (strcmp(line, "start") == 0) {
+            ok = write(tracingOnFd, "1", 1) == 1;
+            // See the comment in main(): the buffer is cleared after enabling
+            // tracing so that no CPU's events predate the others'.
+            ok &= clearTrace();
+            writeClockSyncMarker();
+        } else if (strcmp(line, "stop") == 0) {
+            ok = write(tracingOnFd, "0", 1) == 1;
+        } else if (strcmp(line, "dump") == 0) {
+            int outFd = STDOUT_FILENO;
+            if (g_outputFile) {
+                outFd = open(g_outputFile, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            }
+            if (outFd == -1) {
+                fprintf(stderr, "failed to open '%s', err=%d\n", g_outputFile, errno);
+                ok = false;
+            } else {
+                dprintf(outFd, "TRACE:\n");
+                dumpTrace(outFd);
+                if (g_outputFile) {
+                    close(outFd);
+                }
+                ok = clearTrace();
+            }
+        } else if (strcmp(line, "quit") == 0) {
+            break;
+        } else {
+            fprintf(stderr, "unknown command '%s'\n", line);
+            ok = false;
+        }
+        printf("%s\n", ok ? "ok" : "error");
+        fflush(stdout);
+    }
+
+    close(tracingOnFd);
+    stopTrace();
+    cleanUpUserspaceTracing();
+    cleanUpVendorTracing();
+    cleanUpKernelTracing();
+    return g_traceAborted ? 1 : 0;
+}
+
 int main(int argc, char **argv)
 {
     bool async = false;
@@ -1194,6 +1338,7 @@ int main(int argc, char **argv)
     bool traceDump = true;
     bool traceStream = false;
     bool onlyUserspace = false;
+    bool daemonMode = false;
 
     if (argc == 2 && 0 == strcmp(argv[1], "--help")) {
         showHelp(argv[0]);
@@ -1205,6 +1350,8 @@ int main(int argc, char **argv)
         exit(-1);
     }
 
+    precompileCategoryFileSets();
+
     initVendorCategories();
 
     for (;;) {
@@ -1214,6 +1361,7 @@ int main(int argc, char **argv)
             {"async_start",       no_argument, nullptr,  0 },
             {"async_stop",        no_argument, nullptr,  0 },
             {"async_dump",        no_argument, nullptr,  0 },
+            {"daemon",            no_argument, nullptr,  0 },
             {"only_userspace",    no_argument, nullptr,  0 },
             {"list_categories",   no_argument, nullptr,  0 },
             {"stream",            no_argument, nullptr,  0 },
@@ -1284,6 +1432,8 @@ int main(int argc, char **argv)
                     async = true;
                     traceStart = false;
                     traceStop = false;
+                } else if (!strcmp(long_options[option_index].name, "daemon")) {
+                    daemonMode = true;
                 } else if (!strcmp(long_options[option_index].name, "only_userspace")) {
                     onlyUserspace = true;
                 } else if (!strcmp(long_options[option_index].name, "stream")) {
@@ -1317,6 +1467,15 @@ int main(int argc, char **argv)
         sleep(g_initialSleepSecs);
     }
 
+    if (daemonMode) {
+        if (async || traceStream || onlyUserspace) {
+            fprintf(stderr, "--daemon cannot be combined with --async_*, --stream or "
+                    "--only_userspace\n");
+            exit(1);
+        }
+        return runTraceDaemon();
+    }
+
     bool ok = true;
 
     if (traceStart) {
@@ -18,7 +18,10 @@
 
 #include "DumpPool.h"
 
+#include <inttypes.h>
+
 #include <array>
+#include <chrono>
 #include <thread>
 
 #include <log/log.h>
@@ -59,6 +62,7 @@ DumpPool::~DumpPool() {
         return;
     }
     while (!tasks_.empty()) tasks_.pop();
+    while (!critical_tasks_.empty()) critical_tasks_.pop();
 
     shutdown_ = true;
     condition_variable_.notify_all();
@@ -96,19 +100,52 @@ void DumpPool::setLogDuration(bool log_duration) {
     log_duration_ = log_duration;
 }
 
+namespace {
+
+// Logs a warning if the task ran past its soft time budget. The task is not
+// interrupted; the log is there so over-budget sections show up when chasing
+// slow bugreports.
+class BudgetReporter {
+  public:
+    BudgetReporter(const std::string& title, uint64_t budget_ms)
+        : title_(title), budget_ms_(budget_ms), start_(std::chrono::steady_clock::now()) {
+    }
+
+    ~BudgetReporter() {
+        if (budget_ms_ == 0) {
+            return;
+        }
+        const uint64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start_).count();
+        if (elapsed_ms > budget_ms_) {
+            MYLOGW("Task '%s' exceeded its budget: took %" PRIu64 "ms, budget %" PRIu64 "ms\n",
+                   title_.c_str(), elapsed_ms, budget_ms_);
+        }
+    }
+
+  private:
+    const std::string title_;
+    const uint64_t budget_ms_;
+    const std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace
+
 template <>
 void DumpPool::invokeTask<std::function<void()>>(std::function<void()> dump_func,
-        const std::string& duration_title, int out_fd) {
+        const std::string& duration_title, uint64_t budget_ms, int out_fd) {
     DurationReporter duration_reporter(duration_title, /*logcat_only =*/!log_duration_,
             /*verbose =*/false, out_fd);
+    BudgetReporter budget_reporter(duration_title, budget_ms);
     std::invoke(dump_func);
 }
 
 template <>
 void DumpPool::invokeTask<std::function<void(int)>>(std::function<void(int)> dump_func,
-        const std::string& duration_title, int out_fd) {
+        const std::string& duration_title, uint64_t budget_ms, int out_fd) {
     DurationReporter duration_reporter(duration_title, /*logcat_only =*/!log_duration_,
             /*verbose =*/false, out_fd);
+    BudgetReporter budget_reporter(duration_title, budget_ms);
     std::invoke(dump_func, out_fd);
 }
 
@@ -166,12 +203,13 @@ void DumpPool::setThreadName(const pthread_t thread, int id) {
 void DumpPool::loop() {
     std::unique_lock lock(lock_);
     while (!shutdown_) {
-        if (tasks_.empty()) {
+        if (critical_tasks_.empty() && tasks_.empty()) {
             condition_variable_.wait(lock);
             continue;
         } else {
-            std::packaged_task<std::string()> task = std::move(tasks_.front());
-            tasks_.pop();
+            std::queue<Task>& queue = critical_tasks_.empty() ? tasks_ : critical_tasks_;
+            std::packaged_task<std::string()> task = std::move(queue.front());
+            queue.pop();
             lock.unlock();
             std::invoke(task);
             lock.lock();
@@ -17,6 +17,8 @@
 #ifndef FRAMEWORK_NATIVE_CMD_DUMPPOOL_H_
 #define FRAMEWORK_NATIVE_CMD_DUMPPOOL_H_
 
+#include <stdint.h>
+
 #include <future>
 #include <queue>
 #include <string>
@@ -76,6 +78,14 @@ class DumpPool {
   friend class android::os::dumpstate::DumpPoolTest;
 
   public:
+    /*
+     * Scheduling priority of a task. CRITICAL tasks are dequeued before NORMAL
+     * ones regardless of enqueue order. Sections the main thread waits on
+     * early should be CRITICAL, so that a long NORMAL task does not occupy a
+     * pool thread ahead of them.
+     */
+    enum class TaskPriority { CRITICAL, NORMAL };
+
     /*
      * Creates a thread pool.
      *
@@ -110,9 +120,21 @@ class DumpPool {
      */
     template<class F, class... Args>
     std::future<std::string> enqueueTask(const std::string& duration_title, F&& f, Args&&... args) {
+        return enqueueTask(TaskPriority::NORMAL, /* budget_ms = */ 0, duration_title,
+                std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    /*
+     * As above, with an explicit priority and a soft time budget. A task that
+     * runs longer than |budget_ms| is logged as over budget when it finishes;
+     * a budget of 0 disables the check.
+     */
+    template<class F, class... Args>
+    std::future<std::string> enqueueTask(TaskPriority priority, uint64_t budget_ms,
+            const std::string& duration_title, F&& f, Args&&... args) {
         std::function<void(void)> func = std::bind(std::forward<F>(f),
                 std::forward<Args>(args)...);
-        auto future = post(duration_title, func);
+        auto future = post(priority, budget_ms, duration_title, func);
         if (threads_.empty()) {
             start();
         }
@@ -130,9 +152,20 @@ class DumpPool {
      */
     template<class F, class... Args> std::future<std::string> enqueueTaskWithFd(
             const std::string& duration_title, F&& f, Args&&... args) {
+        return enqueueTaskWithFd(TaskPriority::NORMAL, /* budget_ms = */ 0, duration_title,
+                std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    /*
+     * As above, with an explicit priority and a soft time budget; see
+     * enqueueTask for their semantics.
+     */
+    template<class F, class... Args> std::future<std::string> enqueueTaskWithFd(
+            TaskPriority priority, uint64_t budget_ms, const std::string& duration_title,
+            F&& f, Args&&... args) {
         std::function<void(int)> func = std::bind(std::forward<F>(f),
                 std::forward<Args>(args)...);
-        auto future = post(duration_title, func);
+        auto future = post(priority, budget_ms, duration_title, func);
         if (threads_.empty()) {
             start();
         }
@@ -149,22 +182,28 @@ class DumpPool {
   private:
     using Task = std::packaged_task<std::string()>;
 
-    template<class T> void invokeTask(T dump_func, const std::string& duration_title, int out_fd);
+    template<class T> void invokeTask(T dump_func, const std::string& duration_title,
+            uint64_t budget_ms, int out_fd);
 
     template<class T>
-    std::future<std::string> post(const std::string& duration_title, T dump_func) {
+    std::future<std::string> post(TaskPriority priority, uint64_t budget_ms,
+            const std::string& duration_title, T dump_func) {
         Task packaged_task([=]() {
             std::unique_ptr<TmpFile> tmp_file_ptr = createTempFile();
             if (!tmp_file_ptr) {
                 return std::string("");
             }
-            invokeTask(dump_func, duration_title, tmp_file_ptr->fd.get());
+            invokeTask(dump_func, duration_title, budget_ms, tmp_file_ptr->fd.get());
             fsync(tmp_file_ptr->fd.get());
             return std::string(tmp_file_ptr->path);
         });
         std::unique_lock lock(lock_);
         auto future = packaged_task.get_future();
-        tasks_.push(std::move(packaged_task));
+        if (priority == TaskPriority::CRITICAL) {
+            critical_tasks_.push(std::move(packaged_task));
+        } else {
+            tasks_.push(std::move(packaged_task));
+        }
         condition_variable_.notify_one();
         return future;
     }
@@ -199,6 +238,7 @@ class DumpPool {
 
     std::vector<std::thread> threads_;
     std::queue<Task> tasks_;
+    std::queue<Task> critical_tasks_;  // Served before tasks_.
 
     DISALLOW_COPY_AND_ASSIGN(DumpPool);
 };
@@ -1556,11 +1556,17 @@ static Dumpstate::RunStatus dumpstate() {
         // drop root user. Restarts it with two threads for the parallel run.
         ds.dump_pool_->start(/* thread_counts = */2);
 
-        dump_hals = ds.dump_pool_->enqueueTaskWithFd(DUMP_HALS_TASK, &DumpHals, _1);
+        // The sections are waited on in the order hals, board, checkins, incident report;
+        // the first two are CRITICAL so the incident report does not occupy a pool thread
+        // ahead of them just because it was enqueued earlier. The budgets are soft: tasks
+        // running past them are logged, not interrupted.
+        dump_hals = ds.dump_pool_->enqueueTaskWithFd(DumpPool::TaskPriority::CRITICAL,
+            /* budget_ms = */ SEC_TO_MSEC(60), DUMP_HALS_TASK, &DumpHals, _1);
         dump_incident_report = ds.dump_pool_->enqueueTask(
             DUMP_INCIDENT_REPORT_TASK, &DumpIncidentReport);
-        dump_board = ds.dump_pool_->enqueueTaskWithFd(
-            DUMP_BOARD_TASK, &Dumpstate::DumpstateBoard, &ds, _1);
+        dump_board = ds.dump_pool_->enqueueTaskWithFd(DumpPool::TaskPriority::CRITICAL,
+            /* budget_ms = */ SEC_TO_MSEC(45), DUMP_BOARD_TASK,
+            &Dumpstate::DumpstateBoard, &ds, _1);
         dump_checkins = ds.dump_pool_->enqueueTaskWithFd(DUMP_CHECKINS_TASK, &DumpCheckins, _1);
     }
 
@@ -31,7 +31,11 @@
 #include <signal.h>
 #include <sys/types.h>
 #include <unistd.h>
+
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <aidl/android/hardware/dumpstate/IDumpstateDevice.h>
 #include <android-base/file.h>
@@ -1750,6 +1754,62 @@ TEST_F(DumpPoolTest, EnqueueTask_withDurationLog) {
     EXPECT_THAT(getTempFileCounts(kTestDataPath), Eq(0));
 }
 
+TEST_F(DumpPoolTest, EnqueueTask_withPriority) {
+    std::mutex lock;
+    std::condition_variable cv;
+    bool unblocked = false;
+    std::vector<std::string> order;
+    auto blocker_func = [&]() {
+        std::unique_lock ul(lock);
+        cv.wait(ul, [&] { return unblocked; });
+    };
+    auto record_func = [&](const std::string& name) {
+        std::lock_guard guard(lock);
+        order.push_back(name);
+    };
+    setLogDuration(/* log_duration = */false);
+
+    // With a single thread busy in the blocker, the critical task must be
+    // dequeued before the normal one even though it was enqueued later.
+    dump_pool_->start(/* thread_counts = */1);
+    auto t_blocker = dump_pool_->enqueueTask("", blocker_func);
+    auto t_normal = dump_pool_->enqueueTask("", record_func, std::string("normal"));
+    auto t_critical = dump_pool_->enqueueTask(DumpPool::TaskPriority::CRITICAL,
+            /* budget_ms = */0, "", record_func, std::string("critical"));
+    {
+        std::lock_guard guard(lock);
+        unblocked = true;
+    }
+    cv.notify_all();
+
+    WaitForTask(std::move(t_blocker), "", out_fd_.get());
+    WaitForTask(std::move(t_normal), "", out_fd_.get());
+    WaitForTask(std::move(t_critical), "", out_fd_.get());
+
+    ASSERT_THAT(order.size(), Eq(2u));
+    EXPECT_THAT(order[0], StrEq("critical"));
+    EXPECT_THAT(order[1], StrEq("normal"));
+    EXPECT_THAT(getTempFileCounts(kTestDataPath), Eq(0));
+}
+
+TEST_F(DumpPoolTest, EnqueueTaskWithFd_overBudgetKeepsOutput) {
+    auto dump_func = [](int out_fd) {
+        dprintf(out_fd, "A");
+        usleep(50 * 1000);
+    };
+    setLogDuration(/* log_duration = */false);
+
+    auto task = dump_pool_->enqueueTaskWithFd(DumpPool::TaskPriority::NORMAL,
+            /* budget_ms = */1, "over-budget", dump_func, std::placeholders::_1);
+    WaitForTask(std::move(task), "", out_fd_.get());
+
+    // Exceeding the budget only logs a warning; the task result is kept.
+    std::string result;
+    ReadFileToString(out_path_, &result);
+    EXPECT_THAT(result, StrEq("A\n"));
+    EXPECT_THAT(getTempFileCounts(kTestDataPath), Eq(0));
+}
+
 class TaskQueueTest : public DumpstateBaseTest {
 public:
     void SetUp() {
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
 #include <iomanip>
 #include <thread>
 
@@ -271,34 +272,84 @@ int Dumpsys::main(int argc, char* const argv[]) {
         return 0;
     }
 
+    std::vector<String16> servicesToDump;
     for (size_t i = 0; i < N; i++) {
-        const String16& serviceName = services[i];
-        if (IsSkipped(skippedServices, serviceName)) continue;
+        if (!IsSkipped(skippedServices, services[i])) {
+            servicesToDump.push_back(services[i]);
+        }
+    }
 
-        if (startDumpThread(dumpTypeFlags, serviceName, args) == OK) {
-            bool addSeparator = (N > 1);
-            if (addSeparator) {
-                writeDumpHeader(STDOUT_FILENO, serviceName, priorityFlags);
-            }
-            std::chrono::duration<double> elapsedDuration;
-            size_t bytesWritten = 0;
-            status_t status =
-                writeDump(STDOUT_FILENO, serviceName, std::chrono::milliseconds(timeoutArgMs),
-                          asProto, elapsedDuration, bytesWritten);
-
-            if (status == TIMED_OUT) {
-                std::cout << std::endl
-                     << "*** SERVICE '" << serviceName << "' DUMP TIMEOUT (" << timeoutArgMs
-                     << "ms) EXPIRED ***" << std::endl
-                     << std::endl;
+    // When dumping several services, overlap them: up to kMaxConcurrentDumps services dump
+    // into their own pipes at once while the results are merged to stdout in listed order,
+    // so a slow service only costs its own time instead of delaying every service behind it.
+    static constexpr size_t kMaxConcurrentDumps = 4;
+    const bool addSeparator = (N > 1);
+    const size_t maxConcurrentDumps = addSeparator ? kMaxConcurrentDumps : 1;
+
+    struct PendingDump {
+        String16 serviceName;
+        unique_fd readFd;
+        std::thread thread;
+        std::chrono::steady_clock::time_point startTime;
+    };
+    std::deque<PendingDump> inFlight;
+    size_t nextToStart = 0;
+
+    while (nextToStart < servicesToDump.size() || !inFlight.empty()) {
+        while (inFlight.size() < maxConcurrentDumps && nextToStart < servicesToDump.size()) {
+            PendingDump pending;
+            pending.serviceName = servicesToDump[nextToStart++];
+            pending.startTime = std::chrono::steady_clock::now();
+            if (startDumpThread(dumpTypeFlags, pending.serviceName, args, pending.readFd,
+                                pending.thread) == OK) {
+                inFlight.push_back(std::move(pending));
             }
+        }
+        if (inFlight.empty()) {
+            break;
+        }
 
-            if (addSeparator) {
-                writeDumpFooter(STDOUT_FILENO, serviceName, elapsedDuration);
-            }
-            bool dumpComplete = (status == OK);
-            stopDumpThread(dumpComplete);
+        PendingDump pending = std::move(inFlight.front());
+        inFlight.pop_front();
+
+        if (addSeparator) {
+            writeDumpHeader(STDOUT_FILENO, pending.serviceName, priorityFlags);
+        }
+
+        // The service has been dumping into its pipe since its thread started, so charge the
+        // time already spent against its timeout; the deadline is anchored at the start of
+        // the dump rather than at its turn in the merge.
+        const auto alreadyElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - pending.startTime);
+        const auto remainingTimeout =
+                std::max(std::chrono::milliseconds(timeoutArgMs) - alreadyElapsed,
+                         std::chrono::milliseconds(1));
+
+        std::chrono::duration<double> elapsedDuration;
+        size_t bytesWritten = 0;
+        status_t status = writeDump(pending.readFd.get(), STDOUT_FILENO, pending.serviceName,
+                                    remainingTimeout, asProto, elapsedDuration, bytesWritten);
+
+        if (status == TIMED_OUT) {
+            std::cout << std::endl
+                 << "*** SERVICE '" << pending.serviceName << "' DUMP TIMEOUT (" << timeoutArgMs
+                 << "ms) EXPIRED ***" << std::endl
+                 << std::endl;
         }
+
+        if (addSeparator) {
+            // Report the full duration of the dump, not just the tail spent at
+            // the front of the merge.
+            elapsedDuration = std::chrono::steady_clock::now() - pending.startTime;
+            writeDumpFooter(STDOUT_FILENO, pending.serviceName, elapsedDuration);
+        }
+        if (status == OK) {
+            pending.thread.join();
+        } else {
+            pending.thread.detach();
+        }
+        // The read end of the pipe closes as |pending| goes out of scope, which unblocks a
+        // detached dump thread stuck writing into it.
     }
 
     return 0;
@@ -415,6 +466,12 @@ static void reportDumpError(const String16& serviceName, status_t error, const c
 
 status_t Dumpsys::startDumpThread(int dumpTypeFlags, const String16& serviceName,
                                   const Vector<String16>& args) {
+    return startDumpThread(dumpTypeFlags, serviceName, args, redirectFd_, activeThread_);
+}
+
+status_t Dumpsys::startDumpThread(int dumpTypeFlags, const String16& serviceName,
+                                  const Vector<String16>& args, unique_fd& redirectFd,
+                                  std::thread& thread) const {
     sp<IBinder> service = sm_->checkService(serviceName);
     if (service == nullptr) {
         std::cerr << "Can't find service: " << serviceName << std::endl;
@@ -428,12 +485,12 @@ status_t Dumpsys::startDumpThread(int dumpTypeFlags, const String16& serviceName
         return -errno;
     }
 
-    redirectFd_ = unique_fd(sfd[0]);
+    redirectFd = unique_fd(sfd[0]);
     unique_fd remote_end(sfd[1]);
     sfd[0] = sfd[1] = -1;
 
     // dump blocks until completion, so spawn a thread..
-    activeThread_ = std::thread([=, remote_end{std::move(remote_end)}]() mutable {
+    thread = std::thread([=, remote_end{std::move(remote_end)}]() mutable {
         if (dumpTypeFlags & TYPE_PID) {
             status_t err = dumpPidToFd(service, remote_end, dumpTypeFlags == TYPE_PID);
             reportDumpError(serviceName, err, "dumping PID");
@@ -489,12 +546,19 @@ void Dumpsys::writeDumpHeader(int fd, const String16& serviceName, int priorityF
 status_t Dumpsys::writeDump(int fd, const String16& serviceName, std::chrono::milliseconds timeout,
                             bool asProto, std::chrono::duration<double>& elapsedDuration,
                             size_t& bytesWritten) const {
+    return writeDump(redirectFd_.get(), fd, serviceName, timeout, asProto, elapsedDuration,
+                     bytesWritten);
+}
+
+status_t Dumpsys::writeDump(int serviceDumpFd, int fd, const String16& serviceName,
+                            std::chrono::milliseconds timeout, bool asProto,
+                            std::chrono::duration<double>& elapsedDuration,
+                            size_t& bytesWritten) const {
     status_t status = OK;
     size_t totalBytes = 0;
     auto start = std::chrono::steady_clock::now();
     auto end = start + timeout;
 
-    int serviceDumpFd = redirectFd_.get();
     if (serviceDumpFd == -1) {
         return INVALID_OPERATION;
     }
@@ -521,7 +585,7 @@ status_t Dumpsys::writeDump(int fd, const String16& serviceName, std::chrono::mi
         }
 
         char buf[4096];
-        rc = TEMP_FAILURE_RETRY(read(redirectFd_.get(), buf, sizeof(buf)));
+        rc = TEMP_FAILURE_RETRY(read(serviceDumpFd, buf, sizeof(buf)));
         if (rc < 0) {
             std::cerr << "Failed to read while dumping service " << serviceName << ": "
                  << strerror(errno) << std::endl;
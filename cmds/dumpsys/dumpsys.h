@@ -126,6 +126,24 @@ class Dumpsys {
     }
 
   private:
+    /**
+     * Same as the public {@code startDumpThread} but stores the thread and the read end of
+     * the redirection pipe in the supplied out-parameters instead of the members, so several
+     * dumps can be in flight at once.
+     */
+    status_t startDumpThread(int dumpTypeFlags, const String16& serviceName,
+                             const Vector<String16>& args, android::base::unique_fd& redirectFd,
+                             std::thread& thread) const;
+
+    /**
+     * Same as the public {@code writeDump} but reads the service output from the given
+     * {@code serviceDumpFd} instead of the member pipe.
+     */
+    status_t writeDump(int serviceDumpFd, int fd, const String16& serviceName,
+                       std::chrono::milliseconds timeout, bool asProto,
+                       std::chrono::duration<double>& elapsedDuration,
+                       size_t& bytesWritten) const;
+
     android::IServiceManager* sm_;
     std::thread activeThread_;
     mutable android::base::unique_fd redirectFd_;
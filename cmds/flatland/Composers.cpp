@@ -109,6 +109,182 @@ private:
     GLint mModColorUniformLoc;
 };
 
+// Blits with a rounded-corner mask, approximating the rounded-corner crop of
+// the Skia composition path.
+class RoundedBlitter {
+public:
+
+    bool setUp(GLHelper* helper) {
+        bool result;
+
+        result = helper->getShaderProgram("BlitRounded", &mPgm);
+        if (!result) {
+            return false;
+        }
+
+        mPosAttribLoc = glGetAttribLocation(mPgm, "position");
+        mUVAttribLoc = glGetAttribLocation(mPgm, "uv");
+        mUVToTexUniformLoc = glGetUniformLocation(mPgm, "uvToTex");
+        mObjToNdcUniformLoc = glGetUniformLocation(mPgm, "objToNdc");
+        mBlitSrcSamplerLoc = glGetUniformLocation(mPgm, "blitSrc");
+        mModColorUniformLoc = glGetUniformLocation(mPgm, "modColor");
+        mLayerSizeUniformLoc = glGetUniformLocation(mPgm, "layerSize");
+        mCornerRadiusUniformLoc = glGetUniformLocation(mPgm, "cornerRadius");
+
+        return true;
+    }
+
+    bool blit(GLuint texName, const float* texMatrix, const float* modColor,
+            int32_t x, int32_t y, uint32_t w, uint32_t h, float radius) {
+        glUseProgram(mPgm);
+
+        GLint vp[4];
+        glGetIntegerv(GL_VIEWPORT, vp);
+        float screenToNdc[16] = {
+            2.0f/float(vp[2]),  0.0f,               0.0f,   0.0f,
+            0.0f,               -2.0f/float(vp[3]), 0.0f,   0.0f,
+            0.0f,               0.0f,               1.0f,   0.0f,
+            -1.0f,              1.0f,               0.0f,   1.0f,
+        };
+        const float pos[] = {
+            float(x),   float(y),
+            float(x+w), float(y),
+            float(x),   float(y+h),
+            float(x+w), float(y+h),
+        };
+        const float uv[] = {
+            0.0f, 0.0f,
+            1.0f, 0.0f,
+            0.0f, 1.0f,
+            1.0f, 1.0f,
+        };
+
+        glVertexAttribPointer(mPosAttribLoc, 2, GL_FLOAT, GL_FALSE, 0, pos);
+        glVertexAttribPointer(mUVAttribLoc, 2, GL_FLOAT, GL_FALSE, 0, uv);
+        glEnableVertexAttribArray(mPosAttribLoc);
+        glEnableVertexAttribArray(mUVAttribLoc);
+
+        glUniformMatrix4fv(mObjToNdcUniformLoc, 1, GL_FALSE, screenToNdc);
+        glUniformMatrix4fv(mUVToTexUniformLoc, 1, GL_FALSE, texMatrix);
+        glUniform4fv(mModColorUniformLoc, 1, modColor);
+        glUniform2f(mLayerSizeUniformLoc, float(w), float(h));
+        glUniform1f(mCornerRadiusUniformLoc, radius);
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_EXTERNAL_OES, texName);
+        glUniform1i(mBlitSrcSamplerLoc, 0);
+
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        glDisableVertexAttribArray(mPosAttribLoc);
+        glDisableVertexAttribArray(mUVAttribLoc);
+
+        if (glGetError() != GL_NO_ERROR) {
+            fprintf(stderr, "GL error!\n");
+        }
+
+        return true;
+    }
+
+private:
+    GLuint mPgm;
+    GLint mPosAttribLoc;
+    GLint mUVAttribLoc;
+    GLint mUVToTexUniformLoc;
+    GLint mObjToNdcUniformLoc;
+    GLint mBlitSrcSamplerLoc;
+    GLint mModColorUniformLoc;
+    GLint mLayerSizeUniformLoc;
+    GLint mCornerRadiusUniformLoc;
+};
+
+// Blits through a 3x3 blur kernel, approximating the per-pixel sampling cost
+// of a blur-behind render pass.
+class BlurBlitter {
+public:
+
+    bool setUp(GLHelper* helper) {
+        bool result;
+
+        result = helper->getShaderProgram("BlitBlur", &mPgm);
+        if (!result) {
+            return false;
+        }
+
+        mPosAttribLoc = glGetAttribLocation(mPgm, "position");
+        mUVAttribLoc = glGetAttribLocation(mPgm, "uv");
+        mUVToTexUniformLoc = glGetUniformLocation(mPgm, "uvToTex");
+        mObjToNdcUniformLoc = glGetUniformLocation(mPgm, "objToNdc");
+        mBlitSrcSamplerLoc = glGetUniformLocation(mPgm, "blitSrc");
+        mModColorUniformLoc = glGetUniformLocation(mPgm, "modColor");
+        mBlurOffsetUniformLoc = glGetUniformLocation(mPgm, "blurOffset");
+
+        return true;
+    }
+
+    bool blit(GLuint texName, const float* texMatrix, const float* modColor,
+            int32_t x, int32_t y, uint32_t w, uint32_t h, float radiusTexels) {
+        glUseProgram(mPgm);
+
+        GLint vp[4];
+        glGetIntegerv(GL_VIEWPORT, vp);
+        float screenToNdc[16] = {
+            2.0f/float(vp[2]),  0.0f,               0.0f,   0.0f,
+            0.0f,               -2.0f/float(vp[3]), 0.0f,   0.0f,
+            0.0f,               0.0f,               1.0f,   0.0f,
+            -1.0f,              1.0f,               0.0f,   1.0f,
+        };
+        const float pos[] = {
+            float(x),   float(y),
+            float(x+w), float(y),
+            float(x),   float(y+h),
+            float(x+w), float(y+h),
+        };
+        const float uv[] = {
+            0.0f, 0.0f,
+            1.0f, 0.0f,
+            0.0f, 1.0f,
+            1.0f, 1.0f,
+        };
+
+        glVertexAttribPointer(mPosAttribLoc, 2, GL_FLOAT, GL_FALSE, 0, pos);
+        glVertexAttribPointer(mUVAttribLoc, 2, GL_FLOAT, GL_FALSE, 0, uv);
+        glEnableVertexAttribArray(mPosAttribLoc);
+        glEnableVertexAttribArray(mUVAttribLoc);
+
+        glUniformMatrix4fv(mObjToNdcUniformLoc, 1, GL_FALSE, screenToNdc);
+        glUniformMatrix4fv(mUVToTexUniformLoc, 1, GL_FALSE, texMatrix);
+        glUniform4fv(mModColorUniformLoc, 1, modColor);
+        glUniform2f(mBlurOffsetUniformLoc, radiusTexels / float(w),
+                radiusTexels / float(h));
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_EXTERNAL_OES, texName);
+        glUniform1i(mBlitSrcSamplerLoc, 0);
+
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        glDisableVertexAttribArray(mPosAttribLoc);
+        glDisableVertexAttribArray(mUVAttribLoc);
+
+        if (glGetError() != GL_NO_ERROR) {
+            fprintf(stderr, "GL error!\n");
+        }
+
+        return true;
+    }
+
+private:
+    GLuint mPgm;
+    GLint mPosAttribLoc;
+    GLint mUVAttribLoc;
+    GLint mUVToTexUniformLoc;
+    GLint mObjToNdcUniformLoc;
+    GLint mBlitSrcSamplerLoc;
+    GLint mModColorUniformLoc;
+    GLint mBlurOffsetUniformLoc;
+};
+
 class ComposerBase : public Composer {
 public:
     virtual ~ComposerBase() {}
@@ -282,4 +458,120 @@ Composer* blendShrink() {
     return new BlendShrinkComp();
 }
 
+Composer* blendRounded() {
+    class BlendRoundedComp : public ComposerBase {
+        virtual bool setUp(GLHelper* helper) {
+            return mBlitter.setUp(helper);
+        }
+
+        virtual bool compose(GLuint texName, const sp<GLConsumer>& glc) {
+            bool result;
+
+            float texMatrix[16];
+            glc->getTransformMatrix(texMatrix);
+
+            float modColor[4] = { .75f, .75f, .75f, .75f };
+
+            int32_t x = mLayerDesc.x;
+            int32_t y = mLayerDesc.y;
+            int32_t w = mLayerDesc.width;
+            int32_t h = mLayerDesc.height;
+
+            float radius = float(h) / 16.0f;
+
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+            result = mBlitter.blit(texName, texMatrix, modColor,
+                    x, y, w, h, radius);
+            if (!result) {
+                return false;
+            }
+
+            glDisable(GL_BLEND);
+
+            return true;
+        }
+
+        RoundedBlitter mBlitter;
+    };
+    return new BlendRoundedComp();
+}
+
+Composer* blendShadowed() {
+    class BlendShadowedComp : public ComposerBase {
+        virtual bool setUp(GLHelper* helper) {
+            return mBlitter.setUp(helper);
+        }
+
+        virtual bool compose(GLuint texName, const sp<GLConsumer>& glc) {
+            bool result;
+
+            float texMatrix[16];
+            glc->getTransformMatrix(texMatrix);
+
+            float shadowColor[4] = { 0.0f, 0.0f, 0.0f, .6f };
+            float modColor[4] = { .75f, .75f, .75f, .75f };
+
+            int32_t x = mLayerDesc.x;
+            int32_t y = mLayerDesc.y;
+            int32_t w = mLayerDesc.width;
+            int32_t h = mLayerDesc.height;
+
+            float radius = float(h) / 16.0f;
+            int32_t shadowOffset = h / 64;
+
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+            // Draw a dark offset copy of the rounded layer first to
+            // approximate the overdraw of a key shadow.
+            result = mBlitter.blit(texName, texMatrix, shadowColor,
+                    x + shadowOffset, y + shadowOffset, w, h, radius);
+            if (!result) {
+                return false;
+            }
+
+            result = mBlitter.blit(texName, texMatrix, modColor,
+                    x, y, w, h, radius);
+            if (!result) {
+                return false;
+            }
+
+            glDisable(GL_BLEND);
+
+            return true;
+        }
+
+        RoundedBlitter mBlitter;
+    };
+    return new BlendShadowedComp();
+}
+
+Composer* blur() {
+    class BlurComp : public ComposerBase {
+        virtual bool setUp(GLHelper* helper) {
+            return mBlitter.setUp(helper);
+        }
+
+        virtual bool compose(GLuint texName, const sp<GLConsumer>& glc) {
+            float texMatrix[16];
+            glc->getTransformMatrix(texMatrix);
+
+            float modColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+            int32_t x = mLayerDesc.x;
+            int32_t y = mLayerDesc.y;
+            int32_t w = mLayerDesc.width;
+            int32_t h = mLayerDesc.height;
+
+            return mBlitter.blit(texName, texMatrix, modColor,
+                    x, y, w, h, 4.0f);
+        }
+
+        BlurBlitter mBlitter;
+    };
+    return new BlurComp();
+}
+
 } // namespace android
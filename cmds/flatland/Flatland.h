@@ -57,6 +57,9 @@ Composer* opaque();
 Composer* opaqueShrink();
 Composer* blend();
 Composer* blendShrink();
+Composer* blendRounded();
+Composer* blendShadowed();
+Composer* blur();
 
 class Renderer {
 public:
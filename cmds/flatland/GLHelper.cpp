@@ -18,6 +18,8 @@
 
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
+#include <gui/BLASTBufferQueue.h>
+#include <gui/ISurfaceComposerClient.h>
 #include <gui/SurfaceComposerClient.h>
 #include <ui/DisplayMode.h>
 
@@ -105,6 +107,8 @@ void GLHelper::tearDown() {
         mShaderPrograms = nullptr;
     }
 
+    mBlastBufferQueue.clear();
+
     if (mSurfaceComposerClient != nullptr) {
         mSurfaceComposerClient->dispose();
         mSurfaceComposerClient.clear();
@@ -241,7 +245,7 @@ bool GLHelper::computeWindowScale(uint32_t w, uint32_t h, float* scale) {
     return true;
 }
 
-bool GLHelper::createWindowSurface(uint32_t w, uint32_t h,
+bool GLHelper::createWindowSurface(uint32_t w, uint32_t h, bool useBlast,
         sp<SurfaceControl>* surfaceControl, EGLSurface* surface) {
     bool result;
     status_t err;
@@ -255,8 +259,9 @@ bool GLHelper::createWindowSurface(uint32_t w, uint32_t h,
         return false;
     }
 
+    uint32_t flags = useBlast ? ISurfaceComposerClient::eFXSurfaceBufferState : 0;
     sp<SurfaceControl> sc = mSurfaceComposerClient->createSurface(
-            String8("Benchmark"), w, h, PIXEL_FORMAT_RGBA_8888, 0);
+            String8("Benchmark"), w, h, PIXEL_FORMAT_RGBA_8888, flags);
     if (sc == nullptr || !sc->isValid()) {
         fprintf(stderr, "Failed to create SurfaceControl.\n");
         return false;
@@ -273,7 +278,16 @@ bool GLHelper::createWindowSurface(uint32_t w, uint32_t h,
             .show(sc)
             .apply();
 
-    sp<ANativeWindow> anw = sc->getSurface();
+    sp<ANativeWindow> anw;
+    if (useBlast) {
+        // Queue buffers through a BLASTBufferQueue so that they reach
+        // SurfaceFlinger as transactions, the same path the platform UI uses.
+        mBlastBufferQueue = new BLASTBufferQueue("Benchmark", sc, w, h,
+                PIXEL_FORMAT_RGBA_8888);
+        anw = mBlastBufferQueue->getSurface(false /* includeSurfaceControlHandle */);
+    } else {
+        anw = sc->getSurface();
+    }
     EGLSurface s = eglCreateWindowSurface(mDisplay, mConfig, anw.get(), nullptr);
     if (s == EGL_NO_SURFACE) {
         fprintf(stderr, "eglCreateWindowSurface error: %#x\n", eglGetError());
@@ -23,6 +23,7 @@
 
 namespace android {
 
+class BLASTBufferQueue;
 class SurfaceComposerClient;
 class SurfaceControl;
 
@@ -54,7 +55,7 @@ public:
             sp<GLConsumer>* surfaceTexture, EGLSurface* surface,
             GLuint* name);
 
-    bool createWindowSurface(uint32_t w, uint32_t h,
+    bool createWindowSurface(uint32_t w, uint32_t h, bool useBlast,
             sp<SurfaceControl>* surfaceControl, EGLSurface* surface);
 
     void destroySurface(EGLSurface* surface);
@@ -81,6 +82,7 @@ private:
     EGLConfig mConfig;
 
     sp<SurfaceComposerClient> mSurfaceComposerClient;
+    sp<BLASTBufferQueue> mBlastBufferQueue;
 
     GLuint* mShaderPrograms;
     const ShaderDesc* mShaderDescs;
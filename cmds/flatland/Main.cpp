@@ -36,6 +36,8 @@ using namespace ::android;
 
 static uint32_t g_SleepBetweenSamplesMs = 0;
 static bool     g_PresentToWindow       = false;
+static bool     g_UseBlast              = false;
+static bool     g_JsonOutput            = false;
 static size_t   g_BenchmarkNameLen      = 0;
 
 struct BenchmarkDesc {
@@ -201,6 +203,58 @@ static const BenchmarkDesc benchmarks[] = {
             },
         },
     },
+
+    // Approximates the per-pixel cost of the rounded-corner crop that the
+    // Skia render path applies to every app window.
+    { "16:10 Rounded Corner Window",
+        2560, 1600, { 800, 1200, 1600, 2400 },
+        {
+            {   // Wallpaper
+                0, staticGradient, opaque,
+                0,    50,     2560,   1454,
+            },
+            {   // App window with rounded corners
+                0, staticGradient, blendRounded,
+                0,    50,     2560,   1454,
+            },
+            {   // Status bar
+                0, staticGradient, opaque,
+                0,    0,      2560,   50,
+            },
+            {   // Navigation bar
+                0, staticGradient, opaque,
+                0,    1504,   2560,   96,
+            },
+        },
+    },
+
+    // Approximates a blur-behind dialog: a full-screen app under a blurred
+    // region with a rounded, shadowed dialog on top.
+    { "16:10 Blur Behind Dialog",
+        2560, 1600, { 800, 1200, 1600, 2400 },
+        {
+            {   // App window
+                0, staticGradient, opaque,
+                0,    50,     2560,   1454,
+            },
+            {   // Blur-behind region
+                0, staticGradient, blur,
+                320,  250,    1920,   1054,
+            },
+            {   // Dialog with rounded corners and shadow
+                0, staticGradient, blendShadowed,
+                640,  450,    1280,   654,
+            },
+            {   // Status bar
+                0, staticGradient, opaque,
+                0,    0,      2560,   50,
+            },
+            {   // Navigation bar
+                0, staticGradient, opaque,
+                0,    1504,   2560,   96,
+            },
+        },
+    },
 };
 
 static const ShaderDesc shaders[] = {
@@ -238,6 +292,96 @@ static const ShaderDesc shaders[] = {
         },
     },
 
+    {
+        .name="BlitRounded",
+        .vertexShader={
+            "precision mediump float;",
+            "",
+            "attribute vec4 position;",
+            "attribute vec4 uv;",
+            "",
+            "varying vec4 texCoords;",
+            "varying vec2 localCoords;",
+            "",
+            "uniform mat4 objToNdc;",
+            "uniform mat4 uvToTex;",
+            "uniform vec2 layerSize;",
+            "",
+            "void main() {",
+            "    gl_Position = objToNdc * position;",
+            "    texCoords = uvToTex * uv;",
+            "    localCoords = uv.xy * layerSize;",
+            "}",
+        },
+        .fragmentShader={
+            "#extension GL_OES_EGL_image_external : require",
+            "precision mediump float;",
+            "",
+            "varying vec4 texCoords;",
+            "varying vec2 localCoords;",
+            "",
+            "uniform samplerExternalOES blitSrc;",
+            "uniform vec4 modColor;",
+            "uniform vec2 layerSize;",
+            "uniform float cornerRadius;",
+            "",
+            "void main() {",
+            "    vec2 halfSize = layerSize * 0.5;",
+            "    vec2 p = abs(localCoords - halfSize) -",
+            "            (halfSize - vec2(cornerRadius));",
+            "    float d = length(max(p, vec2(0.0))) - cornerRadius;",
+            "    float coverage = clamp(0.5 - d, 0.0, 1.0);",
+            "    gl_FragColor = texture2D(blitSrc, texCoords.xy);",
+            "    gl_FragColor *= modColor * coverage;",
+            "}",
+        },
+    },
+
+    {
+        .name="BlitBlur",
+        .vertexShader={
+            "precision mediump float;",
+            "",
+            "attribute vec4 position;",
+            "attribute vec4 uv;",
+            "",
+            "varying vec4 texCoords;",
+            "",
+            "uniform mat4 objToNdc;",
+            "uniform mat4 uvToTex;",
+            "",
+            "void main() {",
+            "    gl_Position = objToNdc * position;",
+            "    texCoords = uvToTex * uv;",
+            "}",
+        },
+        .fragmentShader={
+            "#extension GL_OES_EGL_image_external : require",
+            "precision mediump float;",
+            "",
+            "varying vec4 texCoords;",
+            "",
+            "uniform samplerExternalOES blitSrc;",
+            "uniform vec4 modColor;",
+            "uniform vec2 blurOffset;",
+            "",
+            "void main() {",
+            "    vec2 o = blurOffset;",
+            "    vec4 color;",
+            "    color  = texture2D(blitSrc, texCoords.xy + vec2(-o.x, -o.y));",
+            "    color += texture2D(blitSrc, texCoords.xy + vec2( 0.0, -o.y)) * 2.0;",
+            "    color += texture2D(blitSrc, texCoords.xy + vec2( o.x, -o.y));",
+            "    color += texture2D(blitSrc, texCoords.xy + vec2(-o.x,  0.0)) * 2.0;",
+            "    color += texture2D(blitSrc, texCoords.xy) * 4.0;",
+            "    color += texture2D(blitSrc, texCoords.xy + vec2( o.x,  0.0)) * 2.0;",
+            "    color += texture2D(blitSrc, texCoords.xy + vec2(-o.x,  o.y));",
+            "    color += texture2D(blitSrc, texCoords.xy + vec2( 0.0,  o.y)) * 2.0;",
+            "    color += texture2D(blitSrc, texCoords.xy + vec2( o.x,  o.y));",
+            "    gl_FragColor = color * (1.0 / 16.0) * modColor;",
+            "}",
+        },
+    },
+
     {
         .name="Gradient",
         .vertexShader={
@@ -421,8 +565,8 @@ public:
         }
 
         if (g_PresentToWindow) {
-            result = mGLHelper->createWindowSurface(w, h, &mSurfaceControl,
-                    &mWindowSurface);
+            result = mGLHelper->createWindowSurface(w, h, g_UseBlast,
+                    &mSurfaceControl, &mWindowSurface);
             if (!result) {
                 return false;
             }
@@ -586,17 +730,63 @@ static int cmpDouble(const double* lhs, const double* rhs) {
     return 0;
 }
 
+// Return the p'th percentile of the sorted run-time samples, converted to
+// milliseconds per frame.
+static double samplePercentile(const Vector<double>& sortedSamples, double p,
+        uint32_t frames) {
+    size_t elem = size_t(p * double(sortedSamples.size() - 1) + 0.5);
+    return sortedSamples[elem] / double(frames) / 1e6;
+}
+
+// Append one benchmark result to the JSON output array.
+static void printJsonResult(const BenchmarkDesc& b, uint32_t w, uint32_t h,
+        const char* status, double resultMs,
+        const Vector<double>& sortedSamples, uint32_t frames) {
+    static bool firstRecord = true;
+    if (!firstRecord) {
+        printf(",\n");
+    }
+    firstRecord = false;
+
+    printf("  {\n");
+    printf("    \"scenario\": \"%s\",\n", b.name);
+    printf("    \"width\": %u,\n", w);
+    printf("    \"height\": %u,\n", h);
+    printf("    \"status\": \"%s\"", status);
+    if (strcmp(status, "ok") == 0) {
+        printf(",\n");
+        printf("    \"frameTimeMs\": %.3f,\n", resultMs);
+        printf("    \"percentilesMs\": {\n");
+        printf("      \"p50\": %.3f,\n",
+                samplePercentile(sortedSamples, .50, frames));
+        printf("      \"p90\": %.3f,\n",
+                samplePercentile(sortedSamples, .90, frames));
+        printf("      \"p95\": %.3f,\n",
+                samplePercentile(sortedSamples, .95, frames));
+        printf("      \"p99\": %.3f\n",
+                samplePercentile(sortedSamples, .99, frames));
+        printf("    }\n");
+    } else {
+        printf("\n");
+    }
+    printf("  }");
+    fflush(stdout);
+}
+
 // Run a single benchmark and print the result.
 static bool runTest(const BenchmarkDesc b, size_t run) {
     bool success = true;
+    const char* status = "ok";
     double prevResult = 0.0, result = 0.0;
     Vector<double> samples;
 
     uint32_t runHeight = b.runHeights[run];
     uint32_t runWidth = b.width * runHeight / b.height;
-    printf(" %-*s | %4d x %4d | ", static_cast<int>(g_BenchmarkNameLen), b.name,
-            runWidth, runHeight);
-    fflush(stdout);
+    if (!g_JsonOutput) {
+        printf(" %-*s | %4d x %4d | ", static_cast<int>(g_BenchmarkNameLen),
+                b.name, runWidth, runHeight);
+        fflush(stdout);
+    }
 
     BenchmarkRunner r(b, run);
     if (!r.setUp()) {
@@ -627,11 +817,17 @@ static bool runTest(const BenchmarkDesc b, size_t run) {
 
     if (totalFrames - warmUpFrames > 16) {
         // The test runs too fast to get a stable result.  Skip it.
-        printf("  fast");
+        status = "fast";
+        if (!g_JsonOutput) {
+            printf("  fast");
+        }
         goto done;
     } else if (totalFrames == 5 && runTime > 200e6) {
         // The test runs too slow to be very useful.  Skip it.
-        printf("  slow");
+        status = "slow";
+        if (!g_JsonOutput) {
+            printf("  slow");
+        }
         goto done;
     }
 
@@ -642,7 +838,10 @@ static bool runTest(const BenchmarkDesc b, size_t run) {
         }
 
         if (newSamples > 512) {
-            printf("varies");
+            status = "varies";
+            if (!g_JsonOutput) {
+                printf("varies");
+            }
             goto done;
         }
 
@@ -655,6 +854,7 @@ static bool runTest(const BenchmarkDesc b, size_t run) {
 
             if (sample < 0.0) {
                 success = false;
+                status = "error";
                 goto done;
             }
 
@@ -668,12 +868,20 @@ static bool runTest(const BenchmarkDesc b, size_t run) {
         result = (samples[elem-1] + samples[elem]) * 0.5;
     } while (fabs(result - prevResult) > threshold * result);
 
-    printf("%6.3f", result / double(totalFrames - warmUpFrames) / 1e6);
+    if (!g_JsonOutput) {
+        printf("%6.3f", result / double(totalFrames - warmUpFrames) / 1e6);
+    }
 
 done:
 
-    printf("\n");
-    fflush(stdout);
+    if (g_JsonOutput) {
+        printJsonResult(b, runWidth, runHeight, status,
+                result / double(totalFrames - warmUpFrames) / 1e6,
+                samples, totalFrames - warmUpFrames);
+    } else {
+        printf("\n");
+        fflush(stdout);
+    }
     r.tearDown();
 
     return success;
@@ -691,7 +899,11 @@ static void printResultsTableHeader() {
 
 // Run ALL the benchmarks!
 static bool runTests() {
-    printResultsTableHeader();
+    if (g_JsonOutput) {
+        printf("[\n");
+    } else {
+        printResultsTableHeader();
+    }
 
     for (size_t i = 0; i < NELEMS(benchmarks); i++) {
         const BenchmarkDesc& b = benchmarks[i];
@@ -701,6 +913,10 @@ static bool runTests() {
             }
         }
     }
+
+    if (g_JsonOutput) {
+        printf("\n]\n");
+    }
     return true;
 }
 
@@ -723,6 +939,9 @@ static void showHelp(const char *cmd) {
     fprintf(stderr, "options include:\n"
                     "  -s N            sleep for N ms between samples\n"
                     "  -d              display the test frame to a window\n"
+                    "  --blast         present to the window through a BLASTBufferQueue\n"
+                    "                  (implies -d)\n"
+                    "  --json          print results as JSON with frame time percentiles\n"
                     "  --help          print this helpful message and exit\n"
             );
 }
@@ -737,6 +956,8 @@ int main(int argc, char** argv) {
         int ret;
         int option_index = 0;
         static struct option long_options[] = {
+            {"blast",    no_argument, 0,  0 },
+            {"json",     no_argument, 0,  0 },
             {"help",     no_argument, 0,  0 },
             {     0,               0, 0,  0 }
         };
@@ -758,7 +979,13 @@ int main(int argc, char** argv) {
             break;
 
             case 0:
-                if (strcmp(long_options[option_index].name, "help")) {
+                if (strcmp(long_options[option_index].name, "blast") == 0) {
+                    g_UseBlast = true;
+                    g_PresentToWindow = true;
+                } else if (strcmp(long_options[option_index].name,
+                        "json") == 0) {
+                    g_JsonOutput = true;
+                } else {
                     showHelp(argv[0]);
                     exit(0);
                 }
@@ -772,11 +999,13 @@ int main(int argc, char** argv) {
 
     g_BenchmarkNameLen = maxBenchmarkNameLen();
 
-    printf(" cmdline:");
-    for (int i = 0; i < argc; i++) {
-        printf(" %s", argv[i]);
+    if (!g_JsonOutput) {
+        printf(" cmdline:");
+        for (int i = 0; i < argc; i++) {
+            printf(" %s", argv[i]);
+        }
+        printf("\n");
     }
-    printf("\n");
 
     if (!runTests()) {
         fprintf(stderr, "exiting due to error.\n");
@@ -2394,62 +2394,18 @@ static bool ownsExternalStorage(int32_t appId) {
     }
     return false;
 }
-binder::Status InstalldNativeService::getAppSize(const std::optional<std::string>& uuid,
-        const std::vector<std::string>& packageNames, int32_t userId, int32_t flags,
-        int32_t appId, const std::vector<int64_t>& ceDataInodes,
-        const std::vector<std::string>& codePaths, std::vector<int64_t>* _aidl_return) {
-    ENFORCE_UID(AID_SYSTEM);
-    CHECK_ARGUMENT_UUID(uuid);
-    if (packageNames.size() != ceDataInodes.size()) {
-        return exception(binder::Status::EX_ILLEGAL_ARGUMENT,
-                         "packageNames/ceDataInodes size mismatch.");
-    }
-    for (const auto& packageName : packageNames) {
-        CHECK_ARGUMENT_PACKAGE_NAME(packageName);
-    }
-    for (const auto& codePath : codePaths) {
-        CHECK_ARGUMENT_PATH(codePath);
-    }
-    // NOTE: Locking is relaxed on this method, since it's limited to
-    // read-only measurements without mutation.
-
-    // When modifying this logic, always verify using tests:
-    // runtest -x frameworks/base/services/tests/servicestests/src/com/android/server/pm/InstallerTest.java -m testGetAppSize
-
-#if MEASURE_DEBUG
-    LOG(INFO) << "Measuring user " << userId << " app " << appId;
-#endif
-
-    // Here's a summary of the common storage locations across the platform,
-    // and how they're each tagged:
-    //
-    // /data/app/com.example                           UID system
-    // /data/app/com.example/oat                       UID system
-    // /data/user/0/com.example                        UID u0_a10      GID u0_a10
-    // /data/user/0/com.example/cache                  UID u0_a10      GID u0_a10_cache
-    // /data/media/0/foo.txt                           UID u0_media_rw
-    // /data/media/0/bar.jpg                           UID u0_media_rw GID u0_media_image
-    // /data/media/0/Android/data/com.example          UID u0_media_rw GID u0_a10_ext
-    // /data/media/0/Android/data/com.example/cache    UID u0_media_rw GID u0_a10_ext_cache
-    // /data/media/obb/com.example                     UID system
-
-    struct stats stats;
-    struct stats extStats;
-    memset(&stats, 0, sizeof(stats));
-    memset(&extStats, 0, sizeof(extStats));
-
-    auto uuidString = uuid.value_or("");
-    const char* uuid_ = uuid ? uuid->c_str() : nullptr;
-
-    if (!IsQuotaSupported(uuidString)) {
-        flags &= ~FLAG_USE_QUOTA;
-    }
 
+// Measures one group of packages sharing a uid; the single-package and bulk
+// entry points both funnel through here so their results stay identical.
+static void collectAppStats(const char* uuid_, const std::string& uuidString, int32_t userId,
+        int32_t flags, int32_t appId, const std::vector<std::string>& packageNames,
+        const std::vector<int64_t>& ceDataInodes, const std::vector<std::string>& codePaths,
+        struct stats* stats, struct stats* extStats) {
     ATRACE_BEGIN("obb");
     for (const auto& packageName : packageNames) {
         auto obbCodePath = create_data_media_package_path(uuid_, userId,
                 "obb", packageName.c_str());
-        calculate_tree_size(obbCodePath, &extStats.codeSize);
+        calculate_tree_size(obbCodePath, &extStats->codeSize);
     }
     ATRACE_END();
     // Calculating the app size of the external storage owning app in a manual way, since
@@ -2458,18 +2414,18 @@ binder::Status InstalldNativeService::getAppSize(const std::optional<std::string
     if (flags & FLAG_USE_QUOTA && appId >= AID_APP_START && !ownsExternalStorage(appId)) {
         ATRACE_BEGIN("code");
         for (const auto& codePath : codePaths) {
-            calculate_tree_size(codePath, &stats.codeSize, -1,
+            calculate_tree_size(codePath, &stats->codeSize, -1,
                     multiuser_get_shared_gid(0, appId));
         }
         ATRACE_END();
 
         ATRACE_BEGIN("quota");
-        collectQuotaStats(uuidString, userId, appId, &stats, &extStats);
+        collectQuotaStats(uuidString, userId, appId, stats, extStats);
         ATRACE_END();
     } else {
         ATRACE_BEGIN("code");
         for (const auto& codePath : codePaths) {
-            calculate_tree_size(codePath, &stats.codeSize);
+            calculate_tree_size(codePath, &stats->codeSize);
         }
         ATRACE_END();
 
@@ -2478,9 +2434,9 @@ binder::Status InstalldNativeService::getAppSize(const std::optional<std::string
 
             ATRACE_BEGIN("data");
             auto cePath = create_data_user_ce_package_path(uuid_, userId, pkgname, ceDataInodes[i]);
-            collectManualStats(cePath, &stats);
+            collectManualStats(cePath, stats);
             auto dePath = create_data_user_de_package_path(uuid_, userId, pkgname);
-            collectManualStats(dePath, &stats);
+            collectManualStats(dePath, stats);
             ATRACE_END();
 
             // In case of sdk sandbox storage (e.g. /data/misc_ce/0/sdksandbox/<package-name>),
@@ -2489,42 +2445,97 @@ binder::Status InstalldNativeService::getAppSize(const std::optional<std::string
                 ATRACE_BEGIN("sdksandbox");
                 auto sdkSandboxCePath =
                         create_data_misc_sdk_sandbox_package_path(uuid_, true, userId, pkgname);
-                collectManualStatsForSubDirectories(sdkSandboxCePath, &stats);
+                collectManualStatsForSubDirectories(sdkSandboxCePath, stats);
                 auto sdkSandboxDePath =
                         create_data_misc_sdk_sandbox_package_path(uuid_, false, userId, pkgname);
-                collectManualStatsForSubDirectories(sdkSandboxDePath, &stats);
+                collectManualStatsForSubDirectories(sdkSandboxDePath, stats);
                 ATRACE_END();
             }
 
-            if (!uuid) {
+            if (uuid_ == nullptr) {
                 ATRACE_BEGIN("profiles");
                 calculate_tree_size(
                         create_primary_current_profile_package_dir_path(userId, pkgname),
-                        &stats.dataSize);
+                        &stats->dataSize);
                 calculate_tree_size(
                         create_primary_reference_profile_package_dir_path(pkgname),
-                        &stats.codeSize);
+                        &stats->codeSize);
                 ATRACE_END();
             }
 
             ATRACE_BEGIN("external");
             auto extPath = create_data_media_package_path(uuid_, userId, "data", pkgname);
-            collectManualStats(extPath, &extStats);
+            collectManualStats(extPath, extStats);
             auto mediaPath = create_data_media_package_path(uuid_, userId, "media", pkgname);
-            calculate_tree_size(mediaPath, &extStats.dataSize);
+            calculate_tree_size(mediaPath, &extStats->dataSize);
             ATRACE_END();
         }
 
-        if (!uuid) {
+        if (uuid_ == nullptr) {
             ATRACE_BEGIN("dalvik");
             int32_t sharedGid = multiuser_get_shared_gid(0, appId);
             if (sharedGid != -1) {
-                calculate_tree_size(create_data_dalvik_cache_path(), &stats.codeSize,
+                calculate_tree_size(create_data_dalvik_cache_path(), &stats->codeSize,
                         sharedGid, -1);
             }
             ATRACE_END();
         }
     }
+}
+
+binder::Status InstalldNativeService::getAppSize(const std::optional<std::string>& uuid,
+        const std::vector<std::string>& packageNames, int32_t userId, int32_t flags,
+        int32_t appId, const std::vector<int64_t>& ceDataInodes,
+        const std::vector<std::string>& codePaths, std::vector<int64_t>* _aidl_return) {
+    ENFORCE_UID(AID_SYSTEM);
+    CHECK_ARGUMENT_UUID(uuid);
+    if (packageNames.size() != ceDataInodes.size()) {
+        return exception(binder::Status::EX_ILLEGAL_ARGUMENT,
+                         "packageNames/ceDataInodes size mismatch.");
+    }
+    for (const auto& packageName : packageNames) {
+        CHECK_ARGUMENT_PACKAGE_NAME(packageName);
+    }
+    for (const auto& codePath : codePaths) {
+        CHECK_ARGUMENT_PATH(codePath);
+    }
+    // NOTE: Locking is relaxed on this method, since it's limited to
+    // read-only measurements without mutation.
+
+    // When modifying this logic, always verify using tests:
+    // runtest -x frameworks/base/services/tests/servicestests/src/com/android/server/pm/InstallerTest.java -m testGetAppSize
+
+#if MEASURE_DEBUG
+    LOG(INFO) << "Measuring user " << userId << " app " << appId;
+#endif
+
+    // Here's a summary of the common storage locations across the platform,
+    // and how they're each tagged:
+    //
+    // /data/app/com.example                           UID system
+    // /data/app/com.example/oat                       UID system
+    // /data/user/0/com.example                        UID u0_a10      GID u0_a10
+    // /data/user/0/com.example/cache                  UID u0_a10      GID u0_a10_cache
+    // /data/media/0/foo.txt                           UID u0_media_rw
+    // /data/media/0/bar.jpg                           UID u0_media_rw GID u0_media_image
+    // /data/media/0/Android/data/com.example          UID u0_media_rw GID u0_a10_ext
+    // /data/media/0/Android/data/com.example/cache    UID u0_media_rw GID u0_a10_ext_cache
+    // /data/media/obb/com.example                     UID system
+
+    struct stats stats;
+    struct stats extStats;
+    memset(&stats, 0, sizeof(stats));
+    memset(&extStats, 0, sizeof(extStats));
+
+    auto uuidString = uuid.value_or("");
+    const char* uuid_ = uuid ? uuid->c_str() : nullptr;
+
+    if (!IsQuotaSupported(uuidString)) {
+        flags &= ~FLAG_USE_QUOTA;
+    }
+
+    collectAppStats(uuid_, uuidString, userId, flags, appId, packageNames, ceDataInodes,
+            codePaths, &stats, &extStats);
 
     std::vector<int64_t> ret;
     ret.push_back(stats.codeSize);
@@ -2540,6 +2551,89 @@ binder::Status InstalldNativeService::getAppSize(const std::optional<std::string
     return ok();
 }
 
+binder::Status InstalldNativeService::getAppSizeBulk(const std::optional<std::string>& uuid,
+        const std::vector<std::string>& packageNames, int32_t userId, int32_t flags,
+        const std::vector<int32_t>& appIds, const std::vector<int64_t>& ceDataInodes,
+        const std::vector<std::string>& codePaths, const std::vector<int32_t>& packageCounts,
+        std::vector<int64_t>* _aidl_return) {
+    ENFORCE_UID(AID_SYSTEM);
+    CHECK_ARGUMENT_UUID(uuid);
+    if (packageNames.size() != ceDataInodes.size() || packageNames.size() != codePaths.size()) {
+        return exception(binder::Status::EX_ILLEGAL_ARGUMENT,
+                         "packageNames/ceDataInodes/codePaths size mismatch.");
+    }
+    if (appIds.size() != packageCounts.size()) {
+        return exception(binder::Status::EX_ILLEGAL_ARGUMENT,
+                         "appIds/packageCounts size mismatch.");
+    }
+    for (const auto& packageName : packageNames) {
+        CHECK_ARGUMENT_PACKAGE_NAME(packageName);
+    }
+    for (const auto& codePath : codePaths) {
+        CHECK_ARGUMENT_PATH(codePath);
+    }
+    // NOTE: Locking is relaxed on this method, since it's limited to
+    // read-only measurements without mutation.
+
+    auto uuidString = uuid.value_or("");
+    const char* uuid_ = uuid ? uuid->c_str() : nullptr;
+
+    // Check quota support once for the whole batch instead of once per app.
+    if (!IsQuotaSupported(uuidString)) {
+        flags &= ~FLAG_USE_QUOTA;
+    }
+
+    std::vector<int64_t> ret;
+    ret.reserve(appIds.size() * 6);
+
+    // Each packageCounts[i] consecutive entries of the per-package arrays form
+    // one group of packages sharing appIds[i], measured exactly like a
+    // standalone getAppSize() call for that group.
+    size_t next = 0;
+    for (size_t i = 0; i < appIds.size(); i++) {
+        if (packageCounts[i] <= 0 ||
+                static_cast<size_t>(packageCounts[i]) > packageNames.size() - next) {
+            return exception(binder::Status::EX_ILLEGAL_ARGUMENT, "Invalid packageCounts.");
+        }
+        const size_t count = packageCounts[i];
+
+#if MEASURE_DEBUG
+        LOG(INFO) << "Measuring user " << userId << " app " << appIds[i];
+#endif
+
+        struct stats stats;
+        struct stats extStats;
+        memset(&stats, 0, sizeof(stats));
+        memset(&extStats, 0, sizeof(extStats));
+
+        const std::vector<std::string> groupPackageNames(packageNames.begin() + next,
+                packageNames.begin() + next + count);
+        const std::vector<int64_t> groupCeDataInodes(ceDataInodes.begin() + next,
+                ceDataInodes.begin() + next + count);
+        const std::vector<std::string> groupCodePaths(codePaths.begin() + next,
+                codePaths.begin() + next + count);
+        collectAppStats(uuid_, uuidString, userId, flags, appIds[i], groupPackageNames,
+                groupCeDataInodes, groupCodePaths, &stats, &extStats);
+
+        ret.push_back(stats.codeSize);
+        ret.push_back(stats.dataSize);
+        ret.push_back(stats.cacheSize);
+        ret.push_back(extStats.codeSize);
+        ret.push_back(extStats.dataSize);
+        ret.push_back(extStats.cacheSize);
+        next += count;
+    }
+    if (next != packageNames.size()) {
+        return exception(binder::Status::EX_ILLEGAL_ARGUMENT,
+                         "packageCounts do not cover all packages.");
+    }
+#if MEASURE_DEBUG
+    LOG(DEBUG) << "Final result " << toString(ret);
+#endif
+    *_aidl_return = ret;
+    return ok();
+}
+
 struct external_sizes {
     int64_t audioSize;
     int64_t videoSize;
@@ -89,6 +89,11 @@ public:
             const std::vector<std::string>& packageNames, int32_t userId, int32_t flags,
             int32_t appId, const std::vector<int64_t>& ceDataInodes,
             const std::vector<std::string>& codePaths, std::vector<int64_t>* _aidl_return);
+    binder::Status getAppSizeBulk(const std::optional<std::string>& uuid,
+            const std::vector<std::string>& packageNames, int32_t userId, int32_t flags,
+            const std::vector<int32_t>& appIds, const std::vector<int64_t>& ceDataInodes,
+            const std::vector<std::string>& codePaths, const std::vector<int32_t>& packageCounts,
+            std::vector<int64_t>* _aidl_return);
     binder::Status getUserSize(const std::optional<std::string>& uuid,
             int32_t userId, int32_t flags, const std::vector<int32_t>& appIds,
             std::vector<int64_t>* _aidl_return);
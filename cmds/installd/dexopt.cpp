@@ -28,13 +28,16 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
+#include <condition_variable>
 #include <iomanip>
 #include <mutex>
 #include <unordered_set>
 
 #include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/macros.h>
 #include <android-base/no_destructor.h>
 #include <android-base/properties.h>
 #include <android-base/stringprintf.h>
@@ -153,6 +156,73 @@ class DexOptStatus {
 
 android::base::NoDestructor<DexOptStatus> dexopt_status_;
 
+// Bounds how many dex2oat invocations may run at once. The framework issues
+// dexopt calls from several binder threads when it re-optimizes every package
+// (e.g. after an OTA); left unbounded, the resulting dex2oat processes thrash
+// memory and I/O on small devices, and run one at a time they waste cores on
+// big ones. Only background/idle jobs are throttled: a compilation for a
+// user-visible install always gets a slot immediately, so it is never queued
+// behind a batch job.
+class DexOptConcurrencyLimiter {
+ public:
+    DexOptConcurrencyLimiter() : max_background_jobs_(compute_max_background_jobs()) {}
+
+    void acquire(bool background_job) {
+        if (!background_job) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(lock_);
+        cond_.wait(lock, [&] { return running_ < max_background_jobs_; });
+        running_++;
+    }
+
+    void release(bool background_job) {
+        if (!background_job) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            running_--;
+        }
+        cond_.notify_one();
+    }
+
+ private:
+    // Half the online cores, clamped to [1, 4]; a single job on low-RAM
+    // devices, where a second dex2oat is enough to cause memory pressure.
+    static int compute_max_background_jobs() {
+        if (android::base::GetBoolProperty("ro.config.low_ram", false)) {
+            return 1;
+        }
+        const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        return std::clamp<long>(cores / 2, 1, 4);
+    }
+
+    const int max_background_jobs_;
+    std::mutex lock_;
+    std::condition_variable cond_;
+    int running_ GUARDED_BY(lock_) = 0;
+};
+
+android::base::NoDestructor<DexOptConcurrencyLimiter> dexopt_concurrency_;
+
+// Scoped slot in the concurrency limiter; blocks in the constructor until one
+// is free.
+class DexOptJobSlot {
+ public:
+    explicit DexOptJobSlot(bool background_job) : background_job_(background_job) {
+        dexopt_concurrency_->acquire(background_job_);
+    }
+    ~DexOptJobSlot() {
+        dexopt_concurrency_->release(background_job_);
+    }
+
+ private:
+    const bool background_job_;
+
+    DISALLOW_COPY_AND_ASSIGN(DexOptJobSlot);
+};
+
 } // namespace
 
 namespace android {
@@ -360,7 +430,7 @@ static bool ShouldUseSwapFileForDexopt() {
     return kDefaultProvideSwapFile;
 }
 
-static void SetDex2OatScheduling(bool set_to_bg) {
+static void SetDex2OatScheduling(bool set_to_bg, bool background_job_compile) {
     if (set_to_bg) {
         if (!SetTaskProfiles(0, {"Dex2OatBootComplete"})) {
             LOG(ERROR) << "Failed to set dex2oat task profile";
@@ -371,6 +441,15 @@ static void SetDex2OatScheduling(bool set_to_bg) {
             exit(DexoptReturnCodes::kSetPriority);
         }
     }
+    // Idle/background compilations additionally take low I/O priority through
+    // the cgroup io controller, so a batch of them does not starve foreground
+    // apps of disk bandwidth. Best effort: older task profile configurations
+    // may not define the profile.
+    if (background_job_compile) {
+        if (!SetTaskProfiles(0, {"LowIoPriority"})) {
+            LOG(WARNING) << "Failed to set low I/O priority for background dexopt";
+        }
+    }
 }
 
 static unique_fd create_profile(uid_t uid, const std::string& profile, int32_t flags, mode_t mode) {
@@ -1821,6 +1900,10 @@ int dexopt(const char* dex_path, uid_t uid, const char* pkgname, const char* ins
     bool generate_app_image = (dexopt_flags & DEXOPT_GENERATE_APP_IMAGE) != 0;
     bool for_restore = (dexopt_flags & DEXOPT_FOR_RESTORE) != 0;
 
+    // Blocks until a concurrency slot is free if this is a background job; a
+    // compilation for a user-visible install proceeds immediately.
+    DexOptJobSlot job_slot(background_job_compile);
+
     // Check if we're dealing with a secondary dex file and if we need to compile it.
     std::string oat_dir_str;
     std::vector<std::string> context_dex_paths;
@@ -1968,7 +2051,7 @@ int dexopt(const char* dex_path, uid_t uid, const char* pkgname, const char* ins
     if (pid == 0) {
         // Need to set schedpolicy before dropping privileges
         // for cgroup migration. See details at b/175178520.
-        SetDex2OatScheduling(boot_complete);
+        SetDex2OatScheduling(boot_complete, background_job_compile);
 
         /* child -- drop privileges before continuing */
         drop_capabilities(uid);
@@ -523,6 +523,27 @@ TEST_F(ServiceTest, GetAppSizeWrongSizes) {
                                            externalStorageAppId, ceDataInodes, codePaths,
                                            &externalStorageSize));
 }
+
+TEST_F(ServiceTest, GetAppSizeBulkWrongSizes) {
+    std::vector<int64_t> sizes;
+
+    std::vector<std::string> packageNames = {"package1", "package2"};
+    std::vector<int64_t> ceDataInodes = {0, 0};
+    std::vector<std::string> codePaths = {"/data/app/package1", "/data/app/package2"};
+    std::vector<int32_t> appIds = {10001, 10002};
+
+    // Counts must cover every entry of the per-package arrays.
+    std::vector<int32_t> packageCounts = {1};
+    EXPECT_BINDER_FAIL(service->getAppSizeBulk(std::nullopt, packageNames, 0,
+                                               InstalldNativeService::FLAG_USE_QUOTA, appIds,
+                                               ceDataInodes, codePaths, packageCounts, &sizes));
+
+    // A count may not run past the end of the arrays.
+    packageCounts = {1, 3};
+    EXPECT_BINDER_FAIL(service->getAppSizeBulk(std::nullopt, packageNames, 0,
+                                               InstalldNativeService::FLAG_USE_QUOTA, appIds,
+                                               ceDataInodes, codePaths, packageCounts, &sizes));
+}
 static bool mkdirs(const std::string& path, mode_t mode) {
     struct stat sb;
     if (stat(path.c_str(), &sb) != -1 && S_ISDIR(sb.st_mode)) {
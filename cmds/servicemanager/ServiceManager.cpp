@@ -16,6 +16,8 @@
 
 #include "ServiceManager.h"
 
+#include <inttypes.h>
+
 #include <android-base/logging.h>
 #include <android-base/properties.h>
 #include <binder/BpBinder.h>
@@ -24,6 +26,9 @@
 #include <binder/Stability.h>
 #include <cutils/android_filesystem_config.h>
 #include <cutils/multiuser.h>
+
+#include <algorithm>
+#include <chrono>
 #include <thread>
 
 #ifndef VENDORSERVICEMANAGER
@@ -241,7 +246,24 @@ Status ServiceManager::checkService(const std::string& name, sp<IBinder>* outBin
     return Status::ok();
 }
 
+// Records the lifetime of the enclosing scope into the given histogram.
+class ScopedLatencyRecorder {
+public:
+    explicit ScopedLatencyRecorder(ServiceManager::LatencyHistogram* histogram)
+        : mHistogram(histogram), mStart(std::chrono::steady_clock::now()) {}
+    ~ScopedLatencyRecorder() {
+        mHistogram->record(std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now() - mStart)
+                                   .count());
+    }
+
+private:
+    ServiceManager::LatencyHistogram* mHistogram;
+    std::chrono::steady_clock::time_point mStart;
+};
+
 sp<IBinder> ServiceManager::tryGetService(const std::string& name, bool startIfNotFound) {
+    ScopedLatencyRecorder recorder(&mGetServiceLatency);
     auto ctx = mAccess->getCallingContext();
 
     sp<IBinder> out;
@@ -369,6 +391,10 @@ Status ServiceManager::listServices(int32_t dumpPriority, std::vector<std::strin
         }
     }
 
+    // mNameToService has no defined iteration order; keep the historical
+    // sorted output.
+    std::sort(outList->begin(), outList->end());
+
     return Status::ok();
 }
 
@@ -759,7 +785,50 @@ Status ServiceManager::getServiceDebugInfo(std::vector<ServiceDebugInfo>* outRet
         outReturn->push_back(std::move(info));
     }
 
+    // mNameToService has no defined iteration order; keep the historical
+    // sorted output.
+    std::sort(outReturn->begin(), outReturn->end(),
+              [](const ServiceDebugInfo& a, const ServiceDebugInfo& b) { return a.name < b.name; });
+
     return Status::ok();
 }
 
+void ServiceManager::LatencyHistogram::record(uint64_t latencyUs) {
+    size_t bucket = 0;
+    while (bucket < kBucketCount - 1 && latencyUs >= kBucketLimitsUs[bucket]) {
+        bucket++;
+    }
+    buckets[bucket]++;
+}
+
+void ServiceManager::LatencyHistogram::dump(int fd, const char* what) const {
+    uint64_t total = 0;
+    for (uint64_t count : buckets) {
+        total += count;
+    }
+    dprintf(fd, "%s (us): total %" PRIu64, what, total);
+    for (size_t i = 0; i < kBucketCount; i++) {
+        if (i < kBucketCount - 1) {
+            dprintf(fd, " <%" PRIu64 ": %" PRIu64, kBucketLimitsUs[i], buckets[i]);
+        } else {
+            dprintf(fd, " >=%" PRIu64 ": %" PRIu64, kBucketLimitsUs[i - 1], buckets[i]);
+        }
+    }
+    dprintf(fd, "\n");
+}
+
+status_t ServiceManager::dump(int fd, const Vector<String16>& args) {
+    (void) args;
+
+    if (!mAccess->canList(mAccess->getCallingContext())) {
+        return PERMISSION_DENIED;
+    }
+
+    dprintf(fd, "Registered services: %zu\n", mNameToService.size());
+    dprintf(fd, "Registration waiters: %zu names\n", mNameToRegistrationCallback.size());
+    mGetServiceLatency.dump(fd, "Lookup latency");
+
+    return OK;
+}
+
 }  // namespace android
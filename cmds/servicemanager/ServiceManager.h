@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <array>
+#include <unordered_map>
+
 #include <android/os/BnServiceManager.h>
 #include <android/os/IClientCallback.h>
 #include <android/os/IServiceCallback.h>
@@ -55,9 +58,21 @@ public:
                                           const sp<IClientCallback>& cb) override;
     binder::Status tryUnregisterService(const std::string& name, const sp<IBinder>& binder) override;
     binder::Status getServiceDebugInfo(std::vector<ServiceDebugInfo>* outReturn) override;
+    status_t dump(int fd, const Vector<String16>& args) override;
     void binderDied(const wp<IBinder>& who) override;
     void handleClientCallbacks();
 
+    // Fixed-bucket histogram of name lookup latencies, reported by dump().
+    struct LatencyHistogram {
+        static constexpr uint64_t kBucketLimitsUs[4] = {1, 10, 100, 1000};
+        static constexpr size_t kBucketCount = 5; // one bucket per limit, plus overflow
+
+        void record(uint64_t latencyUs);
+        void dump(int fd, const char* what) const;
+
+        std::array<uint64_t, kBucketCount> buckets{};
+    };
+
 protected:
     virtual void tryStartService(const std::string& name);
 
@@ -74,9 +89,13 @@ private:
         ssize_t getNodeStrongRefCount();
     };
 
-    using ServiceCallbackMap = std::map<std::string, std::vector<sp<IServiceCallback>>>;
-    using ClientCallbackMap = std::map<std::string, std::vector<sp<IClientCallback>>>;
-    using ServiceMap = std::map<std::string, Service>;
+    // Hash maps: lookups are on the hot path of every getService/checkService
+    // call and during boot-time registration storms, where the log(n) string
+    // compares of an ordered map show up. Anything with an ordering contract
+    // (e.g. listServices) sorts its output explicitly.
+    using ServiceCallbackMap = std::unordered_map<std::string, std::vector<sp<IServiceCallback>>>;
+    using ClientCallbackMap = std::unordered_map<std::string, std::vector<sp<IClientCallback>>>;
+    using ServiceMap = std::unordered_map<std::string, Service>;
 
     // removes a callback from mNameToRegistrationCallback, removing it if the vector is empty
     // this updates iterator to the next location
@@ -96,6 +115,8 @@ private:
     ServiceCallbackMap mNameToRegistrationCallback;
     ClientCallbackMap mNameToClientCallback;
 
+    LatencyHistogram mGetServiceLatency;
+
     std::unique_ptr<Access> mAccess;
 };
 
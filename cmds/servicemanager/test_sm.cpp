@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <android-base/file.h>
 #include <android/os/BnServiceCallback.h>
 #include <binder/Binder.h>
 #include <binder/ProcessState.h>
@@ -35,6 +36,7 @@ using android::os::BnServiceCallback;
 using android::os::IServiceManager;
 using testing::_;
 using testing::ElementsAre;
+using testing::HasSubstr;
 using testing::NiceMock;
 using testing::Return;
 
@@ -306,6 +308,24 @@ TEST(ListServices, CriticalServices) {
     EXPECT_THAT(out, ElementsAre("sa"));
 }
 
+TEST(Dump, ReportsServicesAndLookupLatency) {
+    auto sm = getPermissiveServiceManager();
+
+    EXPECT_TRUE(sm->addService("foo", getBinder(), false /*allowIsolated*/,
+        IServiceManager::DUMP_FLAG_PRIORITY_DEFAULT).isOk());
+
+    sp<IBinder> out;
+    EXPECT_TRUE(sm->checkService("foo", &out).isOk());
+
+    TemporaryFile tf;
+    EXPECT_EQ(android::OK, sm->dump(tf.fd, android::Vector<android::String16>()));
+
+    std::string contents;
+    EXPECT_TRUE(android::base::ReadFileToString(tf.path, &contents));
+    EXPECT_THAT(contents, HasSubstr("Registered services: 1"));
+    EXPECT_THAT(contents, HasSubstr("Lookup latency"));
+}
+
 class CallbackHistorian : public BnServiceCallback {
     Status onRegistration(const std::string& name, const sp<IBinder>& binder) override {
         registrations.push_back(name);
@@ -47,6 +47,15 @@ void printHelpMenu() {
     std::cout << "\n  -s [Timestamp]  Specify at what timestamp should the replayer switch "
                  "to manual replay\n";
 
+    std::cout << "\n  -x [Multiplier]  Replay speed multiplier (e.g. 2 replays twice as fast)\n";
+
+    std::cout << "\n  -f [Timestamp]  Fast-forward to the specified timestamp by collapsing "
+                 "intermediate\n      transactions into state snapshots, then replay normally\n";
+
+    std::cout << "\n  -k [Nanoseconds]  Interval of trace time between snapshot keyframes while "
+                 "\n      fast-forwarding (default is " << android::DEFAULT_KEYFRAME_INTERVAL
+              << ")\n";
+
     std::cout << "  -n  Ignore timestamps and run through trace as fast as possible\n";
 
     std::cout << "  -l  Indefinitely loop the replayer\n";
@@ -63,9 +72,12 @@ int main(int argc, char** argv) {
     bool pauseBeginning = false;
     int numThreads = DEFAULT_THREADS;
     long stopHere = -1;
+    double speed = 1.0;
+    long fastForwardTo = -1;
+    long keyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
 
     int opt = 0;
-    while ((opt = getopt(argc, argv, "mt:s:nlh?")) != -1) {
+    while ((opt = getopt(argc, argv, "mt:s:x:f:k:nlh?")) != -1) {
         switch (opt) {
             case 'm':
                 pauseBeginning = true;
@@ -76,6 +88,23 @@ int main(int argc, char** argv) {
             case 's':
                 stopHere = atol(optarg);
                 break;
+            case 'x':
+                speed = atof(optarg);
+                if (speed <= 0) {
+                    std::cerr << "Replay speed must be positive...exiting" << std::endl;
+                    exit(0);
+                }
+                break;
+            case 'f':
+                fastForwardTo = atol(optarg);
+                break;
+            case 'k':
+                keyframeInterval = atol(optarg);
+                if (keyframeInterval <= 0) {
+                    std::cerr << "Keyframe interval must be positive...exiting" << std::endl;
+                    exit(0);
+                }
+                break;
             case 'n':
                 wait = false;
                 break;
@@ -102,7 +131,8 @@ int main(int argc, char** argv) {
 
     status_t status = NO_ERROR;
     do {
-        android::Replayer r(filename, pauseBeginning, numThreads, wait, stopHere);
+        android::Replayer r(filename, pauseBeginning, numThreads, wait, stopHere, speed,
+                fastForwardTo, keyframeInterval);
         status = r.replay();
     } while(loop);
 
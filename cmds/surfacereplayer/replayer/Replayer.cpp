@@ -50,12 +50,15 @@ using namespace android;
 std::atomic_bool Replayer::sReplayingManually(false);
 
 Replayer::Replayer(const std::string& filename, bool replayManually, int numThreads, bool wait,
-        nsecs_t stopHere)
+        nsecs_t stopHere, double speed, nsecs_t fastForwardTo, nsecs_t keyframeInterval)
       : mTrace(),
         mLoaded(false),
         mIncrementIndex(0),
         mCurrentTime(0),
         mNumThreads(numThreads),
+        mSpeedMultiplier(speed),
+        mFastForwardTo(fastForwardTo),
+        mKeyframeInterval(keyframeInterval),
         mWaitForTimeStamps(wait),
         mStopTimeStamp(stopHere) {
     srand(RAND_COLOR_SEED);
@@ -81,12 +84,16 @@ Replayer::Replayer(const std::string& filename, bool replayManually, int numThre
     }
 }
 
-Replayer::Replayer(const Trace& t, bool replayManually, int numThreads, bool wait, nsecs_t stopHere)
+Replayer::Replayer(const Trace& t, bool replayManually, int numThreads, bool wait, nsecs_t stopHere,
+        double speed, nsecs_t fastForwardTo, nsecs_t keyframeInterval)
       : mTrace(t),
         mLoaded(true),
         mIncrementIndex(0),
         mCurrentTime(0),
         mNumThreads(numThreads),
+        mSpeedMultiplier(speed),
+        mFastForwardTo(fastForwardTo),
+        mKeyframeInterval(keyframeInterval),
         mWaitForTimeStamps(wait),
         mStopTimeStamp(stopHere) {
     srand(RAND_COLOR_SEED);
@@ -113,6 +120,16 @@ status_t Replayer::replay() {
 
     SurfaceComposerClient::enableVSyncInjections(true);
 
+    if (mFastForwardTo > 0) {
+        status = fastForward();
+
+        if (status != NO_ERROR) {
+            ALOGE("Unable to fast-forward trace (%d)", status);
+            SurfaceComposerClient::enableVSyncInjections(false);
+            return status;
+        }
+    }
+
     initReplay();
 
     ALOGV("Starting actual Replay!");
@@ -158,7 +175,8 @@ status_t Replayer::replay() {
 }
 
 status_t Replayer::initReplay() {
-    for (int i = 0; i < mNumThreads && i < mTrace.increment_size(); i++) {
+    for (int i = mIncrementIndex;
+            i < mIncrementIndex + mNumThreads && i < mTrace.increment_size(); i++) {
         status_t status = dispatchEvent(i);
 
         if (status != NO_ERROR) {
@@ -170,6 +188,156 @@ status_t Replayer::initReplay() {
     return NO_ERROR;
 }
 
+status_t Replayer::fastForward() {
+    ALOGV("Fast-forwarding to timestamp %lld", static_cast<long long>(mFastForwardTo));
+
+    nsecs_t nextKeyframe = mTrace.increment(0).time_stamp() + mKeyframeInterval;
+
+    while (mIncrementIndex < mTrace.increment_size()) {
+        const auto& increment = mTrace.increment(mIncrementIndex);
+
+        if (increment.time_stamp() >= mFastForwardTo) {
+            break;
+        }
+
+        if (increment.time_stamp() >= nextKeyframe) {
+            status_t status = applySnapshot();
+
+            if (status != NO_ERROR) {
+                return status;
+            }
+
+            while (nextKeyframe <= increment.time_stamp()) {
+                nextKeyframe += mKeyframeInterval;
+            }
+        }
+
+        switch (increment.increment_case()) {
+            case Increment::kTransaction: {
+                // Keep only the latest change of each kind; the intermediate
+                // values are invisible once the snapshot is applied.
+                for (const SurfaceChange& change : increment.transaction().surface_change()) {
+                    mSnapshotSurfaceChanges[change.id()][change.SurfaceChange_case()] = change;
+                }
+                for (const DisplayChange& change : increment.transaction().display_change()) {
+                    mSnapshotDisplayChanges[change.id()][change.DisplayChange_case()] = change;
+                }
+            } break;
+            case Increment::kBufferUpdate: {
+                mSnapshotBufferUpdates[increment.buffer_update().id()] = Dimensions(
+                        increment.buffer_update().w(), increment.buffer_update().h());
+            } break;
+            case Increment::kVsyncEvent: {
+                mSnapshotVSync = increment.vsync_event().when();
+            } break;
+            default: {
+                // Surface and display lifetime changes cannot be collapsed.
+                // Dispatch them as usual but complete them immediately.
+                status_t status = dispatchEvent(mIncrementIndex);
+
+                if (status != NO_ERROR) {
+                    return status;
+                }
+
+                auto event = mPendingIncrements.front();
+                mPendingIncrements.pop();
+                event->complete();
+            } break;
+        }
+
+        mIncrementIndex++;
+    }
+
+    status_t status = applySnapshot();
+
+    if (status != NO_ERROR) {
+        return status;
+    }
+
+    if (mIncrementIndex < mTrace.increment_size()) {
+        mCurrentTime = mTrace.increment(mIncrementIndex).time_stamp();
+    }
+
+    ALOGV("Fast-forwarded past %d increments.", mIncrementIndex);
+
+    return NO_ERROR;
+}
+
+status_t Replayer::applySnapshot() {
+    if (mSnapshotSurfaceChanges.empty() && mSnapshotDisplayChanges.empty() &&
+            mSnapshotBufferUpdates.empty() && mSnapshotVSync < 0) {
+        return NO_ERROR;
+    }
+
+    SurfaceComposerClient::Transaction liveTransaction;
+
+    for (const auto& [layerId, changes] : mSnapshotSurfaceChanges) {
+        SurfaceChanges surfaceChanges;
+        for (const auto& [changeCase, change] : changes) {
+            *surfaceChanges.Add() = change;
+        }
+
+        status_t status = doSurfaceTransaction(liveTransaction, surfaceChanges);
+
+        if (status != NO_ERROR) {
+            return status;
+        }
+    }
+
+    for (const auto& [displayId, changes] : mSnapshotDisplayChanges) {
+        DisplayChanges displayChanges;
+        for (const auto& [changeCase, change] : changes) {
+            *displayChanges.Add() = change;
+        }
+
+        doDisplayTransaction(liveTransaction, displayChanges);
+    }
+
+    // Apply synchronously so each keyframe is fully latched before the next
+    // one is built, keeping fast-forward deterministic.
+    liveTransaction.apply(true);
+
+    std::vector<std::shared_ptr<Event>> bufferEvents;
+    {
+        std::lock_guard<std::mutex> lock1(mLayerLock);
+        std::lock_guard<std::mutex> lock2(mBufferQueueSchedulerLock);
+
+        for (const auto& [layerId, dimensions] : mSnapshotBufferUpdates) {
+            auto event = std::make_shared<Event>(Increment::kBufferUpdate);
+            BufferEvent bufferEvent(event, dimensions);
+
+            if (mBufferQueueSchedulers.count(layerId) == 0) {
+                mBufferQueueSchedulers[layerId] = std::make_shared<BufferQueueScheduler>(
+                        mLayers[layerId], mColors[layerId], layerId);
+                mBufferQueueSchedulers[layerId]->addEvent(bufferEvent);
+
+                std::thread(&BufferQueueScheduler::startScheduling,
+                        mBufferQueueSchedulers[layerId].get())
+                        .detach();
+            } else {
+                mBufferQueueSchedulers[layerId]->addEvent(bufferEvent);
+            }
+
+            bufferEvents.push_back(event);
+        }
+    }
+
+    for (const auto& event : bufferEvents) {
+        event->complete();
+    }
+
+    if (mSnapshotVSync >= 0) {
+        SurfaceComposerClient::injectVSync(mSnapshotVSync);
+    }
+
+    mSnapshotSurfaceChanges.clear();
+    mSnapshotDisplayChanges.clear();
+    mSnapshotBufferUpdates.clear();
+    mSnapshotVSync = -1;
+
+    return NO_ERROR;
+}
+
 void Replayer::stopAutoReplayHandler(int /*signal*/) {
     if (sReplayingManually) {
         SurfaceComposerClient::enableVSyncInjections(false);
@@ -654,8 +822,9 @@ void Replayer::updatePowerMode(const PowerModeUpdate& pmu, const std::shared_ptr
 }
 
 void Replayer::waitUntilTimestamp(int64_t timestamp) {
-    ALOGV("Waiting for %lld nanoseconds...", static_cast<int64_t>(timestamp - mCurrentTime));
-    std::this_thread::sleep_for(std::chrono::nanoseconds(timestamp - mCurrentTime));
+    auto delay = static_cast<nsecs_t>((timestamp - mCurrentTime) / mSpeedMultiplier);
+    ALOGV("Waiting for %lld nanoseconds...", static_cast<int64_t>(delay));
+    std::this_thread::sleep_for(std::chrono::nanoseconds(delay));
 }
 
 status_t Replayer::loadSurfaceComposerClient() {
@@ -45,6 +45,7 @@ namespace android {
 const auto DEFAULT_PATH = "/data/local/tmp/SurfaceTrace.dat";
 const auto RAND_COLOR_SEED = 700;
 const auto DEFAULT_THREADS = 3;
+const nsecs_t DEFAULT_KEYFRAME_INTERVAL = 100000000;  // 100ms of trace time
 
 typedef int32_t layer_id;
 typedef int32_t display_id;
@@ -55,14 +56,19 @@ typedef google::protobuf::RepeatedPtrField<DisplayChange> DisplayChanges;
 class Replayer {
   public:
     Replayer(const std::string& filename, bool replayManually = false,
-            int numThreads = DEFAULT_THREADS, bool wait = true, nsecs_t stopHere = -1);
+            int numThreads = DEFAULT_THREADS, bool wait = true, nsecs_t stopHere = -1,
+            double speed = 1.0, nsecs_t fastForwardTo = -1,
+            nsecs_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
     Replayer(const Trace& trace, bool replayManually = false, int numThreads = DEFAULT_THREADS,
-            bool wait = true, nsecs_t stopHere = -1);
+            bool wait = true, nsecs_t stopHere = -1, double speed = 1.0,
+            nsecs_t fastForwardTo = -1, nsecs_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
 
     status_t replay();
 
   private:
     status_t initReplay();
+    status_t fastForward();
+    status_t applySnapshot();
 
     void waitForConsoleCommmand();
     static void stopAutoReplayHandler(int signal);
@@ -136,6 +142,21 @@ class Replayer {
     int32_t mIncrementIndex = 0;
     int64_t mCurrentTime = 0;
     int32_t mNumThreads = DEFAULT_THREADS;
+    double mSpeedMultiplier = 1.0;
+    nsecs_t mFastForwardTo = -1;
+    nsecs_t mKeyframeInterval = DEFAULT_KEYFRAME_INTERVAL;
+
+    // Collapsed state accumulated while fast-forwarding. Only the latest
+    // change of each kind per layer/display is kept; applySnapshot() commits
+    // the snapshot as a single synchronous transaction at keyframe boundaries.
+    std::unordered_map<layer_id,
+            std::unordered_map<SurfaceChange::SurfaceChangeCase, SurfaceChange>>
+            mSnapshotSurfaceChanges;
+    std::unordered_map<display_id,
+            std::unordered_map<DisplayChange::DisplayChangeCase, DisplayChange>>
+            mSnapshotDisplayChanges;
+    std::unordered_map<layer_id, Dimensions> mSnapshotBufferUpdates;
+    int64_t mSnapshotVSync = -1;
 
     Increment mCurrentIncrement;
 
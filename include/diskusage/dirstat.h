@@ -0,0 +1,38 @@
+/*
+ *
+ * Copyright (C) 2022, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIBDISKUSAGE_DIRSTAT_H
+#define __LIBDISKUSAGE_DIRSTAT_H
+
+#include <stdint.h>
+
+__BEGIN_DECLS
+
+/*
+ * Measures the disk usage of the tree rooted at dfd like calculate_dir_size,
+ * but walks it with a pool of worker threads that share subdirectories through
+ * a common work queue. Takes ownership of dfd and closes it.
+ *
+ * num_threads is clamped to a small internal maximum. If cancel is non-NULL,
+ * setting *cancel to a non-zero value makes the walk stop early and return -1.
+ */
+int64_t calculate_dir_size_parallel(int dfd, int num_threads,
+        const volatile int *cancel);
+
+__END_DECLS
+
+#endif /* __LIBDISKUSAGE_DIRSTAT_H */
@@ -46,6 +46,31 @@ struct future_result<Future<T, FutureImpl>> {
 template <typename T>
 using future_result_t = typename future_result<T>::type;
 
+// Shared state between a Promise<T> and its PromisedFuture<T>. Holds the value or the
+// continuation, whichever arrives first.
+template <typename T>
+struct PromiseState {
+  std::mutex mutex;
+  std::optional<T> value;
+  std::function<void(T&&)> continuation;
+};
+
+// Delivers a value to the continuation if one is attached, or stores it until one is. The
+// continuation is invoked outside the lock, on the calling thread.
+template <typename T>
+void resolve(const std::shared_ptr<PromiseState<T>>& state, T&& value) {
+  std::function<void(T&&)> continuation;
+  {
+    const std::lock_guard lock(state->mutex);
+    if (!state->continuation) {
+      state->value.emplace(std::move(value));
+      return;
+    }
+    continuation = std::move(state->continuation);
+  }
+  continuation(std::move(value));
+}
+
 struct ValueTag {};
 
 template <typename, typename T, template <typename> class>
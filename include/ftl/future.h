@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -130,4 +134,124 @@ inline auto defer(F&& f, Args&&... args) {
   return Future(std::async(std::launch::deferred, std::forward<F>(f), std::forward<Args>(args)...));
 }
 
+template <typename T>
+class Promise;
+
+// The consuming side of a one-shot asynchronous value produced through ftl::Promise<T>. Unlike
+// Future<T>, whose std::future can only be composed by blocking, the value is delivered by
+// invoking a continuation, so no thread is parked per outstanding future.
+//
+// A continuation is attached with then(), optionally preceded by an executor that assumes
+// affinity for it. The executor is any copyable callable that accepts a nullary task, e.g. a
+// lambda that posts to a message queue or thread pool. Without an executor, the continuation
+// runs on whichever thread resolves the promise, or inline if the value is already available.
+//
+//   ftl::Promise<int> promise;
+//
+//   promise.get_future()
+//       .then([](int x) { return x + 1; })
+//       .then(executor, [](int x) { consume(x); });
+//
+//   promise.set_value(99);  // consume(100) runs as a task posted to the executor.
+//
+template <typename T>
+class PromisedFuture final {
+ public:
+  // Constructs an invalid future.
+  PromisedFuture() = default;
+
+  PromisedFuture(PromisedFuture&&) = default;
+  PromisedFuture& operator=(PromisedFuture&&) = default;
+
+  bool valid() const { return state_ != nullptr; }
+
+  // Attaches a continuation that maps T to R. Returns the future of R for further chaining,
+  // unless R is void, which ends the chain. The future is consumed either way.
+  template <typename F, typename R = std::invoke_result_t<F, T>>
+  auto then(F op) && {
+    if constexpr (std::is_void_v<R>) {
+      attach(std::move(op));
+    } else {
+      auto state = std::make_shared<details::PromiseState<R>>();
+      attach([state, op = std::move(op)](T&& value) mutable {
+        details::resolve(state, op(std::move(value)));
+      });
+      return PromisedFuture<R>(std::move(state));
+    }
+  }
+
+  // As above, but the continuation is posted to the executor as a nullary task instead of running
+  // on the resolving thread.
+  template <typename E, typename F, typename R = std::invoke_result_t<F, T>>
+  auto then(E executor, F op) && {
+    // The value is boxed because both the continuation slot and common executor task types are
+    // copyable function wrappers, whereas T may be move-only.
+    if constexpr (std::is_void_v<R>) {
+      attach([executor = std::move(executor), op = std::move(op)](T&& value) mutable {
+        auto boxed = std::make_shared<T>(std::move(value));
+        executor([boxed = std::move(boxed), op = std::move(op)]() mutable {
+          op(std::move(*boxed));
+        });
+      });
+    } else {
+      auto state = std::make_shared<details::PromiseState<R>>();
+      attach([state, executor = std::move(executor), op = std::move(op)](T&& value) mutable {
+        auto boxed = std::make_shared<T>(std::move(value));
+        executor([state, boxed = std::move(boxed), op = std::move(op)]() mutable {
+          details::resolve(state, op(std::move(*boxed)));
+        });
+      });
+      return PromisedFuture<R>(std::move(state));
+    }
+  }
+
+ private:
+  template <typename>
+  friend class Promise;
+
+  template <typename>
+  friend class PromisedFuture;
+
+  explicit PromisedFuture(std::shared_ptr<details::PromiseState<T>> state)
+      : state_(std::move(state)) {}
+
+  void attach(std::function<void(T&&)> continuation) {
+    std::optional<T> value;
+    {
+      const std::lock_guard lock(state_->mutex);
+      if (state_->value) {
+        value = std::move(state_->value);
+      } else {
+        state_->continuation = std::move(continuation);
+      }
+    }
+    if (value) {
+      continuation(std::move(*value));
+    }
+    state_.reset();
+  }
+
+  std::shared_ptr<details::PromiseState<T>> state_;
+};
+
+// The producing side of a one-shot asynchronous value, consumed through the PromisedFuture<T>
+// counterpart. If a continuation is already attached when the value is set, it is invoked (or
+// posted to its executor) on the calling thread; otherwise the value is stored until one is.
+template <typename T>
+class Promise final {
+ public:
+  Promise() : state_(std::make_shared<details::PromiseState<T>>()) {}
+
+  Promise(Promise&&) = default;
+  Promise& operator=(Promise&&) = default;
+
+  PromisedFuture<T> get_future() const { return PromisedFuture<T>(state_); }
+
+  // Resolves the promise. Must be called at most once.
+  void set_value(T value) { details::resolve(state_, std::move(value)); }
+
+ private:
+  std::shared_ptr<details::PromiseState<T>> state_;
+};
+
 }  // namespace android::ftl
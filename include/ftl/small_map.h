@@ -27,6 +27,18 @@
 
 namespace android::ftl {
 
+namespace details {
+
+// Whether a comparator E is transparent, i.e. declares an is_transparent tag type that opts in to
+// comparing keys against lookup arguments of other types, as std::equal_to<> does.
+template <typename E, typename = void>
+struct IsTransparent : std::false_type {};
+
+template <typename E>
+struct IsTransparent<E, std::void_t<typename E::is_transparent>> : std::true_type {};
+
+}  // namespace details
+
 // Associative container with unique, unordered keys. Unlike std::unordered_map, key-value pairs are
 // stored in contiguous storage for cache efficiency. The map is allocated statically until its size
 // exceeds N, at which point mappings are relocated to dynamic memory. The try_emplace operation has
@@ -82,6 +94,14 @@ class SmallMap final {
   using const_reference = typename Map::const_reference;
   using const_iterator = typename Map::const_iterator;
 
+  // A transparent comparator (one defining is_transparent, like std::equal_to<>) enables lookup
+  // overloads that compare keys against arguments of other types, e.g. std::string_view against
+  // std::string keys, without constructing (and allocating) a key.
+  template <typename Q>
+  using EnableIfTransparent =
+      std::enable_if_t<std::conjunction_v<details::IsTransparent<KeyEqual>,
+                                          std::negation<std::is_same<std::decay_t<Q>, K>>>>;
+
   // Creates an empty map.
   SmallMap() = default;
 
@@ -127,6 +147,11 @@ class SmallMap final {
     return get(key, [](const mapped_type&) {});
   }
 
+  template <typename Q, typename = EnableIfTransparent<Q>>
+  bool contains(const Q& key) const {
+    return get(key, [](const mapped_type&) {});
+  }
+
   // Returns a reference to the value for the given key, or std::nullopt if the key was not found.
   //
   //   ftl::SmallMap map = ftl::init::map('a', 'A')('b', 'B')('c', 'C');
@@ -147,6 +172,16 @@ class SmallMap final {
     return get(key, [](mapped_type& v) { return std::ref(v); });
   }
 
+  template <typename Q, typename = EnableIfTransparent<Q>>
+  auto get(const Q& key) const -> std::optional<std::reference_wrapper<const mapped_type>> {
+    return get(key, [](const mapped_type& v) { return std::cref(v); });
+  }
+
+  template <typename Q, typename = EnableIfTransparent<Q>>
+  auto get(const Q& key) -> std::optional<std::reference_wrapper<mapped_type>> {
+    return get(key, [](mapped_type& v) { return std::ref(v); });
+  }
+
   // Returns the result R of a unary operation F on (a constant or mutable reference to) the value
   // for the given key, or std::nullopt if the key was not found. If F has a return type of void,
   // then the Boolean result indicates whether the key was found.
@@ -159,18 +194,7 @@ class SmallMap final {
   template <typename F, typename R = std::invoke_result_t<F, const mapped_type&>>
   auto get(const key_type& key, F f) const
       -> std::conditional_t<std::is_void_v<R>, bool, std::optional<R>> {
-    for (auto& [k, v] : *this) {
-      if (KeyEqual{}(k, key)) {
-        if constexpr (std::is_void_v<R>) {
-          f(v);
-          return true;
-        } else {
-          return f(v);
-        }
-      }
-    }
-
-    return {};
+    return apply(key, std::move(f));
   }
 
   template <typename F>
@@ -179,10 +203,33 @@ class SmallMap final {
         key, [&f](const mapped_type& v) { return f(const_cast<mapped_type&>(v)); });
   }
 
+  template <typename Q, typename F, typename = EnableIfTransparent<Q>,
+            typename R = std::invoke_result_t<F, const mapped_type&>>
+  auto get(const Q& key, F f) const
+      -> std::conditional_t<std::is_void_v<R>, bool, std::optional<R>> {
+    return apply(key, std::move(f));
+  }
+
+  template <typename Q, typename F, typename = EnableIfTransparent<Q>>
+  auto get(const Q& key, F f) {
+    return std::as_const(*this).get(
+        key, [&f](const mapped_type& v) { return f(const_cast<mapped_type&>(v)); });
+  }
+
   // Returns an iterator to an existing mapping for the given key, or the end() iterator otherwise.
   const_iterator find(const key_type& key) const { return const_cast<SmallMap&>(*this).find(key); }
   iterator find(const key_type& key) { return find(key, begin()); }
 
+  template <typename Q, typename = EnableIfTransparent<Q>>
+  const_iterator find(const Q& key) const {
+    return const_cast<SmallMap&>(*this).find(key);
+  }
+
+  template <typename Q, typename = EnableIfTransparent<Q>>
+  iterator find(const Q& key) {
+    return find(key, begin());
+  }
+
   // Inserts a mapping unless it exists. Returns an iterator to the inserted or existing mapping,
   // and whether the mapping was inserted.
   //
@@ -238,6 +285,27 @@ class SmallMap final {
     return {it, ok};
   }
 
+  // Inserts the mappings in the range [first, last) whose keys are not already present, skipping
+  // later duplicates within the batch itself. Each element of the range must be a pair whose
+  // members construct key_type and mapped_type, respectively. Returns the number of mappings
+  // inserted.
+  //
+  // If any mapping is inserted and the map reaches its static or dynamic capacity, then all
+  // iterators are invalidated. Otherwise, only the end() iterator is invalidated.
+  //
+  template <typename InputIt>
+  size_type try_emplace_batch(InputIt first, InputIt last) {
+    size_type count = 0;
+    for (; first != last; ++first) {
+      if (find(first->first) == end()) {
+        map_.emplace_back(std::piecewise_construct, std::forward_as_tuple(first->first),
+                          std::forward_as_tuple(first->second));
+        ++count;
+      }
+    }
+    return count;
+  }
+
   // Removes a mapping if it exists, and returns whether it did.
   //
   // The last() and end() iterators, as well as those to the erased mapping, are invalidated.
@@ -251,11 +319,29 @@ class SmallMap final {
   void clear() { map_.clear(); }
 
  private:
-  iterator find(const key_type& key, iterator first) {
+  template <typename Q>
+  iterator find(const Q& key, iterator first) {
     return std::find_if(first, end(),
                         [&key](const auto& pair) { return KeyEqual{}(pair.first, key); });
   }
 
+  template <typename Q, typename F, typename R = std::invoke_result_t<F, const mapped_type&>>
+  auto apply(const Q& key, F f) const
+      -> std::conditional_t<std::is_void_v<R>, bool, std::optional<R>> {
+    for (auto& [k, v] : *this) {
+      if (KeyEqual{}(k, key)) {
+        if constexpr (std::is_void_v<R>) {
+          f(v);
+          return true;
+        } else {
+          return f(v);
+        }
+      }
+    }
+
+    return {};
+  }
+
   bool erase(const key_type& key, iterator first) {
     const auto it = find(key, first);
     if (it == end()) return false;
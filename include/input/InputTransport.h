@@ -31,6 +31,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <android-base/chrono_utils.h>
 #include <android-base/result.h>
@@ -271,6 +272,20 @@ public:
      */
     status_t sendMessage(const InputMessage* msg);
 
+    /* Send several messages to the other endpoint with a single syscall.
+     *
+     * Each message is delivered as a separate packet, exactly as if sendMessage had been
+     * called for each of them in order. The number of messages actually sent is returned
+     * in outSent; on WOULD_BLOCK the remaining messages are guaranteed not to have been
+     * sent at all and can be retried after the consumer has caught up.
+     *
+     * Return OK on success.
+     * Return WOULD_BLOCK if the channel filled up before all messages were sent.
+     * Return DEAD_OBJECT if the channel's peer has been closed.
+     * Other errors probably indicate that the channel is broken.
+     */
+    status_t sendMessages(const InputMessage* msgs, size_t count, size_t* outSent);
+
     /* Receive a message sent by the other endpoint.
      *
      * If there is no message present, try again after poll() indicates that the fd
@@ -355,6 +370,11 @@ public:
                              int32_t repeatCount, nsecs_t downTime, nsecs_t eventTime);
 
     /* Publishes a motion event to the input channel.
+     *
+     * Move and hover-move events are not sent immediately: they are accumulated and
+     * flushed with a single syscall when a different kind of event is published, when
+     * the batch fills up, or when flushMotionEvents is called. Publishers must call
+     * flushMotionEvents once they have no further events to publish for the moment.
      *
      * Returns OK on success.
      * Returns WOULD_BLOCK if the channel is full.
@@ -409,6 +429,18 @@ public:
      */
     status_t publishTouchModeEvent(uint32_t seq, int32_t eventId, bool isInTouchMode);
 
+    /* Sends any accumulated move events to the input channel.
+     *
+     * On WOULD_BLOCK the unsent events stay queued and are retried by the next publish
+     * or flush call, so ordering is preserved.
+     *
+     * Returns OK on success or if there was nothing to flush.
+     * Returns WOULD_BLOCK if the channel filled up before all events were sent.
+     * Returns DEAD_OBJECT if the channel's peer has been closed.
+     * Other errors probably indicate that the channel is broken.
+     */
+    status_t flushMotionEvents();
+
     struct Finished {
         uint32_t seq;
         bool handled;
@@ -445,6 +477,11 @@ public:
 
 private:
     std::shared_ptr<InputChannel> mChannel;
+
+    // Move events awaiting a flush. Kept small so that a full batch still fits comfortably
+    // in the socket buffer alongside whatever the consumer has not yet drained.
+    static constexpr size_t kMaxPendingMotionMessages = 8;
+    std::vector<InputMessage> mPendingMotionMessages;
 };
 
 /*
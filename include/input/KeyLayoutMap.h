@@ -23,6 +23,8 @@
 #include <utils/KeyedVector.h>
 #include <utils/Tokenizer.h>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <input/InputDevice.h>
 
@@ -101,7 +103,13 @@ private:
     };
 
     KeyedVector<int32_t, Key> mKeysByScanCode;
-    KeyedVector<int32_t, Key> mKeysByUsageCode;
+    // Scan codes are small, dense kernel constants, so a table indexed directly by scan code is
+    // built after parsing to avoid a binary search on every key event. Each slot holds the index
+    // of the entry in mKeysByScanCode, or -1 if the scan code is unmapped. Scan codes beyond the
+    // table fall back to searching mKeysByScanCode.
+    std::vector<ssize_t> mKeyIndexByScanCode;
+    // HID usage codes are sparse (32-bit page:id pairs), so they stay in a hash table.
+    std::unordered_map<int32_t, Key> mKeysByUsageCode;
     KeyedVector<int32_t, AxisInfo> mAxes;
     KeyedVector<int32_t, Led> mLedsByScanCode;
     KeyedVector<int32_t, Led> mLedsByUsageCode;
@@ -111,6 +119,7 @@ private:
 
     KeyLayoutMap();
 
+    void buildKeyIndexByScanCode();
     const Key* getKey(int32_t scanCode, int32_t usageCode) const;
 
     class Parser {
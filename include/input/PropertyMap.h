@@ -22,6 +22,7 @@
 #include <utils/KeyedVector.h>
 #include <utils/String8.h>
 #include <utils/Tokenizer.h>
+#include <memory>
 
 namespace android {
 
@@ -81,6 +82,16 @@ public:
     /* Loads a property map from a file. */
     static android::base::Result<std::unique_ptr<PropertyMap>> load(const char* filename);
 
+    /* Loads a property map from a file, returning a cached instance if the file was loaded
+     * before and has not changed since (judged by its size and modification time).
+     *
+     * Device configuration files are parsed every time a device is added, and hotplug-heavy
+     * setups re-add devices with identical configurations constantly; with this, all of those
+     * share one immutable parsed map instead of re-tokenizing the file each time.
+     */
+    static android::base::Result<std::shared_ptr<const PropertyMap>> loadShared(
+            const char* filename);
+
 private:
     class Parser {
         PropertyMap* mMap;
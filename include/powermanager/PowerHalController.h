@@ -67,8 +67,10 @@ private:
     std::unique_ptr<HalConnector> mHalConnector;
 
     // Shared pointers to keep global pointer and allow local copies to be used in
-    // different threads
-    std::shared_ptr<HalWrapper> mConnectedHal GUARDED_BY(mConnectedHalMutex) = nullptr;
+    // different threads. Readers take a lock-free snapshot via std::atomic_load;
+    // |mConnectedHalMutex| only serializes (re)connection attempts, and all writes
+    // go through std::atomic_store while holding it.
+    std::shared_ptr<HalWrapper> mConnectedHal = nullptr;
     const std::shared_ptr<HalWrapper> mDefaultHal = std::make_shared<EmptyHalWrapper>();
 
     std::shared_ptr<HalWrapper> initHal();
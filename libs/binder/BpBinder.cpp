@@ -19,6 +19,7 @@
 
 #include <binder/BpBinder.h>
 
+#include <android-base/stringprintf.h>
 #include <binder/IPCThreadState.h>
 #include <binder/IResultReceiver.h>
 #include <binder/RpcSession.h>
@@ -26,8 +27,11 @@
 #include <cutils/compiler.h>
 #include <utils/Log.h>
 
+#include <inttypes.h>
 #include <stdio.h>
 
+#include <atomic>
+
 //#undef ALOGV
 //#define ALOGV(...) fprintf(stderr, __VA_ARGS__)
 
@@ -56,6 +60,31 @@ enum {
     COUNTING_VALUE_MASK = 0x7FFFFFFF,       // A mask of the remaining bits for the count value
 };
 
+// ---------------------------------------------------------------------------
+// Always-on proxy census. Proxy construction and destruction each touch a
+// single cache-line-sized shard, so unlike the count-by-uid tracking above
+// this stays enabled in production and covers RPC binders as well.
+
+static constexpr size_t kProxyCensusShards = 16; // must be a power of two
+
+struct alignas(64) ProxyCensusShard {
+    std::atomic<int32_t> count{0};
+};
+static ProxyCensusShard sProxyCensusShards[kProxyCensusShards];
+
+static ProxyCensusShard& proxyCensusShardFor(const BpBinder* binder) {
+    // Proxies are heap allocated, so skip past the low pointer bits the
+    // allocator keeps aligned before picking a shard.
+    const uintptr_t p = reinterpret_cast<uintptr_t>(binder);
+    return sProxyCensusShards[(p >> 6) & (kProxyCensusShards - 1)];
+}
+
+// Guards the per-interface attribution below. Only taken when a proxy's
+// descriptor is first resolved and when an attributed proxy is destroyed,
+// never on the creation path.
+static Mutex sProxyCensusLock;
+static std::map<String16, uint32_t> sProxyCountByInterface;
+
 BpBinder::ObjectManager::ObjectManager()
 {
 }
@@ -174,6 +203,7 @@ BpBinder::BpBinder(Handle&& handle)
         mObituaries(nullptr),
         mTrackedUid(-1) {
     extendObjectLifetime(OBJECT_LIFETIME_WEAK);
+    proxyCensusShardFor(this).count.fetch_add(1, std::memory_order_relaxed);
 }
 
 BpBinder::BpBinder(BinderHandle&& handle, int32_t trackedUid) : BpBinder(Handle(handle)) {
@@ -232,8 +262,13 @@ const String16& BpBinder::getInterfaceDescriptor() const
             Mutex::Autolock _l(mLock);
             // mDescriptorCache could have been assigned while the lock was
             // released.
-            if (mDescriptorCache.size() == 0)
+            if (mDescriptorCache.size() == 0) {
                 mDescriptorCache = res;
+                if (res.size() != 0) {
+                    AutoMutex _c(sProxyCensusLock);
+                    sProxyCountByInterface[res]++;
+                }
+            }
         }
     }
 
@@ -473,6 +508,15 @@ BpBinder::~BpBinder()
 {
     ALOGV("Destroying BpBinder %p handle %d\n", this, binderHandle());
 
+    proxyCensusShardFor(this).count.fetch_sub(1, std::memory_order_relaxed);
+    if (mDescriptorCache.size() != 0) {
+        AutoMutex _l(sProxyCensusLock);
+        auto it = sProxyCountByInterface.find(mDescriptorCache);
+        if (it != sProxyCountByInterface.end() && --it->second == 0) {
+            sProxyCountByInterface.erase(it);
+        }
+    }
+
     if (CC_UNLIKELY(isRpcBinder())) return;
 
     IPCThreadState* ipc = IPCThreadState::self();
@@ -593,6 +637,36 @@ void BpBinder::setBinderProxyCountWatermarks(int high, int low) {
     sBinderProxyCountLowWatermark = low;
 }
 
+uint32_t BpBinder::getTotalBinderProxyCount() {
+    int32_t total = 0;
+    for (const auto& shard : sProxyCensusShards) {
+        total += shard.count.load(std::memory_order_relaxed);
+    }
+    // Concurrent creations and destructions can make the unsynchronized sum
+    // transiently negative; report that as zero rather than wrapping.
+    return total > 0 ? static_cast<uint32_t>(total) : 0;
+}
+
+void BpBinder::getProxyCountsByInterface(std::map<String16, uint32_t>* counts) {
+    AutoMutex _l(sProxyCensusLock);
+    *counts = sProxyCountByInterface;
+}
+
+void BpBinder::dumpProxyCensus(std::string* out) {
+    const uint32_t total = getTotalBinderProxyCount();
+    base::StringAppendF(out, "Binder proxies alive: %" PRIu32 "\n", total);
+    AutoMutex _l(sProxyCensusLock);
+    uint32_t attributed = 0;
+    for (const auto& [descriptor, count] : sProxyCountByInterface) {
+        base::StringAppendF(out, "  %7" PRIu32 "  %s\n", count, String8(descriptor).c_str());
+        attributed += count;
+    }
+    if (total > attributed) {
+        base::StringAppendF(out, "  %7" PRIu32 "  <descriptor not yet resolved>\n",
+                            total - attributed);
+    }
+}
+
 // ---------------------------------------------------------------------------
 
 } // namespace android
@@ -20,6 +20,7 @@
 #include <stdatomic.h>
 
 #include <fcntl.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -32,8 +33,11 @@
 #include <log/log.h>
 
 #include <utils/Mutex.h>
+#include <utils/Timers.h>
 
 #include <map>
+#include <memory>
+#include <vector>
 
 #define VERBOSE   0
 
@@ -58,15 +62,41 @@ private:
     struct heap_info_t {
         sp<IMemoryHeap> heap;
         int32_t         count;
-        // Note that this cannot be meaningfully copied.
+    };
+
+    using HeapMap = std::map<wp<IBinder>, heap_info_t>;
+
+    // A heap whose reference count dropped to zero. It stays mapped until its
+    // retention window expires so that a quick re-user doesn't pay for a fresh
+    // mmap (and the minor faults that come with it).
+    struct pending_heap_t {
+        sp<IMemoryHeap> heap;
+        nsecs_t         freedAt;
     };
 
     void free_heap(const wp<IBinder>& binder);
 
-    Mutex mHeapCacheLock;  // Protects entire vector below.
-    std::map<wp<IBinder>, heap_info_t> mHeapCache;
-    // We do not use the copy-on-write capabilities of KeyedVector.
-    // TODO: Reimplemement based on standard C++ container?
+    // Replaces the published snapshot. Caller must hold mHeapCacheLock.
+    void publishLocked(HeapMap&& map);
+    // Removes pending heaps whose retention window has expired and returns
+    // them so the caller can release them (and unmap) outside the lock.
+    // Caller must hold mHeapCacheLock.
+    std::vector<sp<IMemoryHeap>> reclaimExpiredLocked(nsecs_t now);
+
+    // How long an unreferenced heap stays mapped.
+    static constexpr nsecs_t kHeapRetentionNs = 1000000000; // 1s
+
+    Mutex mHeapCacheLock;  // Serializes writers; readers use the snapshot.
+    // Immutable snapshot of the cache, replaced wholesale on modification so
+    // lookups don't need the lock. Always non-null; accessed with
+    // std::atomic_load/atomic_store.
+    std::shared_ptr<const HeapMap> mHeapCacheSnapshot;
+    std::map<wp<IBinder>, pending_heap_t> mPendingFree; // Guarded by mHeapCacheLock.
+
+    std::atomic<uint64_t> mHits{0};        // Lookups served from the snapshot.
+    std::atomic<uint64_t> mMisses{0};      // Lookups that created a new mapping.
+    std::atomic<uint64_t> mResurrected{0}; // Heaps rescued from the pending list.
+    std::atomic<uint64_t> mReclaimed{0};   // Heaps actually unmapped.
 };
 
 static sp<HeapCache> gHeapCache = sp<HeapCache>::make();
@@ -418,7 +448,8 @@ status_t BnMemoryHeap::onTransact(
 /*****************************************************************************/
 
 HeapCache::HeapCache()
-    : DeathRecipient()
+    : DeathRecipient(),
+      mHeapCacheSnapshot(std::make_shared<const HeapMap>())
 {
 }
 
@@ -432,30 +463,70 @@ void HeapCache::binderDied(const wp<IBinder>& binder)
     free_heap(binder);
 }
 
+void HeapCache::publishLocked(HeapMap&& map)
+{
+    std::atomic_store_explicit(&mHeapCacheSnapshot,
+            std::shared_ptr<const HeapMap>(std::make_shared<HeapMap>(std::move(map))),
+            std::memory_order_release);
+}
+
+std::vector<sp<IMemoryHeap>> HeapCache::reclaimExpiredLocked(nsecs_t now)
+{
+    std::vector<sp<IMemoryHeap>> expired;
+    for (auto i = mPendingFree.begin(); i != mPendingFree.end();) {
+        if (now - i->second.freedAt >= kHeapRetentionNs) {
+            ALOGD_IF(VERBOSE, "reclaiming binder=%p, heap=%p",
+                    i->first.unsafe_get(), i->second.heap.get());
+            expired.push_back(std::move(i->second.heap));
+            i = mPendingFree.erase(i);
+            mReclaimed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ++i;
+        }
+    }
+    return expired;
+}
+
 sp<IMemoryHeap> HeapCache::find_heap(const sp<IBinder>& binder)
 {
-    Mutex::Autolock _l(mHeapCacheLock);
-    auto i = mHeapCache.find(binder);
-    if (i != mHeapCache.end()) {
-        heap_info_t& info = i->second;
-        ALOGD_IF(VERBOSE,
-                "found binder=%p, heap=%p, size=%zu, fd=%d, count=%d",
-                binder.get(), info.heap.get(),
-                static_cast<BpMemoryHeap*>(info.heap.get())->mSize,
-                static_cast<BpMemoryHeap*>(info.heap.get())
-                    ->mHeapId.load(memory_order_relaxed),
-                info.count);
-        ++info.count;
-        return info.heap;
-    } else {
-        heap_info_t info;
-        info.heap = interface_cast<IMemoryHeap>(binder);
-        info.count = 1;
-        //ALOGD("adding binder=%p, heap=%p, count=%d",
-        //      binder.get(), info.heap.get(), info.count);
-        mHeapCache.insert({binder, info});
-        return info.heap;
+    sp<IMemoryHeap> heap;
+    std::vector<sp<IMemoryHeap>> expired;
+    {
+        Mutex::Autolock _l(mHeapCacheLock);
+        const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+        HeapMap map(*mHeapCacheSnapshot);
+        auto i = map.find(binder);
+        if (i != map.end()) {
+            heap_info_t& info = i->second;
+            ALOGD_IF(VERBOSE,
+                    "found binder=%p, heap=%p, size=%zu, fd=%d, count=%d",
+                    binder.get(), info.heap.get(),
+                    static_cast<BpMemoryHeap*>(info.heap.get())->mSize,
+                    static_cast<BpMemoryHeap*>(info.heap.get())
+                        ->mHeapId.load(memory_order_relaxed),
+                    info.count);
+            ++info.count;
+            heap = info.heap;
+            mHits.fetch_add(1, std::memory_order_relaxed);
+        } else if (auto p = mPendingFree.find(binder); p != mPendingFree.end()) {
+            // The heap is still mapped and waiting out its retention window;
+            // rescue it instead of mapping the same heap again.
+            heap = std::move(p->second.heap);
+            mPendingFree.erase(p);
+            map.insert({binder, {heap, 1}});
+            mResurrected.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            heap = interface_cast<IMemoryHeap>(binder);
+            //ALOGD("adding binder=%p, heap=%p, count=%d",
+            //      binder.get(), heap.get(), 1);
+            map.insert({binder, {heap, 1}});
+            mMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+        publishLocked(std::move(map));
+        expired = reclaimExpiredLocked(now);
     }
+    // expired heaps are released (and unmapped) here, outside the lock.
+    return heap;
 }
 
 void HeapCache::free_heap(const sp<IBinder>& binder)  {
@@ -464,51 +535,65 @@ void HeapCache::free_heap(const sp<IBinder>& binder)  {
 
 void HeapCache::free_heap(const wp<IBinder>& binder)
 {
-    sp<IMemoryHeap> rel;
+    std::vector<sp<IMemoryHeap>> expired;
     {
         Mutex::Autolock _l(mHeapCacheLock);
-        auto i = mHeapCache.find(binder);
-        if (i != mHeapCache.end()) {
+        const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+        HeapMap map(*mHeapCacheSnapshot);
+        auto i = map.find(binder);
+        if (i != map.end()) {
             heap_info_t& info = i->second;
             if (--info.count == 0) {
                 ALOGD_IF(VERBOSE,
-                        "removing binder=%p, heap=%p, size=%zu, fd=%d, count=%d",
+                        "retiring binder=%p, heap=%p, size=%zu, fd=%d, count=%d",
                         binder.unsafe_get(), info.heap.get(),
                         static_cast<BpMemoryHeap*>(info.heap.get())->mSize,
                         static_cast<BpMemoryHeap*>(info.heap.get())
                             ->mHeapId.load(memory_order_relaxed),
                         info.count);
-                rel = i->second.heap;
-                mHeapCache.erase(i);
+                // Don't unmap yet; park the heap so a quick re-user can
+                // rescue the mapping before the retention window expires.
+                mPendingFree[binder] = {std::move(info.heap), now};
+                map.erase(i);
             }
+            publishLocked(std::move(map));
         } else {
             ALOGE("free_heap binder=%p not found!!!", binder.unsafe_get());
         }
+        expired = reclaimExpiredLocked(now);
     }
+    // expired heaps are released (and unmapped) here, outside the lock.
 }
 
 sp<IMemoryHeap> HeapCache::get_heap(const sp<IBinder>& binder)
 {
-    sp<IMemoryHeap> realHeap;
-    Mutex::Autolock _l(mHeapCacheLock);
-    auto i = mHeapCache.find(binder);
-    if (i != mHeapCache.end())
-        realHeap = i->second.heap;
-    else
-        realHeap = interface_cast<IMemoryHeap>(binder);
-    return realHeap;
+    // Hot lookup path: resolve against the immutable snapshot, no lock taken.
+    std::shared_ptr<const HeapMap> snapshot =
+            std::atomic_load_explicit(&mHeapCacheSnapshot, std::memory_order_acquire);
+    auto i = snapshot->find(binder);
+    if (i != snapshot->end()) {
+        mHits.fetch_add(1, std::memory_order_relaxed);
+        return i->second.heap;
+    }
+    mMisses.fetch_add(1, std::memory_order_relaxed);
+    return interface_cast<IMemoryHeap>(binder);
 }
 
 void HeapCache::dump_heaps()
 {
     Mutex::Autolock _l(mHeapCacheLock);
-    for (const auto& i : mHeapCache) {
+    for (const auto& i : *mHeapCacheSnapshot) {
         const heap_info_t& info = i.second;
         BpMemoryHeap const* h(static_cast<BpMemoryHeap const *>(info.heap.get()));
         ALOGD("hey=%p, heap=%p, count=%d, (fd=%d, base=%p, size=%zu)", i.first.unsafe_get(),
               info.heap.get(), info.count, h->mHeapId.load(memory_order_relaxed), h->mBase,
               h->mSize);
     }
+    ALOGD("heap cache stats: pending=%zu hits=%" PRIu64 " misses=%" PRIu64 " resurrected=%" PRIu64
+          " reclaimed=%" PRIu64,
+          mPendingFree.size(), mHits.load(std::memory_order_relaxed),
+          mMisses.load(std::memory_order_relaxed), mResurrected.load(std::memory_order_relaxed),
+          mReclaimed.load(std::memory_order_relaxed));
 }
 
 
@@ -31,6 +31,7 @@
 #include <atomic>
 #include <errno.h>
 #include <inttypes.h>
+#include <poll.h>
 #include <pthread.h>
 #include <sched.h>
 #include <signal.h>
@@ -508,6 +509,35 @@ void IPCThreadState::flushCommands()
     }
 }
 
+void IPCThreadState::beginBatch()
+{
+    mBatchDepth++;
+}
+
+status_t IPCThreadState::endBatch()
+{
+    LOG_ALWAYS_FATAL_IF(mBatchDepth <= 0, "endBatch() without matching beginBatch()");
+    if (--mBatchDepth > 0) return NO_ERROR;
+    return flushBatchedOneways();
+}
+
+status_t IPCThreadState::flushBatchedOneways()
+{
+    status_t err = NO_ERROR;
+    // The first waitForResponse() pushes every queued transaction to the
+    // driver with a single BINDER_WRITE_READ; the remaining iterations
+    // consume the per-transaction BR_TRANSACTION_COMPLETE commands, which
+    // usually arrive in the same read buffer without further syscalls.
+    while (mBatchedOneways > 0) {
+        mBatchedOneways--;
+        status_t result = waitForResponse(nullptr, nullptr);
+        if (err == NO_ERROR) err = result;
+    }
+    // The driver has copied every queued payload out of our buffers by now.
+    mBatchedTransactionData.clear();
+    return err;
+}
+
 bool IPCThreadState::flushIfNeeded()
 {
     if (mIsLooper || mServingStackPointer != nullptr || mIsFlushing) {
@@ -557,6 +587,7 @@ status_t IPCThreadState::getAndExecuteCommand()
         if (mProcess->mExecutingThreadsCount >= mProcess->mMaxThreads &&
                 mProcess->mStarvationStartTimeMs == 0) {
             mProcess->mStarvationStartTimeMs = uptimeMillis();
+            mProcess->mStarvationEvents++;
         }
         pthread_mutex_unlock(&mProcess->mThreadCountLock);
 
@@ -642,9 +673,41 @@ void IPCThreadState::joinThreadPool(bool isMain)
     mOut.writeInt32(isMain ? BC_ENTER_LOOPER : BC_REGISTER_LOOPER);
 
     mIsLooper = true;
+    pthread_mutex_lock(&mProcess->mThreadCountLock);
+    mProcess->mCurrentThreads++;
+    pthread_mutex_unlock(&mProcess->mThreadCountLock);
+    bool retired = false;
     status_t result;
     do {
         processPendingDerefs();
+
+        // If idle retirement is enabled, wait for work with a timeout instead
+        // of parking in the driver indefinitely, so this thread's stack can be
+        // reclaimed once the pool has been oversized for a while.
+        if (!isMain && mIn.dataPosition() >= mIn.dataSize()) {
+            pthread_mutex_lock(&mProcess->mThreadCountLock);
+            const int64_t idleTimeoutMs = mProcess->mThreadPoolIdleTimeoutMs;
+            pthread_mutex_unlock(&mProcess->mThreadCountLock);
+            if (idleTimeoutMs > 0) {
+                // The driver only sees this thread as a waiting looper once
+                // pending commands (BC_REGISTER_LOOPER in particular) are sent.
+                if (mOut.dataSize() > 0) flushCommands();
+                struct pollfd pfd = {mProcess->mDriverFD, POLLIN, 0};
+                const int events = TEMP_FAILURE_RETRY(
+                        poll(&pfd, 1, static_cast<int>(idleTimeoutMs)));
+                if (events == 0 && mProcess->attemptThreadRetire()) {
+                    // Exiting releases this thread's looper slot in the driver
+                    // (through BINDER_THREAD_EXIT), so the driver will request
+                    // a replacement (BR_SPAWN_LOOPER) if load comes back.
+                    retired = true;
+                    result = TIMED_OUT;
+                    break;
+                }
+                // Either work arrived or the pool is at its floor: fall
+                // through and (possibly) block in the driver.
+            }
+        }
+
         // now get the next command to be processed, waiting if necessary
         result = getAndExecuteCommand();
 
@@ -663,6 +726,13 @@ void IPCThreadState::joinThreadPool(bool isMain)
     LOG_THREADPOOL("**** THREAD %p (PID %d) IS LEAVING THE THREAD POOL err=%d\n",
         (void*)pthread_self(), getpid(), result);
 
+    if (!retired) {
+        // attemptThreadRetire() already dropped the count for retired threads.
+        pthread_mutex_lock(&mProcess->mThreadCountLock);
+        mProcess->mCurrentThreads--;
+        pthread_mutex_unlock(&mProcess->mThreadCountLock);
+    }
+
     mOut.writeInt32(BC_EXIT_LOOPER);
     mIsLooper = false;
     talkWithDriver(false);
@@ -722,6 +792,32 @@ status_t IPCThreadState::transact(int32_t handle,
 
     LOG_ONEWAY(">>>> SEND from pid %d uid %d %s", getpid(), getuid(),
         (flags & TF_ONE_WAY) == 0 ? "READ REPLY" : "ONE WAY");
+
+    // A synchronous call issued inside a batch scope must not outrun the
+    // queued oneway transactions' completions, so drain them first.
+    if ((flags & TF_ONE_WAY) == 0 && mBatchedOneways > 0) {
+        (void)flushBatchedOneways();
+    }
+
+    if ((flags & TF_ONE_WAY) != 0 && mBatchDepth > 0) {
+        // The queued binder_transaction_data points at the sender's buffers,
+        // which the kernel only copies at the deferred flush ioctl, while
+        // callers are free to destroy or reuse `data` as soon as we return.
+        // Queue against an owned copy that lives until the flush.
+        Parcel& owned = mBatchedTransactionData.emplace_back();
+        err = owned.appendFrom(&data, 0, data.dataSize());
+        if (err == NO_ERROR) {
+            err = writeTransactionData(BC_TRANSACTION, flags, handle, code, owned, nullptr);
+        }
+        if (err != NO_ERROR) {
+            mBatchedTransactionData.pop_back();
+            if (reply) reply->setError(err);
+            return (mLastError = err);
+        }
+        mBatchedOneways++;
+        return NO_ERROR;
+    }
+
     err = writeTransactionData(BC_TRANSACTION, flags, handle, code, data, nullptr);
 
     if (err != NO_ERROR) {
@@ -871,6 +967,8 @@ IPCThreadState::IPCThreadState()
         mPropagateWorkSource(false),
         mIsLooper(false),
         mIsFlushing(false),
+        mBatchDepth(0),
+        mBatchedOneways(0),
         mStrictModePolicy(0),
         mLastTransactionBinderFlags(0),
         mCallRestriction(mProcess->mCallRestriction) {
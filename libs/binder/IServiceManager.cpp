@@ -21,6 +21,9 @@
 #include <inttypes.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <set>
+
 #include <android/os/BnServiceCallback.h>
 #include <android/os/IServiceManager.h>
 #include <binder/IPCThreadState.h>
@@ -123,6 +126,19 @@ protected:
                                           ServiceCallbackMap::iterator* it,
                                           sp<RegistrationWaiter>* waiter);
 
+    // Client-side lookup cache (see android::enableServiceCache()). Entries
+    // are refreshed by servicemanager registration callbacks and evicted
+    // when the cached binder dies.
+    class CacheCallback;
+    void cacheService(const std::string& name, const sp<IBinder>& binder) const;
+    void onCachedServiceRegistered(const std::string& name, const sp<IBinder>& binder);
+    void onCachedServiceDied(const wp<IBinder>& who);
+    mutable std::mutex mCachedServicesLock;
+    mutable std::map<std::string, sp<IBinder>> mCachedServices;
+    // Names with a live registration callback; registered at most once each.
+    mutable std::set<std::string> mCacheRegisteredNames;
+    mutable sp<CacheCallback> mCacheCallback;
+
     // Directly get the service in a way that, for lazy services, requests the service to be started
     // if it is not currently started. This way, calls directly to ServiceManagerShim::getService
     // will still have the 5s delay that is expected by a large amount of Android code.
@@ -134,6 +150,30 @@ protected:
     }
 };
 
+class ServiceManagerShim::CacheCallback : public android::os::BnServiceCallback,
+                                          public IBinder::DeathRecipient {
+public:
+    explicit CacheCallback(ServiceManagerShim* shim) : mShim(shim) {}
+
+    Status onRegistration(const std::string& name, const sp<IBinder>& binder) override {
+        mShim->onCachedServiceRegistered(name, binder);
+        return Status::ok();
+    }
+
+    void binderDied(const wp<IBinder>& who) override { mShim->onCachedServiceDied(who); }
+
+private:
+    // The default service manager shim is never destroyed.
+    ServiceManagerShim* const mShim;
+};
+
+// Process-wide opt-in for the ServiceManagerShim lookup cache.
+static std::atomic<bool> gServiceCacheEnabled(false);
+
+void enableServiceCache(bool enable) {
+    gServiceCacheEnabled.store(enable, std::memory_order_relaxed);
+}
+
 [[clang::no_destroy]] static std::once_flag gSmOnce;
 [[clang::no_destroy]] static sp<IServiceManager> gDefaultServiceManager;
 
@@ -305,13 +345,78 @@ sp<IBinder> ServiceManagerShim::getService(const String16& name) const
 
 sp<IBinder> ServiceManagerShim::checkService(const String16& name) const
 {
+    std::string nameStr = String8(name).c_str();
+
+    if (gServiceCacheEnabled.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mCachedServicesLock);
+        auto it = mCachedServices.find(nameStr);
+        if (it != mCachedServices.end()) {
+            return it->second;
+        }
+    }
+
     sp<IBinder> ret;
-    if (!mTheRealServiceManager->checkService(String8(name).c_str(), &ret).isOk()) {
+    if (!mTheRealServiceManager->checkService(nameStr, &ret).isOk()) {
         return nullptr;
     }
+    if (ret != nullptr && gServiceCacheEnabled.load(std::memory_order_relaxed)) {
+        cacheService(nameStr, ret);
+    }
     return ret;
 }
 
+void ServiceManagerShim::cacheService(const std::string& name, const sp<IBinder>& binder) const
+{
+    auto* self = const_cast<ServiceManagerShim*>(this);
+    std::lock_guard<std::mutex> lock(mCachedServicesLock);
+    if (mCachedServices.find(name) != mCachedServices.end()) {
+        return;
+    }
+    if (mCacheCallback == nullptr) {
+        mCacheCallback = sp<CacheCallback>::make(self);
+    }
+    // Without the registration callback the entry could go stale across a
+    // service restart, so only cache when both the callback registration and
+    // the death link are in place.
+    if (mCacheRegisteredNames.find(name) == mCacheRegisteredNames.end()) {
+        if (!mTheRealServiceManager->registerForNotifications(name, mCacheCallback).isOk()) {
+            return;
+        }
+        mCacheRegisteredNames.insert(name);
+    }
+    if (binder->linkToDeath(mCacheCallback) != OK) {
+        return;
+    }
+    mCachedServices[name] = binder;
+}
+
+void ServiceManagerShim::onCachedServiceRegistered(const std::string& name,
+                                                   const sp<IBinder>& binder)
+{
+    std::lock_guard<std::mutex> lock(mCachedServicesLock);
+    auto it = mCachedServices.find(name);
+    if (it == mCachedServices.end()) {
+        return;
+    }
+    if (binder == nullptr || binder->linkToDeath(mCacheCallback) != OK) {
+        mCachedServices.erase(it);
+        return;
+    }
+    it->second = binder;
+}
+
+void ServiceManagerShim::onCachedServiceDied(const wp<IBinder>& who)
+{
+    std::lock_guard<std::mutex> lock(mCachedServicesLock);
+    for (auto it = mCachedServices.begin(); it != mCachedServices.end();) {
+        if (wp<IBinder>(it->second) == who) {
+            it = mCachedServices.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 status_t ServiceManagerShim::addService(const String16& name, const sp<IBinder>& service,
                                         bool allowIsolated, int dumpsysPriority)
 {
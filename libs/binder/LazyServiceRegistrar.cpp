@@ -24,6 +24,10 @@
 #include <android/os/IServiceManager.h>
 #include <utils/Log.h>
 
+#include <inttypes.h>
+
+#include <thread>
+
 namespace android {
 namespace binder {
 namespace internal {
@@ -40,6 +44,10 @@ public:
 
     void setActiveServicesCallback(const std::function<bool(bool)>& activeServicesCallback);
 
+    void setShutdownIdleDelay(std::chrono::milliseconds delay);
+
+    LazyServiceRegistrar::ShutdownStats getShutdownStats();
+
     bool tryUnregisterLocked();
 
     void reRegisterLocked();
@@ -78,9 +86,18 @@ private:
      * - 'forcePersist' is 'true', or
      * - The active services count callback returns 'true', or
      * - Some services have clients.
+     *
+     * If an idle delay has been configured, the shutdown decision is deferred
+     * until the process has stayed idle for that long.
      */
     void maybeTryShutdownLocked();
 
+    /**
+     * Called once a deferred shutdown's idle window elapses. Shuts the process
+     * down if the window wasn't invalidated by a reconnecting client.
+     */
+    void onIdleWindowExpired(uint64_t generation);
+
     // for below
     std::mutex mMutex;
 
@@ -95,6 +112,19 @@ private:
 
     bool mForcePersist;
 
+    // how long all services must stay without clients before the process shuts
+    // down; zero means shut down as soon as the client count drops to zero
+    std::chrono::milliseconds mShutdownIdleDelay{0};
+
+    // whether an idle window is currently being waited out
+    bool mShutdownPending = false;
+
+    // bumped whenever a pending idle window is invalidated, so a stale timer
+    // thread can tell its window no longer applies
+    uint64_t mIdleGeneration = 0;
+
+    LazyServiceRegistrar::ShutdownStats mStats;
+
     // Callback used to report if there are services with clients
     std::function<bool(bool)> mActiveServicesCallback;
 };
@@ -113,6 +143,10 @@ public:
 
     void setActiveServicesCallback(const std::function<bool(bool)>& activeServicesCallback);
 
+    void setShutdownIdleDelay(std::chrono::milliseconds delay);
+
+    LazyServiceRegistrar::ShutdownStats getShutdownStats();
+
     bool tryUnregister();
 
     void reRegister();
@@ -235,9 +269,45 @@ void ClientCounterCallbackImpl::maybeTryShutdownLocked() {
     // If there is no callback defined or the callback did not handle this
     // client count change event, try to shutdown the process if its services
     // have no clients.
-    if (!handledInCallback && mNumConnectedServices == 0) {
+    if (handledInCallback || mNumConnectedServices != 0) {
+        return;
+    }
+
+    if (mShutdownIdleDelay.count() == 0) {
         tryShutdownLocked();
+        return;
+    }
+
+    if (mShutdownPending) {
+        return;
+    }
+
+    // Defer the decision until the idle window elapses, so a client that comes
+    // back quickly keeps the process alive instead of paying for a full
+    // teardown and relaunch.
+    mShutdownPending = true;
+    const uint64_t generation = mIdleGeneration;
+    ALOGI("All services have 0 clients; deferring shutdown decision by %lldms.",
+          static_cast<long long>(mShutdownIdleDelay.count()));
+    std::thread([impl = sp<ClientCounterCallbackImpl>::fromExisting(this), generation,
+                 delay = mShutdownIdleDelay] {
+        std::this_thread::sleep_for(delay);
+        impl->onIdleWindowExpired(generation);
+    }).detach();
+}
+
+void ClientCounterCallbackImpl::onIdleWindowExpired(uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (generation != mIdleGeneration) {
+        // A client reconnected during the idle window; this timer is stale.
+        return;
+    }
+    mShutdownPending = false;
+    if (mForcePersist) {
+        ALOGI("Shutdown prevented by forcePersist override flag.");
+        return;
     }
+    tryShutdownLocked();
 }
 
 Status ClientCounterCallbackImpl::onClients(const sp<IBinder>& service, bool clients) {
@@ -262,18 +332,32 @@ Status ClientCounterCallbackImpl::onClients(const sp<IBinder>& service, bool cli
     ALOGI("Process has %zu (of %zu available) client(s) in use after notification %s has clients: %d",
           mNumConnectedServices, mRegisteredServices.size(), name.c_str(), clients);
 
+    if (mShutdownPending && mNumConnectedServices != 0) {
+        // A client came back before the idle window elapsed; keep the process
+        // alive rather than bouncing it.
+        mShutdownPending = false;
+        mIdleGeneration++;
+        mStats.shutdownsCancelled++;
+        ALOGI("Client reconnected during idle window; cancelling deferred shutdown.");
+    }
+
     maybeTryShutdownLocked();
     return Status::ok();
 }
 
 void ClientCounterCallbackImpl::tryShutdownLocked() {
-    ALOGI("Trying to shut down the service. No clients in use for any service in process.");
+    mStats.shutdownAttempts++;
+    ALOGI("Trying to shut down the service. No clients in use for any service in process. "
+          "(%" PRIu64 " attempt(s), %" PRIu64 " cancelled by reconnects, %" PRIu64
+          " raced re-registers)",
+          mStats.shutdownAttempts, mStats.shutdownsCancelled, mStats.reRegisters);
 
     if (tryUnregisterLocked()) {
         ALOGI("Unregistered all clients and exiting");
         exit(EXIT_SUCCESS);
     }
 
+    mStats.reRegisters++;
     reRegisterLocked();
 }
 
@@ -283,6 +367,16 @@ void ClientCounterCallbackImpl::setActiveServicesCallback(const std::function<bo
     mActiveServicesCallback = activeServicesCallback;
 }
 
+void ClientCounterCallbackImpl::setShutdownIdleDelay(std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mShutdownIdleDelay = delay;
+}
+
+LazyServiceRegistrar::ShutdownStats ClientCounterCallbackImpl::getShutdownStats() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
 ClientCounterCallback::ClientCounterCallback() {
       mImpl = sp<ClientCounterCallbackImpl>::make();
 }
@@ -301,6 +395,14 @@ void ClientCounterCallback::setActiveServicesCallback(const std::function<bool(b
     mImpl->setActiveServicesCallback(activeServicesCallback);
 }
 
+void ClientCounterCallback::setShutdownIdleDelay(std::chrono::milliseconds delay) {
+    mImpl->setShutdownIdleDelay(delay);
+}
+
+LazyServiceRegistrar::ShutdownStats ClientCounterCallback::getShutdownStats() {
+    return mImpl->getShutdownStats();
+}
+
 bool ClientCounterCallback::tryUnregister() {
     // see comments in header, this should only be called from the active
     // services callback, see also b/191781736
@@ -341,6 +443,14 @@ void LazyServiceRegistrar::setActiveServicesCallback(const std::function<bool(bo
     mClientCC->setActiveServicesCallback(activeServicesCallback);
 }
 
+void LazyServiceRegistrar::setShutdownIdleDelay(std::chrono::milliseconds delay) {
+    mClientCC->setShutdownIdleDelay(delay);
+}
+
+LazyServiceRegistrar::ShutdownStats LazyServiceRegistrar::getShutdownStats() const {
+    return mClientCC->getShutdownStats();
+}
+
 bool LazyServiceRegistrar::tryUnregister() {
     return mClientCC->tryUnregister();
 }
@@ -37,75 +37,11 @@
 #include <sys/mman.h>
 #include <sys/file.h>
 
-namespace android {
-// ----------------------------------------------------------------------------
-
-/*
- * A simple templatized doubly linked-list implementation
- */
-
-template <typename NODE>
-class LinkedList
-{
-    NODE*  mFirst;
-    NODE*  mLast;
-
-public:
-                LinkedList() : mFirst(nullptr), mLast(nullptr) { }
-    bool        isEmpty() const { return mFirst == nullptr; }
-    NODE const* head() const { return mFirst; }
-    NODE*       head() { return mFirst; }
-    NODE const* tail() const { return mLast; }
-    NODE*       tail() { return mLast; }
-
-    void insertAfter(NODE* node, NODE* newNode) {
-        newNode->prev = node;
-        newNode->next = node->next;
-        if (node->next == nullptr) mLast = newNode;
-        else                 node->next->prev = newNode;
-        node->next = newNode;
-    }
-
-    void insertBefore(NODE* node, NODE* newNode) {
-         newNode->prev = node->prev;
-         newNode->next = node;
-         if (node->prev == nullptr)   mFirst = newNode;
-         else                   node->prev->next = newNode;
-         node->prev = newNode;
-    }
-
-    void insertHead(NODE* newNode) {
-        if (mFirst == nullptr) {
-            mFirst = mLast = newNode;
-            newNode->prev = newNode->next = nullptr;
-        } else {
-            newNode->prev = nullptr;
-            newNode->next = mFirst;
-            mFirst->prev = newNode;
-            mFirst = newNode;
-        }
-    }
-
-    void insertTail(NODE* newNode) {
-        if (mLast == 0) {
-            insertHead(newNode);
-        } else {
-            newNode->prev = mLast;
-            newNode->next = 0;
-            mLast->next = newNode;
-            mLast = newNode;
-        }
-    }
-
-    NODE* remove(NODE* node) {
-        if (node->prev == nullptr)    mFirst = node->next;
-        else                    node->prev->next = node->next;
-        if (node->next == nullptr)    mLast = node->prev;
-        else                    node->next->prev = node->prev;
-        return node;
-    }
-};
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+namespace android {
 // ----------------------------------------------------------------------------
 
 class Allocation : public MemoryBase {
@@ -119,14 +55,18 @@ private:
 
 // ----------------------------------------------------------------------------
 
-class SimpleBestFitAllocator
+// A binary buddy allocator. Block sizes are powers of two in units of
+// kMemoryAlign bytes, every block is aligned to its own size, and freed
+// blocks coalesce with their buddy in constant time, so alloc and free don't
+// walk the heap no matter how fragmented it gets.
+class BuddyAllocator
 {
     enum {
         PAGE_ALIGNED = 0x00000001
     };
 public:
-    explicit SimpleBestFitAllocator(size_t size);
-    ~SimpleBestFitAllocator();
+    explicit BuddyAllocator(size_t size);
+    ~BuddyAllocator() = default;
 
     size_t      allocate(size_t size, uint32_t flags = 0);
     status_t    deallocate(size_t offset);
@@ -137,27 +77,29 @@ public:
     static size_t getAllocationAlignment() { return kMemoryAlign; }
 
 private:
-
-    struct chunk_t {
-        chunk_t(size_t start, size_t size)
-        : start(start), size(size), free(1), prev(nullptr), next(nullptr) {
-        }
-        size_t              start;
-        size_t              size : 28;
-        int                 free : 4;
-        mutable chunk_t*    prev;
-        mutable chunk_t*    next;
+    struct alloc_info_t {
+        uint8_t order;          // block size is (1 << order) units
+        size_t  requestedUnits; // what the caller asked for, for stats
     };
 
     ssize_t  alloc(size_t size, uint32_t flags);
-    chunk_t* dealloc(size_t start);
+    bool     dealloc(size_t start);
     void     dump_l(const char* what) const;
     void     dump_l(String8& res, const char* what) const;
 
+    // Smallest order whose block holds at least units.
+    static uint8_t orderOf(size_t units);
+
     static const int    kMemoryAlign;
     mutable Mutex       mLock;
-    LinkedList<chunk_t> mList;
     size_t              mHeapSize;
+    size_t              mHeapUnits;
+    size_t              mAllocatedUnits = 0;
+    size_t              mRequestedUnits = 0;
+    // Free block offsets (in units), one set per order.
+    std::vector<std::unordered_set<size_t>> mFreeBlocks;
+    // Live allocations, keyed by block offset in units.
+    std::unordered_map<size_t, alloc_info_t> mAllocations;
 };
 
 // ----------------------------------------------------------------------------
@@ -228,7 +170,7 @@ Allocation::~Allocation()
 
 MemoryDealer::MemoryDealer(size_t size, const char* name, uint32_t flags)
       : mHeap(sp<MemoryHeapBase>::make(size, flags, name)),
-        mAllocator(new SimpleBestFitAllocator(size)) {}
+        mAllocator(new BuddyAllocator(size)) {}
 
 MemoryDealer::~MemoryDealer()
 {
@@ -259,221 +201,205 @@ const sp<IMemoryHeap>& MemoryDealer::heap() const {
     return mHeap;
 }
 
-SimpleBestFitAllocator* MemoryDealer::allocator() const {
+BuddyAllocator* MemoryDealer::allocator() const {
     return mAllocator;
 }
 
 // static
 size_t MemoryDealer::getAllocationAlignment()
 {
-    return SimpleBestFitAllocator::getAllocationAlignment();
+    return BuddyAllocator::getAllocationAlignment();
 }
 
 // ----------------------------------------------------------------------------
 
 // align all the memory blocks on a cache-line boundary
-const int SimpleBestFitAllocator::kMemoryAlign = 32;
+const int BuddyAllocator::kMemoryAlign = 32;
 
-SimpleBestFitAllocator::SimpleBestFitAllocator(size_t size)
+uint8_t BuddyAllocator::orderOf(size_t units)
 {
-    size_t pagesize = getpagesize();
-    mHeapSize = ((size + pagesize-1) & ~(pagesize-1));
-
-    chunk_t* node = new chunk_t(0, mHeapSize / kMemoryAlign);
-    mList.insertHead(node);
+    uint8_t order = 0;
+    while ((size_t(1) << order) < units) {
+        order++;
+    }
+    return order;
 }
 
-SimpleBestFitAllocator::~SimpleBestFitAllocator()
+BuddyAllocator::BuddyAllocator(size_t size)
 {
-    while(!mList.isEmpty()) {
-        chunk_t* removed = mList.remove(mList.head());
-#ifdef __clang_analyzer__
-        // Clang static analyzer gets confused in this loop
-        // and generates a false positive warning about accessing
-        // memory that is already freed.
-        // Add an "assert" to avoid the confusion.
-        LOG_ALWAYS_FATAL_IF(mList.head() == removed);
-#endif
-        delete removed;
+    size_t pagesize = getpagesize();
+    mHeapSize = ((size + pagesize-1) & ~(pagesize-1));
+    mHeapUnits = mHeapSize / kMemoryAlign;
+
+    if (mHeapUnits == 0) {
+        return;
+    }
+    mFreeBlocks.resize(orderOf(mHeapUnits) + 1);
+
+    // Seed the free lists with the power-of-two decomposition of the heap,
+    // largest blocks first. Each seeded block starts at a multiple of its own
+    // size, which the buddy math below relies on.
+    size_t offset = 0;
+    for (size_t order = mFreeBlocks.size(); order-- > 0; ) {
+        if (mHeapUnits & (size_t(1) << order)) {
+            mFreeBlocks[order].insert(offset);
+            offset += size_t(1) << order;
+        }
     }
 }
 
-size_t SimpleBestFitAllocator::size() const
+size_t BuddyAllocator::size() const
 {
     return mHeapSize;
 }
 
-size_t SimpleBestFitAllocator::allocate(size_t size, uint32_t flags)
+size_t BuddyAllocator::allocate(size_t size, uint32_t flags)
 {
     Mutex::Autolock _l(mLock);
     ssize_t offset = alloc(size, flags);
     return offset;
 }
 
-status_t SimpleBestFitAllocator::deallocate(size_t offset)
+status_t BuddyAllocator::deallocate(size_t offset)
 {
     Mutex::Autolock _l(mLock);
-    chunk_t const * const freed = dealloc(offset);
-    if (freed) {
+    if (dealloc(offset)) {
         return NO_ERROR;
     }
     return NAME_NOT_FOUND;
 }
 
-ssize_t SimpleBestFitAllocator::alloc(size_t size, uint32_t flags)
+ssize_t BuddyAllocator::alloc(size_t size, uint32_t flags)
 {
     if (size == 0) {
         return 0;
     }
-    size = (size + kMemoryAlign-1) / kMemoryAlign;
-    chunk_t* free_chunk = nullptr;
-    chunk_t* cur = mList.head();
-
-    size_t pagesize = getpagesize();
-    while (cur) {
-        int extra = 0;
-        if (flags & PAGE_ALIGNED)
-            extra = ( -cur->start & ((pagesize/kMemoryAlign)-1) ) ;
-
-        // best fit
-        if (cur->free && (cur->size >= (size+extra))) {
-            if ((!free_chunk) || (cur->size < free_chunk->size)) {
-                free_chunk = cur;
-            }
-            if (cur->size == size) {
-                break;
-            }
+    const size_t units = (size + kMemoryAlign-1) / kMemoryAlign;
+    if (units > mHeapUnits) {
+        return NO_MEMORY;
+    }
+    uint8_t order = orderOf(units);
+    if (flags & PAGE_ALIGNED) {
+        // Blocks are aligned to their own size, so rounding the block up to a
+        // page guarantees page alignment.
+        const uint8_t pageOrder = orderOf(getpagesize() / kMemoryAlign);
+        if (order < pageOrder) {
+            order = pageOrder;
         }
-        cur = cur->next;
     }
 
-    if (free_chunk) {
-        const size_t free_size = free_chunk->size;
-        free_chunk->free = 0;
-        free_chunk->size = size;
-        if (free_size > size) {
-            int extra = 0;
-            if (flags & PAGE_ALIGNED)
-                extra = ( -free_chunk->start & ((pagesize/kMemoryAlign)-1) ) ;
-            if (extra) {
-                chunk_t* split = new chunk_t(free_chunk->start, extra);
-                free_chunk->start += extra;
-                mList.insertBefore(free_chunk, split);
-            }
-
-            ALOGE_IF((flags&PAGE_ALIGNED) && 
-                    ((free_chunk->start*kMemoryAlign)&(pagesize-1)),
-                    "PAGE_ALIGNED requested, but page is not aligned!!!");
+    // Find the smallest free block that fits, then split it down to size.
+    size_t haveOrder = order;
+    while (haveOrder < mFreeBlocks.size() && mFreeBlocks[haveOrder].empty()) {
+        haveOrder++;
+    }
+    if (haveOrder >= mFreeBlocks.size()) {
+        return NO_MEMORY;
+    }
 
-            const ssize_t tail_free = free_size - (size+extra);
-            if (tail_free > 0) {
-                chunk_t* split = new chunk_t(
-                        free_chunk->start + free_chunk->size, tail_free);
-                mList.insertAfter(free_chunk, split);
-            }
-        }
-        return (free_chunk->start)*kMemoryAlign;
+    const size_t start = *mFreeBlocks[haveOrder].begin();
+    mFreeBlocks[haveOrder].erase(mFreeBlocks[haveOrder].begin());
+    while (haveOrder > order) {
+        haveOrder--;
+        mFreeBlocks[haveOrder].insert(start + (size_t(1) << haveOrder));
     }
-    return NO_MEMORY;
+
+    mAllocations.emplace(start, alloc_info_t{order, units});
+    mAllocatedUnits += size_t(1) << order;
+    mRequestedUnits += units;
+    return static_cast<ssize_t>(start * kMemoryAlign);
 }
 
-SimpleBestFitAllocator::chunk_t* SimpleBestFitAllocator::dealloc(size_t start)
+bool BuddyAllocator::dealloc(size_t start)
 {
     start = start / kMemoryAlign;
-    chunk_t* cur = mList.head();
-    while (cur) {
-        if (cur->start == start) {
-            LOG_FATAL_IF(cur->free,
-                "block at offset 0x%08lX of size 0x%08X already freed",
-                cur->start*kMemoryAlign, cur->size*kMemoryAlign);
-
-            // merge freed blocks together
-            chunk_t* freed = cur;
-            cur->free = 1;
-            do {
-                chunk_t* const p = cur->prev;
-                chunk_t* const n = cur->next;
-                if (p && (p->free || !cur->size)) {
-                    freed = p;
-                    p->size += cur->size;
-                    mList.remove(cur);
-                    delete cur;
-                }
-                cur = n;
-            } while (cur && cur->free);
-
-            #ifndef NDEBUG
-                if (!freed->free) {
-                    dump_l("dealloc (!freed->free)");
-                }
-            #endif
-            LOG_FATAL_IF(!freed->free,
-                "freed block at offset 0x%08lX of size 0x%08X is not free!",
-                freed->start * kMemoryAlign, freed->size * kMemoryAlign);
-
-            return freed;
+    const auto it = mAllocations.find(start);
+    if (it == mAllocations.end()) {
+        return false;
+    }
+    uint8_t order = it->second.order;
+    mAllocatedUnits -= size_t(1) << order;
+    mRequestedUnits -= it->second.requestedUnits;
+    mAllocations.erase(it);
+
+    // Coalesce with the buddy block as long as it is also free, then put the
+    // merged block back on its free list.
+    while (order + 1u < mFreeBlocks.size()) {
+        const size_t buddy = start ^ (size_t(1) << order);
+        const auto buddyIt = mFreeBlocks[order].find(buddy);
+        if (buddyIt == mFreeBlocks[order].end()) {
+            break;
         }
-        cur = cur->next;
+        mFreeBlocks[order].erase(buddyIt);
+        start &= ~(size_t(1) << order);
+        order++;
     }
-    return nullptr;
+    mFreeBlocks[order].insert(start);
+    return true;
 }
 
-void SimpleBestFitAllocator::dump(const char* what) const
+void BuddyAllocator::dump(const char* what) const
 {
     Mutex::Autolock _l(mLock);
     dump_l(what);
 }
 
-void SimpleBestFitAllocator::dump_l(const char* what) const
+void BuddyAllocator::dump_l(const char* what) const
 {
     String8 result;
     dump_l(result, what);
     ALOGD("%s", result.string());
 }
 
-void SimpleBestFitAllocator::dump(String8& result,
+void BuddyAllocator::dump(String8& result,
         const char* what) const
 {
     Mutex::Autolock _l(mLock);
     dump_l(result, what);
 }
 
-void SimpleBestFitAllocator::dump_l(String8& result,
+void BuddyAllocator::dump_l(String8& result,
         const char* what) const
 {
-    size_t size = 0;
-    int32_t i = 0;
-    chunk_t const* cur = mList.head();
-    
     const size_t SIZE = 256;
     char buffer[SIZE];
     snprintf(buffer, SIZE, "  %s (%p, size=%u)\n",
             what, this, (unsigned int)mHeapSize);
-    
     result.append(buffer);
-            
-    while (cur) {
-        const char* errs[] = {"", "| link bogus NP",
-                            "| link bogus PN", "| link bogus NP+PN" };
-        int np = ((cur->next) && cur->next->prev != cur) ? 1 : 0;
-        int pn = ((cur->prev) && cur->prev->next != cur) ? 2 : 0;
-
-        snprintf(buffer, SIZE, "  %3u: %p | 0x%08X | 0x%08X | %s %s\n",
-            i, cur, int(cur->start*kMemoryAlign),
-            int(cur->size*kMemoryAlign),
-                    int(cur->free) ? "F" : "A",
-                    errs[np|pn]);
-        
+
+    size_t freeUnits = 0;
+    size_t largestFreeUnits = 0;
+    for (size_t order = 0; order < mFreeBlocks.size(); order++) {
+        const size_t count = mFreeBlocks[order].size();
+        if (count == 0) {
+            continue;
+        }
+        const size_t blockUnits = size_t(1) << order;
+        freeUnits += count * blockUnits;
+        largestFreeUnits = blockUnits; // orders are visited smallest first
+        snprintf(buffer, SIZE, "  order %2zu (0x%08X bytes): %zu free\n",
+                order, (unsigned int)(blockUnits * kMemoryAlign), count);
         result.append(buffer);
+    }
 
-        if (!cur->free)
-            size += cur->size*kMemoryAlign;
+    snprintf(buffer, SIZE,
+            "  allocations: %zu, size allocated: %u (%u KB), requested: %u (%u KB)\n",
+            mAllocations.size(),
+            (unsigned int)(mAllocatedUnits * kMemoryAlign),
+            (unsigned int)(mAllocatedUnits * kMemoryAlign / 1024),
+            (unsigned int)(mRequestedUnits * kMemoryAlign),
+            (unsigned int)(mRequestedUnits * kMemoryAlign / 1024));
+    result.append(buffer);
 
-        i++;
-        cur = cur->next;
-    }
+    // External fragmentation: how much of the free space is unusable for a
+    // single allocation of the largest free block size.
+    const unsigned int extFrag = freeUnits
+            ? (unsigned int)(100 - (largestFreeUnits * 100) / freeUnits) : 0;
     snprintf(buffer, SIZE,
-            "  size allocated: %u (%u KB)\n", int(size), int(size/1024));
+            "  free: %u (%u KB), largest block: %u, external fragmentation: %u%%\n",
+            (unsigned int)(freeUnits * kMemoryAlign),
+            (unsigned int)(freeUnits * kMemoryAlign / 1024),
+            (unsigned int)(largestFreeUnits * kMemoryAlign), extFrag);
     result.append(buffer);
 }
 
@@ -48,6 +48,8 @@
 #include <utils/String8.h>
 #include <utils/misc.h>
 
+#include <algorithm>
+
 #include "RpcState.h"
 #include "Static.h"
 #include "Utils.h"
@@ -89,6 +91,75 @@ static std::atomic<size_t> gParcelGlobalAllocSize;
 
 static size_t gMaxFds = 0;
 
+// Opt-in recycling of Parcel data buffers through per-thread free lists,
+// enabled with ProcessState::setParcelBufferPoolEnabled(). Pooled buffers are
+// plain malloc() blocks, so they stay compatible with the realloc() growth
+// path in continueWrite().
+static std::atomic<bool> gParcelBufferPoolEnabled(false);
+
+namespace {
+
+struct ParcelBufferPool {
+    // Size classes cover common transaction payloads on high-rate services;
+    // larger buffers keep going through malloc/free directly.
+    static constexpr size_t kClassSizes[] = {512, 2048, 8192, 32768};
+    static constexpr size_t kNumClasses = std::size(kClassSizes);
+    static constexpr size_t kMaxPerClass = 8;
+
+    struct Entry {
+        uint8_t* data;
+        size_t capacity;
+    };
+
+    Entry entries[kNumClasses][kMaxPerClass];
+    size_t counts[kNumClasses] = {};
+
+    ~ParcelBufferPool() {
+        for (size_t c = 0; c < kNumClasses; c++) {
+            for (size_t i = 0; i < counts[c]; i++) {
+                free(entries[c][i].data);
+            }
+        }
+    }
+
+    // Largest class whose size is <= capacity, or -1 if below the smallest.
+    static ssize_t classForCapacity(size_t capacity) {
+        ssize_t c = -1;
+        for (size_t i = 0; i < kNumClasses && capacity >= kClassSizes[i]; i++) {
+            c = i;
+        }
+        return c;
+    }
+
+    // Returns a recycled buffer of at least `desired` bytes, or nullptr if
+    // none is pooled. On success, `*outCapacity` is the buffer's true size.
+    uint8_t* acquire(size_t desired, size_t* outCapacity) {
+        for (size_t c = 0; c < kNumClasses; c++) {
+            if (counts[c] == 0 || kClassSizes[c] < desired) continue;
+            Entry& entry = entries[c][--counts[c]];
+            *outCapacity = entry.capacity;
+            return entry.data;
+        }
+        return nullptr;
+    }
+
+    // Takes ownership of `data` if there is room in its size class; the
+    // caller must free() it when this returns false.
+    bool release(uint8_t* data, size_t capacity) {
+        ssize_t c = classForCapacity(capacity);
+        if (c < 0 || counts[c] >= kMaxPerClass) return false;
+        entries[c][counts[c]++] = {data, capacity};
+        return true;
+    }
+};
+
+ParcelBufferPool& threadBufferPool() {
+    thread_local ParcelBufferPool pool;
+    return pool;
+}
+
+} // namespace
+
 // Maximum size of a blob to transfer in-place.
 static const size_t BLOB_INPLACE_LIMIT = 16 * 1024;
 
@@ -323,6 +394,10 @@ size_t Parcel::getGlobalAllocCount() {
     return gParcelGlobalAllocCount.load();
 }
 
+void Parcel::setBufferPoolEnabled(bool enabled) {
+    gParcelBufferPoolEnabled.store(enabled, std::memory_order_relaxed);
+}
+
 const uint8_t* Parcel::data() const
 {
     return mData;
@@ -379,7 +454,11 @@ void Parcel::setDataPosition(size_t pos) const
 
     mDataPos = pos;
     mNextObjectHint = 0;
-    mObjectsSorted = false;
+    // Note: mObjectsSorted is a property of mObjects, not of the read
+    // position, so it survives repositioning. It is invalidated by writes
+    // (writeObject, continueWrite, etc.) instead. Keeping it here lets
+    // readers which jump around an object-dense parcel skip re-verifying
+    // sortedness on every reposition.
 }
 
 status_t Parcel::setDataCapacity(size_t size)
@@ -491,6 +570,12 @@ status_t Parcel::appendFrom(const Parcel *parcel, size_t offset, size_t len)
         int idx = mObjectsSize;
         for (int i = firstIndex; i <= lastIndex; i++) {
             size_t off = objects[i] - offset + startPos;
+            // appending after setDataPosition rewound the write position can
+            // land this offset before existing ones, invalidating any
+            // previously verified sort order (same guard as writeObject)
+            if (idx > 0 && mObjects[idx - 1] > off) {
+                mObjectsSorted = false;
+            }
             mObjects[idx++] = off;
             mObjectsSize++;
 
@@ -1092,6 +1177,48 @@ status_t Parcel::writeByteArray(size_t len, const uint8_t *val) {
     return ret;
 }
 
+status_t Parcel::writeByteArrayAsBlob(size_t len, const uint8_t* val) {
+    if (len > INT32_MAX) {
+        // don't accept size_t values which may have come from an
+        // inadvertent conversion from a negative int.
+        return BAD_VALUE;
+    }
+
+    if (!val) {
+        return writeInt32(-1);
+    }
+
+    // writeBlob() keeps small payloads in place and spills large ones into
+    // an ashmem region attached as a file descriptor, so big arrays avoid
+    // both the copy through the binder buffer and its size limit.
+    status_t ret = writeInt32(static_cast<uint32_t>(len));
+    if (ret != NO_ERROR) return ret;
+
+    WritableBlob blob;
+    ret = writeBlob(len, false, &blob);
+    if (ret != NO_ERROR) return ret;
+
+    memcpy(blob.data(), val, len);
+    blob.release();
+    return NO_ERROR;
+}
+
+status_t Parcel::readByteVectorAsBlob(std::vector<uint8_t>* val) const {
+    int32_t size;
+    status_t ret = readInt32(&size);
+    if (ret != NO_ERROR) return ret;
+    if (size < 0) return UNEXPECTED_NULL;
+
+    ReadableBlob blob;
+    ret = readBlob(static_cast<size_t>(size), &blob);
+    if (ret != NO_ERROR) return ret;
+
+    const uint8_t* data = static_cast<const uint8_t*>(blob.data());
+    val->assign(data, data + size);
+    blob.release();
+    return NO_ERROR;
+}
+
 status_t Parcel::writeBool(bool val)
 {
     return writeInt32(int32_t(val));
@@ -1418,6 +1545,11 @@ restart_write:
 
         // Need to write meta-data?
         if (nullMetaData || val.binder != 0) {
+            // an out-of-order write (after setDataPosition) invalidates any
+            // previously verified sort order of the offsets
+            if (mObjectsSize > 0 && mObjects[mObjectsSize - 1] > mDataPos) {
+                mObjectsSorted = false;
+            }
             mObjects[mObjectsSize] = mDataPos;
             acquire_object(ProcessState::self(), val, this);
             mObjectsSize++;
@@ -1457,18 +1589,25 @@ status_t Parcel::validateReadData(size_t upperBound) const
 data_sorted:
         // Expect to check only against the next object
         if (mNextObjectHint < mObjectsSize && upperBound > mObjects[mNextObjectHint]) {
-            // For some reason the current read position is greater than the next object
-            // hint. Iterate until we find the right object
-            size_t nextObject = mNextObjectHint;
-            do {
-                if (mDataPos < mObjects[nextObject] + sizeof(flat_binder_object)) {
-                    // Requested info overlaps with an object
-                    ALOGE("Attempt to read from protected data in Parcel %p", this);
-                    return PERMISSION_DENIED;
-                }
-                nextObject++;
-            } while (nextObject < mObjectsSize && upperBound > mObjects[nextObject]);
-            mNextObjectHint = nextObject;
+            // The read window reaches past the cached cursor. Binary search for
+            // the first object which could still overlap the window instead of
+            // walking every object in between, so repositioned reads in
+            // object-dense parcels don't go quadratic.
+            const binder_size_t* const first = mObjects + mNextObjectHint;
+            const binder_size_t* const last = mObjects + mObjectsSize;
+            const binder_size_t* obj = first;
+            if (mDataPos >= sizeof(flat_binder_object)) {
+                // first object which ends after the window start
+                obj = std::upper_bound(first, last,
+                                       static_cast<binder_size_t>(mDataPos -
+                                                                  sizeof(flat_binder_object)));
+            }
+            if (obj < last && *obj < upperBound) {
+                // Requested info overlaps with an object
+                ALOGE("Attempt to read from protected data in Parcel %p", this);
+                return PERMISSION_DENIED;
+            }
+            mNextObjectHint = obj - mObjects;
         }
         return NO_ERROR;
     }
@@ -1558,6 +1697,17 @@ const void* Parcel::readInplace(size_t len) const
     return nullptr;
 }
 
+status_t Parcel::startValidatedRead(size_t len, ReadCursor* outCursor) const {
+    // readInplace does the range and object-boundary validation for the
+    // whole window up front; the cursor then reads within it unchecked.
+    const void* data = readInplace(len);
+    if (data == nullptr) {
+        return NOT_ENOUGH_DATA;
+    }
+    outCursor->mCursor = static_cast<const uint8_t*>(data);
+    return NO_ERROR;
+}
+
 status_t Parcel::readOutVectorSizeWithCheck(size_t elmSize, int32_t* size) const {
     if (status_t status = readInt32(size); status != OK) return status;
     if (*size < 0) return OK; // may be null, client to handle
@@ -2154,6 +2304,30 @@ const flat_binder_object* Parcel::readObject(bool nullMetaData) const
             ALOGV("Parcel %p looking for obj at %zu, hint=%zu",
                  this, DPOS, opos);
 
+            if (mObjectsSorted) {
+                // Sequential reads hit the cursor directly.
+                if (opos < N && OBJS[opos] == DPOS) {
+                    mNextObjectHint = opos + 1;
+                    ALOGV("readObject Setting data pos of %p to %zu", this, mDataPos);
+                    return obj;
+                }
+                // Otherwise the offsets are known sorted, so jump straight to
+                // the candidate instead of scanning linearly.
+                const binder_size_t* found =
+                        std::lower_bound(OBJS, OBJS + N, static_cast<binder_size_t>(DPOS));
+                if (found < OBJS + N && *found == DPOS) {
+                    ALOGV("Parcel %p found obj %zu at index %zu with binary search",
+                         this, DPOS, static_cast<size_t>(found - OBJS));
+                    mNextObjectHint = found - OBJS + 1;
+                    ALOGV("readObject Setting data pos of %p to %zu", this, mDataPos);
+                    return obj;
+                }
+                ALOGW("Attempt to read object from Parcel %p at offset %zu that is not in the "
+                      "object list",
+                      this, DPOS);
+                return nullptr;
+            }
+
             // Start at the current hint position, looking for an object at
             // the current data position.
             if (opos < N) {
@@ -2356,7 +2530,12 @@ void Parcel::freeDataNoInit()
             if (mDeallocZero) {
                 zeroMemory(mData, mDataSize);
             }
-            free(mData);
+            // Sensitive parcels are never pooled, so recycled buffers can't
+            // leak zeroed-over secrets through their unzeroed tail.
+            if (mDeallocZero || !gParcelBufferPoolEnabled.load(std::memory_order_relaxed) ||
+                !threadBufferPool().release(mData, mDataCapacity)) {
+                free(mData);
+            }
         }
         if (mObjects) free(mObjects);
     }
@@ -2582,7 +2761,15 @@ status_t Parcel::continueWrite(size_t desired)
 
     } else {
         // This is the first data.  Easy!
-        uint8_t* data = (uint8_t*)malloc(desired);
+        uint8_t* data = nullptr;
+        size_t capacity = desired;
+        if (gParcelBufferPoolEnabled.load(std::memory_order_relaxed)) {
+            data = threadBufferPool().acquire(desired, &capacity);
+        }
+        if (!data) {
+            data = (uint8_t*)malloc(desired);
+            capacity = desired;
+        }
         if (!data) {
             mError = NO_MEMORY;
             return NO_MEMORY;
@@ -2593,15 +2780,15 @@ status_t Parcel::continueWrite(size_t desired)
             ALOGE("continueWrite: %zu/%p/%zu/%zu", mDataCapacity, mObjects, mObjectsCapacity, desired);
         }
 
-        LOG_ALLOC("Parcel %p: allocating with %zu capacity", this, desired);
-        gParcelGlobalAllocSize += desired;
+        LOG_ALLOC("Parcel %p: allocating with %zu capacity", this, capacity);
+        gParcelGlobalAllocSize += capacity;
         gParcelGlobalAllocCount++;
 
         mData = data;
         mDataSize = mDataPos = 0;
         ALOGV("continueWrite Setting data size of %p to %zu", this, mDataSize);
         ALOGV("continueWrite Setting data pos of %p to %zu", this, mDataPos);
-        mDataCapacity = desired;
+        mDataCapacity = capacity;
     }
 
     return NO_ERROR;
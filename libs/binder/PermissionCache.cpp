@@ -31,47 +31,61 @@ ANDROID_SINGLETON_STATIC_INSTANCE(PermissionCache)
 
 // ----------------------------------------------------------------------------
 
-PermissionCache::PermissionCache() {
+PermissionCache::PermissionCache()
+      : mState(std::make_shared<State>()), mGeneration(0) {
 }
 
 status_t PermissionCache::check(bool* granted,
         const String16& permission, uid_t uid) const {
-    Mutex::Autolock _l(mLock);
+    // Lock-free: load the current snapshot and search it. A concurrent
+    // purge or insert publishes a new snapshot; this one stays valid for
+    // the duration of the lookup.
+    std::shared_ptr<const State> state = std::atomic_load(&mState);
     Entry e;
     e.name = permission;
     e.uid  = uid;
-    ssize_t index = mCache.indexOf(e);
+    ssize_t index = state->cache.indexOf(e);
     if (index >= 0) {
-        *granted = mCache.itemAt(index).granted;
+        *granted = state->cache.itemAt(index).granted;
         return NO_ERROR;
     }
     return NAME_NOT_FOUND;
 }
 
 void PermissionCache::cache(const String16& permission,
-        uid_t uid, bool granted) {
+        uid_t uid, bool granted, uint32_t generation) {
     Mutex::Autolock _l(mLock);
+    if (generation != mGeneration.load(std::memory_order_relaxed)) {
+        // The cache was purged while the permission check was in flight,
+        // so the result may already be stale; don't publish it.
+        return;
+    }
+    auto state = std::make_shared<State>(*mState);
     Entry e;
-    ssize_t index = mPermissionNamesPool.indexOf(permission);
+    ssize_t index = state->permissionNamesPool.indexOf(permission);
     if (index > 0) {
-        e.name = mPermissionNamesPool.itemAt(index);
+        e.name = state->permissionNamesPool.itemAt(index);
     } else {
-        mPermissionNamesPool.add(permission);
+        state->permissionNamesPool.add(permission);
         e.name = permission;
     }
     // note, we don't need to store the pid, which is not actually used in
     // permission checks
     e.uid  = uid;
     e.granted = granted;
-    index = mCache.indexOf(e);
+    index = state->cache.indexOf(e);
     if (index < 0) {
-        mCache.add(e);
+        state->cache.add(e);
     }
+    std::atomic_store(&mState, std::shared_ptr<const State>(std::move(state)));
 }
 
 void PermissionCache::purge() {
     Mutex::Autolock _l(mLock);
-    mCache.clear();
+    mGeneration.fetch_add(1, std::memory_order_relaxed);
+    auto state = std::make_shared<State>();
+    state->permissionNamesPool = mState->permissionNamesPool;
+    std::atomic_store(&mState, std::shared_ptr<const State>(std::move(state)));
 }
 
 bool PermissionCache::checkCallingPermission(const String16& permission) {
@@ -98,13 +112,14 @@ bool PermissionCache::checkPermission(
     PermissionCache& pc(PermissionCache::getInstance());
     bool granted = false;
     if (pc.check(&granted, permission, uid) != NO_ERROR) {
+        uint32_t generation = pc.mGeneration.load(std::memory_order_acquire);
         nsecs_t t = -systemTime();
         granted = android::checkPermission(permission, pid, uid);
         t += systemTime();
         ALOGD("checking %s for uid=%d => %s (%d us)",
                 String8(permission).string(), uid,
                 granted?"granted":"denied", (int)ns2us(t));
-        pc.cache(permission, uid, granted);
+        pc.cache(permission, uid, granted, generation);
     }
     return granted;
 }
@@ -114,5 +129,9 @@ void PermissionCache::purgeCache() {
     pc.purge();
 }
 
+uint32_t PermissionCache::getGeneration() {
+    return PermissionCache::getInstance().mGeneration.load(std::memory_order_acquire);
+}
+
 // ---------------------------------------------------------------------------
 } // namespace android
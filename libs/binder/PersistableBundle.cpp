@@ -134,14 +134,86 @@ status_t PersistableBundle::readFromParcel(const Parcel* parcel) {
         return UNEXPECTED_NULL;
     }
 
+    // An eager read merges into the maps, so any lazily-held entries must be
+    // materialized first to keep them visible.
+    unparcel();
+
     return readFromParcelInner(parcel, static_cast<size_t>(length));
 }
 
+status_t PersistableBundle::readFromParcelLazy(const Parcel* parcel) {
+    int32_t length = parcel->readInt32();
+    if (length < 0) {
+        ALOGE("Bad length in parcel: %d", length);
+        return UNEXPECTED_NULL;
+    }
+
+    unparcel();
+
+    if (length == 0) {
+        // Empty PersistableBundle or end of data.
+        return NO_ERROR;
+    }
+
+    /*
+     * The region after the length field holds the magic number followed by
+     * |length| bytes of key/value entries. Copy it out once; values are
+     * deserialized from the copy on demand through findLazyEntry().
+     */
+    auto data = std::make_unique<Parcel>();
+    size_t start = parcel->dataPosition();
+    size_t total = sizeof(int32_t) + static_cast<size_t>(length);
+    RETURN_IF_FAILED(data->appendFrom(parcel, start, total));
+    parcel->setDataPosition(start + total);
+
+    data->setDataPosition(0);
+    int32_t magic;
+    RETURN_IF_FAILED(data->readInt32(&magic));
+    if (magic != BUNDLE_MAGIC && magic != BUNDLE_MAGIC_NATIVE) {
+        ALOGE("Bad magic number for PersistableBundle: 0x%08x", magic);
+        return BAD_VALUE;
+    }
+
+    mLazyData = std::move(data);
+    mLazyIndex.clear();
+    mLazyIndexBuilt = false;
+    return NO_ERROR;
+}
+
+PersistableBundle::PersistableBundle(const PersistableBundle& bundle) {
+    *this = bundle;
+}
+
+PersistableBundle& PersistableBundle::operator=(const PersistableBundle& bundle) {
+    if (this == &bundle) return *this;
+    /*
+     * Copies behave like eagerly-read bundles; duplicating the raw region
+     * would just re-parse the same bytes in both copies later.
+     */
+    bundle.unparcel();
+    mLazyData.reset();
+    mLazyIndex.clear();
+    mLazyIndexBuilt = false;
+    mBoolMap = bundle.mBoolMap;
+    mIntMap = bundle.mIntMap;
+    mLongMap = bundle.mLongMap;
+    mDoubleMap = bundle.mDoubleMap;
+    mStringMap = bundle.mStringMap;
+    mBoolVectorMap = bundle.mBoolVectorMap;
+    mIntVectorMap = bundle.mIntVectorMap;
+    mLongVectorMap = bundle.mLongVectorMap;
+    mDoubleVectorMap = bundle.mDoubleVectorMap;
+    mStringVectorMap = bundle.mStringVectorMap;
+    mPersistableBundleMap = bundle.mPersistableBundleMap;
+    return *this;
+}
+
 bool PersistableBundle::empty() const {
     return size() == 0u;
 }
 
 size_t PersistableBundle::size() const {
+    unparcel();
     return (mBoolMap.size() +
             mIntMap.size() +
             mLongMap.size() +
@@ -156,6 +228,7 @@ size_t PersistableBundle::size() const {
 }
 
 size_t PersistableBundle::erase(const String16& key) {
+    unparcel();
     RETURN_IF_ENTRY_ERASED(mBoolMap, key);
     RETURN_IF_ENTRY_ERASED(mIntMap, key);
     RETURN_IF_ENTRY_ERASED(mLongMap, key);
@@ -225,90 +298,145 @@ void PersistableBundle::putPersistableBundle(const String16& key, const Persista
 }
 
 bool PersistableBundle::getBoolean(const String16& key, bool* out) const {
-    return getValue(key, out, mBoolMap);
+    if (getValue(key, out, mBoolMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_BOOLEAN, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readBool(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getInt(const String16& key, int32_t* out) const {
-    return getValue(key, out, mIntMap);
+    if (getValue(key, out, mIntMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_INTEGER, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readInt32(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getLong(const String16& key, int64_t* out) const {
-    return getValue(key, out, mLongMap);
+    if (getValue(key, out, mLongMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_LONG, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readInt64(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getDouble(const String16& key, double* out) const {
-    return getValue(key, out, mDoubleMap);
+    if (getValue(key, out, mDoubleMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_DOUBLE, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readDouble(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getString(const String16& key, String16* out) const {
-    return getValue(key, out, mStringMap);
+    if (getValue(key, out, mStringMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_STRING, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readString16(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getBooleanVector(const String16& key, vector<bool>* out) const {
-    return getValue(key, out, mBoolVectorMap);
+    if (getValue(key, out, mBoolVectorMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_BOOLEANARRAY, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readBoolVector(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getIntVector(const String16& key, vector<int32_t>* out) const {
-    return getValue(key, out, mIntVectorMap);
+    if (getValue(key, out, mIntVectorMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_INTARRAY, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readInt32Vector(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getLongVector(const String16& key, vector<int64_t>* out) const {
-    return getValue(key, out, mLongVectorMap);
+    if (getValue(key, out, mLongVectorMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_LONGARRAY, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readInt64Vector(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getDoubleVector(const String16& key, vector<double>* out) const {
-    return getValue(key, out, mDoubleVectorMap);
+    if (getValue(key, out, mDoubleVectorMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_DOUBLEARRAY, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readDoubleVector(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getStringVector(const String16& key, vector<String16>* out) const {
-    return getValue(key, out, mStringVectorMap);
+    if (getValue(key, out, mStringVectorMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_STRINGARRAY, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return mLazyData->readString16Vector(out) == NO_ERROR;
 }
 
 bool PersistableBundle::getPersistableBundle(const String16& key, PersistableBundle* out) const {
-    return getValue(key, out, mPersistableBundleMap);
+    if (getValue(key, out, mPersistableBundleMap)) return true;
+    size_t offset;
+    if (!findLazyEntry(VAL_PERSISTABLEBUNDLE, key, &offset)) return false;
+    mLazyData->setDataPosition(offset);
+    return out->readFromParcel(mLazyData.get()) == NO_ERROR;
 }
 
 set<String16> PersistableBundle::getBooleanKeys() const {
+    unparcel();
     return getKeys(mBoolMap);
 }
 
 set<String16> PersistableBundle::getIntKeys() const {
+    unparcel();
     return getKeys(mIntMap);
 }
 
 set<String16> PersistableBundle::getLongKeys() const {
+    unparcel();
     return getKeys(mLongMap);
 }
 
 set<String16> PersistableBundle::getDoubleKeys() const {
+    unparcel();
     return getKeys(mDoubleMap);
 }
 
 set<String16> PersistableBundle::getStringKeys() const {
+    unparcel();
     return getKeys(mStringMap);
 }
 
 set<String16> PersistableBundle::getBooleanVectorKeys() const {
+    unparcel();
     return getKeys(mBoolVectorMap);
 }
 
 set<String16> PersistableBundle::getIntVectorKeys() const {
+    unparcel();
     return getKeys(mIntVectorMap);
 }
 
 set<String16> PersistableBundle::getLongVectorKeys() const {
+    unparcel();
     return getKeys(mLongVectorMap);
 }
 
 set<String16> PersistableBundle::getDoubleVectorKeys() const {
+    unparcel();
     return getKeys(mDoubleVectorMap);
 }
 
 set<String16> PersistableBundle::getStringVectorKeys() const {
+    unparcel();
     return getKeys(mStringVectorMap);
 }
 
 set<String16> PersistableBundle::getPersistableBundleKeys() const {
+    unparcel();
     return getKeys(mPersistableBundleMap);
 }
 
@@ -478,6 +606,130 @@ status_t PersistableBundle::readFromParcelInner(const Parcel* parcel, size_t len
     return NO_ERROR;
 }
 
+namespace {
+
+status_t skipString16(const Parcel* parcel) {
+    int32_t len;
+    RETURN_IF_FAILED(parcel->readInt32(&len));
+    if (len >= 0) {
+        // Matches readString16Inplace(): the characters plus the terminator.
+        if (parcel->readInplace((static_cast<size_t>(len) + 1) * sizeof(char16_t)) == nullptr) {
+            return NOT_ENOUGH_DATA;
+        }
+    }
+    return NO_ERROR;
+}
+
+status_t skipFixedVector(const Parcel* parcel, size_t elem_size) {
+    int32_t count;
+    RETURN_IF_FAILED(parcel->readInt32(&count));
+    if (count > 0) {
+        if (parcel->readInplace(elem_size * static_cast<size_t>(count)) == nullptr) {
+            return NOT_ENOUGH_DATA;
+        }
+    }
+    return NO_ERROR;
+}
+
+/* Advances |parcel| past one value of |value_type| without deserializing it. */
+status_t skipValue(const Parcel* parcel, int32_t value_type) {
+    switch (value_type) {
+        case VAL_BOOLEAN:
+        case VAL_INTEGER: {
+            if (parcel->readInplace(sizeof(int32_t)) == nullptr) return NOT_ENOUGH_DATA;
+            return NO_ERROR;
+        }
+        case VAL_LONG:
+        case VAL_DOUBLE: {
+            if (parcel->readInplace(sizeof(int64_t)) == nullptr) return NOT_ENOUGH_DATA;
+            return NO_ERROR;
+        }
+        case VAL_STRING:
+            return skipString16(parcel);
+        case VAL_BOOLEANARRAY:
+        case VAL_INTARRAY:
+            // Bools are written as one int32 each.
+            return skipFixedVector(parcel, sizeof(int32_t));
+        case VAL_LONGARRAY:
+        case VAL_DOUBLEARRAY:
+            return skipFixedVector(parcel, sizeof(int64_t));
+        case VAL_STRINGARRAY: {
+            int32_t count;
+            RETURN_IF_FAILED(parcel->readInt32(&count));
+            for (int32_t i = 0; i < count; ++i) {
+                RETURN_IF_FAILED(skipString16(parcel));
+            }
+            return NO_ERROR;
+        }
+        case VAL_PERSISTABLEBUNDLE: {
+            int32_t length;
+            RETURN_IF_FAILED(parcel->readInt32(&length));
+            if (length > 0) {
+                // Magic number plus |length| bytes of entries.
+                if (parcel->readInplace(sizeof(int32_t) + static_cast<size_t>(length)) ==
+                    nullptr) {
+                    return NOT_ENOUGH_DATA;
+                }
+            }
+            return NO_ERROR;
+        }
+        default: {
+            ALOGE("Unrecognized type: %d", value_type);
+            return BAD_TYPE;
+        }
+    }
+}
+
+}  // namespace
+
+status_t PersistableBundle::buildLazyIndex() const {
+    if (mLazyIndexBuilt || !mLazyData) return NO_ERROR;
+
+    mLazyData->setDataPosition(sizeof(int32_t));  // skip the magic number
+
+    int32_t num_entries;
+    RETURN_IF_FAILED(mLazyData->readInt32(&num_entries));
+
+    for (; num_entries > 0; --num_entries) {
+        String16 key;
+        int32_t value_type;
+        RETURN_IF_FAILED(mLazyData->readString16(&key));
+        RETURN_IF_FAILED(mLazyData->readInt32(&value_type));
+        mLazyIndex.emplace(std::move(key),
+                           std::make_pair(value_type, mLazyData->dataPosition()));
+        RETURN_IF_FAILED(skipValue(mLazyData.get(), value_type));
+    }
+
+    mLazyIndexBuilt = true;
+    return NO_ERROR;
+}
+
+bool PersistableBundle::findLazyEntry(int32_t type, const String16& key, size_t* offset) const {
+    if (!mLazyData) return false;
+    if (buildLazyIndex() != NO_ERROR) return false;
+    const auto& it = mLazyIndex.find(key);
+    if (it == mLazyIndex.end() || it->second.first != type) return false;
+    *offset = it->second.second;
+    return true;
+}
+
+void PersistableBundle::unparcel() const {
+    if (!mLazyData) return;
+
+    /*
+     * Move the raw region out first so readFromParcelInner() runs against a
+     * bundle with no lazy state left.
+     */
+    std::unique_ptr<Parcel> data = std::move(mLazyData);
+    mLazyIndex.clear();
+    mLazyIndexBuilt = false;
+
+    data->setDataPosition(0);
+    auto* self = const_cast<PersistableBundle*>(this);
+    status_t err = self->readFromParcelInner(data.get(), data->dataSize());
+    ALOGE_IF(err != NO_ERROR, "Failed to materialize lazy PersistableBundle: %d", err);
+}
+
 }  // namespace os
 
 }  // namespace android
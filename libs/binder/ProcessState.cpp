@@ -23,6 +23,7 @@
 #include <binder/BpBinder.h>
 #include <binder/IPCThreadState.h>
 #include <binder/IServiceManager.h>
+#include <binder/Parcel.h>
 #include <binder/Stability.h>
 #include <cutils/atomic.h>
 #include <utils/AndroidThreads.h>
@@ -277,26 +278,34 @@ void ProcessState::setCallRestriction(CallRestriction restriction) {
     mCallRestriction = restriction;
 }
 
-ProcessState::handle_entry* ProcessState::lookupHandleLocked(int32_t handle)
+ProcessState::HandleTableShard& ProcessState::shardForHandle(int32_t handle)
 {
-    const size_t N=mHandleToObject.size();
-    if (N <= (size_t)handle) {
+    return mHandleTableShards[static_cast<size_t>(handle) % kHandleTableShards];
+}
+
+ProcessState::handle_entry* ProcessState::lookupHandleLocked(HandleTableShard& shard,
+                                                             int32_t handle)
+{
+    const size_t index = static_cast<size_t>(handle) / kHandleTableShards;
+    const size_t N = shard.handleToObject.size();
+    if (N <= index) {
         handle_entry e;
         e.binder = nullptr;
         e.refs = nullptr;
-        status_t err = mHandleToObject.insertAt(e, N, handle+1-N);
+        status_t err = shard.handleToObject.insertAt(e, N, index+1-N);
         if (err < NO_ERROR) return nullptr;
     }
-    return &mHandleToObject.editItemAt(handle);
+    return &shard.handleToObject.editItemAt(index);
 }
 
 sp<IBinder> ProcessState::getStrongProxyForHandle(int32_t handle)
 {
     sp<IBinder> result;
 
-    AutoMutex _l(mLock);
+    HandleTableShard& shard = shardForHandle(handle);
+    AutoMutex _l(shard.lock);
 
-    handle_entry* e = lookupHandleLocked(handle);
+    handle_entry* e = lookupHandleLocked(shard, handle);
 
     if (e != nullptr) {
         // We need to create a new BpBinder if there isn't currently one, OR we
@@ -356,9 +365,10 @@ sp<IBinder> ProcessState::getStrongProxyForHandle(int32_t handle)
 
 void ProcessState::expungeHandle(int32_t handle, IBinder* binder)
 {
-    AutoMutex _l(mLock);
+    HandleTableShard& shard = shardForHandle(handle);
+    AutoMutex _l(shard.lock);
 
-    handle_entry* e = lookupHandleLocked(handle);
+    handle_entry* e = lookupHandleLocked(shard, handle);
 
     // This handle may have already been replaced with a new BpBinder
     // (if someone failed the AttemptIncWeak() above); we don't want
@@ -386,7 +396,37 @@ void ProcessState::spawnPooledThread(bool isMain)
         ALOGV("Spawning new pooled thread, name=%s\n", name.string());
         sp<Thread> t = sp<PoolThread>::make(isMain);
         t->run(name.string());
+        pthread_mutex_lock(&mThreadCountLock);
+        mThreadsSpawned++;
+        pthread_mutex_unlock(&mThreadCountLock);
+    }
+}
+
+void ProcessState::setThreadPoolIdleTimeoutMs(int64_t timeoutMs) {
+    pthread_mutex_lock(&mThreadCountLock);
+    mThreadPoolIdleTimeoutMs = timeoutMs;
+    pthread_mutex_unlock(&mThreadCountLock);
+}
+
+ProcessState::ThreadPoolStats ProcessState::getThreadPoolStats() {
+    pthread_mutex_lock(&mThreadCountLock);
+    ThreadPoolStats stats = {.currentThreads = mCurrentThreads,
+                             .threadsSpawned = mThreadsSpawned,
+                             .threadsRetired = mThreadsRetired,
+                             .starvationEvents = mStarvationEvents};
+    pthread_mutex_unlock(&mThreadCountLock);
+    return stats;
+}
+
+bool ProcessState::attemptThreadRetire() {
+    pthread_mutex_lock(&mThreadCountLock);
+    const bool retire = mCurrentThreads > kThreadPoolRetireFloor;
+    if (retire) {
+        mCurrentThreads--;
+        mThreadsRetired++;
     }
+    pthread_mutex_unlock(&mThreadCountLock);
+    return retire;
 }
 
 status_t ProcessState::setThreadPoolMaxThreadCount(size_t maxThreads) {
@@ -441,6 +481,10 @@ status_t ProcessState::enableOnewaySpamDetection(bool enable) {
     return NO_ERROR;
 }
 
+void ProcessState::setParcelBufferPoolEnabled(bool enable) {
+    Parcel::setBufferPoolEnabled(enable);
+}
+
 void ProcessState::giveThreadPoolName() {
     androidSetThreadName( makeBinderThreadName().string() );
 }
@@ -491,7 +535,12 @@ ProcessState::ProcessState(const char* driver)
         mExecutingThreadsCount(0),
         mWaitingForThreads(0),
         mMaxThreads(DEFAULT_MAX_BINDER_THREADS),
+        mCurrentThreads(0),
+        mThreadPoolIdleTimeoutMs(0),
         mStarvationStartTimeMs(0),
+        mThreadsSpawned(0),
+        mThreadsRetired(0),
+        mStarvationEvents(0),
         mForked(false),
         mThreadPoolStarted(false),
         mThreadPoolSeq(1),
@@ -26,7 +26,6 @@
 
 #include <android-base/file.h>
 #include <android-base/hex.h>
-#include <android-base/scopeguard.h>
 #include <binder/Parcel.h>
 #include <binder/RpcServer.h>
 #include <binder/RpcTransportRaw.h>
@@ -41,7 +40,6 @@ namespace android {
 
 constexpr size_t kSessionIdBytes = 32;
 
-using base::ScopeGuard;
 using base::unique_fd;
 
 RpcServer::RpcServer(std::unique_ptr<RpcTransportCtx> ctx) : mCtx(std::move(ctx)) {}
@@ -113,6 +111,21 @@ void RpcServer::setMaxThreads(size_t threads) {
     mMaxThreads = threads;
 }
 
+void RpcServer::setMaxConnectingThreads(size_t threads) {
+    LOG_ALWAYS_FATAL_IF(threads <= 0, "RpcServer cannot establish connections without threads");
+    LOG_ALWAYS_FATAL_IF(mJoinThreadRunning, "Cannot set max connecting threads while running");
+    mMaxConnectingThreads = threads;
+}
+
+size_t RpcServer::getMaxConnectingThreads() {
+    return mMaxConnectingThreads;
+}
+
+RpcServer::AcceptLatencyStats RpcServer::getAcceptLatencyStats() {
+    std::lock_guard<std::mutex> _l(mLock);
+    return mAcceptLatencyStats;
+}
+
 size_t RpcServer::getMaxThreads() {
     return mMaxThreads;
 }
@@ -194,14 +207,34 @@ void RpcServer::join() {
 
         {
             std::lock_guard<std::mutex> _l(mLock);
-            std::thread thread =
-                    std::thread(&RpcServer::establishConnection, sp<RpcServer>::fromExisting(this),
-                                std::move(clientFd), addr, addrLen);
-            mConnectingThreads[thread.get_id()] = std::move(thread);
+            mPendingConnections.push_back(PendingConnection{std::move(clientFd), addr, addrLen,
+                                                            std::chrono::steady_clock::now()});
+            // Grow the handshake pool only when every thread is busy, up to the configured
+            // bound. Under a connection storm the queue grows instead of the thread count.
+            if (mIdleConnectionSetupThreads == 0 &&
+                mConnectionSetupThreads.size() < mMaxConnectingThreads) {
+                mConnectionSetupThreads.emplace_back(&RpcServer::connectionSetupLoop,
+                                                     sp<RpcServer>::fromExisting(this));
+            }
         }
+        mPendingConnectionCv.notify_one();
     }
     LOG_RPC_DETAIL("RpcServer::join exiting with %s", statusToString(status).c_str());
 
+    // Wake the handshake threads so they observe the shutdown trigger, and join them before
+    // signaling shutdown progress. Queued sockets which never started a handshake are dropped.
+    std::vector<std::thread> connectionSetupThreads;
+    {
+        std::lock_guard<std::mutex> _l(mLock);
+        connectionSetupThreads = std::move(mConnectionSetupThreads);
+        mConnectionSetupThreads.clear();
+        mPendingConnections.clear();
+    }
+    mPendingConnectionCv.notify_all();
+    for (auto& thread : connectionSetupThreads) {
+        thread.join();
+    }
+
     {
         std::lock_guard<std::mutex> _l(mLock);
         mJoinThreadRunning = false;
@@ -263,11 +296,32 @@ std::vector<sp<RpcSession>> RpcServer::listSessions() {
 
 size_t RpcServer::numUninitializedSessions() {
     std::lock_guard<std::mutex> _l(mLock);
-    return mConnectingThreads.size();
+    return mConnectingThreads.size() + mPendingConnections.size() +
+            (mConnectionSetupThreads.size() - mIdleConnectionSetupThreads);
+}
+
+void RpcServer::connectionSetupLoop(sp<RpcServer>&& server) {
+    while (true) {
+        PendingConnection pending;
+        {
+            std::unique_lock<std::mutex> _l(server->mLock);
+            server->mIdleConnectionSetupThreads++;
+            server->mPendingConnectionCv.wait(_l, [&server] {
+                return !server->mPendingConnections.empty() ||
+                        server->mShutdownTrigger->isTriggered();
+            });
+            server->mIdleConnectionSetupThreads--;
+            if (server->mShutdownTrigger->isTriggered()) {
+                return;
+            }
+            pending = std::move(server->mPendingConnections.front());
+            server->mPendingConnections.pop_front();
+        }
+        establishConnection(sp<RpcServer>(server), std::move(pending));
+    }
 }
 
-void RpcServer::establishConnection(sp<RpcServer>&& server, base::unique_fd clientFd,
-                                    const sockaddr_storage addr, socklen_t addrLen) {
+void RpcServer::establishConnection(sp<RpcServer>&& server, PendingConnection&& pending) {
     // mShutdownTrigger can only be cleared once connection threads have joined.
     // It must be set before this thread is started
     LOG_ALWAYS_FATAL_IF(server->mShutdownTrigger == nullptr);
@@ -275,8 +329,9 @@ void RpcServer::establishConnection(sp<RpcServer>&& server, base::unique_fd clie
 
     status_t status = OK;
 
-    int clientFdForLog = clientFd.get();
-    auto client = server->mCtx->newTransport(std::move(clientFd), server->mShutdownTrigger.get());
+    int clientFdForLog = pending.fd.get();
+    auto client =
+            server->mCtx->newTransport(std::move(pending.fd), server->mShutdownTrigger.get());
     if (client == nullptr) {
         ALOGE("Dropping accept4()-ed socket because sslAccept fails");
         status = DEAD_OBJECT;
@@ -341,21 +396,22 @@ void RpcServer::establishConnection(sp<RpcServer>&& server, base::unique_fd clie
         }
     }
 
-    std::thread thisThread;
     sp<RpcSession> session;
     {
         std::unique_lock<std::mutex> _l(server->mLock);
 
-        auto threadId = server->mConnectingThreads.find(std::this_thread::get_id());
-        LOG_ALWAYS_FATAL_IF(threadId == server->mConnectingThreads.end(),
-                            "Must establish connection on owned thread");
-        thisThread = std::move(threadId->second);
-        ScopeGuard detachGuard = [&]() {
-            thisThread.detach();
-            _l.unlock();
-            server->mShutdownCv.notify_all();
+        // Accounts a connection as usable from the moment it was accepted. Called with
+        // the server lock held once the handshake is done and the connection is attached
+        // to a session.
+        const auto recordAcceptLatency = [&] {
+            const auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                                           std::chrono::steady_clock::now() - pending.acceptTime)
+                                           .count();
+            auto& stats = server->mAcceptLatencyStats;
+            stats.connections++;
+            stats.totalLatencyUs += static_cast<uint64_t>(latencyUs);
+            stats.maxLatencyUs = std::max(stats.maxLatencyUs, static_cast<uint64_t>(latencyUs));
         };
-        server->mConnectingThreads.erase(threadId);
 
         if (status != OK || server->mShutdownTrigger->isTriggered()) {
             return;
@@ -396,8 +452,8 @@ void RpcServer::establishConnection(sp<RpcServer>&& server, base::unique_fd clie
             sp<IBinder> sessionSpecificRoot;
             if (server->mRootObjectFactory != nullptr) {
                 sessionSpecificRoot =
-                        server->mRootObjectFactory(reinterpret_cast<const sockaddr*>(&addr),
-                                                   addrLen);
+                        server->mRootObjectFactory(reinterpret_cast<const sockaddr*>(&pending.addr),
+                                                   pending.addrLen);
                 if (sessionSpecificRoot == nullptr) {
                     ALOGE("Warning: server returned null from root object factory");
                 }
@@ -426,13 +482,35 @@ void RpcServer::establishConnection(sp<RpcServer>&& server, base::unique_fd clie
         if (incoming) {
             LOG_ALWAYS_FATAL_IF(OK != session->addOutgoingConnection(std::move(client), true),
                                 "server state must already be initialized");
+            recordAcceptLatency();
             return;
         }
 
-        detachGuard.Disable();
-        session->preJoinThreadOwnership(std::move(thisThread));
+        // The dedicated session thread is spawned only now that the handshake succeeded, so
+        // sockets which never complete setup do not cost a thread. The thread object is
+        // parked in mConnectingThreads under the lock, and the new thread claims it before
+        // handing its ownership to the session.
+        std::thread thread(&RpcServer::joinSessionThread, sp<RpcServer>(server),
+                           sp<RpcSession>(session), std::move(client));
+        server->mConnectingThreads[thread.get_id()] = std::move(thread);
+        recordAcceptLatency();
+    }
+}
+
+void RpcServer::joinSessionThread(sp<RpcServer>&& server, sp<RpcSession>&& session,
+                                  std::unique_ptr<RpcTransport> client) {
+    std::thread thisThread;
+    {
+        std::lock_guard<std::mutex> _l(server->mLock);
+        auto threadId = server->mConnectingThreads.find(std::this_thread::get_id());
+        LOG_ALWAYS_FATAL_IF(threadId == server->mConnectingThreads.end(),
+                            "Must join session on owned thread");
+        thisThread = std::move(threadId->second);
+        server->mConnectingThreads.erase(threadId);
     }
+    server->mShutdownCv.notify_all();
 
+    session->preJoinThreadOwnership(std::move(thisThread));
     auto setupResult = session->preJoinSetup(std::move(client));
 
     // avoid strong cycle
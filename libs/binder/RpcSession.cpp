@@ -132,33 +132,49 @@ std::optional<uint32_t> RpcSession::getProtocolVersion() {
     return mProtocolVersion;
 }
 
+// The connectors below own all of their state, since setupClient keeps a copy
+// of them for the session's lifetime to open additional connections on demand.
+
 status_t RpcSession::setupUnixDomainClient(const char* path) {
-    return setupSocketClient(UnixSocketAddress(path));
+    return setupClient([this, addr = UnixSocketAddress(path)](
+                               const std::vector<uint8_t>& sessionId, bool incoming) {
+        return setupOneSocketConnection(addr, sessionId, incoming);
+    });
 }
 
 status_t RpcSession::setupVsockClient(unsigned int cid, unsigned int port) {
-    return setupSocketClient(VsockSocketAddress(cid, port));
+    return setupClient([this, addr = VsockSocketAddress(cid, port)](
+                               const std::vector<uint8_t>& sessionId, bool incoming) {
+        return setupOneSocketConnection(addr, sessionId, incoming);
+    });
 }
 
 status_t RpcSession::setupInetClient(const char* addr, unsigned int port) {
-    auto aiStart = InetSocketAddress::getAddrInfo(addr, port);
-    if (aiStart == nullptr) return UNKNOWN_ERROR;
-    for (auto ai = aiStart.get(); ai != nullptr; ai = ai->ai_next) {
-        InetSocketAddress socketAddress(ai->ai_addr, ai->ai_addrlen, addr, port);
-        if (status_t status = setupSocketClient(socketAddress); status == OK) return OK;
-    }
-    ALOGE("None of the socket address resolved for %s:%u can be added as inet client.", addr, port);
-    return NAME_NOT_FOUND;
+    // resolved per connection - InetSocketAddress points into the addrinfo
+    // list, so it cannot be stored in the connector itself
+    return setupClient([this, addrStr = std::string(addr),
+                        port](const std::vector<uint8_t>& sessionId, bool incoming) -> status_t {
+        auto aiStart = InetSocketAddress::getAddrInfo(addrStr.c_str(), port);
+        if (aiStart == nullptr) return UNKNOWN_ERROR;
+        for (auto ai = aiStart.get(); ai != nullptr; ai = ai->ai_next) {
+            InetSocketAddress socketAddress(ai->ai_addr, ai->ai_addrlen, addrStr.c_str(), port);
+            if (status_t status = setupOneSocketConnection(socketAddress, sessionId, incoming);
+                status == OK)
+                return OK;
+        }
+        ALOGE("None of the socket address resolved for %s:%u can be added as inet client.",
+              addrStr.c_str(), port);
+        return NAME_NOT_FOUND;
+    });
 }
 
 status_t RpcSession::setupPreconnectedClient(unique_fd fd, std::function<unique_fd()>&& request) {
-    // Why passing raw fd? When fd is passed as reference, Clang analyzer sees that the variable
-    // `fd` is a moved-from object. To work-around the issue, unwrap the raw fd from the outer `fd`,
-    // pass the raw fd by value to the lambda, and then finally wrap it in unique_fd inside the
-    // lambda.
-    return setupClient([&, raw = fd.release()](const std::vector<uint8_t>& sessionId,
-                                               bool incoming) -> status_t {
-        unique_fd fd(raw);
+    // The shared_ptr keeps the connector copyable; the first connection
+    // consumes the given fd and every one after that comes from 'request'.
+    auto firstFd = std::make_shared<unique_fd>(std::move(fd));
+    return setupClient([this, firstFd, request = std::move(request)](
+                               const std::vector<uint8_t>& sessionId, bool incoming) -> status_t {
+        unique_fd fd = std::move(*firstFd);
         if (!fd.ok()) {
             fd = request();
             if (!fd.ok()) return BAD_VALUE;
@@ -463,6 +479,7 @@ status_t RpcSession::setupClient(const std::function<status_t(const std::vector<
         // downgrade again
         mProtocolVersion = oldProtocolVersion;
 
+        mConnectFunction = nullptr;
         mConnections = {};
     });
 
@@ -505,18 +522,19 @@ status_t RpcSession::setupClient(const std::function<status_t(const std::vector<
              "because it is preconfigured to start at most %zu outgoing threads.",
              numThreadsAvailable, outgoingThreads, mMaxOutgoingThreads);
 
-    // TODO(b/189955605): we should add additional sessions dynamically
-    // instead of all at once - the other side should be responsible for setting
-    // up additional connections. We need to create at least one (unless 0 are
-    // requested to be set) in order to allow the other side to reliably make
-    // any requests at all.
-
-    // we've already setup one client
-    LOG_RPC_DETAIL("RpcSession::setupClient() instantiating %zu outgoing (server max: %zu) and %zu "
-                   "incoming threads",
+    // Outgoing connections beyond the first are added dynamically, the first
+    // time every existing connection is busy with a transaction - see
+    // ExclusiveConnection::find. This keeps the number of sockets (and the
+    // number of threads serving them on the other side) proportional to the
+    // concurrency the session actually reaches, instead of the configured
+    // maximum.
+    LOG_RPC_DETAIL("RpcSession::setupClient() instantiating 1 of up to %zu outgoing (server max: "
+                   "%zu) and %zu incoming threads",
                    outgoingThreads, numThreadsAvailable, mMaxIncomingThreads);
-    for (size_t i = 0; i + 1 < outgoingThreads; i++) {
-        if (status_t status = connectAndInit(mId, false /*incoming*/); status != OK) return status;
+    {
+        std::lock_guard<std::mutex> _l(mMutex);
+        mConnections.mMaxOutgoing = outgoingThreads;
+        mConnectFunction = connectAndInit;
     }
 
     for (size_t i = 0; i < mMaxIncomingThreads; i++) {
@@ -528,12 +546,6 @@ status_t RpcSession::setupClient(const std::function<status_t(const std::vector<
     return OK;
 }
 
-status_t RpcSession::setupSocketClient(const RpcSocketAddress& addr) {
-    return setupClient([&](const std::vector<uint8_t>& sessionId, bool incoming) {
-        return setupOneSocketConnection(addr, sessionId, incoming);
-    });
-}
-
 status_t RpcSession::setupOneSocketConnection(const RpcSocketAddress& addr,
                                               const std::vector<uint8_t>& sessionId,
                                               bool incoming) {
@@ -866,6 +878,27 @@ status_t RpcSession::ExclusiveConnection::find(const sp<RpcSession>& session, Co
             return WOULD_BLOCK;
         }
 
+        // All outgoing connections are busy. If the negotiated maximum allows
+        // another one, open it now instead of waiting - connections are only
+        // created lazily, so this is where the session grows under load.
+        if (session->mConnectFunction != nullptr &&
+            session->mConnections.mOutgoing.size() + session->mConnections.mOutgoingPending <
+                    session->mConnections.mMaxOutgoing) {
+            session->mConnections.mOutgoingPending++;
+            _l.unlock();
+            status_t status = session->mConnectFunction(session->mId, false /*incoming*/);
+            _l.lock();
+            session->mConnections.mOutgoingPending--;
+            if (status == OK) {
+                // Compete for the new connection (another waiting thread may
+                // legitimately grab it first).
+                continue;
+            }
+            ALOGE("Failed to open additional outgoing connection on demand: %s. Waiting for an "
+                  "existing connection to free up.",
+                  statusToString(status).c_str());
+        }
+
         LOG_RPC_DETAIL("No available connections (have %zu clients and %zu servers). Waiting...",
                        session->mConnections.mOutgoing.size(),
                        session->mConnections.mIncoming.size());
@@ -319,15 +319,9 @@ status_t RpcTransportTls::interruptableWriteFully(FdTrigger* fdTrigger, iovec* i
     if (fdTrigger->isTriggered()) return DEAD_OBJECT;
 
     size_t size = 0;
-    for (int i = 0; i < niovs; i++) {
-        const iovec& iov = iovs[i];
-        if (iov.iov_len == 0) {
-            continue;
-        }
-        size += iov.iov_len;
-
-        auto buffer = reinterpret_cast<const uint8_t*>(iov.iov_base);
-        const uint8_t* end = buffer + iov.iov_len;
+    auto writeBuffer = [&](const uint8_t* buffer, size_t len) -> status_t {
+        size += len;
+        const uint8_t* end = buffer + len;
         while (buffer < end) {
             size_t todo = std::min<size_t>(end - buffer, std::numeric_limits<int>::max());
             auto [writeSize, errorQueue] = mSsl.call(SSL_write, buffer, todo);
@@ -345,6 +339,39 @@ status_t RpcTransportTls::interruptableWriteFully(FdTrigger* fdTrigger, iovec* i
             if (pollStatus != OK) return pollStatus;
             // Do not advance buffer. Try SSL_write() again.
         }
+        return OK;
+    };
+
+    // Each SSL_write() emits at least one TLS record, so writing every iovec
+    // separately costs a record and a syscall per wire header. Coalesce the
+    // leading small iovecs (the RpcWireHeader and transaction/reply headers)
+    // into one bounded stack buffer so they go out in a single record. Large
+    // payload iovecs are still written in place, without copying.
+    uint8_t coalesced[512];
+    size_t coalescedSize = 0;
+    int coalescedIovs = 0;
+    while (coalescedIovs < niovs &&
+           coalescedSize + iovs[coalescedIovs].iov_len <= sizeof(coalesced)) {
+        memcpy(coalesced + coalescedSize, iovs[coalescedIovs].iov_base,
+               iovs[coalescedIovs].iov_len);
+        coalescedSize += iovs[coalescedIovs].iov_len;
+        coalescedIovs++;
+    }
+
+    int i = 0;
+    if (coalescedIovs >= 2) {
+        if (status_t status = writeBuffer(coalesced, coalescedSize); status != OK) return status;
+        i = coalescedIovs;
+    }
+    for (; i < niovs; i++) {
+        const iovec& iov = iovs[i];
+        if (iov.iov_len == 0) {
+            continue;
+        }
+        if (status_t status = writeBuffer(reinterpret_cast<const uint8_t*>(iov.iov_base),
+                                          iov.iov_len);
+            status != OK)
+            return status;
     }
     LOG_TLS_DETAIL("TLS: Sent %zu bytes!", size);
     return OK;
@@ -20,6 +20,7 @@
 #include <utils/Mutex.h>
 
 #include <map>
+#include <string>
 #include <unordered_map>
 #include <variant>
 
@@ -85,6 +86,17 @@ public:
     static void         setLimitCallback(binder_proxy_limit_callback cb);
     static void         setBinderProxyCountWatermarks(int high, int low);
 
+    // Always-on census of the binder proxies alive in this process. Unlike the
+    // count-by-uid machinery above this is never disabled: proxy construction
+    // and destruction only touch a sharded atomic counter, so it is cheap
+    // enough for production. A proxy is attributed to an interface once its
+    // descriptor has been resolved (see getInterfaceDescriptor()), so the
+    // per-interface counts cover proxies that have been used at least once.
+    static uint32_t     getTotalBinderProxyCount();
+    static void         getProxyCountsByInterface(std::map<String16, uint32_t>* counts);
+    // Appends a human-readable census to out, for use by dump() handlers.
+    static void         dumpProxyCensus(std::string* out);
+
     std::optional<int32_t> getDebugBinderHandle() const;
 
     class ObjectManager {
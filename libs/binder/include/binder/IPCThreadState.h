@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <list>
+
 #include <utils/Errors.h>
 #include <binder/Parcel.h>
 #include <binder/ProcessState.h>
@@ -150,6 +152,17 @@ public:
                                          uint32_t code, const Parcel& data,
                                          Parcel* reply, uint32_t flags);
 
+            // Within a beginBatch()/endBatch() scope, oneway transactions
+            // issued on this thread are queued in the thread-local command
+            // buffer instead of being written to the driver one ioctl at a
+            // time. endBatch() flushes the whole burst with a single
+            // BINDER_WRITE_READ and returns the first error encountered, if
+            // any. Scopes may nest; only the outermost endBatch() flushes.
+            // A synchronous transaction inside a scope flushes the pending
+            // batch first.
+            void                beginBatch();
+            status_t            endBatch();
+
             void                incStrongHandle(int32_t handle, BpBinder *proxy);
             void                decStrongHandle(int32_t handle);
             void                incWeakHandle(int32_t handle, BpBinder *proxy);
@@ -207,6 +220,7 @@ private:
                                                      status_t* statusBuffer);
             status_t            getAndExecuteCommand();
             status_t            executeCommand(int32_t command);
+            status_t            flushBatchedOneways();
             void                processPendingDerefs();
             void                processPostWriteDerefs();
 
@@ -237,6 +251,14 @@ private:
             bool                mPropagateWorkSource;
             bool                mIsLooper;
             bool mIsFlushing;
+            // Depth of nested beginBatch() scopes on this thread.
+            int32_t             mBatchDepth;
+            // Oneway transactions queued in mOut awaiting the batch flush.
+            int32_t             mBatchedOneways;
+            // Owned copies of the batched transactions' payloads. The kernel
+            // reads the sender's buffers at the flush ioctl, not at queue
+            // time, so the data must stay alive until the batch is flushed.
+            std::list<Parcel>   mBatchedTransactionData;
             int32_t             mStrictModePolicy;
             int32_t             mLastTransactionBinderFlags;
             CallRestriction     mCallRestriction;
@@ -152,6 +152,16 @@ sp<IServiceManager> defaultServiceManager();
  */
 void setDefaultServiceManager(const sp<IServiceManager>& sm);
 
+/**
+ * Enables a process-wide cache of successful checkService()/getService()
+ * lookups. Cached entries are kept fresh by a servicemanager registration
+ * callback (re-registration replaces the cached binder) and evicted when the
+ * cached binder dies, so repeated lookups stop round-tripping to
+ * servicemanager. Intended for processes doing many lookups at startup or
+ * after fork.
+ */
+void enableServiceCache(bool enable);
+
 template<typename INTERFACE>
 sp<INTERFACE> waitForService(const String16& name) {
     const sp<IServiceManager> sm = defaultServiceManager();
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <functional>
 
 #include <binder/IServiceManager.h>
@@ -79,6 +80,33 @@ class LazyServiceRegistrar {
       */
      void setActiveServicesCallback(const std::function<bool(bool)>& activeServicesCallback);
 
+     /**
+      * Set how long all services in the process must remain without clients
+      * before the process shuts itself down. A client that reconnects within
+      * the window cancels the pending shutdown, so services under oscillating
+      * load stay alive instead of repeatedly paying process startup costs.
+      *
+      * Defaults to zero: shut down as soon as the client count drops to zero.
+      *
+      * This method should be called before 'registerService' to avoid races.
+      */
+     void setShutdownIdleDelay(std::chrono::milliseconds delay);
+
+     /**
+      * Counters describing this process's lifecycle decisions, so lazy
+      * services can report how often they restart and how often the idle
+      * window saved a restart.
+      */
+     struct ShutdownStats {
+         /** Times all services went idle and a shutdown was attempted. */
+         uint64_t shutdownAttempts = 0;
+         /** Pending shutdowns cancelled by a client reconnecting within the idle window. */
+         uint64_t shutdownsCancelled = 0;
+         /** Shutdown attempts that raced with an incoming client and had to re-register. */
+         uint64_t reRegisters = 0;
+     };
+     ShutdownStats getShutdownStats() const;
+
      /**
       * Try to unregister all services previously registered with 'registerService'.
       * Returns 'true' if successful. This should only be called within the callback registered by
@@ -25,7 +25,7 @@
 namespace android {
 // ----------------------------------------------------------------------------
 
-class SimpleBestFitAllocator;
+class BuddyAllocator;
 
 // ----------------------------------------------------------------------------
 
@@ -50,10 +50,10 @@ private:
     friend class Allocation;
     virtual void                deallocate(size_t offset);
     const sp<IMemoryHeap>&      heap() const;
-    SimpleBestFitAllocator*     allocator() const;
+    BuddyAllocator*             allocator() const;
 
     sp<IMemoryHeap>             mHeap;
-    SimpleBestFitAllocator*     mAllocator;
+    BuddyAllocator*             mAllocator;
 };
 
 
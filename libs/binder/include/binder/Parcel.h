@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <string.h>
+
 #include <array>
 #include <map> // for legacy reasons
 #include <string>
@@ -60,10 +62,12 @@ class Status;
 
 class Parcel {
     friend class IPCThreadState;
+    friend class ProcessState;
     friend class RpcState;
 
 public:
     class ReadableBlob;
+    class ReadCursor;
     class WritableBlob;
 
                         Parcel();
@@ -170,6 +174,11 @@ public:
     status_t            writeStrongBinder(const sp<IBinder>& val);
     status_t            writeInt32Array(size_t len, const int32_t *val);
     status_t            writeByteArray(size_t len, const uint8_t *val);
+    // Like writeByteArray(), but routed through the blob mechanism: payloads
+    // above the in-place limit travel in an ashmem region attached as a file
+    // descriptor instead of through the binder buffer. Read back with
+    // readByteVectorAsBlob().
+    status_t            writeByteArrayAsBlob(size_t len, const uint8_t *val);
     status_t            writeBool(bool val);
     status_t            writeChar(char16_t val);
     status_t            writeByte(int8_t val);
@@ -369,6 +378,13 @@ public:
     
     status_t            read(void* outData, size_t len) const;
     const void*         readInplace(size_t len) const;
+    // Validates once that `len` bytes are available at the current position
+    // and advances past them, handing out a cursor for unchecked typed reads
+    // within that window. Intended for hot loops draining many primitives
+    // back to back, where the per-read range check in readInt32() and
+    // friends is measurable. The caller must not read more than `len` bytes
+    // through the cursor; reads through it perform no bounds checking.
+    status_t            startValidatedRead(size_t len, ReadCursor* outCursor) const;
     int32_t             readInt32() const;
     status_t            readInt32(int32_t *pArg) const;
     uint32_t            readUint32() const;
@@ -478,6 +494,8 @@ public:
     status_t            readByteVector(std::optional<std::vector<uint8_t>>* val) const;
     status_t            readByteVector(std::unique_ptr<std::vector<uint8_t>>* val) const __attribute__((deprecated("use std::optional version instead")));
     status_t            readByteVector(std::vector<uint8_t>* val) const;
+    // Counterpart of writeByteArrayAsBlob().
+    status_t            readByteVectorAsBlob(std::vector<uint8_t>* val) const;
     status_t            readInt32Vector(std::optional<std::vector<int32_t>>* val) const;
     status_t            readInt32Vector(std::unique_ptr<std::vector<int32_t>>* val) const __attribute__((deprecated("use std::optional version instead")));
     status_t            readInt32Vector(std::vector<int32_t>* val) const;
@@ -615,6 +633,10 @@ private:
     uintptr_t           readPointer() const;
     void                freeDataNoInit();
     void                initState();
+
+    // Routes freed data buffers to per-thread free lists for reuse. Only
+    // ProcessState::setParcelBufferPoolEnabled() should flip this.
+    static void         setBufferPoolEnabled(bool enabled);
     void                scanForFds() const;
     status_t            validateReadData(size_t len) const;
 
@@ -1354,6 +1376,33 @@ public:
         inline void* data() { return mData; }
     };
 
+    // Cursor for unchecked typed reads inside a window previously validated
+    // with startValidatedRead(). See there for the safety contract.
+    class ReadCursor {
+        friend class Parcel;
+        const uint8_t* mCursor = nullptr;
+
+        template <class T>
+        T readUnchecked() {
+            static_assert(sizeof(T) % 4 == 0); // reads stay 4-byte aligned
+            static_assert(std::is_trivially_copyable_v<T>);
+            T result;
+            memcpy(&result, mCursor, sizeof(T));
+            mCursor += sizeof(T);
+            return result;
+        }
+
+    public:
+        ReadCursor() = default;
+        inline int32_t readInt32() { return readUnchecked<int32_t>(); }
+        inline uint32_t readUint32() { return readUnchecked<uint32_t>(); }
+        inline int64_t readInt64() { return readUnchecked<int64_t>(); }
+        inline uint64_t readUint64() { return readUnchecked<uint64_t>(); }
+        inline float readFloat() { return readUnchecked<float>(); }
+        inline double readDouble() { return readUnchecked<double>(); }
+        inline bool readBool() { return readUnchecked<int32_t>() != 0; }
+    };
+
     /**
      * Returns the total amount of ashmem memory owned by this object.
      *
@@ -21,6 +21,9 @@
 #include <stdint.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <memory>
+
 #include <utils/String16.h>
 #include <utils/Singleton.h>
 #include <utils/SortedVector.h>
@@ -48,12 +51,22 @@ class PermissionCache : Singleton<PermissionCache> {
             return (uid == e.uid) ? (name < e.name) : (uid < e.uid);
         }
     };
-    mutable Mutex mLock;
-    // we pool all the permission names we see, as many permissions checks
-    // will have identical names
-    SortedVector< String16 > mPermissionNamesPool;
-    // this is our cache per say. it stores pooled names.
-    SortedVector< Entry > mCache;
+    // Immutable snapshot of the cache contents. Readers grab a reference
+    // atomically and search it without taking any lock; writers build a new
+    // snapshot under mLock and publish it with an atomic swap.
+    struct State {
+        // we pool all the permission names we see, as many permissions checks
+        // will have identical names
+        SortedVector< String16 > permissionNamesPool;
+        // this is our cache per say. it stores pooled names.
+        SortedVector< Entry > cache;
+    };
+
+    mutable Mutex mLock; // serializes writers; readers never take it
+    std::shared_ptr<const State> mState;
+    // Bumped on every purge. A result whose permission check started before
+    // a purge is considered stale and is not inserted.
+    std::atomic<uint32_t> mGeneration;
 
     // free the whole cache, but keep the permission name pool
     void purge();
@@ -61,7 +74,8 @@ class PermissionCache : Singleton<PermissionCache> {
     status_t check(bool* granted,
             const String16& permission, uid_t uid) const;
 
-    void cache(const String16& permission, uid_t uid, bool granted);
+    void cache(const String16& permission, uid_t uid, bool granted,
+            uint32_t generation);
 
 public:
     PermissionCache();
@@ -75,6 +89,11 @@ public:
             pid_t pid, uid_t uid);
 
     static void purgeCache();
+
+    // Generation of the cache contents; bumped by purgeCache(). Lets
+    // callers detect that cached decisions they derived from this cache
+    // have been invalidated.
+    static uint32_t getGeneration();
 };
 
 // ---------------------------------------------------------------------------
@@ -17,7 +17,9 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include <binder/Parcelable.h>
@@ -36,11 +38,24 @@ class PersistableBundle : public Parcelable {
 public:
     PersistableBundle() = default;
     virtual ~PersistableBundle() = default;
-    PersistableBundle(const PersistableBundle& bundle) = default;
+    PersistableBundle(const PersistableBundle& bundle);
+    PersistableBundle& operator=(const PersistableBundle& bundle);
+    PersistableBundle(PersistableBundle&& bundle) noexcept = default;
+    PersistableBundle& operator=(PersistableBundle&& bundle) noexcept = default;
 
     status_t writeToParcel(Parcel* parcel) const override;
     status_t readFromParcel(const Parcel* parcel) override;
 
+    /*
+     * Reads the bundle from |parcel| without eagerly deserializing its
+     * key/value pairs. The raw bundle region is copied once and an offset
+     * index over it is built on first access, so getters only deserialize
+     * the values they are asked for. Mutation, key enumeration, size() and
+     * reserialization materialize the whole bundle first. Intended for
+     * large config bundles of which consumers touch only a few keys.
+     */
+    status_t readFromParcelLazy(const Parcel* parcel);
+
     bool empty() const;
     size_t size() const;
     size_t erase(const String16& key);
@@ -93,6 +108,8 @@ public:
     std::set<String16> getPersistableBundleKeys() const;
 
     friend bool operator==(const PersistableBundle& lhs, const PersistableBundle& rhs) {
+        lhs.unparcel();
+        rhs.unparcel();
         return (lhs.mBoolMap == rhs.mBoolMap && lhs.mIntMap == rhs.mIntMap &&
                 lhs.mLongMap == rhs.mLongMap && lhs.mDoubleMap == rhs.mDoubleMap &&
                 lhs.mStringMap == rhs.mStringMap && lhs.mBoolVectorMap == rhs.mBoolVectorMap &&
@@ -111,6 +128,20 @@ private:
     status_t writeToParcelInner(Parcel* parcel) const;
     status_t readFromParcelInner(const Parcel* parcel, size_t length);
 
+    /*
+     * Lazy-mode helpers; see readFromParcelLazy(). unparcel() materializes
+     * any lazily-held entries into the maps below and drops the raw region.
+     */
+    void unparcel() const;
+    status_t buildLazyIndex() const;
+    bool findLazyEntry(int32_t type, const String16& key, size_t* offset) const;
+
+    /* Raw bundle bytes ([magic][count][entries...]) held by lazy mode. */
+    mutable std::unique_ptr<Parcel> mLazyData;
+    /* Key -> (value type, offset of the value in mLazyData). */
+    mutable std::map<String16, std::pair<int32_t, size_t>> mLazyIndex;
+    mutable bool mLazyIndexBuilt = false;
+
     std::map<String16, bool> mBoolMap;
     std::map<String16, int32_t> mIntMap;
     std::map<String16, int64_t> mLongMap;
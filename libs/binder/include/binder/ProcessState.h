@@ -57,6 +57,34 @@ public:
 
     status_t setThreadPoolMaxThreadCount(size_t maxThreads);
     status_t enableOnewaySpamDetection(bool enable);
+
+    // Allows pooled binder threads to retire after sitting idle for
+    // timeoutMs. By default (0), a pooled thread parks in the driver forever
+    // once spawned, so its stack stays resident even if the process only
+    // needed that many threads for a short burst. A retired thread releases
+    // its looper slot in the driver on exit, so the driver requests a
+    // replacement (BR_SPAWN_LOOPER) if load returns. The pool never shrinks
+    // below kThreadPoolRetireFloor threads.
+    void setThreadPoolIdleTimeoutMs(int64_t timeoutMs);
+
+    struct ThreadPoolStats {
+        // Looper threads currently serving the pool.
+        size_t currentThreads;
+        // Pooled threads spawned since process start.
+        uint64_t threadsSpawned;
+        // Threads retired after the idle timeout.
+        uint64_t threadsRetired;
+        // Times the pool transitioned to having every thread busy.
+        uint64_t starvationEvents;
+    };
+    // Snapshot of the thread pool counters, for inclusion in service dumps.
+    ThreadPoolStats getThreadPoolStats();
+
+    // Enables process-wide recycling of Parcel data buffers through
+    // per-thread free lists bucketed by size class. Intended for services
+    // with very high transaction rates; recycled buffers are retained until
+    // their thread exits.
+    void setParcelBufferPoolEnabled(bool enable);
     void giveThreadPoolName();
 
     String8 getDriverName();
@@ -118,7 +146,27 @@ private:
         RefBase::weakref_type* refs;
     };
 
-    handle_entry* lookupHandleLocked(int32_t handle);
+    // The handle table is sharded by handle so that proxy lookups for
+    // different handles do not contend on a single process-wide mutex.
+    // Each shard's lock also serializes against BpBinder's destructor
+    // (through expungeHandle()), which keeps the attemptIncWeak() in
+    // getStrongProxyForHandle() safe.
+    static constexpr size_t kHandleTableShards = 16;
+    struct HandleTableShard {
+        mutable Mutex lock;
+        // Indexed by handle / kHandleTableShards.
+        Vector<handle_entry> handleToObject;
+    };
+
+    HandleTableShard& shardForHandle(int32_t handle);
+    handle_entry* lookupHandleLocked(HandleTableShard& shard, int32_t handle);
+
+    // Never retire below this many threads; a small floor absorbs bursts
+    // without putting a thread spawn on the critical path.
+    static constexpr size_t kThreadPoolRetireFloor = 2;
+
+    // Called by an idle pooled thread; returns whether it may leave the pool.
+    bool attemptThreadRetire();
 
     String8 mDriverName;
     int mDriverFD;
@@ -134,12 +182,20 @@ private:
     size_t mWaitingForThreads;
     // Maximum number for binder threads allowed for this process.
     size_t mMaxThreads;
+    // Number of looper threads currently in the pool.
+    size_t mCurrentThreads;
+    // Idle time after which a pooled thread retires; 0 disables retirement.
+    int64_t mThreadPoolIdleTimeoutMs;
     // Time when thread pool was emptied
     int64_t mStarvationStartTimeMs;
+    // Lifetime counters reported by getThreadPoolStats().
+    uint64_t mThreadsSpawned;
+    uint64_t mThreadsRetired;
+    uint64_t mStarvationEvents;
 
-    mutable Mutex mLock; // protects everything below.
+    HandleTableShard mHandleTableShards[kHandleTableShards];
 
-    Vector<handle_entry> mHandleToObject;
+    mutable Mutex mLock; // protects everything below.
 
     bool mForked;
     bool mThreadPoolStarted;
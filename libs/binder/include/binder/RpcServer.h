@@ -22,6 +22,8 @@
 #include <utils/Errors.h>
 #include <utils/RefBase.h>
 
+#include <chrono>
+#include <deque>
 #include <mutex>
 #include <thread>
 
@@ -106,6 +108,15 @@ public:
     void setMaxThreads(size_t threads);
     size_t getMaxThreads();
 
+    /**
+     * Bounds the pool of threads that perform connection handshakes for
+     * accepted sockets. Handshake threads are created on demand up to this
+     * limit and then reused, so a storm of incoming connections queues up
+     * behind the pool instead of spawning a thread per socket.
+     */
+    void setMaxConnectingThreads(size_t threads);
+    size_t getMaxConnectingThreads();
+
     /**
      * By default, the latest protocol version which is supported by a client is
      * used. However, this can be used in order to prevent newer protocol
@@ -168,6 +179,17 @@ public:
     std::vector<sp<RpcSession>> listSessions();
     size_t numUninitializedSessions();
 
+    /**
+     * Cumulative latency from accept4() to the connection being usable (handshake done and
+     * the connection handed to a session). For debugging!
+     */
+    struct AcceptLatencyStats {
+        uint64_t connections = 0;
+        uint64_t totalLatencyUs = 0;
+        uint64_t maxLatencyUs = 0;
+    };
+    AcceptLatencyStats getAcceptLatencyStats();
+
     ~RpcServer();
 
 private:
@@ -177,18 +199,38 @@ private:
     void onSessionAllIncomingThreadsEnded(const sp<RpcSession>& session) override;
     void onSessionIncomingThreadEnded() override;
 
-    static void establishConnection(sp<RpcServer>&& server, base::unique_fd clientFd,
-                                    const sockaddr_storage addr, socklen_t addrLen);
+    // An accepted socket waiting for a handshake thread to pick it up.
+    struct PendingConnection {
+        base::unique_fd fd;
+        sockaddr_storage addr;
+        socklen_t addrLen;
+        std::chrono::steady_clock::time_point acceptTime;
+    };
+
+    static void connectionSetupLoop(sp<RpcServer>&& server);
+    static void establishConnection(sp<RpcServer>&& server, PendingConnection&& pending);
+    static void joinSessionThread(sp<RpcServer>&& server, sp<RpcSession>&& session,
+                                  std::unique_ptr<RpcTransport> client);
     [[nodiscard]] status_t setupSocketServer(const RpcSocketAddress& address);
 
     const std::unique_ptr<RpcTransportCtx> mCtx;
     size_t mMaxThreads = 1;
+    size_t mMaxConnectingThreads = 4;
     std::optional<uint32_t> mProtocolVersion;
     base::unique_fd mServer; // socket we are accepting sessions on
 
     std::mutex mLock; // for below
     std::unique_ptr<std::thread> mJoinThread;
     bool mJoinThreadRunning = false;
+    // Bounded pool of handshake threads, fed through mPendingConnections. The threads are
+    // joined by join() when the shutdown trigger fires.
+    std::vector<std::thread> mConnectionSetupThreads;
+    size_t mIdleConnectionSetupThreads = 0;
+    std::deque<PendingConnection> mPendingConnections;
+    std::condition_variable mPendingConnectionCv;
+    AcceptLatencyStats mAcceptLatencyStats;
+    // Threads spawned for established connections, parked here only until the thread claims
+    // itself and hands its ownership to the session.
     std::map<std::thread::id, std::thread> mConnectingThreads;
     sp<IBinder> mRootObject;
     wp<IBinder> mRootObjectWeak;
@@ -240,7 +240,6 @@ private:
     [[nodiscard]] status_t setupClient(
             const std::function<status_t(const std::vector<uint8_t>& sessionId, bool incoming)>&
                     connectAndInit);
-    [[nodiscard]] status_t setupSocketClient(const RpcSocketAddress& address);
     [[nodiscard]] status_t setupOneSocketConnection(const RpcSocketAddress& address,
                                                     const std::vector<uint8_t>& sessionId,
                                                     bool incoming);
@@ -320,6 +319,12 @@ private:
 
     std::unique_ptr<RpcState> mRpcBinderState;
 
+    // Self-contained connector stored by setupClient so additional outgoing
+    // connections can be opened on demand (see ExclusiveConnection::find),
+    // rather than opening the maximum number of sockets up front. Set once
+    // during setup, then immutable.
+    std::function<status_t(const std::vector<uint8_t>& sessionId, bool incoming)> mConnectFunction;
+
     std::mutex mMutex; // for all below
 
     size_t mMaxIncomingThreads = 0;
@@ -333,6 +338,11 @@ private:
         // hint index into clients, ++ when sending an async transaction
         size_t mOutgoingOffset = 0;
         std::vector<sp<RpcConnection>> mOutgoing;
+        // negotiated limit on mOutgoing; connections beyond the first are
+        // opened lazily, when all existing ones are busy
+        size_t mMaxOutgoing = 0;
+        // number of outgoing connections currently being established
+        size_t mOutgoingPending = 0;
         size_t mMaxIncoming = 0;
         std::vector<sp<RpcConnection>> mIncoming;
         std::map<std::thread::id, std::thread> mThreads;
@@ -636,7 +636,7 @@ binder_status_t AIBinder_prepareTransaction(AIBinder* binder, AParcel** in) {
         return STATUS_INVALID_OPERATION;
     }
 
-    *in = new AParcel(binder);
+    *in = AParcel::obtain(binder);
     (*in)->get()->markForBinder(binder->getBinder());
 
     status_t status = android::OK;
@@ -646,7 +646,7 @@ binder_status_t AIBinder_prepareTransaction(AIBinder* binder, AParcel** in) {
     binder_status_t ret = PruneStatusT(status);
 
     if (ret != STATUS_OK) {
-        delete *in;
+        AParcel::recycle(*in);
         *in = nullptr;
     }
 
@@ -654,7 +654,7 @@ binder_status_t AIBinder_prepareTransaction(AIBinder* binder, AParcel** in) {
 }
 
 static void DestroyParcel(AParcel** parcel) {
-    delete *parcel;
+    AParcel::recycle(*parcel);
     *parcel = nullptr;
 }
 
@@ -692,13 +692,13 @@ binder_status_t AIBinder_transact(AIBinder* binder, transaction_code_t code, APa
         return STATUS_BAD_VALUE;
     }
 
-    *out = new AParcel(binder);
+    *out = AParcel::obtain(binder);
 
     status_t status = binder->getBinder()->transact(code, *(*in)->get(), (*out)->get(), flags);
     binder_status_t ret = PruneStatusT(status);
 
     if (ret != STATUS_OK) {
-        delete *out;
+        AParcel::recycle(*out);
         *out = nullptr;
     }
 
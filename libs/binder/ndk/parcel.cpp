@@ -22,6 +22,7 @@
 #include "status_internal.h"
 
 #include <limits>
+#include <vector>
 
 #include <android-base/logging.h>
 #include <android-base/unique_fd.h>
@@ -219,8 +220,56 @@ binder_status_t ReadArray(const AParcel* parcel, void* arrayData, ArrayAllocator
     return STATUS_OK;
 }
 
+namespace {
+
+// Transaction-rate NDK clients churn through an AParcel and Parcel per call, so keep a small
+// per-thread cache of retired parcels for reuse. The cache never holds parcel data: parcels are
+// stripped with freeData() before they are cached.
+constexpr size_t kMaxRecycledParcels = 4;
+
+struct ParcelCache {
+    std::vector<AParcel*> parcels;
+    ~ParcelCache() {
+        for (AParcel* parcel : parcels) {
+            delete parcel;
+        }
+    }
+};
+
+std::vector<AParcel*>& threadRecycledParcels() {
+    thread_local ParcelCache cache;
+    return cache.parcels;
+}
+
+} // namespace
+
+AParcel* AParcel::obtain(AIBinder* binder) {
+    std::vector<AParcel*>& parcels = threadRecycledParcels();
+    if (!parcels.empty()) {
+        AParcel* parcel = parcels.back();
+        parcels.pop_back();
+        parcel->mBinder = binder;
+        return parcel;
+    }
+    return new AParcel(binder);
+}
+
+void AParcel::recycle(AParcel* parcel) {
+    if (parcel == nullptr) {
+        return;
+    }
+    std::vector<AParcel*>& parcels = threadRecycledParcels();
+    if (!parcel->mOwns || parcels.size() >= kMaxRecycledParcels) {
+        delete parcel;
+        return;
+    }
+    parcel->mParcel->freeData();
+    parcel->mBinder = nullptr;
+    parcels.push_back(parcel);
+}
+
 void AParcel_delete(AParcel* parcel) {
-    delete parcel;
+    AParcel::recycle(parcel);
 }
 
 binder_status_t AParcel_setDataPosition(const AParcel* parcel, int32_t position) {
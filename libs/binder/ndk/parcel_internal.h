@@ -41,11 +41,21 @@ struct AParcel {
         return AParcel(binder, const_cast<::android::Parcel*>(parcel), false);
     }
 
+    // Returns a parcel for a transaction on binder, reusing one from the calling thread's
+    // recycling cache when possible so high-rate transaction paths don't allocate an AParcel
+    // and Parcel per call.
+    static AParcel* obtain(AIBinder* binder);
+
+    // Frees the parcel's data and returns it to the calling thread's recycling cache, or
+    // deletes it if the cache is full or the parcel doesn't own its data.
+    static void recycle(AParcel* parcel);
+
     const AIBinder* getBinder() { return mBinder; }
 
    private:
     // This object is associated with a calls to a specific AIBinder object. This is used for sanity
-    // checking to make sure that a parcel is one that is expected.
+    // checking to make sure that a parcel is one that is expected. Rebound by obtain() when a
+    // recycled parcel is reused for a new transaction.
     const AIBinder* mBinder;
 
     ::android::Parcel* mParcel;
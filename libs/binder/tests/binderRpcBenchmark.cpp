@@ -31,13 +31,18 @@
 #include <binder/RpcTransportTls.h>
 #include <openssl/ssl.h>
 
+#include <functional>
 #include <thread>
 
+#include <netinet/in.h>
 #include <signal.h>
 #include <sys/prctl.h>
+#include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "../vm_sockets.h" // for VMADDR_*
+
 using android::BBinder;
 using android::defaultServiceManager;
 using android::IBinder;
@@ -57,7 +62,6 @@ using android::RpcTransportCtxFactoryRaw;
 using android::RpcTransportCtxFactoryTls;
 using android::sp;
 using android::status_t;
-using android::statusToString;
 using android::String16;
 using android::binder::Status;
 
@@ -80,6 +84,8 @@ enum Transport {
     KERNEL,
     RPC,
     RPC_TLS,
+    RPC_VSOCK,
+    RPC_INET,
 };
 
 static const std::initializer_list<int64_t> kTransportList = {
@@ -88,8 +94,32 @@ static const std::initializer_list<int64_t> kTransportList = {
 #endif
         Transport::RPC,
         Transport::RPC_TLS,
+        Transport::RPC_VSOCK,
+        Transport::RPC_INET,
 };
 
+// Sized so the thread-segmented benchmarks below can saturate the session.
+constexpr size_t kMaxThreads = 8;
+
+constexpr unsigned int kVsockPort = 1234;
+constexpr const char* kLocalAddr = "127.0.0.1";
+
+// Reserve an ephemeral TCP port by binding to it and immediately releasing
+// it. Racey (someone else could grab it before the server does), okay.
+static unsigned int allocateLoopbackPort() {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    CHECK_GE(fd, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    CHECK_EQ(0, bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+    socklen_t len = sizeof(addr);
+    CHECK_EQ(0, getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len));
+    close(fd);
+    return ntohs(addr.sin_port);
+}
+
 std::unique_ptr<RpcTransportCtxFactory> makeFactoryTls() {
     auto pkey = android::makeKeyPairForSelfSignedCert();
     CHECK_NE(pkey.get(), nullptr);
@@ -105,11 +135,26 @@ static sp<RpcSession> gSession = RpcSession::make();
 // Certificate validation happens during handshake and does not affect the result of benchmarks.
 // Skip certificate validation to simplify the setup process.
 static sp<RpcSession> gSessionTls = RpcSession::make(makeFactoryTls());
+// These may remain unconnected when the environment lacks the endpoint
+// (e.g. no vsock support); affected benchmarks are skipped with an error.
+static sp<RpcSession> gSessionVsock = RpcSession::make();
+static sp<RpcSession> gSessionInet = RpcSession::make();
+static bool gVsockAvailable = false;
+static bool gInetAvailable = false;
 #ifdef __BIONIC__
 static const String16 kKernelBinderInstance = String16(u"binderRpcBenchmark-control");
 static sp<IBinder> gKernelBinder;
 #endif
 
+static sp<IBinder> getRootObjectOrSkip(benchmark::State& state, const sp<RpcSession>& session,
+                                       bool available, const char* what) {
+    if (!available) {
+        state.SkipWithError(what);
+        return nullptr;
+    }
+    return session->getRootObject();
+}
+
 static sp<IBinder> getBinderForOptions(benchmark::State& state) {
     Transport transport = static_cast<Transport>(state.range(0));
     switch (transport) {
@@ -121,6 +166,10 @@ static sp<IBinder> getBinderForOptions(benchmark::State& state) {
             return gSession->getRootObject();
         case RPC_TLS:
             return gSessionTls->getRootObject();
+        case RPC_VSOCK:
+            return getRootObjectOrSkip(state, gSessionVsock, gVsockAvailable, "vsock unavailable");
+        case RPC_INET:
+            return getRootObjectOrSkip(state, gSessionInet, gInetAvailable, "inet unavailable");
         default:
             LOG(FATAL) << "Unknown transport value: " << transport;
             return nullptr;
@@ -129,6 +178,7 @@ static sp<IBinder> getBinderForOptions(benchmark::State& state) {
 
 void BM_pingTransaction(benchmark::State& state) {
     sp<IBinder> binder = getBinderForOptions(state);
+    if (binder == nullptr) return; // skipped
 
     while (state.KeepRunning()) {
         CHECK_EQ(OK, binder->pingBinder());
@@ -138,6 +188,7 @@ BENCHMARK(BM_pingTransaction)->ArgsProduct({kTransportList});
 
 void BM_repeatTwoPageString(benchmark::State& state) {
     sp<IBinder> binder = getBinderForOptions(state);
+    if (binder == nullptr) return; // skipped
 
     sp<IBinderRpcBenchmark> iface = interface_cast<IBinderRpcBenchmark>(binder);
     CHECK(iface != nullptr);
@@ -167,6 +218,7 @@ BENCHMARK(BM_repeatTwoPageString)->ArgsProduct({kTransportList});
 
 void BM_throughputForTransportAndBytes(benchmark::State& state) {
     sp<IBinder> binder = getBinderForOptions(state);
+    if (binder == nullptr) return; // skipped
     sp<IBinderRpcBenchmark> iface = interface_cast<IBinderRpcBenchmark>(binder);
     CHECK(iface != nullptr);
 
@@ -187,7 +239,7 @@ BENCHMARK(BM_throughputForTransportAndBytes)
 
 void BM_repeatBinder(benchmark::State& state) {
     sp<IBinder> binder = getBinderForOptions(state);
-    CHECK(binder != nullptr);
+    if (binder == nullptr) return; // skipped
     sp<IBinderRpcBenchmark> iface = interface_cast<IBinderRpcBenchmark>(binder);
     CHECK(iface != nullptr);
 
@@ -202,24 +254,60 @@ void BM_repeatBinder(benchmark::State& state) {
 }
 BENCHMARK(BM_repeatBinder)->ArgsProduct({kTransportList});
 
-void forkRpcServer(const char* addr, const sp<RpcServer>& server) {
+// Throughput with a fixed-size payload, segmented by the number of client
+// threads issuing transactions concurrently. Sessions are configured with
+// kMaxThreads incoming/outgoing threads, so this measures how well each
+// transport scales until the session's thread limit is reached.
+void BM_throughputForTransportAndThreads(benchmark::State& state) {
+    sp<IBinder> binder = getBinderForOptions(state);
+    if (binder == nullptr) return; // skipped
+    sp<IBinderRpcBenchmark> iface = interface_cast<IBinderRpcBenchmark>(binder);
+    CHECK(iface != nullptr);
+
+    std::vector<uint8_t> bytes = std::vector<uint8_t>(getpagesize());
+    for (size_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = i % 256;
+    }
+
+    while (state.KeepRunning()) {
+        std::vector<uint8_t> out;
+        Status ret = iface->repeatBytes(bytes, &out);
+        CHECK(ret.isOk()) << ret;
+    }
+}
+BENCHMARK(BM_throughputForTransportAndThreads)
+        ->ArgsProduct({kTransportList})
+        ->ThreadRange(1, kMaxThreads);
+
+void forkRpcServer(const std::function<status_t(const sp<RpcServer>&)>& setup,
+                   const sp<RpcServer>& server) {
     if (0 == fork()) {
         prctl(PR_SET_PDEATHSIG, SIGHUP); // racey, okay
+        server->setMaxThreads(kMaxThreads);
         server->setRootObject(sp<MyBinderRpcBenchmark>::make());
-        CHECK_EQ(OK, server->setupUnixDomainServer(addr));
+        CHECK_EQ(OK, setup(server));
         server->join();
         exit(1);
     }
 }
 
-void setupClient(const sp<RpcSession>& session, const char* addr) {
+bool trySetupClient(const sp<RpcSession>& session,
+                    const std::function<status_t(const sp<RpcSession>&)>& setup) {
+    session->setMaxIncomingThreads(kMaxThreads);
+    session->setMaxOutgoingThreads(kMaxThreads);
     status_t status;
     for (size_t tries = 0; tries < 5; tries++) {
         usleep(10000);
-        status = session->setupUnixDomainClient(addr);
+        status = setup(session);
         if (status == OK) break;
     }
-    CHECK_EQ(status, OK) << "Could not connect: " << addr << ": " << statusToString(status).c_str();
+    return status == OK;
+}
+
+void setupClient(const sp<RpcSession>& session, const char* addr) {
+    CHECK(trySetupClient(session,
+                         [&](const sp<RpcSession>& s) { return s->setupUnixDomainClient(addr); }))
+            << "Could not connect: " << addr;
 }
 
 int main(int argc, char** argv) {
@@ -230,6 +318,8 @@ int main(int argc, char** argv) {
     std::cerr << "\t.../" << Transport::KERNEL << " is KERNEL" << std::endl;
     std::cerr << "\t.../" << Transport::RPC << " is RPC" << std::endl;
     std::cerr << "\t.../" << Transport::RPC_TLS << " is RPC with TLS" << std::endl;
+    std::cerr << "\t.../" << Transport::RPC_VSOCK << " is RPC over vsock" << std::endl;
+    std::cerr << "\t.../" << Transport::RPC_INET << " is RPC over inet" << std::endl;
 
 #ifdef __BIONIC__
     if (0 == fork()) {
@@ -252,14 +342,37 @@ int main(int argc, char** argv) {
 
     std::string addr = tmp + "/binderRpcBenchmark";
     (void)unlink(addr.c_str());
-    forkRpcServer(addr.c_str(), RpcServer::make(RpcTransportCtxFactoryRaw::make()));
+    forkRpcServer([&](const sp<RpcServer>& s) { return s->setupUnixDomainServer(addr.c_str()); },
+                  RpcServer::make(RpcTransportCtxFactoryRaw::make()));
     setupClient(gSession, addr.c_str());
 
     std::string tlsAddr = tmp + "/binderRpcTlsBenchmark";
     (void)unlink(tlsAddr.c_str());
-    forkRpcServer(tlsAddr.c_str(), RpcServer::make(makeFactoryTls()));
+    forkRpcServer([&](const sp<RpcServer>& s) { return s->setupUnixDomainServer(tlsAddr.c_str()); },
+                  RpcServer::make(makeFactoryTls()));
     setupClient(gSessionTls, tlsAddr.c_str());
 
+    forkRpcServer([](const sp<RpcServer>& s) { return s->setupVsockServer(kVsockPort); },
+                  RpcServer::make(RpcTransportCtxFactoryRaw::make()));
+    gVsockAvailable = trySetupClient(gSessionVsock, [](const sp<RpcSession>& s) {
+        return s->setupVsockClient(VMADDR_CID_LOCAL, kVsockPort);
+    });
+    if (!gVsockAvailable) {
+        std::cerr << "Could not connect over vsock; vsock benchmarks will be skipped" << std::endl;
+    }
+
+    // Bind to an ephemeral port up front so the forked server and the client
+    // agree on the port without extra IPC.
+    unsigned int inetPort = allocateLoopbackPort();
+    forkRpcServer([=](const sp<RpcServer>& s) { return s->setupInetServer(kLocalAddr, inetPort); },
+                  RpcServer::make(RpcTransportCtxFactoryRaw::make()));
+    gInetAvailable = trySetupClient(gSessionInet, [=](const sp<RpcSession>& s) {
+        return s->setupInetClient(kLocalAddr, inetPort);
+    });
+    if (!gInetAvailable) {
+        std::cerr << "Could not connect over inet; inet benchmarks will be skipped" << std::endl;
+    }
+
     ::benchmark::RunSpecifiedBenchmarks();
     return 0;
 }
@@ -19,8 +19,14 @@
 #include <android-base/strings.h>
 #include <binder/Binder.h>
 #include <sys/types.h>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <regex>
+#include <utility>
 
 #include <binderdebug/BinderDebug.h>
 
@@ -48,14 +54,20 @@ static status_t scanBinderContext(pid_t pid, const std::string& contextName,
             return -errno;
         }
     }
-    static const std::regex kContextLine("^context (\\w+)$");
+    static const std::string kContextPrefix = "context ";
 
     bool isDesiredContext = false;
+    bool wasDesiredContext = false;
     std::string line;
-    std::smatch match;
     while (getline(ifs, line)) {
-        if (std::regex_search(line, match, kContextLine)) {
-            isDesiredContext = match.str(1) == contextName;
+        if (base::StartsWith(line, kContextPrefix)) {
+            isDesiredContext = line.substr(kContextPrefix.size()) == contextName;
+            // Context sections are contiguous, so once we've streamed past the
+            // requested one there is nothing left in the file worth parsing.
+            if (!isDesiredContext && wasDesiredContext) {
+                break;
+            }
+            wasDesiredContext |= isDesiredContext;
             continue;
         }
         if (!isDesiredContext) {
@@ -66,16 +78,54 @@ static status_t scanBinderContext(pid_t pid, const std::string& contextName,
     return OK;
 }
 
+// The binderfs stats files are line oriented and a busy process section has
+// thousands of node/thread lines, so the hot parser below scans them directly
+// instead of paying for a std::regex match per line.
+
+static const char* skipSpaces(const char* p) {
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+// Matches "<keyword> <number>:" at p and returns the character following the
+// colon, or nullptr if the line doesn't start that way.
+static const char* matchNumberedKeyword(const char* p, const char* keyword) {
+    const size_t len = strlen(keyword);
+    if (strncmp(p, keyword, len) != 0 || p[len] != ' ') {
+        return nullptr;
+    }
+    p = skipSpaces(p + len);
+    if (!isdigit(*p)) {
+        return nullptr;
+    }
+    while (isdigit(*p)) p++;
+    if (*p != ':') {
+        return nullptr;
+    }
+    return p + 1;
+}
+
 status_t getBinderPidInfo(BinderDebugContext context, pid_t pid, BinderPidInfo* pidInfo) {
-    std::smatch match;
-    static const std::regex kReferencePrefix("^\\s*node \\d+:\\s+u([0-9a-f]+)\\s+c([0-9a-f]+)\\s+");
-    static const std::regex kThreadPrefix("^\\s*thread \\d+:\\s+l\\s+(\\d)(\\d)");
     std::string contextStr = contextToString(context);
     status_t ret = scanBinderContext(pid, contextStr, [&](const std::string& line) {
-        if (std::regex_search(line, match, kReferencePrefix)) {
-            const std::string& ptrString = "0x" + match.str(2); // use number after c
-            uint64_t ptr;
-            if (!::android::base::ParseUint(ptrString.c_str(), &ptr)) {
+        const char* p = skipSpaces(line.c_str());
+        if (const char* rest = matchNumberedKeyword(p, "node"); rest != nullptr) {
+            // "node <N>: u<hex> c<hex> ... proc <pid> <pid>..."
+            rest = skipSpaces(rest);
+            if (*rest != 'u') {
+                return;
+            }
+            char* end;
+            (void)strtoull(rest + 1, &end, 16); // skip the user-space pointer
+            if (end == rest + 1) {
+                return;
+            }
+            rest = skipSpaces(end);
+            if (*rest != 'c') {
+                return;
+            }
+            const uint64_t ptr = strtoull(rest + 1, &end, 16); // use number after c
+            if (end == rest + 1) {
                 // Should not reach here, but just be tolerant.
                 return;
             }
@@ -93,15 +143,24 @@ status_t getBinderPidInfo(BinderDebugContext context, pid_t pid, BinderPidInfo*
 
             return;
         }
-        if (std::regex_search(line, match, kThreadPrefix)) {
+        if (const char* rest = matchNumberedKeyword(p, "thread"); rest != nullptr) {
+            // "thread <N>: l <looper><thread> ..."
+            rest = skipSpaces(rest);
+            if (*rest != 'l') {
+                return;
+            }
+            rest = skipSpaces(rest + 1);
+            if (!isdigit(rest[0]) || !isdigit(rest[1])) {
+                return;
+            }
             // "1" is waiting in binder driver
             // "2" is poll. It's impossible to tell if these are in use.
             //     and HIDL default code doesn't use it.
-            bool isInUse = match.str(1) != "1";
+            bool isInUse = rest[0] != '1';
             // "0" is a thread that has called into binder
             // "1" is looper thread
             // "2" is main looper thread
-            bool isBinderThread = match.str(2) != "0";
+            bool isBinderThread = rest[1] != '0';
             if (!isBinderThread) {
                 return;
             }
@@ -117,6 +176,40 @@ status_t getBinderPidInfo(BinderDebugContext context, pid_t pid, BinderPidInfo*
     return ret;
 }
 
+status_t getBinderPidInfoCached(BinderDebugContext context, pid_t pid, BinderPidInfo* pidInfo,
+                                std::chrono::milliseconds maxStaleness) {
+    using Clock = std::chrono::steady_clock;
+    struct CacheEntry {
+        BinderPidInfo info;
+        Clock::time_point fetchedAt;
+    };
+    static std::mutex cacheLock;
+    static std::map<std::pair<int, pid_t>, CacheEntry> cache;
+
+    const auto key = std::make_pair(static_cast<int>(context), pid);
+    const auto now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock(cacheLock);
+        auto it = cache.find(key);
+        if (it != cache.end() && now - it->second.fetchedAt <= maxStaleness) {
+            *pidInfo = it->second.info;
+            return OK;
+        }
+    }
+    BinderPidInfo fresh = {};
+    status_t ret = getBinderPidInfo(context, pid, &fresh);
+    std::lock_guard<std::mutex> lock(cacheLock);
+    if (ret != OK) {
+        // Drop any stale entry so a vanished process doesn't keep serving
+        // old data once it comes back.
+        cache.erase(key);
+        return ret;
+    }
+    cache[key] = {fresh, now};
+    *pidInfo = std::move(fresh);
+    return OK;
+}
+
 status_t getBinderClientPids(BinderDebugContext context, pid_t pid, pid_t servicePid,
                              int32_t handle, std::vector<pid_t>* pids) {
     std::smatch match;
@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <vector>
 
@@ -36,6 +37,14 @@ enum class BinderDebugContext {
  * pid is the pid of the service
  */
 status_t getBinderPidInfo(BinderDebugContext context, pid_t pid, BinderPidInfo* pidInfo);
+/**
+ * Same as getBinderPidInfo, but may serve the result from a process-wide cache
+ * as long as the cached entry is no older than maxStaleness. Pass zero to force
+ * a fresh read. Intended for periodic pollers that query the same pids over and
+ * over and can tolerate slightly stale data.
+ */
+status_t getBinderPidInfoCached(BinderDebugContext context, pid_t pid, BinderPidInfo* pidInfo,
+                                std::chrono::milliseconds maxStaleness);
 /**
  * pid is typically the pid of this process that is making the query
  */
@@ -51,6 +51,22 @@ TEST(BinderDebugTests, BinderPid) {
     EXPECT_TRUE(!pidInfo.refPids.empty());
 }
 
+TEST(BinderDebugTests, BinderPidCached) {
+    BinderPidInfo pidInfo;
+    const auto& status = getBinderPidInfoCached(BinderDebugContext::BINDER, getpid(), &pidInfo,
+                                                std::chrono::milliseconds(1000));
+    ASSERT_EQ(status, OK);
+    // A second query inside the staleness window must be served from the cache
+    // and match the first result exactly.
+    BinderPidInfo cachedInfo;
+    const auto& cachedStatus = getBinderPidInfoCached(BinderDebugContext::BINDER, getpid(),
+                                                      &cachedInfo,
+                                                      std::chrono::milliseconds(1000));
+    ASSERT_EQ(cachedStatus, OK);
+    EXPECT_EQ(pidInfo.refPids, cachedInfo.refPids);
+    EXPECT_EQ(pidInfo.threadCount, cachedInfo.threadCount);
+}
+
 TEST(BinderDebugTests, BinderThreads) {
     BinderPidInfo pidInfo;
     const auto& status = getBinderPidInfo(BinderDebugContext::BINDER, getpid(), &pidInfo);
@@ -392,6 +392,75 @@ getUidsUpdatedCpuFreqTimes(uint64_t *lastUpdate) {
     return map;
 }
 
+// Retrieve the times in ns that each uid spent running at each CPU freq, excluding UIDs that have
+// not run since before lastUpdate, into flat output buffers that the caller can reuse across polls.
+// Returns false on error, true otherwise. On success *uids contains one entry per reported UID and
+// *times contains uids->size() rows of N entries each, where row r belongs to uids->at(r) and is
+// the concatenation of that UID's per-cluster frequency time lists, in the cluster and (ascending)
+// frequency order of getCpuFreqs(), so N is the total number of freqs across all clusters.
+// The buffers are cleared before use but keep their capacity, so a caller that polls periodically
+// (e.g. batterystats) pays no per-UID allocations in steady state, and the cost of each poll is
+// proportional to the number of UIDs that ran since *lastUpdate rather than the full map size.
+bool getUidsUpdatedCpuFreqTimesFlat(uint64_t *lastUpdate, std::vector<uint32_t> *uids,
+                                    std::vector<uint64_t> *times) {
+    if (!gInitialized && !initGlobals()) return false;
+    if (!uids || !times) return false;
+    uids->clear();
+    times->clear();
+
+    // Offset of each cluster's frequency time list within a flat row.
+    std::vector<uint32_t> policyOffsets(gNPolicies, 0);
+    uint32_t rowSize = 0;
+    for (uint32_t i = 0; i < gNPolicies; ++i) {
+        policyOffsets[i] = rowSize;
+        rowSize += gPolicyFreqs[i].size();
+    }
+
+    time_key_t key, prevKey;
+    if (getFirstMapKey(gTisMapFd, &key)) {
+        if (errno == ENOENT) return true;
+        return false;
+    }
+
+    // Buckets for a given UID are returned in arbitrary hash map order, so remember the row
+    // assigned to each UID already seen.
+    std::unordered_map<uint32_t, size_t> uidRows;
+
+    uint64_t newLastUpdate = lastUpdate ? *lastUpdate : 0;
+    std::vector<tis_val_t> vals(gNCpus);
+    do {
+        if (lastUpdate) {
+            auto uidUpdated = uidUpdatedSince(key.uid, *lastUpdate, &newLastUpdate);
+            if (!uidUpdated.has_value()) return false;
+            if (!*uidUpdated) continue;
+        }
+        if (findMapEntry(gTisMapFd, &key, vals.data())) return false;
+
+        auto row = uidRows.find(key.uid);
+        if (row == uidRows.end()) {
+            row = uidRows.emplace(key.uid, uids->size()).first;
+            uids->push_back(key.uid);
+            times->resize(times->size() + rowSize, 0);
+        }
+        uint64_t *rowBegin = times->data() + row->second * rowSize;
+
+        auto offset = key.bucket * FREQS_PER_ENTRY;
+        auto nextOffset = (key.bucket + 1) * FREQS_PER_ENTRY;
+        for (uint32_t i = 0; i < gNPolicies; ++i) {
+            if (offset >= gPolicyFreqs[i].size()) continue;
+            uint32_t count = std::min<uint32_t>(nextOffset, gPolicyFreqs[i].size()) - offset;
+            for (const auto &cpu : gPolicyCpus[i]) {
+                for (uint32_t j = 0; j < count; ++j) {
+                    rowBegin[policyOffsets[i] + offset + j] += vals[cpu].ar[j];
+                }
+            }
+        }
+    } while (prevKey = key, !getNextMapKey(gTisMapFd, &prevKey, &key));
+    if (errno != ENOENT) return false;
+    if (lastUpdate && newLastUpdate > *lastUpdate) *lastUpdate = newLastUpdate;
+    return true;
+}
+
 static bool verifyConcurrentTimes(const concurrent_time_t &ct) {
     uint64_t activeSum = std::accumulate(ct.active.begin(), ct.active.end(), (uint64_t)0);
     uint64_t policySum = 0;
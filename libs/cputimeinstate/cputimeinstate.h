@@ -30,6 +30,8 @@ std::optional<std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>>>
     getUidsCpuFreqTimes();
 std::optional<std::unordered_map<uint32_t, std::vector<std::vector<uint64_t>>>>
     getUidsUpdatedCpuFreqTimes(uint64_t *lastUpdate);
+bool getUidsUpdatedCpuFreqTimesFlat(uint64_t *lastUpdate, std::vector<uint32_t> *uids,
+                                    std::vector<uint64_t> *times);
 std::optional<std::vector<std::vector<uint32_t>>> getCpuFreqs();
 
 struct concurrent_time_t {
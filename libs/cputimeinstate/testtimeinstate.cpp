@@ -206,6 +206,40 @@ TEST_F(TimeInStateTest, AllUidUpdatedTimeInState) {
     }
 }
 
+TEST_F(TimeInStateTest, AllUidUpdatedTimeInStateFlat) {
+    uint64_t zero = 0;
+    std::vector<uint32_t> uids;
+    std::vector<uint64_t> times;
+    ASSERT_TRUE(getUidsUpdatedCpuFreqTimesFlat(&zero, &uids, &times));
+    ASSERT_FALSE(uids.empty());
+    ASSERT_NE(zero, (uint64_t)0);
+
+    auto freqs = getCpuFreqs();
+    ASSERT_TRUE(freqs.has_value());
+    size_t rowSize = 0;
+    for (const auto &freqList : *freqs) rowSize += freqList.size();
+    ASSERT_EQ(times.size(), uids.size() * rowSize);
+
+    // The flat rows must match the nested map format, modulo time passing between the reads.
+    auto map = getUidsCpuFreqTimes();
+    ASSERT_TRUE(map.has_value());
+    for (size_t i = 0; i < uids.size(); ++i) {
+        auto it = map->find(uids[i]);
+        ASSERT_NE(it, map->end());
+        uint64_t flatSum = 0, mapSum = 0;
+        size_t col = i * rowSize;
+        for (const auto &policyTimes : it->second) {
+            for (uint64_t time : policyTimes) {
+                // Times should never decrease
+                ASSERT_LE(times[col], time);
+                flatSum += times[col++];
+                mapSum += time;
+            }
+        }
+        ASSERT_LE(mapSum - flatSum, NSEC_PER_SEC);
+    }
+}
+
 TEST_F(TimeInStateTest, TotalAndAllUidTimeInStateConsistent) {
     auto allUid = getUidsCpuFreqTimes();
     auto total = getTotalCpuFreqTimes();
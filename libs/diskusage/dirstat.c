@@ -0,0 +1,216 @@
+/*
+ *
+ * Copyright (C) 2022, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <diskusage/dirstat.h>
+
+#define MAX_WORKERS 8
+#define DIRENT_BUF_SIZE 16384
+
+struct dir_work {
+    int fd;
+    struct dir_work *next;
+};
+
+/*
+ * Shared walker state. Subdirectories found by one worker are pushed onto the
+ * work list where any idle worker can pick them up, which balances the load
+ * across uneven trees. Each worker accumulates sizes locally and folds its
+ * total in under the lock when it exits.
+ */
+struct walk_state {
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;
+    struct dir_work *work_head;
+    int active_workers;
+    const volatile int *cancel;
+    int64_t total_size;
+};
+
+static int walk_cancelled(const struct walk_state *state)
+{
+    return state->cancel != NULL && *state->cancel != 0;
+}
+
+static void push_work(struct walk_state *state, struct dir_work *work)
+{
+    pthread_mutex_lock(&state->lock);
+    work->next = state->work_head;
+    state->work_head = work;
+    pthread_cond_signal(&state->work_available);
+    pthread_mutex_unlock(&state->lock);
+}
+
+/*
+ * Scans one directory with batched getdents64 calls and statx queries that
+ * only request the fields actually needed, closing dfd when done.
+ * Subdirectories are pushed onto the shared work list; if that fails they are
+ * scanned recursively so nothing is dropped.
+ */
+static void scan_dir(struct walk_state *state, int dfd, int64_t *size)
+{
+    char buf[DIRENT_BUF_SIZE];
+
+    for (;;) {
+        if (walk_cancelled(state))
+            break;
+
+        int nread = (int) syscall(__NR_getdents64, dfd, buf, sizeof(buf));
+        if (nread <= 0)
+            break;
+
+        for (int off = 0; off < nread;) {
+            struct dirent64 *de = (struct dirent64 *) (buf + off);
+            const char *name = de->d_name;
+            off += de->d_reclen;
+
+            /* always skip "." and ".." */
+            if (name[0] == '.') {
+                if (name[1] == 0)
+                    continue;
+                if ((name[1] == '.') && (name[2] == 0))
+                    continue;
+            }
+
+            unsigned int mask = STATX_BLOCKS;
+            if (de->d_type == DT_UNKNOWN)
+                mask |= STATX_TYPE;
+
+            struct statx stx;
+            if (statx(dfd, name, AT_SYMLINK_NOFOLLOW, mask, &stx) != 0)
+                continue;
+
+            *size += (int64_t) stx.stx_blocks * 512;
+
+            if (de->d_type == DT_DIR ||
+                    (de->d_type == DT_UNKNOWN && S_ISDIR(stx.stx_mode))) {
+                int subfd = openat(dfd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if (subfd < 0)
+                    continue;
+
+                struct dir_work *work = malloc(sizeof(*work));
+                if (work != NULL) {
+                    work->fd = subfd;
+                    push_work(state, work);
+                } else {
+                    scan_dir(state, subfd, size);
+                }
+            }
+        }
+    }
+    close(dfd);
+}
+
+static void *walk_worker(void *arg)
+{
+    struct walk_state *state = arg;
+    int64_t local_size = 0;
+
+    pthread_mutex_lock(&state->lock);
+    for (;;) {
+        if (walk_cancelled(state)) {
+            /* Drain pending work so every dfd is closed exactly once. */
+            while (state->work_head != NULL) {
+                struct dir_work *work = state->work_head;
+                state->work_head = work->next;
+                close(work->fd);
+                free(work);
+            }
+        }
+
+        if (state->work_head != NULL) {
+            struct dir_work *work = state->work_head;
+            state->work_head = work->next;
+            state->active_workers++;
+            pthread_mutex_unlock(&state->lock);
+
+            int fd = work->fd;
+            free(work);
+            scan_dir(state, fd, &local_size);
+
+            pthread_mutex_lock(&state->lock);
+            state->active_workers--;
+            if (state->work_head == NULL && state->active_workers == 0)
+                pthread_cond_broadcast(&state->work_available);
+        } else if (state->active_workers == 0) {
+            break;
+        } else {
+            pthread_cond_wait(&state->work_available, &state->lock);
+        }
+    }
+    state->total_size += local_size;
+    pthread_mutex_unlock(&state->lock);
+
+    return NULL;
+}
+
+int64_t calculate_dir_size_parallel(int dfd, int num_threads,
+        const volatile int *cancel)
+{
+    struct walk_state state;
+    pthread_t threads[MAX_WORKERS];
+
+    if (num_threads < 1)
+        num_threads = 1;
+    if (num_threads > MAX_WORKERS)
+        num_threads = MAX_WORKERS;
+
+    struct dir_work *work = malloc(sizeof(*work));
+    if (work == NULL) {
+        close(dfd);
+        return 0;
+    }
+    work->fd = dfd;
+    work->next = NULL;
+
+    pthread_mutex_init(&state.lock, NULL);
+    pthread_cond_init(&state.work_available, NULL);
+    state.work_head = work;
+    state.active_workers = 0;
+    state.cancel = cancel;
+    state.total_size = 0;
+
+    int started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (pthread_create(&threads[started], NULL, walk_worker, &state) == 0)
+            started++;
+    }
+
+    if (started == 0) {
+        /* Could not spawn any workers; walk on the calling thread instead. */
+        walk_worker(&state);
+    }
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&state.work_available);
+    pthread_mutex_destroy(&state.lock);
+
+    if (cancel != NULL && *cancel != 0)
+        return -1;
+
+    return state.total_size;
+}
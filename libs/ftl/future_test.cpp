@@ -18,7 +18,9 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <functional>
 #include <future>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
@@ -102,4 +104,54 @@ TEST(Future, Chain) {
   decrement_thread.join();
 }
 
+// Keep in sync with example usage in header file.
+TEST(Promise, Example) {
+  std::vector<std::function<void()>> tasks;
+  const auto executor = [&tasks](std::function<void()> task) { tasks.push_back(std::move(task)); };
+
+  int result = 0;
+  const auto consume = [&result](int x) { result = x; };
+
+  ftl::Promise<int> promise;
+
+  promise.get_future()
+      .then([](int x) { return x + 1; })
+      .then(executor, [&consume](int x) { consume(x); });
+
+  promise.set_value(99);  // consume(100) runs as a task posted to the executor.
+
+  EXPECT_EQ(result, 0);
+  ASSERT_EQ(tasks.size(), 1u);
+
+  tasks.front()();
+  EXPECT_EQ(result, 100);
+}
+
+TEST(Promise, ResolveBeforeThen) {
+  ftl::Promise<std::unique_ptr<char>> promise;
+  auto future = promise.get_future();
+  promise.set_value(std::make_unique<char>('!'));
+
+  // The value is already available, so the continuations run inline.
+  char c = '?';
+  std::move(future).then([](std::unique_ptr<char> ptr) { return *ptr; }).then([&c](char v) {
+    c = v;
+  });
+
+  EXPECT_EQ(c, '!');
+}
+
+TEST(Promise, ResolveOnOtherThread) {
+  ftl::Promise<std::string> promise;
+
+  std::string result;
+  promise.get_future().then([&result](std::string str) { result = std::move(str); });
+
+  // The continuation runs on the resolving thread.
+  std::thread thread([&promise] { promise.set_value("hello, world"); });
+  thread.join();
+
+  EXPECT_EQ(result, "hello, world");
+}
+
 }  // namespace android::test
@@ -19,6 +19,9 @@
 
 #include <cctype>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 using namespace std::string_literals;
 
@@ -409,4 +412,44 @@ TEST(SmallMap, KeyEqual) {
   EXPECT_EQ(map, SmallMap(ftl::init::map<int, char, KeyEqual>(1, '1')(2, '2')));
 }
 
+TEST(SmallMap, TransparentKeyEqual) {
+  SmallMap<std::string, int, 2, std::equal_to<>> map;
+
+  map.try_emplace("snake", 1);
+  map.try_emplace("camel", 2);
+
+  // Lookup does not construct a key, so the map can be probed with a string_view.
+  const std::string_view view("snake");
+
+  EXPECT_TRUE(map.contains(view));
+  EXPECT_NE(map.find(view), map.end());
+
+  EXPECT_EQ(map.get(view), 1);
+  EXPECT_EQ(map.get("camel", [](int& i) { return ++i; }), 3);
+
+  const auto& cmap = map;
+  EXPECT_EQ(cmap.get(view), 1);
+  EXPECT_EQ(cmap.find(view)->second, 1);
+}
+
+TEST(SmallMap, TryEmplaceBatch) {
+  SmallMap<int, std::string, 3> map = ftl::init::map<int, std::string>(42, "???");
+
+  const std::vector<std::pair<int, std::string>> batch = {
+      {123, "abc"}, {42, "!!!"}, {-1, ""}, {123, "dup"}};
+
+  // Pairs with duplicate keys, in the map or within the batch, are skipped.
+  EXPECT_EQ(map.try_emplace_batch(batch.begin(), batch.end()), 2u);
+  EXPECT_FALSE(map.dynamic());
+
+  EXPECT_EQ(map, SmallMap(ftl::init::map(-1, ""s)(42, "???"s)(123, "abc"s)));
+
+  // Emplacing past the static capacity promotes the map to dynamic storage.
+  const std::vector<std::pair<int, std::string>> rest = {{1, "a"}, {2, "b"}};
+
+  EXPECT_EQ(map.try_emplace_batch(rest.begin(), rest.end()), 2u);
+  EXPECT_TRUE(map.dynamic());
+  EXPECT_EQ(map.size(), 5u);
+}
+
 }  // namespace android::test
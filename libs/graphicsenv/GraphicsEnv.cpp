@@ -62,11 +62,6 @@ typedef bool (*fpANGLEFreeSystemInfoHandle)(void* handle);
 
 namespace android {
 
-enum NativeLibrary {
-    LLNDK = 0,
-    VNDKSP = 1,
-};
-
 static constexpr const char* kNativeLibrariesSystemConfigPath[] =
         {"/apex/com.android.vndk.v{}/etc/llndk.libraries.{}.txt",
          "/apex/com.android.vndk.v{}/etc/vndksp.libraries.{}.txt"};
@@ -107,7 +102,7 @@ static bool readConfig(const std::string& configFile, std::vector<std::string>*
     return true;
 }
 
-static const std::string getSystemNativeLibraries(NativeLibrary type) {
+/*static*/ std::string GraphicsEnv::getSystemNativeLibraries(NativeLibrary type) {
     std::string nativeLibrariesSystemConfig = kNativeLibrariesSystemConfigPath[type];
     insertVndkVersionStr(&nativeLibrariesSystemConfig);
 
@@ -275,11 +270,28 @@ bool GraphicsEnv::readyToSendGpuStatsLocked() {
     return mActivityLaunched && !mGpuStats.appPackageName.empty();
 }
 
+// Bounds the number of target stats buffered before the process is ready to
+// send; events past the limit are dropped, as they used to be before buffering.
+static constexpr size_t kMaxPendingTargetStats = 16;
+
 void GraphicsEnv::setTargetStats(const GpuStatsInfo::Stats stats, const uint64_t value) {
     ATRACE_CALL();
 
     std::lock_guard<std::mutex> lock(mStatsLock);
-    if (!readyToSendGpuStatsLocked()) return;
+    if (!readyToSendGpuStatsLocked()) {
+        // The app and driver identity are not known yet; buffer the event and
+        // flush the whole batch in one transaction once they are.
+        if (mPendingTargetStats.size() < kMaxPendingTargetStats) {
+            mPendingTargetStats.emplace_back(stats, value);
+        }
+        return;
+    }
+
+    if (!mPendingTargetStats.empty()) {
+        mPendingTargetStats.emplace_back(stats, value);
+        flushPendingTargetStatsLocked();
+        return;
+    }
 
     const sp<IGpuService> gpuService = getGpuService();
     if (gpuService) {
@@ -288,6 +300,25 @@ void GraphicsEnv::setTargetStats(const GpuStatsInfo::Stats stats, const uint64_t
     }
 }
 
+void GraphicsEnv::flushPendingTargetStatsLocked() {
+    if (mPendingTargetStats.empty()) return;
+
+    const sp<IGpuService> gpuService = getGpuService();
+    if (gpuService) {
+        std::vector<GpuStatsInfo::Stats> stats;
+        std::vector<uint64_t> values;
+        stats.reserve(mPendingTargetStats.size());
+        values.reserve(mPendingTargetStats.size());
+        for (const auto& [stat, value] : mPendingTargetStats) {
+            stats.push_back(stat);
+            values.push_back(value);
+        }
+        gpuService->setTargetStatsArray(mGpuStats.appPackageName, mGpuStats.driverVersionCode,
+                                        stats, values);
+    }
+    mPendingTargetStats.clear();
+}
+
 void GraphicsEnv::sendGpuStatsLocked(GpuStatsInfo::Api api, bool isDriverLoaded,
                                      int64_t driverLoadingTime) {
     ATRACE_CALL();
@@ -327,6 +358,10 @@ void GraphicsEnv::sendGpuStatsLocked(GpuStatsInfo::Api api, bool isDriverLoaded,
                                 mGpuStats.appPackageName, mGpuStats.vulkanVersion, driver,
                                 isIntendedDriverLoaded, driverLoadingTime);
     }
+
+    // Target stats that arrived before this process was ready to send can go
+    // out now that the app record exists on the service side.
+    flushPendingTargetStatsLocked();
 }
 
 bool GraphicsEnv::setInjectLayersPrSetDumpable() {
@@ -462,7 +497,12 @@ void GraphicsEnv::setDebugLayersGLES(const std::string layers) {
 // Return true if all the required libraries from vndk and sphal namespace are
 // linked to the updatable gfx driver namespace correctly.
 bool GraphicsEnv::linkDriverNamespaceLocked(android_namespace_t* vndkNamespace) {
-    const std::string llndkLibraries = getSystemNativeLibraries(NativeLibrary::LLNDK);
+    // Use the library lists from the GpuService snapshot when available; only
+    // fall back to reading the vndk apex config files from this process.
+    std::string llndkLibraries = mLlndkLibrariesSnapshot;
+    if (llndkLibraries.empty()) {
+        llndkLibraries = getSystemNativeLibraries(NativeLibrary::LLNDK);
+    }
     if (llndkLibraries.empty()) {
         return false;
     }
@@ -471,7 +511,10 @@ bool GraphicsEnv::linkDriverNamespaceLocked(android_namespace_t* vndkNamespace)
         return false;
     }
 
-    const std::string vndkspLibraries = getSystemNativeLibraries(NativeLibrary::VNDKSP);
+    std::string vndkspLibraries = mVndkspLibrariesSnapshot;
+    if (vndkspLibraries.empty()) {
+        vndkspLibraries = getSystemNativeLibraries(NativeLibrary::VNDKSP);
+    }
     if (vndkspLibraries.empty()) {
         return false;
     }
@@ -524,7 +567,18 @@ android_namespace_t* GraphicsEnv::getDriverNamespace() {
         if (!gpuService) {
             return nullptr;
         }
-        mDriverPath = gpuService->getUpdatableDriverPath();
+        // Prefer the single-transaction driver environment snapshot, which
+        // also carries the llndk/vndksp library lists so the namespace setup
+        // below doesn't have to probe the vndk apex config files. Older
+        // services only implement getUpdatableDriverPath.
+        std::string llndkLibraries, vndkspLibraries;
+        if (gpuService->getUpdatableDriverEnvironment(&mDriverPath, &llndkLibraries,
+                                                      &vndkspLibraries)) {
+            mLlndkLibrariesSnapshot = llndkLibraries;
+            mVndkspLibrariesSnapshot = vndkspLibraries;
+        } else {
+            mDriverPath = gpuService->getUpdatableDriverPath();
+        }
         if (mDriverPath.empty()) {
             return nullptr;
         }
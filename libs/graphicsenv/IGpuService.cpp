@@ -61,6 +61,24 @@ public:
         remote()->transact(BnGpuService::SET_TARGET_STATS, data, &reply, IBinder::FLAG_ONEWAY);
     }
 
+    void setTargetStatsArray(const std::string& appPackageName, const uint64_t driverVersionCode,
+                             const std::vector<GpuStatsInfo::Stats>& stats,
+                             const std::vector<uint64_t>& values) override {
+        Parcel data, reply;
+        data.writeInterfaceToken(IGpuService::getInterfaceDescriptor());
+
+        data.writeUtf8AsUtf16(appPackageName);
+        data.writeUint64(driverVersionCode);
+        data.writeUint32(static_cast<uint32_t>(stats.size()));
+        for (size_t i = 0; i < stats.size(); i++) {
+            data.writeInt32(static_cast<int32_t>(stats[i]));
+            data.writeUint64(values[i]);
+        }
+
+        remote()->transact(BnGpuService::SET_TARGET_STATS_ARRAY, data, &reply,
+                           IBinder::FLAG_ONEWAY);
+    }
+
     void setUpdatableDriverPath(const std::string& driverPath) override {
         Parcel data, reply;
         data.writeInterfaceToken(IGpuService::getInterfaceDescriptor());
@@ -81,6 +99,23 @@ public:
         }
         return driverPath;
     }
+
+    bool getUpdatableDriverEnvironment(std::string* outDriverPath, std::string* outLlndkLibraries,
+                                       std::string* outVndkspLibraries) override {
+        Parcel data, reply;
+        data.writeInterfaceToken(IGpuService::getInterfaceDescriptor());
+
+        status_t error = remote()->transact(BnGpuService::GET_UPDATABLE_DRIVER_ENVIRONMENT, data,
+                                            &reply);
+        if (error != OK) return false;
+
+        bool valid;
+        if (reply.readBool(&valid) != OK || !valid) return false;
+        if (reply.readUtf8FromUtf16(outDriverPath) != OK) return false;
+        if (reply.readUtf8FromUtf16(outLlndkLibraries) != OK) return false;
+        if (reply.readUtf8FromUtf16(outVndkspLibraries) != OK) return false;
+        return true;
+    }
 };
 
 IMPLEMENT_META_INTERFACE(GpuService, "android.graphicsenv.IGpuService");
@@ -147,6 +182,35 @@ status_t BnGpuService::onTransact(uint32_t code, const Parcel& data, Parcel* rep
 
             return OK;
         }
+        case SET_TARGET_STATS_ARRAY: {
+            CHECK_INTERFACE(IGpuService, data, reply);
+
+            std::string appPackageName;
+            if ((status = data.readUtf8FromUtf16(&appPackageName)) != OK) return status;
+
+            uint64_t driverVersionCode;
+            if ((status = data.readUint64(&driverVersionCode)) != OK) return status;
+
+            uint32_t count;
+            if ((status = data.readUint32(&count)) != OK) return status;
+
+            std::vector<GpuStatsInfo::Stats> stats;
+            std::vector<uint64_t> values;
+            for (uint32_t i = 0; i < count; i++) {
+                int32_t stat;
+                if ((status = data.readInt32(&stat)) != OK) return status;
+
+                uint64_t value;
+                if ((status = data.readUint64(&value)) != OK) return status;
+
+                stats.push_back(static_cast<GpuStatsInfo::Stats>(stat));
+                values.push_back(value);
+            }
+
+            setTargetStatsArray(appPackageName, driverVersionCode, stats, values);
+
+            return OK;
+        }
         case SET_UPDATABLE_DRIVER_PATH: {
             CHECK_INTERFACE(IGpuService, data, reply);
 
@@ -162,6 +226,19 @@ status_t BnGpuService::onTransact(uint32_t code, const Parcel& data, Parcel* rep
             std::string driverPath = getUpdatableDriverPath();
             return reply->writeUtf8AsUtf16(driverPath);
         }
+        case GET_UPDATABLE_DRIVER_ENVIRONMENT: {
+            CHECK_INTERFACE(IGpuService, data, reply);
+
+            std::string driverPath, llndkLibraries, vndkspLibraries;
+            const bool valid =
+                    getUpdatableDriverEnvironment(&driverPath, &llndkLibraries, &vndkspLibraries);
+            if ((status = reply->writeBool(valid)) != OK) return status;
+            if (!valid) return OK;
+
+            if ((status = reply->writeUtf8AsUtf16(driverPath)) != OK) return status;
+            if ((status = reply->writeUtf8AsUtf16(llndkLibraries)) != OK) return status;
+            return reply->writeUtf8AsUtf16(vndkspLibraries);
+        }
         case SHELL_COMMAND_TRANSACTION: {
             int in = data.readFileDescriptor();
             int out = data.readFileDescriptor();
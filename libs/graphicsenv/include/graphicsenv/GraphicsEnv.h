@@ -21,6 +21,7 @@
 
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 struct android_namespace_t;
@@ -31,8 +32,19 @@ struct NativeLoaderNamespace;
 
 class GraphicsEnv {
 public:
+    enum NativeLibrary {
+        LLNDK = 0,
+        VNDKSP = 1,
+    };
+
     static GraphicsEnv& getInstance();
 
+    // Read one of the system native library lists from the vndk apex config
+    // for this device. Returns a ':'-separated library list, or an empty
+    // string on failure. Also used by GpuService to build the driver
+    // environment snapshot it serves to launching processes.
+    static std::string getSystemNativeLibraries(NativeLibrary type);
+
     // Check if the process is debuggable. It returns false except in any of the
     // following circumstances:
     // 1. ANDROID_DEBUGGABLE is defined (global debuggable enabled).
@@ -136,6 +148,8 @@ private:
     bool readyToSendGpuStatsLocked();
     // Send the initial complete GpuStats to GpuService.
     void sendGpuStatsLocked(GpuStatsInfo::Api api, bool isDriverLoaded, int64_t driverLoadingTime);
+    // Send the buffered target stats to GpuService in one transaction.
+    void flushPendingTargetStatsLocked();
 
     GraphicsEnv() = default;
     // Path to updatable driver libs.
@@ -148,6 +162,9 @@ private:
     bool mActivityLaunched = false;
     // Information bookkept for GpuStats.
     GpuStatsInfo mGpuStats;
+    // Target stats received before this process is ready to send stats; they
+    // are flushed in one batch once it is.
+    std::vector<std::pair<GpuStatsInfo::Stats, uint64_t>> mPendingTargetStats;
     // Path to ANGLE libs.
     std::string mAnglePath;
     // This App's name.
@@ -166,6 +183,10 @@ private:
     std::string mLayerPaths;
     // This mutex protects the namespace creation.
     std::mutex mNamespaceMutex;
+    // Library lists received from the GpuService driver environment snapshot;
+    // when non-empty they replace the local vndk apex config file reads.
+    std::string mLlndkLibrariesSnapshot;
+    std::string mVndkspLibrariesSnapshot;
     // Updatable driver namespace.
     android_namespace_t* mDriverNamespace = nullptr;
     // ANGLE namespace.
@@ -43,9 +43,23 @@ public:
     virtual void setTargetStats(const std::string& appPackageName, const uint64_t driverVersionCode,
                                 const GpuStatsInfo::Stats stats, const uint64_t value = 0) = 0;
 
+    // set several target stats in one transaction; stats[i] pairs with values[i].
+    virtual void setTargetStatsArray(const std::string& appPackageName,
+                                     const uint64_t driverVersionCode,
+                                     const std::vector<GpuStatsInfo::Stats>& stats,
+                                     const std::vector<uint64_t>& values) = 0;
+
     // setter and getter for updatable driver path.
     virtual void setUpdatableDriverPath(const std::string& driverPath) = 0;
     virtual std::string getUpdatableDriverPath() = 0;
+
+    // get the updatable driver path together with the llndk and vndksp library
+    // lists needed to link the driver namespace, all cached service side so a
+    // launching process pays one transaction instead of per-launch config file
+    // reads. Returns false if no updatable driver is configured.
+    virtual bool getUpdatableDriverEnvironment(std::string* outDriverPath,
+                                               std::string* outLlndkLibraries,
+                                               std::string* outVndkspLibraries) = 0;
 };
 
 class BnGpuService : public BnInterface<IGpuService> {
@@ -55,6 +69,8 @@ public:
         SET_TARGET_STATS,
         SET_UPDATABLE_DRIVER_PATH,
         GET_UPDATABLE_DRIVER_PATH,
+        SET_TARGET_STATS_ARRAY,
+        GET_UPDATABLE_DRIVER_ENVIRONMENT,
         // Always append new enum to the end.
     };
 
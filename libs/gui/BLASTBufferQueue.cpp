@@ -432,9 +432,12 @@ void BLASTBufferQueue::releaseBufferCallbackLocked(
     const auto numPendingBuffersToHold =
             isEGL ? std::max(0u, mMaxAcquiredBuffers - mCurrentMaxAcquiredBufferCount) : 0;
 
-    auto rb = ReleasedBuffer{id, releaseFence};
-    if (std::find(mPendingRelease.begin(), mPendingRelease.end(), rb) == mPendingRelease.end()) {
-        mPendingRelease.emplace_back(rb);
+    if (auto stale = mPendingRelease.evictCollision(id)) {
+        BQA_LOGE("In-flight frames wrapped the pending release ring; releasing %s early",
+                 stale->callbackId.to_string().c_str());
+        releaseBuffer(stale->callbackId, stale->releaseFence);
+    }
+    if (mPendingRelease.insert(id, releaseFence)) {
         if (fakeRelease) {
             BQA_LOGE("Faking releaseBufferCallback from transactionCompleteCallback %" PRIu64,
                      id.framenumber);
@@ -444,8 +447,7 @@ void BLASTBufferQueue::releaseBufferCallbackLocked(
 
     // Release all buffers that are beyond the ones that we need to hold
     while (mPendingRelease.size() > numPendingBuffersToHold) {
-        const auto releasedBuffer = mPendingRelease.front();
-        mPendingRelease.pop_front();
+        const auto releasedBuffer = mPendingRelease.popOldest();
         releaseBuffer(releasedBuffer.callbackId, releasedBuffer.releaseFence);
         // Don't process the transactions here if mSyncedFrameNumbers is not empty. That means
         // are still transactions that have sync buffers in them that have not been applied or
@@ -907,6 +909,18 @@ status_t BLASTBufferQueue::setFrameRate(float frameRate, int8_t compatibility,
     return t.setFrameRate(mSurfaceControl, frameRate, compatibility, shouldBeSeamless).apply();
 }
 
+status_t BLASTBufferQueue::setMaxAcquiredBufferCountHint(int32_t maxAcquiredBuffers) {
+    std::unique_lock _lock{mMutex};
+    if (maxAcquiredBuffers <= mMaxAcquiredBuffers) {
+        return OK;
+    }
+    status_t status = mBufferItemConsumer->setMaxAcquiredBufferCount(maxAcquiredBuffers);
+    if (status == OK) {
+        mMaxAcquiredBuffers = maxAcquiredBuffers;
+    }
+    return status;
+}
+
 status_t BLASTBufferQueue::setFrameTimelineInfo(uint64_t frameNumber,
                                                 const FrameTimelineInfo& frameTimelineInfo) {
     ATRACE_FORMAT("%s(%s) frameNumber: %" PRIu64 " vsyncId: %" PRId64, __func__, mName.c_str(),
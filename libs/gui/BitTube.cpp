@@ -23,6 +23,8 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <vector>
+
 #include <utils/Errors.h>
 
 #include <binder/Parcel.h>
@@ -90,6 +92,23 @@ void BitTube::setSendFd(base::unique_fd&& sendFd) {
     mSendFd = std::move(sendFd);
 }
 
+ssize_t BitTube::setSendBufferSize(size_t size) {
+    if (mSendFd < 0) {
+        return -EBADF;
+    }
+    if (setsockopt(mSendFd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) < 0) {
+        const int error = errno;
+        ALOGE("BitTube::setSendBufferSize(%zu) failed (%s)", size, strerror(error));
+        return -error;
+    }
+    int effective = 0;
+    socklen_t len = sizeof(effective);
+    if (getsockopt(mSendFd, SOL_SOCKET, SO_SNDBUF, &effective, &len) < 0) {
+        return -errno;
+    }
+    return effective;
+}
+
 ssize_t BitTube::write(void const* vaddr, size_t size) {
     ssize_t err, len;
     do {
@@ -173,5 +192,63 @@ ssize_t BitTube::recvObjects(BitTube* tube, void* events, size_t count, size_t o
     return size < 0 ? size : size / static_cast<ssize_t>(objSize);
 }
 
+ssize_t BitTube::sendObjectsVectored(BitTube* tube, void const* events, size_t count,
+                                     size_t objSize) {
+    char* vaddr = const_cast<char*>(reinterpret_cast<const char*>(events));
+    std::vector<iovec> iovs(count);
+    std::vector<mmsghdr> msgs(count);
+    for (size_t i = 0; i < count; i++) {
+        iovs[i] = {vaddr + i * objSize, objSize};
+        msgs[i] = mmsghdr();
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent;
+    do {
+        sent = ::sendmmsg(tube->mSendFd, msgs.data(), static_cast<unsigned int>(count),
+                          MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    if (sent < 0) {
+        return -errno;
+    }
+    // a short count just means the send buffer filled up; the caller can retry the rest
+    return sent;
+}
+
+ssize_t BitTube::recvObjectsVectored(BitTube* tube, void* events, size_t count, size_t objSize) {
+    char* vaddr = reinterpret_cast<char*>(events);
+    std::vector<iovec> iovs(count);
+    std::vector<mmsghdr> msgs(count);
+    for (size_t i = 0; i < count; i++) {
+        iovs[i] = {vaddr + i * objSize, objSize};
+        msgs[i] = mmsghdr();
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int received;
+    do {
+        received = ::recvmmsg(tube->mReceiveFd, msgs.data(), static_cast<unsigned int>(count),
+                              MSG_DONTWAIT, nullptr);
+    } while (received < 0 && errno == EINTR);
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            // there was no data to be read; nothing the client should care about
+            return 0;
+        }
+        return -errno;
+    }
+
+    for (int i = 0; i < received; i++) {
+        // should never happen because of SOCK_SEQPACKET
+        LOG_ALWAYS_FATAL_IF(msgs[i].msg_len != objSize,
+                            "BitTube::recvObjectsVectored(count=%zu, size=%zu), message %d has "
+                            "size %u (one object per message expected!)",
+                            count, objSize, i, msgs[i].msg_len);
+    }
+    return received;
+}
+
 } // namespace gui
 } // namespace android
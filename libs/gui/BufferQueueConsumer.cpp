@@ -18,6 +18,8 @@
 #include <pwd.h>
 #include <sys/types.h>
 
+#include <utility>
+
 #define LOG_TAG "BufferQueueConsumer"
 #define ATRACE_TAG ATRACE_TAG_GRAPHICS
 //#define LOG_NDEBUG 0
@@ -262,7 +264,9 @@ status_t BufferQueueConsumer::acquireBuffer(BufferItem* outBuffer,
             return NO_BUFFER_AVAILABLE;
         } else {
             slot = front->mSlot;
-            *outBuffer = *front;
+            // The front item is erased below, so steal its contents rather
+            // than copying them.
+            *outBuffer = std::move(*front);
         }
 
         ATRACE_BUFFER_INDEX(slot);
@@ -292,11 +296,6 @@ status_t BufferQueueConsumer::acquireBuffer(BufferItem* outBuffer,
 
         mCore->mQueue.erase(front);
 
-        // We might have freed a slot while dropping old buffers, or the producer
-        // may be blocked waiting for the number of buffers in the queue to
-        // decrease.
-        mCore->mDequeueCondition.notify_all();
-
         ATRACE_INT(mCore->mConsumerName.string(),
                 static_cast<int32_t>(mCore->mQueue.size()));
 #ifndef NO_BINDER
@@ -305,6 +304,12 @@ status_t BufferQueueConsumer::acquireBuffer(BufferItem* outBuffer,
         VALIDATE_CONSISTENCY();
     }
 
+    // We might have freed a slot while dropping old buffers, or the producer
+    // may be blocked waiting for the number of buffers in the queue to
+    // decrease. Notify after dropping the lock so a producer blocked in
+    // dequeueBuffer wakes to an uncontended mutex.
+    mCore->mDequeueCondition.notify_all();
+
     if (listener != nullptr) {
         for (int i = 0; i < numDroppedBuffers; ++i) {
             listener->onBufferReleased();
@@ -495,10 +500,13 @@ status_t BufferQueueConsumer::releaseBuffer(int slot, uint64_t frameNumber,
         }
         BQ_LOGV("releaseBuffer: releasing slot %d", slot);
 
-        mCore->mDequeueCondition.notify_all();
         VALIDATE_CONSISTENCY();
     } // Autolock scope
 
+    // Notify after dropping the lock so a producer blocked in dequeueBuffer
+    // wakes to an uncontended mutex.
+    mCore->mDequeueCondition.notify_all();
+
     // Call back without lock held
     if (listener != nullptr) {
         listener->onBufferReleased();
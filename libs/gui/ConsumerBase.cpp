@@ -14,7 +14,10 @@
  * limitations under the License.
  */
 
+#include <errno.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
 
 #define LOG_TAG "ConsumerBase"
 #define ATRACE_TAG ATRACE_TAG_GRAPHICS
@@ -80,6 +83,13 @@ ConsumerBase::ConsumerBase(const sp<IGraphicBufferConsumer>& bufferQueue, bool c
 
 ConsumerBase::~ConsumerBase() {
     CB_LOGV("~ConsumerBase");
+
+    // The callback thread dereferences this object, so it must be joined
+    // before any members are torn down. This should already have happened in
+    // onLastStrongRef, but a derived class may have overridden that method
+    // without calling through to the ConsumerBase implementation.
+    stopCallbackThread();
+
     Mutex::Autolock lock(mMutex);
 
     // Verify that abandon() has been called before we get here.  This should
@@ -91,6 +101,7 @@ ConsumerBase::~ConsumerBase() {
 }
 
 void ConsumerBase::onLastStrongRef(const void* id __attribute__((unused))) {
+    stopCallbackThread();
     abandon();
 }
 
@@ -146,6 +157,10 @@ void ConsumerBase::onFrameDetached(const uint64_t bufferId) {
 void ConsumerBase::onFrameAvailable(const BufferItem& item) {
     CB_LOGV("onFrameAvailable");
 
+    if (dispatchOnCallbackThread(item, false /* replaced */)) {
+        return;
+    }
+
     sp<FrameAvailableListener> listener;
     { // scope for the lock
         Mutex::Autolock lock(mFrameAvailableMutex);
@@ -161,6 +176,10 @@ void ConsumerBase::onFrameAvailable(const BufferItem& item) {
 void ConsumerBase::onFrameReplaced(const BufferItem &item) {
     CB_LOGV("onFrameReplaced");
 
+    if (dispatchOnCallbackThread(item, true /* replaced */)) {
+        return;
+    }
+
     sp<FrameAvailableListener> listener;
     {
         Mutex::Autolock lock(mFrameAvailableMutex);
@@ -241,6 +260,115 @@ void ConsumerBase::setFrameAvailableListener(
     mFrameAvailableListener = listener;
 }
 
+status_t ConsumerBase::setCallbackThread(bool enabled, int32_t schedFifoPriority,
+                                         uint64_t cpuAffinityMask) {
+    CB_LOGV("setCallbackThread: enabled=%d priority=%d mask=%" PRIx64, int(enabled),
+            schedFifoPriority, cpuAffinityMask);
+
+    if (schedFifoPriority < 0 || schedFifoPriority > sched_get_priority_max(SCHED_FIFO)) {
+        return BAD_VALUE;
+    }
+
+    // Join any previous thread so that reconfiguring doesn't leave two threads
+    // draining the same queue.
+    stopCallbackThread();
+
+    if (!enabled) {
+        return NO_ERROR;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mCallbackThreadMutex);
+        mCallbackThreadRunning = true;
+    }
+    mCallbackThread = std::thread([this, schedFifoPriority, cpuAffinityMask]() {
+        callbackThreadLoop(schedFifoPriority, cpuAffinityMask);
+    });
+    return NO_ERROR;
+}
+
+void ConsumerBase::stopCallbackThread() {
+    {
+        std::lock_guard<std::mutex> lock(mCallbackThreadMutex);
+        if (!mCallbackThreadRunning) {
+            return;
+        }
+        mCallbackThreadRunning = false;
+    }
+    mCallbackThreadCondition.notify_all();
+    if (mCallbackThread.joinable()) {
+        mCallbackThread.join();
+    }
+}
+
+bool ConsumerBase::dispatchOnCallbackThread(const BufferItem& item, bool replaced) {
+    std::lock_guard<std::mutex> lock(mCallbackThreadMutex);
+    if (!mCallbackThreadRunning) {
+        return false;
+    }
+    mCallbackEvents.push_back({replaced, item});
+    mCallbackThreadCondition.notify_one();
+    return true;
+}
+
+void ConsumerBase::callbackThreadLoop(int32_t schedFifoPriority, uint64_t cpuAffinityMask) {
+    pthread_setname_np(pthread_self(), "ConsumerCallback");
+
+    if (schedFifoPriority > 0) {
+        struct sched_param param = {};
+        param.sched_priority = schedFifoPriority;
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            // Needs CAP_SYS_NICE; fall back to the default policy.
+            CB_LOGE("callbackThreadLoop: couldn't set SCHED_FIFO %d: %s", schedFifoPriority,
+                    strerror(errno));
+        }
+    }
+
+    if (cpuAffinityMask != 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+            if (cpuAffinityMask & (1ULL << cpu)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+            CB_LOGE("callbackThreadLoop: couldn't set affinity %" PRIx64 ": %s", cpuAffinityMask,
+                    strerror(errno));
+        }
+    }
+
+    while (true) {
+        CallbackEvent event;
+        {
+            std::unique_lock<std::mutex> lock(mCallbackThreadMutex);
+            mCallbackThreadCondition.wait(lock, [this] {
+                return !mCallbackEvents.empty() || !mCallbackThreadRunning;
+            });
+            if (mCallbackEvents.empty()) {
+                // The queue is drained even after a stop has been requested so
+                // that no already-delivered frame loses its notification.
+                return;
+            }
+            event = std::move(mCallbackEvents.front());
+            mCallbackEvents.pop_front();
+        }
+
+        sp<FrameAvailableListener> listener;
+        {
+            Mutex::Autolock lock(mFrameAvailableMutex);
+            listener = mFrameAvailableListener.promote();
+        }
+        if (listener != nullptr) {
+            if (event.replaced) {
+                listener->onFrameReplaced(event.item);
+            } else {
+                listener->onFrameAvailable(event.item);
+            }
+        }
+    }
+}
+
 status_t ConsumerBase::detachBuffer(int slot) {
     CB_LOGV("detachBuffer");
     Mutex::Autolock lock(mMutex);
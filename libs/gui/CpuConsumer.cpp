@@ -20,6 +20,8 @@
 
 #include <gui/CpuConsumer.h>
 
+#include <inttypes.h>
+
 #include <gui/BufferItem.h>
 #include <utils/Log.h>
 
@@ -32,9 +34,10 @@
 namespace android {
 
 CpuConsumer::CpuConsumer(const sp<IGraphicBufferConsumer>& bq,
-        size_t maxLockedBuffers, bool controlledByApp) :
+        size_t maxLockedBuffers, bool controlledByApp, bool persistentMapping) :
     ConsumerBase(bq, controlledByApp),
     mMaxLockedBuffers(maxLockedBuffers),
+    mPersistentMapping(persistentMapping),
     mCurrentLockedBuffers(0)
 {
     // Create tracking entries for locked buffers
@@ -44,6 +47,18 @@ CpuConsumer::CpuConsumer(const sp<IGraphicBufferConsumer>& bq,
     mConsumer->setMaxAcquiredBufferCount(static_cast<int32_t>(maxLockedBuffers));
 }
 
+CpuConsumer::~CpuConsumer() {
+    // Unlock any buffers that were kept mapped across acquire/release cycles.
+    Mutex::Autolock _l(mMutex);
+    for (auto& [id, cached] : mMappingCache) {
+        status_t err = cached.mGraphicBuffer->unlock();
+        if (err != OK) {
+            CC_LOGE("%s: Unable to unlock cached graphic buffer %" PRIu64, __FUNCTION__, id);
+        }
+    }
+    mMappingCache.clear();
+}
+
 size_t CpuConsumer::findAcquiredBufferLocked(uintptr_t id) const {
     for (size_t i = 0; i < mMaxLockedBuffers; i++) {
         const auto& ab = mAcquiredBuffers[i];
@@ -149,6 +164,39 @@ status_t CpuConsumer::lockBufferItem(const BufferItem& item, LockedBuffer* outBu
     return OK;
 }
 
+status_t CpuConsumer::lockBufferItemPersistent(const BufferItem& item, LockedBuffer* outBuffer) {
+    const uint64_t bufferId = item.mGraphicBuffer->getId();
+    const auto cached = mMappingCache.find(bufferId);
+    if (cached != mMappingCache.end()) {
+        // The buffer is still locked and mapped from a previous cycle, so the producer's new
+        // contents only require the acquire fence to have signaled; no gralloc calls are needed.
+        if (item.mFence != nullptr && item.mFence->isValid()) {
+            status_t err = item.mFence->waitForever("CpuConsumer::lockBufferItemPersistent");
+            if (err != OK) {
+                CC_LOGE("Failed to wait for fence of acquired buffer: %s (%d)",
+                        strerror(-err), err);
+                return err;
+            }
+        }
+
+        *outBuffer = cached->second.mMapping;
+        outBuffer->crop = item.mCrop;
+        outBuffer->transform = item.mTransform;
+        outBuffer->scalingMode = item.mScalingMode;
+        outBuffer->timestamp = item.mTimestamp;
+        outBuffer->dataSpace = item.mDataSpace;
+        outBuffer->frameNumber = item.mFrameNumber;
+        return OK;
+    }
+
+    status_t err = lockBufferItem(item, outBuffer);
+    if (err != OK) {
+        return err;
+    }
+    mMappingCache.emplace(bufferId, CachedMapping{item.mGraphicBuffer, *outBuffer});
+    return OK;
+}
+
 status_t CpuConsumer::lockNextBuffer(LockedBuffer *nativeBuffer) {
     status_t err;
 
@@ -177,7 +225,8 @@ status_t CpuConsumer::lockNextBuffer(LockedBuffer *nativeBuffer) {
         b.mGraphicBuffer = mSlots[b.mSlot].mGraphicBuffer;
     }
 
-    err = lockBufferItem(b, nativeBuffer);
+    err = mPersistentMapping ? lockBufferItemPersistent(b, nativeBuffer)
+                             : lockBufferItem(b, nativeBuffer);
     if (err != OK) {
         return err;
     }
@@ -209,12 +258,21 @@ status_t CpuConsumer::unlockBuffer(const LockedBuffer &nativeBuffer) {
 
     AcquiredBuffer& ab = mAcquiredBuffers.editItemAt(lockedIdx);
 
+    // In persistent mapping mode the buffer stays locked for the next acquisition, unless its
+    // mapping was evicted from the cache (because the producer freed the slot) while the user
+    // held it. CPU reads have completed by the time the user returns the buffer, so releasing
+    // without a fence is safe.
+    const bool keepMapped =
+        mPersistentMapping && mMappingCache.count(ab.mGraphicBuffer->getId()) > 0;
+
     int fenceFd = -1;
-    status_t err = ab.mGraphicBuffer->unlockAsync(&fenceFd);
-    if (err != OK) {
-        CC_LOGE("%s: Unable to unlock graphic buffer %zd", __FUNCTION__,
-                lockedIdx);
-        return err;
+    if (!keepMapped) {
+        status_t err = ab.mGraphicBuffer->unlockAsync(&fenceFd);
+        if (err != OK) {
+            CC_LOGE("%s: Unable to unlock graphic buffer %zd", __FUNCTION__,
+                    lockedIdx);
+            return err;
+        }
     }
 
     sp<Fence> fence(fenceFd >= 0 ? new Fence(fenceFd) : Fence::NO_FENCE);
@@ -228,4 +286,33 @@ status_t CpuConsumer::unlockBuffer(const LockedBuffer &nativeBuffer) {
     return OK;
 }
 
+void CpuConsumer::freeBufferLocked(int slotIndex) {
+    const sp<GraphicBuffer>& buffer = mSlots[slotIndex].mGraphicBuffer;
+    if (mPersistentMapping && buffer != nullptr) {
+        const auto cached = mMappingCache.find(buffer->getId());
+        if (cached != mMappingCache.end()) {
+            // If the user still holds the buffer, just evict the cache entry; unlockBuffer will
+            // see the eviction and unlock the buffer when it is returned. Otherwise unlock it now
+            // before the buffer goes away.
+            bool acquired = false;
+            for (size_t i = 0; i < mMaxLockedBuffers; i++) {
+                const sp<GraphicBuffer>& acquiredBuffer = mAcquiredBuffers[i].mGraphicBuffer;
+                if (acquiredBuffer != nullptr && acquiredBuffer->getId() == buffer->getId()) {
+                    acquired = true;
+                    break;
+                }
+            }
+            if (!acquired) {
+                status_t err = cached->second.mGraphicBuffer->unlock();
+                if (err != OK) {
+                    CC_LOGE("%s: Unable to unlock cached graphic buffer %" PRIu64, __FUNCTION__,
+                            buffer->getId());
+                }
+            }
+            mMappingCache.erase(cached);
+        }
+    }
+    ConsumerBase::freeBufferLocked(slotIndex);
+}
+
 } // namespace android
@@ -14,7 +14,11 @@
  * limitations under the License.
  */
 
+#include <errno.h>
 #include <string.h>
+#include <sys/mman.h>
+
+#include <binder/ParcelFileDescriptor.h>
 
 #include <utils/Errors.h>
 
@@ -25,6 +29,7 @@
 #include <private/gui/ComposerService.h>
 
 #include <private/gui/BitTube.h>
+#include <private/gui/VsyncEventMailbox.h>
 
 // ---------------------------------------------------------------------------
 
@@ -46,12 +51,29 @@ DisplayEventReceiver::DisplayEventReceiver(
                 mInitError = std::make_optional<status_t>(status.transactionError());
                 mDataChannel.reset();
                 mEventConnection.clear();
+            } else {
+                // The shared vsync mailbox is optional: servers that don't
+                // provide one leave the BitTube as the only event source.
+                os::ParcelFileDescriptor memory;
+                if (mEventConnection->getLatestVsyncEventMemory(&memory).isOk() &&
+                    memory.get() >= 0) {
+                    void* mapping = mmap(nullptr, sizeof(gui::VsyncEventMailbox), PROT_READ,
+                                         MAP_SHARED, memory.get(), 0);
+                    if (mapping != MAP_FAILED) {
+                        mMailbox = static_cast<const gui::VsyncEventMailbox*>(mapping);
+                    } else {
+                        ALOGW("Failed to map the vsync event mailbox: %s", strerror(errno));
+                    }
+                }
             }
         }
     }
 }
 
 DisplayEventReceiver::~DisplayEventReceiver() {
+    if (mMailbox != nullptr) {
+        munmap(const_cast<gui::VsyncEventMailbox*>(mMailbox), sizeof(gui::VsyncEventMailbox));
+    }
 }
 
 status_t DisplayEventReceiver::initCheck() const {
@@ -98,6 +120,10 @@ status_t DisplayEventReceiver::getLatestVsyncEventData(
     return NO_INIT;
 }
 
+bool DisplayEventReceiver::getLatestVsyncEventFromMailbox(Event* outEvent) const {
+    return mMailbox != nullptr && mMailbox->read(outEvent);
+}
+
 ssize_t DisplayEventReceiver::getEvents(DisplayEventReceiver::Event* events,
         size_t count) {
     return DisplayEventReceiver::getEvents(mDataChannel.get(), events, count);
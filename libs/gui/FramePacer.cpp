@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "FramePacer"
+
+#include <gui/FramePacer.h>
+
+#include <log/log.h>
+
+#include <algorithm>
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace android::gui {
+
+namespace {
+
+struct timespec nsToTimespec(nsecs_t ns) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    return ts;
+}
+
+} // namespace
+
+FramePacer::FramePacer() {
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    ALOGE_IF(mTimerFd < 0, "timerfd_create failed: %s", strerror(errno));
+}
+
+FramePacer::~FramePacer() {
+    if (mTimerFd >= 0) {
+        close(mTimerFd);
+    }
+}
+
+void FramePacer::onVsyncEvent(const VsyncEventData& vsyncEventData) {
+    Mutex::Autolock lock(mMutex);
+    mLastVsyncEventData = vsyncEventData;
+    mHaveVsyncEventData = true;
+}
+
+FramePacer::FrameTarget FramePacer::selectTimeline(const VsyncEventData& vsyncEventData,
+                                                   nsecs_t workDuration, nsecs_t now) {
+    constexpr size_t kLength = VsyncEventData::kFrameTimelinesLength;
+    size_t first = vsyncEventData.preferredFrameTimelineIndex;
+    if (first >= kLength) {
+        ALOGE("selectTimeline: Bad preferred index %zu.", first);
+        first = 0;
+    }
+
+    // The timelines are sorted, so the first one at or after the preferred
+    // entry whose deadline leaves room for the workload is the lowest-latency
+    // frame the workload can make. If none does, fall back to the last entry
+    // so the caller still gets a valid vsync id for the frame.
+    size_t chosen = kLength - 1;
+    for (size_t i = first; i < kLength; i++) {
+        if (vsyncEventData.frameTimelines[i].deadlineTimestamp >= now + workDuration) {
+            chosen = i;
+            break;
+        }
+    }
+
+    const VsyncEventData::FrameTimeline& timeline = vsyncEventData.frameTimelines[chosen];
+    FrameTarget target;
+    target.vsyncId = timeline.vsyncId;
+    target.deadlineTimestamp = timeline.deadlineTimestamp;
+    target.expectedPresentationTime = timeline.expectedPresentationTime;
+    target.startTime = std::max(now, timeline.deadlineTimestamp - workDuration);
+    return target;
+}
+
+FramePacer::FrameTarget FramePacer::selectTimeline(nsecs_t workDuration) const {
+    Mutex::Autolock lock(mMutex);
+    if (!mHaveVsyncEventData) {
+        ALOGE("selectTimeline: No vsync event received yet.");
+        return FrameTarget();
+    }
+    return selectTimeline(mLastVsyncEventData, workDuration, systemTime(SYSTEM_TIME_MONOTONIC));
+}
+
+status_t FramePacer::waitUntilStart(const FrameTarget& target) {
+    if (mTimerFd < 0) {
+        return NO_INIT;
+    }
+
+    const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    if (target.startTime <= now + kWakeupSlack) {
+        // Close enough to start immediately; don't bother with the timer.
+        return NO_ERROR;
+    }
+
+    // Reprogram the timer only if the armed expiry isn't already within the
+    // slack window, so back-to-back waits pacing to the same vsync share one
+    // timer programming.
+    if (mArmedWakeupTime < target.startTime - kWakeupSlack ||
+        mArmedWakeupTime > target.startTime) {
+        struct itimerspec spec;
+        spec.it_value = nsToTimespec(target.startTime);
+        spec.it_interval = {0, 0};
+        if (timerfd_settime(mTimerFd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+            ALOGE("timerfd_settime failed: %s", strerror(errno));
+            mArmedWakeupTime = 0;
+            return -errno;
+        }
+        mArmedWakeupTime = target.startTime;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = mTimerFd;
+    pfd.events = POLLIN;
+    int ret;
+    do {
+        ret = poll(&pfd, 1, -1);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        ALOGE("poll on timerfd failed: %s", strerror(errno));
+        return -errno;
+    }
+
+    uint64_t expirations;
+    ssize_t n;
+    do {
+        n = read(mTimerFd, &expirations, sizeof(expirations));
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        ALOGE("read on timerfd failed: %s", strerror(errno));
+        return -errno;
+    }
+
+    mArmedWakeupTime = 0;
+    return NO_ERROR;
+}
+
+} // namespace android::gui
@@ -269,8 +269,7 @@ void ProducerFrameEventHistory::updateAcquireFence(
     }
 }
 
-void ProducerFrameEventHistory::applyDelta(
-        const FrameEventHistoryDelta& delta) {
+void ProducerFrameEventHistory::applyDelta(FrameEventHistoryDelta&& delta) {
     mCompositorTiming = delta.mCompositorTiming;
 
     for (auto& d : delta.mDeltas) {
@@ -304,11 +303,12 @@ void ProducerFrameEventHistory::applyDelta(
         }
 
         applyFenceDelta(&mGpuCompositionDoneTimeline,
-                &frame.gpuCompositionDoneFence, d.mGpuCompositionDoneFence);
+                &frame.gpuCompositionDoneFence,
+                std::move(d.mGpuCompositionDoneFence));
         applyFenceDelta(&mPresentTimeline,
-                &frame.displayPresentFence, d.mDisplayPresentFence);
+                &frame.displayPresentFence, std::move(d.mDisplayPresentFence));
         applyFenceDelta(&mReleaseTimeline,
-                &frame.releaseFence, d.mReleaseFence);
+                &frame.releaseFence, std::move(d.mReleaseFence));
     }
 }
 
@@ -320,7 +320,7 @@ void ProducerFrameEventHistory::updateSignalTimes() {
 }
 
 void ProducerFrameEventHistory::applyFenceDelta(FenceTimeline* timeline,
-        std::shared_ptr<FenceTime>* dst, const FenceTime::Snapshot& src) const {
+        std::shared_ptr<FenceTime>* dst, FenceTime::Snapshot&& src) const {
     if (CC_UNLIKELY(dst == nullptr || dst->get() == nullptr)) {
         ALOGE("applyFenceDelta: dst is null.");
         return;
@@ -476,9 +476,22 @@ void ConsumerFrameEventHistory::getAndResetDelta(
     mProducerWantsEvents = true;
     delta->mCompositorTiming = mCompositorTiming;
 
+    // In the steady state there is nothing dirty, so don't touch the heap
+    // for the delta storage at all. Otherwise reserve exactly enough room
+    // for the dirty frames.
+    size_t dirtyCount = 0;
+    for (const auto& dirtyFields : mFramesDirty) {
+        if (dirtyFields.anyDirty()) {
+            dirtyCount++;
+        }
+    }
+    if (dirtyCount == 0) {
+        return;
+    }
+
     // Write these in order of frame number so that it is easy to
     // add them to a FenceTimeline in the proper order producer side.
-    delta->mDeltas.reserve(mFramesDirty.size());
+    delta->mDeltas.reserve(dirtyCount);
     auto earliestFrame = std::min_element(
             mFrames.begin(), mFrames.end(), &FrameNumberLessThan);
     for (auto frame = earliestFrame; frame != mFrames.end(); ++frame) {
@@ -331,15 +331,54 @@ status_t GLConsumer::acquireBufferLocked(BufferItem *item,
 
     // If item->mGraphicBuffer is not null, this buffer has not been acquired
     // before, so any prior EglImage created is using a stale buffer. This
-    // replaces any old EglImage with a new one (using the new buffer).
+    // replaces any old EglImage with one for the new buffer, which may be a
+    // cached image if the buffer has passed through this consumer before.
     if (item->mGraphicBuffer != nullptr) {
         int slot = item->mSlot;
-        mEglSlots[slot].mEglImage = new EglImage(item->mGraphicBuffer);
+        mEglSlots[slot].mEglImage = getEglImageLocked(item->mGraphicBuffer);
     }
 
     return NO_ERROR;
 }
 
+sp<GLConsumer::EglImage> GLConsumer::getEglImageLocked(const sp<GraphicBuffer>& graphicBuffer) {
+    const uint64_t bufferId = graphicBuffer->getId();
+    auto cached = mEglImageCache.find(bufferId);
+    if (cached != mEglImageCache.end()) {
+        mEglImageCacheHits++;
+        cached->second.lastUse = ++mEglImageCacheTicket;
+        return cached->second.image;
+    }
+
+    mEglImageCacheMisses++;
+    sp<EglImage> image = new EglImage(graphicBuffer);
+    if (mEglImageCacheCapacity > 0) {
+        while (mEglImageCache.size() >= mEglImageCacheCapacity) {
+            evictLeastRecentlyUsedEglImageLocked();
+        }
+        mEglImageCache.emplace(bufferId, CachedEglImage{image, ++mEglImageCacheTicket});
+    }
+    return image;
+}
+
+void GLConsumer::evictLeastRecentlyUsedEglImageLocked() {
+    auto lru = mEglImageCache.begin();
+    for (auto it = mEglImageCache.begin(); it != mEglImageCache.end(); ++it) {
+        if (it->second.lastUse < lru->second.lastUse) {
+            lru = it;
+        }
+    }
+    mEglImageCache.erase(lru);
+}
+
+void GLConsumer::setEglImageCacheCapacity(size_t capacity) {
+    Mutex::Autolock lock(mMutex);
+    mEglImageCacheCapacity = capacity;
+    while (mEglImageCache.size() > capacity) {
+        evictLeastRecentlyUsedEglImageLocked();
+    }
+}
+
 status_t GLConsumer::releaseBufferLocked(int buf,
         sp<GraphicBuffer> graphicBuffer,
         EGLDisplay display, EGLSyncKHR eglFence) {
@@ -914,6 +953,7 @@ void GLConsumer::freeBufferLocked(int slotIndex) {
 void GLConsumer::abandonLocked() {
     GLC_LOGV("abandonLocked");
     mCurrentTextureImage.clear();
+    mEglImageCache.clear();
     ConsumerBase::abandonLocked();
 }
 
@@ -925,10 +965,12 @@ void GLConsumer::dumpLocked(String8& result, const char* prefix) const
 {
     result.appendFormat(
        "%smTexName=%d mCurrentTexture=%d\n"
-       "%smCurrentCrop=[%d,%d,%d,%d] mCurrentTransform=%#x\n",
+       "%smCurrentCrop=[%d,%d,%d,%d] mCurrentTransform=%#x\n"
+       "%smEglImageCache: size=%zu capacity=%zu hits=%" PRIu64 " misses=%" PRIu64 "\n",
        prefix, mTexName, mCurrentTexture, prefix, mCurrentCrop.left,
        mCurrentCrop.top, mCurrentCrop.right, mCurrentCrop.bottom,
-       mCurrentTransform);
+       mCurrentTransform, prefix, mEglImageCache.size(), mEglImageCacheCapacity,
+       mEglImageCacheHits, mEglImageCacheMisses);
 
     ConsumerBase::dumpLocked(result, prefix);
 }
@@ -30,7 +30,8 @@ enum class Tag : uint32_t {
     ON_TRANSACTION_COMPLETED = IBinder::FIRST_CALL_TRANSACTION,
     ON_RELEASE_BUFFER,
     ON_TRANSACTION_QUEUE_STALLED,
-    LAST = ON_RELEASE_BUFFER,
+    ON_RELEASE_BUFFERS,
+    LAST = ON_RELEASE_BUFFERS,
 };
 
 } // Anonymous namespace
@@ -171,6 +172,30 @@ status_t SurfaceStats::readFromParcel(const Parcel* input) {
     return NO_ERROR;
 }
 
+status_t ReleaseBufferStats::writeToParcel(Parcel* output) const {
+    SAFE_PARCEL(output->writeParcelable, callbackId);
+    if (releaseFence) {
+        SAFE_PARCEL(output->writeBool, true);
+        SAFE_PARCEL(output->write, *releaseFence);
+    } else {
+        SAFE_PARCEL(output->writeBool, false);
+    }
+    SAFE_PARCEL(output->writeUint32, currentMaxAcquiredBufferCount);
+    return NO_ERROR;
+}
+
+status_t ReleaseBufferStats::readFromParcel(const Parcel* input) {
+    SAFE_PARCEL(input->readParcelable, &callbackId);
+    bool hasFence = false;
+    SAFE_PARCEL(input->readBool, &hasFence);
+    if (hasFence) {
+        releaseFence = new Fence();
+        SAFE_PARCEL(input->read, *releaseFence);
+    }
+    SAFE_PARCEL(input->readUint32, &currentMaxAcquiredBufferCount);
+    return NO_ERROR;
+}
+
 status_t TransactionStats::writeToParcel(Parcel* output) const {
     status_t err = output->writeParcelableVector(callbackIds);
     if (err != NO_ERROR) {
@@ -283,6 +308,12 @@ public:
         callRemoteAsync<decltype(&ITransactionCompletedListener::onTransactionQueueStalled)>(
             Tag::ON_TRANSACTION_QUEUE_STALLED);
     }
+
+    void onReleaseBuffers(std::vector<ReleaseBufferStats> releases) override {
+        callRemoteAsync<decltype(
+                &ITransactionCompletedListener::onReleaseBuffers)>(Tag::ON_RELEASE_BUFFERS,
+                                                                   releases);
+    }
 };
 
 // Out-of-line virtual method definitions to trigger vtable emission in this translation unit (see
@@ -306,6 +337,8 @@ status_t BnTransactionCompletedListener::onTransact(uint32_t code, const Parcel&
         case Tag::ON_TRANSACTION_QUEUE_STALLED:
             return callLocalAsync(data, reply,
                                   &ITransactionCompletedListener::onTransactionQueueStalled);
+        case Tag::ON_RELEASE_BUFFERS:
+            return callLocalAsync(data, reply, &ITransactionCompletedListener::onReleaseBuffers);
     }
 }
 
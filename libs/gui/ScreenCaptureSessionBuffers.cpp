@@ -0,0 +1,53 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gui/ScreenCaptureSessionBuffers.h>
+
+#include <private/gui/ParcelUtils.h>
+
+namespace android::gui {
+
+status_t ScreenCaptureSessionBuffers::writeToParcel(android::Parcel* parcel) const {
+    SAFE_PARCEL(parcel->writeUint32, static_cast<uint32_t>(buffers.size()));
+    for (const sp<GraphicBuffer>& buffer : buffers) {
+        if (buffer == nullptr) {
+            return BAD_VALUE;
+        }
+        SAFE_PARCEL(parcel->write, *buffer);
+    }
+    return NO_ERROR;
+}
+
+status_t ScreenCaptureSessionBuffers::readFromParcel(const android::Parcel* parcel) {
+    uint32_t count = 0;
+    SAFE_PARCEL(parcel->readUint32, &count);
+    // The count comes from an untrusted parcel, so bound it by the data
+    // actually present before reserving: each flattened buffer occupies at
+    // least one word, and anything claiming more than that is malformed.
+    if (count > parcel->dataAvail() / sizeof(uint32_t)) {
+        return BAD_VALUE;
+    }
+    buffers.clear();
+    buffers.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        sp<GraphicBuffer> buffer = new GraphicBuffer();
+        SAFE_PARCEL(parcel->read, *buffer);
+        buffers.emplace_back(std::move(buffer));
+    }
+    return NO_ERROR;
+}
+
+} // namespace android::gui
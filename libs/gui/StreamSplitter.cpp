@@ -33,6 +33,8 @@
 
 #include <system/window.h>
 
+#include <optional>
+
 namespace android {
 
 status_t StreamSplitter::createSplitter(
@@ -58,9 +60,22 @@ status_t StreamSplitter::createSplitter(
 
 StreamSplitter::StreamSplitter(const sp<IGraphicBufferConsumer>& inputQueue)
       : mIsAbandoned(false), mMutex(), mReleaseCondition(),
-        mOutstandingBuffers(0), mInput(inputQueue), mOutputs(), mBuffers() {}
+        mOutstandingBuffers(0), mInput(inputQueue), mOutputs(),
+        mOutputWorkers(), mBuffers() {}
 
 StreamSplitter::~StreamSplitter() {
+    // Stop the output workers before tearing down the queues they talk to
+    {
+        Mutex::Autolock lock(mMutex);
+        for (size_t i = 0; i < mOutputWorkers.size(); i++) {
+            mOutputWorkers[i]->requestExit();
+            mOutputWorkers[i]->signalExitLocked();
+        }
+    }
+    for (size_t i = 0; i < mOutputWorkers.size(); i++) {
+        mOutputWorkers[i]->join();
+    }
+
     mInput->consumerDisconnect();
     Vector<sp<IGraphicBufferProducer> >::iterator output = mOutputs.begin();
     for (; output != mOutputs.end(); ++output) {
@@ -93,6 +108,12 @@ status_t StreamSplitter::addOutput(
 
     mOutputs.push_back(outputQueue);
 
+    sp<OutputWorker> worker(new OutputWorker(this, outputQueue));
+    status = worker->run("OutputWorker");
+    LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
+            "starting worker for output failed (%d)", status);
+    mOutputWorkers.push_back(worker);
+
     return NO_ERROR;
 }
 
@@ -101,6 +122,23 @@ void StreamSplitter::setName(const String8 &name) {
     mInput->setConsumerName(name);
 }
 
+void StreamSplitter::waitForOutputs() {
+    Mutex::Autolock lock(mMutex);
+    bool busy = true;
+    while (busy) {
+        busy = false;
+        for (size_t i = 0; i < mOutputWorkers.size(); i++) {
+            if (!mOutputWorkers[i]->isIdleLocked()) {
+                busy = true;
+                break;
+            }
+        }
+        if (busy) {
+            mIdleCondition.wait(mMutex);
+        }
+    }
+}
+
 void StreamSplitter::onFrameAvailable(const BufferItem& /* item */) {
     ATRACE_CALL();
     Mutex::Autolock lock(mMutex);
@@ -148,42 +186,49 @@ void StreamSplitter::onFrameAvailable(const BufferItem& /* item */) {
             static_cast<int32_t>(bufferItem.mScalingMode),
             bufferItem.mTransform, bufferItem.mFence);
 
-    // Attach and queue the buffer to each of the outputs
-    Vector<sp<IGraphicBufferProducer> >::iterator output = mOutputs.begin();
-    for (; output != mOutputs.end(); ++output) {
-        int slot;
-        status = (*output)->attachBuffer(&slot, bufferItem.mGraphicBuffer);
-        if (status == NO_INIT) {
-            // If we just discovered that this output has been abandoned, note
-            // that, increment the release count so that we still release this
-            // buffer eventually, and move on to the next output
-            onAbandonedLocked();
-            mBuffers.editValueFor(bufferItem.mGraphicBuffer->getId())->
-                    incrementReleaseCountLocked();
-            continue;
-        } else {
-            LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
-                    "attaching buffer to output failed (%d)", status);
-        }
+    // Hand the buffer to each output's worker, which attach and queue it to
+    // their outputs in parallel. The workers only synchronize with each other
+    // again through the buffer's release tracking.
+    for (size_t i = 0; i < mOutputWorkers.size(); i++) {
+        mOutputWorkers[i]->queueBufferLocked(bufferItem.mGraphicBuffer, queueInput);
+    }
+}
 
-        IGraphicBufferProducer::QueueBufferOutput queueOutput;
-        status = (*output)->queueBuffer(slot, queueInput, &queueOutput);
-        if (status == NO_INIT) {
-            // If we just discovered that this output has been abandoned, note
-            // that, increment the release count so that we still release this
-            // buffer eventually, and move on to the next output
-            onAbandonedLocked();
-            mBuffers.editValueFor(bufferItem.mGraphicBuffer->getId())->
-                    incrementReleaseCountLocked();
-            continue;
-        } else {
-            LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
-                    "queueing buffer to output failed (%d)", status);
-        }
+void StreamSplitter::attachAndQueueBufferToOutput(
+        const sp<IGraphicBufferProducer>& output, const sp<GraphicBuffer>& buffer,
+        const IGraphicBufferProducer::QueueBufferInput& input) {
+    int slot;
+    status_t status = output->attachBuffer(&slot, buffer);
+    if (status == NO_INIT) {
+        // If we just discovered that this output has been abandoned, note
+        // that, and increment the release count so that we still release this
+        // buffer eventually
+        Mutex::Autolock lock(mMutex);
+        onAbandonedLocked();
+        markBufferReleasedLocked(buffer->getId());
+        return;
+    } else {
+        LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
+                "attaching buffer to output failed (%d)", status);
+    }
 
-        ALOGV("queued buffer %#" PRIx64 " to output %p",
-                bufferItem.mGraphicBuffer->getId(), output->get());
+    IGraphicBufferProducer::QueueBufferOutput queueOutput;
+    status = output->queueBuffer(slot, input, &queueOutput);
+    if (status == NO_INIT) {
+        // If we just discovered that this output has been abandoned, note
+        // that, and increment the release count so that we still release this
+        // buffer eventually
+        Mutex::Autolock lock(mMutex);
+        onAbandonedLocked();
+        markBufferReleasedLocked(buffer->getId());
+        return;
+    } else {
+        LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
+                "queueing buffer to output failed (%d)", status);
     }
+
+    ALOGV("queued buffer %#" PRIx64 " to output %p",
+            buffer->getId(), output.get());
 }
 
 void StreamSplitter::onBufferReleasedByOutput(
@@ -207,15 +252,19 @@ void StreamSplitter::onBufferReleasedByOutput(
     ALOGV("detached buffer %#" PRIx64 " from output %p",
           buffer->getId(), from.get());
 
-    const sp<BufferTracker>& tracker = mBuffers.editValueFor(buffer->getId());
-
     // Merge the release fence of the incoming buffer so that the fence we send
     // back to the input includes all of the outputs' fences
-    tracker->mergeFence(fence);
+    mBuffers.editValueFor(buffer->getId())->mergeFence(fence);
+
+    markBufferReleasedLocked(buffer->getId());
+}
+
+void StreamSplitter::markBufferReleasedLocked(uint64_t bufferId) {
+    const sp<BufferTracker>& tracker = mBuffers.editValueFor(bufferId);
 
     // Check to see if this is the last outstanding reference to this buffer
     size_t releaseCount = tracker->incrementReleaseCountLocked();
-    ALOGV("buffer %#" PRIx64 " reference count %zu (of %zu)", buffer->getId(),
+    ALOGV("buffer %#" PRIx64 " reference count %zu (of %zu)", bufferId,
             releaseCount, mOutputs.size());
     if (releaseCount < mOutputs.size()) {
         return;
@@ -224,13 +273,13 @@ void StreamSplitter::onBufferReleasedByOutput(
     // If we've been abandoned, we can't return the buffer to the input, so just
     // stop tracking it and move on
     if (mIsAbandoned) {
-        mBuffers.removeItem(buffer->getId());
+        mBuffers.removeItem(bufferId);
         return;
     }
 
     // Attach and release the buffer back to the input
     int consumerSlot;
-    status = mInput->attachBuffer(&consumerSlot, tracker->getBuffer());
+    status_t status = mInput->attachBuffer(&consumerSlot, tracker->getBuffer());
     LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
             "attaching buffer to input failed (%d)", status);
 
@@ -239,11 +288,11 @@ void StreamSplitter::onBufferReleasedByOutput(
     LOG_ALWAYS_FATAL_IF(status != NO_ERROR,
             "releasing buffer to input failed (%d)", status);
 
-    ALOGV("released buffer %#" PRIx64 " to input", buffer->getId());
+    ALOGV("released buffer %#" PRIx64 " to input", bufferId);
 
     // We no longer need to track the buffer once it has been returned to the
     // input
-    mBuffers.removeItem(buffer->getId());
+    mBuffers.removeItem(bufferId);
 
     // Notify any waiting onFrameAvailable calls
     --mOutstandingBuffers;
@@ -275,6 +324,51 @@ void StreamSplitter::OutputListener::binderDied(const wp<IBinder>& /* who */) {
     mSplitter->onAbandonedLocked();
 }
 
+StreamSplitter::OutputWorker::OutputWorker(StreamSplitter* splitter,
+        const sp<IGraphicBufferProducer>& output)
+      : mSplitter(splitter), mOutput(output) {}
+
+void StreamSplitter::OutputWorker::queueBufferLocked(const sp<GraphicBuffer>& buffer,
+        const IGraphicBufferProducer::QueueBufferInput& input) {
+    mPending.push_back(PendingBuffer{buffer, input});
+    mWorkCondition.signal();
+}
+
+void StreamSplitter::OutputWorker::signalExitLocked() {
+    mWorkCondition.signal();
+}
+
+bool StreamSplitter::OutputWorker::threadLoop() {
+    sp<GraphicBuffer> buffer;
+    std::optional<IGraphicBufferProducer::QueueBufferInput> input;
+    {
+        Mutex::Autolock lock(mSplitter->mMutex);
+        while (mPending.empty() && !exitPending()) {
+            mWorkCondition.wait(mSplitter->mMutex);
+        }
+        if (exitPending()) {
+            // Any still-pending buffers are dropped; the splitter is being
+            // destroyed, so the queues they would go to are going away too
+            return false;
+        }
+        buffer = mPending.front().buffer;
+        input.emplace(mPending.front().input);
+        mPending.pop_front();
+        mBusy = true;
+    }
+
+    // Do the actual attach/queue work with the splitter unlocked, so a slow
+    // output blocks neither the input nor its sibling outputs
+    mSplitter->attachAndQueueBufferToOutput(mOutput, buffer, *input);
+
+    {
+        Mutex::Autolock lock(mSplitter->mMutex);
+        mBusy = false;
+        mSplitter->mIdleCondition.broadcast();
+    }
+    return true;
+}
+
 StreamSplitter::BufferTracker::BufferTracker(const sp<GraphicBuffer>& buffer)
       : mBuffer(buffer), mMergedFence(Fence::NO_FENCE), mReleaseCount(0) {}
 
@@ -197,7 +197,7 @@ void Surface::enableFrameTimestamps(bool enable) {
     if (!mEnableFrameTimestamps && enable) {
         FrameEventHistoryDelta delta;
         mGraphicBufferProducer->getFrameTimestamps(&delta);
-        mFrameEventHistory->applyDelta(delta);
+        mFrameEventHistory->applyDelta(std::move(delta));
     }
     mEnableFrameTimestamps = enable;
 }
@@ -316,7 +316,7 @@ status_t Surface::getFrameTimestamps(uint64_t frameNumber,
             outDequeueReadyTime, outReleaseTime)) {
         FrameEventHistoryDelta delta;
         mGraphicBufferProducer->getFrameTimestamps(&delta);
-        mFrameEventHistory->applyDelta(delta);
+        mFrameEventHistory->applyDelta(std::move(delta));
         events = mFrameEventHistory->getFrame(frameNumber);
     }
 
@@ -702,7 +702,7 @@ int Surface::dequeueBuffer(android_native_buffer_t** buffer, int* fenceFd) {
     }
 
     if (dqInput.getTimestamps) {
-         mFrameEventHistory->applyDelta(frameTimestamps);
+         mFrameEventHistory->applyDelta(std::move(frameTimestamps));
     }
 
     if ((result & IGraphicBufferProducer::BUFFER_NEEDS_REALLOCATION) || gbuf == nullptr) {
@@ -883,7 +883,7 @@ int Surface::dequeueBuffers(std::vector<BatchBuffer>* buffers) {
     }
 
     for (size_t batchIdx = 0; batchIdx < numBufferRequested; batchIdx++) {
-        const auto& output = dequeueOutput[batchIdx];
+        auto& output = dequeueOutput[batchIdx];
         int slot = output.slot;
         sp<GraphicBuffer>& gbuf(mSlots[slot].buffer);
 
@@ -893,7 +893,7 @@ int Surface::dequeueBuffers(std::vector<BatchBuffer>* buffers) {
         }
 
         if (input.getTimestamps) {
-             mFrameEventHistory->applyDelta(output.timestamps.value());
+             mFrameEventHistory->applyDelta(std::move(output.timestamps.value()));
         }
 
         if (output.fence->isValid()) {
@@ -1113,11 +1113,11 @@ void Surface::applyGrallocMetadataLocked(
 }
 
 void Surface::onBufferQueuedLocked(int slot, sp<Fence> fence,
-        const IGraphicBufferProducer::QueueBufferOutput& output) {
+        IGraphicBufferProducer::QueueBufferOutput& output) {
     mDequeuedSlots.erase(slot);
 
     if (mEnableFrameTimestamps) {
-        mFrameEventHistory->applyDelta(output.frameTimestamps);
+        mFrameEventHistory->applyDelta(std::move(output.frameTimestamps));
         // Update timestamps with the local acquire fence.
         // The consumer doesn't send it back to prevent us from having two
         // file descriptors of the same fence.
@@ -1227,6 +1227,7 @@ int Surface::queueBuffers(const std::vector<BatchQueuedBuffer>& buffers) {
         getQueueBufferInputLocked(
                 buffers[batchIdx].buffer, buffers[batchIdx].fenceFd, buffers[batchIdx].timestamp,
                 &input);
+        input.slot = i;
         bufferFences[batchIdx] = input.fence;
         queueBufferInputs[batchIdx] = input;
     }
@@ -1236,10 +1237,15 @@ int Surface::queueBuffers(const std::vector<BatchQueuedBuffer>& buffers) {
     mLastQueueDuration = systemTime() - now;
     if (err != OK)  {
         ALOGE("%s: error queuing buffer, %d", __FUNCTION__, err);
+        return err;
     }
 
-
     for (size_t batchIdx = 0; batchIdx < numBuffers; batchIdx++) {
+        if (queueBufferOutputs[batchIdx].result != NO_ERROR) {
+            ALOGE("%s: error queuing buffer %zu, %d", __FUNCTION__, batchIdx,
+                  queueBufferOutputs[batchIdx].result);
+            continue;
+        }
         onBufferQueuedLocked(bufferSlots[batchIdx], bufferFences[batchIdx],
                 queueBufferOutputs[batchIdx]);
     }
@@ -1520,6 +1526,9 @@ int Surface::perform(int operation, va_list args)
     case NATIVE_WINDOW_SET_FRAME_TIMELINE_INFO:
         res = dispatchSetFrameTimelineInfo(args);
         break;
+    case NATIVE_WINDOW_SET_BUFFERS_BATCH:
+        res = dispatchSetBuffersBatch(args);
+        break;
     default:
         res = NAME_NOT_FOUND;
         break;
@@ -1627,6 +1636,11 @@ int Surface::dispatchSetBuffersDataSpace(va_list args) {
     return setBuffersDataSpace(dataspace);
 }
 
+int Surface::dispatchSetBuffersBatch(va_list args) {
+    const ANativeWindowBuffersBatch* batch = va_arg(args, const ANativeWindowBuffersBatch*);
+    return setBuffersBatch(batch);
+}
+
 int Surface::dispatchSetBuffersSmpte2086Metadata(va_list args) {
     const android_smpte2086_metadata* metadata =
         va_arg(args, const android_smpte2086_metadata*);
@@ -2247,6 +2261,88 @@ int Surface::setBuffersDataSpace(Dataspace dataSpace)
     return NO_ERROR;
 }
 
+int Surface::setBuffersBatch(const ANativeWindowBuffersBatch* batch)
+{
+    ATRACE_CALL();
+    ALOGV("Surface::setBuffersBatch");
+
+    if (batch == nullptr) {
+        return BAD_VALUE;
+    }
+
+    constexpr uint32_t kKnownProperties = NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS |
+            NATIVE_WINDOW_BATCH_PROPERTY_USER_DIMENSIONS | NATIVE_WINDOW_BATCH_PROPERTY_FORMAT |
+            NATIVE_WINDOW_BATCH_PROPERTY_USAGE | NATIVE_WINDOW_BATCH_PROPERTY_DATASPACE |
+            NATIVE_WINDOW_BATCH_PROPERTY_SCALING_MODE;
+    if (batch->propertyMask & ~kKnownProperties) {
+        return BAD_VALUE;
+    }
+
+    // Validate everything before applying anything, so a rejected batch has no effect.
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS) {
+        if ((batch->width && !batch->height) || (!batch->width && batch->height)) {
+            return BAD_VALUE;
+        }
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_USER_DIMENSIONS) {
+        if ((batch->userWidth && !batch->userHeight) ||
+                (!batch->userWidth && batch->userHeight)) {
+            return BAD_VALUE;
+        }
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_SCALING_MODE) {
+        switch (batch->scalingMode) {
+            case NATIVE_WINDOW_SCALING_MODE_FREEZE:
+            case NATIVE_WINDOW_SCALING_MODE_SCALE_TO_WINDOW:
+            case NATIVE_WINDOW_SCALING_MODE_SCALE_CROP:
+            case NATIVE_WINDOW_SCALING_MODE_NO_SCALE_CROP:
+                break;
+            default:
+                ALOGE("unknown scaling mode: %d", batch->scalingMode);
+                return BAD_VALUE;
+        }
+    }
+
+    Mutex::Autolock lock(mMutex);
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS) {
+        uint32_t width = static_cast<uint32_t>(batch->width);
+        uint32_t height = static_cast<uint32_t>(batch->height);
+        if (width != mReqWidth || height != mReqHeight) {
+            mSharedBufferSlot = BufferItem::INVALID_BUFFER_SLOT;
+        }
+        mReqWidth = width;
+        mReqHeight = height;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_USER_DIMENSIONS) {
+        uint32_t width = static_cast<uint32_t>(batch->userWidth);
+        uint32_t height = static_cast<uint32_t>(batch->userHeight);
+        if (width != mUserWidth || height != mUserHeight) {
+            mSharedBufferSlot = BufferItem::INVALID_BUFFER_SLOT;
+        }
+        mUserWidth = width;
+        mUserHeight = height;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_FORMAT) {
+        if (batch->format != mReqFormat) {
+            mSharedBufferSlot = BufferItem::INVALID_BUFFER_SLOT;
+        }
+        mReqFormat = batch->format;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_USAGE) {
+        if (batch->usage != mReqUsage) {
+            mSharedBufferSlot = BufferItem::INVALID_BUFFER_SLOT;
+        }
+        mReqUsage = batch->usage;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_DATASPACE) {
+        mDataSpace = static_cast<Dataspace>(batch->dataSpace);
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_SCALING_MODE) {
+        mScalingMode = batch->scalingMode;
+    }
+    return NO_ERROR;
+}
+
 int Surface::setBuffersSmpte2086Metadata(const android_smpte2086_metadata* metadata) {
     ALOGV("Surface::setBuffersSmpte2086Metadata");
     Mutex::Autolock lock(mMutex);
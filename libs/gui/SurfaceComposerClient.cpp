@@ -490,6 +490,30 @@ void TransactionCompletedListener::onReleaseBuffer(ReleaseCallbackId callbackId,
     callback(callbackId, releaseFence, optionalMaxAcquiredBufferCount);
 }
 
+void TransactionCompletedListener::onReleaseBuffers(std::vector<ReleaseBufferStats> releases) {
+    // Pop all the callbacks under one lock acquisition, then invoke them outside the lock.
+    std::vector<ReleaseBufferCallback> callbacks(releases.size());
+    {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        for (size_t i = 0; i < releases.size(); i++) {
+            callbacks[i] = popReleaseBufferCallbackLocked(releases[i].callbackId);
+        }
+    }
+    for (size_t i = 0; i < releases.size(); i++) {
+        const auto& release = releases[i];
+        if (!callbacks[i]) {
+            ALOGE("Could not call release buffer callback, buffer not found %s",
+                  release.callbackId.to_string().c_str());
+            continue;
+        }
+        std::optional<uint32_t> optionalMaxAcquiredBufferCount =
+                release.currentMaxAcquiredBufferCount == UINT_MAX
+                ? std::nullopt
+                : std::make_optional<uint32_t>(release.currentMaxAcquiredBufferCount);
+        callbacks[i](release.callbackId, release.releaseFence, optionalMaxAcquiredBufferCount);
+    }
+}
+
 ReleaseBufferCallback TransactionCompletedListener::popReleaseBufferCallbackLocked(
         const ReleaseCallbackId& callbackId) {
     ReleaseBufferCallback callback;
@@ -642,7 +666,7 @@ SurfaceComposerClient::Transaction::Transaction(const Transaction& other)
 }
 
 void SurfaceComposerClient::Transaction::sanitize() {
-    for (auto & [handle, composerState] : mComposerStates) {
+    for (auto & [layerId, composerState] : mComposerStates) {
         composerState.state.sanitize(0 /* permissionMask */);
     }
     mInputWindowCommands.clear();
@@ -719,17 +743,14 @@ status_t SurfaceComposerClient::Transaction::readFromParcel(const Parcel* parcel
     if (count > parcel->dataSize()) {
         return BAD_VALUE;
     }
-    std::unordered_map<sp<IBinder>, ComposerState, IBinderHash> composerStates;
+    std::unordered_map<int32_t, ComposerState> composerStates;
     composerStates.reserve(count);
     for (size_t i = 0; i < count; i++) {
-        sp<IBinder> surfaceControlHandle;
-        SAFE_PARCEL(parcel->readStrongBinder, &surfaceControlHandle);
-
         ComposerState composerState;
         if (composerState.read(*parcel) == BAD_VALUE) {
             return BAD_VALUE;
         }
-        composerStates[surfaceControlHandle] = composerState;
+        composerStates[composerState.state.layerId] = composerState;
     }
 
     InputWindowCommands inputWindowCommands;
@@ -796,8 +817,9 @@ status_t SurfaceComposerClient::Transaction::writeToParcel(Parcel* parcel) const
     }
 
     parcel->writeUint32(static_cast<uint32_t>(mComposerStates.size()));
-    for (auto const& [handle, composerState] : mComposerStates) {
-        SAFE_PARCEL(parcel->writeStrongBinder, handle);
+    for (auto const& [layerId, composerState] : mComposerStates) {
+        // The layer id and handle both travel inside the layer_state_t, so
+        // there is no need to write the map key separately.
         composerState.write(*parcel);
     }
 
@@ -826,14 +848,14 @@ void SurfaceComposerClient::Transaction::releaseBufferIfOverwriting(const layer_
 }
 
 SurfaceComposerClient::Transaction& SurfaceComposerClient::Transaction::merge(Transaction&& other) {
-    for (auto const& [handle, composerState] : other.mComposerStates) {
-        if (mComposerStates.count(handle) == 0) {
-            mComposerStates[handle] = composerState;
+    for (auto const& [layerId, composerState] : other.mComposerStates) {
+        if (mComposerStates.count(layerId) == 0) {
+            mComposerStates[layerId] = composerState;
         } else {
             if (composerState.state.what & layer_state_t::eBufferChanged) {
-                releaseBufferIfOverwriting(mComposerStates[handle].state);
+                releaseBufferIfOverwriting(mComposerStates[layerId].state);
             }
-            mComposerStates[handle].state.merge(composerState.state);
+            mComposerStates[layerId].state.merge(composerState.state);
         }
     }
 
@@ -921,8 +943,8 @@ void SurfaceComposerClient::Transaction::cacheBuffers() {
     }
 
     size_t count = 0;
-    for (auto& [handle, cs] : mComposerStates) {
-        layer_state_t* s = &(mComposerStates[handle].state);
+    for (auto& [layerId, cs] : mComposerStates) {
+        layer_state_t* s = &(cs.state);
         if (!(s->what & layer_state_t::eBufferChanged)) {
             continue;
         } else if (s->bufferData &&
@@ -1121,19 +1143,19 @@ void SurfaceComposerClient::Transaction::setEarlyWakeupEnd() {
 }
 
 layer_state_t* SurfaceComposerClient::Transaction::getLayerState(const sp<SurfaceControl>& sc) {
-    auto handle = sc->getLayerStateHandle();
+    const int32_t layerId = sc->getLayerId();
 
-    if (mComposerStates.count(handle) == 0) {
+    if (mComposerStates.count(layerId) == 0) {
         // we don't have it, add an initialized layer_state to our list
         ComposerState s;
 
-        s.state.surface = handle;
-        s.state.layerId = sc->getLayerId();
+        s.state.surface = sc->getLayerStateHandle();
+        s.state.layerId = layerId;
 
-        mComposerStates[handle] = s;
+        mComposerStates[layerId] = s;
     }
 
-    return &(mComposerStates[handle].state);
+    return &(mComposerStates[layerId].state);
 }
 
 void SurfaceComposerClient::Transaction::registerSurfaceControlForCallback(
@@ -2481,6 +2503,42 @@ status_t ScreenshotClient::captureLayers(const LayerCaptureArgs& captureArgs,
     return status.transactionError();
 }
 
+status_t ScreenshotClient::createDisplayCaptureSession(
+        const DisplayCaptureArgs& captureArgs, const gui::ScreenCaptureSessionBuffers& buffers,
+        const sp<IScreenCaptureListener>& captureListener, int32_t* outSessionId) {
+    sp<gui::ISurfaceComposer> s(ComposerServiceAIDL::getComposerService());
+    if (s == nullptr) return NO_INIT;
+
+    binder::Status status =
+            s->createDisplayCaptureSession(captureArgs, buffers, captureListener, outSessionId);
+    return status.transactionError();
+}
+
+status_t ScreenshotClient::captureSessionFrame(int32_t sessionId) {
+    sp<gui::ISurfaceComposer> s(ComposerServiceAIDL::getComposerService());
+    if (s == nullptr) return NO_INIT;
+
+    binder::Status status = s->captureSessionFrame(sessionId);
+    return status.transactionError();
+}
+
+status_t ScreenshotClient::releaseCaptureSessionBuffer(int32_t sessionId, uint64_t bufferId) {
+    sp<gui::ISurfaceComposer> s(ComposerServiceAIDL::getComposerService());
+    if (s == nullptr) return NO_INIT;
+
+    binder::Status status =
+            s->releaseCaptureSessionBuffer(sessionId, static_cast<int64_t>(bufferId));
+    return status.transactionError();
+}
+
+status_t ScreenshotClient::destroyCaptureSession(int32_t sessionId) {
+    sp<gui::ISurfaceComposer> s(ComposerServiceAIDL::getComposerService());
+    if (s == nullptr) return NO_INIT;
+
+    binder::Status status = s->destroyCaptureSession(sessionId);
+    return status.transactionError();
+}
+
 // ---------------------------------------------------------------------------------
 
 void ReleaseCallbackThread::addReleaseCallback(const ReleaseCallbackId callbackId,
@@ -17,9 +17,10 @@
 #ifndef ANDROID_GUI_BLAST_BUFFER_QUEUE_H
 #define ANDROID_GUI_BLAST_BUFFER_QUEUE_H
 
-#include <gui/IGraphicBufferProducer.h>
-#include <gui/BufferItemConsumer.h>
 #include <gui/BufferItem.h>
+#include <gui/BufferItemConsumer.h>
+#include <gui/BufferQueueDefs.h>
+#include <gui/IGraphicBufferProducer.h>
 #include <gui/SurfaceComposerClient.h>
 
 #include <utils/Condition.h>
@@ -27,8 +28,10 @@
 #include <utils/RefBase.h>
 
 #include <system/window.h>
-#include <thread>
+#include <array>
+#include <optional>
 #include <queue>
+#include <thread>
 
 namespace android {
 
@@ -111,6 +114,14 @@ public:
     status_t setFrameRate(float frameRate, int8_t compatibility, bool shouldBeSeamless);
     status_t setFrameTimelineInfo(uint64_t frameNumber, const FrameTimelineInfo& info);
 
+    /**
+     * Hint from clients that expect to keep many buffers in flight (e.g.
+     * high-refresh pipelines) so the queue is sized for that up front
+     * instead of growing the acquired count lazily mid-stream. Only ever
+     * raises the limit; returns the consumer's status.
+     */
+    status_t setMaxAcquiredBufferCountHint(int32_t maxAcquiredBuffers);
+
     void setSidebandStream(const sp<NativeHandle>& stream);
 
     uint32_t getLastTransformHint() const;
@@ -186,7 +197,84 @@ private:
             return rhs.callbackId == callbackId;
         }
     };
-    std::deque<ReleasedBuffer> mPendingRelease GUARDED_BY(mMutex);
+
+    // Fixed-capacity ring of held-back releases, indexed by frame number so
+    // out-of-order release callbacks are matched and deduplicated in O(1) on
+    // the callback thread. The capacity covers every slot that can be in
+    // flight at once.
+    struct PendingReleaseRing {
+        static constexpr size_t kCapacity = BufferQueueDefs::NUM_BUFFER_SLOTS;
+        static_assert(kCapacity <= 64, "occupancy tracked in a uint64_t");
+
+        size_t size() const { return mCount; }
+
+        bool contains(const ReleaseCallbackId& id) const {
+            const size_t i = indexOf(id.framenumber);
+            return (mOccupied & (1ULL << i)) && mEntries[i].callbackId == id;
+        }
+
+        // If a different pending entry already occupies `id`'s slot — only
+        // possible when in-flight frame numbers span more than kCapacity
+        // frames — it is removed and returned so the caller can release it
+        // immediately instead of leaking it.
+        std::optional<ReleasedBuffer> evictCollision(const ReleaseCallbackId& id) {
+            const size_t i = indexOf(id.framenumber);
+            if (!(mOccupied & (1ULL << i)) || mEntries[i].callbackId == id) {
+                return std::nullopt;
+            }
+            return std::optional(takeAt(i));
+        }
+
+        // Returns false if `id` was already pending.
+        bool insert(const ReleaseCallbackId& id, const sp<Fence>& fence) {
+            const size_t i = indexOf(id.framenumber);
+            if ((mOccupied & (1ULL << i)) && mEntries[i].callbackId == id) {
+                return false;
+            }
+            mEntries[i] = {id, fence};
+            mOccupied |= 1ULL << i;
+            mCount++;
+            return true;
+        }
+
+        // Removes and returns the entry with the lowest frame number.
+        ReleasedBuffer popOldest() {
+            size_t oldest = kCapacity;
+            uint64_t bits = mOccupied;
+            while (bits) {
+                const size_t i = static_cast<size_t>(__builtin_ctzll(bits));
+                bits &= bits - 1;
+                if (oldest == kCapacity ||
+                    mEntries[i].callbackId.framenumber <
+                            mEntries[oldest].callbackId.framenumber) {
+                    oldest = i;
+                }
+            }
+            return takeAt(oldest);
+        }
+
+        void clear() {
+            while (mOccupied) {
+                takeAt(static_cast<size_t>(__builtin_ctzll(mOccupied)));
+            }
+        }
+
+    private:
+        static size_t indexOf(uint64_t frameNumber) { return frameNumber % kCapacity; }
+
+        ReleasedBuffer takeAt(size_t i) {
+            mOccupied &= ~(1ULL << i);
+            mCount--;
+            ReleasedBuffer entry = std::move(mEntries[i]);
+            mEntries[i] = {};
+            return entry;
+        }
+
+        std::array<ReleasedBuffer, kCapacity> mEntries;
+        uint64_t mOccupied = 0;
+        size_t mCount = 0;
+    };
+    PendingReleaseRing mPendingRelease GUARDED_BY(mMutex);
 
     ui::Size mSize GUARDED_BY(mMutex);
     ui::Size mRequestedSize GUARDED_BY(mMutex);
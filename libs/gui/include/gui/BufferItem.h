@@ -48,6 +48,10 @@ class BufferItem : public Flattenable<BufferItem> {
     ~BufferItem();
     BufferItem(const BufferItem&) = default;
     BufferItem& operator=(const BufferItem&) = default;
+    // Moving steals the buffer/fence references, avoiding four refcount
+    // round-trips per frame on the acquire path.
+    BufferItem(BufferItem&&) = default;
+    BufferItem& operator=(BufferItem&&) = default;
 
     static const char* scalingModeName(uint32_t scalingMode);
 
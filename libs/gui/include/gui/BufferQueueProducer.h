@@ -17,12 +17,14 @@
 #ifndef ANDROID_GUI_BUFFERQUEUEPRODUCER_H
 #define ANDROID_GUI_BUFFERQUEUEPRODUCER_H
 
+#include <gui/BufferItem.h>
 #include <gui/BufferQueueDefs.h>
 #include <gui/IGraphicBufferProducer.h>
 
 namespace android {
 
 class IBinder;
+class IConsumerListener;
 struct BufferSlot;
 
 #ifndef NO_BINDER
@@ -119,6 +121,14 @@ public:
     virtual status_t queueBuffer(int slot,
             const QueueBufferInput& input, QueueBufferOutput* output);
 
+    // See IGraphicBufferProducer::queueBuffers. Queues a batch of filled
+    // buffers while holding the BufferQueue lock once for the whole batch,
+    // rather than re-acquiring it per buffer. The status of each buffer is
+    // recorded in the result field of its QueueBufferOutput; the batch itself
+    // only fails outright on a malformed request.
+    virtual status_t queueBuffers(const std::vector<QueueBufferInput>& inputs,
+            std::vector<QueueBufferOutput>* outputs) override;
+
     // cancelBuffer returns a dequeued buffer to the BufferQueue, but doesn't
     // queue it for use by the consumer.
     //
@@ -217,6 +227,48 @@ private:
     void addAndGetFrameTimestamps(const NewFrameEventsEntry* newTimestamps,
             FrameEventHistoryDelta* outDelta);
 
+    // Carries per-buffer state between the three phases of queueBuffer: input
+    // validation (lockless), queueing the buffer (under mCore->mMutex), and
+    // the consumer callback plus EGL throttling (under mCallbackMutex only).
+    // queueBuffers uses one context per buffer so an entire batch can run the
+    // middle phase while holding the core lock a single time.
+    struct QueueBufferContext {
+        int slot = BufferItem::INVALID_BUFFER_SLOT;
+        int64_t requestedPresentTimestamp = 0;
+        bool isAutoTimestamp = false;
+        android_dataspace dataSpace = HAL_DATASPACE_UNKNOWN;
+        Rect crop = Rect::EMPTY_RECT;
+        int scalingMode = 0;
+        uint32_t transform = 0;
+        uint32_t stickyTransform = 0;
+        sp<Fence> acquireFence;
+        bool getFrameTimestamps = false;
+        std::shared_ptr<FenceTime> acquireFenceTime;
+
+        // Filled in by queueBufferLocked for use by finishQueueBuffer.
+        sp<IConsumerListener> frameAvailableListener;
+        sp<IConsumerListener> frameReplacedListener;
+        int callbackTicket = 0;
+        uint64_t currentFrameNumber = 0;
+        BufferItem item;
+    };
+
+    // Deflates and validates a QueueBufferInput without touching any
+    // BufferQueue state. ctx->slot must already be set.
+    status_t validateQueueBufferInput(const QueueBufferInput& input,
+            QueueBufferContext* ctx) const;
+
+    // The portion of queueBuffer that must run with mCore->mMutex held:
+    // validates the slot state, inserts the buffer into the queue (possibly
+    // replacing a droppable frame) and takes a callback ticket.
+    status_t queueBufferLocked(const QueueBufferInput& input,
+            QueueBufferOutput* output, QueueBufferContext& ctx);
+
+    // The portion of queueBuffer that runs after mCore->mMutex is dropped:
+    // frame event bookkeeping, the ticket-ordered consumer callback, and
+    // throttling of EGL producers.
+    void finishQueueBuffer(QueueBufferContext& ctx, QueueBufferOutput* output);
+
     // waitForFreeSlotThenRelock finds the oldest slot in the FREE state. It may
     // block if there are no available slots and we are not in non-blocking
     // mode (producer and consumer controlled by the application). If it blocks,
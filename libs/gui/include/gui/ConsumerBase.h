@@ -17,6 +17,7 @@
 #ifndef ANDROID_GUI_CONSUMERBASE_H
 #define ANDROID_GUI_CONSUMERBASE_H
 
+#include <gui/BufferItem.h>
 #include <gui/BufferQueueDefs.h>
 #include <gui/IConsumerListener.h>
 #include <gui/IGraphicBufferConsumer.h>
@@ -28,6 +29,11 @@
 #include <utils/Vector.h>
 #include <utils/threads.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 
 namespace android {
 // ----------------------------------------------------------------------------
@@ -80,6 +86,19 @@ public:
     // when a new frame becomes available.
     void setFrameAvailableListener(const wp<FrameAvailableListener>& listener);
 
+    // setCallbackThread controls whether onFrameAvailable and onFrameReplaced
+    // callbacks are dispatched on a dedicated thread owned by this consumer
+    // instead of whatever binder thread delivered the notification, making
+    // callback latency independent of binder thread scheduling.
+    //
+    // If schedFifoPriority is greater than zero the thread requests SCHED_FIFO
+    // at that priority; this needs CAP_SYS_NICE and the thread falls back to
+    // the default policy (with a logged warning) without it. A non-zero
+    // cpuAffinityMask restricts the thread to the cores whose bits are set.
+    // Passing enabled = false joins the thread and returns to inline dispatch.
+    status_t setCallbackThread(bool enabled, int32_t schedFifoPriority = 0,
+                               uint64_t cpuAffinityMask = 0);
+
     // See IGraphicBufferConsumer::detachBuffer
     status_t detachBuffer(int slot);
 
@@ -264,6 +283,35 @@ protected:
     Mutex mFrameAvailableMutex;
     wp<FrameAvailableListener> mFrameAvailableListener;
 
+    // State for the optional dedicated callback dispatch thread enabled by
+    // setCallbackThread. The event queue and running flag are protected by
+    // mCallbackThreadMutex (not mMutex); the thread is only started and
+    // joined from setCallbackThread, onLastStrongRef and the destructor.
+    struct CallbackEvent {
+        bool replaced;
+        BufferItem item;
+    };
+
+    // callbackThreadLoop is the dispatch thread's main loop. It applies the
+    // requested scheduling policy and affinity to itself, then drains
+    // mCallbackEvents, forwarding each event to mFrameAvailableListener.
+    void callbackThreadLoop(int32_t schedFifoPriority, uint64_t cpuAffinityMask);
+
+    // stopCallbackThread signals the dispatch thread to exit once its queue
+    // is drained and joins it. It is a no-op if the thread is not running.
+    void stopCallbackThread();
+
+    // dispatchOnCallbackThread queues the event for the dispatch thread.
+    // Returns false if the thread is not running and the callback should be
+    // delivered inline instead.
+    bool dispatchOnCallbackThread(const BufferItem& item, bool replaced);
+
+    std::thread mCallbackThread;
+    std::mutex mCallbackThreadMutex;
+    std::condition_variable mCallbackThreadCondition;
+    std::deque<CallbackEvent> mCallbackEvents;
+    bool mCallbackThreadRunning = false;
+
     // The ConsumerBase has-a BufferQueue and is responsible for creating this object
     // if none is supplied
     sp<IGraphicBufferConsumer> mConsumer;
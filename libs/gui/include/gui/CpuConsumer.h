@@ -24,6 +24,7 @@
 
 #include <utils/Vector.h>
 
+#include <unordered_map>
 
 namespace android {
 
@@ -91,8 +92,19 @@ class CpuConsumer : public ConsumerBase
 
     // Create a new CPU consumer. The maxLockedBuffers parameter specifies
     // how many buffers can be locked for user access at the same time.
+    //
+    // When persistentMapping is true, buffers stay locked and mapped for CPU
+    // access across unlockBuffer/lockNextBuffer cycles, so repeatedly reading
+    // the same ring of buffers stops paying gralloc lock/unlock calls once
+    // every buffer has been seen. Re-acquiring a cached buffer only waits on
+    // its acquire fence and performs no cache maintenance, so this mode should
+    // only be enabled when CPU reads of the producer's buffers are coherent
+    // without a fresh gralloc lock.
     CpuConsumer(const sp<IGraphicBufferConsumer>& bq,
-            size_t maxLockedBuffers, bool controlledByApp = false);
+            size_t maxLockedBuffers, bool controlledByApp = false,
+            bool persistentMapping = false);
+
+    ~CpuConsumer() override;
 
     // Gets the next graphics buffer from the producer and locks it for CPU use,
     // filling out the passed-in locked buffer structure with the native pointer
@@ -111,10 +123,18 @@ class CpuConsumer : public ConsumerBase
     // lockNextBuffer.
     status_t unlockBuffer(const LockedBuffer &nativeBuffer);
 
+  protected:
+    // Drops any cached mapping for the freed slot's buffer, unlocking it if
+    // the user does not currently hold it.
+    void freeBufferLocked(int slotIndex) override;
+
   private:
     // Maximum number of buffers that can be locked at a time
     const size_t mMaxLockedBuffers;
 
+    // Whether buffers stay locked and mapped across unlockBuffer calls
+    const bool mPersistentMapping;
+
     // Tracking for buffers acquired by the user
     struct AcquiredBuffer {
         static constexpr uintptr_t kUnusedId = 0;
@@ -138,12 +158,31 @@ class CpuConsumer : public ConsumerBase
         }
     };
 
+    // A mapping kept alive across acquire/release cycles when persistent
+    // mapping is enabled. The buffer remains locked for CPU access, so
+    // re-acquiring it costs no gralloc calls.
+    struct CachedMapping {
+        sp<GraphicBuffer> mGraphicBuffer;
+        // Only the data pointers, strides and format fields are meaningful;
+        // per-frame metadata is filled in again on each acquisition.
+        LockedBuffer mMapping;
+    };
+
     size_t findAcquiredBufferLocked(uintptr_t id) const;
 
     status_t lockBufferItem(const BufferItem& item, LockedBuffer* outBuffer) const;
 
+    // Like lockBufferItem, but reuses (and populates) mMappingCache so that a
+    // buffer seen before is handed out without gralloc lock calls.
+    status_t lockBufferItemPersistent(const BufferItem& item, LockedBuffer* outBuffer);
+
     Vector<AcquiredBuffer> mAcquiredBuffers;
 
+    // Mappings of buffers that are still locked for CPU access, keyed by
+    // buffer ID. Entries are dropped when the producer frees the
+    // corresponding slot. Only used when mPersistentMapping is true.
+    std::unordered_map<uint64_t, CachedMapping> mMappingCache;
+
     // Count of currently locked buffers
     size_t mCurrentLockedBuffers;
 };
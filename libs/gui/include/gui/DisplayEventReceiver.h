@@ -40,6 +40,7 @@ using gui::VsyncEventData;
 
 namespace gui {
 class BitTube;
+class VsyncEventMailbox;
 } // namespace gui
 
 static inline constexpr uint32_t fourcc(char c1, char c2, char c3, char c4) {
@@ -169,9 +170,20 @@ public:
      */
     status_t getLatestVsyncEventData(ParcelableVsyncEventData* outVsyncEventData) const;
 
+    /*
+     * getLatestVsyncEventFromMailbox() copies the most recent vsync event
+     * delivered on this connection out of a shared-memory mailbox written by
+     * SurfaceFlinger, without any syscall. Returns false if the mailbox is
+     * not available or no vsync has been delivered yet, in which case the
+     * caller should fall back to getEvents() or getLatestVsyncEventData().
+     * The fd from getFd() should still be used to wait for new events.
+     */
+    bool getLatestVsyncEventFromMailbox(Event* outEvent) const;
+
 private:
     sp<IDisplayEventConnection> mEventConnection;
     std::unique_ptr<gui::BitTube> mDataChannel;
+    const gui::VsyncEventMailbox* mMailbox = nullptr;
     std::optional<status_t> mInitError;
 };
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <gui/FrameTimelineInfo.h>
+#include <gui/VsyncEventData.h>
+
+#include <utils/Errors.h>
+#include <utils/Mutex.h>
+#include <utils/Timers.h>
+
+namespace android::gui {
+
+// FramePacer centralizes the frame deadline math for clients that drive their
+// rendering off DisplayEventReceiver vsync events. Given the frame timelines
+// from the latest VsyncEventData and a measured workload duration, it picks
+// the timeline whose deadline the workload can still meet and sleeps until
+// the latest point at which the work can start, so clients don't have to
+// re-derive (and frequently get wrong) the deadline arithmetic themselves.
+//
+// A FramePacer is meant to pace a single render loop: onVsyncEvent may be
+// called from the event dispatch thread, but selectTimeline/waitUntilStart
+// are expected to be called from one thread at a time.
+class FramePacer {
+public:
+    FramePacer();
+    ~FramePacer();
+
+    // Disallow copying, since the pacer owns a timer file descriptor.
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // The timeline entry chosen for a frame, plus the time at which the
+    // workload should begin in order to meet that timeline's deadline.
+    struct FrameTarget {
+        int64_t vsyncId = FrameTimelineInfo::INVALID_VSYNC_ID;
+        nsecs_t startTime = 0;
+        nsecs_t deadlineTimestamp = 0;
+        nsecs_t expectedPresentationTime = 0;
+    };
+
+    // Stores the timelines from the latest vsync event so that subsequent
+    // frames can be paced without re-querying SurfaceFlinger.
+    void onVsyncEvent(const VsyncEventData& vsyncEventData);
+
+    // Picks the earliest frame timeline, starting from the platform's
+    // preferred entry, whose deadline still leaves room for a workload of
+    // workDuration starting at now. If even the last timeline's deadline
+    // can't be met, the last timeline is returned so the caller still has a
+    // valid vsync id to attach to the frame. startTime is as late as possible
+    // while leaving workDuration before the deadline, but never before now.
+    static FrameTarget selectTimeline(const VsyncEventData& vsyncEventData, nsecs_t workDuration,
+                                      nsecs_t now);
+
+    // Convenience overload that uses the event last passed to onVsyncEvent
+    // and the current time.
+    FrameTarget selectTimeline(nsecs_t workDuration) const;
+
+    // Blocks until target.startTime. The pacer reuses a single timerfd across
+    // frames, and wakeup times within kWakeupSlack of the timer's armed
+    // expiry (or of the current time) coalesce onto the existing expiry
+    // instead of reprogramming the timer. Returns NO_INIT if the timer could
+    // not be created, or the error from arming or waiting on it.
+    status_t waitUntilStart(const FrameTarget& target);
+
+    // Wakeups closer together than this share a single timer expiry.
+    static constexpr nsecs_t kWakeupSlack = 500000; // 0.5ms
+
+private:
+    int mTimerFd = -1;
+
+    // The absolute expiry the timerfd is currently armed for, or 0 when the
+    // last programmed expiry has already been consumed.
+    nsecs_t mArmedWakeupTime = 0;
+
+    mutable Mutex mMutex;
+    VsyncEventData mLastVsyncEventData GUARDED_BY(mMutex);
+    bool mHaveVsyncEventData GUARDED_BY(mMutex) = false;
+};
+
+} // namespace android::gui
@@ -142,14 +142,16 @@ public:
     // virtual for testing.
     virtual void updateAcquireFence(
             uint64_t frameNumber, std::shared_ptr<FenceTime>&& acquire);
-    void applyDelta(const FrameEventHistoryDelta& delta);
+    // Consumes the delta, moving the fences out of it, so that applying the
+    // per-frame updates doesn't copy them.
+    void applyDelta(FrameEventHistoryDelta&& delta);
 
     void updateSignalTimes();
 
 protected:
     void applyFenceDelta(FenceTimeline* timeline,
             std::shared_ptr<FenceTime>* dst,
-            const FenceTime::Snapshot& src) const;
+            FenceTime::Snapshot&& src) const;
 
     // virtual for testing.
     virtual std::shared_ptr<FenceTime> createFenceTime(
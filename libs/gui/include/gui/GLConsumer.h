@@ -30,6 +30,8 @@
 #include <utils/Vector.h>
 #include <utils/threads.h>
 
+#include <unordered_map>
+
 namespace android {
 // ----------------------------------------------------------------------------
 
@@ -176,6 +178,12 @@ public:
     // for use with bilinear filtering.
     void setFilteringEnabled(bool enabled);
 
+    // setEglImageCacheCapacity sets the maximum number of EGLImages retained
+    // for buffers this consumer has seen, including buffers no longer
+    // attached to any slot. A capacity of 0 disables the cache. Shrinking the
+    // capacity evicts the least recently used entries immediately.
+    void setEglImageCacheCapacity(size_t capacity);
+
     // getCurrentBuffer returns the buffer associated with the current image.
     // When outSlot is not nullptr, the current buffer slot index is also
     // returned.
@@ -377,6 +385,9 @@ private:
     // consume buffers as hardware textures.
     static const uint64_t DEFAULT_USAGE_FLAGS = GraphicBuffer::USAGE_HW_TEXTURE;
 
+    // The default capacity of mEglImageCache.
+    static const size_t DEFAULT_EGL_IMAGE_CACHE_CAPACITY = 16;
+
     // mCurrentTextureImage is the EglImage/buffer of the current texture. It's
     // possible that this buffer is not associated with any buffer slot, so we
     // must track it separately in order to support the getCurrentBuffer method.
@@ -480,6 +491,31 @@ private:
     // of the buffer allocated to a slot.
     EglSlot mEglSlots[BufferQueueDefs::NUM_BUFFER_SLOTS];
 
+    // getEglImageLocked returns an EglImage for the given buffer, reusing a
+    // cached image if this buffer has been seen before. Producers may attach
+    // a different GraphicBuffer to a slot each time it cycles, so the cache
+    // is keyed by buffer ID rather than by slot.
+    sp<EglImage> getEglImageLocked(const sp<GraphicBuffer>& graphicBuffer);
+
+    // evictLeastRecentlyUsedEglImageLocked removes the cache entry with the
+    // oldest use ticket. The cache capacity is small, so a linear scan is
+    // cheaper than maintaining an ordered structure.
+    void evictLeastRecentlyUsedEglImageLocked();
+
+    // mEglImageCache caches EglImages keyed by GraphicBuffer ID so that
+    // buffers cycling through different slots do not pay for
+    // eglCreateImageKHR again. Entries keep their GraphicBuffer alive until
+    // evicted in LRU order; hit/miss counters are reported by dump().
+    struct CachedEglImage {
+        sp<EglImage> image;
+        uint64_t lastUse;
+    };
+    std::unordered_map<uint64_t, CachedEglImage> mEglImageCache;
+    size_t mEglImageCacheCapacity = DEFAULT_EGL_IMAGE_CACHE_CAPACITY;
+    uint64_t mEglImageCacheTicket = 0;
+    uint64_t mEglImageCacheHits = 0;
+    uint64_t mEglImageCacheMisses = 0;
+
     // mCurrentTexture is the buffer slot index of the buffer that is currently
     // bound to the OpenGL texture. It is initialized to INVALID_BUFFER_SLOT,
     // indicating that no buffer slot is currently bound to the texture. Note,
@@ -84,6 +84,27 @@ struct ReleaseBufferCallbackIdHash {
     }
 };
 
+/**
+ * A single buffer release, as sent in the batched onReleaseBuffers callback. Carries the same
+ * payload as an individual onReleaseBuffer call.
+ */
+class ReleaseBufferStats : public Parcelable {
+public:
+    status_t writeToParcel(Parcel* output) const override;
+    status_t readFromParcel(const Parcel* input) override;
+
+    ReleaseBufferStats() = default;
+    ReleaseBufferStats(const ReleaseCallbackId& id, const sp<Fence>& fence,
+                       uint32_t currentMaxAcquiredBufferCount)
+          : callbackId(id),
+            releaseFence(fence),
+            currentMaxAcquiredBufferCount(currentMaxAcquiredBufferCount) {}
+
+    ReleaseCallbackId callbackId = ReleaseCallbackId::INVALID_ID;
+    sp<Fence> releaseFence;
+    uint32_t currentMaxAcquiredBufferCount = 0;
+};
+
 class FrameEventHistoryStats : public Parcelable {
 public:
     status_t writeToParcel(Parcel* output) const override;
@@ -195,6 +216,10 @@ public:
     virtual void onReleaseBuffer(ReleaseCallbackId callbackId, sp<Fence> releaseFence,
                                  uint32_t currentMaxAcquiredBufferCount) = 0;
     virtual void onTransactionQueueStalled() = 0;
+
+    // Batched form of onReleaseBuffer. All buffers released for this listener within one
+    // commit cycle are delivered in a single binder transaction.
+    virtual void onReleaseBuffers(std::vector<ReleaseBufferStats> releases) = 0;
 };
 
 class BnTransactionCompletedListener : public SafeBnInterface<ITransactionCompletedListener> {
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <binder/Parcel.h>
+#include <binder/Parcelable.h>
+#include <ui/GraphicBuffer.h>
+
+#include <vector>
+
+namespace android::gui {
+
+// The rotating pool of output buffers registered with a capture session. The buffers are
+// parceled once at session creation; subsequent captures render into them without any
+// further buffer traffic.
+struct ScreenCaptureSessionBuffers : public Parcelable {
+public:
+    ScreenCaptureSessionBuffers() = default;
+    virtual ~ScreenCaptureSessionBuffers() = default;
+    status_t writeToParcel(android::Parcel* parcel) const override;
+    status_t readFromParcel(const android::Parcel* parcel) override;
+
+    std::vector<sp<GraphicBuffer>> buffers;
+};
+
+} // namespace android::gui
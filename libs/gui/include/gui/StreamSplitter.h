@@ -18,18 +18,21 @@
 #define ANDROID_GUI_STREAMSPLITTER_H
 
 #include <gui/IConsumerListener.h>
+#include <gui/IGraphicBufferProducer.h>
 #include <gui/IProducerListener.h>
 
 #include <utils/Condition.h>
 #include <utils/KeyedVector.h>
 #include <utils/Mutex.h>
 #include <utils/StrongPointer.h>
+#include <utils/Thread.h>
+
+#include <list>
 
 namespace android {
 
 class GraphicBuffer;
 class IGraphicBufferConsumer;
-class IGraphicBufferProducer;
 
 // StreamSplitter is an autonomous class that manages one input BufferQueue
 // and multiple output BufferQueues. By using the buffer attach and detach logic
@@ -66,6 +69,13 @@ public:
     // setName sets the consumer name of the input queue
     void setName(const String8& name);
 
+    // waitForOutputs blocks until every buffer handed to the output workers so
+    // far has been attached and queued to (or rejected by) its output. Since
+    // the fan-out to the outputs is asynchronous, this is the only way for a
+    // caller (mostly tests) to tell when a queued buffer has reached every
+    // output.
+    void waitForOutputs();
+
 private:
     // From IConsumerListener
     //
@@ -97,6 +107,20 @@ private:
     // onFrameAvailable call to proceed.
     void onBufferReleasedByOutput(const sp<IGraphicBufferProducer>& from);
 
+    // Attaches and queues a buffer to a single output. Called from an
+    // OutputWorker with mMutex not held, so slow or blocked outputs don't
+    // stall the input or each other. If the output turns out to be abandoned,
+    // the buffer's release count is incremented so it can still be returned to
+    // the input once the other outputs release it.
+    void attachAndQueueBufferToOutput(const sp<IGraphicBufferProducer>& output,
+            const sp<GraphicBuffer>& buffer,
+            const IGraphicBufferProducer::QueueBufferInput& input);
+
+    // Increments the release count of the given buffer and, once every output
+    // has released it, returns it to the input and allows a blocked
+    // onFrameAvailable call to proceed. Must be called with mMutex locked.
+    void markBufferReleasedLocked(uint64_t bufferId);
+
     // When this is called, the splitter disconnects from (i.e., abandons) its
     // input queue and signals any waiting onFrameAvailable calls to wake up.
     // It still processes callbacks from other outputs, but only detaches their
@@ -126,6 +150,46 @@ private:
         sp<IGraphicBufferProducer> mOutput;
     };
 
+    // Each output gets its own worker thread, so the attach/queue calls for a
+    // frame run in parallel across outputs instead of serializing the input on
+    // the slowest consumer. A worker queues buffers to its output in FIFO
+    // order; release tracking (see BufferTracker) is the only point where the
+    // outputs synchronize again.
+    class OutputWorker : public Thread {
+    public:
+        OutputWorker(StreamSplitter* splitter,
+                const sp<IGraphicBufferProducer>& output);
+
+        // Schedules a buffer to be attached and queued to this worker's
+        // output. Must be called with mSplitter->mMutex locked.
+        void queueBufferLocked(const sp<GraphicBuffer>& buffer,
+                const IGraphicBufferProducer::QueueBufferInput& input);
+
+        // Wakes the worker up so that a pending requestExit is noticed. Must
+        // be called with mSplitter->mMutex locked.
+        void signalExitLocked();
+
+        // Returns true if this worker has no queued or in-flight buffers.
+        // Must be called with mSplitter->mMutex locked.
+        bool isIdleLocked() const { return mPending.empty() && !mBusy; }
+
+    private:
+        virtual bool threadLoop();
+
+        struct PendingBuffer {
+            sp<GraphicBuffer> buffer;
+            IGraphicBufferProducer::QueueBufferInput input;
+        };
+
+        // The splitter joins its workers before it is destroyed, so this
+        // pointer is always valid (a strong reference would form a cycle)
+        StreamSplitter* const mSplitter;
+        sp<IGraphicBufferProducer> mOutput;
+        std::list<PendingBuffer> mPending; // guarded by mSplitter->mMutex
+        bool mBusy = false; // guarded by mSplitter->mMutex
+        Condition mWorkCondition;
+    };
+
     class BufferTracker : public LightRefBase<BufferTracker> {
     public:
         explicit BufferTracker(const sp<GraphicBuffer>& buffer);
@@ -169,9 +233,12 @@ private:
 
     Mutex mMutex;
     Condition mReleaseCondition;
+    // Signaled whenever an output worker finishes its queued work
+    Condition mIdleCondition;
     int mOutstandingBuffers;
     sp<IGraphicBufferConsumer> mInput;
     Vector<sp<IGraphicBufferProducer> > mOutputs;
+    Vector<sp<OutputWorker> > mOutputWorkers;
 
     // Map of GraphicBuffer IDs (GraphicBuffer::getId()) to buffer tracking
     // objects (which are mostly for counting how many outputs have released the
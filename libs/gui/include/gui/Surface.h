@@ -282,6 +282,7 @@ private:
     int dispatchGetLastQueuedBuffer(va_list args);
     int dispatchGetLastQueuedBuffer2(va_list args);
     int dispatchSetFrameTimelineInfo(va_list args);
+    int dispatchSetBuffersBatch(va_list args);
 
 protected:
     virtual int dequeueBuffer(ANativeWindowBuffer** buffer, int* fenceFd);
@@ -300,6 +301,7 @@ protected:
     virtual int setBuffersStickyTransform(uint32_t transform);
     virtual int setBuffersTimestamp(int64_t timestamp);
     virtual int setBuffersDataSpace(ui::Dataspace dataSpace);
+    virtual int setBuffersBatch(const ANativeWindowBuffersBatch* batch);
     virtual int setBuffersSmpte2086Metadata(const android_smpte2086_metadata* metadata);
     virtual int setBuffersCta8613Metadata(const android_cta861_3_metadata* metadata);
     virtual int setBuffersHdr10PlusMetadata(const size_t size, const uint8_t* metadata);
@@ -411,7 +413,7 @@ protected:
             const IGraphicBufferProducer::QueueBufferInput& queueBufferInput);
 
     void onBufferQueuedLocked(int slot, sp<Fence> fence,
-            const IGraphicBufferProducer::QueueBufferOutput& output);
+            IGraphicBufferProducer::QueueBufferOutput& output);
 
     struct BufferSlot {
         sp<GraphicBuffer> buffer;
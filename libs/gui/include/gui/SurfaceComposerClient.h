@@ -43,6 +43,7 @@
 #include <gui/ISurfaceComposer.h>
 #include <gui/ITransactionCompletedListener.h>
 #include <gui/LayerState.h>
+#include <gui/ScreenCaptureSessionBuffers.h>
 #include <gui/SurfaceControl.h>
 #include <gui/WindowInfosListenerReporter.h>
 #include <math/vec3.h>
@@ -401,7 +402,11 @@ public:
         void releaseBufferIfOverwriting(const layer_state_t& state);
 
     protected:
-        std::unordered_map<sp<IBinder>, ComposerState, IBinderHash> mComposerStates;
+        // Keyed by the stable layer id of each SurfaceControl. The handle the
+        // server resolves still travels inside each layer_state_t, but keying
+        // the map by id means building and merging transactions hashes flat
+        // integers instead of binder handles.
+        std::unordered_map<int32_t, ComposerState> mComposerStates;
         SortedVector<DisplayState> mDisplayStates;
         std::unordered_map<sp<ITransactionCompletedListener>, CallbackInfo, TCLHash>
                 mListenerCallbacks;
@@ -728,6 +733,18 @@ public:
     static status_t captureDisplay(const DisplayCaptureArgs&, const sp<IScreenCaptureListener>&);
     static status_t captureDisplay(DisplayId, const sp<IScreenCaptureListener>&);
     static status_t captureLayers(const LayerCaptureArgs&, const sp<IScreenCaptureListener>&);
+
+    // Capture sessions for continuous capture. The caller registers a rotating pool of
+    // output buffers once; each captureSessionFrame renders into the next free buffer
+    // and results arrive through the listener with the buffer and its release fence.
+    // Buffers must be handed back with releaseCaptureSessionBuffer after consumption.
+    static status_t createDisplayCaptureSession(const DisplayCaptureArgs&,
+                                                const gui::ScreenCaptureSessionBuffers&,
+                                                const sp<IScreenCaptureListener>&,
+                                                int32_t* outSessionId);
+    static status_t captureSessionFrame(int32_t sessionId);
+    static status_t releaseCaptureSessionBuffer(int32_t sessionId, uint64_t bufferId);
+    static status_t destroyCaptureSession(int32_t sessionId);
 };
 
 // ---------------------------------------------------------------------------
@@ -822,6 +839,7 @@ public:
     void onTransactionCompleted(ListenerStats stats) override;
     void onReleaseBuffer(ReleaseCallbackId, sp<Fence> releaseFence,
                          uint32_t currentMaxAcquiredBufferCount) override;
+    void onReleaseBuffers(std::vector<ReleaseBufferStats> releases) override;
 
     void removeReleaseBufferCallback(const ReleaseCallbackId& callbackId);
 
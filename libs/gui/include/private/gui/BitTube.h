@@ -74,6 +74,27 @@ public:
         return recvObjects(tube, events, count, sizeof(T));
     }
 
+    // send objects as one message each, all with a single sendmmsg() syscall. Returns the number
+    // of objects sent, which may be less than count if the send buffer fills up; the remainder can
+    // be retried once the receiver has drained the tube.
+    template <typename T>
+    static ssize_t sendObjectsVectored(BitTube* tube, T const* events, size_t count) {
+        return sendObjectsVectored(tube, events, count, sizeof(T));
+    }
+
+    // receive up to count messages of one object each with a single recvmmsg() syscall. Pairs
+    // with sendObjectsVectored (or with senders that write one object per message); returns the
+    // number of objects received, or 0 if the tube is empty.
+    template <typename T>
+    static ssize_t recvObjectsVectored(BitTube* tube, T* events, size_t count) {
+        return recvObjectsVectored(tube, events, count, sizeof(T));
+    }
+
+    // resizes the send buffer, for senders that queue large bursts of messages between receiver
+    // wakeups. On success, returns the effective size granted by the kernel, which may be larger
+    // than requested; otherwise returns a negative errno.
+    ssize_t setSendBufferSize(size_t size);
+
     // implement the Parcelable protocol. Only parcels the receive file descriptor
     status_t writeToParcel(Parcel* reply) const;
     status_t readFromParcel(const Parcel* parcel);
@@ -94,6 +115,11 @@ private:
     static ssize_t sendObjects(BitTube* tube, void const* events, size_t count, size_t objSize);
 
     static ssize_t recvObjects(BitTube* tube, void* events, size_t count, size_t objSize);
+
+    static ssize_t sendObjectsVectored(BitTube* tube, void const* events, size_t count,
+                                       size_t objSize);
+
+    static ssize_t recvObjectsVectored(BitTube* tube, void* events, size_t count, size_t objSize);
 };
 
 } // namespace gui
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <gui/DisplayEventReceiver.h>
+
+namespace android::gui {
+
+/*
+ * A single-writer, multi-reader mailbox holding the most recent vsync event
+ * published on a display event connection.
+ *
+ * SurfaceFlinger's EventThread owns one mailbox per connection and shares it
+ * with the client as a read-only memory region, so clients that only need the
+ * latest vsync timing can poll it without a syscall. The BitTube is still the
+ * wakeup mechanism; the mailbox only elides the read.
+ *
+ * The event is protected by a seqlock: the sequence number is odd while the
+ * writer is mid-update, and a reader retries until it observes the same even
+ * value on both sides of its copy.
+ */
+class VsyncEventMailbox {
+public:
+    // publish() stores the latest vsync event. Must only be called from the
+    // owning EventThread.
+    void publish(const DisplayEventReceiver::Event& event) {
+        const uint32_t seq = mSeq.load(std::memory_order_relaxed);
+        mSeq.store(seq + 1, std::memory_order_relaxed);
+        // Order the odd sequence number before the event writes.
+        std::atomic_thread_fence(std::memory_order_release);
+        mEvent = event;
+        mSeq.store(seq + 2, std::memory_order_release);
+    }
+
+    // read() copies the latest published event into outEvent. Returns false
+    // if no vsync has been published yet, or if the writer kept invalidating
+    // the mailbox for the (bounded) duration of the retry loop.
+    bool read(DisplayEventReceiver::Event* outEvent) const {
+        for (int attempt = 0; attempt < kMaxReadAttempts; attempt++) {
+            const uint32_t seq = mSeq.load(std::memory_order_acquire);
+            if (seq == 0) {
+                return false;
+            }
+            if (seq & 1) {
+                continue;
+            }
+            *outEvent = mEvent;
+            // Order the event reads before the sequence number re-check.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (mSeq.load(std::memory_order_relaxed) == seq) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // A writer holds the lock for a handful of stores, so a bounded number of
+    // retries is plenty; giving up only means the caller falls back to the
+    // binder path.
+    static constexpr int kMaxReadAttempts = 64;
+
+    std::atomic<uint32_t> mSeq{0};
+    DisplayEventReceiver::Event mEvent;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "the sequence number is shared across processes");
+static_assert(std::is_trivially_copyable_v<DisplayEventReceiver::Event>,
+              "the event is copied in and out of shared memory");
+
+} // namespace android::gui
@@ -1594,7 +1594,7 @@ TEST_F(BLASTFrameEventHistoryTest, FrameEventHistory_Basic) {
     nsecs_t requestedPresentTimeA = 0;
     nsecs_t postedTimeA = 0;
     setUpAndQueueBuffer(igbProducer, &requestedPresentTimeA, &postedTimeA, &qbOutput, true);
-    history.applyDelta(qbOutput.frameTimestamps);
+    history.applyDelta(std::move(qbOutput.frameTimestamps));
 
     FrameEvents* events = nullptr;
     events = history.getFrame(1);
@@ -1609,7 +1609,7 @@ TEST_F(BLASTFrameEventHistoryTest, FrameEventHistory_Basic) {
     nsecs_t requestedPresentTimeB = 0;
     nsecs_t postedTimeB = 0;
     setUpAndQueueBuffer(igbProducer, &requestedPresentTimeB, &postedTimeB, &qbOutput, true);
-    history.applyDelta(qbOutput.frameTimestamps);
+    history.applyDelta(std::move(qbOutput.frameTimestamps));
     events = history.getFrame(1);
     ASSERT_NE(nullptr, events);
 
@@ -1649,7 +1649,7 @@ TEST_F(BLASTFrameEventHistoryTest, FrameEventHistory_DroppedFrame) {
     nsecs_t presentTime = systemTime() + std::chrono::nanoseconds(500ms).count();
     setUpAndQueueBuffer(igbProducer, &requestedPresentTimeA, &postedTimeA, &qbOutput, true,
                         presentTime);
-    history.applyDelta(qbOutput.frameTimestamps);
+    history.applyDelta(std::move(qbOutput.frameTimestamps));
 
     FrameEvents* events = nullptr;
     events = history.getFrame(1);
@@ -1664,7 +1664,7 @@ TEST_F(BLASTFrameEventHistoryTest, FrameEventHistory_DroppedFrame) {
     presentTime = systemTime() + std::chrono::nanoseconds(1ms).count();
     setUpAndQueueBuffer(igbProducer, &requestedPresentTimeB, &postedTimeB, &qbOutput, true,
                         presentTime);
-    history.applyDelta(qbOutput.frameTimestamps);
+    history.applyDelta(std::move(qbOutput.frameTimestamps));
     events = history.getFrame(1);
     ASSERT_NE(nullptr, events);
 
@@ -1687,7 +1687,7 @@ TEST_F(BLASTFrameEventHistoryTest, FrameEventHistory_DroppedFrame) {
     nsecs_t requestedPresentTimeC = 0;
     nsecs_t postedTimeC = 0;
     setUpAndQueueBuffer(igbProducer, &requestedPresentTimeC, &postedTimeC, &qbOutput, true);
-    history.applyDelta(qbOutput.frameTimestamps);
+    history.applyDelta(std::move(qbOutput.frameTimestamps));
 
     // frame number, requestedPresentTime, and postTime should not have changed
     ASSERT_EQ(1, events->frameNumber);
@@ -1727,14 +1727,14 @@ TEST_F(BLASTFrameEventHistoryTest, FrameEventHistory_CompositorTimings) {
     nsecs_t requestedPresentTimeA = 0;
     nsecs_t postedTimeA = 0;
     setUpAndQueueBuffer(igbProducer, &requestedPresentTimeA, &postedTimeA, &qbOutput, true);
-    history.applyDelta(qbOutput.frameTimestamps);
+    history.applyDelta(std::move(qbOutput.frameTimestamps));
     adapter.waitForCallback(1);
 
     // queue another buffer so we query for frame event deltas
     nsecs_t requestedPresentTimeB = 0;
     nsecs_t postedTimeB = 0;
     setUpAndQueueBuffer(igbProducer, &requestedPresentTimeB, &postedTimeB, &qbOutput, true);
-    history.applyDelta(qbOutput.frameTimestamps);
+    history.applyDelta(std::move(qbOutput.frameTimestamps));
 
     // check for a valid compositor deadline
     ASSERT_NE(0, history.getReportedCompositeDeadline());
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <private/gui/BitTube.h>
+
+namespace android {
+
+using gui::BitTube;
+
+namespace test {
+
+namespace {
+
+struct Event {
+    int64_t sequence;
+    int64_t payload;
+};
+
+} // namespace
+
+TEST(BitTubeTest, SendAndReceiveVectored) {
+    BitTube tube(BitTube::DefaultSize);
+    ASSERT_EQ(NO_ERROR, tube.initCheck());
+
+    constexpr size_t kCount = 16;
+    Event in[kCount];
+    for (size_t i = 0; i < kCount; i++) {
+        in[i] = {static_cast<int64_t>(i), static_cast<int64_t>(i * 10)};
+    }
+    ASSERT_EQ(static_cast<ssize_t>(kCount),
+              BitTube::sendObjectsVectored(&tube, in, kCount));
+
+    Event out[kCount] = {};
+    ASSERT_EQ(static_cast<ssize_t>(kCount),
+              BitTube::recvObjectsVectored(&tube, out, kCount));
+    for (size_t i = 0; i < kCount; i++) {
+        EXPECT_EQ(in[i].sequence, out[i].sequence);
+        EXPECT_EQ(in[i].payload, out[i].payload);
+    }
+}
+
+TEST(BitTubeTest, VectoredSendDrainsWithSingleObjectReceives) {
+    BitTube tube(BitTube::DefaultSize);
+    ASSERT_EQ(NO_ERROR, tube.initCheck());
+
+    constexpr size_t kCount = 4;
+    Event in[kCount];
+    for (size_t i = 0; i < kCount; i++) {
+        in[i] = {static_cast<int64_t>(i), static_cast<int64_t>(i * 10)};
+    }
+    ASSERT_EQ(static_cast<ssize_t>(kCount),
+              BitTube::sendObjectsVectored(&tube, in, kCount));
+
+    // Each message holds one object, so the existing per-message receive path
+    // must interoperate with vectored sends.
+    for (size_t i = 0; i < kCount; i++) {
+        Event out = {};
+        ASSERT_EQ(1, BitTube::recvObjects(&tube, &out, 1));
+        EXPECT_EQ(in[i].sequence, out.sequence);
+    }
+}
+
+TEST(BitTubeTest, VectoredReceiveOnEmptyTubeReturnsZero) {
+    BitTube tube(BitTube::DefaultSize);
+    ASSERT_EQ(NO_ERROR, tube.initCheck());
+
+    Event out[4];
+    EXPECT_EQ(0, BitTube::recvObjectsVectored(&tube, out, 4));
+}
+
+TEST(BitTubeTest, SetSendBufferSizeGrantsAtLeastRequested) {
+    BitTube tube(BitTube::DefaultSize);
+    ASSERT_EQ(NO_ERROR, tube.initCheck());
+
+    constexpr size_t kRequested = 64 * 1024;
+    const ssize_t effective = tube.setSendBufferSize(kRequested);
+    ASSERT_GT(effective, 0);
+    EXPECT_GE(static_cast<size_t>(effective), kRequested);
+}
+
+} // namespace test
+} // namespace android
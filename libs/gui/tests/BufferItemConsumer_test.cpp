@@ -203,4 +203,42 @@ TEST_F(BufferItemConsumerTest, TriggerBufferFreed_DeleteBufferItemConsumer) {
     ASSERT_EQ(1, GetFreedBufferCount());
 }
 
+// Test that callbacks are delivered from the dedicated dispatch thread when
+// one is configured with setCallbackThread.
+TEST_F(BufferItemConsumerTest, CallbackThread_DispatchesFrameAvailable) {
+    struct FrameListener : public BufferItemConsumer::FrameAvailableListener {
+        void onFrameAvailable(const BufferItem& /* item */) override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCallbackThreadId = std::this_thread::get_id();
+            mFrameCount++;
+        }
+        std::mutex mMutex;
+        std::thread::id mCallbackThreadId;
+        int mFrameCount{0};
+    };
+
+    sp<FrameListener> listener = new FrameListener();
+    mBIC->setFrameAvailableListener(listener);
+
+    // A negative priority is rejected.
+    ASSERT_EQ(BAD_VALUE, mBIC->setCallbackThread(true, -1));
+
+    // No elevated priority or affinity, so the test doesn't need CAP_SYS_NICE.
+    ASSERT_EQ(NO_ERROR, mBIC->setCallbackThread(true));
+
+    int slot;
+    DequeueBuffer(&slot);
+    QueueBuffer(slot);
+
+    // Sleep to give some time for callbacks to happen.
+    usleep(kFrameSleepUs);
+    {
+        std::lock_guard<std::mutex> lock(listener->mMutex);
+        ASSERT_EQ(1, listener->mFrameCount);
+        ASSERT_NE(std::this_thread::get_id(), listener->mCallbackThreadId);
+    }
+
+    ASSERT_EQ(NO_ERROR, mBIC->setCallbackThread(false));
+}
+
 }  // namespace android
@@ -565,6 +565,48 @@ TEST_P(CpuConsumerTest, FromCpuSingle) {
     mCC->unlockBuffer(b);
 }
 
+// Verify that a consumer with persistent mapping keeps handing out valid
+// buffer contents as the same ring of buffers is acquired and released
+// repeatedly, so later acquisitions are served from cached mappings.
+TEST_P(CpuConsumerTest, FromCpuPersistentMapping) {
+    status_t err;
+    CpuConsumerTestParams params = GetParam();
+
+    // Set up a dedicated consumer with persistent mapping enabled
+    sp<IGraphicBufferProducer> producer;
+    sp<IGraphicBufferConsumer> consumer;
+    BufferQueue::createBufferQueue(&producer, &consumer);
+    sp<CpuConsumer> cc = new CpuConsumer(consumer, params.maxLockedBuffers,
+            /*controlledByApp*/ false, /*persistentMapping*/ true);
+    cc->setName(String8("CpuConsumer_Under_Test_Persistent"));
+    sp<ANativeWindow> anw = new Surface(producer);
+
+    ASSERT_NO_FATAL_FAILURE(configureANW(anw, params, 1));
+
+    // Cycle through the buffer ring several times
+    const int numFrames = 12;
+    for (int i = 0; i < numFrames; i++) {
+        const int64_t time = 1000 + i;
+        uint32_t stride;
+        ASSERT_NO_FATAL_FAILURE(produceOneFrame(anw, params, time, &stride));
+
+        CpuConsumer::LockedBuffer b;
+        err = cc->lockNextBuffer(&b);
+        ASSERT_NO_ERROR(err, "getNextBuffer error: ");
+
+        ASSERT_TRUE(b.data != nullptr);
+        EXPECT_EQ(params.width,  b.width);
+        EXPECT_EQ(params.height, b.height);
+        EXPECT_EQ(params.format, b.format);
+        EXPECT_EQ(stride, b.stride);
+        EXPECT_EQ(time, b.timestamp);
+
+        checkAnyBuffer(b, GetParam().format);
+        err = cc->unlockBuffer(b);
+        ASSERT_NO_ERROR(err, "unlockBuffer error: ");
+    }
+}
+
 // This test is disabled because the HAL_PIXEL_FORMAT_RAW16 format is not
 // supported on all devices.
 TEST_P(CpuConsumerTest, FromCpuManyInQueue) {
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <gui/FramePacer.h>
+
+namespace android {
+
+using gui::FramePacer;
+using gui::VsyncEventData;
+using FrameTimeline = gui::VsyncEventData::FrameTimeline;
+
+namespace test {
+
+namespace {
+
+constexpr nsecs_t kFrameInterval = 16666667;
+
+// Builds timelines one frame interval apart, with the deadline of the
+// first entry firstDeadline ns from now.
+VsyncEventData makeVsyncEventData(nsecs_t now, nsecs_t firstDeadline) {
+    VsyncEventData vsync;
+    vsync.frameInterval = kFrameInterval;
+    vsync.preferredFrameTimelineIndex = 0;
+    for (int64_t i = 0; i < VsyncEventData::kFrameTimelinesLength; i++) {
+        vsync.frameTimelines[i].vsyncId = i + 1;
+        vsync.frameTimelines[i].deadlineTimestamp = now + firstDeadline + i * kFrameInterval;
+        vsync.frameTimelines[i].expectedPresentationTime =
+                vsync.frameTimelines[i].deadlineTimestamp + kFrameInterval;
+    }
+    return vsync;
+}
+
+} // namespace
+
+TEST(FramePacerTest, SelectsPreferredTimelineWhenWorkFits) {
+    const nsecs_t now = 1000000000;
+    VsyncEventData vsync = makeVsyncEventData(now, kFrameInterval);
+
+    const nsecs_t workDuration = kFrameInterval / 2;
+    FramePacer::FrameTarget target = FramePacer::selectTimeline(vsync, workDuration, now);
+
+    EXPECT_EQ(vsync.frameTimelines[0].vsyncId, target.vsyncId);
+    EXPECT_EQ(vsync.frameTimelines[0].deadlineTimestamp, target.deadlineTimestamp);
+    EXPECT_EQ(vsync.frameTimelines[0].expectedPresentationTime,
+              target.expectedPresentationTime);
+    EXPECT_EQ(target.deadlineTimestamp - workDuration, target.startTime);
+}
+
+TEST(FramePacerTest, SkipsTimelinesWhoseDeadlineCannotBeMet) {
+    const nsecs_t now = 1000000000;
+    VsyncEventData vsync = makeVsyncEventData(now, kFrameInterval);
+
+    // Too long for the first two deadlines, but fits the third.
+    const nsecs_t workDuration = 2 * kFrameInterval + kFrameInterval / 2;
+    FramePacer::FrameTarget target = FramePacer::selectTimeline(vsync, workDuration, now);
+
+    EXPECT_EQ(vsync.frameTimelines[2].vsyncId, target.vsyncId);
+    EXPECT_EQ(vsync.frameTimelines[2].deadlineTimestamp, target.deadlineTimestamp);
+}
+
+TEST(FramePacerTest, StartsAtOrAfterPreferredIndex) {
+    const nsecs_t now = 1000000000;
+    VsyncEventData vsync = makeVsyncEventData(now, kFrameInterval);
+    vsync.preferredFrameTimelineIndex = 2;
+
+    const nsecs_t workDuration = kFrameInterval / 2;
+    FramePacer::FrameTarget target = FramePacer::selectTimeline(vsync, workDuration, now);
+
+    EXPECT_EQ(vsync.frameTimelines[2].vsyncId, target.vsyncId);
+}
+
+TEST(FramePacerTest, FallsBackToLastTimelineWhenNothingFits) {
+    const nsecs_t now = 1000000000;
+    VsyncEventData vsync = makeVsyncEventData(now, kFrameInterval);
+
+    const nsecs_t workDuration = VsyncEventData::kFrameTimelinesLength * kFrameInterval * 2;
+    FramePacer::FrameTarget target = FramePacer::selectTimeline(vsync, workDuration, now);
+
+    constexpr size_t kLast = VsyncEventData::kFrameTimelinesLength - 1;
+    EXPECT_EQ(vsync.frameTimelines[kLast].vsyncId, target.vsyncId);
+    // There is no room to wait, so the work should start immediately.
+    EXPECT_EQ(now, target.startTime);
+}
+
+TEST(FramePacerTest, WaitReturnsImmediatelyForPastStartTimes) {
+    FramePacer pacer;
+
+    FramePacer::FrameTarget target;
+    target.startTime = systemTime(SYSTEM_TIME_MONOTONIC) - kFrameInterval;
+    EXPECT_EQ(NO_ERROR, pacer.waitUntilStart(target));
+}
+
+TEST(FramePacerTest, WaitBlocksUntilStartTime) {
+    FramePacer pacer;
+
+    const nsecs_t delay = 2000000; // 2ms
+    FramePacer::FrameTarget target;
+    target.startTime = systemTime(SYSTEM_TIME_MONOTONIC) + delay;
+    EXPECT_EQ(NO_ERROR, pacer.waitUntilStart(target));
+    EXPECT_GE(systemTime(SYSTEM_TIME_MONOTONIC), target.startTime - FramePacer::kWakeupSlack);
+}
+
+} // namespace test
+} // namespace android
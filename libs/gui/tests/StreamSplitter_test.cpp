@@ -98,6 +98,9 @@ TEST_F(StreamSplitterTest, OneInputOneOutput) {
             NATIVE_WINDOW_SCALING_MODE_FREEZE, 0, Fence::NO_FENCE);
     ASSERT_EQ(OK, inputProducer->queueBuffer(slot, qbInput, &qbOutput));
 
+    // Wait for the buffer to be queued to the output
+    splitter->waitForOutputs();
+
     // Now that we have dequeued/allocated one buffer, prevent any further
     // allocations
     ASSERT_EQ(OK, inputProducer->allowAllocation(false));
@@ -170,6 +173,9 @@ TEST_F(StreamSplitterTest, OneInputMultipleOutputs) {
             NATIVE_WINDOW_SCALING_MODE_FREEZE, 0, Fence::NO_FENCE);
     ASSERT_EQ(OK, inputProducer->queueBuffer(slot, qbInput, &qbOutput));
 
+    // Wait for the buffer to be queued to all of the outputs
+    splitter->waitForOutputs();
+
     // Now that we have dequeued/allocated one buffer, prevent any further
     // allocations
     ASSERT_EQ(OK, inputProducer->allowAllocation(false));
@@ -232,6 +238,9 @@ TEST_F(StreamSplitterTest, OutputAbandonment) {
             NATIVE_WINDOW_SCALING_MODE_FREEZE, 0, Fence::NO_FENCE);
     ASSERT_EQ(OK, inputProducer->queueBuffer(slot, qbInput, &qbOutput));
 
+    // Wait for the splitter to discover that the output has been abandoned
+    splitter->waitForOutputs();
+
     // Input should be abandoned
     ASSERT_EQ(NO_INIT,
               inputProducer->dequeueBuffer(&slot, &fence, 0, 0, 0, GRALLOC_USAGE_SW_WRITE_OFTEN,
@@ -360,6 +360,43 @@ TEST_F(SurfaceTest, QueryDefaultBuffersDataSpace) {
     ASSERT_EQ(TEST_DATASPACE, dataSpace);
 }
 
+TEST_F(SurfaceTest, SetBuffersBatch) {
+    sp<IGraphicBufferProducer> producer;
+    sp<IGraphicBufferConsumer> consumer;
+    BufferQueue::createBufferQueue(&producer, &consumer);
+    sp<CpuConsumer> cpuConsumer = new CpuConsumer(consumer, 1);
+    sp<Surface> surface = new Surface(producer);
+    sp<ANativeWindow> window(surface);
+
+    ASSERT_EQ(NO_ERROR, native_window_api_connect(window.get(),
+            NATIVE_WINDOW_API_CPU));
+
+    ANativeWindowBuffersBatch batch = {};
+    batch.propertyMask = NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS |
+            NATIVE_WINDOW_BATCH_PROPERTY_FORMAT | NATIVE_WINDOW_BATCH_PROPERTY_USAGE;
+    batch.width = 16;
+    batch.height = 8;
+    batch.format = PIXEL_FORMAT_RGBA_8888;
+    batch.usage = GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_SW_WRITE_OFTEN;
+    ASSERT_EQ(NO_ERROR, native_window_set_buffers_batch(window.get(), &batch));
+
+    // A rejected batch must leave all staged properties untouched.
+    ANativeWindowBuffersBatch badBatch = {};
+    badBatch.propertyMask = NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS |
+            NATIVE_WINDOW_BATCH_PROPERTY_FORMAT;
+    badBatch.width = 32;  // no height
+    badBatch.format = PIXEL_FORMAT_RGB_565;
+    ASSERT_EQ(BAD_VALUE, native_window_set_buffers_batch(window.get(), &badBatch));
+
+    ANativeWindowBuffer* buffer;
+    int fenceFd;
+    ASSERT_EQ(NO_ERROR, window->dequeueBuffer(window.get(), &buffer, &fenceFd));
+    EXPECT_EQ(16, buffer->width);
+    EXPECT_EQ(8, buffer->height);
+    EXPECT_EQ(PIXEL_FORMAT_RGBA_8888, buffer->format);
+    ASSERT_EQ(NO_ERROR, window->cancelBuffer(window.get(), buffer, fenceFd));
+}
+
 TEST_F(SurfaceTest, SettingGenerationNumber) {
     sp<IGraphicBufferProducer> producer;
     sp<IGraphicBufferConsumer> consumer;
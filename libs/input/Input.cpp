@@ -730,10 +730,6 @@ status_t MotionEvent::readFromParcel(Parcel* parcel) {
 
     mPointerProperties.clear();
     mPointerProperties.reserve(pointerCount);
-    mSampleEventTimes.clear();
-    mSampleEventTimes.reserve(sampleCount);
-    mSamplePointerCoords.clear();
-    mSamplePointerCoords.reserve(sampleCount * pointerCount);
 
     for (size_t i = 0; i < pointerCount; i++) {
         mPointerProperties.push_back({});
@@ -742,16 +738,41 @@ status_t MotionEvent::readFromParcel(Parcel* parcel) {
         properties.toolType = parcel->readInt32();
     }
 
-    while (sampleCount > 0) {
-        sampleCount--;
-        mSampleEventTimes.push_back(parcel->readInt64());
-        for (size_t i = 0; i < pointerCount; i++) {
-            mSamplePointerCoords.push_back({});
-            status_t status = mSamplePointerCoords.back().readFromParcel(parcel);
-            if (status) {
-                return status;
-            }
+    // The sample data is stored as two flat blocks: the event times, and the packed pointer
+    // coords. See writeToParcel.
+    mSampleEventTimes.resize(sampleCount);
+    result = parcel->read(mSampleEventTimes.data(), sampleCount * sizeof(nsecs_t));
+    if (result != OK) {
+        return result;
+    }
+
+    const uint32_t coordsSize = parcel->readUint32();
+    if (coordsSize > sampleCount * pointerCount * sizeof(PointerCoords)) {
+        return BAD_VALUE;
+    }
+    const uint8_t* src = static_cast<const uint8_t*>(parcel->readInplace(coordsSize));
+    if (src == nullptr) {
+        return BAD_VALUE;
+    }
+    const uint8_t* end = src + coordsSize;
+    // Resizing value-initializes the coords, so the axis values not covered by 'bits' are zeroed.
+    mSamplePointerCoords.resize(sampleCount * pointerCount);
+    for (PointerCoords& pc : mSamplePointerCoords) {
+        if (static_cast<size_t>(end - src) < sizeof(pc.bits)) {
+            return BAD_VALUE;
+        }
+        memcpy(&pc.bits, src, sizeof(pc.bits));
+        src += sizeof(pc.bits);
+        const uint32_t count = BitSet64::count(pc.bits);
+        if (count > PointerCoords::MAX_AXES ||
+            static_cast<size_t>(end - src) < count * sizeof(float)) {
+            return BAD_VALUE;
         }
+        memcpy(pc.values, src, count * sizeof(float));
+        src += count * sizeof(float);
+    }
+    if (src != end) {
+        return BAD_VALUE;
     }
     return OK;
 }
@@ -798,15 +819,34 @@ status_t MotionEvent::writeToParcel(Parcel* parcel) const {
         parcel->writeInt32(properties.toolType);
     }
 
-    const PointerCoords* pc = mSamplePointerCoords.data();
-    for (size_t h = 0; h < sampleCount; h++) {
-        parcel->writeInt64(mSampleEventTimes[h]);
-        for (size_t i = 0; i < pointerCount; i++) {
-            status_t status = (pc++)->writeToParcel(parcel);
-            if (status) {
-                return status;
-            }
-        }
+    // Write the sample data as two flat blocks rather than field by field: one bulk copy for the
+    // event times and one for the packed pointer coords. An event carrying a batch of historical
+    // MOVE samples would otherwise pay for hundreds of individual parcel writes, in every app
+    // process. A coord contributes its 'bits' followed by only the axis values present in it,
+    // which are already stored packed, so the wire size matches the old per-field format.
+    result = parcel->write(mSampleEventTimes.data(), sampleCount * sizeof(nsecs_t));
+    if (result != OK) {
+        return result;
+    }
+
+    const size_t coordsCount = sampleCount * pointerCount;
+    size_t coordsSize = 0;
+    for (size_t i = 0; i < coordsCount; i++) {
+        const PointerCoords& pc = mSamplePointerCoords[i];
+        coordsSize += sizeof(pc.bits) + BitSet64::count(pc.bits) * sizeof(float);
+    }
+    parcel->writeUint32(coordsSize);
+    uint8_t* dest = static_cast<uint8_t*>(parcel->writeInplace(coordsSize));
+    if (dest == nullptr) {
+        return NO_MEMORY;
+    }
+    for (size_t i = 0; i < coordsCount; i++) {
+        const PointerCoords& pc = mSamplePointerCoords[i];
+        memcpy(dest, &pc.bits, sizeof(pc.bits));
+        dest += sizeof(pc.bits);
+        const size_t valuesSize = BitSet64::count(pc.bits) * sizeof(float);
+        memcpy(dest, pc.values, valuesSize);
+        dest += valuesSize;
     }
     return OK;
 }
@@ -400,6 +400,62 @@ status_t InputChannel::sendMessage(const InputMessage* msg) {
     return OK;
 }
 
+status_t InputChannel::sendMessages(const InputMessage* msgs, size_t count, size_t* outSent) {
+    *outSent = 0;
+    std::vector<InputMessage> cleanMsgs(count);
+    std::vector<struct iovec> iovs(count);
+    std::vector<struct mmsghdr> headers(count);
+    for (size_t i = 0; i < count; i++) {
+        msgs[i].getSanitizedCopy(&cleanMsgs[i]);
+        iovs[i].iov_base = &cleanMsgs[i];
+        iovs[i].iov_len = msgs[i].size();
+        headers[i] = {};
+        headers[i].msg_hdr.msg_iov = &iovs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int nSent;
+    do {
+        nSent = ::sendmmsg(getFd(), headers.data(), count, MSG_DONTWAIT | MSG_NOSIGNAL);
+    } while (nSent == -1 && errno == EINTR);
+
+    if (nSent < 0) {
+        int error = errno;
+#if DEBUG_CHANNEL_MESSAGES
+        ALOGD("channel '%s' ~ error sending %zu messages, %s", mName.c_str(), count,
+              strerror(error));
+#endif
+        if (error == EAGAIN || error == EWOULDBLOCK) {
+            return WOULD_BLOCK;
+        }
+        if (error == EPIPE || error == ENOTCONN || error == ECONNREFUSED || error == ECONNRESET) {
+            return DEAD_OBJECT;
+        }
+        return -error;
+    }
+
+    *outSent = size_t(nSent);
+    for (size_t i = 0; i < size_t(nSent); i++) {
+        if (size_t(headers[i].msg_len) != iovs[i].iov_len) {
+#if DEBUG_CHANNEL_MESSAGES
+            ALOGD("channel '%s' ~ error sending message type %d, send was incomplete",
+                    mName.c_str(), msgs[i].header.type);
+#endif
+            return DEAD_OBJECT;
+        }
+    }
+
+    if (size_t(nSent) != count) {
+        // The kernel stopped early, most likely because the socket buffer filled up.
+        return WOULD_BLOCK;
+    }
+
+#if DEBUG_CHANNEL_MESSAGES
+    ALOGD("channel '%s' ~ sent %zu messages", mName.c_str(), count);
+#endif
+    return OK;
+}
+
 status_t InputChannel::receiveMessage(InputMessage* msg) {
     ssize_t nRead;
     do {
@@ -519,6 +575,12 @@ status_t InputPublisher::publishKeyEvent(uint32_t seq, int32_t eventId, int32_t
         return BAD_VALUE;
     }
 
+    // Key events must not overtake any batched move events.
+    status_t status = flushMotionEvents();
+    if (status != OK) {
+        return status;
+    }
+
     InputMessage msg;
     msg.header.type = InputMessage::Type::KEY;
     msg.header.seq = seq;
@@ -618,9 +680,39 @@ status_t InputPublisher::publishMotionEvent(
         msg.body.motion.pointers[i].coords.copyFrom(pointerCoords[i]);
     }
 
+    const int32_t actionMasked = action & AMOTION_EVENT_ACTION_MASK;
+    if (actionMasked == AMOTION_EVENT_ACTION_MOVE ||
+        actionMasked == AMOTION_EVENT_ACTION_HOVER_MOVE) {
+        // Accumulate consecutive move samples so that a burst from a high-rate device
+        // costs one syscall instead of one per sample. The consumer already batches and
+        // resamples move events, so receiving them in bursts is expected.
+        mPendingMotionMessages.push_back(msg);
+        if (mPendingMotionMessages.size() >= kMaxPendingMotionMessages) {
+            return flushMotionEvents();
+        }
+        return OK;
+    }
+
+    status_t status = flushMotionEvents();
+    if (status != OK) {
+        return status;
+    }
     return mChannel->sendMessage(&msg);
 }
 
+status_t InputPublisher::flushMotionEvents() {
+    if (mPendingMotionMessages.empty()) {
+        return OK;
+    }
+    size_t sent = 0;
+    const status_t status =
+            mChannel->sendMessages(mPendingMotionMessages.data(), mPendingMotionMessages.size(),
+                                   &sent);
+    mPendingMotionMessages.erase(mPendingMotionMessages.begin(),
+                                 mPendingMotionMessages.begin() + sent);
+    return status;
+}
+
 status_t InputPublisher::publishFocusEvent(uint32_t seq, int32_t eventId, bool hasFocus) {
     if (ATRACE_ENABLED()) {
         std::string message = StringPrintf("publishFocusEvent(inputChannel=%s, hasFocus=%s)",
@@ -628,6 +720,11 @@ status_t InputPublisher::publishFocusEvent(uint32_t seq, int32_t eventId, bool h
         ATRACE_NAME(message.c_str());
     }
 
+    status_t status = flushMotionEvents();
+    if (status != OK) {
+        return status;
+    }
+
     InputMessage msg;
     msg.header.type = InputMessage::Type::FOCUS;
     msg.header.seq = seq;
@@ -645,6 +742,11 @@ status_t InputPublisher::publishCaptureEvent(uint32_t seq, int32_t eventId,
         ATRACE_NAME(message.c_str());
     }
 
+    status_t status = flushMotionEvents();
+    if (status != OK) {
+        return status;
+    }
+
     InputMessage msg;
     msg.header.type = InputMessage::Type::CAPTURE;
     msg.header.seq = seq;
@@ -662,6 +764,11 @@ status_t InputPublisher::publishDragEvent(uint32_t seq, int32_t eventId, float x
         ATRACE_NAME(message.c_str());
     }
 
+    status_t status = flushMotionEvents();
+    if (status != OK) {
+        return status;
+    }
+
     InputMessage msg;
     msg.header.type = InputMessage::Type::DRAG;
     msg.header.seq = seq;
@@ -680,6 +787,11 @@ status_t InputPublisher::publishTouchModeEvent(uint32_t seq, int32_t eventId, bo
         ATRACE_NAME(message.c_str());
     }
 
+    status_t status = flushMotionEvents();
+    if (status != OK) {
+        return status;
+    }
+
     InputMessage msg;
     msg.header.type = InputMessage::Type::TOUCH_MODE;
     msg.header.seq = seq;
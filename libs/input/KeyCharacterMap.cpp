@@ -18,6 +18,10 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+
+#include <mutex>
+#include <unordered_map>
 
 #ifdef __linux__
 #include <binder/Parcel.h>
@@ -156,8 +160,37 @@ bool KeyCharacterMap::operator!=(const KeyCharacterMap& other) const {
     return !(*this == other);
 }
 
+/**
+ * Parsed files are kept in a process-wide cache so that adding many devices that share a map
+ * (most commonly Generic.kcm) only pays for tokenizing it once. Because callers may modify the
+ * returned map (e.g. via combine()), a cache hit returns a fresh deep copy of the parsed base
+ * rather than a shared instance. An entry is invalidated when the file it came from changes.
+ */
+struct CacheEntry {
+    std::shared_ptr<KeyCharacterMap> map;
+    struct timespec mtime;
+    off_t size;
+};
+
+static std::mutex gCacheLock;
+static std::unordered_map<std::string, CacheEntry> gCache; // guarded by gCacheLock
+
 base::Result<std::shared_ptr<KeyCharacterMap>> KeyCharacterMap::load(const std::string& filename,
                                                                      Format format) {
+    // The parse result depends on the requested format, so key the cache by both.
+    const std::string cacheKey = filename + '\0' + std::to_string(static_cast<int32_t>(format));
+    struct stat st;
+    const bool haveStat = (stat(filename.c_str(), &st) == 0);
+    if (haveStat) {
+        std::scoped_lock lock(gCacheLock);
+        const auto it = gCache.find(cacheKey);
+        if (it != gCache.end() && it->second.size == st.st_size &&
+            it->second.mtime.tv_sec == st.st_mtim.tv_sec &&
+            it->second.mtime.tv_nsec == st.st_mtim.tv_nsec) {
+            return std::make_shared<KeyCharacterMap>(*it->second.map);
+        }
+    }
+
     Tokenizer* tokenizer;
     status_t status = Tokenizer::open(String8(filename.c_str()), &tokenizer);
     if (status) {
@@ -172,6 +205,12 @@ base::Result<std::shared_ptr<KeyCharacterMap>> KeyCharacterMap::load(const std::
     std::unique_ptr<Tokenizer> t(tokenizer);
     status = map->load(t.get(), format);
     if (status == OK) {
+        if (haveStat) {
+            // Cache a private copy, since the caller is free to modify the map we return.
+            std::scoped_lock lock(gCacheLock);
+            gCache[cacheKey] =
+                    CacheEntry{std::make_shared<KeyCharacterMap>(*map), st.st_mtim, st.st_size};
+        }
         return map;
     }
     return Errorf("Load KeyCharacterMap failed {}.", status);
@@ -28,7 +28,11 @@
 #include <vintf/RuntimeInfo.h>
 #include <vintf/VintfObject.h>
 
+#include <sys/stat.h>
+
+#include <algorithm>
 #include <cstdlib>
+#include <mutex>
 #include <string_view>
 #include <unordered_map>
 
@@ -54,6 +58,10 @@ namespace {
 
 constexpr const char* WHITESPACE = " \t\r";
 
+// The largest scan code covered by the dense scan code lookup table. This matches KEY_MAX from
+// the kernel's input-event-codes.h, which bounds the scan codes emitted by evdev keyboards.
+constexpr int32_t MAX_DENSE_SCAN_CODE = 0x2ff;
+
 template <InputDeviceSensorType S>
 constexpr auto sensorPair() {
     return std::make_pair(ftl::enum_name<S>(), S);
@@ -111,8 +119,35 @@ base::Result<std::shared_ptr<KeyLayoutMap>> KeyLayoutMap::loadContents(const std
     return load(filename, contents);
 }
 
+/**
+ * Parsed layout files are kept in a process-wide cache so that adding many devices that share a
+ * layout (most commonly Generic.kl) only pays for tokenizing it once. A KeyLayoutMap is immutable
+ * after it has been loaded, so a cached instance can safely be shared between devices. An entry
+ * is invalidated when the file it came from changes.
+ */
+struct LayoutCacheEntry {
+    std::shared_ptr<KeyLayoutMap> map;
+    struct timespec mtime;
+    off_t size;
+};
+
+static std::mutex gCacheLock;
+static std::unordered_map<std::string, LayoutCacheEntry> gCache; // guarded by gCacheLock
+
 base::Result<std::shared_ptr<KeyLayoutMap>> KeyLayoutMap::load(const std::string& filename,
                                                                const char* contents) {
+    struct stat st;
+    const bool haveStat = contents == nullptr && stat(filename.c_str(), &st) == 0;
+    if (haveStat) {
+        std::scoped_lock lock(gCacheLock);
+        const auto it = gCache.find(filename);
+        if (it != gCache.end() && it->second.size == st.st_size &&
+            it->second.mtime.tv_sec == st.st_mtim.tv_sec &&
+            it->second.mtime.tv_nsec == st.st_mtim.tv_nsec) {
+            return it->second.map;
+        }
+    }
+
     Tokenizer* tokenizer;
     status_t status;
     if (contents == nullptr) {
@@ -136,6 +171,10 @@ base::Result<std::shared_ptr<KeyLayoutMap>> KeyLayoutMap::load(const std::string
         return Errorf("Missing kernel config");
     }
     map->mLoadFileName = filename;
+    if (haveStat) {
+        std::scoped_lock lock(gCacheLock);
+        gCache[filename] = LayoutCacheEntry{map, st.st_mtim, st.st_size};
+    }
     return ret;
 }
 
@@ -158,6 +197,7 @@ base::Result<std::shared_ptr<KeyLayoutMap>> KeyLayoutMap::load(Tokenizer* tokeni
               elapsedTime / 1000000.0);
 #endif
         if (!status) {
+            map->buildKeyIndexByScanCode();
             return std::move(map);
         }
     }
@@ -197,14 +237,40 @@ base::Result<std::pair<InputDeviceSensorType, int32_t>> KeyLayoutMap::mapSensor(
     return std::make_pair(sensor.sensorType, sensor.sensorDataIndex);
 }
 
+// Builds the dense scan-code-indexed lookup table once the map has been fully parsed.
+// Key events arrive in bursts (a gaming keyboard rollover produces many at once), and this turns
+// the per-event scan code lookup into a single array load instead of a binary search.
+void KeyLayoutMap::buildKeyIndexByScanCode() {
+    int32_t maxScanCode = -1;
+    for (size_t i = 0; i < mKeysByScanCode.size(); i++) {
+        const int32_t scanCode = mKeysByScanCode.keyAt(i);
+        // Layouts occasionally map codes outside the usual kernel range (KEY_MAX); leave those to
+        // the binary search fallback rather than growing the table to cover outliers.
+        if (scanCode >= 0 && scanCode <= MAX_DENSE_SCAN_CODE) {
+            maxScanCode = std::max(maxScanCode, scanCode);
+        }
+    }
+    mKeyIndexByScanCode.assign(size_t(maxScanCode + 1), -1);
+    for (size_t i = 0; i < mKeysByScanCode.size(); i++) {
+        const int32_t scanCode = mKeysByScanCode.keyAt(i);
+        if (scanCode >= 0 && scanCode <= maxScanCode) {
+            mKeyIndexByScanCode[size_t(scanCode)] = ssize_t(i);
+        }
+    }
+}
+
 const KeyLayoutMap::Key* KeyLayoutMap::getKey(int32_t scanCode, int32_t usageCode) const {
     if (usageCode) {
-        ssize_t index = mKeysByUsageCode.indexOfKey(usageCode);
-        if (index >= 0) {
-            return &mKeysByUsageCode.valueAt(index);
+        const auto it = mKeysByUsageCode.find(usageCode);
+        if (it != mKeysByUsageCode.end()) {
+            return &it->second;
         }
     }
     if (scanCode) {
+        if (scanCode >= 0 && size_t(scanCode) < mKeyIndexByScanCode.size()) {
+            const ssize_t index = mKeyIndexByScanCode[size_t(scanCode)];
+            return index >= 0 ? &mKeysByScanCode.valueAt(index) : nullptr;
+        }
         ssize_t index = mKeysByScanCode.indexOfKey(scanCode);
         if (index >= 0) {
             return &mKeysByScanCode.valueAt(index);
@@ -345,8 +411,10 @@ status_t KeyLayoutMap::Parser::parseKey() {
                 mapUsage ? "usage" : "scan code", codeToken.string());
         return BAD_VALUE;
     }
-    KeyedVector<int32_t, Key>& map = mapUsage ? mMap->mKeysByUsageCode : mMap->mKeysByScanCode;
-    if (map.indexOfKey(code) >= 0) {
+    const bool duplicate = mapUsage
+            ? mMap->mKeysByUsageCode.find(code) != mMap->mKeysByUsageCode.end()
+            : mMap->mKeysByScanCode.indexOfKey(code) >= 0;
+    if (duplicate) {
         ALOGE("%s: Duplicate entry for key %s '%s'.", mTokenizer->getLocation().string(),
                 mapUsage ? "usage" : "scan code", codeToken.string());
         return BAD_VALUE;
@@ -387,7 +455,11 @@ status_t KeyLayoutMap::Parser::parseKey() {
     Key key;
     key.keyCode = keyCode;
     key.flags = flags;
-    map.add(code, key);
+    if (mapUsage) {
+        mMap->mKeysByUsageCode.emplace(code, key);
+    } else {
+        mMap->mKeysByScanCode.add(code, key);
+    }
     return NO_ERROR;
 }
 
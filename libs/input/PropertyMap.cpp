@@ -18,6 +18,11 @@
 
 #include <input/PropertyMap.h>
 
+#include <sys/stat.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 // Enables debug output for the parser.
 #define DEBUG_PARSER 0
 
@@ -137,6 +142,53 @@ android::base::Result<std::unique_ptr<PropertyMap>> PropertyMap::load(const char
     return std::move(outMap);
 }
 
+namespace {
+
+// A parsed property file, tagged with the file attributes it was parsed from so that a changed
+// file is not served stale. The cache never shrinks, but it holds at most one entry per distinct
+// configuration file path on the device.
+struct CachedPropertyMap {
+    timespec mtime;
+    off_t size;
+    std::shared_ptr<const PropertyMap> map;
+};
+
+std::mutex gCacheMutex;
+std::unordered_map<std::string, CachedPropertyMap>& cachedPropertyMaps() {
+    static auto& cache = *new std::unordered_map<std::string, CachedPropertyMap>();
+    return cache;
+}
+
+} // namespace
+
+android::base::Result<std::shared_ptr<const PropertyMap>> PropertyMap::loadShared(
+        const char* filename) {
+    struct stat st;
+    const bool statOk = stat(filename, &st) == 0;
+    if (statOk) {
+        std::scoped_lock _l(gCacheMutex);
+        auto it = cachedPropertyMaps().find(filename);
+        if (it != cachedPropertyMaps().end() && it->second.size == st.st_size &&
+            it->second.mtime.tv_sec == st.st_mtim.tv_sec &&
+            it->second.mtime.tv_nsec == st.st_mtim.tv_nsec) {
+            return it->second.map;
+        }
+    }
+
+    android::base::Result<std::unique_ptr<PropertyMap>> map = load(filename);
+    if (!map.ok()) {
+        return map.error();
+    }
+    std::shared_ptr<const PropertyMap> sharedMap = std::move(*map);
+    if (statOk) {
+        // Tag the entry with the attributes observed before parsing: if the file was replaced
+        // while it was being parsed, the next lookup will miss and parse it again.
+        std::scoped_lock _l(gCacheMutex);
+        cachedPropertyMaps()[filename] = CachedPropertyMap{st.st_mtim, st.st_size, sharedMap};
+    }
+    return sharedMap;
+}
+
 // --- PropertyMap::Parser ---
 
 PropertyMap::Parser::Parser(PropertyMap* map, Tokenizer* tokenizer)
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <input/VelocityTracker.h>
+
+namespace android {
+
+constexpr uint32_t POINTER_ID = 0;
+
+// A typical fling: a stream of move samples at roughly the touch scan rate, curving slightly
+// so that the quadratic term of the fit is exercised.
+static void addFlingMovements(VelocityTracker& tracker, nsecs_t startTime, size_t count) {
+    BitSet32 idBits;
+    idBits.markBit(POINTER_ID);
+    for (size_t i = 0; i < count; i++) {
+        const nsecs_t eventTime = startTime + i * 8'000'000; // 8 ms between samples
+        const float t = i * 0.008f;
+        std::vector<VelocityTracker::Position> positions = {
+                {100 + 1000 * t + 300 * t * t, 200 + 800 * t}};
+        tracker.addMovement(eventTime, idBits, positions);
+    }
+}
+
+static void benchmarkAddMovement(benchmark::State& state) {
+    const auto strategy = static_cast<VelocityTracker::Strategy>(state.range(0));
+    VelocityTracker tracker(strategy);
+    BitSet32 idBits;
+    idBits.markBit(POINTER_ID);
+    std::vector<VelocityTracker::Position> positions = {{100, 200}};
+    nsecs_t eventTime = 0;
+    for (auto _ : state) {
+        eventTime += 8'000'000;
+        positions[0].x += 8;
+        positions[0].y += 6;
+        tracker.addMovement(eventTime, idBits, positions);
+    }
+}
+
+static void benchmarkGetVelocity(benchmark::State& state) {
+    const auto strategy = static_cast<VelocityTracker::Strategy>(state.range(0));
+    VelocityTracker tracker(strategy);
+    addFlingMovements(tracker, 0 /*startTime*/, 20 /*count*/);
+    for (auto _ : state) {
+        float vx, vy;
+        tracker.getVelocity(POINTER_ID, &vx, &vy);
+        benchmark::DoNotOptimize(vx);
+        benchmark::DoNotOptimize(vy);
+    }
+}
+
+BENCHMARK(benchmarkAddMovement)
+        ->Arg(static_cast<int32_t>(VelocityTracker::Strategy::LSQ2))
+        ->Arg(static_cast<int32_t>(VelocityTracker::Strategy::LSQ3))
+        ->Arg(static_cast<int32_t>(VelocityTracker::Strategy::IMPULSE));
+BENCHMARK(benchmarkGetVelocity)
+        ->Arg(static_cast<int32_t>(VelocityTracker::Strategy::LSQ2))
+        ->Arg(static_cast<int32_t>(VelocityTracker::Strategy::LSQ3))
+        ->Arg(static_cast<int32_t>(VelocityTracker::Strategy::IMPULSE));
+
+} // namespace android
+
+BENCHMARK_MAIN();
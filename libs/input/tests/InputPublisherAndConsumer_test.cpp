@@ -204,6 +204,10 @@ void InputPublisherAndConsumerTest::PublishAndConsumeMotionEvent() {
     ASSERT_EQ(OK, status)
             << "publisher publishMotionEvent should return OK";
 
+    status = mPublisher->flushMotionEvents();
+    ASSERT_EQ(OK, status)
+            << "publisher flushMotionEvents should return OK";
+
     uint32_t consumeSeq;
     InputEvent* event;
     status = mConsumer->consume(&mEventFactory, true /*consumeBatches*/, -1, &consumeSeq, &event);
@@ -489,6 +493,45 @@ TEST_F(InputPublisherAndConsumerTest, PublishTouchModeEvent_EndToEnd) {
     ASSERT_NO_FATAL_FAILURE(PublishAndConsumeTouchModeEvent());
 }
 
+TEST_F(InputPublisherAndConsumerTest, PublishMotionMoveEvent_IsNotSentUntilFlushed) {
+    status_t status;
+    const size_t pointerCount = 1;
+    PointerProperties pointerProperties[pointerCount];
+    PointerCoords pointerCoords[pointerCount];
+    for (size_t i = 0; i < pointerCount; i++) {
+        pointerProperties[i].clear();
+        pointerCoords[i].clear();
+    }
+
+    constexpr uint32_t seq = 15;
+    ui::Transform identityTransform;
+    status = mPublisher->publishMotionEvent(seq, InputEvent::nextId(), 1, AINPUT_SOURCE_TOUCHSCREEN,
+                                            ADISPLAY_ID_DEFAULT, INVALID_HMAC,
+                                            AMOTION_EVENT_ACTION_MOVE, 0, 0, 0, 0, 0,
+                                            MotionClassification::NONE, identityTransform, 0, 0,
+                                            AMOTION_EVENT_INVALID_CURSOR_POSITION,
+                                            AMOTION_EVENT_INVALID_CURSOR_POSITION,
+                                            identityTransform, 0, 0, pointerCount,
+                                            pointerProperties, pointerCoords);
+    ASSERT_EQ(OK, status) << "publisher publishMotionEvent should return OK";
+
+    uint32_t consumeSeq;
+    InputEvent* event;
+    status = mConsumer->consume(&mEventFactory, true /*consumeBatches*/, -1, &consumeSeq, &event);
+    ASSERT_EQ(WOULD_BLOCK, status)
+            << "consumer should not see the move event until the publisher flushes";
+
+    status = mPublisher->flushMotionEvents();
+    ASSERT_EQ(OK, status) << "publisher flushMotionEvents should return OK";
+
+    status = mConsumer->consume(&mEventFactory, true /*consumeBatches*/, -1, &consumeSeq, &event);
+    ASSERT_EQ(OK, status) << "consumer consume should return OK after the flush";
+    ASSERT_TRUE(event != nullptr) << "consumer should have returned non-NULL event";
+    ASSERT_EQ(AINPUT_EVENT_TYPE_MOTION, event->getType())
+            << "consumer should have returned a motion event";
+    EXPECT_EQ(seq, consumeSeq);
+}
+
 TEST_F(InputPublisherAndConsumerTest, PublishMotionEvent_WhenSequenceNumberIsZero_ReturnsError) {
     status_t status;
     const size_t pointerCount = 1;
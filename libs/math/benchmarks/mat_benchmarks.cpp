@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <math/mat4.h>
+#include <math/vec4.h>
+
+namespace android {
+
+namespace {
+
+// A full (non-affine, non-identity) matrix so no term of the product folds away.
+mat4 makeFullMatrix(float seed) {
+    mat4 m(mat4::NO_INIT);
+    float v = seed;
+    for (size_t col = 0; col < 4; ++col) {
+        for (size_t row = 0; row < 4; ++row) {
+            m[col][row] = v;
+            v = v * 1.37f + 0.13f;
+        }
+    }
+    return m;
+}
+
+} // namespace
+
+// mat4 * mat4, the shape of transform concatenation and color matrix composition.
+static void benchmarkMat4Multiply(benchmark::State& state) {
+    const mat4 lhs = makeFullMatrix(0.31f);
+    mat4 rhs = makeFullMatrix(0.73f);
+    for (auto _ : state) {
+        rhs = lhs * rhs;
+        benchmark::DoNotOptimize(rhs);
+    }
+}
+BENCHMARK(benchmarkMat4Multiply);
+
+// mat4 * vec4, the per-vertex/per-corner transform.
+static void benchmarkMat4TransformVec4(benchmark::State& state) {
+    const mat4 m = makeFullMatrix(0.31f);
+    vec4 v(0.25f, 0.5f, 0.75f, 1.0f);
+    for (auto _ : state) {
+        v = m * v;
+        benchmark::DoNotOptimize(v);
+    }
+}
+BENCHMARK(benchmarkMat4TransformVec4);
+
+static void benchmarkMat4Inverse(benchmark::State& state) {
+    // makeFullMatrix() yields a singular-ish matrix; perturb the diagonal to keep it invertible.
+    mat4 m = makeFullMatrix(0.31f) + mat4(vec4(5, 7, 11, 13));
+    for (auto _ : state) {
+        mat4 inv = inverse(m);
+        benchmark::DoNotOptimize(inv);
+    }
+}
+BENCHMARK(benchmarkMat4Inverse);
+
+static void benchmarkMat4dInverse(benchmark::State& state) {
+    // The double path still goes through gaussJordanInverse(), for comparison.
+    mat4d m(mat4d::NO_INIT);
+    double v = 0.31;
+    for (size_t col = 0; col < 4; ++col) {
+        for (size_t row = 0; row < 4; ++row) {
+            m[col][row] = v + (col == row ? 7.0 : 0.0);
+            v = v * 1.37 + 0.13;
+        }
+    }
+    for (auto _ : state) {
+        mat4d inv = inverse(m);
+        benchmark::DoNotOptimize(inv);
+    }
+}
+BENCHMARK(benchmarkMat4dInverse);
+
+} // namespace android
+
+BENCHMARK_MAIN();
@@ -24,6 +24,7 @@
 #include <exception>
 #include <iomanip>
 #include <stdexcept>
+#include <type_traits>
 
 #include <math/quat.h>
 #include <math/TVecHelpers.h>
@@ -74,6 +75,48 @@ inline constexpr int     trace(int v)    { return v; }
 inline constexpr float   trace(float v)  { return v; }
 inline constexpr double  trace(double v) { return v; }
 
+/*
+ * 4x4 float fast paths
+ *
+ * mat4/vec4 of float are hot in composition: every layer's transform and color matrix goes
+ * through them each frame. The kernels below are written with GCC/clang vector extensions,
+ * which the compiler lowers to NEON on arm/arm64 and SSE on x86, so there are no
+ * per-architecture intrinsics to maintain. They are used at runtime only; constant evaluation
+ * falls through to the generic scalar loops.
+ */
+#if __cplusplus >= 201703L && (defined(__ARM_NEON) || defined(__SSE2__)) && defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define TMAT_FLOAT4_SIMD 1
+#endif
+#endif
+
+#ifdef TMAT_FLOAT4_SIMD
+typedef float float4 __attribute__((vector_size(16)));
+
+inline float4 loadFloat4(const float* p) {
+    float4 v;
+    __builtin_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline void storeFloat4(float* p, float4 v) {
+    __builtin_memcpy(p, &v, sizeof(v));
+}
+
+inline float4 splatFloat4(float s) {
+    return float4{ s, s, s, s };
+}
+
+// Returns m * v for a column-major 4x4 float matrix: a linear combination of the columns of m
+// scaled by the components of v, i.e. four broadcast multiply-adds on whole columns.
+inline float4 PURE transformFloat4(const float* m, float4 v) {
+    return loadFloat4(m +  0) * splatFloat4(v[0]) +
+           loadFloat4(m +  4) * splatFloat4(v[1]) +
+           loadFloat4(m +  8) * splatFloat4(v[2]) +
+           loadFloat4(m + 12) * splatFloat4(v[3]);
+}
+#endif  // TMAT_FLOAT4_SIMD
+
 /*
  * Matrix inversion
  */
@@ -224,6 +267,65 @@ CONSTEXPR MATRIX PURE fastInverse3(const MATRIX& x) {
     return inverted;
 }
 
+//------------------------------------------------------------------------------
+// 4x4 inverse via the adjugate, built from the 2x2 sub-determinants of the top
+// and bottom halves of the matrix. Unlike gaussJordanInverse() there is no
+// pivot search, so the code is branch-free and the independent sub-determinants
+// leave the compiler free to vectorize.
+template <typename MATRIX>
+MATRIX PURE fastInverse4(const MATRIX& x) {
+    typedef typename MATRIX::value_type T;
+
+    // Importantly, our matrices are column-major: x[col][row] is element (row, col).
+    const T m00 = x[0][0], m10 = x[0][1], m20 = x[0][2], m30 = x[0][3];
+    const T m01 = x[1][0], m11 = x[1][1], m21 = x[1][2], m31 = x[1][3];
+    const T m02 = x[2][0], m12 = x[2][1], m22 = x[2][2], m32 = x[2][3];
+    const T m03 = x[3][0], m13 = x[3][1], m23 = x[3][2], m33 = x[3][3];
+
+    // 2x2 sub-determinants of rows (0,1) and rows (2,3).
+    const T s0 = m00 * m11 - m10 * m01;
+    const T s1 = m00 * m12 - m10 * m02;
+    const T s2 = m00 * m13 - m10 * m03;
+    const T s3 = m01 * m12 - m11 * m02;
+    const T s4 = m01 * m13 - m11 * m03;
+    const T s5 = m02 * m13 - m12 * m03;
+
+    const T c0 = m20 * m31 - m30 * m21;
+    const T c1 = m20 * m32 - m30 * m22;
+    const T c2 = m20 * m33 - m30 * m23;
+    const T c3 = m21 * m32 - m31 * m22;
+    const T c4 = m21 * m33 - m31 * m23;
+    const T c5 = m22 * m33 - m32 * m23;
+
+    // Laplace expansion along the first two rows.
+    const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    const T invDet = T(1) / det;
+
+    MATRIX inverted(MATRIX::NO_INIT);
+
+    inverted[0][0] = ( m11 * c5 - m12 * c4 + m13 * c3) * invDet;
+    inverted[1][0] = (-m01 * c5 + m02 * c4 - m03 * c3) * invDet;
+    inverted[2][0] = ( m31 * s5 - m32 * s4 + m33 * s3) * invDet;
+    inverted[3][0] = (-m21 * s5 + m22 * s4 - m23 * s3) * invDet;
+
+    inverted[0][1] = (-m10 * c5 + m12 * c2 - m13 * c1) * invDet;
+    inverted[1][1] = ( m00 * c5 - m02 * c2 + m03 * c1) * invDet;
+    inverted[2][1] = (-m30 * s5 + m32 * s2 - m33 * s1) * invDet;
+    inverted[3][1] = ( m20 * s5 - m22 * s2 + m23 * s1) * invDet;
+
+    inverted[0][2] = ( m10 * c4 - m11 * c2 + m13 * c0) * invDet;
+    inverted[1][2] = (-m00 * c4 + m01 * c2 - m03 * c0) * invDet;
+    inverted[2][2] = ( m30 * s4 - m31 * s2 + m33 * s0) * invDet;
+    inverted[3][2] = (-m20 * s4 + m21 * s2 - m23 * s0) * invDet;
+
+    inverted[0][3] = (-m10 * c3 + m11 * c1 - m12 * c0) * invDet;
+    inverted[1][3] = ( m00 * c3 - m01 * c1 + m02 * c0) * invDet;
+    inverted[2][3] = (-m30 * s3 + m31 * s1 - m32 * s0) * invDet;
+    inverted[3][3] = ( m20 * s3 - m21 * s1 + m22 * s0) * invDet;
+
+    return inverted;
+}
+
 /**
  * Inversion function which switches on the matrix size.
  * @warning This function assumes the matrix is invertible. The result is
@@ -233,6 +335,13 @@ CONSTEXPR MATRIX PURE fastInverse3(const MATRIX& x) {
 template <typename MATRIX>
 inline constexpr MATRIX PURE inverse(const MATRIX& matrix) {
     static_assert(MATRIX::NUM_ROWS == MATRIX::NUM_COLS, "only square matrices can be inverted");
+#ifdef TMAT_FLOAT4_SIMD
+    if constexpr (MATRIX::NUM_ROWS == 4 && std::is_same_v<typename MATRIX::value_type, float>) {
+        if (!__builtin_is_constant_evaluated()) {
+            return fastInverse4<MATRIX>(matrix);
+        }
+    }
+#endif
     return (MATRIX::NUM_ROWS == 2) ? fastInverse2<MATRIX>(matrix) :
           ((MATRIX::NUM_ROWS == 3) ? fastInverse3<MATRIX>(matrix) :
                     gaussJordanInverse<MATRIX>(matrix));
@@ -253,6 +362,22 @@ CONSTEXPR MATRIX_R PURE multiply(const MATRIX_A& lhs, const MATRIX_B& rhs) {
             "invalid dimension of matrix multiply result.");
 
     MATRIX_R res(MATRIX_R::NO_INIT);
+#ifdef TMAT_FLOAT4_SIMD
+    if constexpr (MATRIX_R::NUM_ROWS == 4 && MATRIX_R::NUM_COLS == 4 &&
+                  MATRIX_A::NUM_ROWS == 4 && MATRIX_A::NUM_COLS == 4 &&
+                  std::is_same_v<typename MATRIX_R::value_type, float> &&
+                  std::is_same_v<typename MATRIX_A::value_type, float> &&
+                  std::is_same_v<typename MATRIX_B::value_type, float>) {
+        if (!__builtin_is_constant_evaluated()) {
+            // Transforming every result column with the same lhs pointer lets the compiler keep
+            // the four columns of lhs in vector registers across the whole product.
+            for (size_t col = 0; col < 4; ++col) {
+                storeFloat4(&res[col][0], transformFloat4(&lhs[0][0], loadFloat4(&rhs[col][0])));
+            }
+            return res;
+        }
+    }
+#endif
     for (size_t col = 0; col < MATRIX_R::NUM_COLS; ++col) {
         res[col] = lhs * rhs[col];
     }
@@ -116,9 +116,12 @@ private:
      *  COL_SIZE = M
      *  ROW_SIZE = N
      *  m[0] = [ a[0][0] a[0][1] a[0][2] ... a[0][M] ]
+     *
+     *  The storage is 16-byte aligned so the 4x4 float fast paths in
+     *  TMatHelpers.h read and write whole columns as aligned 128-bit vectors.
      */
 
-    col_type m_value[NUM_COLS];
+    alignas(16) col_type m_value[NUM_COLS];
 
 public:
     // array access
@@ -522,6 +525,16 @@ CONSTEXPR TMat44<T> TMat44<T>::lookAt(const TVec3<A>& eye, const TVec3<B>& cente
 // matrix * column-vector, result is a vector of the same type than the input vector
 template <typename T, typename U>
 CONSTEXPR typename TMat44<T>::col_type PURE operator *(const TMat44<T>& lhs, const TVec4<U>& rhs) {
+#ifdef TMAT_FLOAT4_SIMD
+    if constexpr (std::is_same_v<T, float> && std::is_same_v<U, float>) {
+        if (!__builtin_is_constant_evaluated()) {
+            typename TMat44<T>::col_type result(TMat44<T>::col_type::NO_INIT);
+            matrix::storeFloat4(&result[0],
+                                matrix::transformFloat4(&lhs[0][0], matrix::loadFloat4(&rhs[0])));
+            return result;
+        }
+    }
+#endif
     // Result is initialized to zero.
     typename TMat44<T>::col_type result;
     for (size_t col = 0; col < TMat44<T>::NUM_COLS; ++col) {
@@ -150,6 +150,25 @@ TEST_F(MatTest, MiscOps) {
     }
 }
 
+TEST_F(MatTest, Multiply) {
+    // The float products take the vectorized fast path on NEON/SSE builds; check them against
+    // the generic scalar code, which is still what the double instantiation uses.
+    mat4 m1(vec4(1, 2, 3, 4), vec4(5, 6, 7, 8), vec4(9, 10, 11, 12), vec4(13, 14, 15, 16));
+    mat4 m2(vec4(2, 3, 5, 7), vec4(11, 13, 17, 19), vec4(23, 29, 31, 37), vec4(41, 43, 47, 53));
+    mat4 p = m1 * m2;
+    mat4d pd = mat4d(m1) * mat4d(m2);
+    for (size_t c = 0; c < 4; c++) {
+        for (size_t r = 0; r < 4; r++) {
+            EXPECT_FLOAT_EQ(static_cast<float>(pd[c][r]), p[c][r]);
+        }
+    }
+
+    vec4 v = m1 * vec4(2, 3, 5, 7);
+    for (size_t r = 0; r < 4; r++) {
+        EXPECT_FLOAT_EQ(2 * m1[0][r] + 3 * m1[1][r] + 5 * m1[2][r] + 7 * m1[3][r], v[r]);
+    }
+}
+
 TEST_F(MatTest, ElementAccess) {
     mat4 m(vec4(1, 2, 3, 4), vec4(5, 6, 7, 8), vec4(9, 10, 11, 12), vec4(13, 14, 15, 16));
     for (size_t c=0 ; c<4 ; c++) {
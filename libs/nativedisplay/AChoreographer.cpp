@@ -16,10 +16,12 @@
 
 #define LOG_TAG "Choreographer"
 //#define LOG_NDEBUG 0
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
 
 #include <android-base/thread_annotations.h>
 #include <gui/DisplayEventDispatcher.h>
 #include <gui/ISurfaceComposer.h>
+#include <gui/TraceUtils.h>
 #include <jni.h>
 #include <private/android/choreographer.h>
 #include <utils/Looper.h>
@@ -81,11 +83,20 @@ struct FrameCallback {
     AChoreographer_vsyncCallback vsyncCallback;
     void* data;
     nsecs_t dueTime;
+    // Minimum interval between dispatches of this (callback, data) pair, or 0
+    // to dispatch on every requested vsync.
+    nsecs_t minDispatchInterval;
+    // Registration sequence number, used to keep dispatch of callbacks that
+    // become due on the same vsync in registration order.
+    uint64_t id;
 
     inline bool operator<(const FrameCallback& rhs) const {
         // Note that this is intentionally flipped because we want callbacks due sooner to be at
         // the head of the queue
-        return dueTime > rhs.dueTime;
+        if (dueTime != rhs.dueTime) {
+            return dueTime > rhs.dueTime;
+        }
+        return id > rhs.id;
     }
 };
 
@@ -123,7 +134,7 @@ public:
     void postFrameCallbackDelayed(AChoreographer_frameCallback cb,
                                   AChoreographer_frameCallback64 cb64,
                                   AChoreographer_vsyncCallback vsyncCallback, void* data,
-                                  nsecs_t delay);
+                                  nsecs_t delay, nsecs_t minDispatchInterval = 0);
     void registerRefreshRateCallback(AChoreographer_refreshRateCallback cb, void* data)
             EXCLUDES(gChoreographers.lock);
     void unregisterRefreshRateCallback(AChoreographer_refreshRateCallback cb, void* data);
@@ -167,6 +178,11 @@ private:
     // Protected by mLock
     std::priority_queue<FrameCallback> mFrameCallbacks;
     std::vector<RefreshRateCallback> mRefreshRateCallbacks;
+    uint64_t mNextCallbackId GUARDED_BY(mLock) = 0;
+    // Last dispatch time for rate-limited (callback, data) pairs, so that a
+    // repost from within a callback is scheduled one interval after the
+    // previous dispatch instead of on the next vsync.
+    std::map<std::pair<void*, void*>, nsecs_t> mLastRateLimitedDispatch GUARDED_BY(mLock);
 
     nsecs_t mLatestVsyncPeriod = -1;
     VsyncEventData mLastVsyncEventData;
@@ -177,6 +193,9 @@ private:
 
     // Approximation of num_threads_using_choreographer * num_frames_of_history with leeway.
     static constexpr size_t kMaxStartTimes = 250;
+
+    // Bound on the number of distinct rate-limited (callback, data) pairs tracked.
+    static constexpr size_t kMaxRateLimitedDispatchTimes = 64;
 };
 
 static thread_local Choreographer* gChoreographer;
@@ -236,11 +255,22 @@ Choreographer::~Choreographer() {
 void Choreographer::postFrameCallbackDelayed(AChoreographer_frameCallback cb,
                                              AChoreographer_frameCallback64 cb64,
                                              AChoreographer_vsyncCallback vsyncCallback, void* data,
-                                             nsecs_t delay) {
+                                             nsecs_t delay, nsecs_t minDispatchInterval) {
     nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
-    FrameCallback callback{cb, cb64, vsyncCallback, data, now + delay};
+    FrameCallback callback{cb, cb64, vsyncCallback, data, now + delay, minDispatchInterval, 0};
     {
         std::lock_guard<std::mutex> _l{mLock};
+        if (minDispatchInterval > 0) {
+            // Don't come due (and wake for a vsync) before one interval has
+            // elapsed since the last dispatch of this (callback, data) pair.
+            const auto it = mLastRateLimitedDispatch.find(std::make_pair(
+                    reinterpret_cast<void*>(vsyncCallback), data));
+            if (it != mLastRateLimitedDispatch.end() &&
+                it->second + minDispatchInterval > callback.dueTime) {
+                callback.dueTime = it->second + minDispatchInterval;
+            }
+        }
+        callback.id = mNextCallbackId++;
         mFrameCallbacks.push(callback);
     }
     if (callback.dueTime <= now) {
@@ -257,7 +287,7 @@ void Choreographer::postFrameCallbackDelayed(AChoreographer_frameCallback cb,
     } else {
         if (mLooper != nullptr) {
             Message m{MSG_SCHEDULE_CALLBACKS};
-            mLooper->sendMessageDelayed(delay, this, m);
+            mLooper->sendMessageDelayed(callback.dueTime - now, this, m);
         } else {
             scheduleCallbacks();
         }
@@ -391,10 +421,20 @@ void Choreographer::dispatchVsync(nsecs_t timestamp, PhysicalDisplayId, uint32_t
             callbacks.push_back(mFrameCallbacks.top());
             mFrameCallbacks.pop();
         }
+        for (const auto& cb : callbacks) {
+            if (cb.minDispatchInterval > 0) {
+                while (mLastRateLimitedDispatch.size() >= kMaxRateLimitedDispatchTimes) {
+                    mLastRateLimitedDispatch.erase(mLastRateLimitedDispatch.begin());
+                }
+                mLastRateLimitedDispatch[std::make_pair(reinterpret_cast<void*>(cb.vsyncCallback),
+                                                        cb.data)] = now;
+            }
+        }
     }
     mLastVsyncEventData = vsyncEventData;
     for (const auto& cb : callbacks) {
         if (cb.vsyncCallback != nullptr) {
+            ATRACE_FORMAT("AChoreographer: vsyncCallback %p", cb.vsyncCallback);
             const ChoreographerFrameCallbackDataImpl frameCallbackData =
                     createFrameCallbackData(timestamp);
             registerStartTime();
@@ -404,8 +444,10 @@ void Choreographer::dispatchVsync(nsecs_t timestamp, PhysicalDisplayId, uint32_t
                              cb.data);
             mInCallback = false;
         } else if (cb.callback64 != nullptr) {
+            ATRACE_FORMAT("AChoreographer: frameCallback64 %p", cb.callback64);
             cb.callback64(timestamp, cb.data);
         } else if (cb.callback != nullptr) {
+            ATRACE_FORMAT("AChoreographer: frameCallback %p", cb.callback);
             cb.callback(timestamp, cb.data);
         }
     }
@@ -582,6 +624,14 @@ int64_t AChoreographer_getFrameInterval(const AChoreographer* choreographer) {
     return AChoreographer_to_Choreographer(choreographer)->getFrameInterval();
 }
 
+void AChoreographer_postVsyncCallbackAtRate(AChoreographer* choreographer,
+                                            AChoreographer_vsyncCallback callback, void* data,
+                                            int64_t minDispatchIntervalNanos) {
+    AChoreographer_to_Choreographer(choreographer)
+            ->postFrameCallbackDelayed(nullptr, nullptr, callback, data, 0,
+                                       minDispatchIntervalNanos);
+}
+
 int64_t AChoreographer_getStartTimeNanosForVsyncId(AVsyncId vsyncId) {
     std::scoped_lock _l(gChoreographers.lock);
     const auto iter = gChoreographers.startTimes.find(vsyncId);
@@ -34,6 +34,15 @@ void AChoreographer_signalRefreshRateCallbacks(int64_t vsyncPeriod);
 // Calling this function from anywhere else will return an undefined value.
 int64_t AChoreographer_getFrameInterval(const AChoreographer* choreographer);
 
+// Posts a vsync callback that will not be dispatched sooner than
+// minDispatchIntervalNanos after the previous dispatch of the same (callback, data)
+// pair. Clients that run below the display refresh rate (e.g. a 30fps animation on
+// a 120Hz display) should repost through this function so the choreographer
+// doesn't request - and wake for - vsyncs that would be dropped anyway.
+void AChoreographer_postVsyncCallbackAtRate(AChoreographer* choreographer,
+                                            AChoreographer_vsyncCallback callback, void* data,
+                                            int64_t minDispatchIntervalNanos);
+
 // Trampoline functions allowing libandroid.so to define the NDK symbols without including
 // the entirety of libnativedisplay as a whole static lib. As libnativedisplay
 // maintains global state, libnativedisplay can never be directly statically
@@ -43,8 +43,13 @@ public:
      * target texture belongs is bound to the calling thread.
      *
      * This calls doGLFenceWait to ensure proper synchronization.
+     *
+     * When callerOwnsContext is true, the caller declares that the context
+     * this consumer is attached to is current on the calling thread, and the
+     * per-call EGL current-state queries and validation are skipped once the
+     * attached display/context have been latched by a prior full update.
      */
-    status_t updateTexImage(SurfaceTexture& st);
+    status_t updateTexImage(SurfaceTexture& st, bool callerOwnsContext = false);
 
     /*
      * releaseTexImage releases the texture acquired in updateTexImage().
@@ -134,16 +139,20 @@ protected:
      * which would have been passed to releaseBufferLocked upon the successful
      * completion of the method will instead be returned to the caller, so that
      * it may call releaseBufferLocked itself later.
+     * When callerOwnsContext is true the EGL current-state confirmation is
+     * skipped; see updateTexImage.
      */
     status_t updateAndReleaseLocked(const BufferItem& item, PendingRelease* pendingRelease,
-                                    SurfaceTexture& st);
+                                    SurfaceTexture& st, bool callerOwnsContext = false);
 
     /**
      * Binds mTexName and the current buffer to mTexTarget.  Uses
      * mCurrentTexture if it's set, mCurrentTextureImage if not.  If the
      * bind succeeds, this calls doGLFenceWait.
+     * When callerOwnsContext is true the EGL current-state validation in the
+     * fence wait is skipped; see updateTexImage.
      */
-    status_t bindTextureImageLocked(SurfaceTexture& st);
+    status_t bindTextureImageLocked(SurfaceTexture& st, bool callerOwnsContext = false);
 
     /**
      * Gets the current EGLDisplay and EGLContext values, and compares them
@@ -214,8 +223,10 @@ protected:
      * doGLFenceWaitLocked inserts a wait command into the OpenGL ES command
      * stream to ensure that it is safe for future OpenGL ES commands to
      * access the current texture buffer.
+     * When callerOwnsContext is true the attached display is used directly
+     * instead of being re-queried and validated; see updateTexImage.
      */
-    status_t doGLFenceWaitLocked(SurfaceTexture& st) const;
+    status_t doGLFenceWaitLocked(SurfaceTexture& st, bool callerOwnsContext = false) const;
 
     /**
      * syncForReleaseLocked performs the synchronization needed to release the
@@ -114,6 +114,20 @@ public:
      */
     status_t updateTexImage();
 
+    /**
+     * updateTexImageInContext behaves like updateTexImage, but the caller
+     * declares that the OpenGL ES context this texture is attached to is
+     * current on the calling thread.  Once the attached display/context have
+     * been latched by a prior full update, the per-call EGL current-state
+     * queries and validation are skipped, which matters for clients that
+     * update many textures per frame from the same context.
+     *
+     * Calling this while a different context is current is undefined
+     * behavior, just like violating the context requirement of
+     * updateTexImage.
+     */
+    status_t updateTexImageInContext();
+
     /**
      * releaseTexImage releases the texture acquired in updateTexImage().
      * This is intended to be used in single buffer mode.
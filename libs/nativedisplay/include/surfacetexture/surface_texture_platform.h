@@ -51,6 +51,15 @@ ASurfaceTexture* ASurfaceTexture_routeFromSurfaceTexture(JNIEnv* env, jobject su
  */
 unsigned int ASurfaceTexture_getCurrentTextureTarget(ASurfaceTexture* st);
 
+/**
+ * ASurfaceTexture_updateTexImageInContext behaves like
+ * ASurfaceTexture_updateTexImage, but the caller declares that the GL context
+ * the texture is attached to is current on the calling thread, allowing the
+ * per-call EGL current-state queries and validation to be skipped.  Intended
+ * for clients that update many textures per frame from one context.
+ */
+int ASurfaceTexture_updateTexImageInContext(ASurfaceTexture* st);
+
 /**
  * ASurfaceTexture_takeConsumerOwnership attaches an ASurfaceTexture that is
  * currently in the 'detached' state to a consumer context.
@@ -85,11 +85,20 @@ static bool hasEglProtectedContent() {
 
 EGLConsumer::EGLConsumer() : mEglDisplay(EGL_NO_DISPLAY), mEglContext(EGL_NO_CONTEXT) {}
 
-status_t EGLConsumer::updateTexImage(SurfaceTexture& st) {
+status_t EGLConsumer::updateTexImage(SurfaceTexture& st, bool callerOwnsContext) {
+    // The caller's declaration of context ownership only lets us skip the EGL
+    // current-state queries once the attached display/context have been
+    // latched by a previous full update.
+    const bool skipEglStateCheck = callerOwnsContext && mEglDisplay != EGL_NO_DISPLAY &&
+            mEglContext != EGL_NO_CONTEXT;
+
     // Make sure the EGL state is the same as in previous calls.
-    status_t err = checkAndUpdateEglStateLocked(st);
-    if (err != NO_ERROR) {
-        return err;
+    status_t err = NO_ERROR;
+    if (!skipEglStateCheck) {
+        err = checkAndUpdateEglStateLocked(st);
+        if (err != NO_ERROR) {
+            return err;
+        }
     }
 
     BufferItem item;
@@ -111,7 +120,7 @@ status_t EGLConsumer::updateTexImage(SurfaceTexture& st) {
     }
 
     // Release the previous buffer.
-    err = updateAndReleaseLocked(item, nullptr, st);
+    err = updateAndReleaseLocked(item, nullptr, st, skipEglStateCheck);
     if (err != NO_ERROR) {
         // We always bind the texture.
         glBindTexture(st.mTexTarget, st.mTexName);
@@ -119,7 +128,7 @@ status_t EGLConsumer::updateTexImage(SurfaceTexture& st) {
     }
 
     // Bind the new buffer to the GL texture, and wait until it's ready.
-    return bindTextureImageLocked(st);
+    return bindTextureImageLocked(st, skipEglStateCheck);
 }
 
 status_t EGLConsumer::releaseTexImage(SurfaceTexture& st) {
@@ -226,7 +235,7 @@ void EGLConsumer::onReleaseBufferLocked(int buf) {
 }
 
 status_t EGLConsumer::updateAndReleaseLocked(const BufferItem& item, PendingRelease* pendingRelease,
-                                             SurfaceTexture& st) {
+                                             SurfaceTexture& st, bool callerOwnsContext) {
     status_t err = NO_ERROR;
 
     int slot = item.mSlot;
@@ -238,11 +247,14 @@ status_t EGLConsumer::updateAndReleaseLocked(const BufferItem& item, PendingRele
         return INVALID_OPERATION;
     }
 
-    // Confirm state.
-    err = checkAndUpdateEglStateLocked(st);
-    if (err != NO_ERROR) {
-        st.releaseBufferLocked(slot, st.mSlots[slot].mGraphicBuffer, mEglDisplay, EGL_NO_SYNC_KHR);
-        return err;
+    // Confirm state, unless the caller has declared context ownership.
+    if (!callerOwnsContext) {
+        err = checkAndUpdateEglStateLocked(st);
+        if (err != NO_ERROR) {
+            st.releaseBufferLocked(slot, st.mSlots[slot].mGraphicBuffer, mEglDisplay,
+                                   EGL_NO_SYNC_KHR);
+            return err;
+        }
     }
 
     // Ensure we have a valid EglImageKHR for the slot, creating an EglImage
@@ -321,7 +333,7 @@ status_t EGLConsumer::updateAndReleaseLocked(const BufferItem& item, PendingRele
     return err;
 }
 
-status_t EGLConsumer::bindTextureImageLocked(SurfaceTexture& st) {
+status_t EGLConsumer::bindTextureImageLocked(SurfaceTexture& st, bool callerOwnsContext) {
     if (mEglDisplay == EGL_NO_DISPLAY) {
         ALOGE("bindTextureImage: invalid display");
         return INVALID_OPERATION;
@@ -366,7 +378,7 @@ status_t EGLConsumer::bindTextureImageLocked(SurfaceTexture& st) {
     }
 
     // Wait for the new buffer to be ready.
-    return doGLFenceWaitLocked(st);
+    return doGLFenceWaitLocked(st, callerOwnsContext);
 }
 
 status_t EGLConsumer::checkAndUpdateEglStateLocked(SurfaceTexture& st, bool contextCheck) {
@@ -539,18 +551,22 @@ status_t EGLConsumer::syncForReleaseLocked(EGLDisplay dpy, SurfaceTexture& st) {
     return OK;
 }
 
-status_t EGLConsumer::doGLFenceWaitLocked(SurfaceTexture& st) const {
-    EGLDisplay dpy = eglGetCurrentDisplay();
-    EGLContext ctx = eglGetCurrentContext();
+status_t EGLConsumer::doGLFenceWaitLocked(SurfaceTexture& st, bool callerOwnsContext) const {
+    EGLDisplay dpy = mEglDisplay;
 
-    if (mEglDisplay != dpy || mEglDisplay == EGL_NO_DISPLAY) {
-        EGC_LOGE("doGLFenceWait: invalid current EGLDisplay");
-        return INVALID_OPERATION;
-    }
+    if (!callerOwnsContext) {
+        dpy = eglGetCurrentDisplay();
+        EGLContext ctx = eglGetCurrentContext();
 
-    if (mEglContext != ctx || mEglContext == EGL_NO_CONTEXT) {
-        EGC_LOGE("doGLFenceWait: invalid current EGLContext");
-        return INVALID_OPERATION;
+        if (mEglDisplay != dpy || mEglDisplay == EGL_NO_DISPLAY) {
+            EGC_LOGE("doGLFenceWait: invalid current EGLDisplay");
+            return INVALID_OPERATION;
+        }
+
+        if (mEglContext != ctx || mEglContext == EGL_NO_CONTEXT) {
+            EGC_LOGE("doGLFenceWait: invalid current EGLContext");
+            return INVALID_OPERATION;
+        }
     }
 
     if (st.mCurrentFence->isValid()) {
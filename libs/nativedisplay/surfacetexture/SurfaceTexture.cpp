@@ -107,6 +107,19 @@ status_t SurfaceTexture::updateTexImage() {
     return mEGLConsumer.updateTexImage(*this);
 }
 
+status_t SurfaceTexture::updateTexImageInContext() {
+    ATRACE_CALL();
+    SFT_LOGV("updateTexImageInContext");
+    Mutex::Autolock lock(mMutex);
+
+    if (mAbandoned) {
+        SFT_LOGE("updateTexImageInContext: SurfaceTexture is abandoned!");
+        return NO_INIT;
+    }
+
+    return mEGLConsumer.updateTexImage(*this, true /* callerOwnsContext */);
+}
+
 status_t SurfaceTexture::releaseTexImage() {
     // releaseTexImage can be invoked even when not attached to a GL context.
     ATRACE_CALL();
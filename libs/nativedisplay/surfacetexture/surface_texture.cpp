@@ -138,6 +138,10 @@ int ASurfaceTexture_updateTexImage(ASurfaceTexture* st) {
     return st->consumer->updateTexImage();
 }
 
+int ASurfaceTexture_updateTexImageInContext(ASurfaceTexture* st) {
+    return st->consumer->updateTexImageInContext();
+}
+
 void ASurfaceTexture_getTransformMatrix(ASurfaceTexture* st, float mtx[16]) {
     st->consumer->getTransformMatrix(mtx);
 }
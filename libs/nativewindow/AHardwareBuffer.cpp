@@ -19,8 +19,14 @@
 #include <vndk/hardware_buffer.h>
 
 #include <errno.h>
+#include <pthread.h>
 #include <sys/socket.h>
+
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include <cutils/native_handle.h>
 #include <log/log.h>
@@ -67,6 +73,71 @@ int AHardwareBuffer_allocate(const AHardwareBuffer_Desc* desc, AHardwareBuffer**
     return NO_ERROR;
 }
 
+namespace {
+
+// Serves AHardwareBuffer_allocateAsync. A single worker keeps allocations in
+// submission order and is started lazily the first time one is queued, so
+// processes that never allocate asynchronously don't pay for the thread.
+class AsyncAllocationQueue {
+public:
+    static AsyncAllocationQueue& instance() {
+        static AsyncAllocationQueue* queue = new AsyncAllocationQueue;
+        return *queue;
+    }
+
+    void enqueue(const AHardwareBuffer_Desc& desc, AHardwareBuffer_AllocateCallback callback,
+                 void* context) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPending.push_back({desc, callback, context});
+        if (!mThreadStarted) {
+            std::thread(&AsyncAllocationQueue::threadLoop, this).detach();
+            mThreadStarted = true;
+        }
+        mAvailableCv.notify_one();
+    }
+
+private:
+    struct Request {
+        AHardwareBuffer_Desc desc;
+        AHardwareBuffer_AllocateCallback callback;
+        void* context;
+    };
+
+    void threadLoop() {
+        pthread_setname_np(pthread_self(), "AHBufferAlloc");
+        while (true) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mAvailableCv.wait(lock, [this] { return !mPending.empty(); });
+                request = mPending.front();
+                mPending.pop_front();
+            }
+            AHardwareBuffer* buffer = nullptr;
+            int status = AHardwareBuffer_allocate(&request.desc, &buffer);
+            request.callback(status, status == NO_ERROR ? buffer : nullptr, request.context);
+        }
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mAvailableCv;
+    std::deque<Request> mPending;
+    bool mThreadStarted = false;
+};
+
+} // namespace
+
+int AHardwareBuffer_allocateAsync(const AHardwareBuffer_Desc* desc,
+                                  AHardwareBuffer_AllocateCallback callback, void* context) {
+    if (!desc || !callback) return BAD_VALUE;
+    // Validate on the caller's thread so that obviously bad requests fail
+    // immediately and the callback only ever reports allocator results.
+    if (!AHardwareBuffer_isValidDescription(desc, /*log=*/true)) return BAD_VALUE;
+
+    AsyncAllocationQueue::instance().enqueue(*desc, callback, context);
+    return NO_ERROR;
+}
+
 void AHardwareBuffer_acquire(AHardwareBuffer* buffer) {
     // incStrong/decStrong token must be the same, doesn't matter what it is
     AHardwareBuffer_to_GraphicBuffer(buffer)->incStrong((void*)AHardwareBuffer_acquire);
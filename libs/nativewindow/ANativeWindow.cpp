@@ -88,18 +88,21 @@ int32_t ANativeWindow_getFormat(ANativeWindow* window) {
 
 int32_t ANativeWindow_setBuffersGeometry(ANativeWindow* window,
         int32_t width, int32_t height, int32_t format) {
-    int32_t err = native_window_set_buffers_format(window, format);
-    if (!err) {
-        err = native_window_set_buffers_user_dimensions(window, width, height);
-        if (!err) {
-            int mode = NATIVE_WINDOW_SCALING_MODE_FREEZE;
-            if (width && height) {
-                mode = NATIVE_WINDOW_SCALING_MODE_SCALE_TO_WINDOW;
-            }
-            err = native_window_set_scaling_mode(window, mode);
-        }
+    int mode = NATIVE_WINDOW_SCALING_MODE_FREEZE;
+    if (width && height) {
+        mode = NATIVE_WINDOW_SCALING_MODE_SCALE_TO_WINDOW;
     }
-    return err;
+    // Stage all three properties and commit them through a single perform call
+    // (with a compatibility fallback to the individual calls inside the helper).
+    ANativeWindowBuffersBatch batch = {};
+    batch.propertyMask = NATIVE_WINDOW_BATCH_PROPERTY_FORMAT |
+            NATIVE_WINDOW_BATCH_PROPERTY_USER_DIMENSIONS |
+            NATIVE_WINDOW_BATCH_PROPERTY_SCALING_MODE;
+    batch.format = format;
+    batch.userWidth = width;
+    batch.userHeight = height;
+    batch.scalingMode = mode;
+    return native_window_set_buffers_batch(window, &batch);
 }
 
 int32_t ANativeWindow_lock(ANativeWindow* window, ANativeWindow_Buffer* outBuffer,
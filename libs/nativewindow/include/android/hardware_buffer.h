@@ -375,6 +375,43 @@ typedef struct AHardwareBuffer AHardwareBuffer;
  */
 int AHardwareBuffer_allocate(const AHardwareBuffer_Desc* _Nonnull desc,
                              AHardwareBuffer* _Nullable* _Nonnull outBuffer) __INTRODUCED_IN(26);
+
+/**
+ * Prototype of the function that is called when an allocation started with
+ * AHardwareBuffer_allocateAsync() completes.
+ *
+ * On success, status is 0 and buffer is the allocated buffer, carrying a
+ * reference count of 1 which the callback's recipient is responsible for
+ * releasing. On failure, status is an error number and buffer is NULL.
+ *
+ * The callback runs on an internal allocation thread, not on the thread that
+ * called AHardwareBuffer_allocateAsync(). It should not block, since that
+ * would delay other pending allocations.
+ */
+typedef void (*AHardwareBuffer_AllocateCallback)(int status, AHardwareBuffer* _Nullable buffer,
+                                                 void* _Null_unspecified context);
+
+/**
+ * Allocates a buffer that matches the passed AHardwareBuffer_Desc without
+ * blocking the calling thread.
+ *
+ * The allocation itself runs on a dedicated internal thread and the callback
+ * is invoked when it completes, so latency-sensitive callers (e.g. render
+ * loops streaming textures) can overlap allocation with other work instead of
+ * stalling on the allocator.
+ *
+ * The description is validated synchronously: if it is invalid, an error is
+ * returned immediately and the callback will not be called.
+ *
+ * Available since API level 33.
+ *
+ * \return 0 if the allocation was queued, or an error number if the arguments
+ * are invalid.
+ */
+int AHardwareBuffer_allocateAsync(const AHardwareBuffer_Desc* _Nonnull desc,
+                                  AHardwareBuffer_AllocateCallback _Nonnull callback,
+                                  void* _Null_unspecified context) __INTRODUCED_IN(33);
+
 /**
  * Acquire a reference on the given AHardwareBuffer object.
  *
@@ -257,6 +257,7 @@ enum {
     NATIVE_WINDOW_SET_QUERY_INTERCEPTOR           = 47,    /* private */
     NATIVE_WINDOW_SET_FRAME_TIMELINE_INFO         = 48,    /* private */
     NATIVE_WINDOW_GET_LAST_QUEUED_BUFFER2         = 49,    /* private */
+    NATIVE_WINDOW_SET_BUFFERS_BATCH               = 50,    /* private */
     // clang-format on
 };
 
@@ -731,6 +732,84 @@ static inline int native_window_set_buffers_data_space(
             dataSpace);
 }
 
+/* valid field bits for ANativeWindowBuffersBatch::propertyMask */
+enum {
+    NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS      = 0x01,
+    NATIVE_WINDOW_BATCH_PROPERTY_USER_DIMENSIONS = 0x02,
+    NATIVE_WINDOW_BATCH_PROPERTY_FORMAT          = 0x04,
+    NATIVE_WINDOW_BATCH_PROPERTY_USAGE           = 0x08,
+    NATIVE_WINDOW_BATCH_PROPERTY_DATASPACE       = 0x10,
+    NATIVE_WINDOW_BATCH_PROPERTY_SCALING_MODE    = 0x20,
+};
+
+/* parameter for NATIVE_WINDOW_SET_BUFFERS_BATCH */
+typedef struct ANativeWindowBuffersBatch {
+    /* bitmask of NATIVE_WINDOW_BATCH_PROPERTY_* selecting which fields below are staged */
+    uint32_t propertyMask;
+    /* NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS */
+    int width;
+    int height;
+    /* NATIVE_WINDOW_BATCH_PROPERTY_USER_DIMENSIONS */
+    int userWidth;
+    int userHeight;
+    /* NATIVE_WINDOW_BATCH_PROPERTY_FORMAT */
+    int format;
+    /* NATIVE_WINDOW_BATCH_PROPERTY_USAGE */
+    uint64_t usage;
+    /* NATIVE_WINDOW_BATCH_PROPERTY_DATASPACE */
+    android_dataspace_t dataSpace;
+    /* NATIVE_WINDOW_BATCH_PROPERTY_SCALING_MODE */
+    int scalingMode;
+} ANativeWindowBuffersBatch;
+
+/*
+ * native_window_set_buffers_batch(..., batch)
+ * Applies every property staged in 'batch' with the same semantics as the
+ * corresponding individual setter above.  Windows that implement
+ * NATIVE_WINDOW_SET_BUFFERS_BATCH validate all staged values before applying
+ * any of them and apply the whole batch under a single internal lock; for
+ * windows that don't, this falls back to the individual perform calls.
+ *
+ * Intended for callers that reconfigure several buffer properties at once
+ * (e.g. media codecs setting format, dimensions, usage and dataspace during
+ * surface setup).
+ */
+static inline int native_window_set_buffers_batch(struct ANativeWindow* window,
+        ANativeWindowBuffersBatch const* batch)
+{
+    int err = window->perform(window, NATIVE_WINDOW_SET_BUFFERS_BATCH, batch);
+    if (err != -ENOENT) {
+        return err;
+    }
+    // NAME_NOT_FOUND: this window predates batching; issue the individual calls.
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_FORMAT) {
+        err = native_window_set_buffers_format(window, batch->format);
+        if (err) return err;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_DIMENSIONS) {
+        err = native_window_set_buffers_dimensions(window, batch->width, batch->height);
+        if (err) return err;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_USER_DIMENSIONS) {
+        err = native_window_set_buffers_user_dimensions(window, batch->userWidth,
+                batch->userHeight);
+        if (err) return err;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_USAGE) {
+        err = native_window_set_usage(window, batch->usage);
+        if (err) return err;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_DATASPACE) {
+        err = native_window_set_buffers_data_space(window, batch->dataSpace);
+        if (err) return err;
+    }
+    if (batch->propertyMask & NATIVE_WINDOW_BATCH_PROPERTY_SCALING_MODE) {
+        err = window->perform(window, NATIVE_WINDOW_SET_SCALING_MODE, batch->scalingMode);
+        if (err) return err;
+    }
+    return 0;
+}
+
 /*
  * native_window_set_buffers_smpte2086_metadata(..., metadata)
  * All buffers queued after this call will be associated with the SMPTE
@@ -18,7 +18,9 @@
 //#define LOG_NDEBUG 0
 
 #include <android/hardware/graphics/common/1.0/types.h>
+#include <condition_variable>
 #include <gtest/gtest.h>
+#include <mutex>
 #include <private/android/AHardwareBufferHelpers.h>
 #include <ui/GraphicBuffer.h>
 #include <vndk/hardware_buffer.h>
@@ -170,3 +172,49 @@ TEST(AHardwareBufferTest, GetIdTest) {
 
     EXPECT_NE(id1, id2);
 }
+
+TEST(AHardwareBufferTest, AllocateAsyncTest) {
+    const AHardwareBuffer_Desc desc = {
+            .width = 2,
+            .height = 4,
+            .layers = 1,
+            .format = AHARDWAREBUFFER_FORMAT_R8G8B8A8_UNORM,
+            .usage = AHARDWAREBUFFER_USAGE_CPU_READ_RARELY,
+    };
+
+    struct Result {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+        int status = -1;
+        AHardwareBuffer* buffer = nullptr;
+    } result;
+
+    int res = AHardwareBuffer_allocateAsync(
+            &desc,
+            [](int status, AHardwareBuffer* buffer, void* context) {
+                Result* result = static_cast<Result*>(context);
+                std::lock_guard<std::mutex> lock(result->mutex);
+                result->status = status;
+                result->buffer = buffer;
+                result->done = true;
+                result->cv.notify_one();
+            },
+            &result);
+    EXPECT_EQ(NO_ERROR, res);
+
+    std::unique_lock<std::mutex> lock(result.mutex);
+    result.cv.wait(lock, [&result] { return result.done; });
+    EXPECT_EQ(NO_ERROR, result.status);
+    ASSERT_NE(nullptr, result.buffer);
+
+    AHardwareBuffer_Desc bufferDesc;
+    AHardwareBuffer_describe(result.buffer, &bufferDesc);
+    EXPECT_EQ(desc.width, bufferDesc.width);
+    EXPECT_EQ(desc.height, bufferDesc.height);
+
+    AHardwareBuffer_release(result.buffer);
+
+    // Invalid arguments fail synchronously, without invoking the callback.
+    EXPECT_EQ(BAD_VALUE, AHardwareBuffer_allocateAsync(&desc, nullptr, nullptr));
+}
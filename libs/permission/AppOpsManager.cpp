@@ -19,6 +19,7 @@
 #include <binder/Binder.h>
 #include <binder/IServiceManager.h>
 
+#include <utils/SortedVector.h>
 #include <utils/SystemClock.h>
 
 #include <sys/types.h>
@@ -31,6 +32,115 @@
 
 namespace android {
 
+namespace {
+
+// How long a noted mode may be served locally before the server is consulted again. The
+// window bounds how many server-side note records a bursty caller can collapse, while the
+// opChanged callback below invalidates immediately when a mode actually changes.
+constexpr int64_t kNoteOpValidityMs = 1000;
+
+// Client-side cache of note decisions, keyed by (op, uid, package) and mirroring
+// PermissionCache semantics: lookups are local, and the server pushes invalidations through
+// the IAppOpsCallback it already supports. Cached hits do not produce a note record on the
+// server for the validity window; that is the intended trade-off for callers which note the
+// same op on every frame of a burst.
+class NoteOpCache : public BnAppOpsCallback {
+    struct Entry {
+        int32_t op;
+        int32_t uid;
+        String16 packageName;
+        int32_t mode;
+        int64_t timestampMs;
+
+        bool operator<(const Entry& other) const {
+            if (op != other.op) return op < other.op;
+            if (uid != other.uid) return uid < other.uid;
+            return packageName < other.packageName;
+        }
+    };
+
+    struct WatchedOp {
+        int32_t op;
+        String16 packageName;
+
+        bool operator<(const WatchedOp& other) const {
+            if (op != other.op) return op < other.op;
+            return packageName < other.packageName;
+        }
+    };
+
+public:
+    bool get(int32_t op, int32_t uid, const String16& packageName, int32_t* outMode) const {
+        Mutex::Autolock _l(mLock);
+        const Entry key{op, uid, packageName, 0, 0};
+        ssize_t index = mEntries.indexOf(key);
+        if (index < 0) {
+            return false;
+        }
+        const Entry& entry = mEntries.itemAt(index);
+        if (uptimeMillis() - entry.timestampMs > kNoteOpValidityMs) {
+            return false;
+        }
+        *outMode = entry.mode;
+        return true;
+    }
+
+    void put(int32_t op, int32_t uid, const String16& packageName, int32_t mode) {
+        Mutex::Autolock _l(mLock);
+        Entry entry{op, uid, packageName, mode, uptimeMillis()};
+        ssize_t index = mEntries.indexOf(entry);
+        if (index >= 0) {
+            mEntries.editItemAt(size_t(index)) = entry;
+        } else {
+            mEntries.add(entry);
+        }
+    }
+
+    // Returns whether the caller needs to register the callback with the server for this
+    // (op, package), and marks it watched so registration happens only once.
+    bool shouldStartWatching(int32_t op, const String16& packageName) {
+        Mutex::Autolock _l(mLock);
+        const WatchedOp key{op, packageName};
+        if (mWatched.indexOf(key) >= 0) {
+            return false;
+        }
+        mWatched.add(key);
+        return true;
+    }
+
+    // Drops all cached decisions and watch registrations, e.g. after the app ops service
+    // restarted and the server-side callbacks were lost.
+    void reset() {
+        Mutex::Autolock _l(mLock);
+        mEntries.clear();
+        mWatched.clear();
+    }
+
+    void opChanged(int32_t op, const String16& packageName) override {
+        Mutex::Autolock _l(mLock);
+        // An empty package invalidates the op for all packages.
+        for (size_t i = mEntries.size(); i > 0; i--) {
+            const Entry& entry = mEntries.itemAt(i - 1);
+            if (entry.op == op &&
+                (packageName.size() == 0 || entry.packageName == packageName)) {
+                mEntries.removeAt(i - 1);
+            }
+        }
+    }
+
+private:
+    mutable Mutex mLock;
+    SortedVector<Entry> mEntries;
+    SortedVector<WatchedOp> mWatched;
+};
+
+const sp<NoteOpCache>& getNoteOpCache() {
+    static sp<NoteOpCache> gCache = sp<NoteOpCache>::make();
+    return gCache;
+}
+
+} // namespace
+
 static const sp<IBinder>& getClientId() {
     static pthread_mutex_t gClientIdMutex = PTHREAD_MUTEX_INITIALIZER;
     static sp<IBinder> gClientId;
@@ -70,6 +180,9 @@ sp<IAppOpsService> AppOpsManager::getService()
         } else {
             service = interface_cast<IAppOpsService>(binder);
             mService = service;
+            // A restarted service has lost the watch registrations, so cached decisions can
+            // no longer be invalidated; start over.
+            getNoteOpCache()->reset();
         }
     }
     return service;
@@ -98,11 +211,26 @@ int32_t AppOpsManager::noteOp(int32_t op, int32_t uid, const String16& callingPa
 
 int32_t AppOpsManager::noteOp(int32_t op, int32_t uid, const String16& callingPackage,
         const std::optional<String16>& attributionTag, const String16& message) {
+    const sp<NoteOpCache>& cache = getNoteOpCache();
+    int32_t cachedMode;
+    if (cache->get(op, uid, callingPackage, &cachedMode)) {
+        return cachedMode;
+    }
+
     sp<IAppOpsService> service = getService();
-    int32_t mode = service != nullptr
-            ? service->noteOperation(op, uid, callingPackage, attributionTag,
-                    shouldCollectNotes(op), message, uid == AID_SYSTEM)
-            : AppOpsManager::MODE_IGNORED;
+    if (service == nullptr) {
+        return AppOpsManager::MODE_IGNORED;
+    }
+
+    // Register for mode changes before noting so an invalidation cannot slip in between the
+    // note below and the watch registration.
+    if (cache->shouldStartWatching(op, callingPackage)) {
+        service->startWatchingMode(op, callingPackage, cache);
+    }
+
+    const int32_t mode = service->noteOperation(op, uid, callingPackage, attributionTag,
+            shouldCollectNotes(op), message, uid == AID_SYSTEM);
+    cache->put(op, uid, callingPackage, mode);
 
     return mode;
 }
@@ -28,6 +28,7 @@
 
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
+#include <android-base/properties.h>
 #include <android-base/stringprintf.h>
 #include <cutils/compiler.h>
 #include <cutils/properties.h>
@@ -388,7 +389,9 @@ GLESRenderEngine::GLESRenderEngine(const RenderEngineCreationArgs& args, EGLDisp
         mProtectedStubSurface(protectedStub),
         mVpWidth(0),
         mVpHeight(0),
-        mFramebufferImageCacheSize(args.imageCacheSize),
+        mFramebufferImageCacheSize(
+                base::GetUintProperty<uint32_t>(PROPERTY_DEBUG_RENDERENGINE_FB_IMAGE_CACHE_SIZE,
+                                                args.imageCacheSize)),
         mUseColorManagement(args.useColorManagement),
         mPrecacheToneMapperShaderOnly(args.precacheToneMapperShaderOnly) {
     glGetIntegerv(GL_MAX_TEXTURE_SIZE, &mMaxTextureSize);
@@ -748,8 +751,17 @@ void GLESRenderEngine::bindExternalTextureBuffer(uint32_t texName, const sp<Grap
 }
 
 void GLESRenderEngine::mapExternalTextureBuffer(const sp<GraphicBuffer>& buffer,
-                                                bool /*isRenderable*/) {
+                                                bool isRenderable) {
     ATRACE_CALL();
+    if (isRenderable && (buffer->getUsage() & GRALLOC_USAGE_HW_FB)) {
+        // This is a display output buffer, so pre-warm the framebuffer image cache now instead
+        // of paying for eglCreateImageKHR on the first frame drawn into it. One-shot render
+        // targets such as screenshot buffers are renderable too but lack the HW_FB usage bit
+        // and must not displace the display buffers from the cache.
+        createFramebufferImageIfNeeded(buffer->getNativeBuffer(),
+                                       buffer->getUsage() & GRALLOC_USAGE_PROTECTED,
+                                       true /* useFramebufferCache */);
+    }
     mImageManager->cacheAsync(buffer, nullptr);
 }
 
@@ -1049,9 +1061,11 @@ EGLImageKHR GLESRenderEngine::createFramebufferImageIfNeeded(ANativeWindowBuffer
         std::lock_guard<std::mutex> lock(mFramebufferImageCacheMutex);
         for (const auto& image : mFramebufferImageCache) {
             if (image.first == graphicBuffer->getId()) {
+                mFramebufferImageCacheHits++;
                 return image.second;
             }
         }
+        mFramebufferImageCacheMisses++;
     }
     EGLint attributes[] = {
             isProtected ? EGL_PROTECTED_CONTENT_EXT : EGL_NONE,
@@ -1066,6 +1080,7 @@ EGLImageKHR GLESRenderEngine::createFramebufferImageIfNeeded(ANativeWindowBuffer
             if (mFramebufferImageCache.size() >= mFramebufferImageCacheSize) {
                 EGLImageKHR expired = mFramebufferImageCache.front().second;
                 mFramebufferImageCache.pop_front();
+                mFramebufferImageCacheEvictions++;
                 eglDestroyImageKHR(mEGLDisplay, expired);
                 DEBUG_EGL_IMAGE_TRACKER_DESTROY();
             }
@@ -1611,8 +1626,13 @@ void GLESRenderEngine::dump(std::string& result) {
     }
     {
         std::lock_guard<std::mutex> lock(mFramebufferImageCacheMutex);
-        StringAppendF(&result, "RenderEngine framebuffer image cache size: %zu\n",
-                      mFramebufferImageCache.size());
+        StringAppendF(&result, "RenderEngine framebuffer image cache size: %zu (capacity %u)\n",
+                      mFramebufferImageCache.size(), mFramebufferImageCacheSize);
+        StringAppendF(&result,
+                      "RenderEngine framebuffer image cache hits: %" PRIu64 ", misses: %" PRIu64
+                      ", evictions: %" PRIu64 "\n",
+                      mFramebufferImageCacheHits, mFramebufferImageCacheMisses,
+                      mFramebufferImageCacheEvictions);
         StringAppendF(&result, "Dumping buffer ids...\n");
         for (const auto& [id, unused] : mFramebufferImageCache) {
             StringAppendF(&result, "0x%" PRIx64 "\n", id);
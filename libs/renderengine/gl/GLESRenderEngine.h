@@ -220,12 +220,20 @@ private:
     // If set to true, then enables tracing flush() and finish() to systrace.
     bool mTraceGpuCompletion = false;
     // Maximum size of mFramebufferImageCache. If more images would be cached, then (approximately)
-    // the last recently used buffer should be kicked out.
+    // the last recently used buffer should be kicked out. Sized from the creation args, but can
+    // be overridden with the debug.renderengine.framebuffer_image_cache_size property on devices
+    // whose output buffer rotation is wider than the default.
     uint32_t mFramebufferImageCacheSize = 0;
 
     // Cache of output images, keyed by corresponding GraphicBuffer ID.
     std::deque<std::pair<uint64_t, EGLImageKHR>> mFramebufferImageCache
             GUARDED_BY(mFramebufferImageCacheMutex);
+    // Running counters surfaced in dump(). A high eviction count relative to hits means the
+    // cache is undersized for the number of output buffers in flight and every frame pays for
+    // an eglCreateImageKHR.
+    uint64_t mFramebufferImageCacheHits GUARDED_BY(mFramebufferImageCacheMutex) = 0;
+    uint64_t mFramebufferImageCacheMisses GUARDED_BY(mFramebufferImageCacheMutex) = 0;
+    uint64_t mFramebufferImageCacheEvictions GUARDED_BY(mFramebufferImageCacheMutex) = 0;
     // The only reason why we have this mutex is so that we don't segfault when
     // dumping info.
     std::mutex mFramebufferImageCacheMutex;
@@ -54,6 +54,13 @@
  */
 #define PROPERTY_SKIA_ATRACE_ENABLED "debug.renderengine.skia_atrace_enabled"
 
+/**
+ * Overrides the number of EGLImages the GLES backend keeps cached for output buffers. Useful on
+ * devices whose displays rotate through more output buffers than the default cache size covers.
+ */
+#define PROPERTY_DEBUG_RENDERENGINE_FB_IMAGE_CACHE_SIZE \
+    "debug.renderengine.framebuffer_image_cache_size"
+
 struct ANativeWindowBuffer;
 
 namespace android {
@@ -172,6 +179,24 @@ public:
     virtual void cleanupPostRender() = 0;
 
     virtual void cleanFramebufferCache() = 0;
+
+    // Staged levels for releasing cached GPU memory under pressure, ordered from least to
+    // most disruptive to subsequent frames.
+    enum class TrimMemoryLevel {
+        // Trims the resource caches down to a fraction of their budget, evicting the least
+        // recently used resources first.
+        WATERMARK = 1,
+        // Purges only resources that have not been used for several seconds.
+        STALE = 2,
+        // Purges every resource that is not locked by an in-flight frame. Reclaims the most
+        // memory, but the following frames pay to re-upload what they still need.
+        ALL = 3,
+    };
+
+    // Releases cached GPU resources according to the given level. Backends that do not
+    // maintain a GPU resource cache may ignore this.
+    virtual void trimGpuMemory(TrimMemoryLevel /*level*/) {}
+
     // Returns the priority this context was actually created with. Note: this may not be
     // the same as specified at context creation time, due to implementation limits on the
     // number of contexts that can be created at a specific priority level in the system.
@@ -51,6 +51,10 @@ const auto kFlip = mat4(1.1f, -0.1f,  0.f, 0.f,
 // a color correction effect is added to the shader.
 constexpr auto kDestDataSpace = ui::Dataspace::SRGB;
 constexpr auto kOtherDataSpace = ui::Dataspace::DISPLAY_P3;
+// HDR sources always mismatch the destination, and additionally select the
+// tone-mapping stage.
+constexpr auto kBT2020DataSpace = ui::Dataspace::BT2020_ITU_PQ;
+constexpr auto kHlgDataSpace = ui::Dataspace::BT2020_ITU_HLG;
 } // namespace
 
 static void drawShadowLayers(SkiaRenderEngine* renderengine, const DisplaySettings& display,
@@ -142,7 +146,9 @@ static void drawImageLayers(SkiaRenderEngine* renderengine, const DisplaySetting
                                           }},
     };
 
-    for (auto dataspace : {kDestDataSpace, kOtherDataSpace}) {
+    // The HDR dataspaces were observed compiling on first use in the field; an HDR source
+    // adds a tone-mapping stage on top of the gamut conversion.
+    for (auto dataspace : {kDestDataSpace, kOtherDataSpace, kBT2020DataSpace, kHlgDataSpace}) {
         layer.sourceDataspace = dataspace;
         // Cache shaders for both rects and round rects.
         // In reduced shader mode, all non-zero round rect radii get the same code path.
@@ -197,6 +203,7 @@ static void drawBlurLayers(SkiaRenderEngine* renderengine, const DisplaySettings
             .geometry =
                     Geometry{
                             .boundaries = rect,
+                            .roundedCornersCrop = rect,
                     },
             .alpha = 1,
             // setting this is mandatory for shadows and blurs
@@ -206,9 +213,13 @@ static void drawBlurLayers(SkiaRenderEngine* renderengine, const DisplaySettings
     // Different blur code is invoked for radii less and greater than 30 pixels
     for (int radius : {9, 60}) {
         layer.backgroundBlurRadius = radius;
-        auto layers = std::vector<LayerSettings>{layer};
-        renderengine->drawLayers(display, layers, dstTexture, kUseFrameBufferCache,
-                                 base::unique_fd());
+        // A rounded-corner radius clips the blurred content with a coverage stage.
+        for (float roundedCornersRadius : {0.0f, 50.0f}) {
+            layer.geometry.roundedCornersRadius = {roundedCornersRadius, roundedCornersRadius};
+            auto layers = std::vector<LayerSettings>{layer};
+            renderengine->drawLayers(display, layers, dstTexture, kUseFrameBufferCache,
+                                     base::unique_fd());
+        }
     }
 }
 
@@ -390,6 +401,9 @@ void Cache::primeShaderCache(SkiaRenderEngine* renderengine) {
 
         if (renderengine->supportsBackgroundBlur()) {
             drawBlurLayers(renderengine, display, dstTexture);
+            // Blur behind HDR video plays out on wide-gamut panels; the non-SRGB
+            // destination adds color correction to the final blend.
+            drawBlurLayers(renderengine, p3Display, dstTexture);
         }
 
         // The majority of skia shaders needed by RenderEngine are related to sampling images.
@@ -44,6 +44,7 @@
 #include <ui/GraphicBuffer.h>
 #include <utils/Trace.h>
 
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <memory>
@@ -544,6 +545,15 @@ void SkiaGLRenderEngine::mapExternalTextureBuffer(const sp<GraphicBuffer>& buffe
                                                                buffer->toAHardwareBuffer(),
                                                                isRenderable, mTextureCleanupMgr);
         cache.insert({buffer->getId(), imageTextureRef});
+
+        // Software-written sources pay the driver's import work when an image is first
+        // created from the texture. We are already on the RenderEngine thread ahead of
+        // the frame that will sample this buffer, so do that work now instead of
+        // blocking the draw that first uses it. The image created here is thrown away;
+        // drawLayers makes its own with the layer's dataspace and alpha type.
+        if (!isRenderable && (buffer->getUsage() & GRALLOC_USAGE_SW_WRITE_MASK)) {
+            imageTextureRef->makeImage(ui::Dataspace::SRGB, kPremul_SkAlphaType, grContext);
+        }
     }
 }
 
@@ -654,11 +664,27 @@ sk_sp<SkShader> SkiaGLRenderEngine::createRuntimeEffectShader(
         const auto targetBuffer = parameters.layer.source.buffer.buffer;
         const auto graphicBuffer = targetBuffer ? targetBuffer->getBuffer() : nullptr;
         const auto hardwareBuffer = graphicBuffer ? graphicBuffer->toAHardwareBuffer() : nullptr;
-        return createLinearEffectShader(parameters.shader, effect, runtimeEffect, colorTransform,
-                                        parameters.display.maxLuminance,
-                                        parameters.display.currentLuminanceNits,
-                                        parameters.layer.source.buffer.maxLuminanceNits,
-                                        hardwareBuffer, parameters.display.renderIntent);
+
+        const LinearEffectUniformsKey key{effect,
+                                          colorTransform,
+                                          parameters.display.maxLuminance,
+                                          parameters.display.currentLuminanceNits,
+                                          parameters.layer.source.buffer.maxLuminanceNits,
+                                          parameters.display.renderIntent};
+        auto uniformsIter = mLinearEffectUniforms.find(key);
+        if (uniformsIter == mLinearEffectUniforms.end()) {
+            if (mLinearEffectUniforms.size() >= kMaxLinearEffectUniforms) {
+                mLinearEffectUniforms.clear();
+            }
+            auto uniforms = shaders::
+                    buildLinearEffectUniforms(effect, colorTransform,
+                                              parameters.display.maxLuminance,
+                                              parameters.display.currentLuminanceNits,
+                                              parameters.layer.source.buffer.maxLuminanceNits,
+                                              hardwareBuffer, parameters.display.renderIntent);
+            uniformsIter = mLinearEffectUniforms.emplace(key, std::move(uniforms)).first;
+        }
+        return createLinearEffectShader(parameters.shader, runtimeEffect, uniformsIter->second);
     }
     return parameters.shader;
 }
@@ -861,6 +887,17 @@ void SkiaGLRenderEngine::drawLayersInternal(
         }
     }
 
+    // Snapshot of the active surface shared between blurred layers, together with the
+    // device space region drawn since it was taken and the blurred images generated from
+    // it. A blurred layer reuses the previous snapshot when nothing has been drawn over
+    // its blur rect since the snapshot, which collapses the per-layer surface copies and
+    // blur pass chains when several disjoint surfaces are blurred in one frame;
+    // overlapping blurs fall back to a fresh snapshot.
+    sk_sp<SkImage> blurInput;
+    SkRect drawnSinceBlurSnapshot = SkRect::MakeEmpty();
+    SkRect cachedBlurRect = SkRect::MakeEmpty();
+    std::unordered_map<uint32_t, sk_sp<SkImage>> cachedBlurs;
+
     AutoSaveRestore surfaceAutoSaveRestore(canvas);
     // Clear the entire canvas with a transparent black to prevent ghost images.
     canvas->clear(SK_ColorTRANSPARENT);
@@ -876,13 +913,15 @@ void SkiaGLRenderEngine::drawLayersInternal(
             logSettings(layer);
         }
 
-        sk_sp<SkImage> blurInput;
         if (blurCompositionLayer == &layer) {
             LOG_ALWAYS_FATAL_IF(activeSurface == dstSurface);
             LOG_ALWAYS_FATAL_IF(canvas == dstCanvas);
 
             // save a snapshot of the activeSurface to use as input to the blur shaders
             blurInput = activeSurface->makeImageSnapshot();
+            drawnSinceBlurSnapshot = SkRect::MakeEmpty();
+            cachedBlurs.clear();
+            cachedBlurRect = SkRect::MakeEmpty();
 
             // blit the offscreen framebuffer into the destination AHB, but only
             // if there are blur regions. backgroundBlurRadius blurs the entire
@@ -931,15 +970,23 @@ void SkiaGLRenderEngine::drawLayersInternal(
                 getBoundsAndClip(layer.geometry.boundaries, layer.geometry.roundedCornersCrop,
                                  layer.geometry.roundedCornersRadius);
         if (mBlurFilter && layerHasBlur(layer, ctModifiesAlpha)) {
-            std::unordered_map<uint32_t, sk_sp<SkImage>> cachedBlurs;
+            // rect to be blurred in the coordinate space of blurInput
+            const auto blurRect = canvas->getTotalMatrix().mapRect(bounds.rect());
 
-            // if multiple layers have blur, then we need to take a snapshot now because
-            // only the lowest layer will have blurImage populated earlier
-            if (!blurInput) {
+            // The previous blurred layer's snapshot is still valid input for this layer
+            // if nothing has been drawn over this layer's blur rect since it was taken;
+            // otherwise fall back to a fresh copy of the surface.
+            if (!blurInput || SkRect::Intersects(drawnSinceBlurSnapshot, blurRect)) {
                 blurInput = activeSurface->makeImageSnapshot();
+                drawnSinceBlurSnapshot = SkRect::MakeEmpty();
+                cachedBlurs.clear();
+                cachedBlurRect = blurRect;
+            } else if (blurRect != cachedBlurRect) {
+                // Same input but different geometry: the blur passes are cropped to the
+                // blur rect, so the cached images do not carry over.
+                cachedBlurs.clear();
+                cachedBlurRect = blurRect;
             }
-            // rect to be blurred in the coordinate space of blurInput
-            const auto blurRect = canvas->getTotalMatrix().mapRect(bounds.rect());
 
             // if the clip needs to be applied then apply it now and make sure
             // it is restored before we attempt to draw any shadows.
@@ -1002,6 +1049,15 @@ void SkiaGLRenderEngine::drawLayersInternal(
             drawShadow(canvas, rrect, layer.shadow);
         }
 
+        // Track what this layer draws over the shared blur snapshot. Blur and content
+        // draws stay within the layer bounds, but shadows extend past them by an amount
+        // that depends on the light, so treat shadow casters as covering everything.
+        if (layer.shadow.length > 0) {
+            drawnSinceBlurSnapshot.join(SkRect::Make(canvas->imageInfo().dimensions()));
+        } else {
+            drawnSinceBlurSnapshot.join(canvas->getTotalMatrix().mapRect(bounds.rect()));
+        }
+
         const float layerDimmingRatio = layer.whitePointNits <= 0.f
                 ? displayDimmingRatio
                 : (layer.whitePointNits / maxLayerWhitePoint) * displayDimmingRatio;
@@ -1560,6 +1616,50 @@ void SkiaGLRenderEngine::onActiveDisplaySizeChanged(ui::Size size) {
     }
 }
 
+void SkiaGLRenderEngine::trimGpuMemory(TrimMemoryLevel level) {
+    ATRACE_CALL();
+    // The fraction of the resource cache budget kept on a WATERMARK trim, and the age past
+    // which a resource counts as stale for a STALE trim.
+    static constexpr size_t kWatermarkDenominator = 2;
+    static constexpr auto kStaleResourceAge = std::chrono::seconds(5);
+
+    const auto trimContext = [level](GrDirectContext* context) {
+        if (!context) {
+            return;
+        }
+        switch (level) {
+            case TrimMemoryLevel::WATERMARK: {
+                size_t cacheBytes = 0;
+                context->getResourceCacheUsage(nullptr, &cacheBytes);
+                const size_t watermark =
+                        context->getResourceCacheLimit() / kWatermarkDenominator;
+                if (cacheBytes > watermark) {
+                    context->purgeUnlockedResources(cacheBytes - watermark,
+                                                    true /* preferScratchResources */);
+                }
+                break;
+            }
+            case TrimMemoryLevel::STALE:
+                context->performDeferredCleanup(kStaleResourceAge);
+                break;
+            case TrimMemoryLevel::ALL:
+                context->purgeUnlockedResources(false /* scratchResourcesOnly */);
+                break;
+        }
+    };
+
+    // Freeing GPU resources requires their context to be current, so trim the active
+    // context first and then switch to the other one, mirroring onActiveDisplaySizeChanged.
+    trimContext(getActiveGrContext());
+    const bool originalProtectedState = mInProtectedContext;
+    useProtectedContext(!mInProtectedContext);
+    if (mInProtectedContext != originalProtectedState) {
+        trimContext(getActiveGrContext());
+        // reset back to the initial context that was active when this method was called
+        useProtectedContext(originalProtectedState);
+    }
+}
+
 void SkiaGLRenderEngine::dump(std::string& result) {
     const gl::GLExtensions& extensions = gl::GLExtensions::getInstance();
 
@@ -1575,6 +1675,20 @@ void SkiaGLRenderEngine::dump(std::string& result) {
     StringAppendF(&result, "RenderEngine shaders cached since last dump/primeCache: %d\n",
                   mSkSLCacheMonitor.shadersCachedSinceLastCall());
 
+    const auto dumpResourceCache = [&result](const char* label, GrDirectContext* context) {
+        if (!context) {
+            return;
+        }
+        int resourceCount = 0;
+        size_t resourceBytes = 0;
+        context->getResourceCacheUsage(&resourceCount, &resourceBytes);
+        StringAppendF(&result,
+                      "RenderEngine %s resource cache: %zu bytes in %d resources (limit %zu)\n",
+                      label, resourceBytes, resourceCount, context->getResourceCacheLimit());
+    };
+    dumpResourceCache("unprotected", mGrContext.get());
+    dumpResourceCache("protected", mProtectedGrContext.get());
+
     std::vector<ResourcePair> cpuResourceMap = {
             {"skia/sk_resource_cache/bitmap_", "Bitmaps"},
             {"skia/sk_resource_cache/rrect-blur_", "Masks"},
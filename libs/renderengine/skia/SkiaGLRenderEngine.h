@@ -62,6 +62,7 @@ public:
     void useProtectedContext(bool useProtectedContext) override;
     bool supportsBackgroundBlur() override { return mBlurFilter != nullptr; }
     void onActiveDisplaySizeChanged(ui::Size size) override;
+    void trimGpuMemory(TrimMemoryLevel level) override;
     int reportShadersCompiled() override;
 
 protected:
@@ -141,6 +142,56 @@ private:
             GUARDED_BY(mRenderingMutex);
     std::unordered_map<shaders::LinearEffect, sk_sp<SkRuntimeEffect>, shaders::LinearEffectHasher>
             mRuntimeEffects;
+
+    // The uniforms fed into a linear effect are a pure function of this tuple. During HDR
+    // playback the same configuration repeats frame after frame, so the color space
+    // matrices and tonemapping parameters are derived once per configuration instead of
+    // once per draw. The source buffer is deliberately not part of the key; the in-tree
+    // tonemappers derive their uniforms from the luminance metadata alone.
+    struct LinearEffectUniformsKey {
+        shaders::LinearEffect effect;
+        mat4 colorTransform;
+        float maxDisplayLuminance;
+        float currentDisplayLuminanceNits;
+        float maxLuminance;
+        aidl::android::hardware::graphics::composer3::RenderIntent renderIntent;
+
+        bool operator==(const LinearEffectUniformsKey& other) const {
+            return effect == other.effect && colorTransform == other.colorTransform &&
+                    maxDisplayLuminance == other.maxDisplayLuminance &&
+                    currentDisplayLuminanceNits == other.currentDisplayLuminanceNits &&
+                    maxLuminance == other.maxLuminance && renderIntent == other.renderIntent;
+        }
+    };
+    struct LinearEffectUniformsHasher {
+        size_t operator()(const LinearEffectUniformsKey& key) const {
+            using shaders::LinearEffectHasher;
+            size_t result = LinearEffectHasher()(key.effect);
+            for (size_t i = 0; i < 4; i++) {
+                for (size_t j = 0; j < 4; j++) {
+                    result = LinearEffectHasher::HashCombine(result,
+                                                             std::hash<float>{}(
+                                                                     key.colorTransform[i][j]));
+                }
+            }
+            result = LinearEffectHasher::HashCombine(result,
+                                                     std::hash<float>{}(key.maxDisplayLuminance));
+            result = LinearEffectHasher::HashCombine(result,
+                                                     std::hash<float>{}(
+                                                             key.currentDisplayLuminanceNits));
+            result = LinearEffectHasher::HashCombine(result, std::hash<float>{}(key.maxLuminance));
+            return LinearEffectHasher::HashCombine(result,
+                                                   std::hash<int32_t>{}(static_cast<int32_t>(
+                                                           key.renderIntent)));
+        }
+    };
+    // Animated color transforms (e.g. dimming) land on a new key every frame, so cap the
+    // cache rather than letting stale configurations accumulate.
+    static constexpr size_t kMaxLinearEffectUniforms = 64;
+    std::unordered_map<LinearEffectUniformsKey, std::vector<tonemap::ShaderUniform>,
+                       LinearEffectUniformsHasher>
+            mLinearEffectUniforms;
+
     AutoBackendTexture::CleanupManager mTextureCleanupMgr GUARDED_BY(mRenderingMutex);
 
     StretchShaderFactory mStretchShaderFactory;
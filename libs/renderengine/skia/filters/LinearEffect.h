@@ -31,24 +31,13 @@ namespace skia {
 
 sk_sp<SkRuntimeEffect> buildRuntimeEffect(const shaders::LinearEffect& linearEffect);
 
-// Generates a shader resulting from applying the a linear effect created from
-// LinearEffectArgs::buildEffect to an inputShader.
-// Optionally, a color transform may also be provided, which combines with the
-// matrix transforming from linear XYZ to linear RGB immediately before OETF.
-// We also provide additional HDR metadata upon creating the shader:
-// * The max display luminance is the max luminance of the physical display in nits
-// * The current luminance of the physical display in nits
-// * The max luminance is provided as the max luminance for the buffer, either from the SMPTE 2086
-// or as the max light level from the CTA 861.3 standard.
-// * An AHardwareBuffer for implementations that support gralloc4 metadata for
-// communicating any HDR metadata.
-// * A RenderIntent that communicates the downstream renderintent for a physical display, for image
-// quality compensation.
-sk_sp<SkShader> createLinearEffectShader(
-        sk_sp<SkShader> inputShader, const shaders::LinearEffect& linearEffect,
-        sk_sp<SkRuntimeEffect> runtimeEffect, const mat4& colorTransform, float maxDisplayLuminance,
-        float currentDisplayLuminanceNits, float maxLuminance, AHardwareBuffer* buffer,
-        aidl::android::hardware::graphics::composer3::RenderIntent renderIntent);
+// Generates a shader resulting from applying the linear effect the runtimeEffect was built
+// from to an inputShader. The uniforms must come from shaders::buildLinearEffectUniforms
+// for the same linear effect; callers may reuse them across draws for as long as the
+// colorimetry configuration they were derived from is unchanged.
+sk_sp<SkShader> createLinearEffectShader(sk_sp<SkShader> inputShader,
+                                         sk_sp<SkRuntimeEffect> runtimeEffect,
+                                         const std::vector<tonemap::ShaderUniform>& uniforms);
 } // namespace skia
 } // namespace renderengine
 } // namespace android
@@ -356,6 +356,20 @@ void RenderEngineThreaded::cleanFramebufferCache() {
     mCondition.notify_one();
 }
 
+void RenderEngineThreaded::trimGpuMemory(TrimMemoryLevel level) {
+    ATRACE_CALL();
+    // This function is designed so it can run asynchronously, so we do not need to wait
+    // for the futures.
+    {
+        std::lock_guard lock(mThreadMutex);
+        mFunctionCalls.push([level](renderengine::RenderEngine& instance) {
+            ATRACE_NAME("REThreaded::trimGpuMemory");
+            instance.trimGpuMemory(level);
+        });
+    }
+    mCondition.notify_one();
+}
+
 int RenderEngineThreaded::getContextPriority() {
     std::promise<int> resultPromise;
     std::future<int> resultFuture = resultPromise.get_future();
@@ -63,6 +63,7 @@ public:
                                                base::unique_fd&& bufferFence) override;
 
     void cleanFramebufferCache() override;
+    void trimGpuMemory(TrimMemoryLevel level) override;
     int getContextPriority() override;
     bool supportsBackgroundBlur() override;
     void onActiveDisplaySizeChanged(ui::Size size) override;
@@ -38,6 +38,7 @@ enum {
     FLUSH_SENSOR,
     CONFIGURE_CHANNEL,
     DESTROY,
+    CONFIGURE_CHANNELS,
 };
 
 class BpSensorEventConnection : public BpInterface<ISensorEventConnection>
@@ -98,6 +99,33 @@ public:
         return reply.readInt32();
     }
 
+    virtual status_t configureChannels(const std::vector<std::pair<int32_t, int32_t>>& rateLevels,
+                                       std::vector<int32_t>* tokens) {
+        Parcel data, reply;
+        data.writeInterfaceToken(ISensorEventConnection::getInterfaceDescriptor());
+        data.writeInt32(static_cast<int32_t>(rateLevels.size()));
+        for (const auto& config : rateLevels) {
+            data.writeInt32(config.first);
+            data.writeInt32(config.second);
+        }
+        remote()->transact(CONFIGURE_CHANNELS, data, &reply);
+        status_t result = reply.readInt32();
+        if (result != NO_ERROR) {
+            return result;
+        }
+        int32_t count = reply.readInt32();
+        if (count < 0 || static_cast<size_t>(count) != rateLevels.size()) {
+            return UNKNOWN_ERROR;
+        }
+        if (tokens != nullptr) {
+            tokens->resize(count);
+            for (int32_t i = 0; i < count; i++) {
+                (*tokens)[i] = reply.readInt32();
+            }
+        }
+        return NO_ERROR;
+    }
+
     virtual void onLastStrongRef(const void* id) {
         destroy();
         BpInterface<ISensorEventConnection>::onLastStrongRef(id);
@@ -166,6 +194,31 @@ status_t BnSensorEventConnection::onTransact(
             destroy();
             return NO_ERROR;
         }
+        case CONFIGURE_CHANNELS: {
+            CHECK_INTERFACE(ISensorEventConnection, data, reply);
+            int32_t count = data.readInt32();
+            if (count < 0 ||
+                static_cast<size_t>(count) > data.dataAvail() / (2 * sizeof(int32_t))) {
+                return BAD_VALUE;
+            }
+            std::vector<std::pair<int32_t, int32_t>> rateLevels;
+            rateLevels.reserve(count);
+            for (int32_t i = 0; i < count; i++) {
+                int32_t handle = data.readInt32();
+                int32_t rateLevel = data.readInt32();
+                rateLevels.emplace_back(handle, rateLevel);
+            }
+            std::vector<int32_t> tokens;
+            status_t result = configureChannels(rateLevels, &tokens);
+            reply->writeInt32(result);
+            if (result == NO_ERROR) {
+                reply->writeInt32(static_cast<int32_t>(tokens.size()));
+                for (int32_t token : tokens) {
+                    reply->writeInt32(token);
+                }
+            }
+            return NO_ERROR;
+        }
 
     }
     return BBinder::onTransact(code, data, reply, flags);
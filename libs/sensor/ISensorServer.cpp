@@ -27,6 +27,7 @@
 
 #include <binder/Parcel.h>
 #include <binder/IInterface.h>
+#include <binder/IMemory.h>
 #include <binder/IResultReceiver.h>
 
 #include <sensor/Sensor.h>
@@ -42,6 +43,7 @@ enum {
     GET_DYNAMIC_SENSOR_LIST,
     CREATE_SENSOR_DIRECT_CONNECTION,
     SET_OPERATION_PARAMETER,
+    GET_SENSOR_LIST_MEMORY,
 };
 
 class BpSensorServer : public BpInterface<ISensorServer>
@@ -98,6 +100,28 @@ public:
         return v;
     }
 
+    virtual sp<IMemory> getSensorListMemory(const String16& opPackageName, bool* outIsCapped)
+    {
+        Parcel data, reply;
+        data.writeInterfaceToken(ISensorServer::getInterfaceDescriptor());
+        data.writeString16(opPackageName);
+        // An older server returns UNKNOWN_TRANSACTION here; callers fall back
+        // to getSensorList() when no region is available.
+        if (remote()->transact(GET_SENSOR_LIST_MEMORY, data, &reply) != NO_ERROR) {
+            return nullptr;
+        }
+        sp<IMemory> memory = interface_cast<IMemory>(reply.readStrongBinder());
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        bool isCapped;
+        if (reply.readBool(&isCapped) != NO_ERROR) {
+            return nullptr;
+        }
+        *outIsCapped = isCapped;
+        return memory;
+    }
+
     virtual sp<ISensorEventConnection> createSensorEventConnection(const String8& packageName,
              int mode, const String16& opPackageName, const String16& attributionTag)
     {
@@ -174,6 +198,15 @@ status_t BnSensorServer::onTransact(
             }
             return NO_ERROR;
         }
+        case GET_SENSOR_LIST_MEMORY: {
+            CHECK_INTERFACE(ISensorServer, data, reply);
+            const String16& opPackageName = data.readString16();
+            bool isCapped = false;
+            sp<IMemory> memory = getSensorListMemory(opPackageName, &isCapped);
+            reply->writeStrongBinder(IInterface::asBinder(memory));
+            reply->writeBool(isCapped);
+            return NO_ERROR;
+        }
         case CREATE_SENSOR_EVENT_CONNECTION: {
             CHECK_INTERFACE(ISensorServer, data, reply);
             String8 packageName = data.readString8();
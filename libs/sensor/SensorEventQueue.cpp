@@ -38,13 +38,14 @@ namespace android {
 // ----------------------------------------------------------------------------
 
 SensorEventQueue::SensorEventQueue(const sp<ISensorEventConnection>& connection)
-    : mSensorEventConnection(connection), mRecBuffer(nullptr), mAvailable(0), mConsumed(0),
-      mNumAcksToSend(0) {
+    : mSensorEventConnection(connection), mRecBuffer(nullptr), mBatchBuffer(nullptr),
+      mAvailable(0), mConsumed(0), mNumAcksToSend(0), mBatchMinEvents(1), mBatchMaxLatencyNs(0) {
     mRecBuffer = new ASensorEvent[MAX_RECEIVE_BUFFER_EVENT_COUNT];
 }
 
 SensorEventQueue::~SensorEventQueue() {
     delete [] mRecBuffer;
+    delete [] mBatchBuffer;
 }
 
 void SensorEventQueue::onFirstRef()
@@ -80,6 +81,77 @@ ssize_t SensorEventQueue::read(ASensorEvent* events, size_t numEvents) {
     return static_cast<ssize_t>(count);
 }
 
+void SensorEventQueue::setBatchDeliveryHints(size_t minEvents, int64_t maxLatencyUs) {
+    mBatchMinEvents = minEvents == 0
+            ? 1 : min(minEvents, size_t(MAX_RECEIVE_BUFFER_EVENT_COUNT));
+    mBatchMaxLatencyNs = maxLatencyUs > 0 ? us2ns(maxLatencyUs) : 0;
+}
+
+ssize_t SensorEventQueue::readBatch(ASensorEvent* events, size_t numEvents) {
+    size_t collected = 0;
+    nsecs_t deadline = 0;
+    while (collected < numEvents) {
+        const ssize_t n = read(events + collected, numEvents - collected);
+        if (n > 0) {
+            collected += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && n != -EAGAIN) {
+            return collected > 0 ? static_cast<ssize_t>(collected) : n;
+        }
+        // Nothing buffered; return the window once it satisfies the batch
+        // delivery hints, otherwise wait for more events.
+        if (collected >= mBatchMinEvents) {
+            break;
+        }
+        int timeoutMillis = -1;
+        if (collected > 0) {
+            if (mBatchMaxLatencyNs <= 0) {
+                break;
+            }
+            if (deadline == 0) {
+                deadline = systemTime(SYSTEM_TIME_MONOTONIC) + mBatchMaxLatencyNs;
+            }
+            const nsecs_t left = deadline - systemTime(SYSTEM_TIME_MONOTONIC);
+            if (left <= 0) {
+                break;
+            }
+            // Round up so we never poll with a zero timeout before the
+            // deadline actually passes.
+            timeoutMillis = static_cast<int>(ns2ms(left + 999999));
+        }
+        const status_t err = waitForEvent(timeoutMillis);
+        if (err == TIMED_OUT) {
+            break;
+        }
+        if (err != NO_ERROR) {
+            return collected > 0 ? static_cast<ssize_t>(collected) : ssize_t(err);
+        }
+    }
+    return static_cast<ssize_t>(collected);
+}
+
+status_t SensorEventQueue::dispatchBatch(BatchCallbackFunc callback, void* data) {
+    if (callback == nullptr) {
+        return BAD_VALUE;
+    }
+    if (mBatchBuffer == nullptr) {
+        mBatchBuffer = new ASensorEvent[MAX_RECEIVE_BUFFER_EVENT_COUNT];
+    }
+    ssize_t count = readBatch(mBatchBuffer, MAX_RECEIVE_BUFFER_EVENT_COUNT);
+    if (count < 0) {
+        return static_cast<status_t>(count);
+    }
+    // Acknowledge before filtering: the wake-up flag may sit on an event the
+    // filter would drop.
+    sendAck(mBatchBuffer, static_cast<int>(count));
+    count = filterEvents(mBatchBuffer, static_cast<size_t>(count));
+    if (count > 0) {
+        callback(mBatchBuffer, static_cast<size_t>(count), data);
+    }
+    return NO_ERROR;
+}
+
 sp<Looper> SensorEventQueue::getLooper() const
 {
     Mutex::Autolock _l(mLock);
@@ -91,14 +163,35 @@ sp<Looper> SensorEventQueue::getLooper() const
 }
 
 status_t SensorEventQueue::waitForEvent() const
+{
+    return waitForEvent(-1);
+}
+
+status_t SensorEventQueue::waitForEvent(int timeoutMillis) const
 {
     const int fd = getFd();
     sp<Looper> looper(getLooper());
 
+    nsecs_t deadline = 0;
+    if (timeoutMillis >= 0) {
+        deadline = systemTime(SYSTEM_TIME_MONOTONIC) + ms2ns(timeoutMillis);
+    }
+
     int events;
     int32_t result;
     do {
-        result = looper->pollOnce(-1, nullptr, &events, nullptr);
+        int timeout = -1;
+        if (timeoutMillis >= 0) {
+            const nsecs_t left = deadline - systemTime(SYSTEM_TIME_MONOTONIC);
+            if (left <= 0) {
+                return TIMED_OUT;
+            }
+            timeout = static_cast<int>(ns2ms(left + 999999));
+        }
+        result = looper->pollOnce(timeout, nullptr, &events, nullptr);
+        if (result == ALOOPER_POLL_TIMEOUT) {
+            return TIMED_OUT;
+        }
         if (result == ALOOPER_POLL_ERROR) {
             ALOGE("SensorEventQueue::waitForEvent error (errno=%d)", errno);
             result = -EPIPE; // unknown error, so we make up one
@@ -19,6 +19,7 @@
 #include <sensor/SensorManager.h>
 
 #include <stdint.h>
+#include <string.h>
 #include <sys/types.h>
 
 #include <cutils/native_handle.h>
@@ -27,6 +28,7 @@
 #include <utils/Singleton.h>
 
 #include <binder/IBinder.h>
+#include <binder/IMemory.h>
 #include <binder/IPermissionController.h>
 #include <binder/IServiceManager.h>
 
@@ -141,9 +143,11 @@ void SensorManager::sensorManagerDied() {
     free(mSensorList);
     mSensorList = nullptr;
     mSensors.clear();
+    mSensorListMemory.clear();
     free(mDynamicSensorList);
     mDynamicSensorList = nullptr;
     mDynamicSensors.clear();
+    mDynamicSensorListValid = false;
 }
 
 status_t SensorManager::assertStateLocked() {
@@ -174,7 +178,9 @@ status_t SensorManager::assertStateLocked() {
         mDeathObserver = new DeathObserver(*const_cast<SensorManager *>(this));
         IInterface::asBinder(mSensorServer)->linkToDeath(mDeathObserver);
 
-        mSensors = mSensorServer->getSensorList(mOpPackageName);
+        if (!initSensorListFromMemoryLocked()) {
+            mSensors = mSensorServer->getSensorList(mOpPackageName);
+        }
         size_t count = mSensors.size();
         if (count == 0) {
             ALOGE("Failed to get Sensor list");
@@ -193,6 +199,80 @@ status_t SensorManager::assertStateLocked() {
     return NO_ERROR;
 }
 
+bool SensorManager::initSensorListFromMemoryLocked() {
+    bool isCapped = false;
+    sp<IMemory> memory = mSensorServer->getSensorListMemory(mOpPackageName, &isCapped);
+    if (memory == nullptr) {
+        return false;
+    }
+
+    const size_t memorySize = memory->size();
+    const uint8_t* base = static_cast<const uint8_t*>(memory->unsecurePointer());
+    if (base == nullptr || memorySize < sizeof(SensorListMemoryHeader)) {
+        return false;
+    }
+    const SensorListMemoryHeader* header = reinterpret_cast<const SensorListMemoryHeader*>(base);
+    if (header->version != SensorListMemoryHeader::kVersion) {
+        return false;
+    }
+
+    const int list = isCapped ? 1 : 0;
+    const uint64_t offset = header->listOffset[list];
+    size_t remaining = header->listSize[list];
+    if (offset + remaining > memorySize) {
+        return false;
+    }
+
+    Vector<Sensor> sensors;
+    sensors.setCapacity(header->sensorCount);
+    const uint8_t* p = base + offset;
+    for (uint32_t i = 0; i < header->sensorCount; i++) {
+        if (remaining < sizeof(uint32_t)) {
+            return false;
+        }
+        uint32_t flattenedSize;
+        memcpy(&flattenedSize, p, sizeof(flattenedSize));
+        p += sizeof(uint32_t);
+        remaining -= sizeof(uint32_t);
+
+        const size_t alignedSize = (static_cast<size_t>(flattenedSize) + 3) & ~size_t(3);
+        if (alignedSize > remaining) {
+            return false;
+        }
+        Sensor sensor;
+        if (sensor.unflatten(p, flattenedSize) != NO_ERROR) {
+            return false;
+        }
+        p += alignedSize;
+        remaining -= alignedSize;
+        sensors.add(sensor);
+    }
+
+    mSensors = sensors;
+    mSensorListMemory = memory;
+    return true;
+}
+
+void SensorManager::updateDynamicSensorListLocked() {
+    uint32_t generation = 0;
+    if (mSensorListMemory != nullptr) {
+        const SensorListMemoryHeader* header =
+                static_cast<const SensorListMemoryHeader*>(mSensorListMemory->unsecurePointer());
+        if (header != nullptr) {
+            // Read the counter before fetching, so a change that races with
+            // the fetch forces another refresh on the next call.
+            generation = header->dynamicSensorGeneration.load(std::memory_order_acquire);
+            if (mDynamicSensorListValid && generation == mDynamicSensorListGeneration) {
+                return;
+            }
+        }
+    }
+
+    mDynamicSensors = mSensorServer->getDynamicSensorList(mOpPackageName);
+    mDynamicSensorListValid = true;
+    mDynamicSensorListGeneration = generation;
+}
+
 ssize_t SensorManager::getSensorList(Sensor const* const** list) {
     Mutex::Autolock _l(mLock);
     status_t err = assertStateLocked();
@@ -210,10 +290,10 @@ ssize_t SensorManager::getDynamicSensorList(Vector<Sensor> & dynamicSensors) {
         return static_cast<ssize_t>(err);
     }
 
-    dynamicSensors = mSensorServer->getDynamicSensorList(mOpPackageName);
-    size_t count = dynamicSensors.size();
+    updateDynamicSensorListLocked();
+    dynamicSensors = mDynamicSensors;
 
-    return static_cast<ssize_t>(count);
+    return static_cast<ssize_t>(dynamicSensors.size());
 }
 
 ssize_t SensorManager::getDynamicSensorList(Sensor const* const** list) {
@@ -225,7 +305,7 @@ ssize_t SensorManager::getDynamicSensorList(Sensor const* const** list) {
 
     free(mDynamicSensorList);
     mDynamicSensorList = nullptr;
-    mDynamicSensors = mSensorServer->getDynamicSensorList(mOpPackageName);
+    updateDynamicSensorListLocked();
     size_t dynamicCount = mDynamicSensors.size();
     if (dynamicCount > 0) {
         mDynamicSensorList = static_cast<Sensor const**>(
@@ -354,6 +434,25 @@ int SensorManager::configureDirectChannel(int channelNativeHandle, int sensorHan
     return ret;
 }
 
+status_t SensorManager::configureDirectChannels(int channelNativeHandle,
+        const std::vector<std::pair<int32_t, int32_t>>& rateLevels, std::vector<int32_t>* tokens) {
+    Mutex::Autolock _l(mLock);
+    if (assertStateLocked() != NO_ERROR) {
+        return NO_INIT;
+    }
+
+    auto i = mDirectConnection.find(channelNativeHandle);
+    if (i == mDirectConnection.end()) {
+        ALOGE("Cannot find the handle in client direct connection table");
+        return BAD_VALUE;
+    }
+
+    status_t ret = i->second->configureChannels(rateLevels, tokens);
+    ALOGE_IF(ret != NO_ERROR, "SensorManager::configureChannels of %zu sensors returns %d",
+            rateLevels.size(), static_cast<int>(ret));
+    return ret;
+}
+
 int SensorManager::setOperationParameter(
         int handle, int type,
         const Vector<float> &floats, const Vector<int32_t> &ints) {
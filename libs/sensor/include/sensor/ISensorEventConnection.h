@@ -19,6 +19,9 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <utility>
+#include <vector>
+
 #include <utils/Errors.h>
 #include <utils/StrongPointer.h>
 #include <utils/Timers.h>
@@ -42,6 +45,12 @@ public:
     virtual status_t setEventRate(int handle, nsecs_t ns) = 0;
     virtual status_t flush() = 0;
     virtual int32_t configureChannel(int32_t handle, int32_t rateLevel) = 0;
+    // Applies a set of (sensor handle, rate level) changes to a direct channel
+    // in one call with all-or-nothing semantics: either every change is applied
+    // and a report token per sensor is returned in tokens, or no change is
+    // applied and an error is returned.
+    virtual status_t configureChannels(const std::vector<std::pair<int32_t, int32_t>>& rateLevels,
+                                       std::vector<int32_t>* tokens) = 0;
 protected:
     virtual void destroy() = 0; // synchronously release resource hold by remote object
 };
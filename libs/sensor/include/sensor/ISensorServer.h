@@ -19,6 +19,8 @@
 #include <stdint.h>
 #include <sys/types.h>
 
+#include <atomic>
+
 #include <utils/Errors.h>
 #include <utils/StrongPointer.h>
 #include <utils/Vector.h>
@@ -30,12 +32,34 @@ typedef struct native_handle native_handle_t;
 namespace android {
 // ----------------------------------------------------------------------------
 
+class IMemory;
 class ISensorEventConnection;
 class Parcel;
 class Sensor;
 class String8;
 class String16;
 
+// Layout of the shared memory region returned by getSensorListMemory(). The
+// header is followed by two flattened copies of the sensor list: index 0 is
+// the full-rate list and index 1 the rate-capped one served to apps without
+// the HIGH_SAMPLING_RATE_SENSORS permission. Each sensor is stored as a
+// uint32_t byte count followed by its flattened representation, padded to a
+// 4-byte boundary.
+struct SensorListMemoryHeader {
+    // Bumped whenever the layout of the region changes.
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t version;
+    uint32_t sensorCount;
+    // Byte offset and length of each flattened list, from the region start.
+    uint32_t listOffset[2];
+    uint32_t listSize[2];
+    // Incremented in place when a dynamic sensor connects or disconnects, so
+    // clients holding a mapping can detect stale cached lists without a
+    // binder call.
+    std::atomic<uint32_t> dynamicSensorGeneration;
+};
+
 class ISensorServer : public IInterface
 {
 public:
@@ -44,6 +68,13 @@ public:
     virtual Vector<Sensor> getSensorList(const String16& opPackageName) = 0;
     virtual Vector<Sensor> getDynamicSensorList(const String16& opPackageName) = 0;
 
+    // Return the shared memory region holding the flattened sensor list (see
+    // SensorListMemoryHeader), shared by every client process, so reading the
+    // list does not copy a multi-KB parcel per process. Returns nullptr when
+    // the caller must use getSensorList() instead; *outIsCapped selects which
+    // of the two lists in the region applies to the caller.
+    virtual sp<IMemory> getSensorListMemory(const String16& opPackageName, bool* outIsCapped) = 0;
+
     virtual sp<ISensorEventConnection> createSensorEventConnection(const String8& packageName,
              int mode, const String16& opPackageName, const String16& attributionTag) = 0;
     virtual int32_t isDataInjectionEnabled() = 0;
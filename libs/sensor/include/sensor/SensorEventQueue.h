@@ -76,7 +76,27 @@ public:
 
     ssize_t read(ASensorEvent* events, size_t numEvents);
 
+    // Invoked by dispatchBatch() with every event of the read window at once.
+    typedef void (*BatchCallbackFunc)(ASensorEvent* events, size_t count, void* data);
+
+    // Configure how readBatch()/dispatchBatch() coalesce deliveries: they
+    // return once at least minEvents are buffered, or once maxLatencyUs has
+    // elapsed since the first undelivered event arrived (0 delivers whatever
+    // is buffered as soon as something arrives). Reducing wakeups at the
+    // source additionally requires a non-zero maxBatchReportLatencyUs when
+    // enabling the sensor.
+    void setBatchDeliveryHints(size_t minEvents, int64_t maxLatencyUs);
+
+    // Blocking read that waits per the batch delivery hints and then returns
+    // the entire buffered window, up to numEvents.
+    ssize_t readBatch(ASensorEvent* events, size_t numEvents);
+
+    // Read a batch, acknowledge wake-up events, filter the window and hand it
+    // to the callback in a single invocation.
+    status_t dispatchBatch(BatchCallbackFunc callback, void* data);
+
     status_t waitForEvent() const;
+    status_t waitForEvent(int timeoutMillis) const;
     status_t wake() const;
 
     status_t enableSensor(Sensor const* sensor) const;
@@ -107,9 +127,13 @@ private:
     mutable Mutex mLock;
     mutable sp<Looper> mLooper;
     ASensorEvent* mRecBuffer;
+    // Delivery buffer for dispatchBatch(), allocated on first use.
+    ASensorEvent* mBatchBuffer;
     size_t mAvailable;
     size_t mConsumed;
     uint32_t mNumAcksToSend;
+    size_t mBatchMinEvents;
+    nsecs_t mBatchMaxLatencyNs;
 };
 
 // ----------------------------------------------------------------------------
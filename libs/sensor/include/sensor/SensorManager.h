@@ -19,6 +19,8 @@
 
 #include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <stdint.h>
 #include <sys/types.h>
@@ -45,6 +47,7 @@ typedef struct native_handle native_handle_t;
 namespace android {
 // ----------------------------------------------------------------------------
 
+class IMemory;
 class ISensorServer;
 class Sensor;
 class SensorEventQueue;
@@ -67,6 +70,11 @@ public:
     int createDirectChannel(size_t size, int channelType, const native_handle_t *channelData);
     void destroyDirectChannel(int channelNativeHandle);
     int configureDirectChannel(int channelNativeHandle, int sensorHandle, int rateLevel);
+    // Applies several (sensor handle, rate level) changes to a direct channel in a single
+    // call; either all of them are applied (report tokens returned in tokens) or none.
+    status_t configureDirectChannels(int channelNativeHandle,
+                                     const std::vector<std::pair<int32_t, int32_t>>& rateLevels,
+                                     std::vector<int32_t>* tokens);
     int setOperationParameter(int handle, int type, const Vector<float> &floats, const Vector<int32_t> &ints);
 
 private:
@@ -76,6 +84,12 @@ private:
 
     explicit SensorManager(const String16& opPackageName);
     status_t assertStateLocked();
+    // Populate mSensors from the shared sensor list region published by the
+    // server; returns false when the caller must use getSensorList() instead.
+    bool initSensorListFromMemoryLocked();
+    // Refetch mDynamicSensors unless the change counter in the shared region
+    // shows the cached copy is still current.
+    void updateDynamicSensorListLocked();
 
 private:
     static Mutex sLock;
@@ -87,6 +101,13 @@ private:
     Vector<Sensor> mSensors;
     Sensor const** mDynamicSensorList = nullptr;
     Vector<Sensor> mDynamicSensors;
+    // Mapping of the shared sensor list region, or nullptr when mSensors was
+    // read through the parcel fallback.
+    sp<IMemory> mSensorListMemory;
+    // Value of the region's dynamic sensor change counter when
+    // mDynamicSensors was last fetched.
+    uint32_t mDynamicSensorListGeneration = 0;
+    bool mDynamicSensorListValid = false;
     sp<IBinder::DeathRecipient> mDeathObserver;
     const String16 mOpPackageName;
     std::unordered_map<int, sp<ISensorEventConnection>> mDirectConnection;
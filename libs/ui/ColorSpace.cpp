@@ -417,4 +417,19 @@ ColorSpaceConnector::ColorSpaceConnector(
     }
 }
 
+CompiledColorSpaceConnector::CompiledColorSpaceConnector(
+        const ColorSpace& src,
+        const ColorSpace& dst) noexcept
+        : mTransform(ColorSpaceConnector(src, dst).getTransform()) {
+
+    constexpr float step = 1.0f / (LUT_SIZE - 1);
+    const ColorSpace::transfer_function& eotf = src.getEOTF();
+    const ColorSpace::transfer_function& oetf = dst.getOETF();
+    for (size_t i = 0; i < LUT_SIZE; i++) {
+        const float v = i * step;
+        mToLinear[i] = eotf(v);
+        mFromLinear[i] = oetf(v);
+    }
+}
+
 }; // namespace android
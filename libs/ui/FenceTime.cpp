@@ -20,8 +20,13 @@
 
 #include <cutils/compiler.h>  // For CC_[UN]LIKELY
 #include <utils/Log.h>
+#include <errno.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
 
 #include <memory>
 
@@ -327,6 +332,99 @@ void FenceTimeline::updateSignalTimes() {
     }
 }
 
+// ============================================================================
+// FenceWatcher
+// ============================================================================
+FenceWatcher& FenceWatcher::getInstance() {
+    // Deliberately leaked; the watcher thread runs for the life of the
+    // process and must not be torn down by static destructors.
+    static FenceWatcher* instance = new FenceWatcher();
+    return *instance;
+}
+
+FenceWatcher::FenceWatcher() {
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (mEpollFd < 0) {
+        ALOGE("FenceWatcher: epoll_create1 failed: %s", strerror(errno));
+        return;
+    }
+    mThread = std::thread(&FenceWatcher::threadLoop, this);
+}
+
+void FenceWatcher::watch(const std::shared_ptr<FenceTime>& fenceTime) {
+    if (mEpollFd < 0 || fenceTime == nullptr || !fenceTime->isValid()) {
+        return;
+    }
+    if (fenceTime->getCachedSignalTime() != Fence::SIGNAL_TIME_PENDING) {
+        return;
+    }
+
+    // Take our own duplicate of the fd so the fence can signal and close
+    // independently of the watcher.
+    FenceTime::Snapshot snapshot = fenceTime->getSnapshot();
+    if (snapshot.state != FenceTime::Snapshot::State::FENCE) {
+        // The fence signaled between the check above and the snapshot.
+        return;
+    }
+    int fd = snapshot.fence->dup();
+    if (fd < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mWatchedFences.size() >= MAX_WATCHED_FENCES) {
+        // Best effort only; the caller falls back to its own polling.
+        close(fd);
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        ALOGE("FenceWatcher: epoll_ctl(ADD) failed: %s", strerror(errno));
+        close(fd);
+        return;
+    }
+    mWatchedFences.emplace(fd, fenceTime);
+}
+
+void FenceWatcher::threadLoop() {
+    pthread_setname_np(pthread_self(), "FenceWatcher");
+
+    constexpr int kMaxEvents = 16;
+    epoll_event events[kMaxEvents];
+    while (true) {
+        int count = epoll_wait(mEpollFd, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ALOGE("FenceWatcher: epoll_wait failed: %s", strerror(errno));
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+            std::shared_ptr<FenceTime> fenceTime;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                auto it = mWatchedFences.find(fd);
+                if (it != mWatchedFences.end()) {
+                    fenceTime = it->second.lock();
+                    mWatchedFences.erase(it);
+                }
+                epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+            }
+            if (fenceTime != nullptr) {
+                // One ioctl, issued exactly once per fence; this publishes
+                // the timestamp into the shared FenceTime so every other
+                // holder hits the cache.
+                fenceTime->getSignalTime();
+            }
+            close(fd);
+        }
+    }
+}
+
 // ============================================================================
 // FenceToFenceTimeMap
 // ============================================================================
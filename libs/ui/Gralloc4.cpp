@@ -771,6 +771,39 @@ status_t Gralloc4Mapper::setSmpte2094_10(buffer_handle_t bufferHandle,
                gralloc4::encodeSmpte2094_10);
 }
 
+status_t Gralloc4Mapper::getHdrMetadata(buffer_handle_t bufferHandle,
+                                        BufferHdrMetadata* outMetadata) const {
+    if (!outMetadata) {
+        return BAD_VALUE;
+    }
+    *outMetadata = BufferHdrMetadata();
+
+    // IMapper 4.0 only accepts a single MetadataType per get(), so the batch is a sequence of
+    // gets under the hood. A field the implementation does not carry for this buffer is not an
+    // error for the batch; it just stays at its default.
+    const auto isFatal = [](status_t error) {
+        return error != NO_ERROR && error != static_cast<status_t>(Error::UNSUPPORTED);
+    };
+
+    status_t error = getDataspace(bufferHandle, &outMetadata->dataspace);
+    if (isFatal(error)) {
+        return error;
+    }
+    error = getSmpte2086(bufferHandle, &outMetadata->smpte2086);
+    if (isFatal(error)) {
+        return error;
+    }
+    error = getCta861_3(bufferHandle, &outMetadata->cta861_3);
+    if (isFatal(error)) {
+        return error;
+    }
+    error = getSmpte2094_40(bufferHandle, &outMetadata->smpte2094_40);
+    if (isFatal(error)) {
+        return error;
+    }
+    return NO_ERROR;
+}
+
 template <class T>
 status_t Gralloc4Mapper::getDefault(uint32_t width, uint32_t height, PixelFormat format,
                                     uint32_t layerCount, uint64_t usage,
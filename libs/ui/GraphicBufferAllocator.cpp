@@ -46,6 +46,14 @@ ANDROID_SINGLETON_STATIC_INSTANCE( GraphicBufferAllocator )
 Mutex GraphicBufferAllocator::sLock;
 KeyedVector<buffer_handle_t,
     GraphicBufferAllocator::alloc_rec_t> GraphicBufferAllocator::sAllocList;
+std::list<GraphicBufferAllocator::pooled_buffer_t> GraphicBufferAllocator::sBufferPool;
+bool GraphicBufferAllocator::sBufferPoolEnabled = false;
+
+// Tuning for the opt-in recycling pool. Allocation storms (app launch, display mode switches)
+// free and re-allocate identical-geometry buffers within a couple of seconds, so pooled buffers
+// only need to survive briefly, and a handful of them covers the working set.
+static constexpr size_t MAX_POOLED_BUFFERS = 8;
+static constexpr nsecs_t BUFFER_POOL_TTL = s2ns(2);
 
 GraphicBufferAllocator::GraphicBufferAllocator() : mMapper(GraphicBufferMapper::getInstance()) {
     mAllocator = std::make_unique<const Gralloc4Allocator>(
@@ -98,6 +106,10 @@ void GraphicBufferAllocator::dump(std::string& result, bool less) const {
     }
     StringAppendF(&result, "Total allocated by GraphicBufferAllocator (estimate): %.2f KB\n",
                   static_cast<double>(total) / 1024.0);
+    if (sBufferPoolEnabled || !sBufferPool.empty()) {
+        StringAppendF(&result, "Buffer pool: %zu buffers%s\n", sBufferPool.size(),
+                      sBufferPoolEnabled ? "" : " (disabled)");
+    }
 
     result.append(mAllocator->dumpDebugInfo(less));
 }
@@ -135,6 +147,12 @@ status_t GraphicBufferAllocator::allocateHelper(uint32_t width, uint32_t height,
     // TODO(b/72323293, b/72703005): Remove these invalid bits from callers
     usage &= ~static_cast<uint64_t>((1 << 10) | (1 << 13));
 
+    if (importBuffer &&
+        allocateFromPool(width, height, format, layerCount, usage, handle, stride,
+                         &requestorName)) {
+        return NO_ERROR;
+    }
+
     status_t error = mAllocator->allocate(requestorName, width, height, format, layerCount, usage,
                                           1, stride, handle, importBuffer);
     if (error != NO_ERROR) {
@@ -202,6 +220,30 @@ status_t GraphicBufferAllocator::free(buffer_handle_t handle)
 {
     ATRACE_CALL();
 
+    std::vector<buffer_handle_t> evicted;
+    bool pooled = false;
+    {
+        Mutex::Autolock _l(sLock);
+        if (sBufferPoolEnabled) {
+            // Keep the buffer briefly available for reuse instead of freeing it, if we know its
+            // geometry (i.e. it was allocated and imported through this class).
+            const ssize_t index = sAllocList.indexOfKey(handle);
+            if (index >= 0) {
+                const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+                sBufferPool.push_back(pooled_buffer_t{handle, sAllocList.valueAt(index), now});
+                sAllocList.removeItemsAt(index);
+                evictStaleBuffersLocked(now, &evicted);
+                pooled = true;
+            }
+        }
+    }
+    for (buffer_handle_t evictedHandle : evicted) {
+        mMapper.freeBuffer(evictedHandle);
+    }
+    if (pooled) {
+        return NO_ERROR;
+    }
+
     // We allocated a buffer from the allocator and imported it into the
     // mapper to get the handle.  We just need to free the handle now.
     mMapper.freeBuffer(handle);
@@ -213,5 +255,78 @@ status_t GraphicBufferAllocator::free(buffer_handle_t handle)
     return NO_ERROR;
 }
 
+bool GraphicBufferAllocator::allocateFromPool(uint32_t width, uint32_t height, PixelFormat format,
+                                              uint32_t layerCount, uint64_t usage,
+                                              buffer_handle_t* handle, uint32_t* stride,
+                                              std::string* requestorName) {
+    std::vector<buffer_handle_t> evicted;
+    bool found = false;
+    {
+        Mutex::Autolock _l(sLock);
+        if (!sBufferPoolEnabled) {
+            return false;
+        }
+        evictStaleBuffersLocked(systemTime(SYSTEM_TIME_MONOTONIC), &evicted);
+        for (auto it = sBufferPool.begin(); it != sBufferPool.end(); ++it) {
+            const alloc_rec_t& rec = it->rec;
+            if (rec.width == width && rec.height == height && rec.format == format &&
+                rec.layerCount == layerCount && rec.usage == usage) {
+                *handle = it->handle;
+                *stride = rec.stride;
+                alloc_rec_t reused = rec;
+                reused.requestorName = std::move(*requestorName);
+                sAllocList.add(*handle, reused);
+                sBufferPool.erase(it);
+                found = true;
+                break;
+            }
+        }
+    }
+    for (buffer_handle_t evictedHandle : evicted) {
+        mMapper.freeBuffer(evictedHandle);
+    }
+    return found;
+}
+
+void GraphicBufferAllocator::evictStaleBuffersLocked(nsecs_t now,
+                                                     std::vector<buffer_handle_t>* outHandles) {
+    while (!sBufferPool.empty() &&
+           (sBufferPool.size() > MAX_POOLED_BUFFERS ||
+            now - sBufferPool.front().freeTimeNs > BUFFER_POOL_TTL)) {
+        outHandles->push_back(sBufferPool.front().handle);
+        sBufferPool.pop_front();
+    }
+}
+
+void GraphicBufferAllocator::flushBufferPool(bool disable) {
+    std::vector<buffer_handle_t> evicted;
+    {
+        Mutex::Autolock _l(sLock);
+        if (disable) {
+            sBufferPoolEnabled = false;
+        }
+        for (const pooled_buffer_t& pooled : sBufferPool) {
+            evicted.push_back(pooled.handle);
+        }
+        sBufferPool.clear();
+    }
+    for (buffer_handle_t evictedHandle : evicted) {
+        mMapper.freeBuffer(evictedHandle);
+    }
+}
+
+void GraphicBufferAllocator::setBufferPoolEnabled(bool enabled) {
+    if (!enabled) {
+        flushBufferPool(true /* disable */);
+        return;
+    }
+    Mutex::Autolock _l(sLock);
+    sBufferPoolEnabled = true;
+}
+
+void GraphicBufferAllocator::trimBufferPool() {
+    flushBufferPool(false /* disable */);
+}
+
 // ---------------------------------------------------------------------------
 }; // namespace android
@@ -330,6 +330,11 @@ status_t GraphicBufferMapper::setSmpte2094_10(buffer_handle_t bufferHandle,
     return mMapper->setSmpte2094_10(bufferHandle, smpte2094_10);
 }
 
+status_t GraphicBufferMapper::getHdrMetadata(buffer_handle_t bufferHandle,
+                                             BufferHdrMetadata* outMetadata) {
+    return mMapper->getHdrMetadata(bufferHandle, outMetadata);
+}
+
 status_t GraphicBufferMapper::getDefaultPixelFormatFourCC(uint32_t width, uint32_t height,
                                                           PixelFormat format, uint32_t layerCount,
                                                           uint64_t usage,
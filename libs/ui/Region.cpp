@@ -653,6 +653,50 @@ void Region::boolean_operation(uint32_t op, Region& dst,
     validate(dst, "boolean_operation (before): dst");
 #endif
 
+#if !defined(VALIDATE_REGIONS) && !VALIDATE_WITH_CORECG
+    // Fast paths for the trivial combinations SurfaceFlinger's visibility computation hits
+    // constantly: an empty operand, or operands whose bounds don't even touch. Both operands
+    // are already well-formed regions, so the result can be produced without running the
+    // band-merge machinery. Note that dst may alias lhs or rhs.
+    const bool lhsEmpty = lhs.isEmpty();
+    const bool rhsEmpty = rhs.isEmpty();
+    if (lhsEmpty || rhsEmpty) {
+        switch (op) {
+            case op_or:
+            case op_xor:
+                if (rhsEmpty) {
+                    dst = lhs;
+                } else {
+                    dst = rhs;
+                    dst.translateSelf(dx, dy);
+                }
+                return;
+            case op_and:
+                dst.clear();
+                return;
+            case op_nand:
+                dst = lhs;
+                return;
+        }
+    }
+    Rect rhsBounds(rhs.getBounds());
+    rhsBounds.offsetBy(dx, dy);
+    Rect boundsIntersection;
+    if (!lhs.getBounds().intersect(rhsBounds, &boundsIntersection)) {
+        if (op == op_and) {
+            dst.clear();
+            return;
+        }
+        if (op == op_nand) {
+            dst = lhs;
+            return;
+        }
+    } else if (op == op_and && lhs.isRect() && rhs.isRect()) {
+        dst.set(boundsIntersection);
+        return;
+    }
+#endif
+
     size_t lhs_count;
     Rect const * const lhs_rects = lhs.getArray(&lhs_count);
 
@@ -767,6 +811,44 @@ void Region::boolean_operation(uint32_t op, Region& dst,
 #if VALIDATE_WITH_CORECG || defined(VALIDATE_REGIONS)
     boolean_operation(op, dst, lhs, Region(rhs), dx, dy);
 #else
+    // Same trivial-case fast paths as the Region flavor of this function.
+    Rect rhsBounds(rhs);
+    rhsBounds.offsetBy(dx, dy);
+    const bool lhsEmpty = lhs.isEmpty();
+    const bool rhsEmpty = rhsBounds.isEmpty();
+    if (lhsEmpty || rhsEmpty) {
+        switch (op) {
+            case op_or:
+            case op_xor:
+                if (rhsEmpty) {
+                    dst = lhs;
+                } else {
+                    dst.set(rhsBounds);
+                }
+                return;
+            case op_and:
+                dst.clear();
+                return;
+            case op_nand:
+                dst = lhs;
+                return;
+        }
+    }
+    Rect boundsIntersection;
+    if (!lhs.getBounds().intersect(rhsBounds, &boundsIntersection)) {
+        if (op == op_and) {
+            dst.clear();
+            return;
+        }
+        if (op == op_nand) {
+            dst = lhs;
+            return;
+        }
+    } else if (op == op_and && lhs.isRect()) {
+        dst.set(boundsIntersection);
+        return;
+    }
+
     size_t lhs_count;
     Rect const * const lhs_rects = lhs.getArray(&lhs_count);
 
@@ -81,9 +81,11 @@ Transform Transform::operator*(const Transform& rhs) const {
     }
     r.mType |= rhs.mType;
 
-    // TODO: we could recompute this value from r and rhs
     r.mType &= 0xFF;
     r.mType |= UNKNOWN_TYPE;
+    // Classify eagerly: a composed transform is queried many times per frame
+    // (getType, getOrientation, preserveRects) but composed only once.
+    r.type();
     return r;
 }
 
@@ -173,6 +175,7 @@ void Transform::set(float a, float b, float c, float d) {
     M[0][1] = c;    M[1][1] = d;
     M[0][2] = 0;    M[1][2] = 0;
     mType = UNKNOWN_TYPE;
+    type();
 }
 
 status_t Transform::set(uint32_t flags, float w, float h) {
@@ -251,7 +254,38 @@ Rect Transform::makeBounds(int w, int h) const {
     return transform( Rect(w, h) );
 }
 
+Rect Transform::transformAxisAligned(const Rect& bounds, bool roundOutwards) const {
+    // With no skew and only multiples of 90 degrees of rotation (including
+    // ROT_90), two opposite corners fully determine the mapped rect; the
+    // other two corners contribute no new coordinates.
+    const vec2 lt = transform(float(bounds.left), float(bounds.top));
+    const vec2 rb = transform(float(bounds.right), float(bounds.bottom));
+
+    const float left   = std::min(lt[0], rb[0]);
+    const float top    = std::min(lt[1], rb[1]);
+    const float right  = std::max(lt[0], rb[0]);
+    const float bottom = std::max(lt[1], rb[1]);
+
+    Rect r;
+    if (roundOutwards) {
+        r.left   = static_cast<int32_t>(floorf(left));
+        r.top    = static_cast<int32_t>(floorf(top));
+        r.right  = static_cast<int32_t>(ceilf(right));
+        r.bottom = static_cast<int32_t>(ceilf(bottom));
+    } else {
+        r.left   = static_cast<int32_t>(floorf(left + 0.5f));
+        r.top    = static_cast<int32_t>(floorf(top + 0.5f));
+        r.right  = static_cast<int32_t>(floorf(right + 0.5f));
+        r.bottom = static_cast<int32_t>(floorf(bottom + 0.5f));
+    }
+    return r;
+}
+
 Rect Transform::transform(const Rect& bounds, bool roundOutwards) const {
+    if (CC_LIKELY(preserveRects())) {
+        return transformAxisAligned(bounds, roundOutwards);
+    }
+
     Rect r;
     vec2 lt( bounds.left,  bounds.top    );
     vec2 rt( bounds.right, bounds.top    );
@@ -278,7 +312,33 @@ Rect Transform::transform(const Rect& bounds, bool roundOutwards) const {
     return r;
 }
 
+void Transform::transform(Rect* rects, size_t count, bool roundOutwards) const {
+    if (CC_LIKELY(preserveRects())) {
+        // The transform is classified once up front; the per-rect kernel
+        // then maps only two corners per rect.
+        for (size_t i = 0; i < count; i++) {
+            rects[i] = transformAxisAligned(rects[i], roundOutwards);
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            rects[i] = transform(rects[i], roundOutwards);
+        }
+    }
+}
+
 FloatRect Transform::transform(const FloatRect& bounds) const {
+    if (CC_LIKELY(preserveRects())) {
+        const vec2 lt = transform(bounds.left, bounds.top);
+        const vec2 rb = transform(bounds.right, bounds.bottom);
+
+        FloatRect r;
+        r.left = std::min(lt[0], rb[0]);
+        r.top = std::min(lt[1], rb[1]);
+        r.right = std::max(lt[0], rb[0]);
+        r.bottom = std::max(lt[1], rb[1]);
+        return r;
+    }
+
     vec2 lt(bounds.left, bounds.top);
     vec2 rt(bounds.right, bounds.top);
     vec2 lb(bounds.left, bounds.bottom);
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ui/ColorSpace.h>
+
+#include <cstring>
+#include <vector>
+
+namespace android {
+
+namespace {
+
+// A thumbnail-sized image, the typical workload for CPU-side conversion.
+constexpr size_t PIXEL_COUNT = 256 * 256;
+
+std::vector<float3> makePixels() {
+    std::vector<float3> pixels(PIXEL_COUNT);
+    for (size_t i = 0; i < PIXEL_COUNT; i++) {
+        const float v = float(i % 256) / 255.0f;
+        pixels[i] = float3{v, 1.0f - v, 0.5f * v};
+    }
+    return pixels;
+}
+
+} // namespace
+
+// Per-pixel conversion through the std::function-based connector.
+static void benchmarkConnectorTransform(benchmark::State& state) {
+    const ColorSpaceConnector connector(ColorSpace::sRGB(), ColorSpace::DisplayP3());
+    const std::vector<float3> src = makePixels();
+    std::vector<float3> dst(PIXEL_COUNT);
+    for (auto _ : state) {
+        for (size_t i = 0; i < PIXEL_COUNT; i++) {
+            dst[i] = connector.transform(src[i]);
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * PIXEL_COUNT);
+}
+BENCHMARK(benchmarkConnectorTransform);
+
+// The same conversion through the precomputed LUT connector.
+static void benchmarkCompiledConnectorTransform(benchmark::State& state) {
+    const CompiledColorSpaceConnector connector(ColorSpace::sRGB(), ColorSpace::DisplayP3());
+    const std::vector<float3> src = makePixels();
+    std::vector<float3> dst(PIXEL_COUNT);
+    for (auto _ : state) {
+        for (size_t i = 0; i < PIXEL_COUNT; i++) {
+            dst[i] = connector.transform(src[i]);
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * PIXEL_COUNT);
+}
+BENCHMARK(benchmarkCompiledConnectorTransform);
+
+// Copying the same pixels, as a lower bound on per-pixel cost.
+static void benchmarkMemcpyBaseline(benchmark::State& state) {
+    const std::vector<float3> src = makePixels();
+    std::vector<float3> dst(PIXEL_COUNT);
+    for (auto _ : state) {
+        memcpy(dst.data(), src.data(), PIXEL_COUNT * sizeof(float3));
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetItemsProcessed(state.iterations() * PIXEL_COUNT);
+}
+BENCHMARK(benchmarkMemcpyBaseline);
+
+} // namespace android
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <ui/Region.h>
+
+namespace android {
+
+namespace {
+
+constexpr int32_t WIDTH = 1080;
+constexpr int32_t HEIGHT = 2400;
+
+// A screen-sized region with a floating window punched out of the middle, the typical shape of
+// the "above opaque layers" region during SurfaceFlinger's visibility computation.
+Region makePunchedScreen() {
+    Region region(Rect(WIDTH, HEIGHT));
+    region.subtractSelf(Rect(200, 600, 880, 1400));
+    return region;
+}
+
+} // namespace
+
+// Subtracting a non-overlapping opaque layer, the most common no-op case.
+static void benchmarkSubtractDisjoint(benchmark::State& state) {
+    const Region screen(Rect(WIDTH, HEIGHT));
+    const Rect below(0, HEIGHT + 100, WIDTH, HEIGHT + 200);
+    for (auto _ : state) {
+        Region visible(screen);
+        visible.subtractSelf(below);
+        benchmark::DoNotOptimize(visible.isEmpty());
+    }
+}
+BENCHMARK(benchmarkSubtractDisjoint);
+
+// Subtracting an overlapping opaque layer from the full screen.
+static void benchmarkSubtractOverlapping(benchmark::State& state) {
+    const Region screen(Rect(WIDTH, HEIGHT));
+    const Rect window(200, 600, 880, 1400);
+    for (auto _ : state) {
+        Region visible(screen);
+        visible.subtractSelf(window);
+        benchmark::DoNotOptimize(visible.isEmpty());
+    }
+}
+BENCHMARK(benchmarkSubtractOverlapping);
+
+// Intersecting two plain rectangles, e.g. clipping a visible region to a display.
+static void benchmarkIntersectRects(benchmark::State& state) {
+    const Region lhs(Rect(100, 100, WIDTH, HEIGHT));
+    const Rect rhs(0, 0, 900, 1800);
+    for (auto _ : state) {
+        Region clipped(lhs);
+        clipped.andSelf(rhs);
+        benchmark::DoNotOptimize(clipped.isEmpty());
+    }
+}
+BENCHMARK(benchmarkIntersectRects);
+
+// Intersecting a multi-rect region with a rectangle.
+static void benchmarkIntersectComplex(benchmark::State& state) {
+    const Region punched = makePunchedScreen();
+    const Rect rhs(0, 0, 900, 1800);
+    for (auto _ : state) {
+        Region clipped(punched);
+        clipped.andSelf(rhs);
+        benchmark::DoNotOptimize(clipped.isEmpty());
+    }
+}
+BENCHMARK(benchmarkIntersectComplex);
+
+// Accumulating the opaque region of a stack of non-overlapping layers.
+static void benchmarkOrAccumulate(benchmark::State& state) {
+    for (auto _ : state) {
+        Region opaque;
+        for (int32_t i = 0; i < 10; i++) {
+            opaque.orSelf(Rect(0, i * 240, WIDTH, i * 240 + 200));
+        }
+        benchmark::DoNotOptimize(opaque.isEmpty());
+    }
+}
+BENCHMARK(benchmarkOrAccumulate);
+
+} // namespace android
+
+BENCHMARK_MAIN();
@@ -25,6 +25,7 @@
 #include <atomic>
 #include <mutex>
 #include <queue>
+#include <thread>
 #include <unordered_map>
 
 namespace android {
@@ -170,6 +171,45 @@ private:
     std::queue<std::weak_ptr<FenceTime>> mQueue GUARDED_BY(mMutex);
 };
 
+// A process-wide service that resolves FenceTime signal times as the fences
+// actually signal, instead of leaving every consumer to poll with its own
+// SYNC_IOC_FILE_INFO ioctl.
+//
+// A single lazily-started thread epolls duplicates of the pending fence fds
+// and calls FenceTime::getSignalTime() once per fence when the kernel reports
+// it signaled. Since the timestamp is published into the shared FenceTime,
+// every other subsystem holding the same FenceTime then hits the cache and
+// never blocks or re-issues the ioctl.
+//
+// Like FenceTimeline, this is best effort: the watcher only keeps a weak
+// reference and bounds the number of watched fences, so users must still be
+// able to fall back to FenceTime::getSignalTime() on their own.
+//
+// watch() is safe to call from any thread.
+class FenceWatcher {
+public:
+    static constexpr size_t MAX_WATCHED_FENCES = 64;
+
+    static FenceWatcher& getInstance();
+
+    // Starts watching the fence if it is valid and still pending. No-op
+    // otherwise, or if the watcher is already at capacity.
+    void watch(const std::shared_ptr<FenceTime>& fenceTime);
+
+private:
+    FenceWatcher();
+
+    void threadLoop();
+
+    int mEpollFd{-1};
+
+    mutable std::mutex mMutex;
+    // Keyed by the duplicated fd registered with epoll, which the watcher
+    // owns and closes once the fence signals.
+    std::unordered_map<int, std::weak_ptr<FenceTime>> mWatchedFences GUARDED_BY(mMutex);
+    std::thread mThread;
+};
+
 // Used by test code to create or get FenceTimes for a given Fence.
 //
 // By design, Fences cannot be signaled from user space. However, this class
@@ -28,6 +28,15 @@
 
 namespace android {
 
+// The dataspace and HDR metadata fields that video playback queries for every buffer. Bundled so
+// callers fetch them with one mapper call instead of one per field.
+struct BufferHdrMetadata {
+    ui::Dataspace dataspace = ui::Dataspace::UNKNOWN;
+    std::optional<ui::Smpte2086> smpte2086;
+    std::optional<ui::Cta861_3> cta861_3;
+    std::optional<std::vector<uint8_t>> smpte2094_40;
+};
+
 // A wrapper to IMapper
 class GrallocMapper {
 public:
@@ -203,6 +212,13 @@ public:
                                      std::optional<std::vector<uint8_t>> /*smpte2094_10*/) const {
         return INVALID_OPERATION;
     }
+    // Queries the dataspace and the HDR metadata blobs in one call. Fields the gralloc
+    // implementation does not carry for the buffer are left at their defaults rather than
+    // failing the whole query.
+    virtual status_t getHdrMetadata(buffer_handle_t /*bufferHandle*/,
+                                    BufferHdrMetadata* /*outMetadata*/) const {
+        return INVALID_OPERATION;
+    }
     virtual status_t getDefaultPixelFormatFourCC(uint32_t /*width*/, uint32_t /*height*/,
                                                  PixelFormat /*format*/, uint32_t /*layerCount*/,
                                                  uint64_t /*usage*/,
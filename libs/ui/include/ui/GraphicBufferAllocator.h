@@ -20,8 +20,10 @@
 
 #include <stdint.h>
 
+#include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <cutils/native_handle.h>
 
@@ -31,6 +33,7 @@
 #include <utils/KeyedVector.h>
 #include <utils/Mutex.h>
 #include <utils/Singleton.h>
+#include <utils/Timers.h>
 
 namespace android {
 
@@ -72,6 +75,20 @@ public:
 
     status_t free(buffer_handle_t handle);
 
+    /**
+     * Enables or disables the buffer recycling pool for this process. While enabled, free()
+     * briefly keeps just-freed imported buffers and allocate() reuses one on a matching
+     * (w, h, format, layerCount, usage) request instead of round-tripping to the gralloc HAL,
+     * which helps processes that allocate and free identical-geometry buffers in bursts.
+     * Disabling the pool frees all pooled buffers. The pool is disabled by default.
+     */
+    void setBufferPoolEnabled(bool enabled);
+
+    /**
+     * Frees all pooled buffers. Call on memory pressure; the pool stays enabled.
+     */
+    void trimBufferPool();
+
     uint64_t getTotalSize() const;
 
     void dump(std::string& res, bool less = true) const;
@@ -89,13 +106,35 @@ protected:
         std::string requestorName;
     };
 
+    struct pooled_buffer_t {
+        buffer_handle_t handle;
+        alloc_rec_t rec;
+        nsecs_t freeTimeNs;
+    };
+
     status_t allocateHelper(uint32_t w, uint32_t h, PixelFormat format, uint32_t layerCount,
                             uint64_t usage, buffer_handle_t* handle, uint32_t* stride,
                             std::string requestorName, bool importBuffer);
 
+    // Returns a pooled buffer matching the request, if any, transferring it back to sAllocList.
+    bool allocateFromPool(uint32_t w, uint32_t h, PixelFormat format, uint32_t layerCount,
+                          uint64_t usage, buffer_handle_t* handle, uint32_t* stride,
+                          std::string* requestorName);
+
+    // Evicts pooled buffers beyond the size cap and those older than the TTL, oldest first.
+    // Appends their handles to *outHandles for the caller to free once sLock is dropped.
+    static void evictStaleBuffersLocked(nsecs_t now, std::vector<buffer_handle_t>* outHandles);
+
+    // Frees all pooled buffers; also disables the pool if requested.
+    void flushBufferPool(bool disable);
+
     static Mutex sLock;
     static KeyedVector<buffer_handle_t, alloc_rec_t> sAllocList;
 
+    // The recycling pool, oldest entries first. Guarded by sLock.
+    static std::list<pooled_buffer_t> sBufferPool;
+    static bool sBufferPoolEnabled;
+
     friend class Singleton<GraphicBufferAllocator>;
     GraphicBufferAllocator();
     ~GraphicBufferAllocator();
@@ -135,6 +135,7 @@ public:
                              std::optional<std::vector<uint8_t>>* outSmpte2094_10);
     status_t setSmpte2094_10(buffer_handle_t bufferHandle,
                              std::optional<std::vector<uint8_t>> smpte2094_10);
+    status_t getHdrMetadata(buffer_handle_t bufferHandle, BufferHdrMetadata* outMetadata);
 
     /**
      * Gets the default metadata for a gralloc buffer allocated with the given parameters.
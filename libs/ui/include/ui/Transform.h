@@ -95,6 +95,10 @@ public:
     Region  transform(const Region& reg) const;
     Rect    transform(const Rect& bounds,
                       bool roundOutwards = false) const;
+    // Maps many rects in place, classifying the transform a single time
+    // instead of once per rect.
+    void    transform(Rect* rects, size_t count,
+                      bool roundOutwards = false) const;
     FloatRect transform(const FloatRect& bounds) const;
     Transform& operator = (const Transform& other);
     Transform operator * (const Transform& rhs) const;
@@ -125,6 +129,7 @@ private:
     enum { UNKNOWN_TYPE = 0x80000000 };
 
     uint32_t type() const;
+    Rect transformAxisAligned(const Rect& bounds, bool roundOutwards) const;
     static bool absIsOne(float f);
     static bool isZero(float f);
 
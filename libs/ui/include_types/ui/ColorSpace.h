@@ -300,6 +300,51 @@ private:
     mat3 mTransform;
 };
 
+/**
+ * A precomputed form of ColorSpaceConnector for per-pixel CPU use.
+ *
+ * ColorSpaceConnector::transform() evaluates the source and destination
+ * transfer functions through std::function for every sample, which is far
+ * too slow for per-pixel work. This class samples the source EOTF and the
+ * destination OETF into 1D lookup tables once at construction; transform()
+ * is then two interpolated table lookups per channel and a 3x3 matrix
+ * multiply, with no indirect calls.
+ *
+ * Both color spaces must define their values in the domain [0..1], the
+ * same restriction as ColorSpace::createLUT(); inputs are clamped to that
+ * domain.
+ */
+class CompiledColorSpaceConnector {
+public:
+    static constexpr size_t LUT_SIZE = 1024;
+
+    CompiledColorSpaceConnector(const ColorSpace& src, const ColorSpace& dst) noexcept;
+
+    constexpr const mat3& getTransform() const noexcept { return mTransform; }
+
+    float3 transform(const float3& v) const noexcept {
+        const float3 linear{lookup(mToLinear, v.r),
+                            lookup(mToLinear, v.g),
+                            lookup(mToLinear, v.b)};
+        const float3 mixed{mTransform * linear};
+        return float3{lookup(mFromLinear, mixed.r),
+                      lookup(mFromLinear, mixed.g),
+                      lookup(mFromLinear, mixed.b)};
+    }
+
+private:
+    static float lookup(const std::array<float, LUT_SIZE>& lut, float v) noexcept {
+        const float x = saturate(v) * (LUT_SIZE - 1);
+        const size_t lo = size_t(x);
+        const size_t hi = lo + 1 < LUT_SIZE ? lo + 1 : LUT_SIZE - 1;
+        return lut[lo] + (lut[hi] - lut[lo]) * (x - float(lo));
+    }
+
+    mat3 mTransform;
+    std::array<float, LUT_SIZE> mToLinear;    // source EOTF, gamma -> linear
+    std::array<float, LUT_SIZE> mFromLinear;  // destination OETF, linear -> gamma
+};
+
 }; // namespace android
 
 #endif // ANDROID_UI_COLOR_SPACE
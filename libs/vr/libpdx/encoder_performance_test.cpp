@@ -487,6 +487,32 @@ int main(int /*argc*/, char** /*argv*/) {
                                 data_buffers.back().size()));
   }
 
+  // Borrowed views deserialize in place instead of copying into owning
+  // containers. Compare against the owning string tests above; the backing
+  // storage must outlive the test run.
+  std::string view_backing_string(10240, '*');
+  for (size_t len : {0, 1, 8, 64, 256}) {
+    test_runner.AddTest(GenerateContainerName("StringViewWrapper", len),
+                        StringViewWrapper<>(view_backing_string.data(), len));
+  }
+  test_runner.AddDeserializationTest(
+      GenerateContainerName("StringViewWrapper", 10240),
+      StringViewWrapper<>(view_backing_string.data(),
+                          view_backing_string.size()));
+
+  // Unlike BufferWrapper, BufferViewWrapper needs no external destination
+  // buffer and can be measured on the deserialization path as well.
+  std::vector<uint8_t> view_backing_buffer(10240);
+  for (size_t len : {0, 1, 8, 64, 256}) {
+    test_runner.AddTest(
+        GenerateContainerName("BufferViewWrapper<uint8_t>", len),
+        BufferViewWrapper<uint8_t>(view_backing_buffer.data(), len));
+  }
+  test_runner.AddDeserializationTest(
+      GenerateContainerName("BufferViewWrapper<uint8_t>", 10240),
+      BufferViewWrapper<uint8_t>(view_backing_buffer.data(),
+                                 view_backing_buffer.size()));
+
   // Various backing buffers to run the tests on.
   std::vector<TestRunner::BufferInfo> buffers;
 
@@ -18,6 +18,7 @@
 #include "buffer_wrapper.h"
 #include "string_wrapper.h"
 #include "variant.h"
+#include "view_wrapper.h"
 
 namespace android {
 namespace pdx {
@@ -451,6 +452,12 @@ inline constexpr EncodingType EncodeType(const std::string& value) {
   return EncodeStringType(value.length());
 }
 
+template <typename CharT, typename Traits>
+inline constexpr EncodingType EncodeType(
+    const StringViewWrapper<CharT, Traits>& value) {
+  return EncodeStringType(value.length());
+}
+
 template <typename T, std::size_t Size>
 inline constexpr EncodingType EncodeType(const std::array<T, Size>& /*value*/) {
   return EncodeArrayType(Size);
@@ -487,6 +494,13 @@ inline constexpr EncodingType EncodeType(const BufferWrapper<T>& value) {
                        sizeof(typename BufferWrapper<T>::value_type));
 }
 
+template <typename T>
+inline constexpr EncodingType EncodeType(const BufferViewWrapper<T>& value) {
+  // BIN size is in bytes.
+  return EncodeBinType(value.size() *
+                       sizeof(typename BufferViewWrapper<T>::value_type));
+}
+
 template <typename T, typename U>
 inline constexpr EncodingType EncodeType(const std::pair<T, U>& /*value*/) {
   return EncodeArrayType(2);
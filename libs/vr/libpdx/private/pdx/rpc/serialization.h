@@ -27,6 +27,7 @@
 #include "pointer_wrapper.h"
 #include "string_wrapper.h"
 #include "variant.h"
+#include "view_wrapper.h"
 
 namespace android {
 namespace pdx {
@@ -58,6 +59,10 @@ namespace rpc {
 //   * ArrayWrapper of any supported basic type.
 //   * BufferWrapper of any POD type.
 //   * StringWrapper of any supported char type.
+//   * BufferViewWrapper of any POD type; deserialization borrows directly
+//     from the receive buffer instead of copying.
+//   * StringViewWrapper of any supported char type; deserialization borrows
+//     directly from the receive buffer instead of copying.
 //   * User types with correctly defined SerializableMembers member type.
 //
 // Planned support for:
@@ -256,8 +261,13 @@ inline constexpr std::size_t GetSerializedSize(const PointerWrapper<T>&);
 inline constexpr std::size_t GetSerializedSize(const std::string&);
 template <typename T>
 inline constexpr std::size_t GetSerializedSize(const StringWrapper<T>&);
+template <typename CharT, typename Traits>
+inline constexpr std::size_t GetSerializedSize(
+    const StringViewWrapper<CharT, Traits>&);
 template <typename T>
 inline constexpr std::size_t GetSerializedSize(const BufferWrapper<T>&);
+template <typename T>
+inline constexpr std::size_t GetSerializedSize(const BufferViewWrapper<T>&);
 template <FileHandleMode Mode>
 inline constexpr std::size_t GetSerializedSize(const FileHandle<Mode>&);
 template <ChannelHandleMode Mode>
@@ -319,6 +329,14 @@ inline constexpr std::size_t GetSerializedSize(const StringWrapper<T>& s) {
          s.length() * sizeof(typename StringWrapper<T>::value_type);
 }
 
+// Overload for StringViewWrapper.
+template <typename CharT, typename Traits>
+inline constexpr std::size_t GetSerializedSize(
+    const StringViewWrapper<CharT, Traits>& s) {
+  return GetEncodingSize(EncodeType(s)) +
+         s.length() * sizeof(typename StringViewWrapper<CharT>::value_type);
+}
+
 // Overload for BufferWrapper types.
 template <typename T>
 inline constexpr std::size_t GetSerializedSize(const BufferWrapper<T>& b) {
@@ -326,6 +344,13 @@ inline constexpr std::size_t GetSerializedSize(const BufferWrapper<T>& b) {
          b.size() * sizeof(typename BufferWrapper<T>::value_type);
 }
 
+// Overload for BufferViewWrapper types.
+template <typename T>
+inline constexpr std::size_t GetSerializedSize(const BufferViewWrapper<T>& b) {
+  return GetEncodingSize(EncodeType(b)) +
+         b.size() * sizeof(typename BufferViewWrapper<T>::value_type);
+}
+
 // Overload for FileHandle. FileHandle is encoded as a FIXEXT2, with a type code
 // of "FileHandle" and a signed 16-bit offset into the pushed fd array. Empty
 // FileHandles are encoded with an array index of -1.
@@ -546,6 +571,11 @@ template <typename T>
 inline void SerializeType(const StringWrapper<T>& value, void*& buffer) {
   SerializeStringType(value, buffer);
 }
+template <typename CharT, typename Traits>
+inline void SerializeType(const StringViewWrapper<CharT, Traits>& value,
+                          void*& buffer) {
+  SerializeStringType(value, buffer);
+}
 
 // Serializes the type code for bin types.
 inline void SerializeBinEncoding(EncodingType encoding, std::size_t size,
@@ -574,6 +604,15 @@ inline void SerializeType(const BufferWrapper<T>& value, void*& buffer) {
       buffer);
 }
 
+// Serializes the type code for BufferViewWrapper types.
+template <typename T>
+inline void SerializeType(const BufferViewWrapper<T>& value, void*& buffer) {
+  const EncodingType encoding = EncodeType(value);
+  SerializeBinEncoding(
+      encoding,
+      value.size() * sizeof(typename BufferViewWrapper<T>::value_type), buffer);
+}
+
 // Serializes the array encoding type and length.
 inline void SerializeArrayEncoding(EncodingType encoding, std::size_t size,
                                    void*& buffer) {
@@ -850,9 +889,13 @@ template <typename T, typename Allocator>
 inline void SerializeObject(const BufferWrapper<std::vector<T, Allocator>>&, MessageWriter*, void*&);
 template <typename T>
 inline void SerializeObject(const BufferWrapper<T*>&, MessageWriter*, void*&);
+template <typename T>
+inline void SerializeObject(const BufferViewWrapper<T>&, MessageWriter*, void*&);
 inline void SerializeObject(const std::string&, MessageWriter*, void*&);
 template <typename T>
 inline void SerializeObject(const StringWrapper<T>&, MessageWriter*, void*&);
+template <typename CharT, typename Traits>
+inline void SerializeObject(const StringViewWrapper<CharT, Traits>&, MessageWriter*, void*&);
 template <typename T, typename Allocator>
 inline void SerializeObject(const std::vector<T, Allocator>&, MessageWriter*, void*&);
 template <typename T>
@@ -941,6 +984,17 @@ inline void SerializeObject(const BufferWrapper<T*>& b,
   WriteRawData(buffer, b.data(), b.size() * value_type_size);
 }
 
+// Serializes the payload of BufferViewWrapper types. These serialize to the
+// same format as BufferWrapper and the two are interchangeable.
+template <typename T>
+inline void SerializeObject(const BufferViewWrapper<T>& b,
+                            MessageWriter* /*writer*/, void*& buffer) {
+  const auto value_type_size =
+      sizeof(typename BufferViewWrapper<T>::value_type);
+  SerializeType(b, buffer);
+  WriteRawData(buffer, b.data(), b.size() * value_type_size);
+}
+
 // Serializes the payload of string types.
 template <typename StringType>
 inline void SerializeString(const StringType& s, void*& buffer) {
@@ -960,6 +1014,11 @@ inline void SerializeObject(const StringWrapper<T>& s,
                             MessageWriter* /*writer*/, void*& buffer) {
   SerializeString(s, buffer);
 }
+template <typename CharT, typename Traits>
+inline void SerializeObject(const StringViewWrapper<CharT, Traits>& s,
+                            MessageWriter* /*writer*/, void*& buffer) {
+  SerializeString(s, buffer);
+}
 
 // Serializes the payload of array types.
 template <typename ArrayType>
@@ -1397,11 +1456,17 @@ inline ErrorType DeserializeObject(BufferWrapper<std::vector<T, Allocator>>*,
 template <typename T>
 inline ErrorType DeserializeObject(BufferWrapper<T*>*, MessageReader*,
                                    const void*&, const void*&);
+template <typename T>
+inline ErrorType DeserializeObject(BufferViewWrapper<T>*, MessageReader*,
+                                   const void*&, const void*&);
 inline ErrorType DeserializeObject(std::string*, MessageReader*, const void*&,
                                    const void*&);
 template <typename T>
 inline ErrorType DeserializeObject(StringWrapper<T>*, MessageReader*,
                                    const void*&, const void*&);
+template <typename CharT, typename Traits>
+inline ErrorType DeserializeObject(StringViewWrapper<CharT, Traits>*,
+                                   MessageReader*, const void*&, const void*&);
 template <typename T, typename U>
 inline ErrorType DeserializeObject(std::pair<T, U>*, MessageReader*,
                                    const void*&, const void*&);
@@ -1609,6 +1674,43 @@ inline ErrorType DeserializeObject(BufferWrapper<T*>* value,
   }
 }
 
+// Overload of DeserializeObject() for BufferViewWrapper types. Instead of
+// copying the payload into caller-provided storage, the view is pointed
+// directly at the payload bytes within the receive buffer. The entire payload
+// must reside in the current read buffer section, consistent with the
+// single-section fast path in ReadRawData(). The view remains valid only as
+// long as the receive buffer itself.
+template <typename T>
+inline ErrorType DeserializeObject(BufferViewWrapper<T>* value,
+                                   MessageReader* reader, const void*& start,
+                                   const void*& end) {
+  const auto value_type_size =
+      sizeof(typename BufferViewWrapper<T>::value_type);
+  EncodingType encoding;
+  std::size_t size;
+
+  if (const auto error =
+          DeserializeBinType(&encoding, &size, reader, start, end))
+    return error;
+
+  if (size == 0U) {
+    value->Set(nullptr, 0);
+    return ErrorCode::NO_ERROR;
+  } else if (size % value_type_size != 0 ||
+             reinterpret_cast<std::uintptr_t>(start) % alignof(T) != 0) {
+    return ErrorType(ErrorCode::UNEXPECTED_TYPE_SIZE, ENCODING_CLASS_BINARY,
+                     encoding);
+  } else if (AdvancePointer(start, size) > end) {
+    // The payload straddles a read buffer section boundary and cannot be
+    // viewed contiguously.
+    return ErrorCode::INSUFFICIENT_BUFFER;
+  } else {
+    value->Set(static_cast<const T*>(start), size / value_type_size);
+    start = AdvancePointer(start, size);
+    return ErrorCode::NO_ERROR;
+  }
+}
+
 // Deserializes the type code and size for string types.
 inline ErrorType DeserializeStringType(EncodingType* encoding,
                                        std::size_t* size, MessageReader* reader,
@@ -1674,6 +1776,40 @@ inline ErrorType DeserializeObject(StringWrapper<T>* value,
   }
 }
 
+// Overload of DeserializeObject() for StringViewWrapper types. The view is
+// pointed directly at the payload bytes within the receive buffer rather than
+// copying them out; the same section and lifetime constraints as
+// BufferViewWrapper apply.
+template <typename CharT, typename Traits>
+inline ErrorType DeserializeObject(StringViewWrapper<CharT, Traits>* value,
+                                   MessageReader* reader, const void*& start,
+                                   const void*& end) {
+  const auto value_type_size =
+      sizeof(typename StringViewWrapper<CharT, Traits>::value_type);
+  EncodingType encoding;
+  std::size_t size;
+
+  if (const auto error =
+          DeserializeStringType(&encoding, &size, reader, start, end))
+    return error;
+
+  if (size == 0U) {
+    value->Set(nullptr, 0);
+    return ErrorCode::NO_ERROR;
+  } else if (size % value_type_size != 0) {
+    return ErrorType(ErrorCode::UNEXPECTED_TYPE_SIZE, ENCODING_CLASS_STRING,
+                     encoding);
+  } else if (AdvancePointer(start, size) > end) {
+    // The payload straddles a read buffer section boundary and cannot be
+    // viewed contiguously.
+    return ErrorCode::INSUFFICIENT_BUFFER;
+  } else {
+    value->Set(static_cast<const CharT*>(start), size / value_type_size);
+    start = AdvancePointer(start, size);
+    return ErrorCode::NO_ERROR;
+  }
+}
+
 // Deserializes the type code and size of array types.
 inline ErrorType DeserializeArrayType(EncodingType* encoding, std::size_t* size,
                                       MessageReader* reader, const void*& start,
@@ -0,0 +1,151 @@
+#ifndef ANDROID_PDX_RPC_VIEW_WRAPPER_H_
+#define ANDROID_PDX_RPC_VIEW_WRAPPER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace android {
+namespace pdx {
+namespace rpc {
+
+// Non-owning, read-only views over serialized payload data, providing an
+// interface suitable for SerializeObject and DeserializeObject. Unlike
+// StringWrapper and BufferWrapper, which copy the payload into storage
+// provided by the caller, these views are pointed directly at the receive
+// buffer during deserialization, eliminating the per-message copy and any
+// backing allocation. The viewed data is only valid until the receive buffer
+// is reused or destroyed: consume or copy the payload before returning
+// control to the message dispatch loop.
+
+// View of a string payload. Serializes to the same format as
+// std::basic_string and StringWrapper and may be substituted for either
+// during serialization and deserialization.
+template <typename CharT = std::string::value_type,
+          typename Traits = std::char_traits<CharT>>
+class StringViewWrapper {
+ public:
+  // Define types in the style of STL strings to support STL operators.
+  typedef Traits traits_type;
+  typedef typename Traits::char_type value_type;
+  typedef std::size_t size_type;
+  typedef const value_type& const_reference;
+  typedef const value_type* const_pointer;
+
+  StringViewWrapper() = default;
+
+  StringViewWrapper(const_pointer data, size_type size)
+      : data_(data), size_(size) {}
+
+  StringViewWrapper(const StringViewWrapper&) = default;
+  StringViewWrapper& operator=(const StringViewWrapper&) = default;
+
+  // Points the view at a new payload; used by the deserializer.
+  void Set(const_pointer data, size_type size) {
+    data_ = data;
+    size_ = size;
+  }
+
+  const_pointer data() const { return data_; }
+
+  const_pointer begin() const { return &data_[0]; }
+  const_pointer end() const { return &data_[size_]; }
+
+  size_type size() const { return size_; }
+  size_type length() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const_reference operator[](size_type pos) const { return data_[pos]; }
+
+  // Copies the viewed payload into an owning string, for data that must
+  // outlive the receive buffer.
+  std::basic_string<value_type, Traits> ToString() const {
+    return {data_, size_};
+  }
+
+ private:
+  const_pointer data_{nullptr};
+  size_type size_{0};
+};
+
+template <typename CharT, typename Traits>
+bool operator==(const StringViewWrapper<CharT, Traits>& lhs,
+                const StringViewWrapper<CharT, Traits>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename CharT, typename Traits>
+bool operator!=(const StringViewWrapper<CharT, Traits>& lhs,
+                const StringViewWrapper<CharT, Traits>& rhs) {
+  return !(lhs == rhs);
+}
+
+// View of a binary buffer payload of trivially copyable elements. Serializes
+// to the same format as BufferWrapper and may be substituted for it during
+// serialization and deserialization.
+template <typename T>
+class BufferViewWrapper {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "BufferViewWrapper elements must be trivially copyable");
+
+ public:
+  // Define types in the style of STL containers to support STL operators.
+  typedef T value_type;
+  typedef std::size_t size_type;
+  typedef const T& const_reference;
+  typedef const T* const_pointer;
+
+  BufferViewWrapper() = default;
+
+  BufferViewWrapper(const_pointer data, size_type size)
+      : data_(data), size_(size) {}
+
+  BufferViewWrapper(const BufferViewWrapper&) = default;
+  BufferViewWrapper& operator=(const BufferViewWrapper&) = default;
+
+  // Points the view at a new payload; used by the deserializer.
+  void Set(const_pointer data, size_type size) {
+    data_ = data;
+    size_ = size;
+  }
+
+  const_pointer data() const { return data_; }
+
+  const_pointer begin() const { return &data_[0]; }
+  const_pointer end() const { return &data_[size_]; }
+
+  size_type size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const_reference operator[](size_type pos) const { return data_[pos]; }
+
+  // Copies the viewed payload into an owning vector, for data that must
+  // outlive the receive buffer.
+  std::vector<T> ToVector() const { return {data_, data_ + size_}; }
+
+ private:
+  const_pointer data_{nullptr};
+  size_type size_{0};
+};
+
+template <typename T>
+bool operator==(const BufferViewWrapper<T>& lhs,
+                const BufferViewWrapper<T>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T>
+bool operator!=(const BufferViewWrapper<T>& lhs,
+                const BufferViewWrapper<T>& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace rpc
+}  // namespace pdx
+}  // namespace android
+
+#endif  // ANDROID_PDX_RPC_VIEW_WRAPPER_H_
@@ -15,6 +15,7 @@
 #include <pdx/rpc/serializable.h>
 #include <pdx/rpc/serialization.h>
 #include <pdx/rpc/string_wrapper.h>
+#include <pdx/rpc/view_wrapper.h>
 #include <pdx/utility.h>
 
 using namespace android::pdx;
@@ -857,6 +858,75 @@ TEST(SerializationTest, StringWrapper) {
   result.Clear();
 }
 
+TEST(SerializationTest, StringViewWrapper) {
+  Payload result;
+  Payload expected;
+  std::string value;
+
+  // Min FIXSTR.
+  value = "";
+  Serialize(StringViewWrapper<>(value.data(), value.length()), &result);
+  expected = {ENCODING_TYPE_FIXSTR_MIN};
+  EXPECT_EQ(expected, result);
+  result.Clear();
+
+  // Max FIXSTR.
+  value = std::string((1 << 5) - 1, 'x');
+  Serialize(StringViewWrapper<>(value.data(), value.length()), &result);
+  expected = {ENCODING_TYPE_FIXSTR_MAX};
+  expected.Append((1 << 5) - 1, 'x');
+  EXPECT_EQ(expected, result);
+  result.Clear();
+
+  // Min STR8.
+  value = std::string((1 << 5), 'x');
+  Serialize(StringViewWrapper<>(value.data(), value.length()), &result);
+  expected = {ENCODING_TYPE_STR8, (1 << 5)};
+  expected.Append((1 << 5), 'x');
+  EXPECT_EQ(expected, result);
+  result.Clear();
+
+  // Min STR16.
+  value = std::string((1 << 8), 'x');
+  Serialize(StringViewWrapper<>(value.data(), value.length()), &result);
+  expected = {ENCODING_TYPE_STR16, 0x00, 0x01};
+  expected.Append((1 << 8), 'x');
+  EXPECT_EQ(expected, result);
+  result.Clear();
+}
+
+TEST(SerializationTest, BufferViewWrapper) {
+  Payload result;
+  Payload expected;
+  std::vector<std::uint8_t> value;
+
+  // Min BIN8.
+  value = {};
+  Serialize(BufferViewWrapper<std::uint8_t>(value.data(), value.size()),
+            &result);
+  expected = {ENCODING_TYPE_BIN8, 0x00};
+  EXPECT_EQ(expected, result);
+  result.Clear();
+
+  // Max BIN8.
+  value = std::vector<std::uint8_t>((1 << 8) - 1, 'x');
+  Serialize(BufferViewWrapper<std::uint8_t>(value.data(), value.size()),
+            &result);
+  expected = {ENCODING_TYPE_BIN8, (1 << 8) - 1};
+  expected.Append((1 << 8) - 1, 'x');
+  EXPECT_EQ(expected, result);
+  result.Clear();
+
+  // Min BIN16.
+  value = std::vector<std::uint8_t>((1 << 8), 'x');
+  Serialize(BufferViewWrapper<std::uint8_t>(value.data(), value.size()),
+            &result);
+  expected = {ENCODING_TYPE_BIN16, 0x00, 0x01};
+  expected.Append((1 << 8), 'x');
+  EXPECT_EQ(expected, result);
+  result.Clear();
+}
+
 TEST(SerializationTest, vector) {
   Payload result;
   Payload expected;
@@ -1991,6 +2061,84 @@ TEST(DeserializationTest, string) {
   EXPECT_EQ(std::string(0x10000, 'x'), result);
 }
 
+TEST(DeserializationTest, StringViewWrapper) {
+  Payload buffer;
+  StringViewWrapper<> result;
+  ErrorType error;
+
+  // Min FIXSTR.
+  buffer = {ENCODING_TYPE_FIXSTR_MIN};
+  error = Deserialize(&result, &buffer);
+  EXPECT_EQ(ErrorCode::NO_ERROR, error);
+  EXPECT_TRUE(result.empty());
+
+  // Max FIXSTR. The view must point directly at the payload bytes in the
+  // receive buffer rather than a copy.
+  buffer = {ENCODING_TYPE_FIXSTR_MAX};
+  buffer.Append((1 << 5) - 1, 'x');
+  error = Deserialize(&result, &buffer);
+  EXPECT_EQ(ErrorCode::NO_ERROR, error);
+  EXPECT_EQ(std::string((1 << 5) - 1, 'x'), result.ToString());
+  EXPECT_EQ(reinterpret_cast<const char*>(buffer.Data() + 1), result.data());
+
+  // Max STR8.
+  buffer = {ENCODING_TYPE_STR8, 0xff};
+  buffer.Append(0xff, 'x');
+  error = Deserialize(&result, &buffer);
+  EXPECT_EQ(ErrorCode::NO_ERROR, error);
+  EXPECT_EQ(std::string(0xff, 'x'), result.ToString());
+  EXPECT_EQ(reinterpret_cast<const char*>(buffer.Data() + 2), result.data());
+
+  // STR8 with a payload short of the encoded length cannot be viewed.
+  buffer = {ENCODING_TYPE_STR8, 0xff};
+  buffer.Append(0x0f, 'x');
+  error = Deserialize(&result, &buffer);
+  EXPECT_EQ(ErrorCode::INSUFFICIENT_BUFFER, error);
+}
+
+TEST(DeserializationTest, BufferViewWrapper) {
+  Payload buffer;
+  BufferViewWrapper<std::uint8_t> result;
+  ErrorType error;
+
+  // Min BIN8.
+  buffer = {ENCODING_TYPE_BIN8, 0x00};
+  error = Deserialize(&result, &buffer);
+  EXPECT_EQ(ErrorCode::NO_ERROR, error);
+  EXPECT_TRUE(result.empty());
+
+  // Max BIN8. The view must point directly at the payload bytes in the
+  // receive buffer rather than a copy.
+  buffer = {ENCODING_TYPE_BIN8, 0xff};
+  buffer.Append(0xff, 'x');
+  error = Deserialize(&result, &buffer);
+  EXPECT_EQ(ErrorCode::NO_ERROR, error);
+  EXPECT_EQ(std::vector<std::uint8_t>(0xff, 'x'), result.ToVector());
+  EXPECT_EQ(buffer.Data() + 2, result.data());
+
+  // BIN8 with a payload short of the encoded length cannot be viewed.
+  buffer = {ENCODING_TYPE_BIN8, 0xff};
+  buffer.Append(0x0f, 'x');
+  error = Deserialize(&result, &buffer);
+  EXPECT_EQ(ErrorCode::INSUFFICIENT_BUFFER, error);
+
+  // A payload that is not a multiple of the element size cannot be viewed as
+  // a wider element type.
+  BufferViewWrapper<std::uint32_t> result32;
+  buffer = {ENCODING_TYPE_BIN8, 0x06};
+  buffer.Append(0x06, 'x');
+  error = Deserialize(&result32, &buffer);
+  EXPECT_EQ(ErrorCode::UNEXPECTED_TYPE_SIZE, error);
+
+  // A payload that is not aligned for the element type cannot be viewed as
+  // that type. The BIN16 header is three bytes, leaving the payload at an odd
+  // offset into the receive buffer.
+  buffer = {ENCODING_TYPE_BIN16, 0x04, 0x00};
+  buffer.Append(0x04, 'x');
+  error = Deserialize(&result32, &buffer);
+  EXPECT_EQ(ErrorCode::UNEXPECTED_TYPE_SIZE, error);
+}
+
 TEST(DeserializationTest, vector) {
   Payload buffer;
   std::vector<std::uint8_t, DefaultInitializationAllocator<std::uint8_t>>
@@ -79,16 +79,15 @@ BlobCache::InsertResult BlobCache::set(const void* key, size_t keySize, const vo
         return InsertResult::kInvalidValueSize;
     }
 
-    std::shared_ptr<Blob> cacheKey(new Blob(key, keySize, false));
-    CacheEntry cacheEntry(cacheKey, nullptr);
+    const uint32_t hash = hashKey(key, keySize);
 
     bool didClean = false;
     while (true) {
-        auto index = std::lower_bound(mCacheEntries.begin(), mCacheEntries.end(), cacheEntry);
-        if (index == mCacheEntries.end() || cacheEntry < *index) {
+        // clean() may move entries around, so the lookup is redone on every
+        // pass.
+        ssize_t entryIndex = findEntry(key, keySize, hash);
+        if (entryIndex < 0) {
             // Create a new cache entry.
-            std::shared_ptr<Blob> keyBlob(new Blob(key, keySize, true));
-            std::shared_ptr<Blob> valueBlob(new Blob(value, valueSize, true));
             size_t newTotalSize = mTotalSize + keySize + valueSize;
             if (mMaxTotalSize < newTotalSize) {
                 if (isCleanable()) {
@@ -104,14 +103,17 @@ BlobCache::InsertResult BlobCache::set(const void* key, size_t keySize, const vo
                     return InsertResult::kNotEnoughSpace;
                 }
             }
-            mCacheEntries.insert(index, CacheEntry(keyBlob, valueBlob));
+            std::shared_ptr<Blob> keyBlob(new Blob(key, keySize, true));
+            std::shared_ptr<Blob> valueBlob(new Blob(value, valueSize, true));
+            mCacheEntries.push_back(CacheEntry(keyBlob, valueBlob, hash));
+            insertIndexEntry(hash, mCacheEntries.size() - 1);
             mTotalSize = newTotalSize;
             ALOGV("set: created new cache entry with %zu byte key and %zu byte value", keySize,
                   valueSize);
         } else {
             // Update the existing cache entry.
-            std::shared_ptr<Blob> valueBlob(new Blob(value, valueSize, true));
-            std::shared_ptr<Blob> oldValueBlob(index->getValue());
+            CacheEntry& entry = mCacheEntries[entryIndex];
+            std::shared_ptr<Blob> oldValueBlob(entry.getValue());
             size_t newTotalSize = mTotalSize + valueSize - oldValueBlob->getSize();
             if (mMaxTotalSize < newTotalSize) {
                 if (isCleanable()) {
@@ -126,7 +128,8 @@ BlobCache::InsertResult BlobCache::set(const void* key, size_t keySize, const vo
                     return InsertResult::kNotEnoughSpace;
                 }
             }
-            index->setValue(valueBlob);
+            std::shared_ptr<Blob> valueBlob(new Blob(value, valueSize, true));
+            entry.setValue(valueBlob);
             mTotalSize = newTotalSize;
             ALOGV("set: updated existing cache entry with %zu byte key and %zu byte "
                   "value",
@@ -142,17 +145,17 @@ size_t BlobCache::get(const void* key, size_t keySize, void* value, size_t value
               mMaxKeySize);
         return 0;
     }
-    std::shared_ptr<Blob> cacheKey(new Blob(key, keySize, false));
-    CacheEntry cacheEntry(cacheKey, nullptr);
-    auto index = std::lower_bound(mCacheEntries.begin(), mCacheEntries.end(), cacheEntry);
-    if (index == mCacheEntries.end() || cacheEntry < *index) {
+    ssize_t entryIndex = findEntry(key, keySize, hashKey(key, keySize));
+    if (entryIndex < 0) {
         ALOGV("get: no cache entry found for key of size %zu", keySize);
+        mStats.misses++;
         return 0;
     }
+    mStats.hits++;
 
     // The key was found. Return the value if the caller's buffer is large
     // enough.
-    std::shared_ptr<Blob> valueBlob(index->getValue());
+    std::shared_ptr<Blob> valueBlob(mCacheEntries[entryIndex].getValue());
     size_t valueBlobSize = valueBlob->getSize();
     if (valueBlobSize <= valueSize) {
         ALOGV("get: copying %zu bytes to caller's buffer", valueBlobSize);
@@ -168,6 +171,67 @@ static inline size_t align4(size_t size) {
     return (size + 3) & ~3;
 }
 
+uint32_t BlobCache::hashKey(const void* key, size_t keySize) {
+    // FNV-1a; cheap and well distributed for shader-key-sized blobs.
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(key);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < keySize; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+ssize_t BlobCache::findEntry(const void* key, size_t keySize, uint32_t hash) const {
+    if (mIndex.empty()) {
+        return -1;
+    }
+    const size_t mask = mIndex.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        const uint32_t ref = mIndex[slot];
+        if (ref == 0) {
+            return -1;
+        }
+        const CacheEntry& entry = mCacheEntries[ref - 1];
+        if (entry.getHash() == hash) {
+            std::shared_ptr<Blob> keyBlob(entry.getKey());
+            if (keyBlob->getSize() == keySize &&
+                    memcmp(keyBlob->getData(), key, keySize) == 0) {
+                return ssize_t(ref - 1);
+            }
+        }
+    }
+}
+
+void BlobCache::insertIndexEntry(uint32_t hash, size_t entryIndex) {
+    if ((entryIndex + 1) * 2 > mIndex.size()) {
+        // Growing the table re-indexes every entry, including this one.
+        rebuildIndex((entryIndex + 1) * 4);
+        return;
+    }
+    const size_t mask = mIndex.size() - 1;
+    size_t slot = hash & mask;
+    while (mIndex[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    mIndex[slot] = uint32_t(entryIndex + 1);
+}
+
+void BlobCache::rebuildIndex(size_t minCapacity) {
+    size_t capacity = 64;
+    while (capacity < minCapacity) {
+        capacity *= 2;
+    }
+    mIndex.assign(capacity, 0);
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < mCacheEntries.size(); i++) {
+        size_t slot = mCacheEntries[i].getHash() & mask;
+        while (mIndex[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        mIndex[slot] = uint32_t(i + 1);
+    }
+}
+
 size_t BlobCache::getFlattenedSize() const {
     auto buildId = base::GetProperty("ro.build.id", "");
     size_t size = align4(sizeof(Header) + buildId.size());
@@ -231,7 +295,7 @@ int BlobCache::flatten(void* buffer, size_t size) const {
 
 int BlobCache::unflatten(void const* buffer, size_t size) {
     // All errors should result in the BlobCache being in an empty state.
-    mCacheEntries.clear();
+    clear();
 
     // Read the cache header
     if (size < sizeof(Header)) {
@@ -258,7 +322,7 @@ int BlobCache::unflatten(void const* buffer, size_t size) {
     size_t numEntries = header->mNumEntries;
     for (size_t i = 0; i < numEntries; i++) {
         if (byteOffset + sizeof(EntryHeader) > size) {
-            mCacheEntries.clear();
+            clear();
             ALOGE("unflatten: not enough room for cache entry headers");
             return -EINVAL;
         }
@@ -270,7 +334,7 @@ int BlobCache::unflatten(void const* buffer, size_t size) {
 
         size_t totalSize = align4(entrySize);
         if (byteOffset + totalSize > size) {
-            mCacheEntries.clear();
+            clear();
             ALOGE("unflatten: not enough room for cache entry headers");
             return -EINVAL;
         }
@@ -299,8 +363,12 @@ void BlobCache::clean() {
         size_t i = size_t(blob_random() % (mCacheEntries.size()));
         const CacheEntry& entry(mCacheEntries[i]);
         mTotalSize -= entry.getKey()->getSize() + entry.getValue()->getSize();
-        mCacheEntries.erase(mCacheEntries.begin() + i);
+        mCacheEntries[i] = mCacheEntries.back();
+        mCacheEntries.pop_back();
+        mStats.evictions++;
     }
+    // Entry positions moved, so rebuild the probe table in one pass.
+    rebuildIndex(mCacheEntries.size() * 2);
 }
 
 bool BlobCache::isCleanable() const {
@@ -320,14 +388,6 @@ BlobCache::Blob::~Blob() {
     }
 }
 
-bool BlobCache::Blob::operator<(const Blob& rhs) const {
-    if (mSize == rhs.mSize) {
-        return memcmp(mData, rhs.mData, mSize) < 0;
-    } else {
-        return mSize < rhs.mSize;
-    }
-}
-
 const void* BlobCache::Blob::getData() const {
     return mData;
 }
@@ -339,21 +399,23 @@ size_t BlobCache::Blob::getSize() const {
 BlobCache::CacheEntry::CacheEntry() {}
 
 BlobCache::CacheEntry::CacheEntry(const std::shared_ptr<Blob>& key,
-                                  const std::shared_ptr<Blob>& value)
-      : mKey(key), mValue(value) {}
+                                  const std::shared_ptr<Blob>& value, uint32_t hash)
+      : mKey(key), mValue(value), mHash(hash) {}
 
-BlobCache::CacheEntry::CacheEntry(const CacheEntry& ce) : mKey(ce.mKey), mValue(ce.mValue) {}
-
-bool BlobCache::CacheEntry::operator<(const CacheEntry& rhs) const {
-    return *mKey < *rhs.mKey;
-}
+BlobCache::CacheEntry::CacheEntry(const CacheEntry& ce)
+      : mKey(ce.mKey), mValue(ce.mValue), mHash(ce.mHash) {}
 
 const BlobCache::CacheEntry& BlobCache::CacheEntry::operator=(const CacheEntry& rhs) {
     mKey = rhs.mKey;
     mValue = rhs.mValue;
+    mHash = rhs.mHash;
     return *this;
 }
 
+uint32_t BlobCache::CacheEntry::getHash() const {
+    return mHash;
+}
+
 std::shared_ptr<BlobCache::Blob> BlobCache::CacheEntry::getKey() const {
     return mKey;
 }
@@ -18,6 +18,8 @@
 #define ANDROID_BLOB_CACHE_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
 
 #include <memory>
 #include <vector>
@@ -115,9 +117,23 @@ public:
     //
     int unflatten(void const* buffer, size_t size);
 
+    // Cache effectiveness counters, accumulated since construction.
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    // getStats returns the hit/miss/eviction counters.
+    Stats getStats() const { return mStats; }
+
     // clear flushes out all contents of the cache then the BlobCache, leaving
     // it in an empty state.
-    void clear() { mCacheEntries.clear(); }
+    void clear() {
+        mCacheEntries.clear();
+        mIndex.clear();
+        mTotalSize = 0;
+    }
 
 protected:
     // mMaxTotalSize is the maximum size that all cache entries can occupy. This
@@ -139,6 +155,23 @@ private:
     // the total size of all remaining entries is less than mMaxTotalSize/2.
     void clean();
 
+    // hashKey computes the hash used by the open-addressed index for the
+    // given key bytes.
+    static uint32_t hashKey(const void* key, size_t keySize);
+
+    // findEntry returns the position in mCacheEntries of the entry matching
+    // the given key, or -1 if there is none. 'hash' must be
+    // hashKey(key, keySize).
+    ssize_t findEntry(const void* key, size_t keySize, uint32_t hash) const;
+
+    // insertIndexEntry adds a slot pointing at mCacheEntries[entryIndex],
+    // growing the table when it passes the load-factor limit.
+    void insertIndexEntry(uint32_t hash, size_t entryIndex);
+
+    // rebuildIndex re-creates the open-addressed table from mCacheEntries,
+    // sized to the smallest power of two of at least minCapacity slots.
+    void rebuildIndex(size_t minCapacity);
+
     // isCleanable returns true if the cache is full enough for the clean method
     // to have some effect, and false otherwise.
     bool isCleanable() const;
@@ -149,8 +182,6 @@ private:
         Blob(const void* data, size_t size, bool copyData);
         ~Blob();
 
-        bool operator<(const Blob& rhs) const;
-
         const void* getData() const;
         size_t getSize() const;
 
@@ -174,14 +205,15 @@ private:
     class CacheEntry {
     public:
         CacheEntry();
-        CacheEntry(const std::shared_ptr<Blob>& key, const std::shared_ptr<Blob>& value);
+        CacheEntry(const std::shared_ptr<Blob>& key, const std::shared_ptr<Blob>& value,
+                   uint32_t hash);
         CacheEntry(const CacheEntry& ce);
 
-        bool operator<(const CacheEntry& rhs) const;
         const CacheEntry& operator=(const CacheEntry&);
 
         std::shared_ptr<Blob> getKey() const;
         std::shared_ptr<Blob> getValue() const;
+        uint32_t getHash() const;
 
         void setValue(const std::shared_ptr<Blob>& value);
 
@@ -191,6 +223,10 @@ private:
 
         // mValue is the cached data associated with the key.
         std::shared_ptr<Blob> mValue;
+
+        // mHash is the hash of the key bytes, cached so that index probes
+        // and rebuilds never have to rehash the key.
+        uint32_t mHash = 0;
     };
 
     // A Header is the header for the entire BlobCache serialization format. No
@@ -257,9 +293,19 @@ private:
     // nrand48 to generate random numbers when needed.
     unsigned short mRandState[3];
 
-    // mCacheEntries stores all the cache entries that are resident in memory.
-    // Cache entries are added to it by the 'set' method.
+    // mCacheEntries stores all the cache entries that are resident in memory,
+    // in no particular order. Cache entries are added to it by the 'set'
+    // method.
     std::vector<CacheEntry> mCacheEntries;
+
+    // mIndex is an open-addressed (linear probing) table of positions into
+    // mCacheEntries, offset by one so that 0 marks an empty slot. It is kept
+    // a power of two in size and at most half full, so probes stay short and
+    // a free slot always exists.
+    std::vector<uint32_t> mIndex;
+
+    // mStats accumulates the hit/miss/eviction counters.
+    Stats mStats;
 };
 
 } // namespace android
@@ -29,8 +29,21 @@
 static const char* cacheFileMagic = "EGL$";
 static const size_t cacheFileHeaderSize = 8;
 
+// Journal file header
+static const char* journalFileMagic = "EGLj";
+static const size_t journalFileHeaderSize = 4;
+
 namespace android {
 
+// A journal record is this fixed header immediately followed by the key and
+// value bytes. A record is only trusted if its CRC matches, so a torn append
+// at the tail of the journal is detected and discarded on replay.
+struct JournalEntryHeader {
+    uint32_t keySize;
+    uint32_t valueSize;
+    uint32_t crc; // crc32c of the key and value bytes
+};
+
 static uint32_t crc32c(const uint8_t* buf, size_t len) {
     const uint32_t polyBits = 0x82F63B78;
     uint32_t r = 0;
@@ -52,68 +65,76 @@ FileBlobCache::FileBlobCache(size_t maxKeySize, size_t maxValueSize, size_t maxT
         : BlobCache(maxKeySize, maxValueSize, maxTotalSize)
         , mFilename(filename) {
     if (mFilename.length() > 0) {
-        size_t headerSize = cacheFileHeaderSize;
+        mJournalFilename = mFilename + ".journal";
+        readCacheFile();
+        // Entries persisted after the last full snapshot live in the
+        // journal; replay them on top of the snapshot.
+        readJournalFile();
+    }
+}
 
-        int fd = open(mFilename.c_str(), O_RDONLY, 0);
-        if (fd == -1) {
-            if (errno != ENOENT) {
-                ALOGE("error opening cache file %s: %s (%d)", mFilename.c_str(),
-                        strerror(errno), errno);
-            }
-            return;
-        }
+void FileBlobCache::readCacheFile() {
+    size_t headerSize = cacheFileHeaderSize;
 
-        struct stat statBuf;
-        if (fstat(fd, &statBuf) == -1) {
-            ALOGE("error stat'ing cache file: %s (%d)", strerror(errno), errno);
-            close(fd);
-            return;
+    int fd = open(mFilename.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        if (errno != ENOENT) {
+            ALOGE("error opening cache file %s: %s (%d)", mFilename.c_str(),
+                    strerror(errno), errno);
         }
+        return;
+    }
 
-        // Check the size before trying to mmap it.
-        size_t fileSize = statBuf.st_size;
-        if (fileSize > mMaxTotalSize * 2) {
-            ALOGE("cache file is too large: %#" PRIx64,
-                  static_cast<off64_t>(statBuf.st_size));
-            close(fd);
-            return;
-        }
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) == -1) {
+        ALOGE("error stat'ing cache file: %s (%d)", strerror(errno), errno);
+        close(fd);
+        return;
+    }
 
-        uint8_t* buf = reinterpret_cast<uint8_t*>(mmap(nullptr, fileSize,
-                PROT_READ, MAP_PRIVATE, fd, 0));
-        if (buf == MAP_FAILED) {
-            ALOGE("error mmaping cache file: %s (%d)", strerror(errno),
-                    errno);
-            close(fd);
-            return;
-        }
+    // Check the size before trying to mmap it.
+    size_t fileSize = statBuf.st_size;
+    if (fileSize > mMaxTotalSize * 2) {
+        ALOGE("cache file is too large: %#" PRIx64,
+              static_cast<off64_t>(statBuf.st_size));
+        close(fd);
+        return;
+    }
 
-        // Check the file magic and CRC
-        size_t cacheSize = fileSize - headerSize;
-        if (memcmp(buf, cacheFileMagic, 4) != 0) {
-            ALOGE("cache file has bad mojo");
-            close(fd);
-            return;
-        }
-        uint32_t* crc = reinterpret_cast<uint32_t*>(buf + 4);
-        if (crc32c(buf + headerSize, cacheSize) != *crc) {
-            ALOGE("cache file failed CRC check");
-            close(fd);
-            return;
-        }
+    uint8_t* buf = reinterpret_cast<uint8_t*>(mmap(nullptr, fileSize,
+            PROT_READ, MAP_PRIVATE, fd, 0));
+    if (buf == MAP_FAILED) {
+        ALOGE("error mmaping cache file: %s (%d)", strerror(errno),
+                errno);
+        close(fd);
+        return;
+    }
 
-        int err = unflatten(buf + headerSize, cacheSize);
-        if (err < 0) {
-            ALOGE("error reading cache contents: %s (%d)", strerror(-err),
-                    -err);
-            munmap(buf, fileSize);
-            close(fd);
-            return;
-        }
+    // Check the file magic and CRC
+    size_t cacheSize = fileSize - headerSize;
+    if (memcmp(buf, cacheFileMagic, 4) != 0) {
+        ALOGE("cache file has bad mojo");
+        close(fd);
+        return;
+    }
+    uint32_t* crc = reinterpret_cast<uint32_t*>(buf + 4);
+    if (crc32c(buf + headerSize, cacheSize) != *crc) {
+        ALOGE("cache file failed CRC check");
+        close(fd);
+        return;
+    }
 
+    int err = unflatten(buf + headerSize, cacheSize);
+    if (err < 0) {
+        ALOGE("error reading cache contents: %s (%d)", strerror(-err),
+                -err);
         munmap(buf, fileSize);
         close(fd);
+        return;
     }
+
+    munmap(buf, fileSize);
+    close(fd);
 }
 
 void FileBlobCache::writeToFile() {
@@ -182,7 +203,141 @@ void FileBlobCache::writeToFile() {
         delete [] buf;
         fchmod(fd, S_IRUSR);
         close(fd);
+
+        // The snapshot now covers everything the journal held.
+        unlink(mJournalFilename.c_str());
+        mJournalSize = 0;
+    }
+}
+
+void FileBlobCache::readJournalFile() {
+    int fd = open(mJournalFilename.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        if (errno != ENOENT) {
+            ALOGE("error opening cache journal %s: %s (%d)", mJournalFilename.c_str(),
+                    strerror(errno), errno);
+        }
+        return;
+    }
+
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) == -1) {
+        ALOGE("error stat'ing cache journal: %s (%d)", strerror(errno), errno);
+        close(fd);
+        return;
+    }
+
+    size_t fileSize = statBuf.st_size;
+    if (fileSize < journalFileHeaderSize || fileSize > mMaxTotalSize) {
+        // An empty, truncated or oversized journal is discarded outright.
+        close(fd);
+        unlink(mJournalFilename.c_str());
+        return;
+    }
+
+    uint8_t* buf = reinterpret_cast<uint8_t*>(mmap(nullptr, fileSize,
+            PROT_READ, MAP_PRIVATE, fd, 0));
+    if (buf == MAP_FAILED) {
+        ALOGE("error mmaping cache journal: %s (%d)", strerror(errno), errno);
+        close(fd);
+        return;
+    }
+
+    size_t offset = 0;
+    if (memcmp(buf, journalFileMagic, journalFileHeaderSize) != 0) {
+        ALOGE("cache journal has bad mojo");
+    } else {
+        offset = journalFileHeaderSize;
+        while (offset + sizeof(JournalEntryHeader) <= fileSize) {
+            JournalEntryHeader header;
+            memcpy(&header, buf + offset, sizeof(header));
+            const size_t remaining = fileSize - offset - sizeof(header);
+            if (header.keySize == 0 || header.valueSize == 0 ||
+                    header.keySize > remaining ||
+                    header.valueSize > remaining - header.keySize) {
+                break;
+            }
+            const uint8_t* key = buf + offset + sizeof(header);
+            const size_t payloadSize = header.keySize + size_t(header.valueSize);
+            if (crc32c(key, payloadSize) != header.crc) {
+                break;
+            }
+            set(key, header.keySize, key + header.keySize, header.valueSize);
+            offset += sizeof(header) + payloadSize;
+        }
+    }
+
+    munmap(buf, fileSize);
+    close(fd);
+
+    if (offset != fileSize) {
+        // Keep the valid prefix; a torn append only costs its own record.
+        ALOGE("cache journal is torn or corrupt, keeping %zu of %zu bytes", offset, fileSize);
+        if (offset <= journalFileHeaderSize ||
+                truncate(mJournalFilename.c_str(), offset) == -1) {
+            unlink(mJournalFilename.c_str());
+            offset = 0;
+        }
+    }
+    mJournalSize = offset;
+}
+
+void FileBlobCache::writeEntryToFile(const void* key, size_t keySize, const void* value,
+        size_t valueSize) {
+    if (mFilename.length() == 0 || keySize == 0 || valueSize == 0) {
+        return;
+    }
+
+    const size_t recordSize = sizeof(JournalEntryHeader) + keySize + valueSize;
+
+    // Compact once the journal grows past a fraction of the cache size;
+    // writing the snapshot also truncates the journal.
+    const size_t maxJournalSize = journalFileHeaderSize + mMaxTotalSize / 4;
+    if (mJournalSize + recordSize > maxJournalSize) {
+        writeToFile();
+        return;
+    }
+
+    const char* fname = mJournalFilename.c_str();
+    const bool createJournal = (mJournalSize == 0);
+    int fd = open(fname, O_CREAT | O_WRONLY | (createJournal ? O_TRUNC : O_APPEND),
+            S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+        ALOGE("error opening cache journal %s: %s (%d)", fname, strerror(errno), errno);
+        return;
+    }
+
+    const size_t writeSize = recordSize + (createJournal ? journalFileHeaderSize : 0);
+    uint8_t* buf = new uint8_t [writeSize];
+    uint8_t* record = buf;
+    if (createJournal) {
+        memcpy(record, journalFileMagic, journalFileHeaderSize);
+        record += journalFileHeaderSize;
+    }
+
+    memcpy(record + sizeof(JournalEntryHeader), key, keySize);
+    memcpy(record + sizeof(JournalEntryHeader) + keySize, value, valueSize);
+
+    JournalEntryHeader header;
+    header.keySize = static_cast<uint32_t>(keySize);
+    header.valueSize = static_cast<uint32_t>(valueSize);
+    header.crc = crc32c(record + sizeof(JournalEntryHeader), keySize + valueSize);
+    memcpy(record, &header, sizeof(header));
+
+    // The record goes out with a single write; if the append is torn, the
+    // CRC check discards it on the next replay.
+    if (write(fd, buf, writeSize) != ssize_t(writeSize)) {
+        ALOGE("error writing cache journal: %s (%d)", strerror(errno), errno);
+        delete [] buf;
+        close(fd);
+        unlink(fname);
+        mJournalSize = 0;
+        return;
     }
+
+    delete [] buf;
+    close(fd);
+    mJournalSize = (createJournal ? journalFileHeaderSize : mJournalSize) + recordSize;
 }
 
 }
@@ -30,12 +30,37 @@ public:
             const std::string& filename);
 
     // writeToFile attempts to save the current contents of BlobCache to
-    // disk.
+    // disk. It also truncates the journal written by writeEntryToFile,
+    // since the snapshot now covers its contents.
     void writeToFile();
 
+    // writeEntryToFile appends a single CRC-protected key/value record to a
+    // journal file next to the cache file, so persisting one new entry costs
+    // one small write instead of rewriting the whole cache. The journal is
+    // replayed on load and compacted into the cache file once it grows past
+    // a fraction of the maximum cache size.
+    void writeEntryToFile(const void* key, size_t keySize, const void* value, size_t valueSize);
+
 private:
+    // readCacheFile attempts to load the saved cache contents from disk.
+    void readCacheFile();
+
+    // readJournalFile replays the journal left by writeEntryToFile,
+    // re-inserting each record that passes its CRC check. Replay stops at
+    // the first torn or corrupt record and the file is truncated to the
+    // valid prefix.
+    void readJournalFile();
+
     // mFilename is the name of the file for storing cache contents.
     std::string mFilename;
+
+    // mJournalFilename is the name of the append-only journal file; empty
+    // when the cache itself is not backed by a file.
+    std::string mJournalFilename;
+
+    // mJournalSize is the current size of the valid journal contents,
+    // including its header.
+    size_t mJournalSize = 0;
 };
 
 } // namespace android
@@ -28,7 +28,10 @@
 #include <utils/Timers.h>
 #include <vndksupport/linker.h>
 
+#include <future>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "EGL/eglext_angle.h"
 #include "egl_platform_entries.h"
@@ -382,6 +385,14 @@ void Loader::init_api(void* dso,
     }
 }
 
+// Memoized results of the driver library search, keyed by library name
+// pattern. The vendor driver cannot change while the process is running, so
+// once a library has been located (or determined to be absent) the
+// filesystem search never needs to run again, even when the driver is
+// unloaded and reloaded around ANGLE or updated-driver switches.
+static std::mutex sDriverPathCacheMutex;
+static std::unordered_map<std::string, std::string> sDriverPathCache;
+
 static void* load_system_driver(const char* kind, const char* suffix, const bool exact) {
     ATRACE_CALL();
     class MatchFile {
@@ -453,7 +464,22 @@ static void* load_system_driver(const char* kind, const char* suffix, const bool
         //      libEGL_*.so, libGLESv1_CM_*.so, libGLESv2_*.so
         libraryName += std::string("_");
     }
-    std::string absolutePath = MatchFile::find(libraryName.c_str(), exact);
+    const std::string cacheKey = libraryName + (exact ? "!" : "*");
+    std::string absolutePath;
+    bool cached = false;
+    {
+        std::lock_guard<std::mutex> lock(sDriverPathCacheMutex);
+        auto it = sDriverPathCache.find(cacheKey);
+        if (it != sDriverPathCache.end()) {
+            absolutePath = it->second;
+            cached = true;
+        }
+    }
+    if (!cached) {
+        absolutePath = MatchFile::find(libraryName.c_str(), exact);
+        std::lock_guard<std::mutex> lock(sDriverPathCacheMutex);
+        sDriverPathCache.emplace(cacheKey, absolutePath);
+    }
     if (absolutePath.empty()) {
         // this happens often, we don't want to log an error
         return nullptr;
@@ -583,14 +609,21 @@ Loader::driver_t* Loader::attempt_to_load_updated_driver(egl_connection_t* cnx)
 
     dso = load_updated_driver("EGL", ns);
     if (dso) {
+        // The GLES dlopens are independent of the EGL symbol resolution
+        // happening on this thread; only init_api needs eglGetProcAddress.
+        auto glesv1 = std::async(std::launch::async,
+                                 [ns] { return load_updated_driver("GLESv1_CM", ns); });
+        auto glesv2 = std::async(std::launch::async,
+                                 [ns] { return load_updated_driver("GLESv2", ns); });
+
         initialize_api(dso, cnx, EGL);
         hnd = new driver_t(dso);
 
-        dso = load_updated_driver("GLESv1_CM", ns);
+        dso = glesv1.get();
         initialize_api(dso, cnx, GLESv1_CM);
         hnd->set(dso, GLESv1_CM);
 
-        dso = load_updated_driver("GLESv2", ns);
+        dso = glesv2.get();
         initialize_api(dso, cnx, GLESv2);
         hnd->set(dso, GLESv2);
     }
@@ -610,14 +643,23 @@ Loader::driver_t* Loader::attempt_to_load_system_driver(egl_connection_t* cnx, c
     }
     dso = load_system_driver("EGL", suffix, exact);
     if (dso) {
+        // Overlap the two GLES dlopens with the EGL symbol resolution on
+        // this thread; only init_api needs eglGetProcAddress from EGL.
+        auto glesv1 = std::async(std::launch::async, [suffix, exact] {
+            return load_system_driver("GLESv1_CM", suffix, exact);
+        });
+        auto glesv2 = std::async(std::launch::async, [suffix, exact] {
+            return load_system_driver("GLESv2", suffix, exact);
+        });
+
         initialize_api(dso, cnx, EGL);
         hnd = new driver_t(dso);
 
-        dso = load_system_driver("GLESv1_CM", suffix, exact);
+        dso = glesv1.get();
         initialize_api(dso, cnx, GLESv1_CM);
         hnd->set(dso, GLESv1_CM);
 
-        dso = load_system_driver("GLESv2", suffix, exact);
+        dso = glesv2.get();
         initialize_api(dso, cnx, GLESv2);
         hnd->set(dso, GLESv2);
     }
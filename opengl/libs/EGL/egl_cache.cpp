@@ -16,12 +16,11 @@
 
 #include "egl_cache.h"
 
+#include <inttypes.h>
 #include <log/log.h>
 #include <private/EGL/cache.h>
 #include <unistd.h>
 
-#include <thread>
-
 #include "../egl_impl.h"
 #include "egl_display.h"
 
@@ -30,9 +29,6 @@ static const size_t maxKeySize = 12 * 1024;
 static const size_t maxValueSize = 64 * 1024;
 static const size_t maxTotalSize = 2 * 1024 * 1024;
 
-// The time in seconds to wait before saving newly inserted cache entries.
-static const unsigned int deferredSaveDelay = 4;
-
 namespace android {
 
 #define BC_EXT_STR "EGL_ANDROID_blob_cache"
@@ -107,6 +103,9 @@ void egl_cache_t::initialize(egl_display_t* display) {
 void egl_cache_t::terminate() {
     std::lock_guard<std::mutex> lock(mMutex);
     if (mBlobCache) {
+        const BlobCache::Stats stats = mBlobCache->getStats();
+        ALOGD("blob cache: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions",
+              stats.hits, stats.misses, stats.evictions);
         mBlobCache->writeToFile();
     }
     mBlobCache = nullptr;
@@ -122,20 +121,15 @@ void egl_cache_t::setBlob(const void* key, EGLsizeiANDROID keySize, const void*
     }
 
     if (mInitialized) {
-        BlobCache* bc = getBlobCacheLocked();
-        bc->set(key, keySize, value, valueSize);
-
-        if (!mSavePending) {
-            mSavePending = true;
-            std::thread deferredSaveThread([this]() {
-                sleep(deferredSaveDelay);
-                std::lock_guard<std::mutex> lock(mMutex);
-                if (mInitialized && mBlobCache) {
-                    mBlobCache->writeToFile();
-                }
-                mSavePending = false;
-            });
-            deferredSaveThread.detach();
+        getBlobCacheLocked();
+        const BlobCache::InsertResult result =
+                mBlobCache->set(key, keySize, value, valueSize);
+
+        if (result == BlobCache::InsertResult::kInserted ||
+                result == BlobCache::InsertResult::kDidClean) {
+            // Persist the new entry with one small journal append instead of
+            // deferring a rewrite of the whole cache file.
+            mBlobCache->writeEntryToFile(key, keySize, value, valueSize);
         }
     }
 }
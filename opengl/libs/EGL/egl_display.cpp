@@ -101,17 +101,28 @@ egl_display_t* egl_display_t::get(EGLDisplay dpy) {
 #ifdef EGL_DISPLAY_ARRAY
     uintptr_t index = uintptr_t(dpy) - 1U;
     if (index >= NUM_DISPLAYS || !sDisplay[index].isValid()) {
-#else
-    const std::lock_guard<std::mutex> lock(displayMapLock);
-    auto search = displayMap.find(dpy);
-    if (search == displayMap.end() || !search->second->isValid()) {
-#endif
         return nullptr;
     }
-#ifdef EGL_DISPLAY_ARRAY
     return &sDisplay[index];
 #else
-    return search->second.get();
+    // Displays are never removed from the map, so a handle this thread has
+    // already resolved can be revalidated without the map lock.
+    egl_display_t* cached = egl_tls_t::getCachedDisplay(dpy);
+    if (cached && cached->isValid()) {
+        return cached;
+    }
+
+    egl_display_t* dp = nullptr;
+    { // scope for displayMapLock
+        const std::lock_guard<std::mutex> lock(displayMapLock);
+        auto search = displayMap.find(dpy);
+        if (search == displayMap.end() || !search->second->isValid()) {
+            return nullptr;
+        }
+        dp = search->second.get();
+    }
+    egl_tls_t::cacheDisplay(dpy, dp);
+    return dp;
 #endif
 }
 
@@ -472,6 +483,7 @@ EGLBoolean egl_display_t::terminate() {
         size_t count = objects.size();
         ALOGW_IF(count, "eglTerminate() called w/ %zu objects remaining", count);
         for (auto o : objects) {
+            o->markTerminated();
             o->destroy();
         }
 
@@ -18,9 +18,11 @@
 
 #include <sstream>
 
+#include "egl_tls.h"
+
 namespace android {
 
-egl_object_t::egl_object_t(egl_display_t* disp) : display(disp), count(1) {
+egl_object_t::egl_object_t(egl_display_t* disp) : display(disp), count(1), terminated(false) {
     // NOTE: this does an implicit incRef
     display->addObject(this);
 }
@@ -29,6 +31,7 @@ egl_object_t::~egl_object_t() {}
 
 void egl_object_t::terminate() {
     // this marks the object as "terminated"
+    markTerminated();
     display->removeObject(this);
     if (decRef() == 1) {
         // shouldn't happen because this is called from LocalRef
@@ -45,6 +48,17 @@ void egl_object_t::destroy() {
 bool egl_object_t::get(egl_display_t const* display, egl_object_t* object) {
     // used by LocalRef, this does an incRef() atomically with
     // checking that the object is valid.
+    //
+    // Objects current on the calling thread are pinned by the references
+    // eglMakeCurrent took on this thread, so they can be revalidated without
+    // taking the display lock. The handle is only dereferenced after it has
+    // matched one of the thread's current objects, since an arbitrary handle
+    // may not point at an object at all.
+    if (egl_tls_t::isCurrentObject(object) && object->getDisplay() == display &&
+        !object->isTerminated()) {
+        object->incRef();
+        return true;
+    }
     return display->getObject(object);
 }
 
@@ -37,6 +37,7 @@ class egl_display_t;
 class egl_object_t {
     egl_display_t* display;
     mutable std::atomic_size_t count;
+    std::atomic_bool terminated;
 
 protected:
     virtual ~egl_object_t();
@@ -49,6 +50,10 @@ public:
     inline void incRef() { count.fetch_add(1, std::memory_order_relaxed); }
     inline size_t decRef() { return count.fetch_sub(1, std::memory_order_acq_rel); }
     inline egl_display_t* getDisplay() const { return display; }
+    // an object's handle becomes invalid when the object is removed from its
+    // display, either explicitly or because the display was terminated.
+    inline void markTerminated() { terminated.store(true, std::memory_order_release); }
+    inline bool isTerminated() const { return terminated.load(std::memory_order_acquire); }
 
 private:
     static bool get(egl_display_t const* display, egl_object_t* object);
@@ -148,64 +148,92 @@ const char* const gClientExtensionString =
  * EGL Extensions entry-points exposed to 3rd party applications
  * (keep in sync with gExtensionString above)
  *
+ * The map must be kept sorted by name (strcmp order): findProcAddress() relies
+ * on the ordering to binary search instead of walking every entry. Debug
+ * builds verify the ordering on the first lookup.
  */
 static const extension_map_t sExtensionMap[] = {
-    // EGL_KHR_lock_surface
-    { "eglLockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)&eglLockSurfaceKHR },
-    { "eglUnlockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)&eglUnlockSurfaceKHR },
+    // EGL_KHR_reusable_sync, EGL_KHR_fence_sync
+    { "eglClientWaitSyncKHR", (__eglMustCastToProperFunctionPointerType)&eglClientWaitSyncKHR },
 
     // EGL_KHR_image, EGL_KHR_image_base
     { "eglCreateImageKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateImageKHR },
-    { "eglDestroyImageKHR", (__eglMustCastToProperFunctionPointerType)&eglDestroyImageKHR },
+
+    // EGL_KHR_stream
+    { "eglCreateStreamFromFileDescriptorKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateStreamFromFileDescriptorKHR },
+    { "eglCreateStreamKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateStreamKHR },
+    { "eglCreateStreamProducerSurfaceKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateStreamProducerSurfaceKHR },
 
     // EGL_KHR_reusable_sync, EGL_KHR_fence_sync
     { "eglCreateSyncKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateSyncKHR },
+
+    // EGL_KHR_image, EGL_KHR_image_base
+    { "eglDestroyImageKHR", (__eglMustCastToProperFunctionPointerType)&eglDestroyImageKHR },
+
+    // EGL_KHR_stream
+    { "eglDestroyStreamKHR", (__eglMustCastToProperFunctionPointerType)&eglDestroyStreamKHR },
+
+    // EGL_KHR_reusable_sync, EGL_KHR_fence_sync
     { "eglDestroySyncKHR", (__eglMustCastToProperFunctionPointerType)&eglDestroySyncKHR },
-    { "eglClientWaitSyncKHR", (__eglMustCastToProperFunctionPointerType)&eglClientWaitSyncKHR },
-    { "eglSignalSyncKHR", (__eglMustCastToProperFunctionPointerType)&eglSignalSyncKHR },
+
+    // EGL_ANDROID_native_fence_sync
+    { "eglDupNativeFenceFDANDROID", (__eglMustCastToProperFunctionPointerType)&eglDupNativeFenceFDANDROID },
+
+    // EGL_ANDROID_get_frame_timestamps
+    { "eglGetCompositorTimingANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetCompositorTimingANDROID },
+    { "eglGetCompositorTimingSupportedANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetCompositorTimingSupportedANDROID },
+    { "eglGetFrameTimestampSupportedANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetFrameTimestampSupportedANDROID },
+    { "eglGetFrameTimestampsANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetFrameTimestampsANDROID },
+
+    // EGL_ANDROID_get_native_client_buffer
+    { "eglGetNativeClientBufferANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetNativeClientBufferANDROID },
+
+    // EGL_ANDROID_get_frame_timestamps
+    { "eglGetNextFrameIdANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetNextFrameIdANDROID },
+
+    // EGL_KHR_stream_cross_process_fd
+    { "eglGetStreamFileDescriptorKHR", (__eglMustCastToProperFunctionPointerType)&eglGetStreamFileDescriptorKHR },
+
+    // EGL_KHR_reusable_sync, EGL_KHR_fence_sync
     { "eglGetSyncAttribKHR", (__eglMustCastToProperFunctionPointerType)&eglGetSyncAttribKHR },
 
     // EGL_NV_system_time
     { "eglGetSystemTimeFrequencyNV", (__eglMustCastToProperFunctionPointerType)&eglGetSystemTimeFrequencyNV },
     { "eglGetSystemTimeNV", (__eglMustCastToProperFunctionPointerType)&eglGetSystemTimeNV },
 
-    // EGL_KHR_wait_sync
-    { "eglWaitSyncKHR", (__eglMustCastToProperFunctionPointerType)&eglWaitSyncKHR },
+    // EGL_KHR_lock_surface
+    { "eglLockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)&eglLockSurfaceKHR },
 
     // EGL_ANDROID_presentation_time
     { "eglPresentationTimeANDROID", (__eglMustCastToProperFunctionPointerType)&eglPresentationTimeANDROID },
 
-    // EGL_KHR_swap_buffers_with_damage
-    { "eglSwapBuffersWithDamageKHR", (__eglMustCastToProperFunctionPointerType)&eglSwapBuffersWithDamageKHR },
-
-    // EGL_ANDROID_get_native_client_buffer
-    { "eglGetNativeClientBufferANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetNativeClientBufferANDROID },
+    // EGL_KHR_stream
+    { "eglQueryStreamKHR", (__eglMustCastToProperFunctionPointerType)&eglQueryStreamKHR },
+    { "eglQueryStreamTimeKHR", (__eglMustCastToProperFunctionPointerType)&eglQueryStreamTimeKHR },
+    { "eglQueryStreamu64KHR", (__eglMustCastToProperFunctionPointerType)&eglQueryStreamu64KHR },
 
     // EGL_KHR_partial_update
     { "eglSetDamageRegionKHR", (__eglMustCastToProperFunctionPointerType)&eglSetDamageRegionKHR },
 
-    { "eglCreateStreamKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateStreamKHR },
-    { "eglDestroyStreamKHR", (__eglMustCastToProperFunctionPointerType)&eglDestroyStreamKHR },
+    // EGL_KHR_reusable_sync, EGL_KHR_fence_sync
+    { "eglSignalSyncKHR", (__eglMustCastToProperFunctionPointerType)&eglSignalSyncKHR },
+
+    // EGL_KHR_stream
     { "eglStreamAttribKHR", (__eglMustCastToProperFunctionPointerType)&eglStreamAttribKHR },
-    { "eglQueryStreamKHR", (__eglMustCastToProperFunctionPointerType)&eglQueryStreamKHR },
-    { "eglQueryStreamu64KHR", (__eglMustCastToProperFunctionPointerType)&eglQueryStreamu64KHR },
-    { "eglQueryStreamTimeKHR", (__eglMustCastToProperFunctionPointerType)&eglQueryStreamTimeKHR },
-    { "eglCreateStreamProducerSurfaceKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateStreamProducerSurfaceKHR },
-    { "eglStreamConsumerGLTextureExternalKHR", (__eglMustCastToProperFunctionPointerType)&eglStreamConsumerGLTextureExternalKHR },
+
+    // EGL_KHR_stream_consumer_gltexture
     { "eglStreamConsumerAcquireKHR", (__eglMustCastToProperFunctionPointerType)&eglStreamConsumerAcquireKHR },
+    { "eglStreamConsumerGLTextureExternalKHR", (__eglMustCastToProperFunctionPointerType)&eglStreamConsumerGLTextureExternalKHR },
     { "eglStreamConsumerReleaseKHR", (__eglMustCastToProperFunctionPointerType)&eglStreamConsumerReleaseKHR },
-    { "eglGetStreamFileDescriptorKHR", (__eglMustCastToProperFunctionPointerType)&eglGetStreamFileDescriptorKHR },
-    { "eglCreateStreamFromFileDescriptorKHR", (__eglMustCastToProperFunctionPointerType)&eglCreateStreamFromFileDescriptorKHR },
 
-    // EGL_ANDROID_get_frame_timestamps
-    { "eglGetNextFrameIdANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetNextFrameIdANDROID },
-    { "eglGetCompositorTimingANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetCompositorTimingANDROID },
-    { "eglGetCompositorTimingSupportedANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetCompositorTimingSupportedANDROID },
-    { "eglGetFrameTimestampsANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetFrameTimestampsANDROID },
-    { "eglGetFrameTimestampSupportedANDROID", (__eglMustCastToProperFunctionPointerType)&eglGetFrameTimestampSupportedANDROID },
+    // EGL_KHR_swap_buffers_with_damage
+    { "eglSwapBuffersWithDamageKHR", (__eglMustCastToProperFunctionPointerType)&eglSwapBuffersWithDamageKHR },
 
-    // EGL_ANDROID_native_fence_sync
-    { "eglDupNativeFenceFDANDROID", (__eglMustCastToProperFunctionPointerType)&eglDupNativeFenceFDANDROID },
+    // EGL_KHR_lock_surface
+    { "eglUnlockSurfaceKHR", (__eglMustCastToProperFunctionPointerType)&eglUnlockSurfaceKHR },
+
+    // EGL_KHR_wait_sync
+    { "eglWaitSyncKHR", (__eglMustCastToProperFunctionPointerType)&eglWaitSyncKHR },
 };
 // clang-format on
 
@@ -218,14 +246,36 @@ static const extension_map_t sExtensionMap[] = {
 // accesses protected by sExtensionMapMutex
 static std::unordered_map<std::string, __eglMustCastToProperFunctionPointerType> sGLExtensionMap;
 static std::unordered_map<std::string, int> sGLExtensionSlotMap;
+static std::unordered_map<std::string, __eglMustCastToProperFunctionPointerType>
+        sBuiltinWrapperMap;
 
 static int sGLExtensionSlot = 0;
 static pthread_mutex_t sExtensionMapMutex = PTHREAD_MUTEX_INITIALIZER;
 
 static void (*findProcAddress(const char* name, const extension_map_t* map, size_t n))() {
-    for (uint32_t i = 0; i < n; i++) {
-        if (!strcmp(name, map[i].name)) {
-            return map[i].address;
+#if !defined(NDEBUG)
+    // Verify once per process that the map is sorted; binary search depends
+    // on it.
+    static const bool mapIsSorted = [map, n] {
+        for (size_t i = 1; i < n; i++) {
+            LOG_ALWAYS_FATAL_IF(strcmp(map[i - 1].name, map[i].name) >= 0,
+                                "extension map entry \"%s\" is out of order", map[i].name);
+        }
+        return true;
+    }();
+    (void)mapIsSorted;
+#endif
+    size_t lo = 0;
+    size_t hi = n;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const int cmp = strcmp(name, map[mid].name);
+        if (cmp == 0) {
+            return map[mid].address;
+        } else if (cmp < 0) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
         }
     }
     return nullptr;
@@ -1036,12 +1086,14 @@ EGLBoolean eglMakeCurrentImpl(EGLDisplay dpy, EGLSurface draw, EGLSurface read,
         if (c) {
             setGLHooksThreadSpecific(c->cnx->hooks[c->version]);
             egl_tls_t::setContext(ctx);
+            egl_tls_t::setCurrentSurfaces(draw, read);
             _c.acquire();
             _r.acquire();
             _d.acquire();
         } else {
             setGLHooksThreadSpecific(&gHooksNoContext);
             egl_tls_t::setContext(EGL_NO_CONTEXT);
+            egl_tls_t::setCurrentSurfaces(EGL_NO_SURFACE, EGL_NO_SURFACE);
         }
     } else {
         // this will ALOGE the error
@@ -1132,14 +1184,30 @@ static __eglMustCastToProperFunctionPointerType findBuiltinWrapper(const char* p
     const egl_connection_t* cnx = &gEGLImpl;
     void* proc = nullptr;
 
-    proc = dlsym(cnx->libEgl, procname);
-    if (proc) return (__eglMustCastToProperFunctionPointerType)proc;
-
-    proc = dlsym(cnx->libGles2, procname);
-    if (proc) return (__eglMustCastToProperFunctionPointerType)proc;
+    // The wrapper libraries never unload, so resolved entry-points can be
+    // cached for the lifetime of the process instead of repeating the dlsym()
+    // walk on every lookup.
+    pthread_mutex_lock(&sExtensionMapMutex);
+    auto pos = sBuiltinWrapperMap.find(procname);
+    if (pos != sBuiltinWrapperMap.end()) {
+        pthread_mutex_unlock(&sExtensionMapMutex);
+        return pos->second;
+    }
+    pthread_mutex_unlock(&sExtensionMapMutex);
 
-    proc = dlsym(cnx->libGles1, procname);
-    if (proc) return (__eglMustCastToProperFunctionPointerType)proc;
+    proc = dlsym(cnx->libEgl, procname);
+    if (!proc) proc = dlsym(cnx->libGles2, procname);
+    if (!proc) proc = dlsym(cnx->libGles1, procname);
+
+    if (proc) {
+        // Only cache hits: a miss before the wrapper libraries are fully
+        // loaded may resolve on a later call.
+        const auto addr = (__eglMustCastToProperFunctionPointerType)proc;
+        pthread_mutex_lock(&sExtensionMapMutex);
+        sBuiltinWrapperMap.emplace(procname, addr);
+        pthread_mutex_unlock(&sExtensionMapMutex);
+        return addr;
+    }
 
     return nullptr;
 }
@@ -28,7 +28,14 @@ namespace android {
 pthread_key_t egl_tls_t::sKey = TLS_KEY_NOT_INITIALIZED;
 pthread_once_t egl_tls_t::sOnceKey = PTHREAD_ONCE_INIT;
 
-egl_tls_t::egl_tls_t() : error(EGL_SUCCESS), ctx(nullptr), logCallWithNoContext(true) {}
+egl_tls_t::egl_tls_t()
+      : error(EGL_SUCCESS),
+        ctx(nullptr),
+        cachedDpy(EGL_NO_DISPLAY),
+        cachedDpyValue(nullptr),
+        currentDraw(EGL_NO_SURFACE),
+        currentRead(EGL_NO_SURFACE),
+        logCallWithNoContext(true) {}
 
 const char* egl_tls_t::egl_strerror(EGLint err) {
     switch (err) {
@@ -176,4 +183,36 @@ EGLContext egl_tls_t::getContext() {
     return tls->ctx;
 }
 
+egl_display_t* egl_tls_t::getCachedDisplay(EGLDisplay dpy) {
+    if (sKey == TLS_KEY_NOT_INITIALIZED) {
+        return nullptr;
+    }
+    egl_tls_t* tls = (egl_tls_t*)pthread_getspecific(sKey);
+    if (!tls || tls->cachedDpy != dpy) return nullptr;
+    return tls->cachedDpyValue;
+}
+
+void egl_tls_t::cacheDisplay(EGLDisplay dpy, egl_display_t* dp) {
+    validateTLSKey();
+    egl_tls_t* tls = getTLS();
+    tls->cachedDpy = dpy;
+    tls->cachedDpyValue = dp;
+}
+
+void egl_tls_t::setCurrentSurfaces(EGLSurface draw, EGLSurface read) {
+    validateTLSKey();
+    egl_tls_t* tls = getTLS();
+    tls->currentDraw = draw;
+    tls->currentRead = read;
+}
+
+bool egl_tls_t::isCurrentObject(const void* object) {
+    if (sKey == TLS_KEY_NOT_INITIALIZED) {
+        return false;
+    }
+    egl_tls_t* tls = (egl_tls_t*)pthread_getspecific(sKey);
+    if (!tls) return false;
+    return object == tls->ctx || object == tls->currentDraw || object == tls->currentRead;
+}
+
 } // namespace android
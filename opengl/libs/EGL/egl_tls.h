@@ -23,6 +23,7 @@
 namespace android {
 
 class DbgContext;
+class egl_display_t;
 
 class egl_tls_t {
     enum { TLS_KEY_NOT_INITIALIZED = -1 };
@@ -31,6 +32,15 @@ class egl_tls_t {
 
     EGLint error;
     EGLContext ctx;
+    // The last display handle validated on this thread, so repeat lookups
+    // with the same handle skip the global display map lock.
+    EGLDisplay cachedDpy;
+    egl_display_t* cachedDpyValue;
+    // The surfaces made current on this thread. They hold the references
+    // that eglMakeCurrent took, so they can be revalidated without taking
+    // the display lock.
+    EGLSurface currentDraw;
+    EGLSurface currentRead;
     bool logCallWithNoContext;
 
     egl_tls_t();
@@ -45,6 +55,10 @@ public:
     static EGLint getError();
     static void setContext(EGLContext ctx);
     static EGLContext getContext();
+    static egl_display_t* getCachedDisplay(EGLDisplay dpy);
+    static void cacheDisplay(EGLDisplay dpy, egl_display_t* dp);
+    static void setCurrentSurfaces(EGLSurface draw, EGLSurface read);
+    static bool isCurrentObject(const void* object);
     static bool logNoContextCall();
     static const char* egl_strerror(EGLint err);
 
@@ -28,115 +28,158 @@ namespace V1_0 {
 namespace implementation {
 
 
-Return<sp<IGraphicBufferProducer>>
-AutomotiveDisplayProxyService::getIGraphicBufferProducer(uint64_t id) {
+sp<SurfaceComposerClient> AutomotiveDisplayProxyService::getSurfaceClient() {
+    if (mSurfaceClient == nullptr) {
+        sp<SurfaceComposerClient> surfaceClient = new SurfaceComposerClient();
+        auto err = surfaceClient->initCheck();
+        if (err != NO_ERROR) {
+            ALOGE("SurfaceComposerClient::initCheck error: %#x", err);
+            return nullptr;
+        }
+        mSurfaceClient = surfaceClient;
+    }
+    return mSurfaceClient;
+}
+
+
+DisplayDesc* AutomotiveDisplayProxyService::acquireDisplay(uint64_t id) {
     auto it = mDisplays.find(id);
+    if (it != mDisplays.end()) {
+        return &it->second;
+    }
+
     sp<IBinder> displayToken = nullptr;
-    sp<SurfaceControl> surfaceControl = nullptr;
-    if (it == mDisplays.end()) {
-        if (const auto displayId = DisplayId::fromValue<PhysicalDisplayId>(id)) {
-            displayToken = SurfaceComposerClient::getPhysicalDisplayToken(*displayId);
-        }
+    if (const auto displayId = DisplayId::fromValue<PhysicalDisplayId>(id)) {
+        displayToken = SurfaceComposerClient::getPhysicalDisplayToken(*displayId);
+    }
 
-        if (displayToken == nullptr) {
-            ALOGE("Given display id, 0x%lX, is invalid.", (unsigned long)id);
-            return nullptr;
-        }
+    if (displayToken == nullptr) {
+        ALOGE("Given display id, 0x%lX, is invalid.", (unsigned long)id);
+        return nullptr;
+    }
 
-        // Get the resolution from stored display state.
-        ui::DisplayMode displayMode = {};
-        auto err = SurfaceComposerClient::getActiveDisplayMode(displayToken, &displayMode);
-        if (err != NO_ERROR) {
-            ALOGE("Failed to get display mode of %lX.  "
-                  "This display will be ignored.", (unsigned long)id);
-            return nullptr;
-        }
+    // Get the resolution from stored display state.
+    ui::DisplayMode displayMode = {};
+    auto err = SurfaceComposerClient::getActiveDisplayMode(displayToken, &displayMode);
+    if (err != NO_ERROR) {
+        ALOGE("Failed to get display mode of %lX.  "
+              "This display will be ignored.", (unsigned long)id);
+        return nullptr;
+    }
 
-        ui::DisplayState displayState = {};
-        err = SurfaceComposerClient::getDisplayState(displayToken, &displayState);
-        if (err != NO_ERROR) {
-            ALOGE("Failed to get current display status of %lX.  "
-                  "This display will be ignored.", (unsigned long)id);
-            return nullptr;
-        }
+    ui::DisplayState displayState = {};
+    err = SurfaceComposerClient::getDisplayState(displayToken, &displayState);
+    if (err != NO_ERROR) {
+        ALOGE("Failed to get current display status of %lX.  "
+              "This display will be ignored.", (unsigned long)id);
+        return nullptr;
+    }
 
-        auto displayWidth  = displayMode.resolution.getWidth();
-        auto displayHeight = displayMode.resolution.getHeight();
-        if ((displayState.orientation != ui::ROTATION_0) &&
-            (displayState.orientation != ui::ROTATION_180)) {
-            std::swap(displayWidth, displayHeight);
-        }
+    auto displayWidth  = displayMode.resolution.getWidth();
+    auto displayHeight = displayMode.resolution.getHeight();
+    if ((displayState.orientation != ui::ROTATION_0) &&
+        (displayState.orientation != ui::ROTATION_180)) {
+        std::swap(displayWidth, displayHeight);
+    }
 
-        sp<android::SurfaceComposerClient> surfaceClient = new SurfaceComposerClient();
-        err = surfaceClient->initCheck();
-        if (err != NO_ERROR) {
-            ALOGE("SurfaceComposerClient::initCheck error: %#x", err);
-            return nullptr;
-        }
+    sp<SurfaceComposerClient> surfaceClient = getSurfaceClient();
+    if (surfaceClient == nullptr) {
+        return nullptr;
+    }
 
-        // Create a SurfaceControl instance
-        surfaceControl = surfaceClient->createSurface(
-                String8::format("AutomotiveDisplay::%lX", (unsigned long)id),
-                displayWidth, displayHeight,
-                PIXEL_FORMAT_RGBX_8888, ISurfaceComposerClient::eOpaque);
-        if (surfaceControl == nullptr || !surfaceControl->isValid()) {
-            ALOGE("Failed to create SurfaceControl.");
-            return nullptr;
+    // Create a SurfaceControl instance
+    sp<SurfaceControl> surfaceControl = surfaceClient->createSurface(
+            String8::format("AutomotiveDisplay::%lX", (unsigned long)id),
+            displayWidth, displayHeight,
+            PIXEL_FORMAT_RGBX_8888, ISurfaceComposerClient::eOpaque);
+    if (surfaceControl == nullptr || !surfaceControl->isValid()) {
+        ALOGE("Failed to create SurfaceControl.");
+        return nullptr;
+    }
+
+    // Store; the descriptor is kept until the service exits so later camera
+    // sessions reuse the same SurfaceControl instead of re-acquiring it.
+    DisplayDesc descriptor = {displayToken, surfaceControl};
+    auto [storedIt, inserted] = mDisplays.insert_or_assign(id, std::move(descriptor));
+    return &storedIt->second;
+}
+
+
+void AutomotiveDisplayProxyService::acquireAllDisplays() {
+    auto displayIds = SurfaceComposerClient::getPhysicalDisplayIds();
+    for (const auto& displayId : displayIds) {
+        if (acquireDisplay(displayId.value) == nullptr) {
+            ALOGW("Failed to pre-acquire display %lX.", (unsigned long)displayId.value);
         }
+    }
+}
 
-        // Store
-        DisplayDesc descriptor = {displayToken, surfaceControl};
-        mDisplays.insert_or_assign(id, std::move(descriptor));
-    } else {
-        displayToken = it->second.token;
-        surfaceControl = it->second.surfaceControl;
+
+Return<sp<IGraphicBufferProducer>>
+AutomotiveDisplayProxyService::getIGraphicBufferProducer(uint64_t id) {
+    DisplayDesc* descriptor = acquireDisplay(id);
+    if (descriptor == nullptr) {
+        return nullptr;
     }
 
     // SurfaceControl::getSurface is guaranteed to be not null.
-    auto targetSurface = surfaceControl->getSurface();
+    auto targetSurface = descriptor->surfaceControl->getSurface();
     return new ::android::hardware::graphics::bufferqueue::V2_0::utils::
                B2HGraphicBufferProducer(targetSurface->getIGraphicBufferProducer());
 }
 
 
-Return<bool> AutomotiveDisplayProxyService::showWindow(uint64_t id) {
-    auto it = mDisplays.find(id);
-    if (it == mDisplays.end()) {
-        ALOGE("Given display token is invalid or unknown.");
-        return false;
-    }
+bool AutomotiveDisplayProxyService::showWindows(const std::vector<uint64_t>& ids) {
+    SurfaceComposerClient::Transaction t;
+    for (const auto& id : ids) {
+        auto it = mDisplays.find(id);
+        if (it == mDisplays.end()) {
+            ALOGE("Given display token is invalid or unknown.");
+            return false;
+        }
 
-    ui::DisplayState displayState;
-    auto err = SurfaceComposerClient::getDisplayState(it->second.token, &displayState);
-    if (err != NO_ERROR) {
-        ALOGE("Failed to get current state of the display 0x%lX", (unsigned long)id);
-        return false;
+        ui::DisplayState displayState;
+        auto err = SurfaceComposerClient::getDisplayState(it->second.token, &displayState);
+        if (err != NO_ERROR) {
+            ALOGE("Failed to get current state of the display 0x%lX", (unsigned long)id);
+            return false;
+        }
+
+        t.setDisplayLayerStack(it->second.token, displayState.layerStack);
+        t.setLayerStack(it->second.surfaceControl, displayState.layerStack);
+        t.setLayer(it->second.surfaceControl, 0x7FFFFFFF)
+         .show(it->second.surfaceControl);
     }
 
+    return t.apply() == NO_ERROR;
+}
+
+
+bool AutomotiveDisplayProxyService::hideWindows(const std::vector<uint64_t>& ids) {
     SurfaceComposerClient::Transaction t;
-    t.setDisplayLayerStack(it->second.token, displayState.layerStack);
-    t.setLayerStack(it->second.surfaceControl, displayState.layerStack);
+    for (const auto& id : ids) {
+        auto it = mDisplays.find(id);
+        if (it == mDisplays.end()) {
+            ALOGE("Given display token is invalid or unknown.");
+            return false;
+        }
 
-    status_t status = t.setLayer(it->second.surfaceControl, 0x7FFFFFFF)
-                      .show(it->second.surfaceControl)
-                      .apply();
+        // The window is only hidden; the SurfaceControl stays cached for the
+        // next session.
+        t.hide(it->second.surfaceControl);
+    }
 
-    return status == NO_ERROR;
+    return t.apply() == NO_ERROR;
 }
 
 
-Return<bool> AutomotiveDisplayProxyService::hideWindow(uint64_t id) {
-    auto it = mDisplays.find(id);
-    if (it == mDisplays.end()) {
-        ALOGE("Given display token is invalid or unknown.");
-        return false;
-    }
+Return<bool> AutomotiveDisplayProxyService::showWindow(uint64_t id) {
+    return showWindows({id});
+}
 
-    status_t status = SurfaceComposerClient::Transaction{}
-                      .hide(it->second.surfaceControl)
-                      .apply();
 
-    return status == NO_ERROR;
+Return<bool> AutomotiveDisplayProxyService::hideWindow(uint64_t id) {
+    return hideWindows({id});
 }
 
 
@@ -197,4 +240,3 @@ Return<void> AutomotiveDisplayProxyService::getDisplayInfo(uint64_t id, getDispl
 }  // namespace automotive
 }  // namespace frameworks
 }  // namespace android
-
@@ -51,10 +51,36 @@ public:
     Return<void> getDisplayIdList(getDisplayIdList_cb _cb) override;
     Return<void> getDisplayInfo(uint64_t, getDisplayInfo_cb _cb) override;
 
+    // Acquires tokens and SurfaceControl instances for all available physical
+    // displays in one pass, so a subsequent getIGraphicBufferProducer() call is
+    // served from the cache.  Called once at service start to take the display
+    // acquisition round trips off the rearview-camera cold-start path; a
+    // failure to acquire an individual display is not fatal because the client
+    // may never use it.
+    void acquireAllDisplays();
+
+    // Shows or hides the windows of multiple displays with a single
+    // SurfaceFlinger transaction.  Returns false if any given display is
+    // unknown or the transaction fails.
+    bool showWindows(const std::vector<uint64_t>& ids);
+    bool hideWindows(const std::vector<uint64_t>& ids);
+
 private:
     uint8_t getDisplayPort(const uint64_t id) { return (id & 0xF); }
 
+    // Returns a descriptor for the given display, acquiring its token and
+    // creating its SurfaceControl on first use.  Descriptors stay cached for
+    // the lifetime of the service; hideWindow() only hides the window, so
+    // camera session restarts reuse the same SurfaceControl.
+    DisplayDesc* acquireDisplay(uint64_t id);
+
+    sp<SurfaceComposerClient> getSurfaceClient();
+
     std::unordered_map<uint64_t, DisplayDesc> mDisplays;
+
+    // A single client is shared by all displays; SurfaceControl instances keep
+    // it alive through their own references as well.
+    sp<SurfaceComposerClient> mSurfaceClient;
 };
 
 }  // namespace implementation
@@ -63,4 +89,3 @@ private:
 }  // namespace automotive
 }  // namespace frameworks
 }  // namespace android
-
@@ -39,9 +39,14 @@ const static char kServiceName[] = "default";
 int main() {
     ALOGI("Automotive Display Proxy Service is starting");
 
-    android::sp<IAutomotiveDisplayProxyService> service =
+    android::sp<AutomotiveDisplayProxyService> service =
         new AutomotiveDisplayProxyService();
 
+    // Warm up the display cache before accepting calls so the first client,
+    // typically the rearview camera on a cold boot, does not pay for the
+    // display acquisition round trips.
+    service->acquireAllDisplays();
+
     configureRpcThreadpool(1, true /* callerWillJoin */);
 
     // Register our service -- if somebody is already registered by our name,
@@ -25,6 +25,7 @@
 #include <binder/PermissionCache.h>
 #include <cutils/properties.h>
 #include <gpumem/GpuMem.h>
+#include <graphicsenv/GraphicsEnv.h>
 #include <gpuwork/GpuWork.h>
 #include <gpustats/GpuStats.h>
 #include <private/android_filesystem_config.h>
@@ -82,6 +83,13 @@ void GpuService::setTargetStats(const std::string& appPackageName, const uint64_
     mGpuStats->insertTargetStats(appPackageName, driverVersionCode, stats, value);
 }
 
+void GpuService::setTargetStatsArray(const std::string& appPackageName,
+                                     const uint64_t driverVersionCode,
+                                     const std::vector<GpuStatsInfo::Stats>& stats,
+                                     const std::vector<uint64_t>& values) {
+    mGpuStats->insertTargetStatsArray(appPackageName, driverVersionCode, stats, values);
+}
+
 void GpuService::setUpdatableDriverPath(const std::string& driverPath) {
     IPCThreadState* ipc = IPCThreadState::self();
     const int pid = ipc->getCallingPid();
@@ -95,6 +103,9 @@ void GpuService::setUpdatableDriverPath(const std::string& driverPath) {
 
     std::lock_guard<std::mutex> lock(mLock);
     mDeveloperDriverPath = driverPath;
+    // system_server re-pushes the path whenever the driver package changes, so
+    // this is where the cached environment snapshot gets invalidated.
+    mDriverEnvironmentValid = false;
 }
 
 std::string GpuService::getUpdatableDriverPath() {
@@ -102,6 +113,30 @@ std::string GpuService::getUpdatableDriverPath() {
     return mDeveloperDriverPath;
 }
 
+bool GpuService::getUpdatableDriverEnvironment(std::string* outDriverPath,
+                                               std::string* outLlndkLibraries,
+                                               std::string* outVndkspLibraries) {
+    std::lock_guard<std::mutex> lock(mLock);
+    if (mDeveloperDriverPath.empty()) return false;
+
+    if (!mDriverEnvironmentValid) {
+        // The library lists only change with the vndk apex or a driver update,
+        // so read the config files once here instead of in every launching
+        // process.
+        mLlndkLibraries = GraphicsEnv::getSystemNativeLibraries(GraphicsEnv::NativeLibrary::LLNDK);
+        mVndkspLibraries =
+                GraphicsEnv::getSystemNativeLibraries(GraphicsEnv::NativeLibrary::VNDKSP);
+        mDriverEnvironmentValid = true;
+    }
+
+    if (mLlndkLibraries.empty() || mVndkspLibraries.empty()) return false;
+
+    *outDriverPath = mDeveloperDriverPath;
+    *outLlndkLibraries = mLlndkLibraries;
+    *outVndkspLibraries = mVndkspLibraries;
+    return true;
+}
+
 status_t GpuService::shellCommand(int /*in*/, int out, int err, std::vector<String16>& args) {
     ATRACE_CALL();
 
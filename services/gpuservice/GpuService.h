@@ -56,8 +56,13 @@ private:
                      int64_t driverLoadingTime) override;
     void setTargetStats(const std::string& appPackageName, const uint64_t driverVersionCode,
                         const GpuStatsInfo::Stats stats, const uint64_t value) override;
+    void setTargetStatsArray(const std::string& appPackageName, const uint64_t driverVersionCode,
+                             const std::vector<GpuStatsInfo::Stats>& stats,
+                             const std::vector<uint64_t>& values) override;
     void setUpdatableDriverPath(const std::string& driverPath) override;
     std::string getUpdatableDriverPath() override;
+    bool getUpdatableDriverEnvironment(std::string* outDriverPath, std::string* outLlndkLibraries,
+                                       std::string* outVndkspLibraries) override;
 
     /*
      * IBinder interface
@@ -86,6 +91,11 @@ private:
     std::unique_ptr<GpuMemTracer> mGpuMemTracer;
     std::mutex mLock;
     std::string mDeveloperDriverPath;
+    // Driver environment snapshot served to launching processes; rebuilt
+    // lazily after setUpdatableDriverPath invalidates it on a driver update.
+    bool mDriverEnvironmentValid = false;
+    std::string mLlndkLibraries;
+    std::string mVndkspLibraries;
 };
 
 } // namespace android
@@ -175,13 +175,38 @@ void GpuStats::insertDriverStats(const std::string& driverPackageName,
 
 void GpuStats::insertTargetStats(const std::string& appPackageName,
                                  const uint64_t driverVersionCode, const GpuStatsInfo::Stats stats,
-                                 const uint64_t /*value*/) {
+                                 const uint64_t value) {
     ATRACE_CALL();
 
-    const std::string appStatsKey = appPackageName + std::to_string(driverVersionCode);
+    std::lock_guard<std::mutex> lock(mLock);
+    registerStatsdCallbacksIfNeeded();
+    insertTargetStatsLocked(appPackageName, driverVersionCode, stats, value);
+}
+
+void GpuStats::insertTargetStatsArray(const std::string& appPackageName,
+                                      const uint64_t driverVersionCode,
+                                      const std::vector<GpuStatsInfo::Stats>& stats,
+                                      const std::vector<uint64_t>& values) {
+    ATRACE_CALL();
+
+    if (stats.size() != values.size()) {
+        ALOGE("Dropping target stats array with mismatched sizes (%zu stats, %zu values)",
+              stats.size(), values.size());
+        return;
+    }
 
     std::lock_guard<std::mutex> lock(mLock);
     registerStatsdCallbacksIfNeeded();
+    for (size_t i = 0; i < stats.size(); i++) {
+        insertTargetStatsLocked(appPackageName, driverVersionCode, stats[i], values[i]);
+    }
+}
+
+void GpuStats::insertTargetStatsLocked(const std::string& appPackageName,
+                                       const uint64_t driverVersionCode,
+                                       const GpuStatsInfo::Stats stats, const uint64_t /*value*/) {
+    const std::string appStatsKey = appPackageName + std::to_string(driverVersionCode);
+
     if (!mAppStats.count(appStatsKey)) {
         return;
     }
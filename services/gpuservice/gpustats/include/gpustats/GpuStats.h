@@ -41,6 +41,12 @@ public:
     // Insert target stats into app stats or potentially global stats as well.
     void insertTargetStats(const std::string& appPackageName, const uint64_t driverVersionCode,
                            const GpuStatsInfo::Stats stats, const uint64_t value);
+    // Insert a batch of target stats under a single lock acquisition; stats[i]
+    // pairs with values[i].
+    void insertTargetStatsArray(const std::string& appPackageName,
+                                const uint64_t driverVersionCode,
+                                const std::vector<GpuStatsInfo::Stats>& stats,
+                                const std::vector<uint64_t>& values);
     // dumpsys interface
     void dump(const Vector<String16>& args, std::string* result);
 
@@ -63,6 +69,10 @@ private:
 
     // Remove old packages from mAppStats.
     void purgeOldDriverStats();
+    // Records one target stat; the caller must hold mLock.
+    void insertTargetStatsLocked(const std::string& appPackageName,
+                                 const uint64_t driverVersionCode, const GpuStatsInfo::Stats stats,
+                                 const uint64_t value);
 
     // Pull global into into global atom.
     AStatsManager_PullAtomCallbackReturn pullGlobalInfoAtom(AStatsEventList* data);
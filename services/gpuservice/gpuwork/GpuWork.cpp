@@ -191,13 +191,18 @@ void GpuWork::dump(const Vector<String16>& /* args */, std::string* result) {
         // thus the returned value is not being concurrently accessed by the BPF
         // program (no atomic reads needed below).
 
-        mGpuWorkMap.iterateWithValue(
-                [&dumpMap](const GpuIdUid& key, const UidTrackingInfo& value,
-                           const android::bpf::BpfMap<GpuIdUid, UidTrackingInfo>&)
-                        -> base::Result<void> {
-                    dumpMap[key] = value;
-                    return {};
-                });
+        // Cheap change check: if the eBPF program has not recorded any work
+        // periods since the map was last cleared then the map is empty and
+        // there is nothing to read back.
+        if (mapChangedSinceLastClear()) {
+            mGpuWorkMap.iterateWithValue(
+                    [&dumpMap](const GpuIdUid& key, const UidTrackingInfo& value,
+                               const android::bpf::BpfMap<GpuIdUid, UidTrackingInfo>&)
+                            -> base::Result<void> {
+                        dumpMap[key] = value;
+                        return {};
+                    });
+        }
     }
 
     // Dump work information.
@@ -276,6 +281,13 @@ AStatsManager_PullAtomCallbackReturn GpuWork::pullWorkAtoms(AStatsEventList* dat
         return AStatsManager_PULL_SKIP;
     }
 
+    // Cheap change check: if the eBPF program has not recorded any work
+    // periods since the map was last cleared then the map is empty, so skip
+    // the per-entry map reads (and the atom sampling) entirely.
+    if (!mapChangedSinceLastClear()) {
+        return AStatsManager_PULL_SKIP;
+    }
+
     std::unordered_map<GpuIdUid, UidTrackingInfo, decltype(hashGpuIdUid)*, decltype(equalGpuIdUid)*>
             workMap(32, &hashGpuIdUid, &equalGpuIdUid);
 
@@ -519,11 +531,30 @@ void GpuWork::clearMap() {
     globalData.value().num_map_entries = 0;
     mGpuWorkGlobalDataMap.writeValue(0, globalData.value(), BPF_ANY);
 
+    // Remember the update count observed above as the baseline for
+    // |mapChangedSinceLastClear|. Counter increments that land while we are
+    // clearing may be missed by this baseline (or clobbered by the write-back
+    // above); they are picked up as a change as soon as the next event arrives.
+    mLastUpdateCount = globalData.value().num_map_updates;
+
     // Update |mPreviousMapClearTimePoint| so we know when we started collecting
     // the stats.
     mPreviousMapClearTimePoint = std::chrono::steady_clock::now();
 }
 
+bool GpuWork::mapChangedSinceLastClear() {
+    if (!mGpuWorkGlobalDataMap.isValid()) {
+        return true;
+    }
+
+    base::Result<GlobalData> globalData = mGpuWorkGlobalDataMap.readValue(0);
+    if (!globalData.ok()) {
+        return true;
+    }
+
+    return globalData.value().num_map_updates != mLastUpdateCount;
+}
+
 void GpuWork::waitForPermissions() {
     const String16 permissionRegisterStatsPullAtom(kPermissionRegisterStatsPullAtom);
     int count = 0;
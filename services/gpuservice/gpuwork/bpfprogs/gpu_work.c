@@ -217,6 +217,18 @@ DEFINE_BPF_PROG("tracepoint/power/gpu_work_period", AID_ROOT, AID_GRAPHICS, tp_g
         }
     }
 
+    // Count this event in |num_map_updates| so that userspace can cheaply
+    // detect whether |gpu_work_map| may have changed since it last cleared the
+    // map. Every path below modifies the entry (durations or |error_count|),
+    // so counting here, before validation, is correct.
+    {
+        const uint32_t zero = 0;
+        GlobalData* global_data = bpf_gpu_work_global_data_lookup_elem(&zero);
+        if (global_data) {
+            __sync_fetch_and_add(&global_data->num_map_updates, 1);
+        }
+    }
+
     if (
             // The period duration must be non-zero.
             period->start_time_ns >= period->end_time_ns ||
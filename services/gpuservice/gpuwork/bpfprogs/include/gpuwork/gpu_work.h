@@ -58,6 +58,14 @@ typedef struct {
     // the number of entries (approximately) using a counter so we can check if
     // the map is nearly full.
     uint64_t num_map_entries;
+
+    // Incremented (approximately) once per handled |gpu_work_period| event.
+    // Userspace uses this as a cheap change hint: if the value has not moved
+    // since |gpu_work_map| was last cleared then the map is empty and does not
+    // need to be read entry-by-entry. Increments that race with userspace
+    // writing this struct back are lost (the counter can even appear to go
+    // backwards); this just delays change detection until the next event.
+    uint64_t num_map_updates;
 } GlobalData;
 
 // The maximum number of tracked GPU ID and UID pairs (|GpuIdUid|).
@@ -72,6 +72,11 @@ private:
     // Clears the |mGpuWorkMap| map.
     void clearMap() REQUIRES(mMutex);
 
+    // Returns true if the eBPF program may have modified |mGpuWorkMap| since
+    // the last call to |clearMap|. Returns true if the global data map cannot
+    // be read, so that callers fall back to reading |mGpuWorkMap| itself.
+    bool mapChangedSinceLastClear() REQUIRES(mMutex);
+
     // Waits for required permissions to become set. This seems to be needed
     // because platform service permissions might not be set when a service
     // first starts. See b/214085769.
@@ -126,6 +131,11 @@ private:
     // The previous time point at which |mGpuWorkMap| was cleared.
     std::chrono::steady_clock::time_point mPreviousMapClearTimePoint GUARDED_BY(mMutex);
 
+    // The value of |GlobalData::num_map_updates| observed when |mGpuWorkMap|
+    // was last cleared. While the current value matches, the eBPF program has
+    // not touched the map since the clear, so readers can skip iterating it.
+    uint64_t mLastUpdateCount GUARDED_BY(mMutex) = 0;
+
     // Permission to register a statsd puller.
     static constexpr char16_t kPermissionRegisterStatsPullAtom[] =
             u"android.permission.REGISTER_STATS_PULL_ATOM";
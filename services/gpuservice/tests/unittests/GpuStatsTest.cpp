@@ -222,6 +222,22 @@ TEST_F(GpuStatsTest, canInsertTargetStatsAfterProperSetup) {
     EXPECT_THAT(inputCommand(InputCommand::DUMP_APP), HasSubstr("gles1InUse = 1"));
 }
 
+TEST_F(GpuStatsTest, canInsertTargetStatsArrayAfterProperSetup) {
+    mGpuStats->insertDriverStats(BUILTIN_DRIVER_PKG_NAME, BUILTIN_DRIVER_VER_NAME,
+                                 BUILTIN_DRIVER_VER_CODE, BUILTIN_DRIVER_BUILD_TIME, APP_PKG_NAME_1,
+                                 VULKAN_VERSION, GpuStatsInfo::Driver::GL, true,
+                                 DRIVER_LOADING_TIME_1);
+    const std::vector<GpuStatsInfo::Stats> stats = {GpuStatsInfo::Stats::CPU_VULKAN_IN_USE,
+                                                    GpuStatsInfo::Stats::FALSE_PREROTATION,
+                                                    GpuStatsInfo::Stats::GLES_1_IN_USE};
+    const std::vector<uint64_t> values = {0, 0, 0};
+    mGpuStats->insertTargetStatsArray(APP_PKG_NAME_1, BUILTIN_DRIVER_VER_CODE, stats, values);
+
+    EXPECT_THAT(inputCommand(InputCommand::DUMP_APP), HasSubstr("cpuVulkanInUse = 1"));
+    EXPECT_THAT(inputCommand(InputCommand::DUMP_APP), HasSubstr("falsePrerotation = 1"));
+    EXPECT_THAT(inputCommand(InputCommand::DUMP_APP), HasSubstr("gles1InUse = 1"));
+}
+
 // Verify we always have the most recently used apps in mAppStats, even when we fill it.
 TEST_F(GpuStatsTest, canInsertMoreThanMaxNumAppRecords) {
     constexpr int kNumExtraApps = 15;
@@ -20,10 +20,15 @@
 
 #include "tracing/GpuMemTracer.h"
 
+#include <android-base/parseint.h>
+#include <android-base/properties.h>
+#include <android-base/strings.h>
 #include <gpumem/GpuMem.h>
 #include <perfetto/trace/android/gpu_mem_event.pbzero.h>
 #include <unistd.h>
+#include <utils/Timers.h>
 
+#include <chrono>
 #include <thread>
 
 PERFETTO_DEFINE_DATA_SOURCE_STATIC_MEMBERS(android::GpuMemTracer::GpuMemDataSource);
@@ -33,6 +38,7 @@ namespace android {
 std::mutex GpuMemTracer::sTraceMutex;
 std::condition_variable GpuMemTracer::sCondition;
 bool GpuMemTracer::sTraceStarted;
+bool GpuMemTracer::sTraceStopped;
 
 void GpuMemTracer::initialize(std::shared_ptr<GpuMem> gpuMem) {
     if (!gpuMem->isInitialized()) {
@@ -89,10 +95,11 @@ void GpuMemTracer::threadLoop(bool infiniteLoop) {
                 sCondition.wait(lock);
             }
         }
-        traceInitialCounters();
+        traceCounters();
         {
             std::lock_guard<std::mutex> lock(GpuMemTracer::sTraceMutex);
             sTraceStarted = false;
+            sTraceStopped = false;
         }
     } while (infiniteLoop);
 
@@ -101,13 +108,59 @@ void GpuMemTracer::threadLoop(bool infiniteLoop) {
     tracerThreadCount--;
 }
 
-void GpuMemTracer::traceInitialCounters() {
+void GpuMemTracer::traceCounters() {
     if (!mGpuMem->isInitialized()) {
         // This should never happen.
         ALOGE("Cannot trace without GpuMem initialization");
         return;
     }
-    mGpuMem->traverseGpuMemTotals([](int64_t ts, uint32_t gpuId, uint32_t pid, uint64_t size) {
+
+    mLastSizes.clear();
+    mTracedPids.clear();
+    for (const auto& pidStr : base::Split(base::GetProperty(kTracedPidsProp, ""), ",")) {
+        uint32_t pid;
+        if (base::ParseUint(pidStr, &pid)) {
+            mTracedPids.insert(pid);
+        }
+    }
+
+    // Poll the gpu memory totals until the session stops. The first poll of a session and
+    // every kPollsPerKeyframe-th one after it are keyframes carrying the full snapshot, so
+    // a consumer can seek into a long trace without replaying it from the start; the polls
+    // in between only emit counters that changed.
+    int pollCount = 0;
+    for (;;) {
+        traceSnapshot(pollCount % kPollsPerKeyframe == 0);
+        pollCount++;
+
+        std::unique_lock<std::mutex> lock(GpuMemTracer::sTraceMutex);
+        sCondition.wait_for(lock, std::chrono::milliseconds(kPollIntervalMs),
+                            [] { return sTraceStopped; });
+        if (sTraceStopped) {
+            break;
+        }
+    }
+}
+
+void GpuMemTracer::traceSnapshot(bool keyframe) {
+    std::unordered_map<uint64_t, uint64_t> sizes;
+    mGpuMem->traverseGpuMemTotals([&](int64_t ts, uint32_t gpuId, uint32_t pid, uint64_t size) {
+        // The global totals (pid 0) are always traced; per-process counters honor the
+        // pid filter when one is set.
+        if (pid != 0 && !mTracedPids.empty() && mTracedPids.count(pid) == 0) {
+            return;
+        }
+
+        const uint64_t key = (uint64_t(gpuId) << 32) | pid;
+        sizes.emplace(key, size);
+
+        if (!keyframe) {
+            const auto lastIt = mLastSizes.find(key);
+            if (lastIt != mLastSizes.end() && lastIt->second == size) {
+                return;
+            }
+        }
+
         GpuMemDataSource::Trace([&](GpuMemDataSource::TraceContext ctx) {
             auto packet = ctx.NewTracePacket();
             packet->set_timestamp_clock_id(perfetto::protos::pbzero::BUILTIN_CLOCK_MONOTONIC);
@@ -118,6 +171,26 @@ void GpuMemTracer::traceInitialCounters() {
             event->set_size(size);
         });
     });
+
+    // Emit a zero for counters that disappeared from the map, so a consumer of the diff
+    // stream does not keep attributing memory to an exited process.
+    const int64_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    for (const auto& [key, lastSize] : mLastSizes) {
+        if (sizes.count(key) != 0) {
+            continue;
+        }
+        GpuMemDataSource::Trace([&, key = key](GpuMemDataSource::TraceContext ctx) {
+            auto packet = ctx.NewTracePacket();
+            packet->set_timestamp_clock_id(perfetto::protos::pbzero::BUILTIN_CLOCK_MONOTONIC);
+            packet->set_timestamp(now);
+            auto* event = packet->set_gpu_mem_total_event();
+            event->set_gpu_id(uint32_t(key >> 32));
+            event->set_pid(uint32_t(key & 0xffffffff));
+            event->set_size(0);
+        });
+    }
+    mLastSizes = std::move(sizes);
+
     // Flush the TraceContext. The last packet in the above loop will go
     // missing without this flush.
     GpuMemDataSource::Trace([](GpuMemDataSource::TraceContext ctx) { ctx.Flush(); });
@@ -19,6 +19,8 @@
 #include <perfetto/tracing.h>
 
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace perfetto::protos {
 class TracePacket;
@@ -37,7 +39,11 @@ public:
             sTraceStarted = true;
             sCondition.notify_all();
         }
-        virtual void OnStop(const StopArgs&) override{};
+        virtual void OnStop(const StopArgs&) override {
+            std::unique_lock<std::mutex> lock(GpuMemTracer::sTraceMutex);
+            sTraceStopped = true;
+            sCondition.notify_all();
+        };
     };
 
     ~GpuMemTracer() = default;
@@ -70,14 +76,32 @@ public:
     static std::condition_variable sCondition;
     static std::mutex sTraceMutex;
     static bool sTraceStarted;
+    static bool sTraceStopped;
+
+    // Sysprop holding a comma-separated list of pids to trace. When set, per-process
+    // counters for any other pid are dropped; the global totals (pid 0) are always kept.
+    static constexpr char kTracedPidsProp[] = "debug.gpumemtracer.trace_pids";
 
 private:
     // Friend class for testing
     friend class GpuMemTracerTest;
 
+    // How often the gpu memory totals map is polled while a trace is active, and how many
+    // polls go between full keyframes. In between keyframes only counters that changed
+    // since the previous poll are emitted, which keeps an always-on session from filling
+    // the trace buffer with identical snapshots.
+    static constexpr int kPollIntervalMs = 100;
+    static constexpr int kPollsPerKeyframe = 100;
+
     void threadLoop(bool infiniteLoop);
-    void traceInitialCounters();
+    void traceCounters();
+    void traceSnapshot(bool keyframe);
     std::shared_ptr<GpuMem> mGpuMem;
+    // Values emitted by the previous poll, keyed by (gpuId << 32) | pid. Only valid while
+    // a trace session is active; cleared when a new session starts.
+    std::unordered_map<uint64_t, uint64_t> mLastSizes;
+    // Parsed from kTracedPidsProp at the start of each session. Empty set means no filter.
+    std::unordered_set<uint32_t> mTracedPids;
     // Count of how many tracer threads are currently active. Useful for testing.
     std::atomic<int32_t> tracerThreadCount = 0;
 };
@@ -23,6 +23,9 @@
 #include <linux/input-event-codes.h>
 #include <linux/input.h>
 #include <server_configurable_flags/get_flags.h>
+#if defined(__linux__)
+    #include <pthread.h>
+#endif
 
 #include "ui/events/ozone/evdev/touch_filter/neural_stylus_palm_detection_filter.h"
 #include "ui/events/ozone/evdev/touch_filter/palm_model/onedevice_train_palm_detection_filter_model.h"
@@ -70,6 +73,21 @@ static const char* INPUT_NATIVE_BOOT = "input_native_boot";
  * 'true' (not case sensitive) or '1'. To disable, specify any other value.
  */
 static const char* PALM_REJECTION_ENABLED = "palm_rejection_enabled";
+/**
+ * Feature flag name. This flag determines whether the palm rejection model runs on a dedicated
+ * inference thread rather than inline on the input pipeline. Events are then passed through
+ * without waiting for the model, and palm suppression takes effect on a subsequent event.
+ * Has no effect unless palm rejection itself is enabled.
+ * To enable, specify 'true' (not case sensitive) or '1'. To disable, specify any other value.
+ */
+static const char* PALM_REJECTION_BATCHED_INFERENCE = "palm_rejection_batched_inference";
+
+/**
+ * Maximum number of samples that can be waiting for palm model inference. At high report rates,
+ * the inference thread drains the accumulated samples in one go, so the queue stays short unless
+ * the thread is starved. Holds more than a second of events from a 240Hz touchscreen.
+ */
+static constexpr size_t MAX_INFERENCE_SAMPLES = 256;
 
 static std::string toLower(std::string s) {
     std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
@@ -98,6 +116,19 @@ static bool isPalmRejectionEnabled() {
     return false;
 }
 
+/**
+ * Return true if batched palm model inference is enabled via the server configurable flags.
+ * Return false otherwise.
+ */
+static bool isPalmRejectionBatchedInferenceEnabled() {
+    std::string value = toLower(server_configurable_flags::GetServerConfigurableFlag(
+            INPUT_NATIVE_BOOT, PALM_REJECTION_BATCHED_INFERENCE, "0"));
+    if (value == "1") {
+        return true;
+    }
+    return false;
+}
+
 static int getLinuxToolCode(int toolType) {
     if (toolType == AMOTION_EVENT_TOOL_TYPE_STYLUS) {
         return BTN_TOOL_PEN;
@@ -315,11 +346,24 @@ std::vector<NotifyMotionArgs> cancelSuppressedPointers(
 }
 
 UnwantedInteractionBlocker::UnwantedInteractionBlocker(InputListenerInterface& listener)
-      : UnwantedInteractionBlocker(listener, isPalmRejectionEnabled()){};
+      : UnwantedInteractionBlocker(listener, isPalmRejectionEnabled(),
+                                   isPalmRejectionBatchedInferenceEnabled()){};
 
 UnwantedInteractionBlocker::UnwantedInteractionBlocker(InputListenerInterface& listener,
-                                                       bool enablePalmRejection)
-      : mQueuedListener(listener), mEnablePalmRejection(enablePalmRejection) {}
+                                                       bool enablePalmRejection,
+                                                       bool enableBatchedInference)
+      : mQueuedListener(listener),
+        mEnablePalmRejection(enablePalmRejection),
+        mEnableBatchedInference(enablePalmRejection && enableBatchedInference),
+        mPalmInferenceQueue(MAX_INFERENCE_SAMPLES) {
+    if (mEnableBatchedInference) {
+        mPalmInferenceThread = std::thread(&UnwantedInteractionBlocker::palmInferenceLoop, this);
+#if defined(__linux__)
+        // Set the thread name for debugging
+        pthread_setname_np(mPalmInferenceThread.native_handle(), "PalmInference");
+#endif
+    }
+}
 
 void UnwantedInteractionBlocker::notifyConfigurationChanged(
         const NotifyConfigurationChangedArgs* args) {
@@ -360,7 +404,31 @@ void UnwantedInteractionBlocker::notifyMotionLocked(const NotifyMotionArgs* args
         return;
     }
 
-    std::vector<NotifyMotionArgs> processedArgs = it->second.processMotion(*args);
+    if (mEnableBatchedInference) {
+        // Pass the event through right away with the suppression detected so far, and let the
+        // inference thread look at it later. Newly detected palms take effect on a later event.
+        const std::shared_ptr<PalmRejector>& palmRejector = it->second;
+        for (const NotifyMotionArgs& loopArgs : palmRejector->applyDetectedSuppression(*args)) {
+            enqueueOutboundMotionLocked(loopArgs);
+        }
+        PalmInferenceSample sample{palmRejector, std::make_unique<NotifyMotionArgs>(*args)};
+        if (!mPalmInferenceQueue.push(std::move(sample))) {
+            // The inference thread has fallen severely behind. Drop the samples it has not looked
+            // at yet and have the model start over at the next gesture, rather than feeding it an
+            // event stream with holes in it.
+            ALOGE("Palm inference queue is full. Resetting palm detection for device %" PRId32,
+                  args->deviceId);
+            const int32_t deviceId = args->deviceId;
+            mPalmInferenceQueue.erase([deviceId](const PalmInferenceSample& queuedSample) {
+                return queuedSample.rejector != nullptr &&
+                        queuedSample.args->deviceId == deviceId;
+            });
+            palmRejector->requestResync();
+        }
+        return;
+    }
+
+    std::vector<NotifyMotionArgs> processedArgs = it->second->processMotion(*args);
     for (const NotifyMotionArgs& loopArgs : processedArgs) {
         enqueueOutboundMotionLocked(loopArgs);
     }
@@ -381,14 +449,24 @@ void UnwantedInteractionBlocker::notifyVibratorState(const NotifyVibratorStateAr
     mQueuedListener.flush();
 }
 void UnwantedInteractionBlocker::notifyDeviceReset(const NotifyDeviceResetArgs* args) {
+    if (mEnableBatchedInference) {
+        // The samples that the inference thread hasn't looked at belong to gestures that are
+        // being reset, so there is no point running the model on them.
+        const int32_t deviceId = args->deviceId;
+        mPalmInferenceQueue.erase([deviceId](const PalmInferenceSample& queuedSample) {
+            return queuedSample.rejector != nullptr && queuedSample.args->deviceId == deviceId;
+        });
+    }
     { // acquire lock
         std::scoped_lock lock(mLock);
         auto it = mPalmRejectors.find(args->deviceId);
         if (it != mPalmRejectors.end()) {
-            AndroidPalmFilterDeviceInfo info = it->second.getPalmFilterDeviceInfo();
+            AndroidPalmFilterDeviceInfo info = it->second->getPalmFilterDeviceInfo();
             // Re-create the object instead of resetting it
             mPalmRejectors.erase(it);
-            mPalmRejectors.emplace(args->deviceId, info);
+            mPalmRejectors.emplace(args->deviceId,
+                                   std::make_shared<PalmRejector>(info, nullptr,
+                                                                  palmProcessingMode()));
         }
         mQueuedListener.notifyDeviceReset(args);
         mPreferStylusOverTouchBlocker.notifyDeviceReset(*args);
@@ -420,11 +498,16 @@ void UnwantedInteractionBlocker::notifyInputDevicesChanged(
             continue;
         }
 
-        auto [it, emplaced] = mPalmRejectors.try_emplace(device.getId(), *info);
-        if (!emplaced && *info != it->second.getPalmFilterDeviceInfo()) {
+        auto it = mPalmRejectors.find(device.getId());
+        if (it != mPalmRejectors.end() && *info != it->second->getPalmFilterDeviceInfo()) {
             // Re-create the PalmRejector because the device info has changed.
             mPalmRejectors.erase(it);
-            mPalmRejectors.emplace(device.getId(), *info);
+            it = mPalmRejectors.end();
+        }
+        if (it == mPalmRejectors.end()) {
+            mPalmRejectors.emplace(device.getId(),
+                                   std::make_shared<PalmRejector>(*info, nullptr,
+                                                                  palmProcessingMode()));
         }
         devicesToKeep.insert(device.getId());
     }
@@ -445,10 +528,14 @@ void UnwantedInteractionBlocker::dump(std::string& dump) {
                          std::to_string(mEnablePalmRejection).c_str());
     dump += StringPrintf("  isPalmRejectionEnabled (flag value): %s\n",
                          std::to_string(isPalmRejectionEnabled()).c_str());
+    dump += StringPrintf("  mEnableBatchedInference: %s\n",
+                         std::to_string(mEnableBatchedInference).c_str());
+    dump += StringPrintf("  isPalmRejectionBatchedInferenceEnabled (flag value): %s\n",
+                         std::to_string(isPalmRejectionBatchedInferenceEnabled()).c_str());
     dump += mPalmRejectors.empty() ? "  mPalmRejectors: None\n" : "  mPalmRejectors:\n";
     for (const auto& [deviceId, palmRejector] : mPalmRejectors) {
         dump += StringPrintf("    deviceId = %" PRId32 ":\n", deviceId);
-        dump += addLinePrefix(palmRejector.dump(), "      ");
+        dump += addLinePrefix(palmRejector->dump(), "      ");
     }
 }
 
@@ -456,7 +543,29 @@ void UnwantedInteractionBlocker::monitor() {
     std::scoped_lock lock(mLock);
 }
 
-UnwantedInteractionBlocker::~UnwantedInteractionBlocker() {}
+PalmProcessingMode UnwantedInteractionBlocker::palmProcessingMode() const {
+    return mEnableBatchedInference ? PalmProcessingMode::BATCHED
+                                   : PalmProcessingMode::SYNCHRONOUS;
+}
+
+void UnwantedInteractionBlocker::palmInferenceLoop() {
+    while (true) {
+        PalmInferenceSample sample = mPalmInferenceQueue.pop();
+        if (sample.rejector == nullptr) {
+            return; // Exit was requested
+        }
+        sample.rejector->detectPalmPointersAsync(*sample.args);
+    }
+}
+
+UnwantedInteractionBlocker::~UnwantedInteractionBlocker() {
+    if (mPalmInferenceThread.joinable()) {
+        // Clearing the queue first guarantees that the exit request fits into it.
+        mPalmInferenceQueue.clear();
+        mPalmInferenceQueue.push(PalmInferenceSample{nullptr, nullptr});
+        mPalmInferenceThread.join();
+    }
+}
 
 void SlotState::update(const NotifyMotionArgs& args) {
     for (size_t i = 0; i < args.pointerCount; i++) {
@@ -536,8 +645,10 @@ public:
 };
 
 PalmRejector::PalmRejector(const AndroidPalmFilterDeviceInfo& info,
-                           std::unique_ptr<::ui::PalmDetectionFilter> filter)
-      : mSharedPalmState(std::make_unique<::ui::SharedPalmDetectionFilterState>()),
+                           std::unique_ptr<::ui::PalmDetectionFilter> filter,
+                           PalmProcessingMode mode)
+      : mMode(mode),
+        mSharedPalmState(std::make_unique<::ui::SharedPalmDetectionFilterState>()),
         mDeviceInfo(info),
         mPalmDetectionFilter(std::move(filter)) {
     if (mPalmDetectionFilter != nullptr) {
@@ -660,20 +771,19 @@ std::set<int32_t> PalmRejector::detectPalmPointers(const NotifyMotionArgs& args)
     return newSuppressedIds;
 }
 
-std::vector<NotifyMotionArgs> PalmRejector::processMotion(const NotifyMotionArgs& args) {
-    if (mPalmDetectionFilter == nullptr) {
-        return {args};
-    }
-    const bool skipThisEvent = args.action == AMOTION_EVENT_ACTION_HOVER_ENTER ||
+/**
+ * Lets not process hover events, button events, or scroll for now.
+ */
+static bool shouldSkipThisEvent(const NotifyMotionArgs& args) {
+    return args.action == AMOTION_EVENT_ACTION_HOVER_ENTER ||
             args.action == AMOTION_EVENT_ACTION_HOVER_MOVE ||
             args.action == AMOTION_EVENT_ACTION_HOVER_EXIT ||
             args.action == AMOTION_EVENT_ACTION_BUTTON_PRESS ||
             args.action == AMOTION_EVENT_ACTION_BUTTON_RELEASE ||
             args.action == AMOTION_EVENT_ACTION_SCROLL;
-    if (skipThisEvent) {
-        // Lets not process hover events, button events, or scroll for now.
-        return {args};
-    }
+}
+
+std::set<int32_t> PalmRejector::updateSuppressedPointerIds(const NotifyMotionArgs& args) {
     if (args.action == AMOTION_EVENT_ACTION_DOWN) {
         mSuppressedPointerIds.clear();
     }
@@ -689,6 +799,20 @@ std::vector<NotifyMotionArgs> PalmRejector::processMotion(const NotifyMotionArgs
         // We can skip this event and just keep the suppressed pointer ids the same as before.
         mSuppressedPointerIds = oldSuppressedIds;
     }
+    return oldSuppressedIds;
+}
+
+std::vector<NotifyMotionArgs> PalmRejector::processMotion(const NotifyMotionArgs& args) {
+    LOG_ALWAYS_FATAL_IF(mMode != PalmProcessingMode::SYNCHRONOUS,
+                        "Must not be called when batched inference is used");
+    if (mPalmDetectionFilter == nullptr) {
+        return {args};
+    }
+    if (shouldSkipThisEvent(args)) {
+        return {args};
+    }
+
+    const std::set<int32_t> oldSuppressedIds = updateSuppressedPointerIds(args);
 
     std::vector<NotifyMotionArgs> argsWithoutUnwantedPointers =
             cancelSuppressedPointers(args, oldSuppressedIds, mSuppressedPointerIds);
@@ -708,6 +832,82 @@ std::vector<NotifyMotionArgs> PalmRejector::processMotion(const NotifyMotionArgs
     return argsWithoutUnwantedPointers;
 }
 
+std::vector<NotifyMotionArgs> PalmRejector::applyDetectedSuppression(const NotifyMotionArgs& args) {
+    LOG_ALWAYS_FATAL_IF(mMode != PalmProcessingMode::BATCHED,
+                        "Only valid when batched inference is used");
+    if (mPalmDetectionFilter == nullptr) {
+        return {args};
+    }
+    if (shouldSkipThisEvent(args)) {
+        return {args};
+    }
+    if (args.action == AMOTION_EVENT_ACTION_DOWN) {
+        mAppliedSuppressedIds.clear();
+    }
+
+    // Pointers are only ever added here: within a gesture, a pointer that has been canceled
+    // downstream can never become valid again.
+    std::set<int32_t> newSuppressedIds = mAppliedSuppressedIds;
+    { // acquire lock
+        std::scoped_lock lock(mDetectionsLock);
+        // The inference thread may still be looking at samples from an earlier gesture. Only
+        // apply its output once it has caught up with the current one.
+        if (mDetectedDownTime == args.downTime) {
+            newSuppressedIds.insert(mDetectedSuppressedIds.begin(), mDetectedSuppressedIds.end());
+        }
+    } // release lock
+
+    std::vector<NotifyMotionArgs> argsWithoutUnwantedPointers =
+            cancelSuppressedPointers(args, mAppliedSuppressedIds, newSuppressedIds);
+    for (const NotifyMotionArgs& checkArgs : argsWithoutUnwantedPointers) {
+        LOG_ALWAYS_FATAL_IF(checkArgs.action == ACTION_UNKNOWN, "%s", checkArgs.dump().c_str());
+    }
+
+    // Only log if new pointers are getting rejected.
+    if (!std::includes(mAppliedSuppressedIds.begin(), mAppliedSuppressedIds.end(),
+                       newSuppressedIds.begin(), newSuppressedIds.end())) {
+        ALOGI("Palm detected, removing pointer ids %s after %" PRId64 "ms from %s",
+              dumpSet(newSuppressedIds).c_str(), ns2ms(args.eventTime - args.downTime),
+              args.dump().c_str());
+    }
+
+    mAppliedSuppressedIds = std::move(newSuppressedIds);
+    return argsWithoutUnwantedPointers;
+}
+
+void PalmRejector::detectPalmPointersAsync(const NotifyMotionArgs& args) {
+    LOG_ALWAYS_FATAL_IF(mMode != PalmProcessingMode::BATCHED,
+                        "Only valid when batched inference is used");
+    if (mPalmDetectionFilter == nullptr) {
+        return;
+    }
+    if (shouldSkipThisEvent(args)) {
+        return;
+    }
+    if (mResyncRequested) {
+        if (args.action != AMOTION_EVENT_ACTION_DOWN) {
+            // The model has missed samples from this gesture, so feeding it the remaining ones
+            // would desync the slot state. Keep dropping until a fresh gesture starts.
+            return;
+        }
+        mResyncRequested = false;
+        mSlotState = SlotState();
+        mSuppressedPointerIds.clear();
+    }
+
+    updateSuppressedPointerIds(args);
+
+    { // acquire lock
+        std::scoped_lock lock(mDetectionsLock);
+        mDetectedDownTime = args.downTime;
+        mDetectedSuppressedIds = mSuppressedPointerIds;
+    } // release lock
+}
+
+void PalmRejector::requestResync() {
+    mResyncRequested = true;
+}
+
 const AndroidPalmFilterDeviceInfo& PalmRejector::getPalmFilterDeviceInfo() const {
     return mDeviceInfo;
 }
@@ -719,6 +919,18 @@ std::string PalmRejector::dump() const {
     deviceInfo << mDeviceInfo << ", touch_major_res=" << mDeviceInfo.touch_major_res
                << ", touch_minor_res=" << mDeviceInfo.touch_minor_res << "\n";
     out += addLinePrefix(deviceInfo.str(), "  ");
+    if (mMode == PalmProcessingMode::BATCHED) {
+        // The model state belongs to the inference thread, so it can't be read safely here.
+        std::set<int32_t> detectedIds;
+        { // acquire lock
+            std::scoped_lock lock(mDetectionsLock);
+            detectedIds = mDetectedSuppressedIds;
+        } // release lock
+        out += "mDetectedSuppressedIds: " + dumpSet(detectedIds) + "\n";
+        out += "mAppliedSuppressedIds: " + dumpSet(mAppliedSuppressedIds) + "\n";
+        out += "Model state is omitted because it is owned by the palm inference thread.\n";
+        return out;
+    }
     out += "mSlotState:\n";
     out += addLinePrefix(mSlotState.dump(), "  ");
     out += "mSuppressedPointerIds: ";
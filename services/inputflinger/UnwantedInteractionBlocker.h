@@ -16,10 +16,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
 
 #include <android-base/thread_annotations.h>
+#include "BlockingQueue.h"
 #include "include/UnwantedInteractionBlockerInterface.h"
 #include "ui/events/ozone/evdev/touch_filter/neural_stylus_palm_detection_filter_util.h"
 #include "ui/events/ozone/evdev/touch_filter/palm_detection_filter.h"
@@ -75,6 +80,15 @@ std::string toString(const ::ui::InProgressTouchEvdev& touch);
 
 class PalmRejector;
 
+// How a PalmRejector invokes the palm model.
+enum class PalmProcessingMode {
+    // The model runs inline via processMotion, and suppression takes effect on the current event.
+    SYNCHRONOUS,
+    // The model runs on a dedicated inference thread via detectPalmPointersAsync, and suppression
+    // takes effect on a subsequent event via applyDetectedSuppression.
+    BATCHED,
+};
+
 // --- Implementations ---
 
 /**
@@ -88,7 +102,8 @@ class PalmRejector;
 class UnwantedInteractionBlocker : public UnwantedInteractionBlockerInterface {
 public:
     explicit UnwantedInteractionBlocker(InputListenerInterface& listener);
-    explicit UnwantedInteractionBlocker(InputListenerInterface& listener, bool enablePalmRejection);
+    explicit UnwantedInteractionBlocker(InputListenerInterface& listener, bool enablePalmRejection,
+                                        bool enableBatchedInference = false);
 
     void notifyConfigurationChanged(const NotifyConfigurationChangedArgs* args) override;
     void notifyKey(const NotifyKeyArgs* args) override;
@@ -111,18 +126,39 @@ private:
 
     QueuedInputListener mQueuedListener;
     const bool mEnablePalmRejection;
+    // When enabled, the palm model runs on a dedicated inference thread instead of inline on the
+    // input pipeline. See PalmProcessingMode.
+    const bool mEnableBatchedInference;
 
     // When stylus is down, ignore touch
     PreferStylusOverTouchBlocker mPreferStylusOverTouchBlocker GUARDED_BY(mLock);
 
     // Detect and reject unwanted palms on screen
     // Use a separate palm rejector for every touch device.
-    std::map<int32_t /*deviceId*/, PalmRejector> mPalmRejectors GUARDED_BY(mLock);
+    // The rejectors are shared with the palm inference queue, so a rejector that's removed here
+    // stays alive until the inference thread has processed its remaining samples.
+    std::map<int32_t /*deviceId*/, std::shared_ptr<PalmRejector>> mPalmRejectors GUARDED_BY(mLock);
     // TODO(b/210159205): delete this when simultaneous stylus and touch is supported
     void notifyMotionLocked(const NotifyMotionArgs* args) REQUIRES(mLock);
 
     // Call this function for outbound events so that they can be logged when logging is enabled.
     void enqueueOutboundMotionLocked(const NotifyMotionArgs& args) REQUIRES(mLock);
+
+    // A single motion event waiting for palm model inference. A null rejector asks the inference
+    // thread to exit.
+    struct PalmInferenceSample {
+        std::shared_ptr<PalmRejector> rejector;
+        std::unique_ptr<NotifyMotionArgs> args;
+    };
+
+    PalmProcessingMode palmProcessingMode() const;
+
+    // Samples that have been passed through to the next stage but have not yet been seen by the
+    // palm model. Only used when batched inference is enabled.
+    BlockingQueue<PalmInferenceSample> mPalmInferenceQueue;
+    // Runs the palm model on the queued samples. Only started when batched inference is enabled.
+    std::thread mPalmInferenceThread;
+    void palmInferenceLoop();
 };
 
 class SlotState {
@@ -162,9 +198,29 @@ std::vector<::ui::InProgressTouchEvdev> getTouches(const NotifyMotionArgs& args,
 class PalmRejector {
 public:
     explicit PalmRejector(const AndroidPalmFilterDeviceInfo& info,
-                          std::unique_ptr<::ui::PalmDetectionFilter> filter = nullptr);
+                          std::unique_ptr<::ui::PalmDetectionFilter> filter = nullptr,
+                          PalmProcessingMode mode = PalmProcessingMode::SYNCHRONOUS);
     std::vector<NotifyMotionArgs> processMotion(const NotifyMotionArgs& args);
 
+    /**
+     * Batched mode, input thread: pass the event through with the most recently detected
+     * suppression applied. Does not run the palm model, so it is cheap enough for the
+     * latency-critical path.
+     */
+    std::vector<NotifyMotionArgs> applyDetectedSuppression(const NotifyMotionArgs& args);
+
+    /**
+     * Batched mode, inference thread: run the palm model on this sample and publish the detected
+     * palm pointers for applyDetectedSuppression to pick up on a subsequent event.
+     */
+    void detectPalmPointersAsync(const NotifyMotionArgs& args);
+
+    /**
+     * Batched mode: the model has missed some samples (for example, because the inference queue
+     * overflowed). Drop the desynced model state and start fresh at the next gesture.
+     */
+    void requestResync();
+
     // Get the device info of this device, for comparison purposes
     const AndroidPalmFilterDeviceInfo& getPalmFilterDeviceInfo() const;
     std::string dump() const;
@@ -181,13 +237,36 @@ private:
      * the incoming args! Also, it will call Filter(..), which has side-effects.
      */
     std::set<int32_t> detectPalmPointers(const NotifyMotionArgs& args);
+
+    /**
+     * Run the model on the incoming event and update mSuppressedPointerIds.
+     * Return the previously suppressed pointer ids.
+     */
+    std::set<int32_t> updateSuppressedPointerIds(const NotifyMotionArgs& args);
+
+    const PalmProcessingMode mMode;
     std::unique_ptr<::ui::SharedPalmDetectionFilterState> mSharedPalmState;
     AndroidPalmFilterDeviceInfo mDeviceInfo;
     std::unique_ptr<::ui::PalmDetectionFilter> mPalmDetectionFilter;
+    // In batched mode, this state (and the model state above) belongs to the inference thread.
     std::set<int32_t> mSuppressedPointerIds;
 
     // Used to help convert an Android touch stream to Linux input stream.
     SlotState mSlotState;
+
+    // Batched mode: pointer ids the input thread has already canceled downstream.
+    // Only touched by the input thread.
+    std::set<int32_t> mAppliedSuppressedIds;
+
+    // Batched mode: the latest model output, written by the inference thread and read by the
+    // input thread. Tagged with the gesture's down time so that late detections belonging to an
+    // earlier gesture are never applied to the current one.
+    mutable std::mutex mDetectionsLock;
+    nsecs_t mDetectedDownTime GUARDED_BY(mDetectionsLock) = 0;
+    std::set<int32_t> mDetectedSuppressedIds GUARDED_BY(mDetectionsLock);
+
+    // Batched mode: set by the input thread when the model has missed samples.
+    std::atomic<bool> mResyncRequested{false};
 };
 
 } // namespace android
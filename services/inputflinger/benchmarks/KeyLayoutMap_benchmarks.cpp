@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <android-base/stringprintf.h>
+#include <input/KeyLayoutMap.h>
+#include <log/log.h>
+
+namespace android {
+
+namespace {
+
+// The number of scan code and usage code entries in the synthetic layout. A real keyboard layout
+// maps a few hundred scan codes; gaming keyboards additionally map HID usages.
+constexpr int32_t NUM_SCAN_CODES = 256;
+constexpr int32_t NUM_USAGE_CODES = 64;
+constexpr int32_t FIRST_USAGE_CODE = 0x0c0000;
+
+std::shared_ptr<KeyLayoutMap> loadSyntheticLayout() {
+    std::string contents;
+    for (int32_t scanCode = 1; scanCode <= NUM_SCAN_CODES; scanCode++) {
+        contents += base::StringPrintf("key %d A\n", scanCode);
+    }
+    for (int32_t i = 0; i < NUM_USAGE_CODES; i++) {
+        contents += base::StringPrintf("key usage 0x%08x B\n", FIRST_USAGE_CODE + i);
+    }
+    base::Result<std::shared_ptr<KeyLayoutMap>> ret =
+            KeyLayoutMap::loadContents("synthetic.kl", contents.c_str());
+    LOG_ALWAYS_FATAL_IF(!ret.ok(), "Could not load synthetic key layout");
+    return *ret;
+}
+
+} // namespace
+
+/**
+ * Map a burst of key events by scan code, the path taken for every key event from a built-in
+ * keyboard.
+ */
+static void benchmarkMapKeyByScanCode(benchmark::State& state) {
+    std::shared_ptr<KeyLayoutMap> map = loadSyntheticLayout();
+    int32_t scanCode = 1;
+    for (auto _ : state) {
+        int32_t keyCode;
+        uint32_t flags;
+        benchmark::DoNotOptimize(map->mapKey(scanCode, /*usageCode=*/0, &keyCode, &flags));
+        scanCode = scanCode % NUM_SCAN_CODES + 1;
+    }
+}
+
+/**
+ * Map a burst of key events by HID usage code, the path taken for keys that report usages
+ * (typically external and gaming keyboards).
+ */
+static void benchmarkMapKeyByUsageCode(benchmark::State& state) {
+    std::shared_ptr<KeyLayoutMap> map = loadSyntheticLayout();
+    int32_t usageIndex = 0;
+    for (auto _ : state) {
+        int32_t keyCode;
+        uint32_t flags;
+        benchmark::DoNotOptimize(
+                map->mapKey(/*scanCode=*/0, FIRST_USAGE_CODE + usageIndex, &keyCode, &flags));
+        usageIndex = (usageIndex + 1) % NUM_USAGE_CODES;
+    }
+}
+
+/**
+ * Map a scan code that has no entry in the layout, which is the miss path for keys handled by the
+ * key character map instead.
+ */
+static void benchmarkMapUnmappedScanCode(benchmark::State& state) {
+    std::shared_ptr<KeyLayoutMap> map = loadSyntheticLayout();
+    for (auto _ : state) {
+        int32_t keyCode;
+        uint32_t flags;
+        benchmark::DoNotOptimize(
+                map->mapKey(NUM_SCAN_CODES + 1, /*usageCode=*/0, &keyCode, &flags));
+    }
+}
+
+BENCHMARK(benchmarkMapKeyByScanCode);
+BENCHMARK(benchmarkMapKeyByUsageCode);
+BENCHMARK(benchmarkMapUnmappedScanCode);
+
+} // namespace android
@@ -16,15 +16,21 @@
 
 #include "AnrTracker.h"
 
-namespace android::inputdispatcher {
+#include <inttypes.h>
 
-template <typename T>
-static T max(const T& a, const T& b) {
-    return a < b ? b : a;
-}
+#include <android-base/stringprintf.h>
+
+using android::base::StringPrintf;
+
+namespace android::inputdispatcher {
 
 void AnrTracker::insert(nsecs_t timeoutTime, sp<IBinder> token) {
-    mAnrTimeouts.insert(std::make_pair(timeoutTime, std::move(token)));
+    if (mFirstValid && timeoutTime < mFirstTimeout) {
+        mFirstTimeout = timeoutTime;
+        mFirstToken = token;
+    }
+    mTimeoutsByToken[std::move(token)].insert(timeoutTime);
+    mNumInserts++;
 }
 
 /**
@@ -32,42 +38,87 @@ void AnrTracker::insert(nsecs_t timeoutTime, sp<IBinder> token) {
  * (same time, same connection), then only remove one of them.
  */
 void AnrTracker::erase(nsecs_t timeoutTime, const sp<IBinder>& token) {
-    auto pair = std::make_pair(timeoutTime, token);
-    auto it = mAnrTimeouts.find(pair);
-    if (it != mAnrTimeouts.end()) {
-        mAnrTimeouts.erase(it);
+    auto it = mTimeoutsByToken.find(token);
+    if (it == mTimeoutsByToken.end()) {
+        return;
+    }
+    std::multiset<nsecs_t>& timeouts = it->second;
+    auto timeoutIt = timeouts.find(timeoutTime);
+    if (timeoutIt == timeouts.end()) {
+        return;
+    }
+    timeouts.erase(timeoutIt);
+    mNumErases++;
+    if (timeouts.empty()) {
+        mTimeoutsByToken.erase(it);
+    }
+    if (mFirstValid && timeoutTime == mFirstTimeout && token == mFirstToken) {
+        // The cached earliest entry was removed (or one of its duplicates). Recompute lazily.
+        mFirstValid = false;
     }
 }
 
 void AnrTracker::eraseToken(const sp<IBinder>& token) {
-    for (auto it = mAnrTimeouts.begin(); it != mAnrTimeouts.end();) {
-        if (it->second == token) {
-            it = mAnrTimeouts.erase(it);
-        } else {
-            ++it;
-        }
+    auto it = mTimeoutsByToken.find(token);
+    if (it == mTimeoutsByToken.end()) {
+        return;
+    }
+    mNumErases += it->second.size();
+    mTimeoutsByToken.erase(it);
+    if (mFirstValid && token == mFirstToken) {
+        mFirstValid = false;
     }
 }
 
 bool AnrTracker::empty() const {
-    return mAnrTimeouts.empty();
+    return mTimeoutsByToken.empty();
+}
+
+void AnrTracker::recomputeFirstIfNeeded() const {
+    if (mFirstValid) {
+        return;
+    }
+    mFirstTimeout = std::numeric_limits<nsecs_t>::max();
+    mFirstToken = nullptr;
+    for (const auto& [token, timeouts] : mTimeoutsByToken) {
+        // The smallest pending timeout of each connection is at the front of its set.
+        if (*timeouts.begin() < mFirstTimeout) {
+            mFirstTimeout = *timeouts.begin();
+            mFirstToken = token;
+        }
+    }
+    mFirstValid = true;
+    mNumFirstRecomputes++;
 }
 
 // If empty() is false, return the time at which the next connection should cause an ANR
 // If empty() is true, return LONG_LONG_MAX
 nsecs_t AnrTracker::firstTimeout() const {
-    if (mAnrTimeouts.empty()) {
-        return std::numeric_limits<nsecs_t>::max();
-    }
-    return mAnrTimeouts.begin()->first;
+    recomputeFirstIfNeeded();
+    return mFirstTimeout;
 }
 
 const sp<IBinder>& AnrTracker::firstToken() const {
-    return mAnrTimeouts.begin()->second;
+    recomputeFirstIfNeeded();
+    return mFirstToken;
 }
 
 void AnrTracker::clear() {
-    mAnrTimeouts.clear();
+    mTimeoutsByToken.clear();
+    mFirstTimeout = std::numeric_limits<nsecs_t>::max();
+    mFirstToken = nullptr;
+    mFirstValid = true;
+}
+
+std::string AnrTracker::dump(const char* prefix) const {
+    size_t pendingTimeouts = 0;
+    for (const auto& [token, timeouts] : mTimeoutsByToken) {
+        pendingTimeouts += timeouts.size();
+    }
+    return StringPrintf("%sAnrTracker: pendingTimeouts=%zu, connections=%zu, inserts=%" PRIu64
+                        ", erases=%" PRIu64 ", firstRecomputes=%" PRIu64 "\n",
+                        prefix, pendingTimeouts, mTimeoutsByToken.size(), mNumInserts, mNumErases,
+                        mNumFirstRecomputes);
 }
 
 } // namespace android::inputdispatcher
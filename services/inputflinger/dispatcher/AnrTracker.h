@@ -19,7 +19,10 @@
 
 #include <binder/IBinder.h>
 #include <utils/Timers.h>
+#include <limits>
 #include <set>
+#include <string>
+#include <unordered_map>
 
 namespace android::inputdispatcher {
 
@@ -42,17 +45,38 @@ public:
     // Do not call this unless empty() is false, you will encounter undefined behaviour.
     const sp<IBinder>& firstToken() const;
 
+    std::string dump(const char* prefix) const;
+
 private:
-    // Optimization: use a multiset to keep track of the event timeouts. When an event is sent
-    // to the InputConsumer, we add an entry to this structure. We look at the smallest value to
-    // determine if any of the connections is unresponsive, and to determine when we should wake
-    // next for the future ANR check.
-    // Using a multiset helps quickly look up the next timeout due.
+    struct IBinderHash {
+        std::size_t operator()(const sp<IBinder>& b) const {
+            return std::hash<IBinder*>{}(b.get());
+        }
+    };
+
+    // The pending timeouts, grouped by connection. A timeout is armed for every dispatched event
+    // and disarmed when the event is finished, so those are the hottest operations here. Each
+    // connection only has a handful of events in flight at a time, so the per-connection sets
+    // stay tiny no matter how many windows are receiving events, unlike a single sorted set of
+    // all timeouts whose rebalancing cost grows with the total in-flight count.
     //
-    // We must use a multi-set, because it is plausible (although highly unlikely) to have entries
-    // from the same connection and same timestamp, but different sequence numbers.
-    // We are not tracking sequence numbers, and just allow duplicates to exist.
-    std::multiset<std::pair<nsecs_t /*timeoutTime*/, sp<IBinder> /*connectionToken*/>> mAnrTimeouts;
+    // We must allow duplicates within a connection, because it is plausible (although highly
+    // unlikely) to have entries with the same time but different sequence numbers. We are not
+    // tracking sequence numbers, and just allow duplicates to exist.
+    std::unordered_map<sp<IBinder>, std::multiset<nsecs_t>, IBinderHash> mTimeoutsByToken;
+
+    // Cached earliest entry. Kept up to date on insert; invalidated when the earliest entry is
+    // erased, and lazily recomputed by the next query. Most events finish well before their
+    // timeout, so erases rarely hit the earliest entry and recomputes stay rare.
+    mutable nsecs_t mFirstTimeout = std::numeric_limits<nsecs_t>::max();
+    mutable sp<IBinder> mFirstToken;
+    mutable bool mFirstValid = true;
+    void recomputeFirstIfNeeded() const;
+
+    // Instrumentation of the timer churn, for dumpsys.
+    uint64_t mNumInserts = 0;
+    uint64_t mNumErases = 0;
+    mutable uint64_t mNumFirstRecomputes = 0;
 };
 
 } // namespace android::inputdispatcher
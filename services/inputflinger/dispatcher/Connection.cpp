@@ -18,8 +18,38 @@
 
 #include "Entry.h"
 
+#include <android-base/stringprintf.h>
+#include <inttypes.h>
+#include <algorithm>
+
+using android::base::StringPrintf;
+
 namespace android::inputdispatcher {
 
+namespace {
+
+// Returns the histogram bucket for 'value', where bucket i covers values up to 2^i and the last
+// bucket covers everything larger.
+template <size_t N>
+size_t bucketFor(const std::array<uint64_t, N>& histogram, uint64_t value) {
+    size_t bucket = 0;
+    while (bucket < histogram.size() - 1 && value > (uint64_t(1) << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+template <size_t N>
+std::string dumpHistogram(const std::array<uint64_t, N>& histogram) {
+    std::string dump;
+    for (size_t i = 0; i < histogram.size(); i++) {
+        dump += StringPrintf("%s%" PRIu64, i ? ", " : "", histogram[i]);
+    }
+    return dump;
+}
+
+} // namespace
+
 Connection::Connection(const std::shared_ptr<InputChannel>& inputChannel, bool monitor,
                        const IdGenerator& idGenerator)
       : status(Status::NORMAL),
@@ -40,6 +70,28 @@ const std::string Connection::getWindowName() const {
     return "?";
 }
 
+void Connection::OutboundQueueStats::recordEnqueue(size_t depth) {
+    enqueuedCount++;
+    maxDepth = std::max(maxDepth, depth);
+    depthHistogram[bucketFor(depthHistogram, depth)]++;
+}
+
+void Connection::OutboundQueueStats::recordPublish(nsecs_t age) {
+    publishAgeHistogram[bucketFor(publishAgeHistogram, static_cast<uint64_t>(ns2ms(age)))]++;
+}
+
+std::string Connection::OutboundQueueStats::dump(const char* prefix) const {
+    std::string dump;
+    dump += StringPrintf("%sOutboundQueueStats: enqueued=%" PRIu64 ", coalesced=%" PRIu64
+                         ", maxDepth=%zu\n",
+                         prefix, enqueuedCount, coalescedCount, maxDepth);
+    dump += StringPrintf("%s  depthAtEnqueue(<=1, <=2, <=4, ...): [%s]\n", prefix,
+                         dumpHistogram(depthHistogram).c_str());
+    dump += StringPrintf("%s  publishAgeMs(<=1, <=2, <=4, ...): [%s]\n", prefix,
+                         dumpHistogram(publishAgeHistogram).c_str());
+    return dump;
+}
+
 std::deque<DispatchEntry*>::iterator Connection::findWaitQueueEntry(uint32_t seq) {
     for (std::deque<DispatchEntry*>::iterator it = waitQueue.begin(); it != waitQueue.end(); it++) {
         if ((*it)->seq == seq) {
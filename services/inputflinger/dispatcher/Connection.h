@@ -21,6 +21,7 @@
 
 #include <input/InputTransport.h>
 #include <utils/RefBase.h>
+#include <array>
 #include <deque>
 
 namespace android::inputdispatcher {
@@ -63,6 +64,25 @@ public:
     // yet received a "finished" response from the application.
     std::deque<DispatchEntry*> waitQueue;
 
+    /* Telemetry of the outbound queue's behavior under load, for dumpsys. */
+    struct OutboundQueueStats {
+        // Histogram of the queue depth observed after each enqueue. Bucket i counts depths up to
+        // 2^i, with the last bucket counting everything deeper.
+        std::array<uint64_t, 10> depthHistogram{};
+        // Histogram of the event's age (now - eventTime) at the moment it was published to the
+        // connection, in exponentially growing millisecond buckets: <=1ms, <=2ms, <=4ms, ...
+        std::array<uint64_t, 10> publishAgeHistogram{};
+        uint64_t enqueuedCount = 0;
+        // The number of MOVE events that were coalesced away because the queue got too deep.
+        uint64_t coalescedCount = 0;
+        size_t maxDepth = 0;
+
+        void recordEnqueue(size_t depth);
+        void recordPublish(nsecs_t age);
+        std::string dump(const char* prefix) const;
+    };
+    OutboundQueueStats outboundQueueStats;
+
     Connection(const std::shared_ptr<InputChannel>& inputChannel, bool monitor,
                const IdGenerator& idGenerator);
 
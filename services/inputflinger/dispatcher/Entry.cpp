@@ -17,6 +17,7 @@
 #include "Entry.h"
 
 #include "Connection.h"
+#include "EntryPool.h"
 
 #include <android-base/properties.h>
 #include <android-base/stringprintf.h>
@@ -28,6 +29,46 @@ using android::base::StringPrintf;
 
 namespace android::inputdispatcher {
 
+namespace {
+
+// Upper bounds on the free blocks each pool retains, sized to absorb a busy steady state (a few
+// events in flight, each dispatched to a handful of targets) without pinning the memory of a
+// large backlog after it drains.
+constexpr size_t MAX_FREE_KEY_ENTRIES = 32;
+constexpr size_t MAX_FREE_MOTION_ENTRIES = 64;
+constexpr size_t MAX_FREE_DISPATCH_ENTRIES = 128;
+
+// The pools are intentionally leaked: an entry held by static state could otherwise be destroyed
+// during process teardown after a function-local static pool has already been destructed.
+EntryPool& keyEntryPool() {
+    static EntryPool& pool = *new EntryPool("KeyEntry", sizeof(KeyEntry), MAX_FREE_KEY_ENTRIES);
+    return pool;
+}
+
+EntryPool& motionEntryPool() {
+    static EntryPool& pool =
+            *new EntryPool("MotionEntry", sizeof(MotionEntry), MAX_FREE_MOTION_ENTRIES);
+    return pool;
+}
+
+EntryPool& dispatchEntryPool() {
+    static EntryPool& pool =
+            *new EntryPool("DispatchEntry", sizeof(DispatchEntry), MAX_FREE_DISPATCH_ENTRIES);
+    return pool;
+}
+
+} // namespace
+
+std::string dumpEntryPools(const char* prefix) {
+    std::string dump = prefix;
+    dump += "EntryPools:\n";
+    const std::string entryPrefix = std::string(prefix) + "  ";
+    dump += keyEntryPool().dump(entryPrefix.c_str());
+    dump += motionEntryPool().dump(entryPrefix.c_str());
+    dump += dispatchEntryPool().dump(entryPrefix.c_str());
+    return dump;
+}
+
 VerifiedKeyEvent verifiedKeyEventFromKeyEntry(const KeyEntry& entry) {
     return {{VerifiedInputEvent::Type::KEY, entry.deviceId, entry.eventTime, entry.source,
              entry.displayId},
@@ -184,6 +225,14 @@ std::string KeyEntry::getDescription() const {
                         keyCode, scanCode, metaState, repeatCount, policyFlags);
 }
 
+void* KeyEntry::operator new(size_t size) {
+    return keyEntryPool().alloc(size);
+}
+
+void KeyEntry::operator delete(void* ptr, size_t size) {
+    keyEntryPool().dealloc(ptr, size);
+}
+
 void KeyEntry::recycle() {
     releaseInjectionState();
 
@@ -240,6 +289,14 @@ MotionEntry::MotionEntry(int32_t id, nsecs_t eventTime, int32_t deviceId, uint32
 
 MotionEntry::~MotionEntry() {}
 
+void* MotionEntry::operator new(size_t size) {
+    return motionEntryPool().alloc(size);
+}
+
+void MotionEntry::operator delete(void* ptr, size_t size) {
+    motionEntryPool().dealloc(ptr, size);
+}
+
 std::string MotionEntry::getDescription() const {
     if (!GetBoolProperty("ro.debuggable", false)) {
         return "MotionEvent";
@@ -320,6 +377,14 @@ DispatchEntry::DispatchEntry(std::shared_ptr<EventEntry> eventEntry, int32_t tar
         resolvedAction(0),
         resolvedFlags(0) {}
 
+void* DispatchEntry::operator new(size_t size) {
+    return dispatchEntryPool().alloc(size);
+}
+
+void DispatchEntry::operator delete(void* ptr, size_t size) {
+    dispatchEntryPool().dealloc(ptr, size);
+}
+
 uint32_t DispatchEntry::nextSeq() {
     // Sequence number 0 is reserved and will never be returned.
     uint32_t seq;
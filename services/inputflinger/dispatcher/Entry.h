@@ -156,6 +156,10 @@ struct KeyEntry : EventEntry {
     std::string getDescription() const override;
     void recycle();
 
+    // Allocated from a pool so that steady-state dispatch does not hit the heap allocator.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     ~KeyEntry() override;
 };
 
@@ -187,6 +191,11 @@ struct MotionEntry : EventEntry {
                 const PointerProperties* pointerProperties, const PointerCoords* pointerCoords);
     std::string getDescription() const override;
 
+    // Allocated from a pool: this is the hottest and, due to the inline pointer arrays, by far the
+    // largest per-event allocation the dispatcher makes.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     ~MotionEntry() override;
 };
 
@@ -246,12 +255,20 @@ struct DispatchEntry {
 
     inline bool isSplit() const { return targetFlags & InputTarget::FLAG_SPLIT; }
 
+    // Allocated from a pool: one wrapper is created per event per target, so at high event rates
+    // these dominate the dispatch cycle's allocations together with MotionEntry.
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
 private:
     static volatile int32_t sNextSeqAtomic;
 
     static uint32_t nextSeq();
 };
 
+// Occupancy and hit-rate stats of the pools behind the pooled entry types above, for dumpsys.
+std::string dumpEntryPools(const char* prefix);
+
 VerifiedKeyEvent verifiedKeyEventFromKeyEntry(const KeyEntry& entry);
 VerifiedMotionEvent verifiedMotionEventFromMotionEntry(const MotionEntry& entry,
                                                        const ui::Transform& rawTransform);
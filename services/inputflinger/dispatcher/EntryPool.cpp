@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EntryPool.h"
+
+#include <android-base/stringprintf.h>
+#include <inttypes.h>
+#include <log/log.h>
+
+using android::base::StringPrintf;
+
+namespace android::inputdispatcher {
+
+EntryPool::EntryPool(const char* name, size_t blockSize, size_t maxFreeBlocks)
+      : mName(name), mBlockSize(blockSize), mMaxFreeBlocks(maxFreeBlocks) {
+    mFreeBlocks.reserve(maxFreeBlocks);
+}
+
+EntryPool::~EntryPool() {
+    std::scoped_lock _l(mMutex);
+    LOG_ALWAYS_FATAL_IF(mInUseBlocks != 0,
+                        "Destroying pool '%s' while %zu of its blocks are still in use", mName,
+                        mInUseBlocks);
+    for (void* block : mFreeBlocks) {
+        ::operator delete(block);
+    }
+}
+
+void* EntryPool::alloc(size_t size) {
+    if (size > mBlockSize) {
+        return ::operator new(size);
+    }
+    { // acquire lock
+        std::scoped_lock _l(mMutex);
+        mNumAllocs++;
+        mInUseBlocks++;
+        if (!mFreeBlocks.empty()) {
+            mNumReuses++;
+            void* block = mFreeBlocks.back();
+            mFreeBlocks.pop_back();
+            return block;
+        }
+    } // release lock
+    // Always hand out full-sized blocks, so that any of them can be reused for any allocation.
+    return ::operator new(mBlockSize);
+}
+
+void EntryPool::dealloc(void* block, size_t size) {
+    if (size > mBlockSize) {
+        ::operator delete(block);
+        return;
+    }
+    { // acquire lock
+        std::scoped_lock _l(mMutex);
+        mInUseBlocks--;
+        if (mFreeBlocks.size() < mMaxFreeBlocks) {
+            mFreeBlocks.push_back(block);
+            return;
+        }
+    } // release lock
+    ::operator delete(block);
+}
+
+std::string EntryPool::dump(const char* prefix) const {
+    std::scoped_lock _l(mMutex);
+    return StringPrintf("%s%s: blockSize=%zu, inUse=%zu, free=%zu/%zu, allocs=%" PRIu64
+                        " (%" PRIu64 " recycled)\n",
+                        prefix, mName, mBlockSize, mInUseBlocks, mFreeBlocks.size(), mMaxFreeBlocks,
+                        mNumAllocs, mNumReuses);
+}
+
+} // namespace android::inputdispatcher
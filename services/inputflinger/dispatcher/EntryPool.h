@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _UI_INPUT_INPUTDISPATCHER_ENTRYPOOL_H
+#define _UI_INPUT_INPUTDISPATCHER_ENTRYPOOL_H
+
+#include <android-base/thread_annotations.h>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace android::inputdispatcher {
+
+/**
+ * A thread-safe pool of fixed-size memory blocks, used to recycle the dispatcher's per-event
+ * objects instead of paying an allocator round trip for every event.
+ *
+ * The pools are type-segregated: each recycled type routes its class-level operator new / delete
+ * to its own EntryPool (see Entry.h), so all blocks of a pool have the same size and any free
+ * block can satisfy any allocation. Allocations larger than the block size (which would only
+ * appear if a pooled type gained a subclass) fall through to the heap.
+ *
+ * At most maxFreeBlocks released blocks are kept around for reuse; the rest go back to the heap,
+ * so a burst of queued events (e.g. during an ANR) does not pin its memory forever.
+ */
+class EntryPool {
+public:
+    EntryPool(const char* name, size_t blockSize, size_t maxFreeBlocks);
+    // All blocks must have been released before the pool is destroyed.
+    ~EntryPool();
+
+    void* alloc(size_t size);
+    void dealloc(void* block, size_t size);
+
+    std::string dump(const char* prefix) const;
+
+private:
+    EntryPool(const EntryPool&) = delete;
+    EntryPool& operator=(const EntryPool&) = delete;
+
+    const char* const mName;
+    const size_t mBlockSize;
+    const size_t mMaxFreeBlocks;
+
+    mutable std::mutex mMutex;
+    // Released blocks available for reuse, most recently released last.
+    std::vector<void*> mFreeBlocks GUARDED_BY(mMutex);
+    // The number of blocks handed out and not yet released.
+    size_t mInUseBlocks GUARDED_BY(mMutex) = 0;
+
+    // Instrumentation of the pool's effectiveness, for dumpsys.
+    uint64_t mNumAllocs GUARDED_BY(mMutex) = 0;
+    uint64_t mNumReuses GUARDED_BY(mMutex) = 0;
+};
+
+} // namespace android::inputdispatcher
+
+#endif // _UI_INPUT_INPUTDISPATCHER_ENTRYPOOL_H
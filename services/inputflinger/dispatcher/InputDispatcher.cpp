@@ -103,6 +103,12 @@ constexpr std::chrono::nanoseconds KEY_WAITING_FOR_EVENTS_TIMEOUT = 500ms;
 // Number of recent events to keep for debugging purposes.
 constexpr size_t RECENT_QUEUE_MAX_SIZE = 10;
 
+// Outbound queue depth beyond which consecutive unpublished MOVE events of the same stream are
+// coalesced rather than queued individually. A healthy app's queue drains within a frame and
+// never gets near this; a stalled one keeps only the freshest sample per stream instead of
+// ballooning its backlog until the ANR fires.
+constexpr size_t OUTBOUND_QUEUE_COALESCING_THRESHOLD = 20;
+
 // Event log tags. See EventLogTags.logtags for reference.
 constexpr int LOGTAG_INPUT_INTERACTION = 62000;
 constexpr int LOGTAG_INPUT_FOCUS = 62001;
@@ -551,6 +557,9 @@ InputDispatcher::InputDispatcher(const sp<InputDispatcherPolicyInterface>& polic
         // initialize it here anyways.
         mInTouchMode(kDefaultInTouchMode),
         mMaximumObscuringOpacityForTouch(1.0f),
+        mTouchHitTests(0),
+        mTouchHitTestTotalTime(0),
+        mTouchHitTestMaxTime(0),
         mFocusedDisplayId(ADISPLAY_ID_DEFAULT),
         mWindowTokenWithPointerCapture(nullptr),
         mStaleEventTimeout(staleEventTimeout),
@@ -908,6 +917,60 @@ void InputDispatcher::dispatchOnceInnerLocked(nsecs_t* nextWakeupTime) {
 
         releasePendingEventLocked();
         *nextWakeupTime = LONG_LONG_MIN; // force next poll to wake up immediately
+    } else if (mPendingEvent->type == EventEntry::Type::MOTION && !isAppSwitchDue &&
+               mNextUnblockedEvent == nullptr &&
+               isFromSource(static_cast<const MotionEntry&>(*mPendingEvent).source,
+                            AINPUT_SOURCE_CLASS_POINTER)) {
+        // The pending pointer event is blocked waiting on its target display, for example
+        // on an application that is still starting up or a window that has paused
+        // dispatching. Pointer streams on other displays are independent of that display's
+        // stream, so let them through instead of stalling every display behind one.
+        dispatchOtherDisplaysWhileBlockedLocked(currentTime, nextWakeupTime);
+    }
+}
+
+void InputDispatcher::dispatchOtherDisplaysWhileBlockedLocked(nsecs_t currentTime,
+                                                              nsecs_t* nextWakeupTime) {
+    const int32_t blockedDisplayId = getTargetDisplayId(*mPendingEvent);
+    for (auto it = mInboundQueue.begin(); it != mInboundQueue.end();) {
+        if ((*it)->type != EventEntry::Type::MOTION) {
+            // Reordering around anything other than a pointer stream (keys, focus or
+            // configuration changes, ...) could change what the events mean, so stop at
+            // the first such entry and let the normal flow handle the rest in order.
+            return;
+        }
+        std::shared_ptr<MotionEntry> motionEntry = std::static_pointer_cast<MotionEntry>(*it);
+        if (!isFromSource(motionEntry->source, AINPUT_SOURCE_CLASS_POINTER)) {
+            return;
+        }
+        if (motionEntry->displayId == blockedDisplayId) {
+            // Keep the blocked display's own stream queued, in order, behind the pending
+            // event.
+            ++it;
+            continue;
+        }
+
+        DropReason dropReason = DropReason::NOT_DROPPED;
+        if (!(motionEntry->policyFlags & POLICY_FLAG_PASS_TO_USER)) {
+            dropReason = DropReason::POLICY;
+        } else if (!mDispatchEnabled) {
+            dropReason = DropReason::DISABLED;
+        } else if (isStaleEvent(currentTime, *motionEntry)) {
+            dropReason = DropReason::STALE;
+        }
+        if (motionEntry->policyFlags & POLICY_FLAG_PASS_TO_USER) {
+            pokeUserActivityLocked(*motionEntry);
+        }
+        if (!dispatchMotionLocked(currentTime, motionEntry, &dropReason, nextWakeupTime)) {
+            // This display is blocked too. Leave the entry queued; it will be retried the
+            // next time the dispatcher wakes up.
+            return;
+        }
+        if (dropReason != DropReason::NOT_DROPPED) {
+            dropInboundEventLocked(*motionEntry, dropReason);
+        }
+        it = mInboundQueue.erase(it);
+        traceInboundQueueLengthLocked();
     }
 }
 
@@ -1067,8 +1130,10 @@ sp<WindowInfoHandle> InputDispatcher::findTouchedWindowAtLocked(int32_t displayI
     if (addOutsideTargets && touchState == nullptr) {
         LOG_ALWAYS_FATAL("Must provide a valid touch state if adding outside targets");
     }
-    // Traverse windows from front to back to find touched window.
-    const auto& windowHandles = getWindowHandlesLocked(displayId);
+    const nsecs_t lookupStartTime = systemTime(SYSTEM_TIME_MONOTONIC);
+    sp<WindowInfoHandle> touchedWindowHandle;
+    // Traverse candidate windows from front to back to find the touched window.
+    const auto& windowHandles = getTouchCandidateWindowsLocked(displayId, x, y);
     for (const sp<WindowInfoHandle>& windowHandle : windowHandles) {
         if (ignoreDragWindow && haveSameToken(windowHandle, mDragState->dragWindow)) {
             continue;
@@ -1076,7 +1141,8 @@ sp<WindowInfoHandle> InputDispatcher::findTouchedWindowAtLocked(int32_t displayI
 
         const WindowInfo& info = *windowHandle->getInfo();
         if (!info.isSpy() && windowAcceptsTouchAt(info, displayId, x, y, isStylus)) {
-            return windowHandle;
+            touchedWindowHandle = windowHandle;
+            break;
         }
 
         if (addOutsideTargets &&
@@ -1085,14 +1151,18 @@ sp<WindowInfoHandle> InputDispatcher::findTouchedWindowAtLocked(int32_t displayI
                                           BitSet32(0));
         }
     }
-    return nullptr;
+    const nsecs_t lookupTime = systemTime(SYSTEM_TIME_MONOTONIC) - lookupStartTime;
+    mTouchHitTests += 1;
+    mTouchHitTestTotalTime += lookupTime;
+    mTouchHitTestMaxTime = std::max(mTouchHitTestMaxTime, lookupTime);
+    return touchedWindowHandle;
 }
 
 std::vector<sp<WindowInfoHandle>> InputDispatcher::findTouchedSpyWindowsAtLocked(
         int32_t displayId, int32_t x, int32_t y, bool isStylus) const {
-    // Traverse windows from front to back and gather the touched spy windows.
+    // Traverse candidate windows from front to back and gather the touched spy windows.
     std::vector<sp<WindowInfoHandle>> spyWindows;
-    const auto& windowHandles = getWindowHandlesLocked(displayId);
+    const auto& windowHandles = getTouchCandidateWindowsLocked(displayId, x, y);
     for (const sp<WindowInfoHandle>& windowHandle : windowHandles) {
         const WindowInfo& info = *windowHandle->getInfo();
 
@@ -2981,6 +3051,39 @@ void InputDispatcher::enqueueDispatchEntriesLocked(nsecs_t currentTime,
     }
 }
 
+/**
+ * Returns true if the unpublished MOVE at the tail of a connection's outbound queue may be
+ * replaced by the next MOVE of the same stream. Requires both to be plain, uninjected MOVE
+ * dispatches with identical flags, pointers and classification, so dropping the older one only
+ * costs the app an intermediate sample.
+ */
+static bool isCoalescibleMoveDispatch(const DispatchEntry& tail, const DispatchEntry& next) {
+    if (tail.resolvedAction != AMOTION_EVENT_ACTION_MOVE ||
+        next.resolvedAction != AMOTION_EVENT_ACTION_MOVE ||
+        tail.targetFlags != next.targetFlags || tail.resolvedFlags != next.resolvedFlags) {
+        return false;
+    }
+    if (tail.eventEntry->type != EventEntry::Type::MOTION ||
+        next.eventEntry->type != EventEntry::Type::MOTION || tail.eventEntry->isInjected() ||
+        next.eventEntry->isInjected()) {
+        return false;
+    }
+    const MotionEntry& tailMotion = static_cast<const MotionEntry&>(*tail.eventEntry);
+    const MotionEntry& nextMotion = static_cast<const MotionEntry&>(*next.eventEntry);
+    if (tailMotion.deviceId != nextMotion.deviceId || tailMotion.source != nextMotion.source ||
+        tailMotion.displayId != nextMotion.displayId ||
+        tailMotion.classification != nextMotion.classification ||
+        tailMotion.pointerCount != nextMotion.pointerCount) {
+        return false;
+    }
+    for (uint32_t i = 0; i < tailMotion.pointerCount; i++) {
+        if (tailMotion.pointerProperties[i] != nextMotion.pointerProperties[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void InputDispatcher::enqueueDispatchEntryLocked(const sp<Connection>& connection,
                                                  std::shared_ptr<EventEntry> eventEntry,
                                                  const InputTarget& inputTarget,
@@ -3122,8 +3225,21 @@ void InputDispatcher::enqueueDispatchEntryLocked(const sp<Connection>& connectio
         incrementPendingForegroundDispatches(newEntry);
     }
 
+    // If the connection is falling behind, coalesce this MOVE with the unpublished MOVE at the
+    // tail of the queue instead of growing the backlog further. The newest sample wins; losing
+    // intermediate samples is the graceful way to degrade for a consumer that is not keeping up
+    // with them anyway.
+    if (connection->outboundQueue.size() >= OUTBOUND_QUEUE_COALESCING_THRESHOLD &&
+        isCoalescibleMoveDispatch(*connection->outboundQueue.back(), *dispatchEntry)) {
+        DispatchEntry* coalesced = connection->outboundQueue.back();
+        connection->outboundQueue.pop_back();
+        releaseDispatchEntry(coalesced);
+        connection->outboundQueueStats.coalescedCount++;
+    }
+
     // Enqueue the dispatch entry.
     connection->outboundQueue.push_back(dispatchEntry.release());
+    connection->outboundQueueStats.recordEnqueue(connection->outboundQueue.size());
     traceOutboundQueueLength(*connection);
 }
 
@@ -3386,6 +3502,8 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
         connection->outboundQueue.erase(std::remove(connection->outboundQueue.begin(),
                                                     connection->outboundQueue.end(),
                                                     dispatchEntry));
+        connection->outboundQueueStats.recordPublish(currentTime -
+                                                     dispatchEntry->eventEntry->eventTime);
         traceOutboundQueueLength(*connection);
         connection->waitQueue.push_back(dispatchEntry);
         if (connection->responsive) {
@@ -3394,6 +3512,20 @@ void InputDispatcher::startDispatchCycleLocked(nsecs_t currentTime,
         }
         traceWaitQueueLength(*connection);
     }
+
+    if (connection->status == Connection::Status::NORMAL) {
+        // Flush any move events the publisher batched during this cycle in one syscall.
+        // On WOULD_BLOCK the publisher keeps them queued; the next cycle, triggered by the
+        // app's finished signals, will retry the flush before publishing anything else.
+        const status_t status = connection->inputPublisher.flushMotionEvents();
+        if (status != OK && status != WOULD_BLOCK) {
+            ALOGE("channel '%s' ~ Could not flush motion events due to an unexpected error, "
+                  "status=%s(%d)",
+                  connection->getInputChannelName().c_str(), statusToString(status).c_str(),
+                  status);
+            abortBrokenDispatchCycleLocked(currentTime, connection, true /*notify*/);
+        }
+    }
 }
 
 std::array<uint8_t, 32> InputDispatcher::sign(const VerifiedInputEvent& event) const {
@@ -4669,6 +4801,95 @@ void InputDispatcher::updateWindowHandlesForDisplayLocked(
 
     // Insert or replace
     mWindowHandlesByDisplay[displayId] = newHandles;
+
+    rebuildTouchWindowIndexLocked(displayId);
+}
+
+void InputDispatcher::rebuildTouchWindowIndexLocked(int32_t displayId) {
+    const std::vector<sp<WindowInfoHandle>>& windowHandles = getWindowHandlesLocked(displayId);
+    if (windowHandles.empty()) {
+        mTouchWindowIndexByDisplay.erase(displayId);
+        return;
+    }
+
+    TouchWindowIndex& index = mTouchWindowIndexByDisplay[displayId];
+    index = TouchWindowIndex();
+
+    // A window can only accept a touch inside the bounds of its touchable region, so the
+    // grid needs to cover the union of those bounds across the windows that can accept
+    // touches at all.
+    auto canAcceptTouch = [](const WindowInfo& info) {
+        if (info.inputConfig.test(WindowInfo::InputConfig::NOT_VISIBLE)) {
+            return false;
+        }
+        if (info.inputConfig.test(WindowInfo::InputConfig::NOT_TOUCHABLE) &&
+            !info.interceptsStylus()) {
+            return false;
+        }
+        return !info.touchableRegion.getBounds().isEmpty();
+    };
+
+    Region touchableArea;
+    for (const sp<WindowInfoHandle>& windowHandle : windowHandles) {
+        if (canAcceptTouch(*windowHandle->getInfo())) {
+            touchableArea.orSelf(windowHandle->getInfo()->touchableRegion.getBounds());
+        }
+    }
+    index.bounds = touchableArea.getBounds();
+    index.cellWidth = std::max(1, (index.bounds.getWidth() + TouchWindowIndex::kGridDim - 1) /
+                                          TouchWindowIndex::kGridDim);
+    index.cellHeight = std::max(1, (index.bounds.getHeight() + TouchWindowIndex::kGridDim - 1) /
+                                           TouchWindowIndex::kGridDim);
+
+    for (const sp<WindowInfoHandle>& windowHandle : windowHandles) {
+        const WindowInfo& info = *windowHandle->getInfo();
+        if (info.inputConfig.test(WindowInfo::InputConfig::WATCH_OUTSIDE_TOUCH)) {
+            // Windows watching outside touches must be visited for every touch, wherever
+            // it lands, to preserve ACTION_OUTSIDE delivery.
+            index.watchOutsideWindows.push_back(windowHandle);
+            for (auto& cell : index.cells) {
+                cell.push_back(windowHandle);
+            }
+            continue;
+        }
+        if (!canAcceptTouch(info)) {
+            continue;
+        }
+        Rect touchableBounds = info.touchableRegion.getBounds();
+        touchableBounds.intersect(index.bounds, &touchableBounds);
+        const int32_t colStart = (touchableBounds.left - index.bounds.left) / index.cellWidth;
+        const int32_t colEnd = (touchableBounds.right - 1 - index.bounds.left) / index.cellWidth;
+        const int32_t rowStart = (touchableBounds.top - index.bounds.top) / index.cellHeight;
+        const int32_t rowEnd = (touchableBounds.bottom - 1 - index.bounds.top) / index.cellHeight;
+        for (int32_t row = rowStart; row <= std::min(rowEnd, TouchWindowIndex::kGridDim - 1);
+             row++) {
+            for (int32_t col = colStart; col <= std::min(colEnd, TouchWindowIndex::kGridDim - 1);
+                 col++) {
+                index.cells[row * TouchWindowIndex::kGridDim + col].push_back(windowHandle);
+            }
+        }
+    }
+}
+
+const std::vector<sp<WindowInfoHandle>>& InputDispatcher::getTouchCandidateWindowsLocked(
+        int32_t displayId, int32_t x, int32_t y) const {
+    static const std::vector<sp<WindowInfoHandle>> EMPTY_WINDOW_HANDLES;
+    const auto it = mTouchWindowIndexByDisplay.find(displayId);
+    if (it == mTouchWindowIndexByDisplay.end()) {
+        return EMPTY_WINDOW_HANDLES;
+    }
+    const TouchWindowIndex& index = it->second;
+    if (x < index.bounds.left || x >= index.bounds.right || y < index.bounds.top ||
+        y >= index.bounds.bottom) {
+        // No window can accept a touch here; only the windows watching outside touches
+        // need to be visited.
+        return index.watchOutsideWindows;
+    }
+    const int32_t col = std::min((x - index.bounds.left) / index.cellWidth,
+                                 TouchWindowIndex::kGridDim - 1);
+    const int32_t row = std::min((y - index.bounds.top) / index.cellHeight,
+                                 TouchWindowIndex::kGridDim - 1);
+    return index.cells[row * TouchWindowIndex::kGridDim + col];
 }
 
 void InputDispatcher::setInputWindows(
@@ -4701,6 +4922,24 @@ void InputDispatcher::setInputWindowsLocked(
         ALOGD("setInputWindows displayId=%" PRId32 " %s", displayId, windowList.c_str());
     }
 
+    // SurfaceFlinger pushes the window lists of every display on each commit, and most commits
+    // leave a given display's windows untouched. If this update changes nothing, skip it instead
+    // of rebuilding the handle list and the derived focus and touch state.
+    const std::vector<sp<WindowInfoHandle>>& currentHandles = getWindowHandlesLocked(displayId);
+    if (windowInfoHandles.size() == currentHandles.size()) {
+        bool changed = false;
+        for (size_t i = 0; i < windowInfoHandles.size(); i++) {
+            if (windowInfoHandles[i]->getToken() != currentHandles[i]->getToken() ||
+                !(*windowInfoHandles[i]->getInfo() == *currentHandles[i]->getInfo())) {
+                changed = true;
+                break;
+            }
+        }
+        if (!changed) {
+            return;
+        }
+    }
+
     // Check preconditions for new input windows
     for (const sp<WindowInfoHandle>& window : windowInfoHandles) {
         const WindowInfo& info = *window->getInfo();
@@ -5342,6 +5581,10 @@ void InputDispatcher::dumpDispatchStateLocked(std::string& dump) {
         dump += INDENT "Displays: <none>\n";
     }
 
+    dump += StringPrintf(INDENT "TouchHitTests: count=%" PRIu64
+                                ", totalTime=%.3fms, maxTime=%.3fms\n",
+                         mTouchHitTests, mTouchHitTestTotalTime / 1e6, mTouchHitTestMaxTime / 1e6);
+
     if (!mGlobalMonitorsByDisplay.empty()) {
         for (const auto& [displayId, monitors] : mGlobalMonitorsByDisplay) {
             dump += StringPrintf(INDENT "Global monitors on display %d:\n", displayId);
@@ -5433,6 +5676,8 @@ void InputDispatcher::dumpDispatchStateLocked(std::string& dump) {
             } else {
                 dump += INDENT3 "WaitQueue: <empty>\n";
             }
+
+            dump += connection->outboundQueueStats.dump(INDENT3);
         }
     } else {
         dump += INDENT "Connections: <none>\n";
@@ -5445,6 +5690,10 @@ void InputDispatcher::dumpDispatchStateLocked(std::string& dump) {
         dump += INDENT "AppSwitch: not pending\n";
     }
 
+    dump += mAnrTracker.dump(INDENT);
+
+    dump += dumpEntryPools(INDENT);
+
     dump += INDENT "Configuration:\n";
     dump += StringPrintf(INDENT2 "KeyRepeatDelay: %" PRId64 "ms\n", ns2ms(mConfig.keyRepeatDelay));
     dump += StringPrintf(INDENT2 "KeyRepeatTimeout: %" PRId64 "ms\n",
@@ -48,6 +48,7 @@
 #include <utils/Looper.h>
 #include <utils/Timers.h>
 #include <utils/threads.h>
+#include <array>
 #include <condition_variable>
 #include <deque>
 #include <optional>
@@ -210,6 +211,12 @@ private:
 
     void dispatchOnceInnerLocked(nsecs_t* nextWakeupTime) REQUIRES(mLock);
 
+    // While the pending pointer event is blocked waiting on its target display, dispatch
+    // queued pointer events that target other displays so that one busy display does not
+    // stall input on the rest.
+    void dispatchOtherDisplaysWhileBlockedLocked(nsecs_t currentTime, nsecs_t* nextWakeupTime)
+            REQUIRES(mLock);
+
     // Enqueues an inbound event.  Returns true if mLooper->wake() should be called.
     bool enqueueInboundEventLocked(std::unique_ptr<EventEntry> entry) REQUIRES(mLock);
 
@@ -362,6 +369,33 @@ private:
             mWindowHandlesByDisplay GUARDED_BY(mLock);
     std::unordered_map<int32_t /*displayId*/, android::gui::DisplayInfo> mDisplayInfos
             GUARDED_BY(mLock);
+
+    // Spatial index that accelerates touch hit testing. The union of the display's touchable
+    // region bounds is covered by a fixed grid, and each cell lists the windows whose
+    // touchable bounds overlap that cell, front to back. Windows that watch outside touches
+    // are listed in every cell (and in the fallback list for points outside the grid) so
+    // they are always visited. The index is rebuilt whenever the window list changes.
+    struct TouchWindowIndex {
+        static constexpr int32_t kGridDim = 8;
+        Rect bounds = Rect::EMPTY_RECT;
+        int32_t cellWidth = 1;
+        int32_t cellHeight = 1;
+        std::array<std::vector<sp<android::gui::WindowInfoHandle>>, kGridDim * kGridDim> cells;
+        std::vector<sp<android::gui::WindowInfoHandle>> watchOutsideWindows;
+    };
+    std::unordered_map<int32_t /*displayId*/, TouchWindowIndex> mTouchWindowIndexByDisplay
+            GUARDED_BY(mLock);
+    void rebuildTouchWindowIndexLocked(int32_t displayId) REQUIRES(mLock);
+    // Returns the front-to-back ordered superset of the display's windows whose touchable
+    // region may contain the given point, plus the windows watching outside touches.
+    const std::vector<sp<android::gui::WindowInfoHandle>>& getTouchCandidateWindowsLocked(
+            int32_t displayId, int32_t x, int32_t y) const REQUIRES(mLock);
+
+    // Touch hit testing statistics for dumpsys.
+    uint64_t mTouchHitTests GUARDED_BY(mLock);
+    nsecs_t mTouchHitTestTotalTime GUARDED_BY(mLock);
+    nsecs_t mTouchHitTestMaxTime GUARDED_BY(mLock);
+
     void setInputWindowsLocked(
             const std::vector<sp<android::gui::WindowInfoHandle>>& inputWindowHandles,
             int32_t displayId) REQUIRES(mLock);
@@ -33,13 +33,9 @@ bool InputState::isNeutral() const {
 }
 
 bool InputState::isHovering(int32_t deviceId, uint32_t source, int32_t displayId) const {
-    for (const MotionMemento& memento : mMotionMementos) {
-        if (memento.deviceId == deviceId && memento.source == source &&
-            memento.displayId == displayId && memento.hovering) {
-            return true;
-        }
-    }
-    return false;
+    return mMotionMementoIndex.find(
+                   MotionMementoKey{deviceId, source, displayId, true /*hovering*/}) !=
+            mMotionMementoIndex.end();
 }
 
 bool InputState::trackKey(const KeyEntry& entry, int32_t action, int32_t flags) {
@@ -56,7 +52,7 @@ bool InputState::trackKey(const KeyEntry& entry, int32_t action, int32_t flags)
             }
             ssize_t index = findKeyMemento(entry);
             if (index >= 0) {
-                mKeyMementos.erase(mKeyMementos.begin() + index);
+                eraseKeyMementoAt(index);
                 return true;
             }
             /* FIXME: We can't just drop the key up event because that prevents creating
@@ -81,7 +77,7 @@ bool InputState::trackKey(const KeyEntry& entry, int32_t action, int32_t flags)
         case AKEY_EVENT_ACTION_DOWN: {
             ssize_t index = findKeyMemento(entry);
             if (index >= 0) {
-                mKeyMementos.erase(mKeyMementos.begin() + index);
+                eraseKeyMementoAt(index);
             }
             addKeyMemento(entry, flags);
             return true;
@@ -99,7 +95,7 @@ bool InputState::trackMotion(const MotionEntry& entry, int32_t action, int32_t f
         case AMOTION_EVENT_ACTION_CANCEL: {
             ssize_t index = findMotionMemento(entry, false /*hovering*/);
             if (index >= 0) {
-                mMotionMementos.erase(mMotionMementos.begin() + index);
+                eraseMotionMementoAt(index);
                 return true;
             }
             if (DEBUG_OUTBOUND_EVENT_DETAILS) {
@@ -113,7 +109,7 @@ bool InputState::trackMotion(const MotionEntry& entry, int32_t action, int32_t f
         case AMOTION_EVENT_ACTION_DOWN: {
             ssize_t index = findMotionMemento(entry, false /*hovering*/);
             if (index >= 0) {
-                mMotionMementos.erase(mMotionMementos.begin() + index);
+                eraseMotionMementoAt(index);
             }
             addMotionMemento(entry, flags, false /*hovering*/);
             return true;
@@ -139,7 +135,7 @@ bool InputState::trackMotion(const MotionEntry& entry, int32_t action, int32_t f
                 // movements).
                 if (index >= 0) {
                     if (entry.pointerCoords[0].isEmpty()) {
-                        mMotionMementos.erase(mMotionMementos.begin() + index);
+                        eraseMotionMementoAt(index);
                     } else {
                         MotionMemento& memento = mMotionMementos[index];
                         memento.setPointers(entry);
@@ -170,7 +166,7 @@ bool InputState::trackMotion(const MotionEntry& entry, int32_t action, int32_t f
         case AMOTION_EVENT_ACTION_HOVER_EXIT: {
             ssize_t index = findMotionMemento(entry, true /*hovering*/);
             if (index >= 0) {
-                mMotionMementos.erase(mMotionMementos.begin() + index);
+                eraseMotionMementoAt(index);
                 return true;
             }
             if (DEBUG_OUTBOUND_EVENT_DETAILS) {
@@ -185,7 +181,7 @@ bool InputState::trackMotion(const MotionEntry& entry, int32_t action, int32_t f
         case AMOTION_EVENT_ACTION_HOVER_MOVE: {
             ssize_t index = findMotionMemento(entry, true /*hovering*/);
             if (index >= 0) {
-                mMotionMementos.erase(mMotionMementos.begin() + index);
+                eraseMotionMementoAt(index);
             }
             addMotionMemento(entry, flags, true /*hovering*/);
             return true;
@@ -197,26 +193,15 @@ bool InputState::trackMotion(const MotionEntry& entry, int32_t action, int32_t f
 }
 
 ssize_t InputState::findKeyMemento(const KeyEntry& entry) const {
-    for (size_t i = 0; i < mKeyMementos.size(); i++) {
-        const KeyMemento& memento = mKeyMementos[i];
-        if (memento.deviceId == entry.deviceId && memento.source == entry.source &&
-            memento.displayId == entry.displayId && memento.keyCode == entry.keyCode &&
-            memento.scanCode == entry.scanCode) {
-            return i;
-        }
-    }
-    return -1;
+    auto it = mKeyMementoIndex.find(KeyMementoKey{entry.deviceId, entry.source, entry.displayId,
+                                                  entry.keyCode, entry.scanCode});
+    return it != mKeyMementoIndex.end() ? static_cast<ssize_t>(it->second) : -1;
 }
 
 ssize_t InputState::findMotionMemento(const MotionEntry& entry, bool hovering) const {
-    for (size_t i = 0; i < mMotionMementos.size(); i++) {
-        const MotionMemento& memento = mMotionMementos[i];
-        if (memento.deviceId == entry.deviceId && memento.source == entry.source &&
-            memento.displayId == entry.displayId && memento.hovering == hovering) {
-            return i;
-        }
-    }
-    return -1;
+    auto it = mMotionMementoIndex.find(
+            MotionMementoKey{entry.deviceId, entry.source, entry.displayId, hovering});
+    return it != mMotionMementoIndex.end() ? static_cast<ssize_t>(it->second) : -1;
 }
 
 void InputState::addKeyMemento(const KeyEntry& entry, int32_t flags) {
@@ -230,6 +215,9 @@ void InputState::addKeyMemento(const KeyEntry& entry, int32_t flags) {
     memento.flags = flags;
     memento.downTime = entry.downTime;
     memento.policyFlags = entry.policyFlags;
+    mKeyMementoIndex.emplace(KeyMementoKey{entry.deviceId, entry.source, entry.displayId,
+                                           entry.keyCode, entry.scanCode},
+                             mKeyMementos.size());
     mKeyMementos.push_back(memento);
 }
 
@@ -247,9 +235,39 @@ void InputState::addMotionMemento(const MotionEntry& entry, int32_t flags, bool
     memento.setPointers(entry);
     memento.hovering = hovering;
     memento.policyFlags = entry.policyFlags;
+    mMotionMementoIndex.emplace(MotionMementoKey{entry.deviceId, entry.source, entry.displayId,
+                                                 hovering},
+                                mMotionMementos.size());
     mMotionMementos.push_back(memento);
 }
 
+void InputState::eraseKeyMementoAt(size_t index) {
+    const KeyMemento& memento = mKeyMementos[index];
+    mKeyMementoIndex.erase(KeyMementoKey{memento.deviceId, memento.source, memento.displayId,
+                                         memento.keyCode, memento.scanCode});
+    mKeyMementos.erase(mKeyMementos.begin() + index);
+    // The mementos after the erased one shifted down by one position.
+    for (auto& [key, i] : mKeyMementoIndex) {
+        if (i > index) {
+            i--;
+        }
+    }
+}
+
+void InputState::eraseMotionMementoAt(size_t index) {
+    const MotionMemento& memento = mMotionMementos[index];
+    mMotionMementoIndex.erase(
+            MotionMementoKey{memento.deviceId, memento.source, memento.displayId,
+                             memento.hovering});
+    mMotionMementos.erase(mMotionMementos.begin() + index);
+    // The mementos after the erased one shifted down by one position.
+    for (auto& [key, i] : mMotionMementoIndex) {
+        if (i > index) {
+            i--;
+        }
+    }
+}
+
 void InputState::MotionMemento::setPointers(const MotionEntry& entry) {
     pointerCount = entry.pointerCount;
     for (uint32_t i = 0; i < entry.pointerCount; i++) {
@@ -362,6 +380,8 @@ std::vector<std::unique_ptr<EventEntry>> InputState::synthesizePointerDownEvents
 void InputState::clear() {
     mKeyMementos.clear();
     mMotionMementos.clear();
+    mKeyMementoIndex.clear();
+    mMotionMementoIndex.clear();
     mFallbackKeys.clear();
 }
 
@@ -371,6 +391,8 @@ void InputState::mergePointerStateTo(InputState& other) {
         // Since we support split pointers we need to merge touch events
         // from the same source + device + screen.
         if (memento.source & AINPUT_SOURCE_CLASS_POINTER) {
+            // This deliberately scans instead of using the index: the match here ignores the
+            // hovering flag, and this is only reached when a pointer stream is being split.
             bool merged = false;
             for (size_t j = 0; j < other.mMotionMementos.size(); j++) {
                 MotionMemento& otherMemento = other.mMotionMementos[j];
@@ -384,6 +406,10 @@ void InputState::mergePointerStateTo(InputState& other) {
             }
             if (!merged) {
                 memento.firstNewPointerIdx = 0;
+                other.mMotionMementoIndex.emplace(MotionMementoKey{memento.deviceId, memento.source,
+                                                                   memento.displayId,
+                                                                   memento.hovering},
+                                                  other.mMotionMementos.size());
                 other.mMotionMementos.push_back(memento);
             }
         }
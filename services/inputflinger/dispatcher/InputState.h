@@ -21,6 +21,7 @@
 #include "Entry.h"
 
 #include <utils/Timers.h>
+#include <unordered_map>
 
 namespace android::inputdispatcher {
 
@@ -111,10 +112,54 @@ private:
         void mergePointerStateTo(MotionMemento& other) const;
     };
 
+    // The fields of a KeyMemento that identify the key it tracks. Only one memento per key exists
+    // at a time: tracking a key down replaces any previous memento with the same key.
+    struct KeyMementoKey {
+        int32_t deviceId;
+        uint32_t source;
+        int32_t displayId;
+        int32_t keyCode;
+        int32_t scanCode;
+
+        bool operator==(const KeyMementoKey&) const = default;
+    };
+    struct KeyMementoKeyHash {
+        size_t operator()(const KeyMementoKey& key) const {
+            return std::hash<int32_t>()(key.deviceId) ^ (std::hash<uint32_t>()(key.source) << 1) ^
+                    (std::hash<int32_t>()(key.displayId) << 2) ^
+                    (std::hash<int32_t>()(key.keyCode) << 3) ^
+                    (std::hash<int32_t>()(key.scanCode) << 4);
+        }
+    };
+
+    // The fields of a MotionMemento that identify the event stream it tracks. Only one memento per
+    // stream exists at a time, for the same reason as above.
+    struct MotionMementoKey {
+        int32_t deviceId;
+        uint32_t source;
+        int32_t displayId;
+        bool hovering;
+
+        bool operator==(const MotionMementoKey&) const = default;
+    };
+    struct MotionMementoKeyHash {
+        size_t operator()(const MotionMementoKey& key) const {
+            return std::hash<int32_t>()(key.deviceId) ^ (std::hash<uint32_t>()(key.source) << 1) ^
+                    (std::hash<int32_t>()(key.displayId) << 2) ^
+                    (std::hash<bool>()(key.hovering) << 3);
+        }
+    };
+
     const IdGenerator& mIdGenerator; // InputDispatcher owns it so we won't have dangling reference.
 
+    // The mementos are kept in vectors because the order in which they were added determines the
+    // order of the synthesized cancelation events, and because the cancelation sweeps iterate all
+    // of them anyway. The maps below index the vectors by the fields that identify a memento, so
+    // that the per-event consistency checks don't have to scan them.
     std::vector<KeyMemento> mKeyMementos;
     std::vector<MotionMemento> mMotionMementos;
+    std::unordered_map<KeyMementoKey, size_t, KeyMementoKeyHash> mKeyMementoIndex;
+    std::unordered_map<MotionMementoKey, size_t, MotionMementoKeyHash> mMotionMementoIndex;
     KeyedVector<int32_t, int32_t> mFallbackKeys;
 
     ssize_t findKeyMemento(const KeyEntry& entry) const;
@@ -122,6 +167,8 @@ private:
 
     void addKeyMemento(const KeyEntry& entry, int32_t flags);
     void addMotionMemento(const MotionEntry& entry, int32_t flags, bool hovering);
+    void eraseKeyMementoAt(size_t index);
+    void eraseMotionMementoAt(size_t index);
 
     static bool shouldCancelKey(const KeyMemento& memento, const CancelationOptions& options);
     static bool shouldCancelMotion(const MotionMemento& memento, const CancelationOptions& options);
@@ -19,6 +19,8 @@
 
 #include <inttypes.h>
 
+#include <cmath>
+
 #include <android-base/stringprintf.h>
 #include <input/Input.h>
 #include <log/log.h>
@@ -95,6 +97,36 @@ private:
     std::vector<char> mBuffer;
 };
 
+void LatencyHistogram::add(nsecs_t value) {
+    size_t bucket = 0;
+    if (value > kFirstBucketUpperBoundNs) {
+        // Bucket i covers (kFirstBucketUpperBoundNs * kGamma^(i-1), kFirstBucketUpperBoundNs *
+        // kGamma^i]. Values beyond the last bucket's range are clamped into the last bucket.
+        const double position = std::ceil(std::log(static_cast<double>(value) /
+                                                   kFirstBucketUpperBoundNs) /
+                                          std::log(kGamma));
+        bucket = std::min(static_cast<size_t>(position), kNumBuckets - 1);
+    }
+    mBuckets[bucket]++;
+    mCount++;
+}
+
+nsecs_t LatencyHistogram::getPercentile(float percentile) const {
+    if (mCount == 0) {
+        return 0;
+    }
+    const uint64_t rank = std::max<uint64_t>(
+            1, static_cast<uint64_t>(std::ceil(percentile / 100 * mCount)));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kNumBuckets; i++) {
+        cumulative += mBuckets[i];
+        if (cumulative >= rank) {
+            return static_cast<nsecs_t>(kFirstBucketUpperBoundNs * std::pow(kGamma, i));
+        }
+    }
+    return static_cast<nsecs_t>(kFirstBucketUpperBoundNs * std::pow(kGamma, kNumBuckets - 1));
+}
+
 LatencyAggregator::LatencyAggregator() {
     AStatsManager_setPullAtomCallback(android::util::INPUT_EVENT_LATENCY_SKETCH, nullptr,
                                       LatencyAggregator::pullAtomCallback, this);
@@ -122,9 +154,23 @@ AStatsManager_PullAtomCallbackReturn LatencyAggregator::pullAtomCallback(int32_t
 
 void LatencyAggregator::processTimeline(const InputEventTimeline& timeline) {
     processStatistics(timeline);
+    processPercentiles(timeline);
     processSlowEvent(timeline);
 }
 
+void LatencyAggregator::processPercentiles(const InputEventTimeline& timeline) {
+    LatencyHistogram& histogram =
+            timeline.isDown ? mDownEndToEndHistogram : mMoveEndToEndHistogram;
+    for (const auto& [connectionToken, connectionTimeline] : timeline.connectionTimelines) {
+        if (!connectionTimeline.isComplete()) {
+            continue;
+        }
+        const nsecs_t presentTime =
+                connectionTimeline.graphicsTimeline[GraphicsTimeline::PRESENT_TIME];
+        histogram.add(presentTime - timeline.eventTime);
+    }
+}
+
 void LatencyAggregator::processStatistics(const InputEventTimeline& timeline) {
     // Before we do any processing, check that we have not yet exceeded MAX_SIZE
     if (mNumSketchEventsProcessed >= MAX_EVENTS_FOR_STATISTICS) {
@@ -271,7 +317,20 @@ std::string LatencyAggregator::dump(const char* prefix) {
                              prefix, i, numDown, downBytesKb, i, numMove, moveBytesKb);
     }
 
-    return StringPrintf("%sLatencyAggregator:\n", prefix) + sketchDump +
+    std::string histogramDump = StringPrintf("%s  End-to-end latency percentiles:\n", prefix);
+    for (const auto& [name, histogram] :
+         {std::make_pair("down", &mDownEndToEndHistogram),
+          std::make_pair("move", &mMoveEndToEndHistogram)}) {
+        histogramDump +=
+                StringPrintf("%s    %s: count = %" PRIu64
+                             ", p50 = %.1fms, p95 = %.1fms, p99 = %.1fms\n",
+                             prefix, name, histogram->getCount(),
+                             histogram->getPercentile(50) / 1E6,
+                             histogram->getPercentile(95) / 1E6,
+                             histogram->getPercentile(99) / 1E6);
+    }
+
+    return StringPrintf("%sLatencyAggregator:\n", prefix) + sketchDump + histogramDump +
             StringPrintf("%s  mNumSketchEventsProcessed=%zu\n", prefix, mNumSketchEventsProcessed) +
             StringPrintf("%s  mLastSlowEventTime=%" PRId64 "\n", prefix, mLastSlowEventTime) +
             StringPrintf("%s  mNumEventsSinceLastSlowEventReport = %zu\n", prefix,
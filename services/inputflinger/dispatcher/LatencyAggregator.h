@@ -17,6 +17,8 @@
 #ifndef _UI_INPUT_INPUTDISPATCHER_LATENCYAGGREGATOR_H
 #define _UI_INPUT_INPUTDISPATCHER_LATENCYAGGREGATOR_H
 
+#include <array>
+
 #include <kll.h>
 #include <statslog.h>
 #include <utils/Timers.h>
@@ -46,6 +48,35 @@ enum SketchIndex : size_t {
 // GraphicsTimeline::GPU_COMPLETED_TIME
 // GraphicsTimeline::PRESENT_TIME
 
+/**
+ * A histogram with logarithmically sized buckets, similar to a DDSketch. Each bucket covers a
+ * range that is 'kGamma' times larger than the previous one, which bounds the relative error of
+ * the percentile estimates. Unlike the KLL sketches, which can only be queried after they are
+ * serialized and shipped to the server, this histogram has a fixed footprint, never allocates
+ * after construction, and can answer percentile queries locally.
+ */
+class LatencyHistogram {
+public:
+    void add(nsecs_t value);
+    /**
+     * Return an estimate of the given percentile (in the range [0, 100]) of the added values.
+     * The returned value is the upper bound of the bucket that contains the requested percentile,
+     * so the estimate errs on the side of reporting higher latency. Returns 0 if no values have
+     * been added.
+     */
+    nsecs_t getPercentile(float percentile) const;
+    uint64_t getCount() const { return mCount; }
+
+private:
+    // With 128 buckets and a growth factor of 1.15, the histogram covers 0.01 ms .. ~0.5 hours,
+    // which is far wider than any latency we would realistically observe.
+    static constexpr size_t kNumBuckets = 128;
+    static constexpr nsecs_t kFirstBucketUpperBoundNs = 10000; // 0.01 ms
+    static constexpr double kGamma = 1.15;
+    std::array<uint64_t, kNumBuckets> mBuckets{};
+    uint64_t mCount = 0;
+};
+
 /**
  * Keep sketches of the provided events and report slow events
  */
@@ -83,6 +114,13 @@ private:
             mMoveSketches;
     // How many events have been processed so far
     size_t mNumSketchEventsProcessed = 0;
+
+    // ---------- Local percentile handling ----------
+    void processPercentiles(const InputEventTimeline& timeline);
+    // End-to-end latency histograms that can be queried locally (through dump()). They are not
+    // subject to MAX_EVENTS_FOR_STATISTICS and are never reset, unlike the sketches above.
+    LatencyHistogram mDownEndToEndHistogram;
+    LatencyHistogram mMoveEndToEndHistogram;
 };
 
 } // namespace android::inputdispatcher
@@ -45,55 +45,51 @@ static bool isMatureEvent(nsecs_t eventTime, nsecs_t now) {
     return age > ANR_TIMEOUT;
 }
 
-/**
- * A multimap allows to have several entries with the same key. This function just erases a specific
- * key-value pair. Equivalent to the imaginary std api std::multimap::erase(key, value).
- */
-template <typename K, typename V>
-static void eraseByValue(std::multimap<K, V>& map, const V& value) {
-    for (auto it = map.begin(); it != map.end();) {
-        if (it->second == value) {
-            it = map.erase(it);
-        } else {
-            it++;
-        }
-    }
-}
-
 LatencyTracker::LatencyTracker(InputEventTimelineProcessor* processor)
-      : mTimelineProcessor(processor) {
+      : mEventRing(RING_CAPACITY), mTimelineProcessor(processor) {
     LOG_ALWAYS_FATAL_IF(processor == nullptr);
+    mSlotsById.reserve(RING_CAPACITY);
 }
 
 void LatencyTracker::trackListener(int32_t inputEventId, bool isDown, nsecs_t eventTime,
                                    nsecs_t readTime) {
     reportAndPruneMatureRecords(eventTime);
-    const auto it = mTimelines.find(inputEventId);
-    if (it != mTimelines.end()) {
+    const auto it = mSlotsById.find(inputEventId);
+    if (it != mSlotsById.end()) {
         // Input event ids are randomly generated, so it's possible that two events have the same
         // event id. Drop this event, and also drop the existing event because the apps would
         // confuse us by reporting the rest of the timeline for one of them. This should happen
         // rarely, so we won't lose much data
-        mTimelines.erase(it);
-        eraseByValue(mEventTimes, inputEventId);
+        // The slot itself stays in the ring with a cleared timeline until pruning reaches it.
+        mEventRing[it->second].timeline.reset();
+        mSlotsById.erase(it);
         return;
     }
-    mTimelines.emplace(inputEventId, InputEventTimeline(isDown, eventTime, readTime));
-    mEventTimes.emplace(eventTime, inputEventId);
+    if (mRingSize == mEventRing.size()) {
+        // The ring filled up before the oldest event matured. Report the oldest event early to
+        // make room, rather than allocating more storage.
+        reportOldestRecord();
+    }
+    const size_t slot = (mRingHead + mRingSize) % mEventRing.size();
+    TrackedEvent& event = mEventRing[slot];
+    event.inputEventId = inputEventId;
+    event.timeline.emplace(isDown, eventTime, readTime);
+    mRingSize++;
+    mSlotsById.emplace(inputEventId, slot);
 }
 
 void LatencyTracker::trackFinishedEvent(int32_t inputEventId, const sp<IBinder>& connectionToken,
                                         nsecs_t deliveryTime, nsecs_t consumeTime,
                                         nsecs_t finishTime) {
-    const auto it = mTimelines.find(inputEventId);
-    if (it == mTimelines.end()) {
+    const auto it = mSlotsById.find(inputEventId);
+    if (it == mSlotsById.end()) {
         // This could happen if we erased this event when duplicate events were detected. It's
         // also possible that an app sent a bad (or late) 'Finish' signal, since it's free to do
         // anything in its process. Just drop the report and move on.
         return;
     }
 
-    InputEventTimeline& timeline = it->second;
+    InputEventTimeline& timeline = *mEventRing[it->second].timeline;
     const auto connectionIt = timeline.connectionTimelines.find(connectionToken);
     if (connectionIt == timeline.connectionTimelines.end()) {
         // Most likely case: app calls 'finishInputEvent' before it reports the graphics timeline
@@ -116,15 +112,15 @@ void LatencyTracker::trackFinishedEvent(int32_t inputEventId, const sp<IBinder>&
 void LatencyTracker::trackGraphicsLatency(
         int32_t inputEventId, const sp<IBinder>& connectionToken,
         std::array<nsecs_t, GraphicsTimeline::SIZE> graphicsTimeline) {
-    const auto it = mTimelines.find(inputEventId);
-    if (it == mTimelines.end()) {
+    const auto it = mSlotsById.find(inputEventId);
+    if (it == mSlotsById.end()) {
         // This could happen if we erased this event when duplicate events were detected. It's
         // also possible that an app sent a bad (or late) 'Timeline' signal, since it's free to do
         // anything in its process. Just drop the report and move on.
         return;
     }
 
-    InputEventTimeline& timeline = it->second;
+    InputEventTimeline& timeline = *mEventRing[it->second].timeline;
     const auto connectionIt = timeline.connectionTimelines.find(connectionToken);
     if (connectionIt == timeline.connectionTimelines.end()) {
         timeline.connectionTimelines.emplace(connectionToken, std::move(graphicsTimeline));
@@ -146,29 +142,53 @@ void LatencyTracker::trackGraphicsLatency(
  * 'trackListener' should happen soon after the event occurs.
  */
 void LatencyTracker::reportAndPruneMatureRecords(nsecs_t newEventTime) {
-    while (!mEventTimes.empty()) {
-        const auto& [oldestEventTime, oldestInputEventId] = *mEventTimes.begin();
-        if (isMatureEvent(oldestEventTime, newEventTime /*now*/)) {
-            // Report and drop this event
-            const auto it = mTimelines.find(oldestInputEventId);
-            LOG_ALWAYS_FATAL_IF(it == mTimelines.end(),
-                                "Event %" PRId32 " is in mEventTimes, but not in mTimelines",
-                                oldestInputEventId);
-            const InputEventTimeline& timeline = it->second;
-            mTimelineProcessor->processTimeline(timeline);
-            mTimelines.erase(it);
-            mEventTimes.erase(mEventTimes.begin());
-        } else {
+    while (mRingSize > 0) {
+        TrackedEvent& oldest = mEventRing[mRingHead];
+        if (!oldest.timeline.has_value()) {
+            // The slot was cleared when a duplicate event id was dropped. Just free it.
+            mRingHead = (mRingHead + 1) % mEventRing.size();
+            mRingSize--;
+            continue;
+        }
+        if (!isMatureEvent(oldest.timeline->eventTime, newEventTime /*now*/)) {
             // If the oldest event does not need to be pruned, no events should be pruned.
             return;
         }
+        // Report and drop this event
+        mTimelineProcessor->processTimeline(*oldest.timeline);
+        mSlotsById.erase(oldest.inputEventId);
+        oldest.timeline.reset();
+        mRingHead = (mRingHead + 1) % mEventRing.size();
+        mRingSize--;
+    }
+}
+
+void LatencyTracker::reportOldestRecord() {
+    while (mRingSize > 0) {
+        TrackedEvent& oldest = mEventRing[mRingHead];
+        const bool hadTimeline = oldest.timeline.has_value();
+        if (hadTimeline) {
+            mTimelineProcessor->processTimeline(*oldest.timeline);
+            mSlotsById.erase(oldest.inputEventId);
+            oldest.timeline.reset();
+            mNumEarlyReports++;
+        }
+        mRingHead = (mRingHead + 1) % mEventRing.size();
+        mRingSize--;
+        if (hadTimeline) {
+            return;
+        }
+        // The head slot only held the remains of a dropped duplicate; keep looking for an
+        // actual event to report.
     }
 }
 
 std::string LatencyTracker::dump(const char* prefix) {
     return StringPrintf("%sLatencyTracker:\n", prefix) +
-            StringPrintf("%s  mTimelines.size() = %zu\n", prefix, mTimelines.size()) +
-            StringPrintf("%s  mEventTimes.size() = %zu\n", prefix, mEventTimes.size());
+            StringPrintf("%s  mEventRing: size = %zu, capacity = %zu\n", prefix, mRingSize,
+                         mEventRing.size()) +
+            StringPrintf("%s  mSlotsById.size() = %zu\n", prefix, mSlotsById.size()) +
+            StringPrintf("%s  mNumEarlyReports = %zu\n", prefix, mNumEarlyReports);
 }
 
 } // namespace android::inputdispatcher
@@ -17,8 +17,9 @@
 #ifndef _UI_INPUT_INPUTDISPATCHER_LATENCYTRACKER_H
 #define _UI_INPUT_INPUTDISPATCHER_LATENCYTRACKER_H
 
-#include <map>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include <binder/IBinder.h>
 #include <input/Input.h>
@@ -58,26 +59,51 @@ public:
 
     std::string dump(const char* prefix);
 
+    /**
+     * The maximum number of events that can be tracked at the same time. If a new event arrives
+     * while the ring is full, the oldest tracked event is reported early to make room for it.
+     * At typical input rates, events mature (and are reported) long before the ring fills up.
+     */
+    static constexpr size_t RING_CAPACITY = 2048;
+
 private:
     /**
-     * A collection of InputEventTimelines keyed by inputEventId. An InputEventTimeline is first
-     * created when 'trackListener' is called.
+     * A single slot of the ring. When a duplicate inputEventId is encountered, the timeline of
+     * the slot that was already tracking that id is cleared, but the slot itself remains in the
+     * ring until the pruning logic reaches it.
+     */
+    struct TrackedEvent {
+        int32_t inputEventId = 0;
+        std::optional<InputEventTimeline> timeline;
+    };
+    /**
+     * The timelines of the events that are currently being tracked, in the order in which
+     * 'trackListener' was called. The storage is preallocated in the constructor and the slots are
+     * recycled in FIFO order, so that tracking an event does not allocate in steady state. The
+     * oldest event is at 'mRingHead' and the events are pruned from there once they mature.
+     * An InputEventTimeline is first created when 'trackListener' is called.
      * When either 'trackFinishedEvent' or 'trackGraphicsLatency' is called for this input event,
      * the corresponding InputEventTimeline will be updated for that token.
      */
-    std::unordered_map<int32_t /*inputEventId*/, InputEventTimeline> mTimelines;
+    std::vector<TrackedEvent> mEventRing;
+    size_t mRingHead = 0;
+    size_t mRingSize = 0;
     /**
-     * The collection of eventTimes will help us quickly find the events that we should prune
-     * from the 'mTimelines'. Since 'mTimelines' is keyed by inputEventId, it would be inefficient
-     * to walk through it directly to find the oldest input events to get rid of.
-     * There is a 1:1 mapping between 'mTimelines' and 'mEventTimes'.
-     * We are using 'multimap' instead of 'map' because there could be more than 1 event with the
-     * same eventTime.
+     * The number of events that had to be reported before they matured because the ring was full.
      */
-    std::multimap<nsecs_t /*eventTime*/, int32_t /*inputEventId*/> mEventTimes;
+    size_t mNumEarlyReports = 0;
+    /**
+     * Find the ring slot of an event by its inputEventId without scanning the ring.
+     * There is a 1:1 mapping between the occupied ring slots and the entries of this index.
+     */
+    std::unordered_map<int32_t /*inputEventId*/, size_t /*ring slot*/> mSlotsById;
 
     InputEventTimelineProcessor* mTimelineProcessor;
     void reportAndPruneMatureRecords(nsecs_t newEventTime);
+    /**
+     * Report the oldest tracked event even though it has not matured yet, and free its slot.
+     */
+    void reportOldestRecord();
 };
 
 } // namespace android::inputdispatcher
@@ -17,6 +17,7 @@
 #ifndef _UI_INPUT_LISTENER_H
 #define _UI_INPUT_LISTENER_H
 
+#include <variant>
 #include <vector>
 
 #include <input/Input.h>
@@ -288,7 +289,16 @@ public:
 
 private:
     InputListenerInterface& mInnerListener;
-    std::vector<std::unique_ptr<NotifyArgs>> mArgsQueue;
+
+    // The queued args are stored by value in a variant, so queueing copies them into the vector's
+    // existing storage, and flushing clears the vector without releasing it. Once the vector has
+    // grown to the size of the largest batch, a loop iteration's handoff to the inner listener
+    // makes no heap allocations at all.
+    using NotifyArgsVariant =
+            std::variant<NotifyConfigurationChangedArgs, NotifyKeyArgs, NotifyMotionArgs,
+                         NotifySwitchArgs, NotifySensorArgs, NotifyVibratorStateArgs,
+                         NotifyDeviceResetArgs, NotifyPointerCaptureChangedArgs>;
+    std::vector<NotifyArgsVariant> mArgsQueue;
 };
 
 } // namespace android
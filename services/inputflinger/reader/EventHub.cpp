@@ -50,6 +50,7 @@
 #include <utils/Log.h>
 #include <utils/Timers.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <regex>
 
@@ -473,8 +474,8 @@ void EventHub::Device::loadConfigurationLocked() {
     if (configurationFile.empty()) {
         ALOGD("No input device configuration file found for device '%s'.", identifier.name.c_str());
     } else {
-        android::base::Result<std::unique_ptr<PropertyMap>> propertyMap =
-                PropertyMap::load(configurationFile.c_str());
+        android::base::Result<std::shared_ptr<const PropertyMap>> propertyMap =
+                PropertyMap::loadShared(configurationFile.c_str());
         if (!propertyMap.ok()) {
             ALOGE("Error loading input device configuration file for device '%s'.  "
                   "Using default configuration.",
@@ -1780,6 +1781,7 @@ size_t EventHub::getEvents(int timeoutMillis, RawEvent* buffer, size_t bufferSiz
         } else {
             // Some events occurred.
             mPendingEventCount = size_t(pollResult);
+            sortPendingEventsByPriorityLocked();
         }
     }
 
@@ -1787,6 +1789,26 @@ size_t EventHub::getEvents(int timeoutMillis, RawEvent* buffer, size_t bufferSiz
     return event - buffer;
 }
 
+void EventHub::sortPendingEventsByPriorityLocked() {
+    // Kernel drivers buffer the unread events of each device in that device's own evdev queue, so
+    // nothing is lost by draining the ready fds in an order other than the one epoll reported.
+    // Process touch devices first, so that when the caller's buffer fills up mid-cycle, it is the
+    // chatty low-priority device that waits for the next iteration rather than the touchscreen.
+    std::stable_partition(mPendingEventItems, mPendingEventItems + mPendingEventCount,
+                          [this](const struct epoll_event& eventItem) REQUIRES(mLock) {
+                              if (eventItem.data.fd == mINotifyFd ||
+                                  eventItem.data.fd == mWakeReadPipeFd) {
+                                  // Control fds don't consume buffer space; keep them first so
+                                  // wakes and device notifications are never delayed.
+                                  return true;
+                              }
+                              const Device* device = getDeviceByFdLocked(eventItem.data.fd);
+                              return device != nullptr &&
+                                      device->classes.any(InputDeviceClass::TOUCH |
+                                                          InputDeviceClass::TOUCH_MT);
+                          });
+}
+
 std::vector<TouchVideoFrame> EventHub::getVideoFrames(int32_t deviceId) {
     std::scoped_lock _l(mLock);
 
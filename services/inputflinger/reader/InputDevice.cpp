@@ -358,7 +358,12 @@ void InputDevice::configure(nsecs_t when, const InputReaderConfiguration* config
         }
 
         for_each_mapper([this, when, config, changes](InputMapper& mapper) {
-            mapper.configure(when, config, changes);
+            // Skip mappers that declare the change irrelevant, so that a reconfiguration (like a
+            // pointer speed change) does not make every mapper of every device recompute state.
+            // The initial configuration (changes == 0) is always delivered.
+            if (!changes || (changes & mapper.getRelevantConfigurationChanges())) {
+                mapper.configure(when, config, changes);
+            }
             mSources |= mapper.getSources();
         });
 
@@ -573,7 +573,8 @@ private:
         BitArray<MSC_MAX> mscBitmask;
 
         std::string configurationFile;
-        std::unique_ptr<PropertyMap> configuration;
+        // May be shared with other devices that loaded the identical, unchanged file.
+        std::shared_ptr<const PropertyMap> configuration;
         std::unique_ptr<VirtualKeyMap> virtualKeyMap;
         KeyMap keyMap;
 
@@ -659,6 +660,14 @@ private:
      */
     Device* getDeviceByFdLocked(int fd) const REQUIRES(mLock);
 
+    /**
+     * Reorder the epoll events that are waiting to be processed so that the wake pipe, device
+     * notifications and touch devices come first. The events are processed (and the devices' fds
+     * are drained) in this order, so a burst from a chatty device such as a joystick cannot fill
+     * the caller's buffer before the touchscreen's events have been read.
+     */
+    void sortPendingEventsByPriorityLocked() REQUIRES(mLock);
+
     int32_t getNextControllerNumberLocked(const std::string& name) REQUIRES(mLock);
     void releaseControllerNumberLocked(int32_t num) REQUIRES(mLock);
     void reportDeviceAddedForStatisticsLocked(const InputDeviceIdentifier& identifier,
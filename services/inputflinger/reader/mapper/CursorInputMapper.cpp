@@ -122,6 +122,12 @@ void CursorInputMapper::dump(std::string& dump) {
     dump += StringPrintf(INDENT3 "DownTime: %" PRId64 "\n", mDownTime);
 }
 
+uint32_t CursorInputMapper::getRelevantConfigurationChanges() const {
+    return InputReaderConfiguration::CHANGE_POINTER_CAPTURE |
+            InputReaderConfiguration::CHANGE_POINTER_SPEED |
+            InputReaderConfiguration::CHANGE_DISPLAY_INFO;
+}
+
 void CursorInputMapper::configure(nsecs_t when, const InputReaderConfiguration* config,
                                   uint32_t changes) {
     InputMapper::configure(when, config, changes);
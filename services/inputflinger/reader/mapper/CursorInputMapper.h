@@ -59,6 +59,7 @@ public:
     virtual uint32_t getSources() const override;
     virtual void populateDeviceInfo(InputDeviceInfo* deviceInfo) override;
     virtual void dump(std::string& dump) override;
+    virtual uint32_t getRelevantConfigurationChanges() const override;
     virtual void configure(nsecs_t when, const InputReaderConfiguration* config,
                            uint32_t changes) override;
     virtual void reset(nsecs_t when) override;
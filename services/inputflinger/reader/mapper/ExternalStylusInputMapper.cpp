@@ -44,6 +44,11 @@ void ExternalStylusInputMapper::dump(std::string& dump) {
     dumpStylusState(dump, mStylusState);
 }
 
+uint32_t ExternalStylusInputMapper::getRelevantConfigurationChanges() const {
+    // The axis and button state only depend on the device itself.
+    return 0;
+}
+
 void ExternalStylusInputMapper::configure(nsecs_t when, const InputReaderConfiguration* config,
                                           uint32_t changes) {
     getAbsoluteAxisInfo(ABS_PRESSURE, &mRawPressureAxis);
@@ -54,6 +54,15 @@ public:
     virtual uint32_t getSources() const = 0;
     virtual void populateDeviceInfo(InputDeviceInfo* deviceInfo);
     virtual void dump(std::string& dump);
+    /**
+     * The configuration changes (a bitmask of InputReaderConfiguration::Change) that this
+     * mapper reacts to in configure(). The device skips the mapper when a reconfiguration
+     * does not intersect this set, so a mapper that overrides configure() should also
+     * override this to avoid being reconfigured for changes it ignores anyway.
+     * The initial configuration (changes == 0) is always delivered.
+     * By default, every change is considered relevant.
+     */
+    virtual uint32_t getRelevantConfigurationChanges() const { return ~0u; }
     virtual void configure(nsecs_t when, const InputReaderConfiguration* config, uint32_t changes);
     virtual void reset(nsecs_t when);
     virtual void process(const RawEvent* rawEvent) = 0;
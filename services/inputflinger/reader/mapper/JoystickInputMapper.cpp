@@ -103,6 +103,11 @@ void JoystickInputMapper::dump(std::string& dump) {
     }
 }
 
+uint32_t JoystickInputMapper::getRelevantConfigurationChanges() const {
+    // The axes only depend on the device itself and are collected on the first configuration.
+    return 0;
+}
+
 void JoystickInputMapper::configure(nsecs_t when, const InputReaderConfiguration* config,
                                     uint32_t changes) {
     InputMapper::configure(when, config, changes);
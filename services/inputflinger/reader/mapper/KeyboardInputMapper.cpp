@@ -144,6 +144,10 @@ std::optional<DisplayViewport> KeyboardInputMapper::findViewport(
     return std::nullopt;
 }
 
+uint32_t KeyboardInputMapper::getRelevantConfigurationChanges() const {
+    return InputReaderConfiguration::CHANGE_DISPLAY_INFO;
+}
+
 void KeyboardInputMapper::configure(nsecs_t when, const InputReaderConfiguration* config,
                                     uint32_t changes) {
     InputMapper::configure(when, config, changes);
@@ -60,6 +60,10 @@ void RotaryEncoderInputMapper::dump(std::string& dump) {
                          toString(mRotaryEncoderScrollAccumulator.haveRelativeVWheel()));
 }
 
+uint32_t RotaryEncoderInputMapper::getRelevantConfigurationChanges() const {
+    return InputReaderConfiguration::CHANGE_DISPLAY_INFO;
+}
+
 void RotaryEncoderInputMapper::configure(nsecs_t when, const InputReaderConfiguration* config,
                                          uint32_t changes) {
     InputMapper::configure(when, config, changes);
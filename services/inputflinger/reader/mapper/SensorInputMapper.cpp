@@ -122,6 +122,11 @@ void SensorInputMapper::dump(std::string& dump) {
     }
 }
 
+uint32_t SensorInputMapper::getRelevantConfigurationChanges() const {
+    // The axes only depend on the device itself and are collected on the first configuration.
+    return 0;
+}
+
 void SensorInputMapper::configure(nsecs_t when, const InputReaderConfiguration* config,
                                   uint32_t changes) {
     InputMapper::configure(when, config, changes);
@@ -31,6 +31,7 @@ public:
     uint32_t getSources() const override;
     void populateDeviceInfo(InputDeviceInfo* deviceInfo) override;
     void dump(std::string& dump) override;
+    uint32_t getRelevantConfigurationChanges() const override;
     void configure(nsecs_t when, const InputReaderConfiguration* config, uint32_t changes) override;
     void reset(nsecs_t when) override;
     void process(const RawEvent* rawEvent) override;
@@ -344,6 +344,17 @@ void TouchInputMapper::dump(std::string& dump) {
     }
 }
 
+uint32_t TouchInputMapper::getRelevantConfigurationChanges() const {
+    // This set must cover every config field that configure() snapshots into mConfig.
+    return InputReaderConfiguration::CHANGE_TOUCH_AFFINE_TRANSFORMATION |
+            InputReaderConfiguration::CHANGE_POINTER_SPEED |
+            InputReaderConfiguration::CHANGE_DISPLAY_INFO |
+            InputReaderConfiguration::CHANGE_POINTER_CAPTURE |
+            InputReaderConfiguration::CHANGE_POINTER_GESTURE_ENABLEMENT |
+            InputReaderConfiguration::CHANGE_SHOW_TOUCHES |
+            InputReaderConfiguration::CHANGE_EXTERNAL_STYLUS_PRESENCE;
+}
+
 void TouchInputMapper::configure(nsecs_t when, const InputReaderConfiguration* config,
                                  uint32_t changes) {
     InputMapper::configure(when, config, changes);
@@ -1404,11 +1415,40 @@ void TouchInputMapper::dumpAffineTransformation(std::string& dump) {
     dump += StringPrintf(INDENT4 "Y xmix: %0.3f\n", mAffineTransform.y_xmix);
     dump += StringPrintf(INDENT4 "Y scale: %0.3f\n", mAffineTransform.y_scale);
     dump += StringPrintf(INDENT4 "Y offset: %0.3f\n", mAffineTransform.y_offset);
+
+    dump += INDENT3 "Cooked Transform:\n";
+    dump += StringPrintf(INDENT4 "[%0.3f %0.3f %0.3f]\n", mCookedTransform.xx, mCookedTransform.xy,
+                         mCookedTransform.xc);
+    dump += StringPrintf(INDENT4 "[%0.3f %0.3f %0.3f]\n", mCookedTransform.yx, mCookedTransform.yy,
+                         mCookedTransform.yc);
 }
 
 void TouchInputMapper::updateAffineTransformation() {
     mAffineTransform = getPolicy()->getTouchAffineTransformation(getDeviceContext().getDescriptor(),
                                                                  mInputDeviceOrientation);
+    computeCookedTransform();
+}
+
+void TouchInputMapper::computeCookedTransform() {
+    // Fold the calibration affine, the raw-to-display scale and the display rotation into one
+    // affine transform. The coefficients are extracted by pushing the origin and the two basis
+    // vectors through the existing transform chain, so this stays consistent by construction if
+    // either step of the chain changes.
+    float cx = 0, cy = 0;
+    mAffineTransform.applyTo(cx, cy);
+    rotateAndScale(cx, cy);
+    float ux = 1, uy = 0;
+    mAffineTransform.applyTo(ux, uy);
+    rotateAndScale(ux, uy);
+    float vx = 0, vy = 1;
+    mAffineTransform.applyTo(vx, vy);
+    rotateAndScale(vx, vy);
+    mCookedTransform.xc = cx;
+    mCookedTransform.yc = cy;
+    mCookedTransform.xx = ux - cx;
+    mCookedTransform.yx = uy - cy;
+    mCookedTransform.xy = vx - cx;
+    mCookedTransform.yy = vy - cy;
 }
 
 void TouchInputMapper::reset(nsecs_t when) {
@@ -2290,11 +2330,11 @@ void TouchInputMapper::cookPointerData() {
                 break;
         }
 
-        // Adjust X,Y coords for device calibration
+        // Adjust X,Y coords for device calibration and display orientation, using the
+        // transform that was precompiled when the device was configured.
         // TODO: Adjust coverage coords?
         float xTransformed = in.x, yTransformed = in.y;
-        mAffineTransform.applyTo(xTransformed, yTransformed);
-        rotateAndScale(xTransformed, yTransformed);
+        mCookedTransform.applyTo(xTransformed, yTransformed);
 
         // Adjust X, Y, and coverage coords for input device orientation.
         float left, top, right, bottom;
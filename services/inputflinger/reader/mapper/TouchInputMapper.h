@@ -141,6 +141,7 @@ public:
     uint32_t getSources() const override;
     void populateDeviceInfo(InputDeviceInfo* deviceInfo) override;
     void dump(std::string& dump) override;
+    uint32_t getRelevantConfigurationChanges() const override;
     void configure(nsecs_t when, const InputReaderConfiguration* config, uint32_t changes) override;
     void reset(nsecs_t when) override;
     void process(const RawEvent* rawEvent) override;
@@ -463,6 +464,24 @@ private:
 
     float mDistanceScale;
 
+    // Transform from raw device coordinates to oriented display coordinates. The calibration
+    // affine, the per-axis raw-to-display scale and the display rotation are folded into a single
+    // affine step, so that cooking a pointer sample is a few multiply-adds instead of re-deriving
+    // the whole chain. Recomputed by computeCookedTransform() whenever any of the folded pieces
+    // changes.
+    struct CookedTransform {
+        float xx = 1, xy = 0, xc = 0;
+        float yx = 0, yy = 1, yc = 0;
+
+        inline void applyTo(float& x, float& y) const {
+            const float newX = xx * x + xy * y + xc;
+            const float newY = yx * x + yy * y + yc;
+            x = newX;
+            y = newY;
+        }
+    };
+    CookedTransform mCookedTransform;
+
     bool mHaveTilt;
     float mTiltXCenter;
     float mTiltXScale;
@@ -820,6 +839,7 @@ private:
 
     const char* modeToString(DeviceMode deviceMode);
     void rotateAndScale(float& x, float& y) const;
+    void computeCookedTransform();
 };
 
 } // namespace android
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../EntryPool.h"
+
+#include <gtest/gtest.h>
+
+namespace android {
+
+namespace inputdispatcher {
+
+// --- EntryPoolTest ---
+
+/**
+ * A released block satisfies the next allocation instead of going back to the heap.
+ */
+TEST(EntryPoolTest, ReleasedBlockIsReused) {
+    EntryPool pool("test", /*blockSize=*/64, /*maxFreeBlocks=*/4);
+
+    void* first = pool.alloc(64);
+    pool.dealloc(first, 64);
+    void* second = pool.alloc(64);
+
+    ASSERT_EQ(first, second);
+    pool.dealloc(second, 64);
+}
+
+/**
+ * Allocations smaller than the block size are served from the same freelist, because the pool
+ * always hands out full-sized blocks.
+ */
+TEST(EntryPoolTest, SmallerAllocationReusesFullSizedBlock) {
+    EntryPool pool("test", /*blockSize=*/64, /*maxFreeBlocks=*/4);
+
+    void* first = pool.alloc(64);
+    pool.dealloc(first, 64);
+    void* second = pool.alloc(32);
+
+    ASSERT_EQ(first, second);
+    pool.dealloc(second, 32);
+}
+
+/**
+ * Oversized allocations bypass the pool, but are still valid heap allocations.
+ */
+TEST(EntryPoolTest, OversizedAllocationFallsThrough) {
+    EntryPool pool("test", /*blockSize=*/64, /*maxFreeBlocks=*/4);
+
+    void* block = pool.alloc(128);
+    ASSERT_NE(block, nullptr);
+    pool.dealloc(block, 128);
+}
+
+/**
+ * The pool retains at most maxFreeBlocks released blocks.
+ */
+TEST(EntryPoolTest, FreelistIsBounded) {
+    EntryPool pool("test", /*blockSize=*/64, /*maxFreeBlocks=*/2);
+
+    void* blocks[4];
+    for (void*& block : blocks) {
+        block = pool.alloc(64);
+    }
+    for (void* block : blocks) {
+        pool.dealloc(block, 64);
+    }
+
+    // Only the first two released blocks were retained; the rest went back to the heap. The
+    // retained blocks are handed out in LIFO order.
+    ASSERT_EQ(blocks[1], pool.alloc(64));
+    ASSERT_EQ(blocks[0], pool.alloc(64));
+    pool.dealloc(blocks[0], 64);
+    pool.dealloc(blocks[1], 64);
+}
+
+/**
+ * The dump contains the pool's name and occupancy.
+ */
+TEST(EntryPoolTest, DumpContainsNameAndOccupancy) {
+    EntryPool pool("KeyEntry", /*blockSize=*/64, /*maxFreeBlocks=*/4);
+
+    void* block = pool.alloc(64);
+    const std::string dump = pool.dump("  ");
+    pool.dealloc(block, 64);
+
+    ASSERT_NE(dump.find("KeyEntry"), std::string::npos);
+    ASSERT_NE(dump.find("inUse=1"), std::string::npos);
+}
+
+} // namespace inputdispatcher
+
+} // namespace android
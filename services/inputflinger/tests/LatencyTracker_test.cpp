@@ -293,4 +293,19 @@ TEST_F(LatencyTrackerTest, EventsAreTracked_WhenTrackListenerIsCalledFirst) {
             InputEventTimeline{expected.isDown, expected.eventTime, expected.readTime});
 }
 
+/**
+ * If we try to track more events than the ring can hold, the oldest event should be reported
+ * early (before it matures) instead of growing the storage.
+ */
+TEST_F(LatencyTrackerTest, WhenRingIsFull_OldestEventIsReportedEarly) {
+    for (size_t i = 1; i <= LatencyTracker::RING_CAPACITY; i++) {
+        mTracker->trackListener(static_cast<int32_t>(i), false /*isDown*/, 2 /*eventTime*/,
+                                3 /*readTime*/);
+    }
+    // The ring is now full, so tracking one more event should report the oldest one to make room.
+    mTracker->trackListener(static_cast<int32_t>(LatencyTracker::RING_CAPACITY) + 1,
+                            false /*isDown*/, 2 /*eventTime*/, 3 /*readTime*/);
+    assertReceivedTimeline(InputEventTimeline{false, 2, 3});
+}
+
 } // namespace android::inputdispatcher
@@ -472,6 +472,23 @@ TEST_F(UnwantedInteractionBlockerTest, DownEventIsPassedToNextListener) {
     ASSERT_EQ(motionArgs, args);
 }
 
+/**
+ * In batched inference mode, events pass through to the next stage without waiting for the palm
+ * model to run.
+ */
+TEST_F(UnwantedInteractionBlockerTest, DownEventIsPassedToNextListenerWithBatchedInference) {
+    mBlocker = std::make_unique<UnwantedInteractionBlocker>(mTestListener,
+                                                            /*enablePalmRejection*/ true,
+                                                            /*enableBatchedInference*/ true);
+    mBlocker->notifyInputDevicesChanged({generateTestDeviceInfo()});
+    NotifyMotionArgs motionArgs =
+            generateMotionArgs(0 /*downTime*/, 0 /*eventTime*/, DOWN, {{1, 2, 3}});
+    mBlocker->notifyMotion(&motionArgs);
+    NotifyMotionArgs args;
+    ASSERT_NO_FATAL_FAILURE(mTestListener.assertNotifyMotionWasCalled(&args));
+    ASSERT_EQ(motionArgs, args);
+}
+
 /**
  * Create a basic switch event and send it to the UnwantedInteractionBlocker.
  * Expect that the event is received by the next input stage, unmodified.
@@ -1128,4 +1145,95 @@ TEST_F(PalmRejectorFakeFilterTest, CancelTwoPointers) {
     ASSERT_EQ(CANCEL, argsList[0].action);
 }
 
+class BatchedPalmRejectorFakeFilterTest : public testing::Test {
+protected:
+    std::unique_ptr<PalmRejector> mPalmRejector;
+
+    void SetUp() override {
+        std::unique_ptr<::ui::PalmDetectionFilter> filter =
+                std::make_unique<TestFilter>(&mSharedPalmState, /*byref*/ mSuppressedPointers);
+        mPalmRejector = std::make_unique<PalmRejector>(generatePalmFilterDeviceInfo(),
+                                                       std::move(filter),
+                                                       PalmProcessingMode::BATCHED);
+    }
+
+    void suppressPointerAtPosition(float x, float y) { mSuppressedPointers.push_back({x, y}); }
+
+    /**
+     * Run both halves of the batched pipeline back to back, the way the input thread and the
+     * inference thread behave when the inference thread keeps up with the event stream.
+     */
+    std::vector<NotifyMotionArgs> processBatched(const NotifyMotionArgs& args) {
+        std::vector<NotifyMotionArgs> argsList = mPalmRejector->applyDetectedSuppression(args);
+        mPalmRejector->detectPalmPointersAsync(args);
+        return argsList;
+    }
+
+private:
+    std::vector<std::pair<float, float>> mSuppressedPointers;
+    ::ui::SharedPalmDetectionFilterState mSharedPalmState; // unused, but we must retain ownership
+};
+
+/**
+ * In batched mode, the event on which the model detects the palm is passed through unmodified,
+ * and the suppression takes effect on the next event.
+ */
+TEST_F(BatchedPalmRejectorFakeFilterTest, SuppressionIsDelayedByOneEvent) {
+    std::vector<NotifyMotionArgs> argsList;
+    constexpr nsecs_t downTime = 0;
+
+    processBatched(generateMotionArgs(downTime, downTime, DOWN, {{1342.0, 613.0, 79.0}}));
+    processBatched(generateMotionArgs(downTime, /*eventTime*/ 1, POINTER_1_DOWN,
+                                      {{1417.0, 685.0, 41.0}, {1062.0, 697.0, 10.0}}));
+
+    // The model starts suppressing the second pointer, but the in-flight event still passes
+    // through in full.
+    suppressPointerAtPosition(1059, 731);
+    argsList = processBatched(generateMotionArgs(downTime, /*eventTime*/ 2, MOVE,
+                                                 {{1414.0, 702.0, 41.0}, {1059.0, 731.0, 12.0}}));
+    ASSERT_EQ(1u, argsList.size());
+    ASSERT_EQ(MOVE, argsList[0].action);
+    ASSERT_EQ(2u, argsList[0].pointerCount);
+
+    // The next event picks up the detection: pointer 1 is canceled, and only pointer 0 remains.
+    argsList = processBatched(generateMotionArgs(downTime, /*eventTime*/ 3, MOVE,
+                                                 {{1433.0, 751.0, 43.0}, {1072.0, 766.0, 13.0}}));
+    ASSERT_EQ(2u, argsList.size());
+    ASSERT_EQ(POINTER_1_UP, argsList[0].action);
+    ASSERT_EQ(FLAG_CANCELED, argsList[0].flags);
+    ASSERT_EQ(MOVE, argsList[1].action);
+    ASSERT_EQ(1u, argsList[1].pointerCount);
+    ASSERT_EQ(1433, argsList[1].pointerCoords[0].getX());
+    ASSERT_EQ(751, argsList[1].pointerCoords[0].getY());
+}
+
+/**
+ * A detection that the model produced for an earlier gesture must not cancel pointers of a new
+ * gesture that the model has not looked at yet.
+ */
+TEST_F(BatchedPalmRejectorFakeFilterTest, StaleDetectionsAreNotAppliedToANewGesture) {
+    std::vector<NotifyMotionArgs> argsList;
+    constexpr nsecs_t downTime = 0;
+
+    processBatched(generateMotionArgs(downTime, downTime, DOWN, {{1342.0, 613.0, 79.0}}));
+    suppressPointerAtPosition(1414, 702);
+    processBatched(generateMotionArgs(downTime, /*eventTime*/ 1, MOVE, {{1414.0, 702.0, 41.0}}));
+
+    // The suppression arrives on the next event. Since the only remaining pointer is being
+    // canceled, the entire gesture gets canceled.
+    argsList = processBatched(generateMotionArgs(downTime, /*eventTime*/ 2, UP,
+                                                 {{1414.0, 702.0, 41.0}}));
+    ASSERT_EQ(1u, argsList.size());
+    ASSERT_EQ(CANCEL, argsList[0].action);
+
+    // A new gesture starts at the suppressed position, but only the model's detections for the
+    // current gesture may be applied to it. The DOWN event passes through unmodified.
+    constexpr nsecs_t newDownTime = 10;
+    argsList = mPalmRejector->applyDetectedSuppression(
+            generateMotionArgs(newDownTime, newDownTime, DOWN, {{1414.0, 702.0, 41.0}}));
+    ASSERT_EQ(1u, argsList.size());
+    ASSERT_EQ(DOWN, argsList[0].action);
+    ASSERT_EQ(0, argsList[0].flags);
+}
+
 } // namespace android
@@ -61,15 +61,25 @@ void PowerHalController::init() {
 // Check validity of current handle to the power HAL service, and create a new
 // one if necessary.
 std::shared_ptr<HalWrapper> PowerHalController::initHal() {
+    // Fast path: this runs on every HAL access, including from the frame path,
+    // so an already-connected handle is snapshotted without taking the lock.
+    std::shared_ptr<HalWrapper> handle =
+            std::atomic_load_explicit(&mConnectedHal, std::memory_order_acquire);
+    if (handle != nullptr) {
+        return handle;
+    }
+
     std::lock_guard<std::mutex> lock(mConnectedHalMutex);
-    if (mConnectedHal == nullptr) {
-        mConnectedHal = mHalConnector->connect();
-        if (mConnectedHal == nullptr) {
+    handle = std::atomic_load_explicit(&mConnectedHal, std::memory_order_relaxed);
+    if (handle == nullptr) {
+        handle = mHalConnector->connect();
+        if (handle == nullptr) {
             // Unable to connect to Power HAL service. Fallback to default.
             return mDefaultHal;
         }
+        std::atomic_store_explicit(&mConnectedHal, handle, std::memory_order_release);
     }
-    return mConnectedHal;
+    return handle;
 }
 
 // Check if a call to Power HAL function failed; if so, log the failure and
@@ -80,7 +90,8 @@ HalResult<T> PowerHalController::processHalResult(HalResult<T> result, const cha
         ALOGE("%s failed: %s", fnName, result.errorMessage());
         std::lock_guard<std::mutex> lock(mConnectedHalMutex);
         // Drop Power HAL handle. This will force future api calls to reconnect.
-        mConnectedHal = nullptr;
+        std::atomic_store_explicit(&mConnectedHal, std::shared_ptr<HalWrapper>(nullptr),
+                                   std::memory_order_release);
         mHalConnector->reset();
     }
     return result;
@@ -143,6 +143,27 @@ static mat<TYPE, 3, 3> crossMatrix(const vec<TYPE, 3>& p, OTHER_TYPE diag) {
     return r;
 }
 
+template <typename TYPE>
+static mat<TYPE, 3, 3> crossMatrixSquared(const vec<TYPE, 3>& p) {
+    // Symbolic expansion of crossMatrix(p, 0)*crossMatrix(p, 0), using the
+    // identity [p]x^2 = p*transpose(p) - dot(p,p)*I33. Cheaper than the
+    // generic 3x3 product and exactly symmetric.
+    const TYPE xx = p.x*p.x;
+    const TYPE yy = p.y*p.y;
+    const TYPE zz = p.z*p.z;
+    mat<TYPE, 3, 3> r;
+    r[0][0] = -(yy + zz);
+    r[1][1] = -(xx + zz);
+    r[2][2] = -(xx + yy);
+    r[1][0] = p.x*p.y;
+    r[0][1] = p.x*p.y;
+    r[2][0] = p.x*p.z;
+    r[0][2] = p.x*p.z;
+    r[2][1] = p.y*p.z;
+    r[1][2] = p.y*p.z;
+    return r;
+}
+
 
 template<typename TYPE, size_t SIZE>
 class Covariance {
@@ -432,8 +453,10 @@ void Fusion::predict(const vec3_t& w, float dT) {
     const vec3_t b  = x1;
     vec3_t we = w - b;
 
-    if (length(we) < WVEC_EPS) {
+    float lwe = length(we);
+    if (lwe < WVEC_EPS) {
         we = (we[0]>0.f)?WVEC_EPS:-WVEC_EPS;
+        lwe = length(we);
     }
     // q(k+1) = O(we)*q(k)
     // --------------------
@@ -464,10 +487,10 @@ void Fusion::predict(const vec3_t& w, float dT) {
     const mat33_t I33(1);
     const mat33_t I33dT(dT);
     const mat33_t wx(crossMatrix(we, 0));
-    const mat33_t wx2(wx*wx);
-    const float lwedT = length(we)*dT;
+    const mat33_t wx2(crossMatrixSquared(we));
+    const float lwedT = lwe*dT;
     const float hlwedT = 0.5f*lwedT;
-    const float ilwe = 1.f/length(we);
+    const float ilwe = 1.f/lwe;
     const float k0 = (1-cosf(lwedT))*(ilwe*ilwe);
     const float k1 = sinf(lwedT);
     const float k2 = cosf(hlwedT);
@@ -487,7 +510,25 @@ void Fusion::predict(const vec3_t& w, float dT) {
     if (x0.w < 0)
         x0 = -x0;
 
-    P = Phi*P*transpose(Phi) + GQGt;
+    // P(k+1) = Phi*P*Phi' + GQGt, expanded by blocks. The bottom row of Phi
+    // is | 0 I33 |, so with P01 = transpose(P10):
+    //
+    //   P10(k+1) = Phi00*P10 + Phi10*P11
+    //   P00(k+1) = (Phi00*P00 + Phi10*P01)*Phi00' + P10(k+1)*Phi10'
+    //   P11(k+1) = P11
+    //
+    // This is 6 3x3 products instead of the 16 performed by the generic
+    // block product, and P11 only picks up the process noise.
+    const mat33_t& A(Phi[0][0]);
+    const mat33_t& B(Phi[1][0]);
+    const mat33_t P10(A*P[1][0] + B*P[1][1]);
+    const mat33_t P00((A*P[0][0] + B*P[0][1])*transpose(A) + P10*transpose(B));
+    // P00 is symmetric up to rounding; enforce it, like scaleCovariance()
+    // does, so checkState() only trips on real divergence.
+    P[0][0] = (P00 + transpose(P00))*0.5f + GQGt[0][0];
+    P[1][0] = P10 + GQGt[1][0];
+    P[0][1] = transpose(P[1][0]);
+    P[1][1] += GQGt[1][1];
 
     checkState();
 }
@@ -23,6 +23,8 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+
 namespace android {
 namespace SensorServiceUtil {
 
@@ -30,40 +32,89 @@ namespace {
     constexpr size_t LOG_SIZE = 10;
     constexpr size_t LOG_SIZE_MED = 30;  // debugging for slower sensors
     constexpr size_t LOG_SIZE_LARGE = 50;  // larger samples for debugging
+
+    // How often a reader retries a slot whose write is in progress. A write is just a struct
+    // copy, so a handful of retries is plenty.
+    constexpr int MAX_READ_ATTEMPTS = 5;
 }// unnamed namespace
 
 RecentEventLogger::RecentEventLogger(int sensorType) :
         mSensorType(sensorType), mEventSize(eventSizeBySensorType(mSensorType)),
-        mRecentEvents(logSizeBySensorType(sensorType)), mMaskData(false),
-        mIsLastEventCurrent(false) {
+        mSlots(logSizeBySensorType(sensorType)), mMaskData(false) {
     // blank
 }
 
 void RecentEventLogger::addEvent(const sensors_event_t& event) {
-    std::lock_guard<std::mutex> lk(mLock);
-    mRecentEvents.emplace(event);
-    mIsLastEventCurrent = true;
+    // Only the sensor event thread writes the ring, so plain reads of mEventCount and the
+    // slot sequence are safe here; the fences publish the slot contents to readers.
+    const uint64_t count = mEventCount.load(std::memory_order_relaxed);
+    Slot& slot = mSlots[count % mSlots.size()];
+    const uint32_t seq = slot.mSeq.load(std::memory_order_relaxed);
+
+    slot.mSeq.store(seq + 1, std::memory_order_relaxed);  // odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.mLog = SensorEventLog(event);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.mSeq.store(seq + 2, std::memory_order_relaxed);
+
+    mEventCount.store(count + 1, std::memory_order_release);
+    mIsLastEventCurrent.store(true, std::memory_order_release);
 }
 
 bool RecentEventLogger::isEmpty() const {
-    return mRecentEvents.size() == 0;
+    return mEventCount.load(std::memory_order_acquire) == 0;
 }
 
 void RecentEventLogger::setLastEventStale() {
-    std::lock_guard<std::mutex> lk(mLock);
-    mIsLastEventCurrent = false;
+    mIsLastEventCurrent.store(false, std::memory_order_release);
+}
+
+bool RecentEventLogger::readSlot(size_t slotIndex, SensorEventLog* out) const {
+    const Slot& slot = mSlots[slotIndex];
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        const uint32_t seqBegin = slot.mSeq.load(std::memory_order_acquire);
+        if (seqBegin == 0) {
+            return false;  // never written
+        }
+        if (seqBegin & 1) {
+            continue;  // write in progress
+        }
+        *out = slot.mLog;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.mSeq.load(std::memory_order_relaxed) == seqBegin) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<RecentEventLogger::SensorEventLog> RecentEventLogger::getSnapshot() const {
+    std::vector<SensorEventLog> snapshot;
+    const uint64_t count = mEventCount.load(std::memory_order_acquire);
+    const size_t n = std::min<uint64_t>(count, mSlots.size());
+    snapshot.reserve(n);
+    // Most recent event first, like indexing into the ring. If the writer overruns us it is
+    // overwriting the oldest slots, so everything older than a torn slot is gone as well.
+    for (size_t i = 0; i < n; ++i) {
+        SensorEventLog log;
+        if (!readSlot(size_t((count - 1 - i) % mSlots.size()), &log)) {
+            break;
+        }
+        snapshot.push_back(log);
+    }
+    return snapshot;
 }
 
 std::string RecentEventLogger::dump() const {
-    std::lock_guard<std::mutex> lk(mLock);
+    const std::vector<SensorEventLog> recentEvents = getSnapshot();
 
     //TODO: replace String8 with std::string completely in this function
     String8 buffer;
 
-    buffer.appendFormat("last %zu events\n", mRecentEvents.size());
+    buffer.appendFormat("last %zu events\n", recentEvents.size());
     int j = 0;
-    for (int i = mRecentEvents.size() - 1; i >= 0; --i) {
-        const auto& ev = mRecentEvents[i];
+    for (int i = recentEvents.size() - 1; i >= 0; --i) {
+        const auto& ev = recentEvents[i];
         struct tm * timeinfo = localtime(&(ev.mWallTime.tv_sec));
         buffer.appendFormat("\t%2d (ts=%.9f, wall=%02d:%02d:%02d.%03d) ",
                 ++j, ev.mEvent.timestamp/1e9, timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec,
@@ -95,11 +146,11 @@ std::string RecentEventLogger::dump() const {
  */
 void RecentEventLogger::dump(util::ProtoOutputStream* proto) const {
     using namespace service::SensorEventsProto;
-    std::lock_guard<std::mutex> lk(mLock);
+    const std::vector<SensorEventLog> recentEvents = getSnapshot();
 
-    proto->write(RecentEventsLog::RECENT_EVENTS_COUNT, int(mRecentEvents.size()));
-    for (int i = mRecentEvents.size() - 1; i >= 0; --i) {
-        const auto& ev = mRecentEvents[i];
+    proto->write(RecentEventsLog::RECENT_EVENTS_COUNT, int(recentEvents.size()));
+    for (int i = recentEvents.size() - 1; i >= 0; --i) {
+        const auto& ev = recentEvents[i];
         const uint64_t token = proto->start(RecentEventsLog::EVENTS);
         proto->write(Event::TIMESTAMP_SEC, float(ev.mEvent.timestamp) / 1e9f);
         proto->write(Event::WALL_TIMESTAMP_MS, ev.mWallTime.tv_sec * 1000LL
@@ -129,15 +180,19 @@ void RecentEventLogger::setFormat(std::string format) {
 }
 
 bool RecentEventLogger::populateLastEventIfCurrent(sensors_event_t *event) const {
-    std::lock_guard<std::mutex> lk(mLock);
-
-    if (mIsLastEventCurrent && mRecentEvents.size()) {
-        // Index 0 contains the latest event emplace()'ed
-        *event = mRecentEvents[0].mEvent;
-        return true;
-    } else {
+    if (!mIsLastEventCurrent.load(std::memory_order_acquire)) {
+        return false;
+    }
+    const uint64_t count = mEventCount.load(std::memory_order_acquire);
+    if (count == 0) {
+        return false;
+    }
+    SensorEventLog log;
+    if (!readSlot(size_t((count - 1) % mSlots.size()), &log)) {
         return false;
     }
+    *event = log.mEvent;
+    return true;
 }
 
 
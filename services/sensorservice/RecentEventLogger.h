@@ -17,13 +17,13 @@
 #ifndef ANDROID_SENSOR_SERVICE_UTIL_RECENT_EVENT_LOGGER_H
 #define ANDROID_SENSOR_SERVICE_UTIL_RECENT_EVENT_LOGGER_H
 
-#include "RingBuffer.h"
 #include "SensorServiceUtils.h"
 
 #include <hardware/sensors.h>
 #include <utils/String8.h>
 
-#include <mutex>
+#include <atomic>
+#include <vector>
 
 namespace android {
 namespace SensorServiceUtil {
@@ -33,6 +33,11 @@ namespace SensorServiceUtil {
 // generated from the sensor are stored in this buffer.  The buffer is NOT cleared when the sensor
 // unregisters and as a result very old data in the dumpsys output can be seen, which is an intended
 // behavior.
+//
+// The ring is written lock-free: addEvent() is only called from the sensor event thread and guards
+// each slot with a sequence counter (odd while a write is in progress), so recording an event for
+// debugging costs no mutex on the hot path. Readers snapshot slots and retry or give up on the
+// rare slot that is being overwritten while they read it.
 class RecentEventLogger : public Dumpable {
 public:
     explicit RecentEventLogger(int sensorType);
@@ -53,19 +58,36 @@ public:
 
 protected:
     struct SensorEventLog {
+        SensorEventLog() = default;
         explicit SensorEventLog(const sensors_event_t& e);
         timespec mWallTime;
         sensors_event_t mEvent;
     };
 
+    struct Slot {
+        // Sequence counter for the slot: zero means never written, odd means a write is in
+        // progress, and any other even value means mLog is stable.
+        std::atomic<uint32_t> mSeq{0};
+        SensorEventLog mLog;
+    };
+
+    // Copy the event stored in the given slot. Returns false if the slot has never been written
+    // or the writer kept racing with us.
+    bool readSlot(size_t slotIndex, SensorEventLog* out) const;
+
+    // Copy the recorded events, most recent first, like indexing into the ring.
+    std::vector<SensorEventLog> getSnapshot() const;
+
     const int mSensorType;
     const size_t mEventSize;
 
-    mutable std::mutex mLock;
-    RingBuffer<SensorEventLog> mRecentEvents;
+    // The ring itself. mEventCount is the total number of events ever recorded; the writer owns
+    // it and stores the next event in slot mEventCount % mSlots.size().
+    std::vector<Slot> mSlots;
+    std::atomic<uint64_t> mEventCount{0};
 
     bool mMaskData;
-    bool mIsLastEventCurrent;
+    std::atomic<bool> mIsLastEventCurrent{false};
 
 private:
     static size_t logSizeBySensorType(int sensorType);
@@ -75,4 +97,3 @@ private:
 } // namespace android;
 
 #endif // ANDROID_SENSOR_SERVICE_UTIL_RECENT_EVENT_LOGGER_H
-
@@ -139,18 +139,8 @@ status_t SensorService::SensorDirectConnection::flush() {
     return INVALID_OPERATION;
 }
 
-int32_t SensorService::SensorDirectConnection::configureChannel(int handle, int rateLevel) {
-
-    if (handle == -1 && rateLevel == SENSOR_DIRECT_RATE_STOP) {
-        stopAll();
-        mMicRateBackup.clear();
-        return NO_ERROR;
-    }
-
-    if (!hasSensorAccess()) {
-        return PERMISSION_DENIED;
-    }
-
+status_t SensorService::SensorDirectConnection::validateSensorRateRequest(
+        int handle, int* rateLevel, bool* inCappedSet) {
     sp<SensorInterface> si = mService->getSensorInterfaceFromHandle(handle);
     if (si == nullptr) {
         return NAME_NOT_FOUND;
@@ -162,18 +152,39 @@ int32_t SensorService::SensorDirectConnection::configureChannel(int handle, int
     }
 
     if (s.getHighestDirectReportRateLevel() == 0
-            || rateLevel > s.getHighestDirectReportRateLevel()
+            || *rateLevel > s.getHighestDirectReportRateLevel()
             || !s.isDirectChannelTypeSupported(mMem.type)) {
         return INVALID_OPERATION;
     }
 
-    int requestedRateLevel = rateLevel;
-    if (mService->isSensorInCappedSet(s.getType()) && rateLevel != SENSOR_DIRECT_RATE_STOP) {
-        status_t err = mService->adjustRateLevelBasedOnMicAndPermission(&rateLevel, mOpPackageName);
+    *inCappedSet = mService->isSensorInCappedSet(s.getType());
+    if (*inCappedSet && *rateLevel != SENSOR_DIRECT_RATE_STOP) {
+        status_t err = mService->adjustRateLevelBasedOnMicAndPermission(rateLevel, mOpPackageName);
         if (err != OK) {
             return err;
         }
     }
+    return NO_ERROR;
+}
+
+int32_t SensorService::SensorDirectConnection::configureChannel(int handle, int rateLevel) {
+
+    if (handle == -1 && rateLevel == SENSOR_DIRECT_RATE_STOP) {
+        stopAll();
+        mMicRateBackup.clear();
+        return NO_ERROR;
+    }
+
+    if (!hasSensorAccess()) {
+        return PERMISSION_DENIED;
+    }
+
+    int requestedRateLevel = rateLevel;
+    bool inCappedSet = false;
+    status_t err = validateSensorRateRequest(handle, &rateLevel, &inCappedSet);
+    if (err != NO_ERROR) {
+        return err;
+    }
 
     struct sensors_direct_cfg_t config = {
         .rate_level = rateLevel
@@ -193,7 +204,7 @@ int32_t SensorService::SensorDirectConnection::configureChannel(int handle, int
     } else {
         if (ret > 0) {
             mActivated[handle] = rateLevel;
-            if (mService->isSensorInCappedSet(s.getType())) {
+            if (inCappedSet) {
                 // Back up the rates that the app is allowed to have if the mic toggle is off
                 // This is used in the uncapRates() function.
                 if ((requestedRateLevel <= SENSOR_SERVICE_CAPPED_SAMPLING_RATE_LEVEL) ||
@@ -209,6 +220,108 @@ int32_t SensorService::SensorDirectConnection::configureChannel(int handle, int
     return ret;
 }
 
+status_t SensorService::SensorDirectConnection::configureChannels(
+        const std::vector<std::pair<int32_t, int32_t>>& rateLevels, std::vector<int32_t>* tokens) {
+    if (rateLevels.empty() || tokens == nullptr) {
+        return BAD_VALUE;
+    }
+    tokens->clear();
+
+    if (!hasSensorAccess()) {
+        return PERMISSION_DENIED;
+    }
+
+    // Validate every request before touching the HAL so that a bad entry
+    // cannot leave the channel half-configured.
+    struct PreparedConfig {
+        int handle;
+        int rateLevel;          // rate to send to the HAL, possibly capped
+        int requestedRateLevel; // rate as requested by the app
+        bool inCappedSet;
+    };
+    std::vector<PreparedConfig> prepared;
+    prepared.reserve(rateLevels.size());
+    for (const auto& [handle, requestedRateLevel] : rateLevels) {
+        int rateLevel = requestedRateLevel;
+        bool inCappedSet = false;
+        status_t err = validateSensorRateRequest(handle, &rateLevel, &inCappedSet);
+        if (err != NO_ERROR) {
+            return err;
+        }
+        prepared.push_back({handle, rateLevel, requestedRateLevel, inCappedSet});
+    }
+
+    Mutex::Autolock _l(mConnectionLock);
+    SensorDevice& dev(SensorDevice::getInstance());
+
+    // Apply the whole batch back to back while holding the connection lock, so
+    // a session setup touching several sensors pays for one validation pass
+    // and one lock acquisition instead of one binder round trip per sensor.
+    const std::unordered_map<int, int> previousActivated = mActivated;
+    const std::unordered_map<int, int> previousMicRateBackup = mMicRateBackup;
+    std::vector<std::pair<int, int>> applied; // handle and its pre-batch rate
+    status_t err = NO_ERROR;
+    for (const auto& cfg : prepared) {
+        struct sensors_direct_cfg_t config = {
+            .rate_level = cfg.rateLevel
+        };
+        int ret = dev.configureDirectChannel(cfg.handle, getHalChannelHandle(), &config);
+        const bool success =
+                (cfg.rateLevel == SENSOR_DIRECT_RATE_STOP) ? (ret == NO_ERROR) : (ret > 0);
+        if (!success) {
+            err = (ret < 0) ? ret : UNKNOWN_ERROR;
+            break;
+        }
+
+        auto it = previousActivated.find(cfg.handle);
+        applied.emplace_back(cfg.handle,
+                             (it != previousActivated.end()) ? it->second
+                                                             : SENSOR_DIRECT_RATE_STOP);
+        if (cfg.rateLevel == SENSOR_DIRECT_RATE_STOP) {
+            mActivated.erase(cfg.handle);
+            mMicRateBackup.erase(cfg.handle);
+            tokens->push_back(NO_ERROR);
+        } else {
+            mActivated[cfg.handle] = cfg.rateLevel;
+            if (cfg.inCappedSet) {
+                // Back up the rates that the app is allowed to have if the mic toggle is off
+                // This is used in the uncapRates() function.
+                if ((cfg.requestedRateLevel <= SENSOR_SERVICE_CAPPED_SAMPLING_RATE_LEVEL) ||
+                    !isRateCappedBasedOnPermission()) {
+                    mMicRateBackup[cfg.handle] = cfg.requestedRateLevel;
+                } else {
+                    mMicRateBackup[cfg.handle] = SENSOR_SERVICE_CAPPED_SAMPLING_RATE_LEVEL;
+                }
+            }
+            tokens->push_back(ret);
+        }
+    }
+
+    if (err != NO_ERROR) {
+        // All-or-nothing: restore the sensors already touched by this batch to
+        // their pre-batch rates.
+        const struct sensors_direct_cfg_t stopConfig = {
+            .rate_level = SENSOR_DIRECT_RATE_STOP
+        };
+        for (const auto& [handle, previousRate] : applied) {
+            // Stopping before reconfiguring is the well-tested path in CTS
+            dev.configureDirectChannel(handle, getHalChannelHandle(), &stopConfig);
+            if (previousRate != SENSOR_DIRECT_RATE_STOP) {
+                const struct sensors_direct_cfg_t config = {
+                    .rate_level = previousRate
+                };
+                dev.configureDirectChannel(handle, getHalChannelHandle(), &config);
+            }
+        }
+        mActivated = previousActivated;
+        mMicRateBackup = previousMicRateBackup;
+        tokens->clear();
+        return err;
+    }
+
+    return NO_ERROR;
+}
+
 void SensorService::SensorDirectConnection::capRates() {
     Mutex::Autolock _l(mConnectionLock);
     const struct sensors_direct_cfg_t capConfig = {
@@ -20,6 +20,8 @@
 #include <optional>
 #include <stdint.h>
 #include <sys/types.h>
+#include <utility>
+#include <vector>
 
 #include <binder/BinderService.h>
 
@@ -64,10 +66,18 @@ protected:
     virtual status_t setEventRate(int handle, nsecs_t samplingPeriodNs);
     virtual status_t flush();
     virtual int32_t configureChannel(int handle, int rateLevel);
+    virtual status_t configureChannels(const std::vector<std::pair<int32_t, int32_t>>& rateLevels,
+                                       std::vector<int32_t>* tokens);
     virtual void destroy();
 private:
     bool hasSensorAccess() const;
 
+    // Checks that this connection may use the sensor at the requested rate and
+    // applies the mic-toggle rate cap; on success rateLevel holds the rate to
+    // send to the HAL and inCappedSet tells whether the sensor is subject to
+    // the cap.
+    status_t validateSensorRateRequest(int handle, int* rateLevel, bool* inCappedSet);
+
     // Stops all active sensor direct report requests.
     //
     // If backupRecord is true, stopped requests can be recovered
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <inttypes.h>
 #include <log/log.h>
 #include <sys/socket.h>
 #include <utils/threads.h>
@@ -94,12 +95,14 @@ void SensorService::SensorEventConnection::dump(String8& result) {
             mMaxCacheSize);
     for (auto& it : mSensorInfo) {
         const FlushInfo& flushInfo = it.second;
-        result.appendFormat("\t %s 0x%08x | status: %s | pending flush events %d \n",
+        result.appendFormat("\t %s 0x%08x | status: %s | pending flush events %d | "
+                            "sampling period %" PRId64 "ns \n",
                             mService->getSensorName(it.first).string(),
                             it.first,
                             flushInfo.mFirstFlushPending ? "First flush pending" :
                                                            "active",
-                            flushInfo.mPendingFlushEventsToSend);
+                            flushInfo.mPendingFlushEventsToSend,
+                            flushInfo.mSamplingPeriodNs);
     }
 #if DEBUG_CONNECTIONS
     result.appendFormat("\t events recvd: %d | sent %d | cache %d | dropped %d |"
@@ -223,6 +226,16 @@ void SensorService::SensorEventConnection::setFirstFlushPending(int32_t handle,
     }
 }
 
+void SensorService::SensorEventConnection::setSamplingPeriod(int32_t handle,
+                                nsecs_t samplingPeriodNs) {
+    Mutex::Autolock _l(mConnectionLock);
+    auto it = mSensorInfo.find(handle);
+    if (it != mSensorInfo.end()) {
+        it->second.mSamplingPeriodNs = samplingPeriodNs;
+        it->second.mLastDeliveredTimestampNs = 0;
+    }
+}
+
 void SensorService::SensorEventConnection::updateLooperRegistration(const sp<Looper>& looper) {
     Mutex::Autolock _l(mConnectionLock);
     updateLooperRegistrationLocked(looper);
@@ -297,6 +310,10 @@ status_t SensorService::SensorEventConnection::sendEvents(
 
     int count = 0;
     Mutex::Autolock _l(mConnectionLock);
+    // Evaluate the sensor access state once per batch. It cannot change meaningfully within one
+    // batch, and checking it goes through service-level state that is too expensive to consult
+    // for every event of a high-rate sensor.
+    const bool hasAccess = hasSensorAccess();
     if (scratch) {
         size_t i=0;
         while (i<numEvents) {
@@ -312,12 +329,13 @@ status_t SensorService::SensorEventConnection::sendEvents(
 
             // Check if this connection has registered for this sensor. If not continue to the
             // next sensor_event.
-            if (mSensorInfo.count(sensor_handle) == 0) {
+            const auto sensorInfoIt = mSensorInfo.find(sensor_handle);
+            if (sensorInfoIt == mSensorInfo.end()) {
                 ++i;
                 continue;
             }
 
-            FlushInfo& flushInfo = mSensorInfo[sensor_handle];
+            FlushInfo& flushInfo = sensorInfoIt->second;
             // Check if there is a pending flush_complete event for this sensor on this connection.
             if (buffer[i].type == SENSOR_TYPE_META_DATA && flushInfo.mFirstFlushPending == true &&
                     mapFlushEventsToConnections[i] == this) {
@@ -345,9 +363,11 @@ status_t SensorService::SensorEventConnection::sendEvents(
                         scratch[count++] = buffer[i];
                     }
                 } else {
-                    // Regular sensor event, just copy it to the scratch buffer after checking
-                    // the AppOp.
-                    if (hasSensorAccess() && noteOpIfRequired(buffer[i])) {
+                    // Regular sensor event. Skip it if this connection asked for a slower rate
+                    // than the sensor is being driven at, otherwise copy it to the scratch
+                    // buffer after checking the AppOp.
+                    if (hasAccess && isSampleDueLocked(flushInfo, buffer[i]) &&
+                        noteOpIfRequired(buffer[i])) {
                         scratch[count++] = buffer[i];
                     }
                 }
@@ -358,7 +378,7 @@ status_t SensorService::SensorEventConnection::sendEvents(
                                         buffer[i].meta_data.sensor == sensor_handle)));
         }
     } else {
-        if (hasSensorAccess()) {
+        if (hasAccess) {
             scratch = const_cast<sensors_event_t *>(buffer);
             count = numEvents;
         } else {
@@ -389,7 +409,7 @@ status_t SensorService::SensorEventConnection::sendEvents(
     }
 
     int index_wake_up_event = -1;
-    if (hasSensorAccess()) {
+    if (hasAccess) {
         index_wake_up_event = findWakeUpSensorEventLocked(scratch, count);
         if (index_wake_up_event >= 0) {
             scratch[index_wake_up_event].flags |= WAKE_UP_SENSOR_EVENT_NEEDS_ACK;
@@ -671,6 +691,21 @@ int SensorService::SensorEventConnection::findWakeUpSensorEventLocked(
     return -1;
 }
 
+bool SensorService::SensorEventConnection::isSampleDueLocked(FlushInfo& flushInfo,
+                       const sensors_event_t& event) const {
+    if (flushInfo.mSamplingPeriodNs == 0) {
+        return true;
+    }
+    // Leave a 10% margin so that a sensor delivering at exactly the requested rate is not
+    // decimated by timestamp jitter.
+    const nsecs_t minGapNs = flushInfo.mSamplingPeriodNs - flushInfo.mSamplingPeriodNs / 10;
+    if (event.timestamp - flushInfo.mLastDeliveredTimestampNs < minGapNs) {
+        return false;
+    }
+    flushInfo.mLastDeliveredTimestampNs = event.timestamp;
+    return true;
+}
+
 sp<BitTube> SensorService::SensorEventConnection::getSensorChannel() const
 {
     return mChannel;
@@ -816,6 +851,14 @@ int32_t SensorService::SensorEventConnection::configureChannel(int handle, int r
     return INVALID_OPERATION;
 }
 
+status_t SensorService::SensorEventConnection::configureChannels(
+        const std::vector<std::pair<int32_t, int32_t>>& rateLevels, std::vector<int32_t>* tokens) {
+    // SensorEventConnection does not support configureChannels, parameters not used
+    UNUSED(rateLevels);
+    UNUSED(tokens);
+    return INVALID_OPERATION;
+}
+
 int SensorService::SensorEventConnection::handleEvent(int fd, int events, void* /*data*/) {
     if (events & ALOOPER_EVENT_HANGUP || events & ALOOPER_EVENT_ERROR) {
         {
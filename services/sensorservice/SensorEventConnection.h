@@ -63,6 +63,7 @@ public:
     bool removeSensor(int32_t handle);
     std::vector<int32_t> getActiveSensorHandles() const;
     void setFirstFlushPending(int32_t handle, bool value);
+    void setSamplingPeriod(int32_t handle, nsecs_t samplingPeriodNs);
     void dump(String8& result);
     void dump(util::ProtoOutputStream* proto) const;
     bool needsWakeLock();
@@ -83,6 +84,8 @@ private:
     virtual status_t setEventRate(int handle, nsecs_t samplingPeriodNs);
     virtual status_t flush();
     virtual int32_t configureChannel(int handle, int rateLevel);
+    virtual status_t configureChannels(const std::vector<std::pair<int32_t, int32_t>>& rateLevels,
+                                       std::vector<int32_t>* tokens);
     virtual void destroy();
 
     // Count the number of flush complete events which are about to be dropped in the buffer.
@@ -96,6 +99,12 @@ private:
     // flag set. SOCK_SEQPACKET ensures that either the entire packet is read or dropped.
     int findWakeUpSensorEventLocked(sensors_event_t const* scratch, int count);
 
+    // Decimation gate for continuous-mode sensors. Returns whether the event is due for this
+    // connection given the sampling period it requested, recording the timestamp if so. The
+    // sensor may be driven faster than this connection asked for when other connections request
+    // higher rates; a sensor delivering at the requested rate passes untouched.
+    bool isSampleDueLocked(FlushInfo& flushInfo, const sensors_event_t& event) const;
+
     // Send pending flush_complete events. There may have been flush_complete_events that are
     // dropped which need to be sent separately before other events. On older HALs (1_0) this method
     // emulates the behavior of flush().
@@ -174,7 +183,18 @@ private:
         // the events for the sensor are sent on that *connection*.
         bool mFirstFlushPending;
 
-        FlushInfo() : mPendingFlushEventsToSend(0), mFirstFlushPending(false) {}
+        // The sampling period this connection requested for the sensor, after clamping by the
+        // service, or zero if the sensor is not in continuous mode. When another connection
+        // drives the same sensor faster, events this connection would only discard are decimated
+        // during fan-out instead of being copied to it.
+        nsecs_t mSamplingPeriodNs;
+
+        // Timestamp of the last continuous-mode event forwarded to this connection, used by the
+        // decimation above.
+        nsecs_t mLastDeliveredTimestampNs;
+
+        FlushInfo() : mPendingFlushEventsToSend(0), mFirstFlushPending(false),
+                mSamplingPeriodNs(0), mLastDeliveredTimestampNs(0) {}
     };
     // protected by SensorService::mLock. Key for this map is the sensor handle.
     std::unordered_map<int32_t, FlushInfo> mSensorInfo;
@@ -19,7 +19,10 @@
 #include <frameworks/base/core/proto/android/service/sensor_service.proto.h>
 #include <binder/ActivityManager.h>
 #include <binder/BinderService.h>
+#include <binder/IMemory.h>
 #include <binder/IServiceManager.h>
+#include <binder/MemoryBase.h>
+#include <binder/MemoryHeapBase.h>
 #include <binder/PermissionCache.h>
 #include <binder/PermissionController.h>
 #include <cutils/ashmem.h>
@@ -56,6 +59,8 @@
 #include <math.h>
 #include <sched.h>
 #include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -419,10 +424,12 @@ const Sensor& SensorService::registerSensor(SensorInterface* s, bool isDebug, bo
 }
 
 const Sensor& SensorService::registerDynamicSensorLocked(SensorInterface* s, bool isDebug) {
+    invalidateSensorListMemoryLocked();
     return registerSensor(s, isDebug);
 }
 
 bool SensorService::unregisterDynamicSensorLocked(int handle) {
+    invalidateSensorListMemoryLocked();
     bool ret = mSensors.remove(handle);
 
     const auto i = mRecentEvent.find(handle);
@@ -1362,6 +1369,108 @@ Vector<Sensor> SensorService::getDynamicSensorList(const String16& opPackageName
     return accessibleSensorList;
 }
 
+sp<IMemory> SensorService::getSensorListMemory(const String16& opPackageName, bool* outIsCapped) {
+    char value[PROPERTY_VALUE_MAX];
+    property_get("debug.sensors", value, "0");
+    if (atoi(value)) {
+        // The debug sensor list differs from the published one; have the
+        // caller go through getSensorList instead.
+        return nullptr;
+    }
+    if (isAudioServerOrSystemServerUid(IPCThreadState::self()->getCallingUid())) {
+        // Privileged clients receive real uuids, which must not end up in a
+        // region mapped by every app.
+        return nullptr;
+    }
+
+    resetTargetSdkVersionCache(opPackageName);
+    const bool isCapped = isRateCappedBasedOnPermission(opPackageName);
+
+    Mutex::Autolock _l(mLock);
+    if (mSensorListMemory == nullptr && !buildSensorListMemoryLocked()) {
+        return nullptr;
+    }
+    *outIsCapped = isCapped;
+    return mSensorListMemory;
+}
+
+bool SensorService::buildSensorListMemoryLocked() {
+    Vector<Sensor> lists[2];
+    lists[0] = mSensors.getUserSensors();
+    for (auto& sensor : lists[0]) {
+        sensor.setId(getIdFromUuid(sensor.getUuid()));
+        // The region is only served to non privileged clients, so uuids are
+        // always anonymized.
+        sensor.anonymizeUuid();
+    }
+    lists[1] = lists[0];
+    for (auto& sensor : lists[1]) {
+        if (isSensorInCappedSet(sensor.getType())) {
+            sensor.capMinDelayMicros(SENSOR_SERVICE_CAPPED_SAMPLING_PERIOD_NS / 1000);
+            sensor.capHighestDirectReportRateLevel(SENSOR_SERVICE_CAPPED_SAMPLING_RATE_LEVEL);
+        }
+    }
+
+    size_t listSize[2];
+    for (int i = 0; i < 2; i++) {
+        listSize[i] = 0;
+        for (const auto& sensor : lists[i]) {
+            listSize[i] += sizeof(uint32_t) + ((sensor.getFlattenedSize() + 3) & ~size_t(3));
+        }
+    }
+    const size_t totalSize = sizeof(SensorListMemoryHeader) + listSize[0] + listSize[1];
+
+    // Every app parses this region, so no client may map it writable.
+    // READ_ONLY downgrades the ashmem region to PROT_READ after our own
+    // mapping is in place, which stays writable for the in-place
+    // dynamicSensorGeneration bumps.
+    sp<MemoryHeapBase> heap =
+            new MemoryHeapBase(totalSize, MemoryHeapBase::READ_ONLY, "SensorService::SensorList");
+    void* const base = heap->getBase();
+    if (base == nullptr || base == MAP_FAILED) {
+        ALOGE("Failed to allocate %zu byte sensor list region", totalSize);
+        return false;
+    }
+
+    SensorListMemoryHeader* header = static_cast<SensorListMemoryHeader*>(base);
+    header->version = SensorListMemoryHeader::kVersion;
+    header->sensorCount = static_cast<uint32_t>(lists[0].size());
+    header->dynamicSensorGeneration.store(mDynamicSensorGeneration, std::memory_order_release);
+
+    uint8_t* p = static_cast<uint8_t*>(base) + sizeof(SensorListMemoryHeader);
+    for (int i = 0; i < 2; i++) {
+        header->listOffset[i] = static_cast<uint32_t>(p - static_cast<uint8_t*>(base));
+        header->listSize[i] = static_cast<uint32_t>(listSize[i]);
+        for (const auto& sensor : lists[i]) {
+            const uint32_t flattenedSize = static_cast<uint32_t>(sensor.getFlattenedSize());
+            memcpy(p, &flattenedSize, sizeof(flattenedSize));
+            p += sizeof(uint32_t);
+            if (sensor.flatten(p, flattenedSize) != NO_ERROR) {
+                ALOGE("Failed to flatten sensor %s into the sensor list region",
+                      sensor.getName().string());
+                return false;
+            }
+            p += (flattenedSize + 3) & ~size_t(3);
+        }
+    }
+
+    mSensorListMemory = new MemoryBase(heap, 0, totalSize);
+    mSensorListMemoryHeader = header;
+    return true;
+}
+
+void SensorService::invalidateSensorListMemoryLocked() {
+    mDynamicSensorGeneration++;
+    if (mSensorListMemoryHeader != nullptr) {
+        // Clients still mapping the old region read this counter to learn
+        // that their cached lists are stale.
+        mSensorListMemoryHeader->dynamicSensorGeneration.store(mDynamicSensorGeneration,
+                                                               std::memory_order_release);
+        mSensorListMemoryHeader = nullptr;
+    }
+    mSensorListMemory.clear();
+}
+
 sp<ISensorEventConnection> SensorService::createSensorEventConnection(const String8& packageName,
         int requestedMode, const String16& opPackageName, const String16& attributionTag) {
     // Only 2 modes supported for a SensorEventConnection ... NORMAL and DATA_INJECTION.
@@ -1825,6 +1934,12 @@ status_t SensorService::enable(const sp<SensorEventConnection>& connection,
         samplingPeriodNs = minDelayNs;
     }
 
+    // Remember the rate this connection asked for, so that fan-out can decimate events when
+    // another connection drives the same sensor faster than this one wants.
+    if (sensor->getSensor().getReportingMode() == AREPORTING_MODE_CONTINUOUS) {
+        connection->setSamplingPeriod(handle, samplingPeriodNs);
+    }
+
     ALOGD_IF(DEBUG_CONNECTIONS, "Calling batch handle==%d flags=%d"
                                 "rate=%" PRId64 " timeout== %" PRId64"",
              handle, reservedFlags, samplingPeriodNs, maxBatchReportLatencyNs);
@@ -1944,7 +2059,12 @@ status_t SensorService::setEventRate(const sp<SensorEventConnection>& connection
         ns = minDelayNs;
     }
 
-    return sensor->setDelay(connection.get(), handle, ns);
+    status_t err = sensor->setDelay(connection.get(), handle, ns);
+    if (err == NO_ERROR &&
+            sensor->getSensor().getReportingMode() == AREPORTING_MODE_CONTINUOUS) {
+        connection->setSamplingPeriod(handle, ns);
+    }
+    return err;
 }
 
 status_t SensorService::flushSensor(const sp<SensorEventConnection>& connection,
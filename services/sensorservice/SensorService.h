@@ -346,6 +346,7 @@ private:
     // ISensorServer interface
     virtual Vector<Sensor> getSensorList(const String16& opPackageName);
     virtual Vector<Sensor> getDynamicSensorList(const String16& opPackageName);
+    virtual sp<IMemory> getSensorListMemory(const String16& opPackageName, bool* outIsCapped);
     virtual sp<ISensorEventConnection> createSensorEventConnection(
             const String8& packageName,
             int requestedMode, const String16& opPackageName, const String16& attributionTag);
@@ -421,6 +422,12 @@ private:
     status_t resetToNormalMode();
     status_t resetToNormalModeLocked();
 
+    // (Re)create the shared sensor list region served by getSensorListMemory.
+    bool buildSensorListMemoryLocked();
+    // Drop the shared sensor list region after a dynamic sensor change and
+    // bump the change counter so clients still mapping it notice.
+    void invalidateSensorListMemoryLocked();
+
     // Transforms the UUIDs for all the sensors into proper IDs.
     void makeUuidsIntoIdsForSensorList(Vector<Sensor> &sensorList) const;
     // Gets the appropriate ID from the given UUID.
@@ -492,6 +499,11 @@ private:
     wp<const SensorEventConnection> * mMapFlushEventsToConnections;
     std::unordered_map<int, SensorServiceUtil::RecentEventLogger*> mRecentEvent;
     Mode mCurrentOperatingMode;
+    // Shared region holding the flattened sensor list, built lazily on the
+    // first getSensorListMemory call and dropped on dynamic sensor changes.
+    sp<IMemory> mSensorListMemory;
+    SensorListMemoryHeader* mSensorListMemoryHeader = nullptr;
+    uint32_t mDynamicSensorGeneration = 0;
 
     // true if the head tracker sensor type is currently restricted to system usage only
     // (can only be unrestricted for testing, via shell cmd)
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "Fusion.h"
+
+namespace android {
+
+namespace {
+
+// 200Hz gyro, the typical rate used by SensorFusion for the 9-axis fusion.
+constexpr float GYRO_DT = 1.0f / 200;
+
+vec3_t makeVec(float x, float y, float z) {
+    vec3_t v;
+    v.x = x;
+    v.y = y;
+    v.z = z;
+    return v;
+}
+
+// Nominal stationary samples: gravity along z, a plausible magnetic field,
+// and a small gyro rate so predict() takes its regular path.
+const vec3_t ACC_SAMPLE = makeVec(0.0f, 0.0f, 9.81f);
+const vec3_t MAG_SAMPLE = makeVec(0.0f, 30.0f, -40.0f);
+const vec3_t GYRO_SAMPLE = makeVec(0.01f, -0.02f, 0.005f);
+
+// Feeds samples until the fusion has an initial estimate, so that the
+// benchmark loops below measure the steady-state predict/update paths.
+void initEstimate(Fusion& fusion) {
+    while (!fusion.hasEstimate()) {
+        fusion.handleAcc(ACC_SAMPLE, GYRO_DT);
+        fusion.handleMag(MAG_SAMPLE);
+        fusion.handleGyro(GYRO_SAMPLE, GYRO_DT);
+    }
+}
+
+} // namespace
+
+// Measures the prediction step (gyro integration and covariance
+// propagation), which runs at the full gyro rate.
+static void benchmarkHandleGyro(benchmark::State& state) {
+    Fusion fusion;
+    fusion.init();
+    initEstimate(fusion);
+
+    for (auto _ : state) {
+        fusion.handleGyro(GYRO_SAMPLE, GYRO_DT);
+        benchmark::DoNotOptimize(fusion.getAttitude());
+    }
+}
+BENCHMARK(benchmarkHandleGyro);
+
+// Measures the measurement update (Kalman gain and state correction).
+static void benchmarkHandleAcc(benchmark::State& state) {
+    Fusion fusion;
+    fusion.init();
+    initEstimate(fusion);
+
+    for (auto _ : state) {
+        fusion.handleAcc(ACC_SAMPLE, GYRO_DT);
+        benchmark::DoNotOptimize(fusion.getAttitude());
+    }
+}
+BENCHMARK(benchmarkHandleAcc);
+
+} // namespace android
+
+BENCHMARK_MAIN();
@@ -21,6 +21,9 @@
 
 #include <utils/Log.h>
 
+#include <algorithm>
+#include <condition_variable>
+
 #include "BackgroundExecutor.h"
 
 namespace android {
@@ -28,50 +31,120 @@ namespace android {
 ANDROID_SINGLETON_STATIC_INSTANCE(BackgroundExecutor);
 
 BackgroundExecutor::BackgroundExecutor() : Singleton<BackgroundExecutor>() {
-    mThread = std::thread([&]() {
-        LOG_ALWAYS_FATAL_IF(sem_init(&mSemaphore, 0, 0), "sem_init failed");
-        while (!mDone) {
-            LOG_ALWAYS_FATAL_IF(sem_wait(&mSemaphore), "sem_wait failed (%d)", errno);
-
-            ftl::SmallVector<Work*, 10> workItems;
-
-            Work* work = mWorks.pop();
-            while (work) {
-                workItems.push_back(work);
-                work = mWorks.pop();
-            }
-
-            // Sequence numbers are guaranteed to be in intended order, as we assume a single
-            // producer and single consumer.
-            std::stable_sort(workItems.begin(), workItems.end(), [](Work* left, Work* right) {
-                return left->sequence < right->sequence;
-            });
-            for (Work* work : workItems) {
-                for (auto& task : work->tasks) {
-                    task();
-                }
-                delete work;
-            }
-        }
-    });
+    LOG_ALWAYS_FATAL_IF(sem_init(&mSemaphore, 0, 0), "sem_init failed");
+    const size_t numWorkers =
+            std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 2u, 4u);
+    mThreads.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; i++) {
+        mThreads.emplace_back(&BackgroundExecutor::threadLoop, this);
+    }
 }
 
 BackgroundExecutor::~BackgroundExecutor() {
     mDone = true;
-    LOG_ALWAYS_FATAL_IF(sem_post(&mSemaphore), "sem_post failed");
-    if (mThread.joinable()) {
-        mThread.join();
-        LOG_ALWAYS_FATAL_IF(sem_destroy(&mSemaphore), "sem_destroy failed");
+    for (size_t i = 0; i < mThreads.size(); i++) {
+        LOG_ALWAYS_FATAL_IF(sem_post(&mSemaphore), "sem_post failed");
+    }
+    for (std::thread& thread : mThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    LOG_ALWAYS_FATAL_IF(sem_destroy(&mSemaphore), "sem_destroy failed");
+
+    // Delete any batches that were never claimed by a worker.
+    std::scoped_lock lock(mStateLock);
+    drainIncomingLocked();
+    for (auto& [tag, queue] : mTagQueues) {
+        for (Work* work : queue) {
+            delete work;
+        }
     }
 }
 
-void BackgroundExecutor::sendCallbacks(Callbacks&& tasks) {
+void BackgroundExecutor::sendCallbacks(Callbacks&& tasks, Tag tag) {
     Work* work = new Work();
     work->sequence = mSequence;
+    work->tag = tag;
     work->tasks = std::move(tasks);
     mWorks.push(work);
     mSequence++;
     LOG_ALWAYS_FATAL_IF(sem_post(&mSemaphore), "sem_post failed");
 }
 
-} // namespace android
\ No newline at end of file
+void BackgroundExecutor::flushQueue(Tag tag) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool flushComplete = false;
+    sendCallbacks({[&]() {
+                      std::scoped_lock lock(mutex);
+                      flushComplete = true;
+                      cv.notify_one();
+                  }},
+                  tag);
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [&] { return flushComplete; });
+}
+
+void BackgroundExecutor::drainIncomingLocked() {
+    ftl::SmallVector<Work*, 10> workItems;
+
+    Work* work = mWorks.pop();
+    while (work) {
+        workItems.push_back(work);
+        work = mWorks.pop();
+    }
+
+    // Sequence numbers are guaranteed to be in intended order, as we assume a single
+    // producer.
+    std::stable_sort(workItems.begin(), workItems.end(), [](Work* left, Work* right) {
+        return left->sequence < right->sequence;
+    });
+    for (Work* work : workItems) {
+        mTagQueues[work->tag].push_back(work);
+    }
+}
+
+void BackgroundExecutor::threadLoop() {
+    while (!mDone) {
+        LOG_ALWAYS_FATAL_IF(sem_wait(&mSemaphore), "sem_wait failed (%d)", errno);
+
+        std::unique_lock lock(mStateLock);
+        drainIncomingLocked();
+
+        bool ranWork = true;
+        while (ranWork) {
+            ranWork = false;
+            for (auto& [tag, queue] : mTagQueues) {
+                if (queue.empty() || mActiveTags.count(tag)) {
+                    continue;
+                }
+
+                // Claim every batch currently queued for the tag. Another worker may
+                // append new batches while we run, but it cannot execute them until we
+                // release the tag, which keeps per-tag ordering intact.
+                const Tag claimedTag = tag;
+                std::deque<Work*> batches = std::move(queue);
+                queue.clear();
+                mActiveTags.insert(claimedTag);
+                lock.unlock();
+
+                for (Work* work : batches) {
+                    for (auto& task : work->tasks) {
+                        task();
+                    }
+                    delete work;
+                }
+
+                lock.lock();
+                mActiveTags.erase(claimedTag);
+                drainIncomingLocked();
+                ranWork = true;
+                // drainIncomingLocked may rehash mTagQueues, so restart the scan.
+                break;
+            }
+        }
+    }
+}
+
+} // namespace android
@@ -21,38 +21,71 @@
 #include <ftl/small_vector.h>
 #include <semaphore.h>
 #include <utils/Singleton.h>
+#include <deque>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace android {
 
-// Executes tasks off the main thread.
+// Executes tasks off the main thread on a small pool of worker threads.
 class BackgroundExecutor : public Singleton<BackgroundExecutor> {
 public:
     BackgroundExecutor();
     ~BackgroundExecutor();
     using Callbacks = ftl::SmallVector<std::function<void()>, 10>;
-    // Queues callbacks onto a work queue to be executed by a background thread.
+
+    // Work batches sent with the same tag execute one at a time, in the order they were
+    // sent, so per-client callback ordering guarantees are preserved. Batches with
+    // different tags may execute in parallel on different workers.
+    using Tag = uint32_t;
+    static constexpr Tag kDefaultTag = 0;
+    static constexpr Tag kTransactionCallbackTag = 1;
+    static constexpr Tag kWindowInfoTag = 2;
+    static constexpr Tag kRefreshRateOverlayTag = 3;
+    static constexpr Tag kFpsReporterTag = 4;
+    static constexpr Tag kHdrLayerInfoTag = 5;
+    static constexpr Tag kTunnelModeTag = 6;
+
+    // Queues callbacks onto a work queue to be executed by a background worker.
     // Note that this is not thread-safe - a single producer is assumed.
-    void sendCallbacks(Callbacks&& tasks);
+    void sendCallbacks(Callbacks&& tasks, Tag tag = kDefaultTag);
+
+    // Blocks until all batches previously sent with |tag| have executed. Only intended for
+    // tests that need to observe the side effects of queued callbacks.
+    void flushQueue(Tag tag = kDefaultTag);
 
 private:
+    struct Work {
+        int32_t sequence = 0;
+        Tag tag = kDefaultTag;
+        Callbacks tasks;
+    };
+
+    void threadLoop();
+    // Moves works pushed by the producer into the per-tag queues, oldest first.
+    void drainIncomingLocked() REQUIRES(mStateLock);
+
     sem_t mSemaphore;
     std::atomic_bool mDone = false;
 
     // Sequence number for work items.
     // Work items are batched by sequence number. Work items for earlier sequence numbers are
-    // executed first. Work items with the same sequence number are executed in the same order they
-    // were added to the stack (meaning the stack must reverse the order after popping from the
-    // queue)
+    // executed first within their tag. Work items with the same sequence number are executed
+    // in the same order they were added to the stack (meaning the stack must reverse the order
+    // after popping from the queue)
     int32_t mSequence = 0;
-    struct Work {
-        int32_t sequence = 0;
-        Callbacks tasks;
-    };
     LocklessStack<Work> mWorks;
-    std::thread mThread;
+
+    std::mutex mStateLock;
+    // Pending work batches per tag, in execution order.
+    std::unordered_map<Tag, std::deque<Work*>> mTagQueues GUARDED_BY(mStateLock);
+    // Tags currently being executed by a worker. A tag is claimed by at most one worker at a
+    // time so its batches never run concurrently or out of order.
+    std::unordered_set<Tag> mActiveTags GUARDED_BY(mStateLock);
+    std::vector<std::thread> mThreads;
 };
 
 } // namespace android
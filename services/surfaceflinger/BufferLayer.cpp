@@ -462,6 +462,8 @@ bool BufferLayer::latchBuffer(bool& recomputeVisibleRegions, nsecs_t latchTime,
     bool refreshRequired = latchSidebandStream(recomputeVisibleRegions);
 
     if (refreshRequired) {
+        // The sideband stream changed, so any cached client composition list is stale.
+        mVisualStateGeneration++;
         return refreshRequired;
     }
 
@@ -496,6 +498,10 @@ bool BufferLayer::latchBuffer(bool& recomputeVisibleRegions, nsecs_t latchTime,
 
     gatherBufferInfo();
 
+    // A new buffer (and its fence, frame number and metadata) was latched, so any cached
+    // client composition list is stale.
+    mVisualStateGeneration++;
+
     if (oldBufferInfo.mBuffer == nullptr) {
         // the first time we receive a buffer, we need to trigger a
         // geometry invalidation.
@@ -783,6 +789,9 @@ void BufferLayer::updateCloneBufferInfo() {
     mDrawingState.zOrderRelativeOf = tmpZOrderRelativeOf;
     mDrawingState.zOrderRelatives = tmpZOrderRelatives;
     mDrawingState.inputInfo = tmpInputInfo;
+
+    // Clones bypass latchBuffer, so invalidate the cached client composition list here.
+    mVisualStateGeneration++;
 }
 
 void BufferLayer::setTransformHint(ui::Transform::RotationFlags displayTransformHint) {
@@ -363,12 +363,20 @@ bool BufferStateLayer::setBuffer(std::shared_ptr<renderengine::ExternalTexture>&
             // If mDrawingState has a buffer, and we are about to update again
             // before swapping to drawing state, then the first buffer will be
             // dropped and we should decrement the pending buffer count and
-            // call any release buffer callbacks if set.
-            callReleaseBufferCallback(mDrawingState.releaseBufferListener,
-                                      mDrawingState.buffer->getBuffer(), mDrawingState.frameNumber,
-                                      mDrawingState.acquireFence,
-                                      mFlinger->getMaxAcquiredBufferCountForCurrentRefreshRate(
-                                              mOwnerUid));
+            // call any release buffer callbacks if set. The release is queued
+            // on the invoker so that all buffers released for the same
+            // listener this commit go out in one binder transaction.
+            if (mDrawingState.releaseBufferListener) {
+                mFlinger->getTransactionCallbackInvoker()
+                        .addBufferRelease(mDrawingState.releaseBufferListener,
+                                          {{mDrawingState.buffer->getBuffer()->getId(),
+                                            mDrawingState.frameNumber},
+                                           mDrawingState.acquireFence
+                                                   ? mDrawingState.acquireFence
+                                                   : Fence::NO_FENCE,
+                                           mFlinger->getMaxAcquiredBufferCountForCurrentRefreshRate(
+                                                   mOwnerUid)});
+            }
             decrementPendingBufferCount();
             if (mDrawingState.bufferSurfaceFrameTX != nullptr &&
                 mDrawingState.bufferSurfaceFrameTX->getPresentState() != PresentState::Presented) {
@@ -376,11 +384,15 @@ bool BufferStateLayer::setBuffer(std::shared_ptr<renderengine::ExternalTexture>&
               mDrawingState.bufferSurfaceFrameTX.reset();
             }
         } else if (EARLY_RELEASE_ENABLED && mLastClientCompositionFence != nullptr) {
-            callReleaseBufferCallback(mDrawingState.releaseBufferListener,
-                                      mDrawingState.buffer->getBuffer(), mDrawingState.frameNumber,
-                                      mLastClientCompositionFence,
-                                      mFlinger->getMaxAcquiredBufferCountForCurrentRefreshRate(
-                                              mOwnerUid));
+            if (mDrawingState.releaseBufferListener) {
+                mFlinger->getTransactionCallbackInvoker()
+                        .addBufferRelease(mDrawingState.releaseBufferListener,
+                                          {{mDrawingState.buffer->getBuffer()->getId(),
+                                            mDrawingState.frameNumber},
+                                           mLastClientCompositionFence,
+                                           mFlinger->getMaxAcquiredBufferCountForCurrentRefreshRate(
+                                                   mOwnerUid)});
+            }
             mLastClientCompositionFence = nullptr;
         }
     }
@@ -394,6 +406,9 @@ bool BufferStateLayer::setBuffer(std::shared_ptr<renderengine::ExternalTexture>&
             ? bufferData.acquireFence
             : Fence::NO_FENCE;
     mDrawingState.acquireFenceTime = std::make_unique<FenceTime>(mDrawingState.acquireFence);
+    // Let the FenceWatcher resolve the signal time asynchronously, so the latch readiness
+    // checks during commit read a cached value instead of querying the fence.
+    FenceWatcher::getInstance().watch(mDrawingState.acquireFenceTime);
     if (mDrawingState.acquireFenceTime->getSignalTime() == Fence::SIGNAL_TIME_PENDING) {
         // We latched this buffer unsiganled, so we need to pass the acquire fence
         // on the callback instead of just the acquire time, since it's unknown at
@@ -578,8 +593,11 @@ bool BufferStateLayer::fenceHasSignaled() const {
         return true;
     }
 
+    // Reads the FenceTime's cached signal time (resolved by the FenceWatcher) instead of
+    // issuing an ioctl per layer per commit. Only a pending fence blocks the latch; invalid
+    // fences (e.g. NO_FENCE) count as signaled, like in Fence::getStatus().
     const bool fenceSignaled =
-            getDrawingState().acquireFence->getStatus() == Fence::Status::Signaled;
+            getDrawingState().acquireFenceTime->getSignalTime() != Fence::SIGNAL_TIME_PENDING;
     if (!fenceSignaled) {
         mFlinger->mTimeStats->incrementLatchSkipped(getSequence(),
                                                     TimeStats::LatchSkipReason::LateAcquire);
@@ -32,15 +32,15 @@ ANDROID_SINGLETON_STATIC_INSTANCE(ClientCache);
 
 ClientCache::ClientCache() : mDeathRecipient(new CacheDeathRecipient) {}
 
-bool ClientCache::getBuffer(const client_cache_t& cacheId,
-                            ClientCacheBuffer** outClientCacheBuffer) {
+bool ClientCache::getBufferLocked(CacheShard& shard, const client_cache_t& cacheId,
+                                  ClientCacheBuffer** outClientCacheBuffer) {
     auto& [processToken, id] = cacheId;
     if (processToken == nullptr) {
         ALOGE("failed to get buffer, invalid (nullptr) process token");
         return false;
     }
-    auto it = mBuffers.find(processToken);
-    if (it == mBuffers.end()) {
+    auto it = shard.buffers.find(processToken);
+    if (it == shard.buffers.end()) {
         ALOGE("failed to get buffer, invalid process token");
         return false;
     }
@@ -70,13 +70,14 @@ bool ClientCache::add(const client_cache_t& cacheId, const sp<GraphicBuffer>& bu
         return false;
     }
 
-    std::lock_guard lock(mMutex);
+    CacheShard& shard = shardForToken(processToken);
+    std::lock_guard lock(shard.mutex);
     sp<IBinder> token;
 
     // If this is a new process token, set a death recipient. If the client process dies, we will
     // get a callback through binderDied.
-    auto it = mBuffers.find(processToken);
-    if (it == mBuffers.end()) {
+    auto it = shard.buffers.find(processToken);
+    if (it == shard.buffers.end()) {
         token = processToken.promote();
         if (!token) {
             ALOGE("failed to cache buffer: invalid token");
@@ -92,7 +93,8 @@ bool ClientCache::add(const client_cache_t& cacheId, const sp<GraphicBuffer>& bu
             }
         }
         auto [itr, success] =
-                mBuffers.emplace(processToken,
+                shard.buffers
+                        .emplace(processToken,
                                  std::make_pair(token,
                                                 std::unordered_map<uint64_t, ClientCacheBuffer>()));
         LOG_ALWAYS_FATAL_IF(!success, "failed to insert new process into client cache");
@@ -118,35 +120,36 @@ bool ClientCache::add(const client_cache_t& cacheId, const sp<GraphicBuffer>& bu
 
 void ClientCache::erase(const client_cache_t& cacheId) {
     auto& [processToken, id] = cacheId;
-    std::vector<sp<ErasedRecipient>> pendingErase;
+    // Recipients are collected under the shard lock but promoted and notified
+    // outside of it, so a large flush holds the lock only briefly per buffer.
+    std::set<wp<ErasedRecipient>> pendingErase;
     {
-        std::lock_guard lock(mMutex);
+        CacheShard& shard = shardForToken(processToken);
+        std::lock_guard lock(shard.mutex);
         ClientCacheBuffer* buf = nullptr;
-        if (!getBuffer(cacheId, &buf)) {
+        if (!getBufferLocked(shard, cacheId, &buf)) {
             ALOGE("failed to erase buffer, could not retrieve buffer");
             return;
         }
 
-        for (auto& recipient : buf->recipients) {
-            sp<ErasedRecipient> erasedRecipient = recipient.promote();
-            if (erasedRecipient) {
-                pendingErase.push_back(erasedRecipient);
-            }
-        }
-
-        mBuffers[processToken].second.erase(id);
+        pendingErase = std::move(buf->recipients);
+        shard.buffers[processToken].second.erase(id);
     }
 
     for (auto& recipient : pendingErase) {
-        recipient->bufferErased(cacheId);
+        sp<ErasedRecipient> erasedRecipient = recipient.promote();
+        if (erasedRecipient) {
+            erasedRecipient->bufferErased(cacheId);
+        }
     }
 }
 
 std::shared_ptr<renderengine::ExternalTexture> ClientCache::get(const client_cache_t& cacheId) {
-    std::lock_guard lock(mMutex);
+    CacheShard& shard = shardForToken(cacheId.token);
+    std::lock_guard lock(shard.mutex);
 
     ClientCacheBuffer* buf = nullptr;
-    if (!getBuffer(cacheId, &buf)) {
+    if (!getBufferLocked(shard, cacheId, &buf)) {
         ALOGE("failed to get buffer, could not retrieve buffer");
         return nullptr;
     }
@@ -156,10 +159,11 @@ std::shared_ptr<renderengine::ExternalTexture> ClientCache::get(const client_cac
 
 bool ClientCache::registerErasedRecipient(const client_cache_t& cacheId,
                                           const wp<ErasedRecipient>& recipient) {
-    std::lock_guard lock(mMutex);
+    CacheShard& shard = shardForToken(cacheId.token);
+    std::lock_guard lock(shard.mutex);
 
     ClientCacheBuffer* buf = nullptr;
-    if (!getBuffer(cacheId, &buf)) {
+    if (!getBufferLocked(shard, cacheId, &buf)) {
         ALOGV("failed to register erased recipient, could not retrieve buffer");
         return false;
     }
@@ -169,10 +173,11 @@ bool ClientCache::registerErasedRecipient(const client_cache_t& cacheId,
 
 void ClientCache::unregisterErasedRecipient(const client_cache_t& cacheId,
                                             const wp<ErasedRecipient>& recipient) {
-    std::lock_guard lock(mMutex);
+    CacheShard& shard = shardForToken(cacheId.token);
+    std::lock_guard lock(shard.mutex);
 
     ClientCacheBuffer* buf = nullptr;
-    if (!getBuffer(cacheId, &buf)) {
+    if (!getBufferLocked(shard, cacheId, &buf)) {
         ALOGE("failed to unregister erased recipient");
         return;
     }
@@ -181,33 +186,35 @@ void ClientCache::unregisterErasedRecipient(const client_cache_t& cacheId,
 }
 
 void ClientCache::removeProcess(const wp<IBinder>& processToken) {
-    std::vector<std::pair<sp<ErasedRecipient>, client_cache_t>> pendingErase;
+    // The process's buffer map is detached under the shard lock in one go;
+    // recipients are promoted and notified afterwards so a process death with
+    // hundreds of cached buffers does not stall the shard.
+    std::unordered_map<uint64_t, ClientCacheBuffer> removedBuffers;
     {
         if (processToken == nullptr) {
             ALOGE("failed to remove process, invalid (nullptr) process token");
             return;
         }
-        std::lock_guard lock(mMutex);
-        auto itr = mBuffers.find(processToken);
-        if (itr == mBuffers.end()) {
+        CacheShard& shard = shardForToken(processToken);
+        std::lock_guard lock(shard.mutex);
+        auto itr = shard.buffers.find(processToken);
+        if (itr == shard.buffers.end()) {
             ALOGE("failed to remove process, could not find process");
             return;
         }
 
-        for (auto& [id, clientCacheBuffer] : itr->second.second) {
-            client_cache_t cacheId = {processToken, id};
-            for (auto& recipient : clientCacheBuffer.recipients) {
-                sp<ErasedRecipient> erasedRecipient = recipient.promote();
-                if (erasedRecipient) {
-                    pendingErase.emplace_back(erasedRecipient, cacheId);
-                }
-            }
-        }
-        mBuffers.erase(itr);
+        removedBuffers = std::move(itr->second.second);
+        shard.buffers.erase(itr);
     }
 
-    for (auto& [recipient, cacheId] : pendingErase) {
-        recipient->bufferErased(cacheId);
+    for (auto& [id, clientCacheBuffer] : removedBuffers) {
+        const client_cache_t cacheId = {processToken, id};
+        for (auto& recipient : clientCacheBuffer.recipients) {
+            sp<ErasedRecipient> erasedRecipient = recipient.promote();
+            if (erasedRecipient) {
+                erasedRecipient->bufferErased(cacheId);
+            }
+        }
     }
 }
 
@@ -216,14 +223,16 @@ void ClientCache::CacheDeathRecipient::binderDied(const wp<IBinder>& who) {
 }
 
 void ClientCache::dump(std::string& result) {
-    std::lock_guard lock(mMutex);
-    for (const auto& [_, cache] : mBuffers) {
-        base::StringAppendF(&result, " Cache owner: %p\n", cache.first.get());
-
-        for (const auto& [id, entry] : cache.second) {
-            const auto& buffer = entry.buffer->getBuffer();
-            base::StringAppendF(&result, "\tID: %" PRIu64 ", size: %ux%u\n", id, buffer->getWidth(),
-                                buffer->getHeight());
+    for (CacheShard& shard : mShards) {
+        std::lock_guard lock(shard.mutex);
+        for (const auto& [_, cache] : shard.buffers) {
+            base::StringAppendF(&result, " Cache owner: %p\n", cache.first.get());
+
+            for (const auto& [id, entry] : cache.second) {
+                const auto& buffer = entry.buffer->getBuffer();
+                base::StringAppendF(&result, "\tID: %" PRIu64 ", size: %ux%u\n", id,
+                                    buffer->getWidth(), buffer->getHeight());
+            }
         }
     }
 }
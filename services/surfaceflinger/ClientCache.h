@@ -61,16 +61,31 @@ public:
     void dump(std::string& result);
 
 private:
-    std::mutex mMutex;
-
     struct ClientCacheBuffer {
         std::shared_ptr<renderengine::ExternalTexture> buffer;
         std::set<wp<ErasedRecipient>> recipients;
     };
-    std::map<wp<IBinder> /*caching process*/,
-             std::pair<sp<IBinder> /*strong ref to caching process*/,
-                       std::unordered_map<uint64_t /*cache id*/, ClientCacheBuffer>>>
-            mBuffers GUARDED_BY(mMutex);
+
+    // The cache is sharded by client process token so that one process
+    // flushing its cached buffers only contends with itself; transactions
+    // from other processes proceed on their own shard locks.
+    struct CacheShard {
+        std::mutex mutex;
+        std::map<wp<IBinder> /*caching process*/,
+                 std::pair<sp<IBinder> /*strong ref to caching process*/,
+                           std::unordered_map<uint64_t /*cache id*/, ClientCacheBuffer>>>
+                buffers GUARDED_BY(mutex);
+    };
+
+    static constexpr size_t kNumShards = 8;
+    CacheShard mShards[kNumShards];
+
+    CacheShard& shardForToken(const wp<IBinder>& processToken) {
+        // The raw pointer is used only to pick a shard and is never
+        // dereferenced.
+        const auto ptr = reinterpret_cast<uintptr_t>(processToken.unsafe_get());
+        return mShards[(ptr >> 4) % kNumShards];
+    }
 
     class CacheDeathRecipient : public IBinder::DeathRecipient {
     public:
@@ -80,8 +95,9 @@ private:
     sp<CacheDeathRecipient> mDeathRecipient;
     renderengine::RenderEngine* mRenderEngine = nullptr;
 
-    bool getBuffer(const client_cache_t& cacheId, ClientCacheBuffer** outClientCacheBuffer)
-            REQUIRES(mMutex);
+    // Called with the shard's lock held.
+    bool getBufferLocked(CacheShard& shard, const client_cache_t& cacheId,
+                         ClientCacheBuffer** outClientCacheBuffer);
 };
 
 }; // namespace android
@@ -33,10 +33,13 @@ namespace compositionengine::impl {
 // we can skip of the request, pass back an empty fence, and let HWC use the previous render
 // result.
 //
-// The cache is a mapping of the RenderSurface buffer id (unique per process) and a snapshot of
-// the composition request. We need to make sure the request, including the order of the
-// layers, do not change from call to call. The snapshot removes strong references to the
-// client buffer id so we don't extend the lifetime of the buffer by storing it in the cache.
+// The cache is a mapping of the RenderSurface buffer id (unique per process) and a fingerprint
+// of the composition request, so a lookup is a single hash compare rather than a deep compare
+// of the settings. The fingerprint hashes the request state that determines the rendered
+// output - including the order of the layers - and excludes buffer handles, fences and other
+// non-visual state, so we neither extend buffer lifetimes nor re-render visually identical
+// frames. A 64-bit fingerprint collision could skip a necessary re-render, but the odds are
+// negligible against the per-frame cost of the deep compare.
 class ClientCompositionRequestCache {
 public:
     explicit ClientCompositionRequestCache(uint32_t cacheSize) : mMaxCacheSize(cacheSize){};
@@ -49,17 +52,9 @@ public:
 
 private:
     uint32_t mMaxCacheSize;
-    struct ClientCompositionRequest {
-        renderengine::DisplaySettings display;
-        std::vector<LayerFE::LayerSettings> layerSettings;
-        ClientCompositionRequest(const renderengine::DisplaySettings& _display,
-                                 const std::vector<LayerFE::LayerSettings>& _layerSettings);
-        bool equals(const renderengine::DisplaySettings& _display,
-                    const std::vector<LayerFE::LayerSettings>& _layerSettings) const;
-    };
 
-    // Cache of requests, keyed by corresponding GraphicBuffer ID.
-    std::deque<std::pair<uint64_t /* bufferId */, ClientCompositionRequest>> mCache;
+    // Cache of request fingerprints, keyed by corresponding GraphicBuffer ID.
+    std::deque<std::pair<uint64_t /* bufferId */, size_t /* fingerprint */>> mCache;
 };
 
 } // namespace compositionengine::impl
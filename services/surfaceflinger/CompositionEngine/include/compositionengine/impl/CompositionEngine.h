@@ -17,6 +17,10 @@
 #pragma once
 
 #include <compositionengine/CompositionEngine.h>
+#include <compositionengine/impl/HwcAsyncWorker.h>
+
+#include <memory>
+#include <vector>
 
 namespace android::compositionengine::impl {
 
@@ -55,13 +59,27 @@ public:
 
     // Testing
     void setNeedsAnotherUpdateForTest(bool);
+    void setParallelPresentForTest(bool);
 
 private:
+    // Runs Output::present for every output on a worker pool and joins before
+    // returning, so independent displays compose concurrently.
+    void presentOutputsParallel(CompositionRefreshArgs& args);
+
     std::unique_ptr<HWComposer> mHwComposer;
     std::unique_ptr<renderengine::RenderEngine> mRenderEngine;
     std::shared_ptr<TimeStats> mTimeStats;
     bool mNeedsAnotherUpdate = false;
     nsecs_t mRefreshStartTime = 0;
+
+    // Opt-in parallel present mode (debug.sf.parallel_composition). Each extra
+    // output runs its full present pass on a dedicated worker so multi-display
+    // frame time approaches the slowest display instead of the sum. Off by
+    // default: it is only safe on stacks whose composer HAL accepts concurrent
+    // per-display command streams and whose render engine is the threaded
+    // backend.
+    bool mParallelPresentEnabled;
+    std::vector<std::unique_ptr<HwcAsyncWorker>> mPresentWorkers;
 };
 
 std::unique_ptr<compositionengine::CompositionEngine> createCompositionEngine();
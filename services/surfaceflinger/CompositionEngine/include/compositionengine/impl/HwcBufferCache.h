@@ -57,15 +57,33 @@ public:
     void getHwcBuffer(int slot, const sp<GraphicBuffer>& buffer, uint32_t* outSlot,
                       sp<GraphicBuffer>* outBuffer);
 
+    // Number of lookups that did not require sending the buffer to the HAL, and number that
+    // did. A high miss count for a layer means its buffer rotation exceeds the cache size and
+    // every frame pays the full buffer import cost.
+    uint64_t getHitCount() const { return mCacheHits; }
+    uint64_t getMissCount() const { return mCacheMisses; }
+
     // Special caching slot for the layer caching feature.
     static const constexpr size_t FLATTENER_CACHING_SLOT = BufferQueue::NUM_BUFFER_SLOTS;
 
 private:
-    // an array where the index corresponds to a slot and the value corresponds to a (counter,
-    // buffer) pair. "counter" is a unique value that indicates the last time this slot was updated
-    // or used and allows us to keep track of the least-recently used buffer.
+    // Each slot is tagged with the id of the GraphicBuffer cached in it. Buffer ids are unique
+    // for the lifetime of the process, so the tag detects a slot that was evicted and reused by
+    // the caller's slot generator, as well as a new buffer allocated at the address of a
+    // destroyed one - either would otherwise compare equal to the stale weak reference and
+    // leave the HAL compositing from a stale handle.
+    struct Entry {
+        wp<GraphicBuffer> buffer;
+        uint64_t bufferId = 0;
+    };
+
+    // an array where the index corresponds to a slot and the value corresponds to a (buffer,
+    // generation tag) pair mirroring what the HAL has cached for that slot.
     static const constexpr size_t kMaxLayerBufferCount = BufferQueue::NUM_BUFFER_SLOTS + 1;
-    wp<GraphicBuffer> mBuffers[kMaxLayerBufferCount];
+    Entry mBuffers[kMaxLayerBufferCount];
+
+    uint64_t mCacheHits = 0;
+    uint64_t mCacheMisses = 0;
 };
 
 } // namespace compositionengine::impl
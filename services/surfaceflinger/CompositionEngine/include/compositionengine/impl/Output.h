@@ -25,6 +25,7 @@
 #include <compositionengine/impl/OutputCompositionState.h>
 #include <compositionengine/impl/OutputLayerCompositionState.h>
 #include <compositionengine/impl/planner/Planner.h>
+#include <ftl/small_vector.h>
 #include <renderengine/DisplaySettings.h>
 #include <renderengine/LayerSettings.h>
 
@@ -156,6 +157,11 @@ protected:
 
 private:
     void dirtyEntireOutput();
+    // Latches the candidate layers' basic geometry state and returns a fingerprint of every
+    // input to the coverage computation, or std::nullopt if the result cannot be reused (e.g.
+    // a layer has dirty content that must contribute to the output dirty region).
+    std::optional<size_t> latchAndComputeCoverageFingerprint(const CompositionRefreshArgs&,
+                                                             LayerFESet&);
     compositionengine::OutputLayer* findLayerRequestingBackgroundComposition() const;
     void finishPrepareFrame();
     ui::Dataspace getBestDataspace(ui::Dataspace*, bool*) const;
@@ -168,6 +174,9 @@ private:
     std::unique_ptr<compositionengine::RenderSurface> mRenderSurface;
 
     ReleasedLayers mReleasedLayers;
+    // Fingerprint of the coverage inputs from the last layer-stack rebuild, used to skip the
+    // per-layer Region arithmetic when nothing affecting this output changed.
+    std::optional<size_t> mCoverageFingerprint;
     OutputLayer* mLayerRequestingBackgroundBlur = nullptr;
     std::unique_ptr<ClientCompositionRequestCache> mClientCompositionRequestCache;
     std::unique_ptr<planner::Planner> mPlanner;
@@ -265,8 +274,15 @@ std::shared_ptr<BaseOutput> createOutputTemplated(const CompositionEngine& compo
 
         const CompositionEngine& mCompositionEngine;
         OutputCompositionState mState;
-        std::vector<std::unique_ptr<OutputLayer>> mCurrentOutputLayersOrderedByZ;
-        std::vector<std::unique_ptr<OutputLayer>> mPendingOutputLayersOrderedByZ;
+
+        // These lists are rebuilt every frame, so they use inline storage to avoid
+        // reallocating identically sized vectors 60+ times a second, only spilling
+        // to the heap for outputs with more visible layers than most frames have.
+        static constexpr size_t kStaticOutputLayers = 16;
+        ftl::SmallVector<std::unique_ptr<OutputLayer>, kStaticOutputLayers>
+                mCurrentOutputLayersOrderedByZ;
+        ftl::SmallVector<std::unique_ptr<OutputLayer>, kStaticOutputLayers>
+                mPendingOutputLayersOrderedByZ;
     };
 
     return std::make_shared<Output>(compositionEngine, std::forward<Args>(args)...);
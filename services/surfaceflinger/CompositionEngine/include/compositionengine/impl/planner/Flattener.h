@@ -21,6 +21,7 @@
 #include <compositionengine/impl/planner/LayerState.h>
 
 #include <chrono>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -74,6 +75,11 @@ public:
 
         static const constexpr bool kDefaultEnableHolePunch = true;
 
+        static const constexpr size_t kDefaultMaxFlattenedLayers =
+                std::numeric_limits<size_t>::max();
+
+        static const constexpr float kDefaultStabilityWeight = 0.f;
+
         // Threshold for determing whether a layer is active. A layer whose properties, including
         // the buffer, have not changed in at least this time is considered inactive and is
         // therefore a candidate for flattening.
@@ -85,6 +91,17 @@ public:
 
         // True if the hole punching feature should be enabled.
         const bool mEnableHolePunch;
+
+        // Maximum number of layers a single cached set may flatten. Candidate runs longer than
+        // this are not flattened at all, which bounds the size of the set a buffer update can
+        // invalidate.
+        const size_t mMaxFlattenedLayers = kDefaultMaxFlattenedLayers;
+
+        // Weight applied to buffer stability (frames since the last buffer update, averaged
+        // over a candidate run) when scoring runs in findBestRun. Zero scores runs purely by
+        // layer count; larger values prefer runs of long-stable content, which are the least
+        // likely to invalidate a cached set right after we spend GPU time rendering it.
+        const float mStabilityWeight = kDefaultStabilityWeight;
     };
 
     // Constants not yet backed by a sysprop
@@ -254,6 +271,10 @@ private:
     size_t mCachedSetCreationCount = 0;
     size_t mCachedSetCreationCost = 0;
     std::unordered_map<size_t, size_t> mInvalidatedCachedSetAges;
+    // Frames in which at least one multi-layer cached set with a rendered buffer was reused,
+    // versus frames where none was (including geometry invalidations).
+    size_t mCacheHitFrames = 0;
+    size_t mCacheMissFrames = 0;
 };
 
 } // namespace compositionengine::impl::planner
@@ -14,84 +14,64 @@
  * limitations under the License.
  */
 
-#include <algorithm>
-
 #include <compositionengine/impl/ClientCompositionRequestCache.h>
+#include <math/HashCombine.h>
 #include <renderengine/DisplaySettings.h>
 #include <renderengine/LayerSettings.h>
 
 namespace android::compositionengine::impl {
 
 namespace {
-LayerFE::LayerSettings getLayerSettingsSnapshot(const LayerFE::LayerSettings& settings) {
-    LayerFE::LayerSettings snapshot = settings;
-    snapshot.source.buffer.buffer = nullptr;
-    snapshot.source.buffer.fence = nullptr;
-    return snapshot;
-}
-
-inline bool equalIgnoringSource(const renderengine::LayerSettings& lhs,
-                                const renderengine::LayerSettings& rhs) {
-    return lhs.geometry == rhs.geometry && lhs.alpha == rhs.alpha &&
-            lhs.sourceDataspace == rhs.sourceDataspace &&
-            lhs.colorTransform == rhs.colorTransform &&
-            lhs.disableBlending == rhs.disableBlending && lhs.shadow == rhs.shadow &&
-            lhs.backgroundBlurRadius == rhs.backgroundBlurRadius &&
-            lhs.stretchEffect == rhs.stretchEffect;
-}
-
-inline bool equalIgnoringBuffer(const renderengine::Buffer& lhs, const renderengine::Buffer& rhs) {
-    return lhs.textureName == rhs.textureName &&
-            lhs.useTextureFiltering == rhs.useTextureFiltering &&
-            lhs.textureTransform == rhs.textureTransform &&
-            lhs.usePremultipliedAlpha == rhs.usePremultipliedAlpha &&
-            lhs.isOpaque == rhs.isOpaque && lhs.isY410BT2020 == rhs.isY410BT2020 &&
-            lhs.maxLuminanceNits == rhs.maxLuminanceNits;
-}
-
-inline bool equalIgnoringBuffer(const renderengine::LayerSettings& lhs,
-                                const renderengine::LayerSettings& rhs) {
-    // compare LayerSettings without LayerSettings.PixelSource
-    return equalIgnoringSource(lhs, rhs) &&
 
-            // compare LayerSettings.PixelSource without buffer
-            lhs.source.solidColor == rhs.source.solidColor &&
-
-            // compare LayerSettings.PixelSource.Buffer without buffer & fence
-            equalIgnoringBuffer(lhs.source.buffer, rhs.source.buffer);
-}
-
-bool layerSettingsAreEqual(const LayerFE::LayerSettings& lhs, const LayerFE::LayerSettings& rhs) {
-    return lhs.bufferId == rhs.bufferId && lhs.frameNumber == rhs.frameNumber &&
-            equalIgnoringBuffer(lhs, rhs);
+// The fingerprint must cover exactly the state that determines the rendered output, and must
+// exclude the buffer handle and the acquire fence: fences differ on every frame, and holding
+// the buffer would extend its lifetime. bufferId and frameNumber stand in for the buffer
+// content - the same buffer id with a new frame number may carry new pixels.
+size_t hashLayerSettings(const LayerFE::LayerSettings& settings) {
+    return hashCombine( // LayerFE::LayerSettings additions
+            settings.bufferId, settings.frameNumber,
+
+            // LayerSettings without LayerSettings.PixelSource
+            settings.geometry.boundaries, settings.geometry.positionTransform,
+            settings.geometry.roundedCornersRadius, settings.geometry.roundedCornersCrop,
+            settings.alpha, settings.sourceDataspace, settings.colorTransform,
+            settings.disableBlending, settings.shadow.boundaries, settings.shadow.ambientColor,
+            settings.shadow.spotColor, settings.shadow.lightPos, settings.shadow.lightRadius,
+            settings.shadow.length, settings.shadow.casterIsTranslucent,
+            settings.backgroundBlurRadius, settings.stretchEffect.width,
+            settings.stretchEffect.height, settings.stretchEffect.vectorX,
+            settings.stretchEffect.vectorY, settings.stretchEffect.maxAmountX,
+            settings.stretchEffect.maxAmountY,
+
+            // LayerSettings.PixelSource without buffer & fence
+            settings.source.solidColor, settings.source.buffer.textureName,
+            settings.source.buffer.useTextureFiltering, settings.source.buffer.textureTransform,
+            settings.source.buffer.usePremultipliedAlpha, settings.source.buffer.isOpaque,
+            settings.source.buffer.isY410BT2020, settings.source.buffer.maxLuminanceNits);
 }
 
-} // namespace
-
-ClientCompositionRequestCache::ClientCompositionRequest::ClientCompositionRequest(
-        const renderengine::DisplaySettings& initDisplay,
-        const std::vector<LayerFE::LayerSettings>& initLayerSettings)
-      : display(initDisplay) {
-    layerSettings.reserve(initLayerSettings.size());
-    for (const LayerFE::LayerSettings& settings : initLayerSettings) {
-        layerSettings.push_back(getLayerSettingsSnapshot(settings));
+size_t computeFingerprint(const renderengine::DisplaySettings& display,
+                          const std::vector<LayerFE::LayerSettings>& layerSettings) {
+    size_t hash = hashCombine(display.physicalDisplay, display.clip, display.maxLuminance,
+                              display.currentLuminanceNits, display.outputDataspace,
+                              display.colorTransform, display.deviceHandlesColorTransform,
+                              display.orientation, display.targetLuminanceNits,
+                              display.dimmingStage, display.renderIntent);
+    for (const LayerFE::LayerSettings& settings : layerSettings) {
+        hashCombineSingleHashed(hash, hashLayerSettings(settings));
     }
+    return hash;
 }
 
-bool ClientCompositionRequestCache::ClientCompositionRequest::equals(
-        const renderengine::DisplaySettings& newDisplay,
-        const std::vector<LayerFE::LayerSettings>& newLayerSettings) const {
-    return newDisplay == display &&
-            std::equal(layerSettings.begin(), layerSettings.end(), newLayerSettings.begin(),
-                       newLayerSettings.end(), layerSettingsAreEqual);
-}
+} // namespace
 
 bool ClientCompositionRequestCache::exists(
         uint64_t bufferId, const renderengine::DisplaySettings& display,
         const std::vector<LayerFE::LayerSettings>& layerSettings) const {
-    for (const auto& [cachedBufferId, cachedRequest] : mCache) {
+    const size_t fingerprint = computeFingerprint(display, layerSettings);
+    for (const auto& [cachedBufferId, cachedFingerprint] : mCache) {
         if (cachedBufferId == bufferId) {
-            return cachedRequest.equals(display, layerSettings);
+            return cachedFingerprint == fingerprint;
         }
     }
     return false;
@@ -100,10 +80,10 @@ bool ClientCompositionRequestCache::exists(
 void ClientCompositionRequestCache::add(uint64_t bufferId,
                                         const renderengine::DisplaySettings& display,
                                         const std::vector<LayerFE::LayerSettings>& layerSettings) {
-    const ClientCompositionRequest request(display, layerSettings);
-    for (auto& [cachedBufferId, cachedRequest] : mCache) {
+    const size_t fingerprint = computeFingerprint(display, layerSettings);
+    for (auto& [cachedBufferId, cachedFingerprint] : mCache) {
         if (cachedBufferId == bufferId) {
-            cachedRequest = std::move(request);
+            cachedFingerprint = fingerprint;
             return;
         }
     }
@@ -112,7 +92,7 @@ void ClientCompositionRequestCache::add(uint64_t bufferId,
         mCache.pop_front();
     }
 
-    mCache.emplace_back(bufferId, std::move(request));
+    mCache.emplace_back(bufferId, fingerprint);
 }
 
 void ClientCompositionRequestCache::remove(uint64_t bufferId) {
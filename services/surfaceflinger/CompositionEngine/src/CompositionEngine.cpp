@@ -21,6 +21,7 @@
 #include <compositionengine/impl/CompositionEngine.h>
 #include <compositionengine/impl/Display.h>
 
+#include <android-base/properties.h>
 #include <renderengine/RenderEngine.h>
 #include <utils/Trace.h>
 
@@ -43,7 +44,9 @@ std::unique_ptr<compositionengine::CompositionEngine> createCompositionEngine()
     return std::make_unique<CompositionEngine>();
 }
 
-CompositionEngine::CompositionEngine() = default;
+CompositionEngine::CompositionEngine()
+      : mParallelPresentEnabled(
+                base::GetBoolProperty(std::string("debug.sf.parallel_composition"), false)) {}
 CompositionEngine::~CompositionEngine() = default;
 
 std::shared_ptr<compositionengine::Display> CompositionEngine::createDisplay(
@@ -107,8 +110,41 @@ void CompositionEngine::present(CompositionRefreshArgs& args) {
 
     updateLayerStateFromFE(args);
 
-    for (const auto& output : args.outputs) {
-        output->present(args);
+    if (mParallelPresentEnabled && args.outputs.size() > 1) {
+        presentOutputsParallel(args);
+    } else {
+        for (const auto& output : args.outputs) {
+            output->present(args);
+        }
+    }
+}
+
+void CompositionEngine::presentOutputsParallel(CompositionRefreshArgs& args) {
+    ATRACE_CALL();
+
+    // One worker per additional output; the first output presents on this
+    // thread. The pool is grown lazily and kept for the lifetime of the engine
+    // since the output count changes rarely.
+    while (mPresentWorkers.size() < args.outputs.size() - 1) {
+        mPresentWorkers.push_back(std::make_unique<HwcAsyncWorker>());
+    }
+
+    std::vector<std::future<bool>> presentDone;
+    presentDone.reserve(args.outputs.size() - 1);
+    for (size_t i = 1; i < args.outputs.size(); i++) {
+        auto& output = args.outputs[i];
+        presentDone.push_back(mPresentWorkers[i - 1]->send([&args, &output]() {
+            output->present(args);
+            return true;
+        }));
+    }
+
+    args.outputs.front()->present(args);
+
+    // Join before returning so the coordinated frame-end work in the caller
+    // (fence bookkeeping, postComposition) sees every output fully presented.
+    for (auto& done : presentDone) {
+        done.wait();
     }
 }
 
@@ -152,6 +188,10 @@ void CompositionEngine::setNeedsAnotherUpdateForTest(bool value) {
     mNeedsAnotherUpdate = value;
 }
 
+void CompositionEngine::setParallelPresentForTest(bool value) {
+    mParallelPresentEnabled = value;
+}
+
 void CompositionEngine::updateLayerStateFromFE(CompositionRefreshArgs& args) {
     // Update the composition state from each front-end layer
     for (const auto& output : args.outputs) {
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include <android-base/stringprintf.h>
 #include <compositionengine/CompositionEngine.h>
 #include <compositionengine/CompositionRefreshArgs.h>
@@ -314,7 +316,11 @@ void Display::applyChangedTypesToLayers(const ChangedTypes& changedTypes) {
             continue;
         }
 
-        if (auto it = changedTypes.find(hwcLayer); it != changedTypes.end()) {
+        if (auto it = std::find_if(changedTypes.begin(), changedTypes.end(),
+                                   [hwcLayer](const auto& entry) {
+                                       return entry.first == hwcLayer;
+                                   });
+            it != changedTypes.end()) {
             layer->applyDeviceCompositionTypeChange(
                     static_cast<aidl::android::hardware::graphics::composer3::Composition>(
                             it->second));
@@ -338,7 +344,11 @@ void Display::applyLayerRequestsToLayers(const LayerRequests& layerRequests) {
             continue;
         }
 
-        if (auto it = layerRequests.find(hwcLayer); it != layerRequests.end()) {
+        if (auto it = std::find_if(layerRequests.begin(), layerRequests.end(),
+                                   [hwcLayer](const auto& entry) {
+                                       return entry.first == hwcLayer;
+                                   });
+            it != layerRequests.end()) {
             layer->applyDeviceLayerRequest(
                     static_cast<Hwc2::IComposerClient::LayerRequest>(it->second));
         }
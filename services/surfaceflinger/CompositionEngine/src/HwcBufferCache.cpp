@@ -28,9 +28,7 @@
 
 namespace android::compositionengine::impl {
 
-HwcBufferCache::HwcBufferCache() {
-    std::fill(std::begin(mBuffers), std::end(mBuffers), wp<GraphicBuffer>(nullptr));
-}
+HwcBufferCache::HwcBufferCache() = default;
 
 void HwcBufferCache::getHwcBuffer(int slot, const sp<GraphicBuffer>& buffer, uint32_t* outSlot,
                                   sp<GraphicBuffer>* outBuffer) {
@@ -42,16 +40,20 @@ void HwcBufferCache::getHwcBuffer(int slot, const sp<GraphicBuffer>& buffer, uin
         *outSlot = static_cast<uint32_t>(slot);
     }
 
-    auto& currentBuffer = mBuffers[*outSlot];
+    auto& entry = mBuffers[*outSlot];
     wp<GraphicBuffer> weakCopy(buffer);
-    if (currentBuffer == weakCopy) {
+    const uint64_t bufferId = buffer ? buffer->getId() : 0;
+    if (entry.buffer == weakCopy && entry.bufferId == bufferId) {
         // already cached in HWC, skip sending the buffer
+        ++mCacheHits;
         *outBuffer = nullptr;
     } else {
+        ++mCacheMisses;
         *outBuffer = buffer;
 
         // update cache
-        currentBuffer = buffer;
+        entry.buffer = buffer;
+        entry.bufferId = bufferId;
     }
 }
 
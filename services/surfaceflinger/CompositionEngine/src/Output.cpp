@@ -30,6 +30,7 @@
 #include <compositionengine/impl/OutputLayerCompositionState.h>
 #include <compositionengine/impl/planner/Planner.h>
 #include <ftl/future.h>
+#include <math/HashCombine.h>
 
 #include <thread>
 
@@ -464,6 +465,21 @@ void Output::rebuildLayerStacks(const compositionengine::CompositionRefreshArgs&
         return;
     }
 
+    // Latch the candidate layers' basic geometry and fingerprint the inputs to the coverage
+    // computation. If nothing affecting this output changed since the last rebuild - common
+    // when another output's layer stack triggered the update, or when a transaction dirtied
+    // visibility without actually moving anything - the result would be identical, so the
+    // per-layer Region arithmetic can be skipped.
+    const std::optional<size_t> fingerprint =
+            latchAndComputeCoverageFingerprint(refreshArgs, layerFESet);
+    if (fingerprint && fingerprint == mCoverageFingerprint) {
+        // Layers with queued frames that are not presented on any output still need their
+        // release fences, so this must happen even when the rebuild is skipped.
+        setReleasedLayers(refreshArgs);
+        return;
+    }
+    mCoverageFingerprint = fingerprint;
+
     // Process the layers to determine visibility and coverage
     compositionengine::Output::CoverageState coverage{layerFESet};
     collectVisibleLayers(refreshArgs, coverage);
@@ -477,6 +493,52 @@ void Output::rebuildLayerStacks(const compositionengine::CompositionRefreshArgs&
     outputState.dirtyRegion.orSelf(coverage.dirtyRegion);
 }
 
+std::optional<size_t> Output::latchAndComputeCoverageFingerprint(
+        const compositionengine::CompositionRefreshArgs& refreshArgs, LayerFESet& layerFESet) {
+    const auto& outputState = getState();
+    const ui::Transform& tr = outputState.transform;
+    size_t fingerprint =
+            hashCombine(tr.tx(), tr.ty(), tr.dsdx(), tr.dtdx(), tr.dtdy(), tr.dsdy(),
+                        outputState.displaySpace.getBoundsAsRect(),
+                        outputState.layerStackSpace.getContent());
+
+    bool upToDate = true;
+    for (auto layerFE : reversed(refreshArgs.layers)) {
+        // Latch the basic geometry snapshot here rather than in
+        // ensureOutputLayerIfVisible, still at most once per frame for each
+        // candidate layer via the shared set.
+        if (!layerFESet.count(layerFE)) {
+            layerFESet.insert(layerFE);
+            layerFE->prepareCompositionState(compositionengine::LayerFE::StateSubset::BasicGeometry);
+        }
+
+        if (!includesLayer(layerFE)) {
+            continue;
+        }
+
+        const auto* layerFEState = layerFE->getCompositionState();
+        if (CC_UNLIKELY(!layerFEState) || layerFEState->contentDirty) {
+            // Dirty content must contribute to the output dirty region, so the
+            // coverage result cannot be reused. Keep iterating so the remaining
+            // candidate layers are still latched.
+            upToDate = false;
+            continue;
+        }
+
+        const ui::Transform& layerTr = layerFEState->geomLayerTransform;
+        hashCombineSingleHashed(fingerprint,
+                                hashCombine(layerFE.get(), layerFEState->isVisible,
+                                            layerFEState->isOpaque, layerFEState->shadowRadius,
+                                            layerFEState->geomLayerBounds,
+                                            layerFEState->transparentRegionHint,
+                                            layerFEState->compositionType, layerTr.tx(),
+                                            layerTr.ty(), layerTr.dsdx(), layerTr.dtdx(),
+                                            layerTr.dtdy(), layerTr.dsdy()));
+    }
+
+    return upToDate ? std::make_optional(fingerprint) : std::nullopt;
+}
+
 void Output::collectVisibleLayers(const compositionengine::CompositionRefreshArgs& refreshArgs,
                                   compositionengine::Output::CoverageState& coverage) {
     // Evaluate the layers from front to back to determine what is visible. This
@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
+#include <android-base/stringprintf.h>
 #include <compositionengine/impl/DumpHelpers.h>
 #include <compositionengine/impl/OutputLayerCompositionState.h>
 
+#include <cinttypes>
+
 // TODO(b/129481165): remove the #pragma below and fix conversion issues
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wconversion"
@@ -40,6 +43,17 @@ void dumpHwc(const OutputLayerCompositionState::Hwc& hwc, std::string& out) {
     }
 
     dumpVal(out, "composition", toString(hwc.hwcCompositionType), hwc.hwcCompositionType);
+
+    const uint64_t hits = hwc.hwcBufferCache.getHitCount();
+    const uint64_t misses = hwc.hwcBufferCache.getMissCount();
+    const uint64_t lookups = hits + misses;
+    // A persistently high miss rate means the layer cycles through more unique buffers than
+    // there are cache slots and pays the full buffer import cost every frame.
+    base::StringAppendF(&out, "bufferCache hits=%" PRIu64 " misses=%" PRIu64 " (%.1f%% misses) ",
+                        hits, misses,
+                        lookups > 0
+                                ? 100.f * static_cast<float>(misses) / static_cast<float>(lookups)
+                                : 0.f);
 }
 
 } // namespace
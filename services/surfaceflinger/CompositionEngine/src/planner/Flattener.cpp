@@ -77,6 +77,7 @@ NonBufferHash Flattener::flattenLayers(const std::vector<const LayerState*>& lay
     if (mCurrentGeometry != hash || (!mLayers.empty() && !isSameStack(layers, mLayers))) {
         resetActivities(hash, now);
         mFlattenedDisplayCost += unflattenedDisplayCost;
+        ++mCacheMissFrames;
         return hash;
     }
 
@@ -189,6 +190,20 @@ void Flattener::dump(std::string& result) const {
     base::StringAppendF(&result, "    Cost: %.2f\n",
                         static_cast<float>(mCachedSetCreationCost) / displayArea);
 
+    const size_t totalFrames = mCacheHitFrames + mCacheMissFrames;
+    base::StringAppendF(&result, "\n    Cache hit frames: %zd (%.2f%% of %zd frames)\n",
+                        mCacheHitFrames,
+                        totalFrames > 0 ? 100.f * static_cast<float>(mCacheHitFrames) /
+                                        static_cast<float>(totalFrames)
+                                        : 0.f,
+                        totalFrames);
+    // The display-cost delta is the closest proxy we have for GPU/DPU time saved by
+    // compositing from cached sets instead of the constituent layers.
+    base::StringAppendF(&result, "    Display cost saved (in screen-size buffers): %.2f\n",
+                        (static_cast<float>(mUnflattenedDisplayCost) -
+                         static_cast<float>(mFlattenedDisplayCost)) /
+                                displayArea);
+
     const auto lastUpdate =
             std::chrono::duration_cast<std::chrono::milliseconds>(now - mLastGeometryUpdate);
     base::StringAppendF(&result, "\n  Current hash %016zx, last update %sago\n\n", mCurrentGeometry,
@@ -269,9 +284,14 @@ bool Flattener::mergeWithCachedSets(const std::vector<const LayerState*>& layers
             mFlattenedDisplayCost += merged.back().getDisplayCost();
         }
         mLayers = std::move(merged);
+        ++mCacheMissFrames;
         return false;
     }
 
+    // Tracks whether this frame composited from at least one multi-layer cached set, for the
+    // cache hit statistics.
+    bool reusedFlattenedSet = false;
+
     // the compiler should strip out the following no-op loops when ALOGV is off
     ALOGV("[%s] Incoming layers:", __func__);
     for (const LayerState* layer : layers) {
@@ -305,6 +325,7 @@ bool Flattener::mergeWithCachedSets(const std::vector<const LayerState*>& layers
                 mNewCachedSet = std::nullopt;
             } else if (mNewCachedSet->hasReadyBuffer()) {
                 ALOGV("[%s] Found ready buffer", __func__);
+                reusedFlattenedSet = true;
                 size_t skipCount = mNewCachedSet->getLayerCount();
                 while (skipCount != 0) {
                     auto* peekThroughLayer = mNewCachedSet->getHolePunchLayer();
@@ -348,6 +369,9 @@ bool Flattener::mergeWithCachedSets(const std::vector<const LayerState*>& layers
 
             // Skip the incoming layers corresponding to this valid current layer
             const size_t layerCount = currentLayerIter->getLayerCount();
+            if (layerCount > 1) {
+                reusedFlattenedSet = true;
+            }
             auto* peekThroughLayer = currentLayerIter->getHolePunchLayer();
             for (size_t i = 0; i < layerCount; ++i) {
                 bool disableBlur =
@@ -398,6 +422,12 @@ bool Flattener::mergeWithCachedSets(const std::vector<const LayerState*>& layers
         mFlattenedDisplayCost += layer.getDisplayCost();
     }
 
+    if (reusedFlattenedSet) {
+        ++mCacheHitFrames;
+    } else {
+        ++mCacheMissFrames;
+    }
+
     mLayers = std::move(merged);
     return true;
 }
@@ -475,8 +505,36 @@ std::optional<Flattener::Run> Flattener::findBestRun(std::vector<Flattener::Run>
         return std::nullopt;
     }
 
-    // TODO (b/181192467): Choose the best run, instead of just the first.
-    return runs[0];
+    // Choose the highest-scoring run that fits within the flattened-layer cap. A run's score
+    // is the number of layers it would remove from composition, optionally weighted by how
+    // long those layers' buffers have been stable (see Tunables::mStabilityWeight).
+    std::optional<Run> bestRun;
+    float bestScore = 0.f;
+    for (const Run& run : runs) {
+        if (run.getLayerLength() > mTunables.mMaxFlattenedLayers) {
+            continue;
+        }
+
+        int64_t framesSinceBufferUpdate = 0;
+        size_t layersSeen = 0;
+        for (auto set = run.getStart(); layersSeen < run.getLayerLength(); ++set) {
+            for (const auto& layer : set->getConstituentLayers()) {
+                framesSinceBufferUpdate += layer.getState()->getFramesSinceBufferUpdate();
+            }
+            layersSeen += set->getLayerCount();
+        }
+        const float meanFramesSinceBufferUpdate = static_cast<float>(framesSinceBufferUpdate) /
+                static_cast<float>(run.getLayerLength());
+
+        const float score = static_cast<float>(run.getLayerLength()) *
+                (1.f + mTunables.mStabilityWeight * meanFramesSinceBufferUpdate);
+        if (score > bestScore) {
+            bestScore = score;
+            bestRun.emplace(run);
+        }
+    }
+
+    return bestRun;
 }
 
 void Flattener::buildCachedSets(time_point now) {
@@ -27,6 +27,7 @@
 
 #include <utils/Trace.h>
 #include <chrono>
+#include <cstdlib>
 
 namespace android::compositionengine::impl::planner {
 
@@ -53,18 +54,67 @@ std::optional<Flattener::Tunables::RenderScheduling> buildRenderSchedulingTunabl
             });
 }
 
+float getFloatProperty(const std::string& name, float defaultValue) {
+    const std::string value = base::GetProperty(name, "");
+    if (value.empty()) {
+        return defaultValue;
+    }
+    char* end = nullptr;
+    const float parsed = std::strtof(value.c_str(), &end);
+    return end != value.c_str() ? parsed : defaultValue;
+}
+
+// Baseline tunable values for a device profile, selected via
+// debug.sf.layer_caching_profile. Individual sysprops below still override the
+// profile's baseline, so a profile only changes the defaults.
+struct FlattenerProfile {
+    std::chrono::milliseconds activeLayerTimeout = Flattener::Tunables::kDefaultActiveLayerTimeout;
+    size_t maxFlattenedLayers = Flattener::Tunables::kDefaultMaxFlattenedLayers;
+    float stabilityWeight = Flattener::Tunables::kDefaultStabilityWeight;
+};
+
+FlattenerProfile getFlattenerProfile() {
+    const std::string profile =
+            base::GetProperty(std::string("debug.sf.layer_caching_profile"), "default");
+    if (profile == "aggressive") {
+        // For devices with weak GPUs: consider layers inactive sooner, and prefer
+        // flattening runs of long-stable content over merely long runs.
+        return {.activeLayerTimeout = 50ms, .stabilityWeight = 0.05f};
+    }
+    if (profile == "conservative") {
+        // For devices where cached-set rendering competes with frame rendering: wait
+        // longer before flattening and keep the invalidation blast radius small.
+        return {.activeLayerTimeout = 500ms, .maxFlattenedLayers = 4};
+    }
+    if (profile != "default") {
+        ALOGW("Ignoring unknown layer caching profile '%s'", profile.c_str());
+    }
+    return {};
+}
+
 Flattener::Tunables buildFlattenerTuneables() {
+    const FlattenerProfile profile = getFlattenerProfile();
+
     const auto activeLayerTimeout = std::chrono::milliseconds(
             base::GetIntProperty<int32_t>(std::string(
                                                   "debug.sf.layer_caching_active_layer_timeout_ms"),
-                                          Flattener::Tunables::kDefaultActiveLayerTimeout.count()));
+                                          profile.activeLayerTimeout.count()));
     const auto enableHolePunch =
             base::GetBoolProperty(std::string("debug.sf.enable_hole_punch_pip"),
                                   Flattener::Tunables::kDefaultEnableHolePunch);
+    const auto maxFlattenedLayers =
+            base::GetUintProperty<size_t>(std::string(
+                                                  "debug.sf.layer_caching_max_flattened_layers"),
+                                          profile.maxFlattenedLayers);
+    const auto stabilityWeight =
+            getFloatProperty(std::string("debug.sf.layer_caching_stability_weight"),
+                             profile.stabilityWeight);
     return Flattener::Tunables{
             .mActiveLayerTimeout = activeLayerTimeout,
             .mRenderScheduling = buildRenderSchedulingTunables(),
             .mEnableHolePunch = enableHolePunch,
+            .mMaxFlattenedLayers = maxFlattenedLayers,
+            .mStabilityWeight = stabilityWeight,
     };
 }
 
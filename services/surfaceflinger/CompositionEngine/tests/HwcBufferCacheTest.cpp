@@ -82,5 +82,24 @@ TEST_F(HwcBufferCacheTest, cacheMapsNegativeSlotToZero) {
     testSlot(-123, 0);
 }
 
+TEST_F(HwcBufferCacheTest, cacheCountsHitsAndMisses) {
+    uint32_t outSlot;
+    sp<GraphicBuffer> outBuffer;
+
+    mCache.getHwcBuffer(0, mBuffer1, &outSlot, &outBuffer);
+    EXPECT_EQ(0u, mCache.getHitCount());
+    EXPECT_EQ(1u, mCache.getMissCount());
+
+    mCache.getHwcBuffer(0, mBuffer1, &outSlot, &outBuffer);
+    EXPECT_EQ(1u, mCache.getHitCount());
+    EXPECT_EQ(1u, mCache.getMissCount());
+
+    // A different buffer reusing the slot must be re-sent to the HAL and counts as a miss.
+    mCache.getHwcBuffer(0, mBuffer2, &outSlot, &outBuffer);
+    EXPECT_EQ(mBuffer2, outBuffer);
+    EXPECT_EQ(1u, mCache.getHitCount());
+    EXPECT_EQ(2u, mCache.getMissCount());
+}
+
 } // namespace
 } // namespace android::compositionengine
@@ -42,6 +42,7 @@ public:
     MOCK_METHOD1(setCallback, void(HWC2::ComposerCallback&));
     MOCK_CONST_METHOD3(getDisplayIdentificationData,
                        bool(hal::HWDisplayId, uint8_t*, DisplayIdentificationData*));
+    MOCK_METHOD1(prefetchDisplayIdentificationData, void(hal::HWDisplayId));
     MOCK_CONST_METHOD1(hasCapability,
                        bool(aidl::android::hardware::graphics::composer3::Capability));
     MOCK_CONST_METHOD2(hasDisplayCapability,
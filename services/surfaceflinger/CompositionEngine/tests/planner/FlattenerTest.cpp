@@ -1133,6 +1133,46 @@ TEST_F(FlattenerRenderSchedulingTest, flattenLayers_renderCachedSets_defersUpToM
                                  true);
 }
 
+const constexpr size_t kMaxFlattenedLayers = 2;
+
+class FlattenerMaxFlattenedLayersTest : public FlattenerTest {
+public:
+    FlattenerMaxFlattenedLayersTest()
+          : FlattenerTest(Flattener::Tunables{.mActiveLayerTimeout = 100ms,
+                                              .mRenderScheduling = std::nullopt,
+                                              .mEnableHolePunch = true,
+                                              .mMaxFlattenedLayers = kMaxFlattenedLayers}) {}
+};
+
+TEST_F(FlattenerMaxFlattenedLayersTest, flattenLayers_doesNotFlattenRunsOverTheCap) {
+    auto& layerState1 = mTestLayers[0]->layerState;
+    auto& layerState2 = mTestLayers[1]->layerState;
+    auto& layerState3 = mTestLayers[2]->layerState;
+
+    const std::vector<const LayerState*> layers = {
+            layerState1.get(),
+            layerState2.get(),
+            layerState3.get(),
+    };
+
+    initializeFlattener(layers);
+
+    // All three layers are inactive, but the run exceeds the flattened-layer cap, so no
+    // cached set may be built.
+    mTime += 200ms;
+
+    EXPECT_CALL(mRenderEngine, drawLayers(_, _, _, _, _)).Times(0);
+
+    initializeOverrideBuffer(layers);
+    EXPECT_EQ(getNonBufferHash(layers),
+              mFlattener->flattenLayers(layers, getNonBufferHash(layers), mTime));
+    mFlattener->renderCachedSets(mOutputState, std::nullopt, true);
+
+    for (const auto layer : layers) {
+        EXPECT_EQ(nullptr, layer->getOutputLayer()->getState().overrideInfo.buffer);
+    }
+}
+
 TEST_F(FlattenerTest, flattenLayers_skipsBT601_625) {
     auto& layerState1 = mTestLayers[0]->layerState;
     const auto& overrideBuffer1 = layerState1->getOutputLayer()->getState().overrideInfo.buffer;
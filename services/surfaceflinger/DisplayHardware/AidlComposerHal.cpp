@@ -294,11 +294,30 @@ void AidlComposer::registerCallback(HWC2::ComposerCallback& callback) {
 }
 
 void AidlComposer::resetCommands() {
-    mWriter.reset();
+    std::lock_guard lock(mMutex);
+    for (auto& [_, writer] : mWriters) {
+        writer.reset();
+    }
 }
 
 Error AidlComposer::executeCommands() {
-    return execute();
+    std::vector<int64_t> displays;
+    {
+        std::lock_guard lock(mMutex);
+        displays.reserve(mWriters.size());
+        for (const auto& [display, _] : mWriters) {
+            displays.push_back(display);
+        }
+    }
+
+    Error error = Error::NONE;
+    for (const auto display : displays) {
+        const auto displayError = execute(translate<Display>(display));
+        if (displayError != Error::NONE) {
+            error = displayError;
+        }
+    }
+    return error;
 }
 
 uint32_t AidlComposer::getMaxVirtualDisplayCount() {
@@ -338,11 +357,12 @@ Error AidlComposer::destroyVirtualDisplay(Display display) {
         ALOGE("destroyVirtualDisplay failed %s", status.getDescription().c_str());
         return static_cast<Error>(status.getServiceSpecificError());
     }
+    removeDisplay(display);
     return Error::NONE;
 }
 
 Error AidlComposer::acceptDisplayChanges(Display display) {
-    mWriter.acceptDisplayChanges(translate<int64_t>(display));
+    getWriter(display).acceptDisplayChanges(translate<int64_t>(display));
     return Error::NONE;
 }
 
@@ -383,7 +403,8 @@ Error AidlComposer::getActiveConfig(Display display, Config* outConfig) {
 Error AidlComposer::getChangedCompositionTypes(
         Display display, std::vector<Layer>* outLayers,
         std::vector<aidl::android::hardware::graphics::composer3::Composition>* outTypes) {
-    const auto changedLayers = mReader.takeChangedCompositionTypes(translate<int64_t>(display));
+    const auto changedLayers =
+            getReader(display).takeChangedCompositionTypes(translate<int64_t>(display));
     outLayers->reserve(changedLayers.size());
     outTypes->reserve(changedLayers.size());
 
@@ -443,7 +464,8 @@ Error AidlComposer::getDisplayName(Display display, std::string* outName) {
 Error AidlComposer::getDisplayRequests(Display display, uint32_t* outDisplayRequestMask,
                                        std::vector<Layer>* outLayers,
                                        std::vector<uint32_t>* outLayerRequestMasks) {
-    const auto displayRequests = mReader.takeDisplayRequests(translate<int64_t>(display));
+    const auto displayRequests =
+            getReader(display).takeDisplayRequests(translate<int64_t>(display));
     *outDisplayRequestMask = translate<uint32_t>(displayRequests.mask);
     outLayers->reserve(displayRequests.layerRequests.size());
     outLayerRequestMasks->reserve(displayRequests.layerRequests.size());
@@ -501,7 +523,7 @@ Error AidlComposer::getHdrCapabilities(Display display, std::vector<Hdr>* outTyp
 
 Error AidlComposer::getReleaseFences(Display display, std::vector<Layer>* outLayers,
                                      std::vector<int>* outReleaseFences) {
-    auto fences = mReader.takeReleaseFences(translate<int64_t>(display));
+    auto fences = getReader(display).takeReleaseFences(translate<int64_t>(display));
     outLayers->reserve(fences.size());
     outReleaseFences->reserve(fences.size());
 
@@ -517,14 +539,14 @@ Error AidlComposer::getReleaseFences(Display display, std::vector<Layer>* outLay
 
 Error AidlComposer::presentDisplay(Display display, int* outPresentFence) {
     ATRACE_NAME("HwcPresentDisplay");
-    mWriter.presentDisplay(translate<int64_t>(display));
+    getWriter(display).presentDisplay(translate<int64_t>(display));
 
-    Error error = execute();
+    Error error = execute(display);
     if (error != Error::NONE) {
         return error;
     }
 
-    auto fence = mReader.takePresentFence(translate<int64_t>(display));
+    auto fence = getReader(display).takePresentFence(translate<int64_t>(display));
     // take ownership
     *outPresentFence = fence.get();
     *fence.getR() = -1;
@@ -549,10 +571,10 @@ Error AidlComposer::setClientTarget(Display display, uint32_t slot, const sp<Gra
         handle = target->getNativeBuffer()->handle;
     }
 
-    mWriter.setClientTarget(translate<int64_t>(display), slot, handle, acquireFence,
-                            translate<aidl::android::hardware::graphics::common::Dataspace>(
-                                    dataspace),
-                            translate<AidlRect>(damage));
+    getWriter(display).setClientTarget(
+            translate<int64_t>(display), slot, handle, acquireFence,
+            translate<aidl::android::hardware::graphics::common::Dataspace>(dataspace),
+            translate<AidlRect>(damage));
     return Error::NONE;
 }
 
@@ -569,13 +591,13 @@ Error AidlComposer::setColorMode(Display display, ColorMode mode, RenderIntent r
 }
 
 Error AidlComposer::setColorTransform(Display display, const float* matrix) {
-    mWriter.setColorTransform(translate<int64_t>(display), matrix);
+    getWriter(display).setColorTransform(translate<int64_t>(display), matrix);
     return Error::NONE;
 }
 
 Error AidlComposer::setOutputBuffer(Display display, const native_handle_t* buffer,
                                     int releaseFence) {
-    mWriter.setOutputBuffer(translate<int64_t>(display), 0, buffer, dup(releaseFence));
+    getWriter(display).setOutputBuffer(translate<int64_t>(display), 0, buffer, dup(releaseFence));
     return Error::NONE;
 }
 
@@ -614,15 +636,15 @@ Error AidlComposer::setClientTargetSlotCount(Display display) {
 Error AidlComposer::validateDisplay(Display display, nsecs_t expectedPresentTime,
                                     uint32_t* outNumTypes, uint32_t* outNumRequests) {
     ATRACE_NAME("HwcValidateDisplay");
-    mWriter.validateDisplay(translate<int64_t>(display),
-                            ClockMonotonicTimestamp{expectedPresentTime});
+    getWriter(display).validateDisplay(translate<int64_t>(display),
+                                       ClockMonotonicTimestamp{expectedPresentTime});
 
-    Error error = execute();
+    Error error = execute(display);
     if (error != Error::NONE) {
         return error;
     }
 
-    mReader.hasChanges(translate<int64_t>(display), outNumTypes, outNumRequests);
+    getReader(display).hasChanges(translate<int64_t>(display), outNumTypes, outNumRequests);
 
     return Error::NONE;
 }
@@ -631,15 +653,16 @@ Error AidlComposer::presentOrValidateDisplay(Display display, nsecs_t expectedPr
                                              uint32_t* outNumTypes, uint32_t* outNumRequests,
                                              int* outPresentFence, uint32_t* state) {
     ATRACE_NAME("HwcPresentOrValidateDisplay");
-    mWriter.presentOrvalidateDisplay(translate<int64_t>(display),
-                                     ClockMonotonicTimestamp{expectedPresentTime});
+    getWriter(display).presentOrvalidateDisplay(translate<int64_t>(display),
+                                                ClockMonotonicTimestamp{expectedPresentTime});
 
-    Error error = execute();
+    Error error = execute(display);
     if (error != Error::NONE) {
         return error;
     }
 
-    const auto result = mReader.takePresentOrValidateStage(translate<int64_t>(display));
+    auto& reader = getReader(display);
+    const auto result = reader.takePresentOrValidateStage(translate<int64_t>(display));
     if (!result.has_value()) {
         *state = translate<uint32_t>(-1);
         return Error::NO_RESOURCES;
@@ -648,21 +671,22 @@ Error AidlComposer::presentOrValidateDisplay(Display display, nsecs_t expectedPr
     *state = translate<uint32_t>(*result);
 
     if (*result == PresentOrValidate::Result::Presented) {
-        auto fence = mReader.takePresentFence(translate<int64_t>(display));
+        auto fence = reader.takePresentFence(translate<int64_t>(display));
         // take ownership
         *outPresentFence = fence.get();
         *fence.getR() = -1;
     }
 
     if (*result == PresentOrValidate::Result::Validated) {
-        mReader.hasChanges(translate<int64_t>(display), outNumTypes, outNumRequests);
+        reader.hasChanges(translate<int64_t>(display), outNumTypes, outNumRequests);
     }
 
     return Error::NONE;
 }
 
 Error AidlComposer::setCursorPosition(Display display, Layer layer, int32_t x, int32_t y) {
-    mWriter.setLayerCursorPosition(translate<int64_t>(display), translate<int64_t>(layer), x, y);
+    getWriter(display).setLayerCursorPosition(translate<int64_t>(display),
+                                              translate<int64_t>(layer), x, y);
     return Error::NONE;
 }
 
@@ -673,90 +697,96 @@ Error AidlComposer::setLayerBuffer(Display display, Layer layer, uint32_t slot,
         handle = buffer->getNativeBuffer()->handle;
     }
 
-    mWriter.setLayerBuffer(translate<int64_t>(display), translate<int64_t>(layer), slot, handle,
-                           acquireFence);
+    getWriter(display).setLayerBuffer(translate<int64_t>(display), translate<int64_t>(layer),
+                                      slot, handle, acquireFence);
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerSurfaceDamage(Display display, Layer layer,
                                           const std::vector<IComposerClient::Rect>& damage) {
-    mWriter.setLayerSurfaceDamage(translate<int64_t>(display), translate<int64_t>(layer),
-                                  translate<AidlRect>(damage));
+    getWriter(display).setLayerSurfaceDamage(translate<int64_t>(display), translate<int64_t>(layer),
+                                             translate<AidlRect>(damage));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerBlendMode(Display display, Layer layer,
                                       IComposerClient::BlendMode mode) {
-    mWriter.setLayerBlendMode(translate<int64_t>(display), translate<int64_t>(layer),
-                              translate<BlendMode>(mode));
+    getWriter(display).setLayerBlendMode(translate<int64_t>(display), translate<int64_t>(layer),
+                                         translate<BlendMode>(mode));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerColor(Display display, Layer layer, const Color& color) {
-    mWriter.setLayerColor(translate<int64_t>(display), translate<int64_t>(layer), color);
+    getWriter(display).setLayerColor(translate<int64_t>(display), translate<int64_t>(layer), color);
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerCompositionType(
         Display display, Layer layer,
         aidl::android::hardware::graphics::composer3::Composition type) {
-    mWriter.setLayerCompositionType(translate<int64_t>(display), translate<int64_t>(layer), type);
+    getWriter(display).setLayerCompositionType(translate<int64_t>(display),
+                                               translate<int64_t>(layer), type);
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerDataspace(Display display, Layer layer, Dataspace dataspace) {
-    mWriter.setLayerDataspace(translate<int64_t>(display), translate<int64_t>(layer),
-                              translate<AidlDataspace>(dataspace));
+    getWriter(display).setLayerDataspace(translate<int64_t>(display), translate<int64_t>(layer),
+                                         translate<AidlDataspace>(dataspace));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerDisplayFrame(Display display, Layer layer,
                                          const IComposerClient::Rect& frame) {
-    mWriter.setLayerDisplayFrame(translate<int64_t>(display), translate<int64_t>(layer),
-                                 translate<AidlRect>(frame));
+    getWriter(display).setLayerDisplayFrame(translate<int64_t>(display), translate<int64_t>(layer),
+                                            translate<AidlRect>(frame));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerPlaneAlpha(Display display, Layer layer, float alpha) {
-    mWriter.setLayerPlaneAlpha(translate<int64_t>(display), translate<int64_t>(layer), alpha);
+    getWriter(display).setLayerPlaneAlpha(translate<int64_t>(display), translate<int64_t>(layer),
+                                          alpha);
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerSidebandStream(Display display, Layer layer,
                                            const native_handle_t* stream) {
-    mWriter.setLayerSidebandStream(translate<int64_t>(display), translate<int64_t>(layer), stream);
+    getWriter(display).setLayerSidebandStream(translate<int64_t>(display),
+                                              translate<int64_t>(layer), stream);
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerSourceCrop(Display display, Layer layer,
                                        const IComposerClient::FRect& crop) {
-    mWriter.setLayerSourceCrop(translate<int64_t>(display), translate<int64_t>(layer),
-                               translate<AidlFRect>(crop));
+    getWriter(display).setLayerSourceCrop(translate<int64_t>(display), translate<int64_t>(layer),
+                                          translate<AidlFRect>(crop));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerTransform(Display display, Layer layer, Transform transform) {
-    mWriter.setLayerTransform(translate<int64_t>(display), translate<int64_t>(layer),
-                              translate<AidlTransform>(transform));
+    getWriter(display).setLayerTransform(translate<int64_t>(display), translate<int64_t>(layer),
+                                         translate<AidlTransform>(transform));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerVisibleRegion(Display display, Layer layer,
                                           const std::vector<IComposerClient::Rect>& visible) {
-    mWriter.setLayerVisibleRegion(translate<int64_t>(display), translate<int64_t>(layer),
-                                  translate<AidlRect>(visible));
+    getWriter(display).setLayerVisibleRegion(translate<int64_t>(display), translate<int64_t>(layer),
+                                             translate<AidlRect>(visible));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerZOrder(Display display, Layer layer, uint32_t z) {
-    mWriter.setLayerZOrder(translate<int64_t>(display), translate<int64_t>(layer), z);
+    getWriter(display).setLayerZOrder(translate<int64_t>(display), translate<int64_t>(layer), z);
     return Error::NONE;
 }
 
-Error AidlComposer::execute() {
-    const auto& commands = mWriter.getPendingCommands();
+Error AidlComposer::execute(Display display) {
+    auto& writer = getWriter(display);
+    auto& reader = getReader(display);
+
+    const auto& commands = writer.getPendingCommands();
     if (commands.empty()) {
-        mWriter.reset();
+        writer.reset();
         return Error::NONE;
     }
 
@@ -768,9 +798,9 @@ Error AidlComposer::execute() {
             return static_cast<Error>(status.getServiceSpecificError());
         }
 
-        mReader.parse(std::move(results));
+        reader.parse(std::move(results));
     }
-    const auto commandErrors = mReader.takeErrors();
+    const auto commandErrors = reader.takeErrors();
     Error error = Error::NONE;
     for (const auto& cmdErr : commandErrors) {
         const auto index = static_cast<size_t>(cmdErr.commandIndex);
@@ -788,16 +818,33 @@ Error AidlComposer::execute() {
         }
     }
 
-    mWriter.reset();
+    writer.reset();
 
     return error;
 }
 
+ComposerClientWriter& AidlComposer::getWriter(Display display) {
+    std::lock_guard lock(mMutex);
+    return mWriters[translate<int64_t>(display)];
+}
+
+ComposerClientReader& AidlComposer::getReader(Display display) {
+    std::lock_guard lock(mMutex);
+    return mReaders[translate<int64_t>(display)];
+}
+
+void AidlComposer::removeDisplay(Display display) {
+    std::lock_guard lock(mMutex);
+    mWriters.erase(translate<int64_t>(display));
+    mReaders.erase(translate<int64_t>(display));
+}
+
 Error AidlComposer::setLayerPerFrameMetadata(
         Display display, Layer layer,
         const std::vector<IComposerClient::PerFrameMetadata>& perFrameMetadatas) {
-    mWriter.setLayerPerFrameMetadata(translate<int64_t>(display), translate<int64_t>(layer),
-                                     translate<AidlPerFrameMetadata>(perFrameMetadatas));
+    getWriter(display).setLayerPerFrameMetadata(translate<int64_t>(display),
+                                                translate<int64_t>(layer),
+                                                translate<AidlPerFrameMetadata>(perFrameMetadatas));
     return Error::NONE;
 }
 
@@ -858,7 +905,8 @@ Error AidlComposer::getDisplayIdentificationData(Display display, uint8_t* outPo
 }
 
 Error AidlComposer::setLayerColorTransform(Display display, Layer layer, const float* matrix) {
-    mWriter.setLayerColorTransform(translate<int64_t>(display), translate<int64_t>(layer), matrix);
+    getWriter(display).setLayerColorTransform(translate<int64_t>(display),
+                                              translate<int64_t>(layer), matrix);
     return Error::NONE;
 }
 
@@ -922,17 +970,19 @@ Error AidlComposer::getDisplayedContentSample(Display display, uint64_t maxFrame
 Error AidlComposer::setLayerPerFrameMetadataBlobs(
         Display display, Layer layer,
         const std::vector<IComposerClient::PerFrameMetadataBlob>& metadata) {
-    mWriter.setLayerPerFrameMetadataBlobs(translate<int64_t>(display), translate<int64_t>(layer),
-                                          translate<AidlPerFrameMetadataBlob>(metadata));
+    getWriter(display).setLayerPerFrameMetadataBlobs(translate<int64_t>(display),
+                                                     translate<int64_t>(layer),
+                                                     translate<AidlPerFrameMetadataBlob>(metadata));
     return Error::NONE;
 }
 
 Error AidlComposer::setDisplayBrightness(Display display, float brightness, float brightnessNits,
                                          const DisplayBrightnessOptions& options) {
-    mWriter.setDisplayBrightness(translate<int64_t>(display), brightness, brightnessNits);
+    getWriter(display).setDisplayBrightness(translate<int64_t>(display), brightness,
+                                            brightnessNits);
 
     if (options.applyImmediately) {
-        return execute();
+        return execute(display);
     }
 
     return Error::NONE;
@@ -1075,19 +1125,22 @@ Error AidlComposer::getPreferredBootDisplayConfig(Display display, Config* confi
 
 Error AidlComposer::getClientTargetProperty(
         Display display, ClientTargetPropertyWithBrightness* outClientTargetProperty) {
-    *outClientTargetProperty = mReader.takeClientTargetProperty(translate<int64_t>(display));
+    *outClientTargetProperty =
+            getReader(display).takeClientTargetProperty(translate<int64_t>(display));
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerBrightness(Display display, Layer layer, float brightness) {
-    mWriter.setLayerBrightness(translate<int64_t>(display), translate<int64_t>(layer), brightness);
+    getWriter(display).setLayerBrightness(translate<int64_t>(display), translate<int64_t>(layer),
+                                          brightness);
     return Error::NONE;
 }
 
 Error AidlComposer::setLayerBlockingRegion(Display display, Layer layer,
                                            const std::vector<IComposerClient::Rect>& blocking) {
-    mWriter.setLayerBlockingRegion(translate<int64_t>(display), translate<int64_t>(layer),
-                                   translate<AidlRect>(blocking));
+    getWriter(display).setLayerBlockingRegion(translate<int64_t>(display),
+                                              translate<int64_t>(layer),
+                                              translate<AidlRect>(blocking));
     return Error::NONE;
 }
 
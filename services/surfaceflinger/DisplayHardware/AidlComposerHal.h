@@ -18,12 +18,15 @@
 
 #include "ComposerHal.h"
 
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include <android-base/thread_annotations.h>
+
 // TODO(b/129481165): remove the #pragma below and fix conversion issues
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wconversion"
@@ -230,8 +233,15 @@ public:
 private:
     // Many public functions above simply write a command into the command
     // queue to batch the calls.  validateDisplay and presentDisplay will call
-    // this function to execute the command queue.
-    Error execute();
+    // this function to execute the commands queued for their display.
+    Error execute(Display display) EXCLUDES(mMutex);
+
+    // Returns the command writer/reader for a display, creating them on first
+    // use. The maps are node-based, so the returned references stay valid
+    // while other displays are added or removed.
+    ComposerClientWriter& getWriter(Display display) EXCLUDES(mMutex);
+    ComposerClientReader& getReader(Display display) EXCLUDES(mMutex);
+    void removeDisplay(Display display) EXCLUDES(mMutex);
 
     // returns the default instance name for the given service
     static std::string instance(const std::string& serviceName);
@@ -243,8 +253,14 @@ private:
     // 1. Tightly coupling this cache to the max size of BufferQueue
     // 2. Adding an additional slot for the layer caching feature in SurfaceFlinger (see: Planner.h)
     static const constexpr uint32_t kMaxLayerBufferCount = BufferQueue::NUM_BUFFER_SLOTS + 1;
-    ComposerClientWriter mWriter;
-    ComposerClientReader mReader;
+
+    // Guards only the structure of the maps below. A display's writer and
+    // reader are preallocated on first use and reused frame to frame, and are
+    // only touched by the thread composing that display, so per-display
+    // command streams may be built and executed concurrently.
+    mutable std::mutex mMutex;
+    std::unordered_map<int64_t, ComposerClientWriter> mWriters GUARDED_BY(mMutex);
+    std::unordered_map<int64_t, ComposerClientReader> mReaders GUARDED_BY(mMutex);
 
     // Aidl interface
     using AidlIComposer = aidl::android::hardware::graphics::composer3::IComposer;
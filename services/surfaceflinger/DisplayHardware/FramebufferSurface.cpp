@@ -24,6 +24,7 @@
 #define LOG_TAG "FramebufferSurface"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -109,7 +110,8 @@ status_t FramebufferSurface::nextBuffer(uint32_t& outSlot,
     BufferItem item;
     status_t err = acquireBufferLocked(&item, 0);
     if (err == BufferQueue::NO_BUFFER_AVAILABLE) {
-        mHwcBufferCache.getHwcBuffer(mCurrentBufferSlot, mCurrentBuffer, &outSlot, &outBuffer);
+        // Nothing new to latch. The client target set on a previous frame is
+        // still current in HWC, so skip the cache lookup entirely.
         return NO_ERROR;
     } else if (err != NO_ERROR) {
         ALOGE("error acquiring buffer: %s (%d)", strerror(-err), err);
@@ -201,6 +203,8 @@ void FramebufferSurface::dumpAsString(String8& result) const {
     result.appendFormat("      mDataSpace=%s (%d)\n",
                         dataspaceDetails(static_cast<android_dataspace>(mDataSpace)).c_str(),
                         mDataSpace);
+    result.appendFormat("      clientTargetCacheHits=%" PRIu64 " misses=%" PRIu64 "\n",
+                        mHwcBufferCache.getHitCount(), mHwcBufferCache.getMissCount());
     ConsumerBase::dumpLocked(result, "      ");
 }
 
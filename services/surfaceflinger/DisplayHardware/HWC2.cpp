@@ -158,12 +158,13 @@ Error Display::getPhysicalDisplayOrientation(Hwc2::AidlTransform* outTransform)
     return static_cast<Error>(error);
 }
 
-Error Display::getChangedCompositionTypes(std::unordered_map<HWC2::Layer*, Composition>* outTypes) {
-    std::vector<Hwc2::Layer> layerIds;
-    std::vector<Composition> types;
+Error Display::getChangedCompositionTypes(
+        std::vector<std::pair<HWC2::Layer*, Composition>>* outTypes) {
+    mChangedLayerIds.clear();
+    mChangedTypes.clear();
     auto intError = mComposer.getChangedCompositionTypes(
-            mId, &layerIds, &types);
-    uint32_t numElements = layerIds.size();
+            mId, &mChangedLayerIds, &mChangedTypes);
+    uint32_t numElements = mChangedLayerIds.size();
     auto error = static_cast<Error>(intError);
     error = static_cast<Error>(intError);
     if (error != Error::NONE) {
@@ -173,15 +174,15 @@ Error Display::getChangedCompositionTypes(std::unordered_map<HWC2::Layer*, Compo
     outTypes->clear();
     outTypes->reserve(numElements);
     for (uint32_t element = 0; element < numElements; ++element) {
-        auto layer = getLayerById(layerIds[element]);
+        auto layer = getLayerById(mChangedLayerIds[element]);
         if (layer) {
-            auto type = types[element];
+            auto type = mChangedTypes[element];
             ALOGV("getChangedCompositionTypes: adding %" PRIu64 " %s",
                     layer->getId(), to_string(type).c_str());
-            outTypes->emplace(layer.get(), type);
+            outTypes->emplace_back(layer.get(), type);
         } else {
             ALOGE("getChangedCompositionTypes: invalid layer %" PRIu64 " found"
-                    " on display %" PRIu64, layerIds[element], mId);
+                    " on display %" PRIu64, mChangedLayerIds[element], mId);
         }
     }
 
@@ -251,13 +252,13 @@ Error Display::getName(std::string* outName) const
 }
 
 Error Display::getRequests(HWC2::DisplayRequest* outDisplayRequests,
-                           std::unordered_map<HWC2::Layer*, LayerRequest>* outLayerRequests) {
+                           std::vector<std::pair<HWC2::Layer*, LayerRequest>>* outLayerRequests) {
     uint32_t intDisplayRequests = 0;
-    std::vector<Hwc2::Layer> layerIds;
-    std::vector<uint32_t> layerRequests;
+    mRequestedLayerIds.clear();
+    mLayerRequestMasks.clear();
     auto intError = mComposer.getDisplayRequests(
-            mId, &intDisplayRequests, &layerIds, &layerRequests);
-    uint32_t numElements = layerIds.size();
+            mId, &intDisplayRequests, &mRequestedLayerIds, &mLayerRequestMasks);
+    uint32_t numElements = mRequestedLayerIds.size();
     auto error = static_cast<Error>(intError);
     if (error != Error::NONE) {
         return error;
@@ -267,14 +268,14 @@ Error Display::getRequests(HWC2::DisplayRequest* outDisplayRequests,
     outLayerRequests->clear();
     outLayerRequests->reserve(numElements);
     for (uint32_t element = 0; element < numElements; ++element) {
-        auto layer = getLayerById(layerIds[element]);
+        auto layer = getLayerById(mRequestedLayerIds[element]);
         if (layer) {
             auto layerRequest =
-                    static_cast<LayerRequest>(layerRequests[element]);
-            outLayerRequests->emplace(layer.get(), layerRequest);
+                    static_cast<LayerRequest>(mLayerRequestMasks[element]);
+            outLayerRequests->emplace_back(layer.get(), layerRequest);
         } else {
             ALOGE("getRequests: invalid layer %" PRIu64 " found on display %"
-                    PRIu64, layerIds[element], mId);
+                    PRIu64, mRequestedLayerIds[element], mId);
         }
     }
 
@@ -32,6 +32,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "ComposerHal.h"
@@ -99,7 +100,8 @@ public:
     [[nodiscard]] virtual base::expected<std::shared_ptr<HWC2::Layer>, hal::Error>
     createLayer() = 0;
     [[nodiscard]] virtual hal::Error getChangedCompositionTypes(
-            std::unordered_map<Layer*, aidl::android::hardware::graphics::composer3::Composition>*
+            std::vector<std::pair<Layer*,
+                                  aidl::android::hardware::graphics::composer3::Composition>>*
                     outTypes) = 0;
     [[nodiscard]] virtual hal::Error getColorModes(std::vector<hal::ColorMode>* outModes) const = 0;
     // Returns a bitmask which contains HdrMetadata::Type::*.
@@ -112,7 +114,7 @@ public:
     [[nodiscard]] virtual hal::Error getName(std::string* outName) const = 0;
     [[nodiscard]] virtual hal::Error getRequests(
             hal::DisplayRequest* outDisplayRequests,
-            std::unordered_map<Layer*, hal::LayerRequest>* outLayerRequests) = 0;
+            std::vector<std::pair<Layer*, hal::LayerRequest>>* outLayerRequests) = 0;
     [[nodiscard]] virtual hal::Error getConnectionType(ui::DisplayConnectionType*) const = 0;
     [[nodiscard]] virtual hal::Error supportsDoze(bool* outSupport) const = 0;
     [[nodiscard]] virtual hal::Error getHdrCapabilities(
@@ -187,9 +189,9 @@ public:
     hal::Error acceptChanges() override;
     base::expected<std::shared_ptr<HWC2::Layer>, hal::Error> createLayer() override;
     hal::Error getChangedCompositionTypes(
-            std::unordered_map<HWC2::Layer*,
-                               aidl::android::hardware::graphics::composer3::Composition>* outTypes)
-            override;
+            std::vector<std::pair<HWC2::Layer*,
+                                  aidl::android::hardware::graphics::composer3::Composition>>*
+                    outTypes) override;
     hal::Error getColorModes(std::vector<hal::ColorMode>* outModes) const override;
     // Returns a bitmask which contains HdrMetadata::Type::*.
     int32_t getSupportedPerFrameMetadata() const override;
@@ -200,7 +202,7 @@ public:
     hal::Error getName(std::string* outName) const override;
     hal::Error getRequests(
             hal::DisplayRequest* outDisplayRequests,
-            std::unordered_map<HWC2::Layer*, hal::LayerRequest>* outLayerRequests) override;
+            std::vector<std::pair<HWC2::Layer*, hal::LayerRequest>>* outLayerRequests) override;
     hal::Error getConnectionType(ui::DisplayConnectionType*) const override;
     hal::Error supportsDoze(bool* outSupport) const override EXCLUDES(mDisplayCapabilitiesMutex);
     hal::Error getHdrCapabilities(android::HdrCapabilities* outCapabilities) const override;
@@ -285,6 +287,13 @@ private:
     using Layers = std::unordered_map<hal::HWLayerId, std::weak_ptr<HWC2::impl::Layer>>;
     Layers mLayers;
 
+    // Scratch buffers for the layer ids and values returned by the composer during validate,
+    // reused across frames so they are not reallocated on every cycle.
+    std::vector<Hwc2::Layer> mChangedLayerIds;
+    std::vector<aidl::android::hardware::graphics::composer3::Composition> mChangedTypes;
+    std::vector<Hwc2::Layer> mRequestedLayerIds;
+    std::vector<uint32_t> mLayerRequestMasks;
+
     mutable std::mutex mDisplayCapabilitiesMutex;
     std::once_flag mDisplayCapabilityQueryFlag;
     std::optional<
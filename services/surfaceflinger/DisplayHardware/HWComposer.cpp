@@ -108,6 +108,16 @@ void HWComposer::setCallback(HWC2::ComposerCallback& callback) {
 
 bool HWComposer::getDisplayIdentificationData(hal::HWDisplayId hwcDisplayId, uint8_t* outPort,
                                               DisplayIdentificationData* outData) const {
+    {
+        std::lock_guard lock(mIdentificationDataMutex);
+        if (const auto it = mPrefetchedIdentificationData.find(hwcDisplayId);
+            it != mPrefetchedIdentificationData.end()) {
+            *outPort = it->second.first;
+            *outData = std::move(it->second.second);
+            mPrefetchedIdentificationData.erase(it);
+            return true;
+        }
+    }
     const auto error = static_cast<hal::Error>(
             mComposer->getDisplayIdentificationData(hwcDisplayId, outPort, outData));
     if (error != hal::Error::NONE) {
@@ -119,6 +129,19 @@ bool HWComposer::getDisplayIdentificationData(hal::HWDisplayId hwcDisplayId, uin
     return true;
 }
 
+void HWComposer::prefetchDisplayIdentificationData(hal::HWDisplayId hwcDisplayId) {
+    uint8_t port;
+    DisplayIdentificationData data;
+    const auto error = static_cast<hal::Error>(
+            mComposer->getDisplayIdentificationData(hwcDisplayId, &port, &data));
+    if (error != hal::Error::NONE) {
+        // Leave failures to the non-prefetched path, which owns the error logging.
+        return;
+    }
+    std::lock_guard lock(mIdentificationDataMutex);
+    mPrefetchedIdentificationData.emplace(hwcDisplayId, std::make_pair(port, std::move(data)));
+}
+
 bool HWComposer::hasCapability(Capability capability) const {
     return mCapabilities.count(capability) > 0;
 }
@@ -130,14 +153,25 @@ bool HWComposer::hasDisplayCapability(HalDisplayId displayId, DisplayCapability
 
 std::optional<DisplayIdentificationInfo> HWComposer::onHotplug(hal::HWDisplayId hwcDisplayId,
                                                                hal::Connection connection) {
+    std::optional<DisplayIdentificationInfo> info;
     switch (connection) {
         case hal::Connection::CONNECTED:
-            return onHotplugConnect(hwcDisplayId);
+            info = onHotplugConnect(hwcDisplayId);
+            break;
         case hal::Connection::DISCONNECTED:
-            return onHotplugDisconnect(hwcDisplayId);
+            info = onHotplugDisconnect(hwcDisplayId);
+            break;
         case hal::Connection::INVALID:
-            return {};
+            break;
     }
+
+    // Drop any prefetched identification data this event did not consume; it would be
+    // stale by the time another hotplug for this display could use it.
+    {
+        std::lock_guard lock(mIdentificationDataMutex);
+        mPrefetchedIdentificationData.erase(hwcDisplayId);
+    }
+    return info;
 }
 
 bool HWComposer::updatesDeviceProductInfoOnHotplugReconnect() const {
@@ -466,13 +500,15 @@ status_t HWComposer::getDeviceCompositionChanges(
         RETURN_IF_HWC_ERROR_FOR("validate", error, displayId, BAD_INDEX);
     }
 
-    android::HWComposer::DeviceRequestedChanges::ChangedTypes changedTypes;
+    // The pooled vectors are cleared and refilled by the calls below, keeping their capacity
+    // across frames.
+    auto& changedTypes = displayData.changedTypes;
     changedTypes.reserve(numTypes);
     error = hwcDisplay->getChangedCompositionTypes(&changedTypes);
     RETURN_IF_HWC_ERROR_FOR("getChangedCompositionTypes", error, displayId, BAD_INDEX);
 
     auto displayRequests = static_cast<hal::DisplayRequest>(0);
-    android::HWComposer::DeviceRequestedChanges::LayerRequests layerRequests;
+    auto& layerRequests = displayData.layerRequests;
     layerRequests.reserve(numRequests);
     error = hwcDisplay->getRequests(&displayRequests, &layerRequests);
     RETURN_IF_HWC_ERROR_FOR("getRequests", error, displayId, BAD_INDEX);
@@ -480,8 +516,7 @@ status_t HWComposer::getDeviceCompositionChanges(
     DeviceRequestedChanges::ClientTargetProperty clientTargetProperty;
     error = hwcDisplay->getClientTargetProperty(&clientTargetProperty);
 
-    outChanges->emplace(DeviceRequestedChanges{std::move(changedTypes), std::move(displayRequests),
-                                               std::move(layerRequests),
+    outChanges->emplace(DeviceRequestedChanges{changedTypes, displayRequests, layerRequests,
                                                std::move(clientTargetProperty)});
     error = hwcDisplay->acceptChanges();
     RETURN_IF_HWC_ERROR_FOR("acceptChanges", error, displayId, BAD_INDEX);
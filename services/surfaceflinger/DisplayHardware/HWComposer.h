@@ -22,6 +22,7 @@
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <android-base/thread_annotations.h>
@@ -76,13 +77,14 @@ struct KnownHWCGenericLayerMetadata {
 class HWComposer {
 public:
     struct DeviceRequestedChanges {
-        using ChangedTypes =
-                std::unordered_map<HWC2::Layer*,
-                                   aidl::android::hardware::graphics::composer3::Composition>;
+        // Flat vectors in the order the HWC returned the layers. The per-frame element counts
+        // are small, so a linear scan is cheaper than building a hash map on every validate.
+        using ChangedTypes = std::vector<std::pair<
+                HWC2::Layer*, aidl::android::hardware::graphics::composer3::Composition>>;
         using ClientTargetProperty =
                 aidl::android::hardware::graphics::composer3::ClientTargetPropertyWithBrightness;
         using DisplayRequests = hal::DisplayRequest;
-        using LayerRequests = std::unordered_map<HWC2::Layer*, hal::LayerRequest>;
+        using LayerRequests = std::vector<std::pair<HWC2::Layer*, hal::LayerRequest>>;
 
         ChangedTypes changedTypes;
         DisplayRequests displayRequests;
@@ -113,6 +115,12 @@ public:
     virtual bool getDisplayIdentificationData(hal::HWDisplayId, uint8_t* outPort,
                                               DisplayIdentificationData* outData) const = 0;
 
+    // Fetches and caches the identification data (port and EDID blob) for the given display,
+    // so that a subsequent getDisplayIdentificationData does not block on the composer HAL.
+    // Safe to call concurrently for different displays, e.g. to overlap the fetches while
+    // processing a batch of hotplug events during boot.
+    virtual void prefetchDisplayIdentificationData(hal::HWDisplayId) = 0;
+
     virtual bool hasCapability(aidl::android::hardware::graphics::composer3::Capability) const = 0;
     virtual bool hasDisplayCapability(
             HalDisplayId,
@@ -304,6 +312,8 @@ public:
     bool getDisplayIdentificationData(hal::HWDisplayId, uint8_t* outPort,
                                       DisplayIdentificationData* outData) const override;
 
+    void prefetchDisplayIdentificationData(hal::HWDisplayId) override;
+
     bool hasCapability(aidl::android::hardware::graphics::composer3::Capability) const override;
     bool hasDisplayCapability(
             HalDisplayId,
@@ -462,6 +472,11 @@ private:
         bool validateWasSkipped;
         hal::Error presentError;
 
+        // Pooled storage for the per-frame composition change results, cleared and refilled on
+        // every validate cycle so the vectors keep their capacity across frames.
+        DeviceRequestedChanges::ChangedTypes changedTypes;
+        DeviceRequestedChanges::LayerRequests layerRequests;
+
         bool vsyncTraceToggle = false;
 
         std::mutex vsyncEnabledLock;
@@ -491,6 +506,12 @@ private:
     std::optional<hal::HWDisplayId> mPrimaryHwcDisplayId;
     bool mHasMultiDisplaySupport = false;
 
+    // Identification data fetched ahead of time by prefetchDisplayIdentificationData and
+    // consumed by the next getDisplayIdentificationData for the same display.
+    mutable std::mutex mIdentificationDataMutex;
+    mutable std::unordered_map<hal::HWDisplayId, std::pair<uint8_t, DisplayIdentificationData>>
+            mPrefetchedIdentificationData GUARDED_BY(mIdentificationDataMutex);
+
     const size_t mMaxVirtualDisplayDimension;
     const bool mUpdateDeviceProductInfoOnHotplugReconnect;
 };
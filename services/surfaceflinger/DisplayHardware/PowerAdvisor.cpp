@@ -282,6 +282,12 @@ void PowerAdvisor::setGpuFenceTime(DisplayId displayId, std::unique_ptr<FenceTim
             }
             displayData.lastValidGpuStartTime = displayData.gpuStartTime;
             displayData.lastValidGpuEndTime = signalTime;
+
+            const nsecs_t gpuDuration =
+                    *displayData.lastValidGpuEndTime - *displayData.lastValidGpuStartTime;
+            displayData.smoothedGpuDuration = displayData.smoothedGpuDuration.has_value()
+                    ? (3 * *displayData.smoothedGpuDuration + gpuDuration) / 4
+                    : gpuDuration;
         }
     }
     displayData.gpuEndFenceTime = std::move(fenceTime);
@@ -549,8 +555,8 @@ std::optional<PowerAdvisor::GpuTimeline> PowerAdvisor::DisplayTimingData::estima
         // If we know how long the most recent gpu duration was, use that
         gpuDuration = latestGpuEndTime - latestGpuStartTime;
     } else if (lastValidGpuEndTime.has_value()) {
-        // If we don't have the fence data, use the most recent information we do have
-        gpuDuration = *lastValidGpuEndTime - *lastValidGpuStartTime;
+        // If we don't have the fence data, use the smoothed recent gpu duration
+        gpuDuration = smoothedGpuDuration.value_or(*lastValidGpuEndTime - *lastValidGpuStartTime);
         if (latestGpuEndTime == Fence::SIGNAL_TIME_PENDING) {
             // If pending but went over the previous duration, use current time as the end
             gpuDuration = std::max(gpuDuration, systemTime() - latestGpuStartTime);
@@ -205,6 +205,10 @@ private:
         std::optional<nsecs_t> gpuStartTime;
         std::optional<nsecs_t> lastValidGpuEndTime;
         std::optional<nsecs_t> lastValidGpuStartTime;
+        // Smoothed average of recent valid gpu durations, used instead of the single most
+        // recent sample when the current frame's gpu fence has not signaled yet, so that one
+        // slow frame does not keep inflating the estimate
+        std::optional<nsecs_t> smoothedGpuDuration;
         std::optional<nsecs_t> hwcPresentStartTime;
         std::optional<nsecs_t> hwcPresentEndTime;
         std::optional<nsecs_t> hwcValidateStartTime;
@@ -20,8 +20,10 @@
 
 // #define LOG_NDEBUG 0
 
+#include <algorithm>
 #include <cinttypes>
 
+#include <android-base/properties.h>
 #include <ftl/enum.h>
 #include <ftl/flags.h>
 #include <gui/BufferItem.h>
@@ -46,6 +48,10 @@
 
 namespace android {
 
+// Sink dequeues that block longer than this are counted as pipeline stalls
+// in dumpAsString().
+static constexpr nsecs_t kSinkStallThresholdNs = 1000000; // 1ms
+
 VirtualDisplaySurface::VirtualDisplaySurface(HWComposer& hwc, VirtualDisplayId displayId,
                                              const sp<IGraphicBufferProducer>& sink,
                                              const sp<IGraphicBufferProducer>& bqProducer,
@@ -71,7 +77,9 @@ VirtualDisplaySurface::VirtualDisplaySurface(HWComposer& hwc, VirtualDisplayId d
         mOutputProducerSlot(BufferQueue::INVALID_BUFFER_SLOT),
         mForceHwcCopy(SurfaceFlinger::useHwcForRgbToYuv),
         mSecure(secure),
-        mSinkUsage(0) {
+        mSinkUsage(0),
+        mExtraSinkBuffers(
+                std::max(0, base::GetIntProperty("debug.sf.vds_extra_sink_buffers", 0))) {
     mSource[SOURCE_SINK] = sink;
     mSource[SOURCE_SCRATCH] = bqProducer;
 
@@ -280,7 +288,13 @@ void VirtualDisplaySurface::onFrameCommitted() {
     resetPerFrameState();
 }
 
-void VirtualDisplaySurface::dumpAsString(String8& /* result */) const {
+void VirtualDisplaySurface::dumpAsString(String8& result) const {
+    result.appendFormat("   VirtualDisplaySurface\n");
+    result.appendFormat("      extraSinkBuffers=%d\n", mExtraSinkBuffers);
+    result.appendFormat("      sink dequeues=%" PRIu64 " stalls=%" PRIu64
+                        " stallTime=%.3fms maxStall=%.3fms\n",
+                        mSinkDequeues, mSinkStalls, mSinkStallTotalTime / 1e6,
+                        mSinkStallMaxTime / 1e6);
 }
 
 void VirtualDisplaySurface::resizeBuffers(const ui::Size& newSize) {
@@ -309,7 +323,11 @@ status_t VirtualDisplaySurface::requestBuffer(int pslot,
 
 status_t VirtualDisplaySurface::setMaxDequeuedBufferCount(
         int maxDequeuedBuffers) {
-    return mSource[SOURCE_SINK]->setMaxDequeuedBufferCount(maxDequeuedBuffers);
+    // Ask the sink for extra buffers so it can still be consuming the
+    // previous frame while the next frame's output buffer is dequeued.
+    // Without the headroom, the dequeue in beginFrame() blocks until the
+    // sink consumer releases the previous buffer.
+    return mSource[SOURCE_SINK]->setMaxDequeuedBufferCount(maxDequeuedBuffers + mExtraSinkBuffers);
 }
 
 status_t VirtualDisplaySurface::setAsyncMode(bool async) {
@@ -328,9 +346,19 @@ status_t VirtualDisplaySurface::dequeueBuffer(Source source,
                 __func__, ftl::enum_string(source).c_str(), usage);
     }
 
+    const nsecs_t dequeueStartTime = systemTime();
     status_t result =
             mSource[source]->dequeueBuffer(sslot, fence, mSinkBufferWidth, mSinkBufferHeight,
                                            format, usage, nullptr, nullptr);
+    if (source == SOURCE_SINK) {
+        const nsecs_t waitTime = systemTime() - dequeueStartTime;
+        mSinkDequeues++;
+        if (waitTime >= kSinkStallThresholdNs) {
+            mSinkStalls++;
+            mSinkStallTotalTime += waitTime;
+            mSinkStallMaxTime = std::max(mSinkStallMaxTime, waitTime);
+        }
+    }
     if (result < 0)
         return result;
     int pslot = mapSource2ProducerSlot(source, *sslot);
@@ -267,6 +267,20 @@ private:
     bool mForceHwcCopy;
     bool mSecure;
     int mSinkUsage;
+
+    // Extra sink buffers to keep in flight beyond what the GPU driver
+    // requests, so the sink consumer (e.g. a video encoder) can hold on to
+    // the previous frame while the next frame's output buffer is dequeued
+    // and composed. Configured with debug.sf.vds_extra_sink_buffers; 0
+    // preserves the historical one-frame-deep pipeline.
+    const int mExtraSinkBuffers;
+
+    // Track how often and for how long dequeueing the next sink buffer
+    // blocked waiting on the sink consumer, for dumpsys.
+    uint64_t mSinkDequeues = 0;
+    uint64_t mSinkStalls = 0;
+    nsecs_t mSinkStallTotalTime = 0;
+    nsecs_t mSinkStallMaxTime = 0;
 };
 
 } // namespace android
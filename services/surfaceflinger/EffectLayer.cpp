@@ -49,11 +49,16 @@ EffectLayer::~EffectLayer() = default;
 
 std::vector<compositionengine::LayerFE::LayerSettings> EffectLayer::prepareClientCompositionList(
         compositionengine::LayerFE::ClientCompositionTargetSettings& targetSettings) {
+    if (auto cached = getCachedClientCompositionList(targetSettings)) {
+        return std::move(*cached);
+    }
+
     std::vector<compositionengine::LayerFE::LayerSettings> results;
     std::optional<compositionengine::LayerFE::LayerSettings> layerSettings =
             prepareClientComposition(targetSettings);
     // Nothing to render.
     if (!layerSettings) {
+        cacheClientCompositionList(targetSettings, results);
         return {};
     }
 
@@ -70,6 +75,7 @@ std::vector<compositionengine::LayerFE::LayerSettings> EffectLayer::prepareClien
         results.push_back(*layerSettings);
     }
 
+    cacheClientCompositionList(targetSettings, results);
     return results;
 }
 
@@ -18,9 +18,14 @@
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wconversion"
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
 #include <log/log.h>
+#include <utils/ThreadDefs.h>
 
 #include "EventLog.h"
 
@@ -30,6 +35,18 @@ ANDROID_SINGLETON_STATIC_INSTANCE(EventLog)
 
 
 EventLog::EventLog() {
+    for (size_t i = 0; i < kRingSize; i++) {
+        mRing[i].sequence = i;
+    }
+    LOG_ALWAYS_FATAL_IF(sem_init(&mSemaphore, 0, 0), "sem_init failed");
+    mFlushThread = std::thread([this] { flushLoop(); });
+}
+
+EventLog::~EventLog() {
+    mDone = true;
+    sem_post(&mSemaphore);
+    mFlushThread.join();
+    sem_destroy(&mSemaphore);
 }
 
 void EventLog::doLogFrameDurations(const std::string_view& name, const int32_t* durations,
@@ -41,7 +58,7 @@ void EventLog::doLogFrameDurations(const std::string_view& name, const int32_t*
         buffer.writeInt32(durations[i]);
     }
     buffer.endList();
-    buffer.log();
+    enqueue(buffer);
 }
 
 void EventLog::logFrameDurations(const std::string_view& name, const int32_t* durations,
@@ -49,21 +66,86 @@ void EventLog::logFrameDurations(const std::string_view& name, const int32_t* du
     EventLog::getInstance().doLogFrameDurations(name, durations, numDurations);
 }
 
-// ---------------------------------------------------------------------------
+void EventLog::enqueue(const TagBuffer& buffer) {
+    if (buffer.overflow()) {
+        ALOGW("couldn't log to binary event log: overflow.");
+        return;
+    }
 
-EventLog::TagBuffer::TagBuffer(int32_t tag)
-    : mPos(0), mTag(tag), mOverflow(false) {
+    // Under sustained jank the flush thread falls behind; sample entries instead of
+    // fighting over the remaining slots.
+    if (mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed) >=
+        kRingSize / 2) {
+        if (mSampleCounter.fetch_add(1, std::memory_order_relaxed) % kSampleStride != 0) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    uint64_t pos = mHead.load(std::memory_order_relaxed);
+    for (;;) {
+        Entry& entry = mRing[pos % kRingSize];
+        const uint64_t sequence = entry.sequence.load(std::memory_order_acquire);
+        const int64_t difference = static_cast<int64_t>(sequence - pos);
+        if (difference == 0) {
+            if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                entry.tag = buffer.tag();
+                entry.size = buffer.size();
+                memcpy(entry.storage, buffer.data(), buffer.size());
+                entry.sequence.store(pos + 1, std::memory_order_release);
+                sem_post(&mSemaphore);
+                return;
+            }
+        } else if (difference < 0) {
+            // The ring is full; drop rather than block the frame path.
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = mHead.load(std::memory_order_relaxed);
+        }
+    }
 }
 
-void EventLog::TagBuffer::log() {
-    if (mOverflow) {
-        ALOGW("couldn't log to binary event log: overflow.");
-    } else if (android_bWriteLog(mTag, mStorage, mPos) < 0) {
-        ALOGE("couldn't log to EventLog: %s", strerror(errno));
+void EventLog::flushLoop() {
+    if (pthread_setname_np(pthread_self(), "EventLogWriter")) {
+        ALOGW("Failed to set thread name on event log writer thread");
+    }
+    if (setpriority(PRIO_PROCESS, 0, ANDROID_PRIORITY_BACKGROUND)) {
+        ALOGW("Failed to set background priority on event log writer thread");
     }
-    // purge the buffer
-    mPos = 0;
-    mOverflow = false;
+
+    while (true) {
+        if (sem_wait(&mSemaphore)) {
+            LOG_ALWAYS_FATAL_IF(errno != EINTR, "sem_wait failed (%d)", errno);
+            continue;
+        }
+        if (mDone) {
+            break;
+        }
+
+        uint64_t tail = mTail.load(std::memory_order_relaxed);
+        Entry& entry = mRing[tail % kRingSize];
+        if (static_cast<int64_t>(entry.sequence.load(std::memory_order_acquire) - (tail + 1)) <
+            0) {
+            continue;
+        }
+
+        if (android_bWriteLog(entry.tag, entry.storage, entry.size) < 0) {
+            ALOGE("couldn't log to EventLog: %s", strerror(errno));
+        }
+        entry.sequence.store(tail + kRingSize, std::memory_order_release);
+        mTail.store(tail + 1, std::memory_order_relaxed);
+
+        if (const uint64_t dropped = mDropped.exchange(0, std::memory_order_relaxed)) {
+            ALOGW("dropped %" PRIu64 " binary event log entries under sustained jank", dropped);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+EventLog::TagBuffer::TagBuffer(int32_t tag)
+    : mPos(0), mTag(tag), mOverflow(false) {
 }
 
 void EventLog::TagBuffer::startList(int8_t count) {
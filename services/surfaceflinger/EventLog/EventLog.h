@@ -16,14 +16,25 @@
 
 #pragma once
 
+#include <semaphore.h>
 #include <utils/Errors.h>
 #include <utils/Singleton.h>
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <string_view>
+#include <thread>
 
 namespace android {
 
+/*
+ * Logs jank diagnostics to the binary event log. Entries are preformatted on the
+ * caller's thread and pushed into a lock-free ring that a low-priority thread drains
+ * into the event log, so logging never takes a lock or a syscall on the frame path -
+ * which is exactly when jank is being reported. Under sustained jank the ring samples
+ * entries rather than growing the backlog.
+ */
 class EventLog : public Singleton<EventLog> {
 
 public:
@@ -32,18 +43,21 @@ public:
 
 protected:
     EventLog();
+    ~EventLog();
 
 private:
+    // Maximum size of a preformatted tag, including the list framing.
+    enum { STORAGE_MAX_SIZE = 128 };
+
     /*
      * EventLogBuffer is a helper class to construct an in-memory event log
      * tag. In this version the buffer is not dynamic, so write operation can
      * fail if there is not enough space in the temporary buffer.
-     * Once constructed, the buffer can be logger by calling the log()
-     * method.
+     * Once constructed, the buffer can be queued for logging by calling the
+     * enqueue() method.
      */
 
     class TagBuffer {
-        enum { STORAGE_MAX_SIZE = 128 };
         int32_t mPos;
         int32_t mTag;
         bool mOverflow;
@@ -58,7 +72,10 @@ private:
         void writeInt64(int64_t);
         void writeString(const std::string_view&);
 
-        void log();
+        int32_t tag() const { return mTag; }
+        const char* data() const { return mStorage; }
+        int32_t size() const { return mPos; }
+        bool overflow() const { return mOverflow; }
     };
 
     friend class Singleton<EventLog>;
@@ -68,6 +85,39 @@ private:
     enum { LOGTAG_SF_FRAME_DUR = 60100 };
     void doLogFrameDurations(const std::string_view& name, const int32_t* durations,
                              size_t numDurations);
+
+    // A ring slot holding a preformatted tag. The sequence number implements the usual
+    // bounded lock-free queue protocol: a slot is free for the producer claiming index
+    // i when sequence == i, and ready for the consumer when sequence == i + 1.
+    struct Entry {
+        std::atomic<uint64_t> sequence;
+        int32_t tag;
+        int32_t size;
+        char storage[STORAGE_MAX_SIZE];
+    };
+
+    // Must be a power of two.
+    static constexpr size_t kRingSize = 32;
+    // Once the ring is half full the writer thread is clearly not keeping up with the
+    // jank being reported; keep only one entry in kSampleStride until it drains.
+    static constexpr uint64_t kSampleStride = 4;
+
+    // Copies the preformatted buffer into the ring and wakes the flush thread.
+    // Drops (or samples) entries instead of blocking when the ring is contended.
+    void enqueue(const TagBuffer&);
+
+    // Drains the ring into the event log on a background thread.
+    void flushLoop();
+
+    std::array<Entry, kRingSize> mRing;
+    std::atomic<uint64_t> mHead = 0;
+    // Only advanced by the flush thread; atomic so producers can estimate occupancy.
+    std::atomic<uint64_t> mTail = 0;
+    std::atomic<uint64_t> mDropped = 0;
+    std::atomic<uint64_t> mSampleCounter = 0;
+    std::atomic<bool> mDone = false;
+    sem_t mSemaphore;
+    std::thread mFlushThread;
 };
 
 } // namespace android
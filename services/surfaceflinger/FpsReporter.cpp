@@ -20,6 +20,7 @@
 
 #include <algorithm>
 
+#include "BackgroundExecutor.h"
 #include "FpsReporter.h"
 #include "Layer.h"
 #include "SurfaceFlinger.h"
@@ -71,13 +72,27 @@ void FpsReporter::dispatchLayerFps() {
         }
     });
 
+    std::vector<std::pair<sp<gui::IFpsListener>, float>> fpsToReport;
+    fpsToReport.reserve(listenersAndLayersToReport.size());
     for (const auto& [listener, layer] : listenersAndLayersToReport) {
         std::unordered_set<int32_t> layerIds;
 
         layer->traverse(LayerVector::StateSet::Current,
                         [&](Layer* layer) { layerIds.insert(layer->getSequence()); });
 
-        listener.listener->onFpsReported(mFrameTimeline.computeFps(layerIds));
+        fpsToReport.emplace_back(listener.listener, mFrameTimeline.computeFps(layerIds));
+    }
+
+    if (!fpsToReport.empty()) {
+        // Hand the binder round trips to a background worker so a slow listener can't
+        // stall the caller, which holds mStateLock on the main thread.
+        BackgroundExecutor::getInstance().sendCallbacks(
+                {[fpsToReport = std::move(fpsToReport)]() {
+                    for (const auto& [listener, fps] : fpsToReport) {
+                        listener->onFpsReported(fps);
+                    }
+                }},
+                BackgroundExecutor::kFpsReporterTag);
     }
 
     mLastDispatch = now;
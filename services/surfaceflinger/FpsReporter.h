@@ -38,7 +38,8 @@ public:
 
     // Dispatches updated layer fps values for the registered listeners
     // This method promotes Layer weak pointers and performs layer stack traversals, so mStateLock
-    // must be held when calling this method.
+    // must be held when calling this method. The listener binder calls themselves are handed to
+    // a background worker so they cannot stall the caller.
     void dispatchLayerFps() EXCLUDES(mMutex);
 
     // Override for IBinder::DeathRecipient
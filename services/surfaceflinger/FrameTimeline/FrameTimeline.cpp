@@ -742,22 +742,32 @@ namespace impl {
 
 int64_t TokenManager::generateTokenForPredictions(TimelineItem&& predictions) {
     ATRACE_CALL();
-    std::scoped_lock lock(mMutex);
-    while (mPredictions.size() >= kMaxTokens) {
-        mPredictions.erase(mPredictions.begin());
-    }
-    const int64_t assignedToken = mCurrentToken++;
-    mPredictions[assignedToken] = predictions;
+    const int64_t assignedToken = mCurrentToken.fetch_add(1, std::memory_order_relaxed);
+    TokenSlot& slot = mTokenRing[static_cast<size_t>(assignedToken) % kMaxTokens];
+    // Expire the evicted token before rewriting the slot; the acquire half of
+    // the exchange keeps the prediction writes from being reordered ahead of
+    // the invalidation.
+    slot.token.exchange(FrameTimelineInfo::INVALID_VSYNC_ID, std::memory_order_acq_rel);
+    slot.predictions = std::move(predictions);
+    slot.token.store(assignedToken, std::memory_order_release);
     return assignedToken;
 }
 
 std::optional<TimelineItem> TokenManager::getPredictionsForToken(int64_t token) const {
-    std::scoped_lock lock(mMutex);
-    auto predictionsIterator = mPredictions.find(token);
-    if (predictionsIterator != mPredictions.end()) {
-        return predictionsIterator->second;
+    if (token <= FrameTimelineInfo::INVALID_VSYNC_ID) {
+        return {};
     }
-    return {};
+    const TokenSlot& slot = mTokenRing[static_cast<size_t>(token) % kMaxTokens];
+    if (slot.token.load(std::memory_order_acquire) != token) {
+        return {};
+    }
+    const TimelineItem predictions = slot.predictions;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.token.load(std::memory_order_relaxed) != token) {
+        // The slot was recycled while being read; treat the token as expired.
+        return {};
+    }
+    return predictions;
 }
 
 FrameTimeline::FrameTimeline(std::shared_ptr<TimeStats> timeStats, pid_t surfaceFlingerPid,
@@ -769,6 +779,11 @@ FrameTimeline::FrameTimeline(std::shared_ptr<TimeStats> timeStats, pid_t surface
         mJankClassificationThresholds(thresholds) {
     mCurrentDisplayFrame =
             std::make_shared<DisplayFrame>(mTimeStats, thresholds, &mTraceCookieCounter);
+    mDisplayFramePool.reserve(kDefaultMaxDisplayFrames);
+    for (uint32_t i = 0; i < kDefaultMaxDisplayFrames; i++) {
+        mDisplayFramePool.push_back(
+                std::make_shared<DisplayFrame>(mTimeStats, thresholds, &mTraceCookieCounter));
+    }
 }
 
 void FrameTimeline::onBootFinished() {
@@ -883,6 +898,22 @@ void FrameTimeline::DisplayFrame::setGpuFence(const std::shared_ptr<FenceTime>&
     mGpuFence = gpuFence;
 }
 
+void FrameTimeline::DisplayFrame::reset() {
+    mToken = FrameTimelineInfo::INVALID_VSYNC_ID;
+    mSurfaceFlingerPredictions = TimelineItem();
+    mSurfaceFlingerActuals = TimelineItem();
+    // clear() keeps the vector's capacity, so a recycled frame does not have
+    // to regrow to kNumSurfaceFramesInitial.
+    mSurfaceFrames.clear();
+    mPredictionState = PredictionState::None;
+    mJankType = JankType::None;
+    mGpuFence = FenceTime::NO_FENCE;
+    mFramePresentMetadata = FramePresentMetadata::UnknownPresent;
+    mFrameReadyMetadata = FrameReadyMetadata::UnknownFinish;
+    mFrameStartMetadata = FrameStartMetadata::UnknownStart;
+    mRefreshRate = Fps();
+}
+
 void FrameTimeline::DisplayFrame::classifyJank(nsecs_t& deadlineDelta, nsecs_t& deltaToVsync,
                                                nsecs_t previousPresentTime) {
     if (mPredictionState == PredictionState::Expired ||
@@ -1200,12 +1231,25 @@ void FrameTimeline::flushPendingPresentFences() {
 void FrameTimeline::finalizeCurrentDisplayFrame() {
     while (mDisplayFrames.size() >= mMaxDisplayFrames) {
         // We maintain only a fixed number of frames' data. Pop older frames
+        std::shared_ptr<DisplayFrame> evicted = std::move(mDisplayFrames.front());
         mDisplayFrames.pop_front();
+        // Recycle the evicted frame unless something else (e.g. a pending
+        // present fence) still holds a reference to it.
+        if (evicted.use_count() == 1 && mDisplayFramePool.size() < mMaxDisplayFrames) {
+            evicted->reset();
+            mDisplayFramePool.push_back(std::move(evicted));
+        }
     }
     mDisplayFrames.push_back(mCurrentDisplayFrame);
     mCurrentDisplayFrame.reset();
-    mCurrentDisplayFrame = std::make_shared<DisplayFrame>(mTimeStats, mJankClassificationThresholds,
-                                                          &mTraceCookieCounter);
+    if (!mDisplayFramePool.empty()) {
+        mCurrentDisplayFrame = std::move(mDisplayFramePool.back());
+        mDisplayFramePool.pop_back();
+    } else {
+        mCurrentDisplayFrame =
+                std::make_shared<DisplayFrame>(mTimeStats, mJankClassificationThresholds,
+                                               &mTraceCookieCounter);
+    }
 }
 
 nsecs_t FrameTimeline::DisplayFrame::getBaseTime() const {
@@ -1313,6 +1357,7 @@ void FrameTimeline::setMaxDisplayFrames(uint32_t size) {
     // The size can either increase or decrease, clear everything, to be consistent
     mDisplayFrames.clear();
     mPendingPresentFences.clear();
+    mDisplayFramePool.clear();
     mMaxDisplayFrames = size;
 }
 
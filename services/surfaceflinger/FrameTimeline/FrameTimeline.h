@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <deque>
@@ -339,12 +340,20 @@ private:
     // Friend class for testing
     friend class android::frametimeline::FrameTimelineTest;
 
-    void flushTokens(nsecs_t flushTime) REQUIRES(mMutex);
-
-    std::map<int64_t, TimelineItem> mPredictions GUARDED_BY(mMutex);
-    int64_t mCurrentToken GUARDED_BY(mMutex);
-    mutable std::mutex mMutex;
     static constexpr size_t kMaxTokens = 500;
+
+    // Predictions are stored in a fixed ring indexed by token % kMaxTokens so
+    // that token generation on the vsync path never allocates or takes a lock.
+    // A slot's token is invalidated before its predictions are rewritten and
+    // republished with a release store afterwards; readers validate the token
+    // on both sides of their copy, so a recycled slot simply reads as expired.
+    struct TokenSlot {
+        std::atomic<int64_t> token = FrameTimelineInfo::INVALID_VSYNC_ID;
+        TimelineItem predictions;
+    };
+
+    std::array<TokenSlot, kMaxTokens> mTokenRing;
+    std::atomic<int64_t> mCurrentToken;
 };
 
 class FrameTimeline : public android::frametimeline::FrameTimeline {
@@ -385,6 +394,9 @@ public:
         void setActualStartTime(nsecs_t actualStartTime);
         void setActualEndTime(nsecs_t actualEndTime);
         void setGpuFence(const std::shared_ptr<FenceTime>& gpuFence);
+        // Restores the frame to a newly constructed state so it can be reused
+        // from the pool. The SurfaceFrame vector keeps its capacity.
+        void reset();
 
         // BaseTime is the smallest timestamp in a DisplayFrame.
         // Used for dumping all timestamps relative to the oldest, making it easy to read.
@@ -483,6 +495,10 @@ private:
     std::vector<std::pair<std::shared_ptr<FenceTime>, std::shared_ptr<DisplayFrame>>>
             mPendingPresentFences GUARDED_BY(mMutex);
     std::shared_ptr<DisplayFrame> mCurrentDisplayFrame GUARDED_BY(mMutex);
+    // Recycled DisplayFrames, preallocated to kDefaultMaxDisplayFrames. Frames
+    // aging out of mDisplayFrames return here (when nothing else references
+    // them) and are reused instead of allocating a new frame every vsync.
+    std::vector<std::shared_ptr<DisplayFrame>> mDisplayFramePool GUARDED_BY(mMutex);
     TokenManager mTokenManager;
     TraceCookieCounter mTraceCookieCounter;
     mutable std::mutex mMutex;
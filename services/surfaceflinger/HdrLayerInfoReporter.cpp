@@ -20,15 +20,39 @@
 
 #include <utils/Trace.h>
 
+#include "BackgroundExecutor.h"
 #include "HdrLayerInfoReporter.h"
 
 namespace android {
 
 void HdrLayerInfoReporter::dispatchHdrLayerInfo(const HdrLayerInfo& info) {
     ATRACE_CALL();
+    {
+        std::scoped_lock lock(mMutex);
+        mPendingInfo = info;
+        if (mDispatchPending) {
+            // The queued dispatch will pick up the info stored above, so rapid HDR
+            // entry/exit flapping collapses into a single listener update.
+            return;
+        }
+        mDispatchPending = true;
+    }
+
+    BackgroundExecutor::getInstance()
+            .sendCallbacks({[reporter = sp<HdrLayerInfoReporter>::fromExisting(this)]() {
+                               reporter->dispatchPendingHdrLayerInfo();
+                           }},
+                           BackgroundExecutor::kHdrLayerInfoTag);
+}
+
+void HdrLayerInfoReporter::dispatchPendingHdrLayerInfo() {
+    ATRACE_CALL();
+    HdrLayerInfo info;
     std::vector<sp<gui::IHdrLayerInfoListener>> toInvoke;
     {
         std::scoped_lock lock(mMutex);
+        mDispatchPending = false;
+        info = mPendingInfo;
         toInvoke.reserve(mListeners.size());
         for (auto& [key, it] : mListeners) {
             if (it.lastInfo != info) {
@@ -45,9 +45,10 @@ public:
     HdrLayerInfoReporter() = default;
     ~HdrLayerInfoReporter() final = default;
 
-    // Dispatches updated layer fps values for the registered listeners
-    // This method promotes Layer weak pointers and performs layer stack traversals, so mStateLock
-    // must be held when calling this method.
+    // Schedules a dispatch of |info| to the registered listeners on a background worker, so
+    // the binder round trips never run on the caller's (the main) thread. Rapid successive
+    // calls coalesce: if a dispatch is already queued it simply picks up the latest info, so
+    // listeners see at most one update per dispatch in flight and only when the info changed.
     void dispatchHdrLayerInfo(const HdrLayerInfo& info) EXCLUDES(mMutex);
 
     // Override for IBinder::DeathRecipient
@@ -64,6 +65,9 @@ public:
     }
 
 private:
+    // Invokes the listeners with the most recently queued info. Runs on a background worker.
+    void dispatchPendingHdrLayerInfo() EXCLUDES(mMutex);
+
     mutable std::mutex mMutex;
 
     struct TrackedListener {
@@ -72,6 +76,11 @@ private:
     };
 
     std::unordered_map<wp<IBinder>, TrackedListener, WpHash> mListeners GUARDED_BY(mMutex);
+
+    // The most recent info passed to dispatchHdrLayerInfo, consumed by the background worker.
+    HdrLayerInfo mPendingInfo GUARDED_BY(mMutex);
+    // True while a dispatch is queued on the background executor but has not yet run.
+    bool mDispatchPending GUARDED_BY(mMutex) = false;
 };
 
 } // namespace android
\ No newline at end of file
@@ -92,6 +92,7 @@ using gui::WindowInfo;
 using PresentState = frametimeline::SurfaceFrame::PresentState;
 
 std::atomic<int32_t> Layer::sSequence{1};
+std::atomic<uint64_t> Layer::sOrderGeneration{1};
 
 Layer::Layer(const LayerCreationArgs& args)
       : sequence(args.sequence.value_or(sSequence++)),
@@ -338,6 +339,11 @@ void Layer::computeBounds(FloatRect parentBounds, ui::Transform parentTransform,
                           float parentShadowRadius) {
     const State& s(getDrawingState());
 
+    // Bounds are only recomputed when some layer's committed state changed, so the effective
+    // transform, bounds and shadow radius below may differ from what the cached client
+    // composition list was built with.
+    mVisualStateGeneration++;
+
     // Calculate effective layer transform
     mEffectiveTransform = parentTransform * getActiveTransform(s);
 
@@ -650,28 +656,67 @@ void Layer::prepareClearClientComposition(LayerFE::LayerSettings& layerSettings,
     layerSettings.name = getName();
 }
 
+std::optional<std::vector<compositionengine::LayerFE::LayerSettings>>
+Layer::getCachedClientCompositionList(
+        const compositionengine::LayerFE::ClientCompositionTargetSettings& targetSettings) const {
+    const auto& cache = mClientCompositionCache;
+    if (cache.generation != mVisualStateGeneration ||
+        cache.realContentIsVisible != targetSettings.realContentIsVisible ||
+        cache.clearContent != targetSettings.clearContent ||
+        cache.isSecure != targetSettings.isSecure ||
+        cache.supportsProtectedContent != targetSettings.supportsProtectedContent ||
+        cache.needsFiltering != targetSettings.needsFiltering ||
+        cache.blurSetting != targetSettings.blurSetting ||
+        cache.whitePointNits != targetSettings.whitePointNits ||
+        cache.viewport != targetSettings.viewport) {
+        return std::nullopt;
+    }
+    return cache.settings;
+}
+
+void Layer::cacheClientCompositionList(
+        const compositionengine::LayerFE::ClientCompositionTargetSettings& targetSettings,
+        const std::vector<compositionengine::LayerFE::LayerSettings>& settings) {
+    auto& cache = mClientCompositionCache;
+    cache.generation = mVisualStateGeneration;
+    cache.realContentIsVisible = targetSettings.realContentIsVisible;
+    cache.clearContent = targetSettings.clearContent;
+    cache.isSecure = targetSettings.isSecure;
+    cache.supportsProtectedContent = targetSettings.supportsProtectedContent;
+    cache.needsFiltering = targetSettings.needsFiltering;
+    cache.blurSetting = targetSettings.blurSetting;
+    cache.whitePointNits = targetSettings.whitePointNits;
+    cache.viewport = targetSettings.viewport;
+    cache.settings = settings;
+}
+
 // TODO(b/188891810): This method now only ever returns 0 or 1 layers so we should return
 // std::optional instead of a vector.  Additionally, we should consider removing
 // this method entirely in favor of calling prepareClientComposition directly.
 std::vector<compositionengine::LayerFE::LayerSettings> Layer::prepareClientCompositionList(
         compositionengine::LayerFE::ClientCompositionTargetSettings& targetSettings) {
+    if (auto cached = getCachedClientCompositionList(targetSettings)) {
+        return std::move(*cached);
+    }
+
     std::optional<compositionengine::LayerFE::LayerSettings> layerSettings =
             prepareClientComposition(targetSettings);
-    // Nothing to render.
-    if (!layerSettings) {
-        return {};
-    }
 
-    // HWC requests to clear this layer.
-    if (targetSettings.clearContent) {
-        prepareClearClientComposition(*layerSettings, false /* blackout */);
-        return {*layerSettings};
+    std::vector<compositionengine::LayerFE::LayerSettings> results;
+    if (layerSettings) {
+        if (targetSettings.clearContent) {
+            // HWC requests to clear this layer.
+            prepareClearClientComposition(*layerSettings, false /* blackout */);
+        } else {
+            // set the shadow for the layer if needed
+            prepareShadowClientComposition(*layerSettings, targetSettings.viewport);
+        }
+        results.push_back(std::move(*layerSettings));
     }
 
-    // set the shadow for the layer if needed
-    prepareShadowClientComposition(*layerSettings, targetSettings.viewport);
-
-    return {*layerSettings};
+    // Also cache the "nothing to render" case so invisible layers skip the rebuild too.
+    cacheClientCompositionList(targetSettings, results);
+    return results;
 }
 
 aidl::android::hardware::graphics::composer3::Composition Layer::getCompositionType(
@@ -800,6 +845,7 @@ bool Layer::setLayer(int32_t z) {
     mDrawingState.sequence++;
     mDrawingState.z = z;
     mDrawingState.modified = true;
+    bumpOrderGeneration();
 
     mFlinger->mSomeChildrenChanged = true;
 
@@ -819,6 +865,9 @@ void Layer::removeZOrderRelative(const wp<Layer>& relative) {
     mDrawingState.zOrderRelatives.remove(relative);
     mDrawingState.sequence++;
     mDrawingState.modified = true;
+    // Drop the cached lists as well so they do not hold a strong reference to the relative.
+    clearTraversalCache();
+    bumpOrderGeneration();
     setTransactionFlags(eTransactionNeeded);
 }
 
@@ -826,6 +875,7 @@ void Layer::addZOrderRelative(const wp<Layer>& relative) {
     mDrawingState.zOrderRelatives.add(relative);
     mDrawingState.modified = true;
     mDrawingState.sequence++;
+    bumpOrderGeneration();
     setTransactionFlags(eTransactionNeeded);
 }
 
@@ -835,6 +885,7 @@ void Layer::setZOrderRelativeOf(const wp<Layer>& relativeOf) {
     mDrawingState.modified = true;
     mDrawingState.isRelativeOf = relativeOf != nullptr;
 
+    bumpOrderGeneration();
     setTransactionFlags(eTransactionNeeded);
 }
 
@@ -1566,6 +1617,7 @@ void Layer::addChild(const sp<Layer>& layer) {
 
     mCurrentChildren.add(layer);
     layer->setParent(this);
+    bumpOrderGeneration();
     layer->setGameModeForTree(mGameMode);
     updateTreeHasFrameRateVote();
 }
@@ -1576,6 +1628,9 @@ ssize_t Layer::removeChild(const sp<Layer>& layer) {
 
     layer->setParent(nullptr);
     const auto removeResult = mCurrentChildren.remove(layer);
+    // Drop the cached lists as well so they do not hold a strong reference to the child.
+    clearTraversalCache();
+    bumpOrderGeneration();
 
     updateTreeHasFrameRateVote();
     layer->setGameModeForTree(GameMode::Unsupported);
@@ -1709,6 +1764,19 @@ __attribute__((no_sanitize("unsigned-integer-overflow"))) LayerVector Layer::mak
     return traverse;
 }
 
+const LayerVector& Layer::getTraversalList(LayerVector::StateSet stateSet,
+                                           bool* outSkipRelativeZUsers) {
+    TraversalCache& cache = stateSet == LayerVector::StateSet::Drawing ? mDrawingTraversalCache
+                                                                       : mCurrentTraversalCache;
+    const uint64_t generation = sOrderGeneration.load(std::memory_order_relaxed);
+    if (cache.generation != generation) {
+        cache.list = makeTraversalList(stateSet, &cache.skipRelativeZUsers);
+        cache.generation = generation;
+    }
+    *outSkipRelativeZUsers = cache.skipRelativeZUsers;
+    return cache.list;
+}
+
 /**
  * Negatively signed relatives are before 'this' in Z-order.
  */
@@ -1720,7 +1788,7 @@ void Layer::traverseInZOrder(LayerVector::StateSet stateSet, const LayerVector::
     // However in this case we need to take the responsibility for filtering children which
     // are relatives of another surface here.
     bool skipRelativeZUsers = false;
-    const LayerVector list = makeTraversalList(stateSet, &skipRelativeZUsers);
+    const LayerVector& list = getTraversalList(stateSet, &skipRelativeZUsers);
 
     size_t i = 0;
     for (; i < list.size(); i++) {
@@ -1753,7 +1821,7 @@ void Layer::traverseInReverseZOrder(LayerVector::StateSet stateSet,
                                     const LayerVector::Visitor& visitor) {
     // See traverseInZOrder for documentation.
     bool skipRelativeZUsers = false;
-    LayerVector list = makeTraversalList(stateSet, &skipRelativeZUsers);
+    const LayerVector& list = getTraversalList(stateSet, &skipRelativeZUsers);
 
     int32_t i = 0;
     for (i = int32_t(list.size()) - 1; i >= 0; i--) {
@@ -2004,6 +2072,9 @@ void Layer::commitChildList() {
     }
     mDrawingChildren = mCurrentChildren;
     mDrawingParent = mCurrentParent;
+    // The drawing children just changed; caches rebuilt since the mutation was recorded on the
+    // current state are stale for the drawing state.
+    bumpOrderGeneration();
     if (CC_UNLIKELY(usingRelativeZ(LayerVector::StateSet::Drawing))) {
         auto zOrderRelativeOf = mDrawingState.zOrderRelativeOf.promote();
         if (zOrderRelativeOf == nullptr) return;
@@ -2027,12 +2098,23 @@ void Layer::setInputInfo(const WindowInfo& info) {
 }
 
 LayerProto* Layer::writeToProto(LayersProto& layersProto, uint32_t traceFlags) {
+    LayerProto* layerProto = writeSelfToProto(layersProto, traceFlags);
+
+    for (const sp<Layer>& layer : mDrawingChildren) {
+        layer->writeToProto(layersProto, traceFlags);
+    }
+
+    return layerProto;
+}
+
+LayerProto* Layer::writeSelfToProto(LayersProto& layersProto, uint32_t traceFlags) {
     LayerProto* layerProto = layersProto.add_layers();
     writeToProtoDrawingState(layerProto);
     writeToProtoCommonState(layerProto, LayerVector::StateSet::Drawing, traceFlags);
 
     if (traceFlags & LayerTracing::TRACE_COMPOSITION) {
-        ftl::FakeGuard guard(mFlinger->mStateLock); // Called from the main thread.
+        // Called from the main thread, or from a worker it forked and waits on.
+        ftl::FakeGuard guard(mFlinger->mStateLock);
 
         // Only populate for the primary display.
         if (const auto display = mFlinger->getDefaultDisplayDeviceLocked()) {
@@ -2043,11 +2125,14 @@ LayerProto* Layer::writeToProto(LayersProto& layersProto, uint32_t traceFlags) {
         }
     }
 
+    return layerProto;
+}
+
+void Layer::appendDrawingHierarchy(std::vector<Layer*>& outLayers) {
+    outLayers.push_back(this);
     for (const sp<Layer>& layer : mDrawingChildren) {
-        layer->writeToProto(layersProto, traceFlags);
+        layer->appendDrawingHierarchy(outLayers);
     }
-
-    return layerProto;
 }
 
 void Layer::writeToProtoDrawingState(LayerProto* layerInfo) {
@@ -2526,6 +2611,7 @@ void Layer::updateClonedDrawingState(std::map<sp<Layer>, sp<Layer>>& clonedLayer
 void Layer::updateClonedChildren(const sp<Layer>& mirrorRoot,
                                  std::map<sp<Layer>, sp<Layer>>& clonedLayersMap) {
     mDrawingChildren.clear();
+    bumpOrderGeneration();
 
     if (!isClonedFromAlive()) {
         return;
@@ -2567,6 +2653,7 @@ void Layer::updateClonedInputInfo(const std::map<sp<Layer>, sp<Layer>>& clonedLa
 void Layer::updateClonedRelatives(const std::map<sp<Layer>, sp<Layer>>& clonedLayersMap) {
     mDrawingState.zOrderRelativeOf = nullptr;
     mDrawingState.zOrderRelatives.clear();
+    bumpOrderGeneration();
 
     if (!isClonedFromAlive()) {
         return;
@@ -2602,6 +2689,8 @@ void Layer::updateClonedRelatives(const std::map<sp<Layer>, sp<Layer>>& clonedLa
 void Layer::addChildToDrawing(const sp<Layer>& layer) {
     mDrawingChildren.add(layer);
     layer->mDrawingParent = this;
+    bumpOrderGeneration();
+    mFlinger->mDrawingState.invalidateTraversalCache();
 }
 
 Layer::FrameRateCompatibility Layer::FrameRate::convertCompatibility(int8_t compatibility) {
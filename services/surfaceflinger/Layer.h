@@ -686,6 +686,14 @@ public:
 
     LayerProto* writeToProto(LayersProto& layersProto, uint32_t traceFlags);
 
+    // Serializes only this layer, without recursing into its children; used by
+    // the sharded proto dump, which flattens the hierarchy first.
+    LayerProto* writeSelfToProto(LayersProto& layersProto, uint32_t traceFlags);
+
+    // Appends this layer and its drawing children in writeToProto() emission
+    // order, so a flattened dump serializes layers identically.
+    void appendDrawingHierarchy(std::vector<Layer*>& outLayers);
+
     // Write states that are modified by the main thread. This includes drawing
     // state as well as buffer data. This should be called in the main or tracing
     // thread.
@@ -940,6 +948,17 @@ protected:
     void prepareClearClientComposition(LayerFE::LayerSettings&, bool blackout) const;
     void prepareShadowClientComposition(LayerFE::LayerSettings& caster, const Rect& layerStackRect);
 
+    // Returns the LayerSettings list built by the last prepareClientCompositionList call if the
+    // layer's visual state generation and the target settings still match the ones it was built
+    // with, or std::nullopt on a miss.
+    std::optional<std::vector<LayerFE::LayerSettings>> getCachedClientCompositionList(
+            const LayerFE::ClientCompositionTargetSettings&) const;
+
+    // Remembers |settings| as the prepareClientCompositionList output for the current visual
+    // state generation and the given target settings.
+    void cacheClientCompositionList(const LayerFE::ClientCompositionTargetSettings&,
+                                    const std::vector<LayerFE::LayerSettings>& settings);
+
     void prepareBasicGeometryCompositionState();
     void prepareGeometryCompositionState();
     void prepareCursorCompositionState();
@@ -953,6 +972,9 @@ protected:
     void setupRoundedCornersCropCoordinates(Rect win, const FloatRect& roundedCornersCrop) const;
     void setParent(const sp<Layer>&);
     LayerVector makeTraversalList(LayerVector::StateSet, bool* outSkipRelativeZUsers);
+    // Returns the cached result of makeTraversalList, rebuilding it only when a z-order or
+    // hierarchy mutation has bumped the global order generation since it was last built.
+    const LayerVector& getTraversalList(LayerVector::StateSet, bool* outSkipRelativeZUsers);
     void addZOrderRelative(const wp<Layer>& relative);
     void removeZOrderRelative(const wp<Layer>& relative);
     compositionengine::OutputLayer* findOutputLayerForDisplay(const DisplayDevice*) const;
@@ -1004,6 +1026,13 @@ protected:
     // Whether filtering is needed b/c of the drawingstate
     bool mNeedsFiltering{false};
 
+    // Generation number for the inputs of prepareClientComposition. Bumped when bounds are
+    // recomputed or when a new buffer or sideband stream is latched; committed state changes on
+    // this layer or any ancestor funnel through computeBounds as well, since they mark the
+    // visible regions dirty. Used to decide whether the cached client composition list can be
+    // reused. Starts at 1 so an empty cache (generation 0) never matches.
+    uint64_t mVisualStateGeneration = 1;
+
     std::atomic<bool> mRemovedFromDrawingState{false};
 
     // page-flip thread (currently main thread)
@@ -1020,6 +1049,33 @@ protected:
     LayerVector mCurrentChildren{LayerVector::StateSet::Current};
     LayerVector mDrawingChildren{LayerVector::StateSet::Drawing};
 
+    // Cached makeTraversalList results, keyed on sOrderGeneration so the per-frame z-order
+    // traversals reuse the same flattened list until a mutation invalidates it. A generation
+    // of 0 marks the cache invalid; the global generation starts at 1.
+    struct TraversalCache {
+        explicit TraversalCache(LayerVector::StateSet stateSet) : list(stateSet) {}
+        uint64_t generation = 0;
+        bool skipRelativeZUsers = false;
+        LayerVector list;
+    };
+    TraversalCache mCurrentTraversalCache{LayerVector::StateSet::Current};
+    TraversalCache mDrawingTraversalCache{LayerVector::StateSet::Drawing};
+
+    // Incremented whenever any layer's z-order, relative layering or hierarchy changes, which
+    // lazily invalidates every layer's cached traversal list.
+    static std::atomic<uint64_t> sOrderGeneration;
+    static void bumpOrderGeneration() {
+        sOrderGeneration.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Drops the cached lists immediately, releasing the strong references they hold. Used when
+    // a child or relative is removed so the cache does not keep it alive.
+    void clearTraversalCache() {
+        mCurrentTraversalCache.generation = 0;
+        mCurrentTraversalCache.list.clear();
+        mDrawingTraversalCache.generation = 0;
+        mDrawingTraversalCache.list.clear();
+    }
+
     wp<Layer> mCurrentParent;
     wp<Layer> mDrawingParent;
 
@@ -1104,6 +1160,24 @@ private:
     // Layer bounds in screen space.
     FloatRect mScreenBounds;
 
+    // Cached output of prepareClientCompositionList along with the inputs it was built from,
+    // so GPU-composed frames with static content can skip rebuilding the settings. A single
+    // slot covers the common case of one GPU-composed display; other callers (screenshots,
+    // the cached set planner) simply miss and rebuild as before.
+    struct {
+        uint64_t generation = 0;
+        bool realContentIsVisible = false;
+        bool clearContent = false;
+        bool isSecure = false;
+        bool supportsProtectedContent = false;
+        bool needsFiltering = false;
+        LayerFE::ClientCompositionTargetSettings::BlurSetting blurSetting =
+                LayerFE::ClientCompositionTargetSettings::BlurSetting::Disabled;
+        float whitePointNits = 0.f;
+        Rect viewport;
+        std::vector<LayerFE::LayerSettings> settings;
+    } mClientCompositionCache;
+
     bool mGetHandleCalled = false;
 
     // Tracks the process and user id of the caller when creating this layer
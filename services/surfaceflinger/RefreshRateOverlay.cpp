@@ -61,8 +61,10 @@ SurfaceControlHolder::~SurfaceControlHolder() {
     // Hand the sp<SurfaceControl> to the helper thread to release the last
     // reference. This makes sure that the SurfaceControl is destructed without
     // SurfaceFlinger::mStateLock held.
-    BackgroundExecutor::getInstance().sendCallbacks(
-            {[sc = std::move(mSurfaceControl)]() mutable { sc.clear(); }});
+    BackgroundExecutor::getInstance().sendCallbacks({[sc = std::move(mSurfaceControl)]() mutable {
+                                                        sc.clear();
+                                                    }},
+                                                    BackgroundExecutor::kRefreshRateOverlayTag);
 }
 
 void RefreshRateOverlay::SevenSegmentDrawer::drawSegment(Segment segment, int left, SkColor color,
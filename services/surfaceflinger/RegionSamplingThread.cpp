@@ -36,6 +36,7 @@
 #include <ui/DisplayStatInfo.h>
 #include <utils/Trace.h>
 
+#include <algorithm>
 #include <string>
 
 #include "DisplayDevice.h"
@@ -98,6 +99,8 @@ RegionSamplingThread::EnvironmentTimingTunables::EnvironmentTimingTunables() {
 RegionSamplingThread::RegionSamplingThread(SurfaceFlinger& flinger, const TimingTunables& tunables)
       : mFlinger(flinger),
         mTunables(tunables),
+        mSamplingDownscale(uint32_t(
+                std::clamp(property_get_int32("debug.sf.region_sampling_downscale", 4), 1, 16))),
         mIdleTimer(
                 "RegSampIdle",
                 std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -225,7 +228,8 @@ float sampleArea(const uint32_t* data, int32_t width, int32_t height, int32_t st
 
 std::vector<float> RegionSamplingThread::sampleBuffer(
         const sp<GraphicBuffer>& buffer, const Point& leftTop,
-        const std::vector<RegionSamplingThread::Descriptor>& descriptors, uint32_t orientation) {
+        const std::vector<RegionSamplingThread::Descriptor>& descriptors, uint32_t orientation,
+        uint32_t downscale) {
     void* data_raw = nullptr;
     buffer->lock(GRALLOC_USAGE_SW_READ_OFTEN, &data_raw);
     std::shared_ptr<uint32_t> data(reinterpret_cast<uint32_t*>(data_raw),
@@ -238,8 +242,18 @@ std::vector<float> RegionSamplingThread::sampleBuffer(
     std::vector<float> lumas(descriptors.size());
     std::transform(descriptors.begin(), descriptors.end(), lumas.begin(),
                    [&](auto const& descriptor) {
-                       return sampleArea(data.get(), width, height, stride, orientation,
-                                         descriptor.area - leftTop);
+                       // Map the sampling area into the (possibly downscaled) buffer. Round
+                       // outwards so a non-empty area always covers at least one pixel, then
+                       // clamp to the buffer in case the capture rounded the size up.
+                       Rect area = descriptor.area - leftTop;
+                       if (downscale > 1) {
+                           const int32_t d = int32_t(downscale);
+                           area = Rect(area.left / d, area.top / d,
+                                       std::min(width, (area.right + d - 1) / d),
+                                       std::min(height, (area.bottom + d - 1) / d));
+                       }
+                       if (area.getWidth() <= 0 || area.getHeight() <= 0) return 0.0f;
+                       return sampleArea(data.get(), width, height, stride, orientation, area);
                    });
     return lumas;
 }
@@ -275,10 +289,17 @@ void RegionSamplingThread::captureSample() {
     }
 
     const Rect sampledBounds = sampleRegion.bounds();
+    // Request a downscaled capture so the GPU does the bulk of the luma
+    // reduction while rendering the screenshot; the CPU pass then only reads
+    // back 1/(downscale^2) of the pixels. Round the size up so no sampled
+    // content is cropped away.
+    const int32_t downscale = int32_t(mSamplingDownscale);
+    const ui::Size sampledSize((sampledBounds.getWidth() + downscale - 1) / downscale,
+                               (sampledBounds.getHeight() + downscale - 1) / downscale);
     constexpr bool kUseIdentityTransform = false;
 
     SurfaceFlinger::RenderAreaFuture renderAreaFuture = ftl::defer([=] {
-        return DisplayRenderArea::create(displayWeak, sampledBounds, sampledBounds.getSize(),
+        return DisplayRenderArea::create(displayWeak, sampledBounds, sampledSize,
                                          ui::Dataspace::V0_SRGB, kUseIdentityTransform);
     });
 
@@ -326,14 +347,14 @@ void RegionSamplingThread::captureSample() {
     };
 
     std::shared_ptr<renderengine::ExternalTexture> buffer = nullptr;
-    if (mCachedBuffer && mCachedBuffer->getBuffer()->getWidth() == sampledBounds.getWidth() &&
-        mCachedBuffer->getBuffer()->getHeight() == sampledBounds.getHeight()) {
+    if (mCachedBuffer && mCachedBuffer->getBuffer()->getWidth() == uint32_t(sampledSize.width) &&
+        mCachedBuffer->getBuffer()->getHeight() == uint32_t(sampledSize.height)) {
         buffer = mCachedBuffer;
     } else {
         const uint32_t usage =
                 GRALLOC_USAGE_SW_READ_OFTEN | GRALLOC_USAGE_HW_RENDER | GRALLOC_USAGE_HW_TEXTURE;
         sp<GraphicBuffer> graphicBuffer =
-                new GraphicBuffer(sampledBounds.getWidth(), sampledBounds.getHeight(),
+                new GraphicBuffer(uint32_t(sampledSize.width), uint32_t(sampledSize.height),
                                   PIXEL_FORMAT_RGBA_8888, 1, usage, "RegionSamplingThread");
         const status_t bufferStatus = graphicBuffer->initCheck();
         LOG_ALWAYS_FATAL_IF(bufferStatus != OK, "captureSample: Buffer failed to allocate: %d",
@@ -364,7 +385,7 @@ void RegionSamplingThread::captureSample() {
 
     ALOGV("Sampling %zu descriptors", activeDescriptors.size());
     std::vector<float> lumas = sampleBuffer(buffer->getBuffer(), sampledBounds.leftTop(),
-                                            activeDescriptors, orientation);
+                                            activeDescriptors, orientation, mSamplingDownscale);
     if (lumas.size() != activeDescriptors.size()) {
         ALOGW("collected %zu median luma values for %zu descriptors", lumas.size(),
               activeDescriptors.size());
@@ -93,7 +93,8 @@ private:
 
     std::vector<float> sampleBuffer(
             const sp<GraphicBuffer>& buffer, const Point& leftTop,
-            const std::vector<RegionSamplingThread::Descriptor>& descriptors, uint32_t orientation);
+            const std::vector<RegionSamplingThread::Descriptor>& descriptors, uint32_t orientation,
+            uint32_t downscale);
 
     void doSample(std::optional<std::chrono::steady_clock::time_point> samplingDeadline);
     void binderDied(const wp<IBinder>& who) override;
@@ -104,6 +105,11 @@ private:
 
     SurfaceFlinger& mFlinger;
     const TimingTunables mTunables;
+    // debug.sf.region_sampling_downscale
+    // Scale divisor applied to the captured region so the GPU performs the
+    // bulk of the luma reduction during the screenshot render and the CPU
+    // pass reads back a small buffer. 1 disables downscaling.
+    const uint32_t mSamplingDownscale;
     scheduler::OneShotTimer mIdleTimer;
 
     std::thread mThread;
@@ -20,8 +20,11 @@
 
 #define ATRACE_TAG ATRACE_TAG_GRAPHICS
 
+#include <errno.h>
 #include <pthread.h>
 #include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 
 #include <chrono>
@@ -32,7 +35,9 @@
 #include <android-base/stringprintf.h>
 
 #include <binder/IPCThreadState.h>
+#include <binder/ParcelFileDescriptor.h>
 
+#include <cutils/ashmem.h>
 #include <cutils/compiler.h>
 #include <cutils/sched_policy.h>
 
@@ -164,11 +169,32 @@ EventThreadConnection::EventThreadConnection(
         mOwnerUid(callingUid),
         mEventRegistration(eventRegistration),
         mEventThread(eventThread),
-        mChannel(gui::BitTube::DefaultSize) {}
+        mChannel(gui::BitTube::DefaultSize) {
+    // The mailbox is best effort: if it cannot be set up, clients simply keep
+    // reading vsync events through the BitTube.
+    mMailboxFd.reset(ashmem_create_region("vsync-event-mailbox",
+                                          sizeof(gui::VsyncEventMailbox)));
+    if (mMailboxFd.ok()) {
+        void* mapping = mmap(nullptr, sizeof(gui::VsyncEventMailbox), PROT_READ | PROT_WRITE,
+                             MAP_SHARED, mMailboxFd.get(), 0);
+        if (mapping == MAP_FAILED) {
+            ALOGW("Failed to map the vsync event mailbox: %s", strerror(errno));
+            mMailboxFd.reset();
+        } else {
+            // Our writable mapping stays valid; clients can only map the
+            // region read-only from here on.
+            ashmem_set_prot_region(mMailboxFd.get(), PROT_READ);
+            mMailbox = new (mapping) gui::VsyncEventMailbox();
+        }
+    }
+}
 
 EventThreadConnection::~EventThreadConnection() {
-    // do nothing here -- clean-up will happen automatically
-    // when the main thread wakes up
+    // Clean-up of the event thread registration happens automatically when
+    // the main thread wakes up.
+    if (mMailbox != nullptr) {
+        munmap(mMailbox, sizeof(gui::VsyncEventMailbox));
+    }
 }
 
 void EventThreadConnection::onFirstRef() {
@@ -205,11 +231,27 @@ binder::Status EventThreadConnection::getLatestVsyncEventData(
     return binder::Status::ok();
 }
 
+binder::Status EventThreadConnection::getLatestVsyncEventMemory(
+        os::ParcelFileDescriptor* outMemory) {
+    if (!mMailboxFd.ok()) {
+        return binder::Status::fromStatusT(NAME_NOT_FOUND);
+    }
+
+    outMemory->reset(base::unique_fd(dup(mMailboxFd.get())));
+    return binder::Status::ok();
+}
+
 status_t EventThreadConnection::postEvent(const DisplayEventReceiver::Event& event) {
     constexpr auto toStatus = [](ssize_t size) {
         return size < 0 ? status_t(size) : status_t(NO_ERROR);
     };
 
+    // Publish the latest vsync in the shared mailbox before waking the client
+    // through the BitTube, so a reader woken by this event sees it.
+    if (event.header.type == DisplayEventReceiver::DISPLAY_EVENT_VSYNC && mMailbox != nullptr) {
+        mMailbox->publish(event);
+    }
+
     if (event.header.type == DisplayEventReceiver::DISPLAY_EVENT_FRAME_RATE_OVERRIDE ||
         event.header.type == DisplayEventReceiver::DISPLAY_EVENT_FRAME_RATE_OVERRIDE_FLUSH) {
         mPendingEvents.emplace_back(event);
@@ -318,6 +360,35 @@ void EventThread::removeDisplayEventConnectionLocked(const wp<EventThreadConnect
     if (it != mDisplayEventConnections.cend()) {
         mDisplayEventConnections.erase(it);
     }
+    removeVsyncActiveConnectionLocked(connection);
+}
+
+void EventThread::addVsyncActiveConnectionLocked(const wp<EventThreadConnection>& connection) {
+    auto it = std::find(mVsyncActiveConnections.cbegin(), mVsyncActiveConnections.cend(),
+            connection);
+    if (it == mVsyncActiveConnections.cend()) {
+        mVsyncActiveConnections.push_back(connection);
+    }
+}
+
+void EventThread::removeVsyncActiveConnectionLocked(const wp<EventThreadConnection>& connection) {
+    auto it = std::find(mVsyncActiveConnections.cbegin(), mVsyncActiveConnections.cend(),
+            connection);
+    if (it != mVsyncActiveConnections.cend()) {
+        mVsyncActiveConnections.erase(it);
+    }
+}
+
+bool EventThread::pruneVsyncActiveConnectionsLocked() {
+    auto it = mVsyncActiveConnections.begin();
+    while (it != mVsyncActiveConnections.end()) {
+        if (it->promote()) {
+            ++it;
+        } else {
+            it = mVsyncActiveConnections.erase(it);
+        }
+    }
+    return !mVsyncActiveConnections.empty();
 }
 
 void EventThread::setVsyncRate(uint32_t rate, const sp<EventThreadConnection>& connection) {
@@ -329,7 +400,13 @@ void EventThread::setVsyncRate(uint32_t rate, const sp<EventThreadConnection>& c
 
     const auto request = rate == 0 ? VSyncRequest::None : static_cast<VSyncRequest>(rate);
     if (connection->vsyncRequest != request) {
+        const bool wasActive = connection->vsyncRequest != VSyncRequest::None;
         connection->vsyncRequest = request;
+        if (request == VSyncRequest::None) {
+            removeVsyncActiveConnectionLocked(connection);
+        } else if (!wasActive) {
+            addVsyncActiveConnectionLocked(connection);
+        }
         mCondition.notify_all();
     }
 }
@@ -343,6 +420,7 @@ void EventThread::requestNextVsync(const sp<EventThreadConnection>& connection)
 
     if (connection->vsyncRequest == VSyncRequest::None) {
         connection->vsyncRequest = VSyncRequest::Single;
+        addVsyncActiveConnectionLocked(connection);
         mCondition.notify_all();
     } else if (connection->vsyncRequest == VSyncRequest::SingleSuppressCallback) {
         connection->vsyncRequest = VSyncRequest::Single;
@@ -463,19 +541,43 @@ void EventThread::threadMain(std::unique_lock<std::mutex>& lock) {
         bool vsyncRequested = false;
 
         // Find connections that should consume this event.
-        auto it = mDisplayEventConnections.begin();
-        while (it != mDisplayEventConnections.end()) {
-            if (const auto connection = it->promote()) {
-                vsyncRequested |= connection->vsyncRequest != VSyncRequest::None;
+        if (event && event->header.type == DisplayEventReceiver::DISPLAY_EVENT_VSYNC) {
+            // Only the connections that requested vsync can consume one, so walk the
+            // active subset rather than every registered connection.
+            auto it = mVsyncActiveConnections.begin();
+            while (it != mVsyncActiveConnections.end()) {
+                if (const auto connection = it->promote()) {
+                    if (shouldConsumeEvent(*event, connection)) {
+                        consumers.push_back(connection);
+                    }
 
-                if (event && shouldConsumeEvent(*event, connection)) {
-                    consumers.push_back(connection);
+                    // shouldConsumeEvent consumes single-shot requests.
+                    if (connection->vsyncRequest == VSyncRequest::None) {
+                        it = mVsyncActiveConnections.erase(it);
+                    } else {
+                        ++it;
+                    }
+                } else {
+                    it = mVsyncActiveConnections.erase(it);
                 }
+            }
+
+            vsyncRequested = !mVsyncActiveConnections.empty();
+        } else {
+            auto it = mDisplayEventConnections.begin();
+            while (it != mDisplayEventConnections.end()) {
+                if (const auto connection = it->promote()) {
+                    if (event && shouldConsumeEvent(*event, connection)) {
+                        consumers.push_back(connection);
+                    }
 
-                ++it;
-            } else {
-                it = mDisplayEventConnections.erase(it);
+                    ++it;
+                } else {
+                    it = mDisplayEventConnections.erase(it);
+                }
             }
+
+            vsyncRequested = pruneVsyncActiveConnectionsLocked();
         }
 
         if (!consumers.empty()) {
@@ -629,14 +731,23 @@ void EventThread::generateFrameTimeline(VsyncEventData& outVsyncEventData, nsecs
 
 void EventThread::dispatchEvent(const DisplayEventReceiver::Event& event,
                                 const DisplayEventConsumers& consumers) {
+    // Consumers sharing a frame interval receive an identical payload, so generate the
+    // frame timeline (and its vsync id tokens) once per distinct interval rather than
+    // once per consumer. Intervals only differ for uids with a frame rate override, so
+    // in practice the payload is computed once and fanned out to every consumer.
+    DisplayEventReceiver::Event copy = event;
+    std::optional<int64_t> lastFrameInterval;
+
     for (const auto& consumer : consumers) {
-        DisplayEventReceiver::Event copy = event;
         if (event.header.type == DisplayEventReceiver::DISPLAY_EVENT_VSYNC) {
             const int64_t frameInterval = mGetVsyncPeriodFunction(consumer->mOwnerUid);
-            copy.vsync.vsyncData.frameInterval = frameInterval;
-            generateFrameTimeline(copy.vsync.vsyncData, frameInterval, copy.header.timestamp,
-                                  event.vsync.vsyncData.preferredExpectedPresentationTime(),
-                                  event.vsync.vsyncData.preferredDeadlineTimestamp());
+            if (frameInterval != lastFrameInterval) {
+                lastFrameInterval = frameInterval;
+                copy.vsync.vsyncData.frameInterval = frameInterval;
+                generateFrameTimeline(copy.vsync.vsyncData, frameInterval, copy.header.timestamp,
+                                      event.vsync.vsyncData.preferredExpectedPresentationTime(),
+                                      event.vsync.vsyncData.preferredDeadlineTimestamp());
+            }
         }
         switch (consumer->postEvent(copy)) {
             case NO_ERROR:
@@ -672,7 +783,8 @@ void EventThread::dump(std::string& result) const {
         StringAppendF(&result, "    %s\n", toString(event).c_str());
     }
 
-    StringAppendF(&result, "  connections (count=%zu):\n", mDisplayEventConnections.size());
+    StringAppendF(&result, "  connections (count=%zu, vsync-active=%zu):\n",
+                  mDisplayEventConnections.size(), mVsyncActiveConnections.size());
     for (const auto& ptr : mDisplayEventConnections) {
         if (const auto connection = ptr.promote()) {
             StringAppendF(&result, "    %s\n", toString(*connection).c_str());
@@ -17,9 +17,11 @@
 #pragma once
 
 #include <android-base/thread_annotations.h>
+#include <android-base/unique_fd.h>
 #include <android/gui/BnDisplayEventConnection.h>
 #include <gui/DisplayEventReceiver.h>
 #include <private/gui/BitTube.h>
+#include <private/gui/VsyncEventMailbox.h>
 #include <sys/types.h>
 #include <utils/Errors.h>
 
@@ -101,6 +103,7 @@ public:
     binder::Status setVsyncRate(int rate) override;
     binder::Status requestNextVsync() override; // asynchronous
     binder::Status getLatestVsyncEventData(ParcelableVsyncEventData* outVsyncEventData) override;
+    binder::Status getLatestVsyncEventMemory(os::ParcelFileDescriptor* outMemory) override;
 
     // Called in response to requestNextVsync.
     const ResyncCallback resyncCallback;
@@ -115,6 +118,11 @@ private:
     std::mutex mLock;
     gui::BitTube mChannel GUARDED_BY(mLock);
 
+    // Shared read-only with the client so it can poll the latest vsync
+    // without a syscall. Only written from the event thread, in postEvent.
+    base::unique_fd mMailboxFd;
+    gui::VsyncEventMailbox* mMailbox = nullptr;
+
     std::vector<DisplayEventReceiver::Event> mPendingEvents;
 };
 
@@ -215,6 +223,13 @@ private:
     void removeDisplayEventConnectionLocked(const wp<EventThreadConnection>& connection)
             REQUIRES(mMutex);
 
+    void addVsyncActiveConnectionLocked(const wp<EventThreadConnection>& connection)
+            REQUIRES(mMutex);
+    void removeVsyncActiveConnectionLocked(const wp<EventThreadConnection>& connection)
+            REQUIRES(mMutex);
+    // Drops dead connections from the active list and returns whether any remain.
+    bool pruneVsyncActiveConnectionsLocked() REQUIRES(mMutex);
+
     // Implements VSyncSource::Callback
     void onVSyncEvent(nsecs_t timestamp, VSyncSource::VSyncData vsyncData) override;
 
@@ -237,6 +252,12 @@ private:
     mutable std::condition_variable mCondition;
 
     std::vector<wp<EventThreadConnection>> mDisplayEventConnections GUARDED_BY(mMutex);
+
+    // Subset of mDisplayEventConnections whose vsyncRequest is not VSyncRequest::None,
+    // maintained on every request transition, so per-vsync dispatch walks only the
+    // connections that asked for vsync rather than every registered one.
+    std::vector<wp<EventThreadConnection>> mVsyncActiveConnections GUARDED_BY(mMutex);
+
     std::deque<DisplayEventReceiver::Event> mPendingEvents GUARDED_BY(mMutex);
 
     // VSYNC state of connected display.
@@ -14,25 +14,41 @@
  * limitations under the License.
  */
 
+#include <atomic>
+
 #include "FrameRateOverrideMappings.h"
 
 namespace android::scheduler {
 using FrameRateOverride = DisplayEventReceiver::Event::FrameRateOverride;
 
+std::shared_ptr<const FrameRateOverrideMappings::Snapshot> FrameRateOverrideMappings::getSnapshot()
+        const {
+    return std::atomic_load_explicit(&mSnapshot, std::memory_order_acquire);
+}
+
+void FrameRateOverrideMappings::publishSnapshot() {
+    auto snapshot = std::make_shared<const Snapshot>(
+            Snapshot{mFrameRateOverridesByContent, mFrameRateOverridesFromBackdoor,
+                     mFrameRateOverridesFromGameManager});
+    std::atomic_store_explicit(&mSnapshot, std::move(snapshot), std::memory_order_release);
+}
+
 std::optional<Fps> FrameRateOverrideMappings::getFrameRateOverrideForUid(
         uid_t uid, bool supportsFrameRateOverrideByContent) const {
-    std::lock_guard lock(mFrameRateOverridesLock);
+    // Read from the published snapshot so this lookup, which runs on EventThread for every
+    // connection on every vsync, never contends with writers.
+    const std::shared_ptr<const Snapshot> snapshot = getSnapshot();
 
     {
-        const auto iter = mFrameRateOverridesFromBackdoor.find(uid);
-        if (iter != mFrameRateOverridesFromBackdoor.end()) {
+        const auto iter = snapshot->overridesFromBackdoor.find(uid);
+        if (iter != snapshot->overridesFromBackdoor.end()) {
             return iter->second;
         }
     }
 
     {
-        const auto iter = mFrameRateOverridesFromGameManager.find(uid);
-        if (iter != mFrameRateOverridesFromGameManager.end()) {
+        const auto iter = snapshot->overridesFromGameManager.find(uid);
+        if (iter != snapshot->overridesFromGameManager.end()) {
             return iter->second;
         }
     }
@@ -42,8 +58,8 @@ std::optional<Fps> FrameRateOverrideMappings::getFrameRateOverrideForUid(
     }
 
     {
-        const auto iter = mFrameRateOverridesByContent.find(uid);
-        if (iter != mFrameRateOverridesByContent.end()) {
+        const auto iter = snapshot->overridesByContent.find(uid);
+        if (iter != snapshot->overridesByContent.end()) {
             return iter->second;
         }
     }
@@ -53,16 +69,16 @@ std::optional<Fps> FrameRateOverrideMappings::getFrameRateOverrideForUid(
 
 std::vector<FrameRateOverride> FrameRateOverrideMappings::getAllFrameRateOverrides(
         bool supportsFrameRateOverrideByContent) {
-    std::lock_guard lock(mFrameRateOverridesLock);
+    const std::shared_ptr<const Snapshot> snapshot = getSnapshot();
     std::vector<FrameRateOverride> overrides;
-    overrides.reserve(std::max({mFrameRateOverridesFromGameManager.size(),
-                                mFrameRateOverridesFromBackdoor.size(),
-                                mFrameRateOverridesByContent.size()}));
+    overrides.reserve(std::max({snapshot->overridesFromGameManager.size(),
+                                snapshot->overridesFromBackdoor.size(),
+                                snapshot->overridesByContent.size()}));
 
-    for (const auto& [uid, frameRate] : mFrameRateOverridesFromBackdoor) {
+    for (const auto& [uid, frameRate] : snapshot->overridesFromBackdoor) {
         overrides.emplace_back(FrameRateOverride{uid, frameRate.getValue()});
     }
-    for (const auto& [uid, frameRate] : mFrameRateOverridesFromGameManager) {
+    for (const auto& [uid, frameRate] : snapshot->overridesFromGameManager) {
         if (std::find_if(overrides.begin(), overrides.end(),
                          [uid = uid](auto i) { return i.uid == uid; }) == overrides.end()) {
             overrides.emplace_back(FrameRateOverride{uid, frameRate.getValue()});
@@ -73,7 +89,7 @@ std::vector<FrameRateOverride> FrameRateOverrideMappings::getAllFrameRateOverrid
         return overrides;
     }
 
-    for (const auto& [uid, frameRate] : mFrameRateOverridesByContent) {
+    for (const auto& [uid, frameRate] : snapshot->overridesByContent) {
         if (std::find_if(overrides.begin(), overrides.end(),
                          [uid = uid](auto i) { return i.uid == uid; }) == overrides.end()) {
             overrides.emplace_back(FrameRateOverride{uid, frameRate.getValue()});
@@ -116,6 +132,7 @@ bool FrameRateOverrideMappings::updateFrameRateOverridesByContent(
                         return lhs.first == rhs.first && isApproxEqual(lhs.second, rhs.second);
                     })) {
         mFrameRateOverridesByContent = frameRateOverrides;
+        publishSnapshot();
         return true;
     }
     return false;
@@ -129,6 +146,7 @@ void FrameRateOverrideMappings::setGameModeRefreshRateForUid(FrameRateOverride f
     } else {
         mFrameRateOverridesFromGameManager.erase(frameRateOverride.uid);
     }
+    publishSnapshot();
 }
 
 void FrameRateOverrideMappings::setPreferredRefreshRateForUid(FrameRateOverride frameRateOverride) {
@@ -139,5 +157,6 @@ void FrameRateOverrideMappings::setPreferredRefreshRateForUid(FrameRateOverride
     } else {
         mFrameRateOverridesFromBackdoor.erase(frameRateOverride.uid);
     }
+    publishSnapshot();
 }
 } // namespace android::scheduler
@@ -21,6 +21,7 @@
 #include <scheduler/Fps.h>
 #include <sys/types.h>
 #include <map>
+#include <memory>
 #include <optional>
 
 namespace android::scheduler {
@@ -30,10 +31,9 @@ class FrameRateOverrideMappings {
 
 public:
     std::optional<Fps> getFrameRateOverrideForUid(uid_t uid,
-                                                  bool supportsFrameRateOverrideByContent) const
-            EXCLUDES(mFrameRateOverridesLock);
-    std::vector<FrameRateOverride> getAllFrameRateOverrides(bool supportsFrameRateOverrideByContent)
-            EXCLUDES(mFrameRateOverridesLock);
+                                                  bool supportsFrameRateOverrideByContent) const;
+    std::vector<FrameRateOverride> getAllFrameRateOverrides(
+            bool supportsFrameRateOverrideByContent);
     void dump(std::string& result) const;
     bool updateFrameRateOverridesByContent(const UidToFrameRateOverride& frameRateOverrides)
             EXCLUDES(mFrameRateOverridesLock);
@@ -43,8 +43,20 @@ public:
             EXCLUDES(mFrameRateOverridesLock);
 
 private:
-    // The frame rate override lists need their own mutex as they are being read
-    // by SurfaceFlinger, Scheduler and EventThread (as a callback) to prevent deadlocks
+    // Immutable copy of the override tables, republished atomically after every update so
+    // readers such as EventThread's per-vsync, per-connection lookup never take a lock.
+    struct Snapshot {
+        UidToFrameRateOverride overridesByContent;
+        UidToFrameRateOverride overridesFromBackdoor;
+        UidToFrameRateOverride overridesFromGameManager;
+    };
+
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+    void publishSnapshot() REQUIRES(mFrameRateOverridesLock);
+
+    // The frame rate override lists need their own mutex as they are being updated
+    // by SurfaceFlinger and Scheduler on different threads. Reads go through the
+    // published snapshot instead so they cannot block vsync delivery.
     mutable std::mutex mFrameRateOverridesLock;
 
     // mappings between a UID and a preferred refresh rate that this app would
@@ -52,5 +64,8 @@ private:
     UidToFrameRateOverride mFrameRateOverridesByContent GUARDED_BY(mFrameRateOverridesLock);
     UidToFrameRateOverride mFrameRateOverridesFromBackdoor GUARDED_BY(mFrameRateOverridesLock);
     UidToFrameRateOverride mFrameRateOverridesFromGameManager GUARDED_BY(mFrameRateOverridesLock);
+
+    // Written under mFrameRateOverridesLock via publishSnapshot(), read with an atomic load.
+    std::shared_ptr<const Snapshot> mSnapshot = std::make_shared<const Snapshot>();
 };
 } // namespace android::scheduler
@@ -64,6 +64,7 @@ void LayerInfo::setLastPresentTime(nsecs_t lastPresentTime, nsecs_t now, LayerUp
             if (mFrameTimes.size() > HISTORY_SIZE) {
                 mFrameTimes.pop_front();
             }
+            mLastHeuristicVote.reset();
             break;
     }
 }
@@ -250,14 +251,20 @@ LayerInfo::LayerVote LayerInfo::getRefreshRateVote(const RefreshRateConfigs& ref
         clearHistory(now);
     }
 
+    if (mLastHeuristicVote) {
+        ALOGV("%s returning vote memoized for the current history", mName.c_str());
+        return *mLastHeuristicVote;
+    }
+
     auto refreshRate = calculateRefreshRateIfPossible(refreshRateConfigs, now);
     if (refreshRate.has_value()) {
         ALOGV("%s calculated refresh rate: %s", mName.c_str(), to_string(*refreshRate).c_str());
-        return {LayerHistory::LayerVoteType::Heuristic, refreshRate.value()};
+        mLastHeuristicVote = LayerVote{LayerHistory::LayerVoteType::Heuristic, refreshRate.value()};
+    } else {
+        ALOGV("%s Max (can't resolve refresh rate)", mName.c_str());
+        mLastHeuristicVote = LayerVote{LayerHistory::LayerVoteType::Max, Fps()};
     }
-
-    ALOGV("%s Max (can't resolve refresh rate)", mName.c_str());
-    return {LayerHistory::LayerVoteType::Max, Fps()};
+    return *mLastHeuristicVote;
 }
 
 const char* LayerInfo::getTraceTag(LayerHistory::LayerVoteType type) const {
@@ -189,6 +189,7 @@ public:
         mFrameTimeValidSince = std::chrono::time_point<std::chrono::steady_clock>(timePoint);
         mLastRefreshRate = {};
         mRefreshRateHistory.clear();
+        mLastHeuristicVote.reset();
     }
 
     void clearHistory(nsecs_t now) {
@@ -283,6 +284,12 @@ private:
 
     RefreshRateHeuristicData mLastRefreshRate;
 
+    // Memoized heuristic vote. The heuristic is derived entirely from the frame time history,
+    // so it stays valid until new history is recorded or the history is cleared. The animating
+    // and infrequent checks are not covered by it, since they change with the passage of time
+    // alone.
+    std::optional<LayerVote> mLastHeuristicVote;
+
     std::deque<FrameTimeData> mFrameTimes;
     std::chrono::time_point<std::chrono::steady_clock> mFrameTimeValidSince =
             std::chrono::steady_clock::now();
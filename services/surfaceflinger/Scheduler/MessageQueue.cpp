@@ -48,12 +48,13 @@ void MessageQueue::Handler::handleMessage(const Message&) {
     const nsecs_t frameTime = systemTime();
     auto& compositor = mQueue.mCompositor;
 
-    if (!compositor.commit(frameTime, mVsyncId, mExpectedVsyncTime)) {
-        return;
+    if (compositor.commit(frameTime, mVsyncId, mExpectedVsyncTime)) {
+        compositor.composite(frameTime, mVsyncId);
+        compositor.sample();
     }
 
-    compositor.composite(frameTime, mVsyncId);
-    compositor.sample();
+    // The frame is done; run housekeeping in whatever slack remains before the next one.
+    mQueue.drainDeferredTasks();
 }
 
 MessageQueue::MessageQueue(ICompositor& compositor)
@@ -165,6 +166,48 @@ void MessageQueue::postMessage(sp<MessageHandler>&& handler) {
     mLooper->sendMessage(handler, Message());
 }
 
+void MessageQueue::postMessageDeferred(sp<MessageHandler>&& handler) {
+    {
+        std::lock_guard lock(mDeferred.mutex);
+        mDeferred.tasks.push_back(std::move(handler));
+    }
+
+    // With no frame in flight there is nothing to yield to, so wake the looper to drain
+    // promptly. Otherwise the tasks run once the pending frame is done.
+    if (!mHandler->isFramePending()) {
+        mLooper->sendMessage(sp<DrainHandler>::make(*this), Message());
+    }
+}
+
+void MessageQueue::drainDeferredTasks() {
+    // Housekeeping must not steal time from commit: run deferred tasks only while no
+    // frame dispatch is pending and the next scheduled frame wakeup leaves slack. Tasks
+    // that do not run here are drained after a later frame, or when the queue goes idle.
+    static constexpr nsecs_t kMinSlack = ms2ns(1);
+
+    while (!mHandler->isFramePending()) {
+        {
+            std::lock_guard lock(mVsync.mutex);
+            if (mVsync.scheduledFrameTime &&
+                *mVsync.scheduledFrameTime - systemTime() < kMinSlack) {
+                return;
+            }
+        }
+
+        sp<MessageHandler> task;
+        {
+            std::lock_guard lock(mDeferred.mutex);
+            if (mDeferred.tasks.empty()) {
+                return;
+            }
+            task = std::move(mDeferred.tasks.front());
+            mDeferred.tasks.pop_front();
+        }
+
+        task->handleMessage(Message());
+    }
+}
+
 void MessageQueue::scheduleFrame() {
     ATRACE_CALL();
 
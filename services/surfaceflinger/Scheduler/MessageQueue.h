@@ -17,6 +17,7 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <future>
 #include <type_traits>
 #include <utility>
@@ -71,6 +72,12 @@ public:
     virtual void setInjector(sp<EventThreadConnection>) = 0;
     virtual void waitMessage() = 0;
     virtual void postMessage(sp<MessageHandler>&&) = 0;
+
+    // Posts a message to the deferred lane, which only runs when no frame dispatch is
+    // pending and the next scheduled frame leaves slack, so that housekeeping does not
+    // delay commit.
+    virtual void postMessageDeferred(sp<MessageHandler>&&) = 0;
+
     virtual void scheduleFrame() = 0;
 
     using Clock = std::chrono::steady_clock;
@@ -126,10 +133,27 @@ private:
         sp<EventThreadConnection> connection GUARDED_BY(mutex);
     };
 
+    // Tasks that run between frames, when the frame schedule leaves slack.
+    struct Deferred {
+        std::mutex mutex;
+        std::deque<sp<MessageHandler>> tasks GUARDED_BY(mutex);
+    };
+
+    // Wakes the looper to drain the deferred lane when no frame is in flight.
+    class DrainHandler : public MessageHandler {
+        MessageQueue& mQueue;
+
+    public:
+        explicit DrainHandler(MessageQueue& queue) : mQueue(queue) {}
+        void handleMessage(const Message&) override { mQueue.drainDeferredTasks(); }
+    };
+
     Vsync mVsync;
     Injector mInjector;
+    Deferred mDeferred;
 
     void injectorCallback();
+    void drainDeferredTasks();
 
 public:
     explicit MessageQueue(ICompositor&);
@@ -141,6 +165,7 @@ public:
 
     void waitMessage() override;
     void postMessage(sp<MessageHandler>&&) override;
+    void postMessageDeferred(sp<MessageHandler>&&) override;
 
     void scheduleFrame() override;
 
@@ -14,31 +14,176 @@
  * limitations under the License.
  */
 
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+
 #include "OneShotTimer.h"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/unistd.h>
+
 #include <utils/Log.h>
 #include <utils/Timers.h>
+#include <utils/Trace.h>
+#include <algorithm>
 #include <chrono>
 #include <sstream>
-#include <thread>
+
+ANDROID_SINGLETON_STATIC_INSTANCE(android::scheduler::OneShotTimerDispatch);
 
 namespace {
 using namespace std::chrono_literals;
 
-constexpr int64_t kNsToSeconds = std::chrono::duration_cast<std::chrono::nanoseconds>(1s).count();
+constexpr size_t kReadPipe = 0;
+constexpr size_t kWritePipe = 1;
 
-// The syscall interface uses a pair of integers for the timestamp. The first
-// (tv_sec) is the whole count of seconds. The second (tv_nsec) is the
-// nanosecond part of the count. This function takes care of translation.
-void calculateTimeoutTime(std::chrono::nanoseconds timestamp, timespec* spec) {
-    const nsecs_t timeout = systemTime(CLOCK_MONOTONIC) + timestamp.count();
-    spec->tv_sec = static_cast<__kernel_time_t>(timeout / kNsToSeconds);
-    spec->tv_nsec = timeout % kNsToSeconds;
-}
+constexpr int64_t kNsToSeconds = std::chrono::duration_cast<std::chrono::nanoseconds>(1s).count();
 } // namespace
 
 namespace android {
 namespace scheduler {
 
+OneShotTimerDispatch::OneShotTimerDispatch() : Singleton<OneShotTimerDispatch>() {
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    LOG_ALWAYS_FATAL_IF(mEpollFd < 0, "epoll_create1 failed (%d)", errno);
+
+    mTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    LOG_ALWAYS_FATAL_IF(mTimerFd < 0, "timerfd_create failed (%d)", errno);
+
+    LOG_ALWAYS_FATAL_IF(pipe2(mPipes.data(), O_CLOEXEC | O_NONBLOCK), "pipe2 failed (%d)", errno);
+
+    epoll_event timerEvent{};
+    timerEvent.events = EPOLLIN;
+    timerEvent.data.fd = mTimerFd;
+    LOG_ALWAYS_FATAL_IF(epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mTimerFd, &timerEvent),
+                        "epoll_ctl failed (%d)", errno);
+
+    epoll_event wakeEvent{};
+    wakeEvent.events = EPOLLIN;
+    wakeEvent.data.fd = mPipes[kReadPipe];
+    LOG_ALWAYS_FATAL_IF(epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mPipes[kReadPipe], &wakeEvent),
+                        "epoll_ctl failed (%d)", errno);
+
+    mDispatchThread = std::thread([this] { threadMain(); });
+}
+
+OneShotTimerDispatch::~OneShotTimerDispatch() {
+    {
+        std::lock_guard lock(mMutex);
+        mStopRequested = true;
+    }
+    wake();
+    mDispatchThread.join();
+
+    close(mEpollFd);
+    close(mTimerFd);
+    close(mPipes[kReadPipe]);
+    close(mPipes[kWritePipe]);
+}
+
+void OneShotTimerDispatch::registerTimer(OneShotTimer* timer) {
+    {
+        std::lock_guard lock(mMutex);
+        if (std::find(mTimers.begin(), mTimers.end(), timer) != mTimers.end()) {
+            return;
+        }
+        mTimers.push_back(timer);
+    }
+    wake();
+}
+
+void OneShotTimerDispatch::unregisterTimer(OneShotTimer* timer) {
+    std::unique_lock lock(mMutex);
+    mTimers.erase(std::remove(mTimers.begin(), mTimers.end(), timer), mTimers.end());
+    if (std::this_thread::get_id() == mDispatchThread.get_id()) {
+        // Called from the timer's own callback; removal from the list is enough.
+        return;
+    }
+    mDispatchedCondition.wait(lock, [this, timer]() REQUIRES(mMutex) {
+        return mDispatching != timer;
+    });
+}
+
+void OneShotTimerDispatch::wake() {
+    char dummy = 0;
+    int result = TEMP_FAILURE_RETRY(write(mPipes[kWritePipe], &dummy, sizeof(dummy)));
+    if (result < 0 && errno != EAGAIN) {
+        ALOGW("Failed to wake timer dispatch thread (%d)", errno);
+    }
+}
+
+void OneShotTimerDispatch::threadMain() {
+    if (pthread_setname_np(pthread_self(), "OneShotTimers")) {
+        ALOGW("Failed to set thread name on dispatch thread");
+    }
+
+    while (dispatchTimers()) {
+        epoll_event events[2];
+        int nfds = epoll_wait(mEpollFd, events, 2, -1);
+        if (nfds < 0) {
+            LOG_ALWAYS_FATAL_IF(errno != EINTR, "epoll_wait failed (%d)", errno);
+            continue;
+        }
+        for (int i = 0; i < nfds; i++) {
+            if (events[i].data.fd == mTimerFd) {
+                uint64_t expirations = 0;
+                read(mTimerFd, &expirations, sizeof(expirations));
+            } else {
+                char buffer[16];
+                while (read(mPipes[kReadPipe], buffer, sizeof(buffer)) > 0) {
+                }
+            }
+        }
+    }
+}
+
+bool OneShotTimerDispatch::dispatchTimers() {
+    std::vector<OneShotTimer*> timers;
+    {
+        std::lock_guard lock(mMutex);
+        if (mStopRequested) {
+            return false;
+        }
+        timers = mTimers;
+    }
+
+    std::optional<std::chrono::nanoseconds> nextWake;
+    for (OneShotTimer* timer : timers) {
+        {
+            std::lock_guard lock(mMutex);
+            if (std::find(mTimers.begin(), mTimers.end(), timer) == mTimers.end()) {
+                // Unregistered (and possibly destroyed) since the snapshot was taken.
+                continue;
+            }
+            mDispatching = timer;
+        }
+        const auto delay = timer->dispatch();
+        {
+            std::lock_guard lock(mMutex);
+            mDispatching = nullptr;
+        }
+        mDispatchedCondition.notify_all();
+
+        if (delay && (!nextWake || *delay < *nextWake)) {
+            nextWake = delay;
+        }
+    }
+
+    // Re-arm the timerfd for the earliest pending deadline, or disarm it when every
+    // timer is idle or stopped; those are prodded through the wake pipe instead.
+    itimerspec timerSpec{};
+    if (nextWake) {
+        const nsecs_t deadline = systemTime(CLOCK_MONOTONIC) + nextWake->count();
+        timerSpec.it_value.tv_sec = static_cast<__kernel_time_t>(deadline / kNsToSeconds);
+        timerSpec.it_value.tv_nsec = deadline % kNsToSeconds;
+    }
+    if (timerfd_settime(mTimerFd, TFD_TIMER_ABSTIME, &timerSpec, nullptr)) {
+        ALOGW("timerfd_settime failed (%d)", errno);
+    }
+    return true;
+}
+
 OneShotTimer::OneShotTimer(std::string name, const Interval& interval,
                            const ResetCallback& resetCallback,
                            const TimeoutCallback& timeoutCallback, std::unique_ptr<Clock> clock)
@@ -56,126 +201,84 @@ OneShotTimer::~OneShotTimer() {
 }
 
 void OneShotTimer::start() {
-    int result = sem_init(&mSemaphore, 0, 0);
-    LOG_ALWAYS_FATAL_IF(result, "sem_init failed");
-
-    if (!mThread.joinable()) {
-        // Only create thread if it has not been created.
-        mThread = std::thread(&OneShotTimer::loop, this);
+    if (mStarted) {
+        return;
     }
+    mStarted = true;
+    mResetTriggered = false;
+    mStopTriggered = false;
+    mState = TimerState::RESET;
+    OneShotTimerDispatch::getInstance().registerTimer(this);
 }
 
 void OneShotTimer::stop() {
-    mStopTriggered = true;
-    int result = sem_post(&mSemaphore);
-    LOG_ALWAYS_FATAL_IF(result, "sem_post failed");
-
-    if (mThread.joinable()) {
-        mThread.join();
-        result = sem_destroy(&mSemaphore);
-        LOG_ALWAYS_FATAL_IF(result, "sem_destroy failed");
+    if (!mStarted) {
+        return;
     }
+    mStarted = false;
+    mStopTriggered = true;
+    OneShotTimerDispatch::getInstance().unregisterTimer(this);
 }
 
-void OneShotTimer::loop() {
-    if (pthread_setname_np(pthread_self(), mName.c_str())) {
-        ALOGW("Failed to set thread name on dispatch thread");
-    }
-
-    TimerState state = TimerState::RESET;
+std::optional<std::chrono::nanoseconds> OneShotTimer::dispatch() {
+    // All timers share the dispatch thread, so tag each evaluation with the timer's name.
+    ATRACE_NAME(mName.c_str());
     while (true) {
-        bool triggerReset = false;
-        bool triggerTimeout = false;
-
-        state = checkForResetAndStop(state);
-        if (state == TimerState::STOPPED) {
-            break;
-        }
-
-        if (state == TimerState::IDLE) {
-            int result = sem_wait(&mSemaphore);
-            if (result && errno != EINTR) {
-                std::stringstream ss;
-                ss << "sem_wait failed (" << errno << ")";
-                LOG_ALWAYS_FATAL("%s", ss.str().c_str());
-            }
-            continue;
-        }
-
-        if (state == TimerState::RESET) {
-            triggerReset = true;
+        mWaiting = false;
+        // Stop takes precedence of the reset.
+        if (mStopTriggered.exchange(false)) {
+            mState = TimerState::STOPPED;
         }
+        const bool resetTriggered = mResetTriggered.exchange(false);
 
-        if (triggerReset && mResetCallback) {
-            mResetCallback();
-        }
+        switch (mState) {
+            case TimerState::STOPPED:
+                return std::nullopt;
 
-        state = checkForResetAndStop(state);
-        if (state == TimerState::STOPPED) {
-            break;
-        }
-
-        auto triggerTime = mClock->now() + mInterval;
-        state = TimerState::WAITING;
-        while (true) {
-            // Wait until triggerTime time to check if we need to reset or drop into the idle state.
-            if (const auto triggerInterval = triggerTime - mClock->now(); triggerInterval > 0ns) {
-                mWaiting = true;
-                struct timespec ts;
-                calculateTimeoutTime(triggerInterval, &ts);
-                int result = sem_clockwait(&mSemaphore, CLOCK_MONOTONIC, &ts);
-                if (result && errno != ETIMEDOUT && errno != EINTR) {
-                    std::stringstream ss;
-                    ss << "sem_clockwait failed (" << errno << ")";
-                    LOG_ALWAYS_FATAL("%s", ss.str().c_str());
+            case TimerState::RESET:
+                if (mResetCallback) {
+                    mResetCallback();
                 }
-            }
+                mTriggerTime = mClock->now() + mInterval;
+                mState = TimerState::WAITING;
+                continue;
 
-            mWaiting = false;
-            state = checkForResetAndStop(state);
-            if (state == TimerState::STOPPED) {
-                break;
-            }
-
-            if (state == TimerState::WAITING && (triggerTime - mClock->now()) <= 0ns) {
-                triggerTimeout = true;
-                state = TimerState::IDLE;
-                break;
-            }
-
-            if (state == TimerState::RESET) {
-                triggerTime = mLastResetTime.load() + mInterval;
-                state = TimerState::WAITING;
+            case TimerState::WAITING: {
+                if (resetTriggered) {
+                    // A reset while waiting only pushes the deadline out; the reset
+                    // callback fires on transitions out of the idle state.
+                    mTriggerTime = mLastResetTime.load() + mInterval;
+                }
+                const auto delay = mTriggerTime - mClock->now();
+                if (delay > 0ns) {
+                    mWaiting = true;
+                    return delay;
+                }
+                if (mTimeoutCallback) {
+                    mTimeoutCallback();
+                }
+                mState = TimerState::IDLE;
+                continue;
             }
-        }
 
-        if (triggerTimeout && mTimeoutCallback) {
-            mTimeoutCallback();
+            case TimerState::IDLE:
+                if (!resetTriggered) {
+                    return std::nullopt;
+                }
+                mState = TimerState::RESET;
+                continue;
         }
     }
 }
 
-OneShotTimer::TimerState OneShotTimer::checkForResetAndStop(TimerState state) {
-    // Stop takes precedence of the reset.
-    if (mStopTriggered.exchange(false)) {
-        return TimerState::STOPPED;
-    }
-    // If the state was stopped, the thread was joined, and we cannot reset
-    // the timer anymore.
-    if (state != TimerState::STOPPED && mResetTriggered.exchange(false)) {
-        return TimerState::RESET;
-    }
-    return state;
-}
-
 void OneShotTimer::reset() {
     mLastResetTime = mClock->now();
     mResetTriggered = true;
-    // If mWaiting is true, then we are guaranteed to be in a block where we are waiting on
-    // mSemaphore for a timeout, rather than idling. So we can avoid a sem_post call since we can
-    // just check that we triggered a reset on timeout.
+    // If mWaiting is true, then the dispatch thread is guaranteed to re-evaluate this
+    // timer when its pending deadline fires, so we can avoid a wakeup and just check
+    // that a reset was triggered then.
     if (!mWaiting) {
-        LOG_ALWAYS_FATAL_IF(sem_post(&mSemaphore), "sem_post failed");
+        OneShotTimerDispatch::getInstance().wake();
     }
 }
 
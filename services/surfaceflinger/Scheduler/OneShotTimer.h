@@ -16,17 +16,68 @@
 
 #pragma once
 
-#include <semaphore.h>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <vector>
 #include "../Clock.h"
 
 #include <android-base/thread_annotations.h>
+#include <utils/Singleton.h>
 
 namespace android {
 namespace scheduler {
 
+class OneShotTimer;
+
+/*
+ * Service that multiplexes every OneShotTimer onto a single timerfd/epoll thread. Each
+ * timer used to park a dedicated thread on a semaphore; with the touch, display power
+ * and idle timers that added up to several always-on threads and their wakeups. Timers
+ * register here when started and their state machines are driven from the shared
+ * dispatch thread, which sleeps on the earliest pending deadline.
+ */
+class OneShotTimerDispatch : public Singleton<OneShotTimerDispatch> {
+public:
+    OneShotTimerDispatch();
+    ~OneShotTimerDispatch();
+
+    // Adds the timer to the dispatch loop and wakes the dispatch thread.
+    void registerTimer(OneShotTimer*) EXCLUDES(mMutex);
+
+    // Removes the timer from the dispatch loop. On return the timer's callbacks are
+    // guaranteed to no longer be running, unless this is called from one of them.
+    void unregisterTimer(OneShotTimer*) EXCLUDES(mMutex);
+
+    // Prods the dispatch thread to re-evaluate timer state, e.g. after a reset while a
+    // timer is idling without a pending deadline.
+    void wake();
+
+private:
+    // Runs the epoll loop waiting on the timerfd and the wake pipe.
+    void threadMain();
+
+    // Drives every registered timer's state machine once, then re-arms the timerfd for
+    // the earliest pending deadline. Returns false when the dispatch thread should exit.
+    bool dispatchTimers() EXCLUDES(mMutex);
+
+    int mEpollFd = -1;
+    int mTimerFd = -1;
+    std::array<int, 2> mPipes = {-1, -1};
+
+    mutable std::mutex mMutex;
+    std::condition_variable mDispatchedCondition;
+    std::vector<OneShotTimer*> mTimers GUARDED_BY(mMutex);
+    // Timer whose callbacks are currently executing, if any.
+    OneShotTimer* mDispatching GUARDED_BY(mMutex) = nullptr;
+    bool mStopRequested GUARDED_BY(mMutex) = false;
+    std::thread mDispatchThread;
+};
+
 /*
  * Class that sets off a timer for a given interval, and fires a callback when the
  * interval expires.
@@ -52,9 +103,11 @@ public:
     std::string dump() const;
 
 private:
+    friend class OneShotTimerDispatch;
+
     // Enum to track in what state is the timer.
     enum class TimerState {
-        // The internal timer thread has been destroyed, and no state is
+        // The timer is not registered with the dispatch thread, and no state is
         // tracked.
         // Possible state transitions: RESET
         STOPPED = 0,
@@ -70,22 +123,14 @@ private:
         IDLE = 3
     };
 
-    // Function that loops until the condition for stopping is met.
-    void loop();
-
-    // Checks whether mResetTriggered and mStopTriggered were set and updates
-    // mState if so.
-    TimerState checkForResetAndStop(TimerState state);
-
-    // Thread waiting for timer to expire.
-    std::thread mThread;
+    // Advances the state machine, firing any due callbacks. Returns how long the
+    // dispatch thread should wait before calling again, or std::nullopt if no wakeup is
+    // needed until an external reset or stop. Only called on the dispatch thread.
+    std::optional<std::chrono::nanoseconds> dispatch();
 
     // Clock object for the timer. Mocked in unit tests.
     std::unique_ptr<Clock> mClock;
 
-    // Semaphore to keep mThread synchronized.
-    sem_t mSemaphore;
-
     // Timer's name.
     std::string mName;
 
@@ -98,9 +143,19 @@ private:
     // Callback that happens when timer expires.
     const TimeoutCallback mTimeoutCallback;
 
-    // After removing lock guarding mState, the state can be now accessed at
-    // any time. Keep a bool if the reset or stop were requested, and occasionally
-    // check in the main loop if they were.
+    // Whether start() has registered this timer with the dispatch service. Only
+    // accessed from the owning thread, like start() and stop() themselves.
+    bool mStarted = false;
+
+    // State machine; only accessed from the dispatch thread, except that start() moves
+    // it to RESET before the timer is registered.
+    TimerState mState = TimerState::STOPPED;
+
+    // Deadline of the pending WAITING interval; only accessed from the dispatch thread.
+    std::chrono::steady_clock::time_point mTriggerTime;
+
+    // The state can be accessed at any time. Keep a bool if the reset or stop were
+    // requested, and check in the dispatch loop if they were.
     std::atomic<bool> mResetTriggered = false;
     std::atomic<bool> mStopTriggered = false;
     std::atomic<bool> mWaiting = false;
@@ -27,6 +27,7 @@
 #include <android-base/properties.h>
 #include <android-base/stringprintf.h>
 #include <ftl/enum.h>
+#include <math/HashCombine.h>
 #include <utils/Trace.h>
 
 #include "../SurfaceFlingerProperties.h"
@@ -257,18 +258,34 @@ float RefreshRateConfigs::calculateLayerScoreLocked(const LayerRequirement& laye
             kNonExactMatchingPenalty;
 }
 
+// Covers exactly the state compared by LayerRequirement::operator== and
+// GlobalSignals::operator==. Hashing the exact desiredRefreshRate is stricter than the
+// approximate comparison it replaces, which can only cause a redundant recompute, never
+// a stale cache hit.
+size_t RefreshRateConfigs::fingerprintArguments(const std::vector<LayerRequirement>& layers,
+                                                GlobalSignals signals) {
+    size_t hash = hashCombine(signals.touch, signals.idle);
+    for (const auto& layer : layers) {
+        hashCombineSingleHashed(hash,
+                                hashCombine(layer.name, layer.vote,
+                                            layer.desiredRefreshRate.getValue(),
+                                            layer.seamlessness, layer.weight, layer.focused));
+    }
+    return hash;
+}
+
 auto RefreshRateConfigs::getBestRefreshRate(const std::vector<LayerRequirement>& layers,
                                             GlobalSignals signals) const
         -> std::pair<DisplayModePtr, GlobalSignals> {
     std::lock_guard lock(mLock);
 
-    if (mGetBestRefreshRateCache &&
-        mGetBestRefreshRateCache->arguments == std::make_pair(layers, signals)) {
+    const size_t fingerprint = fingerprintArguments(layers, signals);
+    if (mGetBestRefreshRateCache && mGetBestRefreshRateCache->fingerprint == fingerprint) {
         return mGetBestRefreshRateCache->result;
     }
 
     const auto result = getBestRefreshRateLocked(layers, signals);
-    mGetBestRefreshRateCache = GetBestRefreshRateCache{{layers, signals}, result};
+    mGetBestRefreshRateCache = GetBestRefreshRateCache{fingerprint, result};
     return result;
 }
 
@@ -400,8 +400,15 @@ private:
     const Config mConfig;
     bool mSupportsFrameRateOverrideByContent;
 
+    // Fingerprint of the mode selection inputs, used as the memoization key below.
+    static size_t fingerprintArguments(const std::vector<LayerRequirement>&, GlobalSignals);
+
+    // Memoizes the last mode selection, keyed by a fingerprint of the layer votes and
+    // global signals, so steady-state lookups compare a single hash instead of deep
+    // comparing (and deep copying) the layer vector. Invalidated on any policy, mode or
+    // frame rate override change.
     struct GetBestRefreshRateCache {
-        std::pair<std::vector<LayerRequirement>, GlobalSignals> arguments;
+        size_t fingerprint;
         std::pair<DisplayModePtr, GlobalSignals> result;
     };
     mutable std::optional<GetBestRefreshRateCache> mGetBestRefreshRateCache GUARDED_BY(mLock);
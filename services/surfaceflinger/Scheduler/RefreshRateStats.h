@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cinttypes>
 #include <cstdlib>
@@ -23,6 +25,7 @@
 
 #include <android-base/stringprintf.h>
 #include <ftl/small_map.h>
+#include <log/log.h>
 #include <utils/Timers.h>
 
 #include <scheduler/Fps.h>
@@ -37,6 +40,12 @@ namespace android::scheduler {
  * mode is set to HWC_POWER_MODE_NORMAL, SF is switching between refresh rates that are stored in
  * the device's configs. Otherwise, we assume the HWC is running in power saving mode under the
  * hood (eg. the device is in DOZE, or screen off mode).
+ *
+ * Time in each mode is accumulated in per-mode atomic counters that are updated lock-free on
+ * mode and power transitions, so the collection cost on the scheduler path is a handful of
+ * atomic operations. Readers (dump, getTotalTimes) aggregate the counters plus the time elapsed
+ * in the current mode without blocking the writer. A dump racing a transition may briefly
+ * double-count the in-flight interval; reported totals remain monotonic.
  */
 class RefreshRateStats {
     static constexpr int64_t MS_PER_S = 1000;
@@ -51,7 +60,9 @@ public:
     RefreshRateStats(TimeStats& timeStats, Fps currentRefreshRate, PowerMode currentPowerMode)
           : mTimeStats(timeStats),
             mCurrentRefreshRate(currentRefreshRate),
-            mCurrentPowerMode(currentPowerMode) {}
+            mCurrentPowerMode(currentPowerMode) {
+        mCurrentModeSlot = findOrCreateModeSlot(currentRefreshRate);
+    }
 
     void setPowerMode(PowerMode mode) {
         if (mCurrentPowerMode == mode) {
@@ -70,25 +81,45 @@ public:
         mTimeStats.incrementRefreshRateSwitches();
         flushTime();
         mCurrentRefreshRate = currRefreshRate;
+        mCurrentModeSlot = findOrCreateModeSlot(currRefreshRate);
     }
 
     // Maps stringified refresh rate to total time spent in that mode.
     using TotalTimes = ftl::SmallMap<std::string, std::chrono::milliseconds, 3>;
 
-    TotalTimes getTotalTimes() {
-        // If the power mode is on, then we are probably switching between the config modes. If
-        // it's not then the screen is probably off. Make sure to flush times before printing
-        // them.
-        flushTime();
-
-        TotalTimes totalTimes = ftl::init::map("ScreenOff", mScreenOffTime);
+    TotalTimes getTotalTimes() const {
+        // Loading the flush timestamp before the counters means a transition that lands in
+        // between is at worst counted twice (in the counter and as in-flight time), keeping the
+        // reported totals monotonic.
+        const nsecs_t previousRecordedTime = mPreviousRecordedTime;
+        const nsecs_t inFlightTime = systemTime() - previousRecordedTime;
+        const PowerMode powerMode = mCurrentPowerMode;
+        const size_t currentModeSlot = mCurrentModeSlot;
+
+        nsecs_t screenOffTime = mScreenOffTime;
+        if (powerMode != PowerMode::ON) {
+            screenOffTime += inFlightTime;
+        }
+        TotalTimes totalTimes =
+                ftl::init::map("ScreenOff", std::chrono::milliseconds{ns2ms(screenOffTime)});
         const auto zero = std::chrono::milliseconds::zero();
 
         // Sum the times for modes that map to the same name, e.g. "60 Hz".
-        for (const auto& [fps, time] : mFpsTotalTimes) {
-            const auto string = to_string(fps);
+        for (size_t slot = 0; slot < mModeSlots.size(); slot++) {
+            const nsecs_t period = mModeSlots[slot].period;
+            if (period == kEmptySlot) {
+                break;
+            }
+            nsecs_t time = mModeSlots[slot].totalTime;
+            if (powerMode == PowerMode::ON && slot == currentModeSlot) {
+                time += inFlightTime;
+            } else if (time == 0) {
+                continue;
+            }
+            const auto string = to_string(Fps::fromPeriodNsecs(period));
             const auto total = std::as_const(totalTimes).get(string).value_or(std::cref(zero));
-            totalTimes.emplace_or_replace(string, total.get() + time);
+            totalTimes.emplace_or_replace(string,
+                                          total.get() + std::chrono::milliseconds{ns2ms(time)});
         }
 
         return totalTimes;
@@ -99,35 +130,54 @@ public:
     void dump(std::string& result) const {
         std::ostringstream stream("+  Refresh rate: running time in seconds\n");
 
-        for (const auto& [name, time] : const_cast<RefreshRateStats*>(this)->getTotalTimes()) {
+        for (const auto& [name, time] : getTotalTimes()) {
             stream << name << ": " << getDateFormatFromMs(time) << '\n';
         }
         result.append(stream.str());
     }
 
 private:
-    // Calculates the time that passed in ms between the last time we recorded time and the time
-    // this method was called.
+    static constexpr nsecs_t kEmptySlot = -1;
+    static constexpr size_t kMaxModeSlots = 16;
+
+    // Time spent in a mode, keyed by its vsync period. Slots are claimed once and never freed,
+    // so readers can aggregate them without synchronization.
+    struct ModeSlot {
+        std::atomic<nsecs_t> period = kEmptySlot;
+        std::atomic<nsecs_t> totalTime = 0;
+    };
+
+    // Returns the slot accumulating time for the given refresh rate, claiming a fresh one on
+    // first use. Only called on transitions, so the linear scan is off the hot path.
+    size_t findOrCreateModeSlot(Fps fps) {
+        const nsecs_t period = fps.getPeriodNsecs();
+        for (size_t slot = 0; slot < mModeSlots.size(); slot++) {
+            nsecs_t expected = kEmptySlot;
+            if (mModeSlots[slot].period == period ||
+                mModeSlots[slot].period.compare_exchange_strong(expected, period)) {
+                return slot;
+            }
+        }
+        ALOGE("RefreshRateStats: no free slot for %s", to_string(fps).c_str());
+        return kMaxModeSlots;
+    }
+
+    // Accumulates the time that passed since the last transition into the counter for the
+    // outgoing mode. Only called from the scheduler on mode and power transitions.
     void flushTime() {
         const nsecs_t currentTime = systemTime();
-        const nsecs_t timeElapsed = currentTime - mPreviousRecordedTime;
-        mPreviousRecordedTime = currentTime;
-
-        const auto duration = std::chrono::milliseconds{ns2ms(timeElapsed)};
-        const auto zero = std::chrono::milliseconds::zero();
+        const nsecs_t timeElapsed = currentTime - mPreviousRecordedTime.exchange(currentTime);
 
         uint32_t fps = 0;
 
         if (mCurrentPowerMode == PowerMode::ON) {
             // Normal power mode is counted under different config modes.
-            const auto total = std::as_const(mFpsTotalTimes)
-                                       .get(mCurrentRefreshRate)
-                                       .value_or(std::cref(zero));
-            mFpsTotalTimes.emplace_or_replace(mCurrentRefreshRate, total.get() + duration);
-
+            if (mCurrentModeSlot < mModeSlots.size()) {
+                mModeSlots[mCurrentModeSlot].totalTime += timeElapsed;
+            }
             fps = static_cast<uint32_t>(mCurrentRefreshRate.getIntValue());
         } else {
-            mScreenOffTime += duration;
+            mScreenOffTime += timeElapsed;
         }
         mTimeStats.recordRefreshRate(fps, timeElapsed);
     }
@@ -146,13 +196,15 @@ private:
     // Aggregate refresh rate statistics for telemetry.
     TimeStats& mTimeStats;
 
+    // Written only on transitions; read concurrently by dumps.
     Fps mCurrentRefreshRate;
-    PowerMode mCurrentPowerMode;
+    std::atomic<PowerMode> mCurrentPowerMode;
+    std::atomic<size_t> mCurrentModeSlot = kMaxModeSlots;
 
-    ftl::SmallMap<Fps, std::chrono::milliseconds, 2, FpsApproxEqual> mFpsTotalTimes;
-    std::chrono::milliseconds mScreenOffTime = std::chrono::milliseconds::zero();
+    std::array<ModeSlot, kMaxModeSlots> mModeSlots;
+    std::atomic<nsecs_t> mScreenOffTime = 0;
 
-    nsecs_t mPreviousRecordedTime = systemTime();
+    std::atomic<nsecs_t> mPreviousRecordedTime = systemTime();
 };
 
 } // namespace android::scheduler
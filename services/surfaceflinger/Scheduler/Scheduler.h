@@ -125,6 +125,15 @@ public:
         return std::move(future);
     }
 
+    // Schedule a main thread task on the deferred lane, for housekeeping that must not
+    // delay commit. The task only runs when the frame schedule leaves slack.
+    template <typename F, typename T = std::invoke_result_t<F>>
+    [[nodiscard]] std::future<T> scheduleDeferred(F&& f) {
+        auto [task, future] = makeTask(std::move(f));
+        postMessageDeferred(std::move(task));
+        return std::move(future);
+    }
+
     ConnectionHandle createConnection(const char* connectionName, frametimeline::TokenManager*,
                                       std::chrono::nanoseconds workDuration,
                                       std::chrono::nanoseconds readyDuration,
@@ -16,6 +16,7 @@
 
 #define ATRACE_TAG ATRACE_TAG_GRAPHICS
 
+#include <algorithm>
 #include <vector>
 
 #include <android-base/stringprintf.h>
@@ -24,6 +25,7 @@
 
 #include <scheduler/TimeKeeper.h>
 
+#include "../TracedOrdinal.h"
 #include "VSyncDispatchTimerQueue.h"
 #include "VSyncTracker.h"
 
@@ -224,22 +226,36 @@ void VSyncDispatchTimerQueue::setTimer(nsecs_t targetTime, nsecs_t /*now*/) {
     mLastTimerSchedule = mTimeKeeper->now();
 }
 
+void VSyncDispatchTimerQueue::addArmedEntry(
+        std::shared_ptr<VSyncDispatchTimerQueueEntry> const& entry) {
+    if (std::find(mArmedEntries.begin(), mArmedEntries.end(), entry) == mArmedEntries.end()) {
+        mArmedEntries.push_back(entry);
+    }
+}
+
+void VSyncDispatchTimerQueue::removeArmedEntry(VSyncDispatchTimerQueueEntry const* entry) {
+    auto const it = std::find_if(mArmedEntries.begin(), mArmedEntries.end(),
+                                 [entry](auto const& armed) { return armed.get() == entry; });
+    if (it != mArmedEntries.end()) {
+        mArmedEntries.erase(it);
+    }
+}
+
 void VSyncDispatchTimerQueue::rearmTimer(nsecs_t now) {
-    rearmTimerSkippingUpdateFor(now, mCallbacks.end());
+    rearmTimerSkippingUpdateFor(now, nullptr);
 }
 
 void VSyncDispatchTimerQueue::rearmTimerSkippingUpdateFor(
-        nsecs_t now, CallbackMap::iterator const& skipUpdateIt) {
+        nsecs_t now, VSyncDispatchTimerQueueEntry const* skipUpdate) {
     std::optional<nsecs_t> min;
     std::optional<nsecs_t> targetVsync;
     std::optional<std::string_view> nextWakeupName;
-    for (auto it = mCallbacks.begin(); it != mCallbacks.end(); it++) {
-        auto& callback = it->second;
+    for (auto& callback : mArmedEntries) {
         if (!callback->wakeupTime() && !callback->hasPendingWorkloadUpdate()) {
             continue;
         }
 
-        if (it != skipUpdateIt) {
+        if (callback.get() != skipUpdate) {
             callback->update(mTracker, now);
         }
         auto const wakeupTime = *callback->wakeupTime();
@@ -251,7 +267,7 @@ void VSyncDispatchTimerQueue::rearmTimerSkippingUpdateFor(
     }
 
     if (min && min < mIntendedWakeupTime) {
-        if (ATRACE_ENABLED() && nextWakeupName && targetVsync) {
+        if (isTracingEnabled() && nextWakeupName && targetVsync) {
             ftl::Concat trace(ftl::truncated<5>(*nextWakeupName), " alarm in ", ns2us(*min - now),
                               "us; VSYNC in ", ns2us(*targetVsync - now), "us");
             ATRACE_NAME(trace.c_str());
@@ -275,10 +291,15 @@ void VSyncDispatchTimerQueue::timerCallback() {
         std::lock_guard lock(mMutex);
         auto const now = mTimeKeeper->now();
         mLastTimerCallback = now;
-        for (auto it = mCallbacks.begin(); it != mCallbacks.end(); it++) {
-            auto& callback = it->second;
+        if (mIntendedWakeupTime != kInvalidTime) {
+            mWakeupSlips[mWakeupCount % mWakeupSlips.size()] = now - mIntendedWakeupTime;
+            mWakeupCount++;
+        }
+        for (auto it = mArmedEntries.begin(); it != mArmedEntries.end();) {
+            auto& callback = *it;
             auto const wakeupTime = callback->wakeupTime();
             if (!wakeupTime) {
+                it++;
                 continue;
             }
 
@@ -289,7 +310,14 @@ void VSyncDispatchTimerQueue::timerCallback() {
                 callback->executing();
                 invocations.emplace_back(Invocation{callback, *callback->lastExecutedVsyncTarget(),
                                                     *wakeupTime, *readyTime});
+                // A pending workload update keeps the entry on the armed list so the rearm
+                // below applies it and rearms the entry for the next vsync.
+                if (!callback->hasPendingWorkloadUpdate()) {
+                    it = mArmedEntries.erase(it);
+                    continue;
+                }
             }
+            it++;
         }
 
         mIntendedWakeupTime = kInvalidTime;
@@ -321,6 +349,7 @@ void VSyncDispatchTimerQueue::unregisterCallback(CallbackToken token) {
         auto it = mCallbacks.find(token);
         if (it != mCallbacks.end()) {
             entry = it->second;
+            removeArmedEntry(entry.get());
             mCallbacks.erase(it);
         }
     }
@@ -348,6 +377,7 @@ ScheduleResult VSyncDispatchTimerQueue::schedule(CallbackToken token,
         auto const rearmImminent = now > mIntendedWakeupTime;
         if (CC_UNLIKELY(rearmImminent)) {
             callback->addPendingWorkloadUpdate(scheduleTiming);
+            addArmedEntry(callback);
             return getExpectedCallbackTime(mTracker, now, scheduleTiming);
         }
 
@@ -355,9 +385,10 @@ ScheduleResult VSyncDispatchTimerQueue::schedule(CallbackToken token,
         if (!result.has_value()) {
             return result;
         }
+        addArmedEntry(callback);
 
         if (callback->wakeupTime() < mIntendedWakeupTime - mTimerSlack) {
-            rearmTimerSkippingUpdateFor(now, it);
+            rearmTimerSkippingUpdateFor(now, callback.get());
         }
     }
 
@@ -376,6 +407,9 @@ CancelResult VSyncDispatchTimerQueue::cancel(CallbackToken token) {
     auto const wakeupTime = callback->wakeupTime();
     if (wakeupTime) {
         callback->disarm();
+        if (!callback->hasPendingWorkloadUpdate()) {
+            removeArmedEntry(callback.get());
+        }
 
         if (*wakeupTime == mIntendedWakeupTime) {
             mIntendedWakeupTime = kInvalidTime;
@@ -397,7 +431,21 @@ void VSyncDispatchTimerQueue::dump(std::string& result) const {
     StringAppendF(&result, "\tmLastTimerCallback: %.2fms ago mLastTimerSchedule: %.2fms ago\n",
                   (mTimeKeeper->now() - mLastTimerCallback) / 1e6f,
                   (mTimeKeeper->now() - mLastTimerSchedule) / 1e6f);
-    StringAppendF(&result, "\tCallbacks:\n");
+    if (mWakeupCount > 0) {
+        const size_t window = std::min(mWakeupCount, mWakeupSlips.size());
+        nsecs_t maxSlip = mWakeupSlips[0];
+        nsecs_t totalSlip = 0;
+        for (size_t i = 0; i < window; i++) {
+            maxSlip = std::max(maxSlip, mWakeupSlips[i]);
+            totalSlip += mWakeupSlips[i];
+        }
+        StringAppendF(&result,
+                      "\tWakeup accuracy over last %zu of %zu wakeups: mean slip %.2fus max slip "
+                      "%.2fus\n",
+                      window, mWakeupCount, totalSlip / static_cast<float>(window) / 1e3f,
+                      maxSlip / 1e3f);
+    }
+    StringAppendF(&result, "\tCallbacks (armed=%zu):\n", mArmedEntries.size());
     for (const auto& [token, entry] : mCallbacks) {
         entry->dump(result);
     }
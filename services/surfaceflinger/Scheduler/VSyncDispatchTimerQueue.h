@@ -16,12 +16,14 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 #include <android-base/thread_annotations.h>
 
@@ -134,13 +136,16 @@ private:
 
     using CallbackMap =
             std::unordered_map<CallbackToken, std::shared_ptr<VSyncDispatchTimerQueueEntry>>;
+    using EntryList = std::vector<std::shared_ptr<VSyncDispatchTimerQueueEntry>>;
 
     void timerCallback();
     void setTimer(nsecs_t, nsecs_t) REQUIRES(mMutex);
     void rearmTimer(nsecs_t now) REQUIRES(mMutex);
-    void rearmTimerSkippingUpdateFor(nsecs_t now, CallbackMap::iterator const& skipUpdate)
+    void rearmTimerSkippingUpdateFor(nsecs_t now, VSyncDispatchTimerQueueEntry const* skipUpdate)
             REQUIRES(mMutex);
     void cancelTimer() REQUIRES(mMutex);
+    void addArmedEntry(std::shared_ptr<VSyncDispatchTimerQueueEntry> const&) REQUIRES(mMutex);
+    void removeArmedEntry(VSyncDispatchTimerQueueEntry const*) REQUIRES(mMutex);
 
     static constexpr nsecs_t kInvalidTime = std::numeric_limits<int64_t>::max();
     std::unique_ptr<TimeKeeper> const mTimeKeeper;
@@ -152,11 +157,19 @@ private:
     size_t mCallbackToken GUARDED_BY(mMutex) = 0;
 
     CallbackMap mCallbacks GUARDED_BY(mMutex);
+    // The subset of mCallbacks that is armed or has a pending workload update. Timer dispatch
+    // and rearming walk this list instead of mCallbacks so their cost scales with the number
+    // of armed callbacks rather than the number of registered ones.
+    EntryList mArmedEntries GUARDED_BY(mMutex);
     nsecs_t mIntendedWakeupTime GUARDED_BY(mMutex) = kInvalidTime;
 
     // For debugging purposes
     nsecs_t mLastTimerCallback GUARDED_BY(mMutex) = kInvalidTime;
     nsecs_t mLastTimerSchedule GUARDED_BY(mMutex) = kInvalidTime;
+    // Ring of recent wakeup slips (actual minus intended timer wakeup time), kept to gauge
+    // dispatch timing accuracy in dumpsys.
+    std::array<nsecs_t, 32> mWakeupSlips GUARDED_BY(mMutex) = {};
+    size_t mWakeupCount GUARDED_BY(mMutex) = 0;
 };
 
 } // namespace android::scheduler
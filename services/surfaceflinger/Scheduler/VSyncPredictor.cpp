@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <sstream>
 
 #include <android-base/logging.h>
@@ -98,6 +99,7 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
     std::lock_guard lock(mMutex);
 
     if (!validate(timestamp)) {
+        mOutliersRejected++;
         // VSR could elect to ignore the incongruent timestamp or resetModel(). If ts is ignored,
         // don't insert this ts into mTimestamps ringbuffer. If we are still
         // in the learning phase we should just clear all timestamps and start
@@ -116,6 +118,24 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
         return false;
     }
 
+    // Record the error between the model's one-step-ahead prediction and the sample
+    // that actually arrived, before refitting the model below. This feeds the
+    // confidence signal reported by getPredictionConfidence() and the dump.
+    if (mTimestamps.size() >= kMinimumSamplesForPrediction) {
+        const auto model = getVSyncPredictionModelLocked();
+        if (model.slope > 0) {
+            const auto oldest = *std::min_element(mTimestamps.begin(), mTimestamps.end());
+            const nsecs_t distance = timestamp - oldest - model.intercept;
+            nsecs_t error = distance % model.slope;
+            if (error > model.slope / 2) {
+                error -= model.slope;
+            } else if (error < -model.slope / 2) {
+                error += model.slope;
+            }
+            recordPredictionErrorLocked(error);
+        }
+    }
+
     if (mTimestamps.size() != kHistorySize) {
         mTimestamps.push_back(timestamp);
         mLastTimestampIndex = next(mLastTimestampIndex);
@@ -145,8 +165,15 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
     //
     // intercept = mean(Y) - slope * mean(X)
     //
-    std::vector<nsecs_t> vsyncTS(numSamples);
-    std::vector<nsecs_t> ordinals(numSamples);
+    // Rather than centering the samples around their means, the equivalent identities
+    //
+    //         N * Sigma_i(X_i * Y_i) - Sigma_i(X_i) * Sigma_i(Y_i)
+    // slope = ----------------------------------------------------
+    //         N * Sigma_i(X_i ^ 2) - Sigma_i(X_i) ^ 2
+    //
+    // are computed from running sums in a single fused pass over the ring, with no
+    // temporary allocations and no data dependency between iterations, so the loop
+    // auto-vectorizes.
 
     // Normalizing to the oldest timestamp cuts down on error in calculating the intercept.
     const auto oldestTS = *std::min_element(mTimestamps.begin(), mTimestamps.end());
@@ -157,35 +184,25 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
     // fixed-point arithmetic.
     constexpr int64_t kScalingFactor = 1000;
 
-    nsecs_t meanTS = 0;
-    nsecs_t meanOrdinal = 0;
+    int64_t sumX = 0;
+    int64_t sumY = 0;
+    int64_t sumXX = 0;
+    int64_t sumXY = 0;
 
     for (size_t i = 0; i < numSamples; i++) {
         traceInt64If("VSP-ts", mTimestamps[i]);
 
-        const auto timestamp = mTimestamps[i] - oldestTS;
-        vsyncTS[i] = timestamp;
-        meanTS += timestamp;
+        const int64_t y = mTimestamps[i] - oldestTS;
+        const int64_t x = (y + currentPeriod / 2) / currentPeriod * kScalingFactor;
 
-        const auto ordinal = (vsyncTS[i] + currentPeriod / 2) / currentPeriod * kScalingFactor;
-        ordinals[i] = ordinal;
-        meanOrdinal += ordinal;
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
     }
 
-    meanTS /= numSamples;
-    meanOrdinal /= numSamples;
-
-    for (size_t i = 0; i < numSamples; i++) {
-        vsyncTS[i] -= meanTS;
-        ordinals[i] -= meanOrdinal;
-    }
-
-    nsecs_t top = 0;
-    nsecs_t bottom = 0;
-    for (size_t i = 0; i < numSamples; i++) {
-        top += vsyncTS[i] * ordinals[i];
-        bottom += ordinals[i] * ordinals[i];
-    }
+    const auto n = static_cast<int64_t>(numSamples);
+    nsecs_t const bottom = n * sumXX - sumX * sumX;
 
     if (CC_UNLIKELY(bottom == 0)) {
         it->second = {mIdealPeriod, 0};
@@ -193,8 +210,9 @@ bool VSyncPredictor::addVsyncTimestamp(nsecs_t timestamp) {
         return false;
     }
 
+    nsecs_t const top = n * sumXY - sumX * sumY;
     nsecs_t const anticipatedPeriod = top * kScalingFactor / bottom;
-    nsecs_t const intercept = meanTS - (anticipatedPeriod * meanOrdinal / kScalingFactor);
+    nsecs_t const intercept = (sumY - anticipatedPeriod * sumX / kScalingFactor) / n;
 
     auto const percent = std::abs(anticipatedPeriod - mIdealPeriod) * kMaxPercent / mIdealPeriod;
     if (percent >= kOutlierTolerancePercent) {
@@ -320,6 +338,42 @@ VSyncPredictor::Model VSyncPredictor::getVSyncPredictionModelLocked() const {
     return mRateMap.find(mIdealPeriod)->second;
 }
 
+void VSyncPredictor::recordPredictionErrorLocked(nsecs_t error) {
+    if (mPredictionErrors.size() != kHistorySize) {
+        mPredictionErrors.push_back(error);
+        mLastErrorIndex = mPredictionErrors.size() - 1;
+    } else {
+        mLastErrorIndex = (mLastErrorIndex + 1) % kHistorySize;
+        mPredictionErrors[mLastErrorIndex] = error;
+    }
+}
+
+float VSyncPredictor::getPredictionConfidence() const {
+    std::lock_guard lock(mMutex);
+    return getPredictionConfidenceLocked();
+}
+
+float VSyncPredictor::getPredictionConfidenceLocked() const {
+    if (mPredictionErrors.empty()) {
+        return 0.f;
+    }
+
+    const nsecs_t period = mRateMap.find(mIdealPeriod)->second.slope;
+    if (period <= 0) {
+        return 0.f;
+    }
+
+    float squaredErrorSum = 0.f;
+    for (auto error : mPredictionErrors) {
+        squaredErrorSum += static_cast<float>(error) * error;
+    }
+    const auto rmsError = std::sqrt(squaredErrorSum / mPredictionErrors.size());
+
+    // An rms error of half a period means the samples are completely out of phase
+    // with the predictions.
+    return 1.f - std::min(1.f, 2.f * rmsError / period);
+}
+
 void VSyncPredictor::setPeriod(nsecs_t period) {
     ATRACE_CALL();
 
@@ -349,6 +403,9 @@ void VSyncPredictor::clearTimestamps() {
         mTimestamps.clear();
         mLastTimestampIndex = 0;
     }
+
+    mPredictionErrors.clear();
+    mLastErrorIndex = 0;
 }
 
 bool VSyncPredictor::needsMoreSamples() const {
@@ -365,6 +422,21 @@ void VSyncPredictor::resetModel() {
 void VSyncPredictor::dump(std::string& result) const {
     std::lock_guard lock(mMutex);
     StringAppendF(&result, "\tmIdealPeriod=%.2f\n", mIdealPeriod / 1e6f);
+    StringAppendF(&result, "\tmPredictionConfidence=%.3f\n", getPredictionConfidenceLocked());
+    if (!mPredictionErrors.empty()) {
+        nsecs_t maxError = 0;
+        float squaredErrorSum = 0.f;
+        for (auto error : mPredictionErrors) {
+            maxError = std::max(maxError, std::abs(error));
+            squaredErrorSum += static_cast<float>(error) * error;
+        }
+        StringAppendF(&result,
+                      "\tprediction error over the last %zu samples: rms=%.2fus max=%.2fus\n",
+                      mPredictionErrors.size(),
+                      std::sqrt(squaredErrorSum / mPredictionErrors.size()) / 1e3f,
+                      maxError / 1e3f);
+    }
+    StringAppendF(&result, "\toutliers rejected=%zu\n", mOutliersRejected);
     StringAppendF(&result, "\tRefresh Rate Map:\n");
     for (const auto& [idealPeriod, periodInterceptTuple] : mRateMap) {
         StringAppendF(&result,
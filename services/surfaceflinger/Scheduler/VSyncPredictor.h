@@ -65,6 +65,16 @@ public:
 
     VSyncPredictor::Model getVSyncPredictionModel() const EXCLUDES(mMutex);
 
+    /*
+     * Query the confidence in the current prediction model, derived from the
+     * one-step-ahead prediction error of the recently added vsync timestamps.
+     *
+     * \return  A value in [0, 1]. 1 means the recent samples landed exactly on the
+     * predicted timestamps, 0 means the model is untrained or the recent samples
+     * were at least half a period away from their predictions.
+     */
+    float getPredictionConfidence() const EXCLUDES(mMutex);
+
     bool isVSyncInPhase(nsecs_t timePoint, Fps frameRate) const final EXCLUDES(mMutex);
 
     void dump(std::string& result) const final EXCLUDES(mMutex);
@@ -89,6 +99,9 @@ private:
 
     nsecs_t nextAnticipatedVSyncTimeFromLocked(nsecs_t timePoint) const REQUIRES(mMutex);
 
+    void recordPredictionErrorLocked(nsecs_t error) REQUIRES(mMutex);
+    float getPredictionConfidenceLocked() const REQUIRES(mMutex);
+
     nsecs_t mIdealPeriod GUARDED_BY(mMutex);
     std::optional<nsecs_t> mKnownTimestamp GUARDED_BY(mMutex);
 
@@ -100,6 +113,14 @@ private:
 
     size_t mLastTimestampIndex GUARDED_BY(mMutex) = 0;
     std::vector<nsecs_t> mTimestamps GUARDED_BY(mMutex);
+
+    // Ring of the one-step-ahead prediction errors of the most recently added
+    // timestamps, from which the prediction confidence is derived.
+    size_t mLastErrorIndex GUARDED_BY(mMutex) = 0;
+    std::vector<nsecs_t> mPredictionErrors GUARDED_BY(mMutex);
+
+    // Number of timestamps rejected as outliers since creation.
+    size_t mOutliersRejected GUARDED_BY(mMutex) = 0;
 };
 
 } // namespace android::scheduler
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#define ATRACE_TAG ATRACE_TAG_GRAPHICS
+
 #include "VsyncConfiguration.h"
 
 #include <chrono>
@@ -22,6 +24,7 @@
 
 #include <cutils/properties.h>
 #include <log/log.h>
+#include <utils/Trace.h>
 
 #include "SurfaceFlingerProperties.h"
 
@@ -47,11 +50,19 @@ PhaseOffsets::VsyncConfigSet VsyncConfiguration::getConfigsForRefreshRate(Fps fp
     return getConfigsForRefreshRateLocked(fps);
 }
 
+void VsyncConfiguration::cacheConfigsForRefreshRates(const std::vector<Fps>& fpss) {
+    std::lock_guard lock(mLock);
+    for (const Fps fps : fpss) {
+        getConfigsForRefreshRateLocked(fps);
+    }
+}
+
 PhaseOffsets::VsyncConfigSet VsyncConfiguration::getConfigsForRefreshRateLocked(Fps fps) const {
     if (const auto offsets = mOffsetsCache.get(fps)) {
         return offsets->get();
     }
 
+    ATRACE_INT("VsyncConfigCacheMiss", static_cast<int32_t>(++mOffsetsCacheMisses));
     const auto [it, _] = mOffsetsCache.try_emplace(fps, constructOffsets(fps.getPeriodNsecs()));
     return it->second;
 }
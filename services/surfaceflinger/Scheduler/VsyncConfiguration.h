@@ -19,6 +19,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <ftl/small_map.h>
 #include <utils/Timers.h>
@@ -42,6 +43,7 @@ public:
     virtual ~VsyncConfiguration() = default;
     virtual VsyncConfigSet getCurrentConfigs() const = 0;
     virtual VsyncConfigSet getConfigsForRefreshRate(Fps fps) const = 0;
+    virtual void cacheConfigsForRefreshRates(const std::vector<Fps>& fpss) = 0;
     virtual void reset() = 0;
 
     virtual void setRefreshRateFps(Fps fps) = 0;
@@ -62,6 +64,11 @@ public:
     // Returns early, early GL, and late offsets for Apps and SF for a given refresh rate.
     VsyncConfigSet getConfigsForRefreshRate(Fps fps) const override EXCLUDES(mLock);
 
+    // Precomputes and caches the configs for each of the given refresh rates (typically all
+    // modes supported by the display, at connect time), so a later mode switch finds them in
+    // the cache instead of computing offsets on the switch path.
+    void cacheConfigsForRefreshRates(const std::vector<Fps>& fpss) override EXCLUDES(mLock);
+
     // Returns early, early GL, and late offsets for Apps and SF.
     VsyncConfigSet getCurrentConfigs() const override EXCLUDES(mLock) {
         std::lock_guard lock(mLock);
@@ -91,6 +98,10 @@ protected:
 
     mutable ftl::SmallMap<Fps, VsyncConfigSet, 2, FpsApproxEqual> mOffsetsCache GUARDED_BY(mLock);
     Fps mRefreshRateFps GUARDED_BY(mLock);
+    // Number of cache misses, exposed as a trace counter. Once the supported modes have been
+    // cached this should stay flat; any later increment means a switch (or a query for an
+    // unexpected rate) had to compute offsets synchronously.
+    mutable size_t mOffsetsCacheMisses GUARDED_BY(mLock) = 0;
     mutable std::mutex mLock;
 };
 
@@ -22,6 +22,7 @@
 #include "VsyncModulator.h"
 
 #include <android-base/properties.h>
+#include <android-base/stringprintf.h>
 #include <log/log.h>
 #include <utils/Trace.h>
 
@@ -34,6 +35,7 @@ using namespace std::chrono_literals;
 namespace android::scheduler {
 
 const std::chrono::nanoseconds VsyncModulator::MIN_EARLY_TRANSACTION_TIME = 1ms;
+const std::chrono::nanoseconds VsyncModulator::MAX_PREDICTED_EARLY_TIME = 100ms;
 
 VsyncModulator::VsyncModulator(const VsyncConfigSet& config, Now now)
       : mVsyncConfigSet(config),
@@ -54,6 +56,7 @@ VsyncModulator::VsyncConfigOpt VsyncModulator::setTransactionSchedule(Transactio
             if (token) {
                 mEarlyWakeupRequests.emplace(token);
                 token->linkToDeath(this);
+                recordEarlyStartLocked(token);
             } else {
                 ALOGW("%s: EarlyStart requested without a valid token", __func__);
             }
@@ -78,6 +81,9 @@ VsyncModulator::VsyncConfigOpt VsyncModulator::setTransactionSchedule(Transactio
     if (mEarlyWakeupRequests.empty() && schedule == Schedule::EarlyEnd) {
         mEarlyTransactionFrames = MIN_EARLY_TRANSACTION_FRAMES;
         mEarlyTransactionStartTime = mNow();
+        if (token) {
+            maybeArmPredictedEarlyLocked(token);
+        }
     }
 
     // An early transaction stays an early transaction.
@@ -107,9 +113,54 @@ VsyncModulator::VsyncConfigOpt VsyncModulator::onRefreshRateChangeCompleted() {
     return updateVsyncConfig();
 }
 
+void VsyncModulator::recordEarlyStartLocked(const sp<IBinder>& token) {
+    const auto now = mNow();
+
+    if (mPredictedEarlyActive) {
+        // The burst predicted after the last EarlyEnd arrived while early offsets were held.
+        mPredictedEarlyActive = false;
+        mPredictionHits++;
+    }
+
+    auto& cadence = mTokenCadences[token];
+    if (cadence.lastEarlyStart != TimePoint()) {
+        const auto interval = now - cadence.lastEarlyStart;
+        cadence.avgStartInterval = cadence.samples == 0
+                ? interval
+                : (3 * cadence.avgStartInterval + interval) / 4;
+        cadence.samples++;
+    }
+    cadence.lastEarlyStart = now;
+}
+
+void VsyncModulator::maybeArmPredictedEarlyLocked(const sp<IBinder>& token) {
+    const auto it = mTokenCadences.find(token);
+    if (it == mTokenCadences.end() || it->second.samples < MIN_CADENCE_SAMPLES) {
+        return;
+    }
+
+    const auto& cadence = it->second;
+    const auto now = mNow();
+    // Allow the predicted burst to run a quarter interval late before giving up on it.
+    const auto holdUntil = cadence.lastEarlyStart + cadence.avgStartInterval +
+            cadence.avgStartInterval / 4;
+    if (holdUntil <= now || holdUntil - now > MAX_PREDICTED_EARLY_TIME) {
+        return;
+    }
+
+    mPredictedEarlyUntil = holdUntil;
+    mPredictedEarlyActive = true;
+}
+
 VsyncModulator::VsyncConfigOpt VsyncModulator::onDisplayRefresh(bool usedGpuComposition) {
     bool updateOffsetsNeeded = false;
 
+    if (mPredictedEarlyActive && mNow() >= mPredictedEarlyUntil.load()) {
+        // The predicted burst never arrived before the hold expired.
+        mPredictedEarlyActive = false;
+        mPredictionMisses++;
+        updateOffsetsNeeded = true;
+    }
     if (mEarlyTransactionStartTime.load() + MIN_EARLY_TRANSACTION_TIME <=
         mLastTransactionCommitTime.load()) {
         if (mEarlyTransactionFrames > 0) {
@@ -136,9 +187,10 @@ VsyncModulator::VsyncConfig VsyncModulator::getVsyncConfig() const {
 
 auto VsyncModulator::getNextVsyncConfigType() const -> VsyncConfigType {
     // Early offsets are used if we're in the middle of a refresh rate
-    // change, or if we recently begin a transaction.
+    // change, if we recently begin a transaction, or if another transaction
+    // burst is predicted to arrive shortly.
     if (!mEarlyWakeupRequests.empty() || mTransactionSchedule == Schedule::EarlyEnd ||
-        mEarlyTransactionFrames > 0 || mRefreshRateChangePending) {
+        mEarlyTransactionFrames > 0 || mRefreshRateChangePending || mPredictedEarlyActive) {
         return VsyncConfigType::Early;
     } else if (mEarlyGpuFrames > 0) {
         return VsyncConfigType::EarlyGpu;
@@ -164,6 +216,12 @@ VsyncModulator::VsyncConfig VsyncModulator::updateVsyncConfig() {
 }
 
 VsyncModulator::VsyncConfig VsyncModulator::updateVsyncConfigLocked() {
+    const VsyncConfigType type = getNextVsyncConfigType();
+    if (type != mLastVsyncConfigType) {
+        mOffsetTransitions++;
+        mLastVsyncConfigType = type;
+    }
+
     const VsyncConfig& offsets = getNextVsyncConfig();
     mVsyncConfig = offsets;
 
@@ -183,10 +241,20 @@ VsyncModulator::VsyncConfig VsyncModulator::updateVsyncConfigLocked() {
 void VsyncModulator::binderDied(const wp<IBinder>& who) {
     std::lock_guard<std::mutex> lock(mMutex);
     mEarlyWakeupRequests.erase(who);
+    mTokenCadences.erase(who);
 
     static_cast<void>(updateVsyncConfigLocked());
 }
 
+void VsyncModulator::dump(std::string& result) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    base::StringAppendF(&result,
+                        "VsyncModulator: offset transitions=%d prediction hits=%d misses=%d "
+                        "tracked tokens=%zu\n\n",
+                        mOffsetTransitions.load(), mPredictionHits.load(),
+                        mPredictionMisses.load(), mTokenCadences.size());
+}
+
 bool VsyncModulator::isVsyncConfigDefault() const {
     std::lock_guard<std::mutex> lock(mMutex);
     return getNextVsyncConfigType() == VsyncConfigType::Late;
@@ -19,6 +19,8 @@
 #include <chrono>
 #include <mutex>
 #include <optional>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <android-base/thread_annotations.h>
@@ -51,6 +53,14 @@ public:
     // This may keep early offsets for an extra frame, but avoids a race with transaction commit.
     static const std::chrono::nanoseconds MIN_EARLY_TRANSACTION_TIME;
 
+    // Number of observed intervals between a token's EarlyStart requests before its cadence is
+    // considered learned, and early offsets are held through predicted gaps between bursts.
+    static constexpr int MIN_CADENCE_SAMPLES = 3;
+
+    // Longest time a predicted hold may keep early offsets after an EarlyEnd. Beyond this the
+    // cost of a misprediction outweighs the frame of latency saved on a hit.
+    static const std::chrono::nanoseconds MAX_PREDICTED_EARLY_TIME;
+
     // Phase offsets and work durations for SF and app deadlines from VSYNC.
     struct VsyncConfig {
         nsecs_t sfOffset;
@@ -111,6 +121,8 @@ public:
 
     [[nodiscard]] bool isVsyncConfigDefault() const;
 
+    void dump(std::string& result) const EXCLUDES(mMutex);
+
 protected:
     // Called from unit tests as well
     void binderDied(const wp<IBinder>&) override EXCLUDES(mMutex);
@@ -123,6 +135,14 @@ private:
     [[nodiscard]] VsyncConfig updateVsyncConfig() EXCLUDES(mMutex);
     [[nodiscard]] VsyncConfig updateVsyncConfigLocked() REQUIRES(mMutex);
 
+    // Updates the token's learned EarlyStart cadence, and resolves an armed predicted hold as
+    // a hit if the predicted burst arrived.
+    void recordEarlyStartLocked(const sp<IBinder>& token) REQUIRES(mMutex);
+
+    // Arms a predicted hold of early offsets if the token's cadence is learned and predicts
+    // another burst soon after this EarlyEnd.
+    void maybeArmPredictedEarlyLocked(const sp<IBinder>& token) REQUIRES(mMutex);
+
     mutable std::mutex mMutex;
     VsyncConfigSet mVsyncConfigSet GUARDED_BY(mMutex);
 
@@ -139,6 +159,24 @@ private:
     std::atomic<TimePoint> mEarlyTransactionStartTime = TimePoint();
     std::atomic<TimePoint> mLastTransactionCommitTime = TimePoint();
 
+    // Learned cadence of a token's EarlyStart requests.
+    struct TokenCadence {
+        TimePoint lastEarlyStart;
+        Clock::duration avgStartInterval = Clock::duration::zero();
+        int samples = 0;
+    };
+    std::unordered_map<wp<IBinder>, TokenCadence, WpHash> mTokenCadences GUARDED_BY(mMutex);
+
+    // While active, early offsets are held until the predicted next burst or until the hold
+    // expires on a display refresh, whichever comes first.
+    std::atomic<bool> mPredictedEarlyActive = false;
+    std::atomic<TimePoint> mPredictedEarlyUntil = TimePoint();
+
+    VsyncConfigType mLastVsyncConfigType GUARDED_BY(mMutex) = VsyncConfigType::Late;
+    std::atomic<int> mOffsetTransitions = 0;
+    std::atomic<int> mPredictionHits = 0;
+    std::atomic<int> mPredictionMisses = 0;
+
     const Now mNow;
     const bool mTraceDetailedInfo;
 };
@@ -29,6 +29,7 @@
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
 #include <android/configuration.h>
+#include <android/gui/BnScreenCaptureListener.h>
 #include <android/gui/IDisplayEventConnection.h>
 #include <android/hardware/configstore/1.0/ISurfaceFlingerConfigs.h>
 #include <android/hardware/configstore/1.1/ISurfaceFlingerConfigs.h>
@@ -95,9 +96,11 @@
 #include <cmath>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 
@@ -237,6 +240,16 @@ bool validateCompositionDataspace(Dataspace dataspace) {
     return dataspace == Dataspace::V0_SRGB || dataspace == Dataspace::DISPLAY_P3;
 }
 
+std::vector<Fps> getSupportedRefreshRates(const sp<DisplayDevice>& display) {
+    const auto& modes = display->getSupportedModes();
+    std::vector<Fps> fpss;
+    fpss.reserve(modes.size());
+    for (const auto& mode : modes) {
+        fpss.push_back(mode->getFps());
+    }
+    return fpss;
+}
+
 std::chrono::milliseconds getIdleTimerTimeout(DisplayId displayId) {
     const auto displayIdleTimerMsKey = [displayId] {
         std::stringstream ss;
@@ -455,6 +468,10 @@ SurfaceFlinger::SurfaceFlinger(Factory& factory) : SurfaceFlinger(factory, SkipI
         mTransactionTracing.emplace();
     }
 
+    if (base::GetBoolProperty("debug.sf.enable_continuous_layer_tracing"s, false)) {
+        mLayerTracing.enable(true /* continuous */);
+    }
+
     mIgnoreHdrCameraLayers = ignore_hdr_camera_layers(false);
 
     // Power hint session mode, representing which hint(s) to send: early, late, or both)
@@ -821,6 +838,23 @@ void SurfaceFlinger::init() {
     mAllowHwcForVDS = mAllowHwcForWFD && base::GetBoolProperty("debug.sf.enable_hwc_vds"s, false);
     mFirstApiLevel = android::base::GetIntProperty("ro.product.first_api_level", 0);
 
+    char primeShaderCache[PROPERTY_VALUE_MAX];
+    property_get("service.sf.prime_shader_cache", primeShaderCache, "1");
+    if (atoi(primeShaderCache)) {
+        if (setSchedFifo(false) != NO_ERROR) {
+            ALOGW("Can't set SCHED_OTHER for primeCache");
+        }
+
+        // Kick this off before probing displays so that shader compilation overlaps the
+        // hotplug processing and display bring-up below. bootFinished() waits on the
+        // future before declaring boot done.
+        mRenderEnginePrimeCacheFuture = getRenderEngine().primeCache();
+
+        if (setSchedFifo(true) != NO_ERROR) {
+            ALOGW("Can't set SCHED_OTHER for primeCache");
+        }
+    }
+
     // Process any initial hotplug and resulting display changes.
     processDisplayHotplugEventsLocked();
     const auto display = getDefaultDisplayDeviceLocked();
@@ -837,20 +871,6 @@ void SurfaceFlinger::init() {
 
     mPowerAdvisor->init();
 
-    char primeShaderCache[PROPERTY_VALUE_MAX];
-    property_get("service.sf.prime_shader_cache", primeShaderCache, "1");
-    if (atoi(primeShaderCache)) {
-        if (setSchedFifo(false) != NO_ERROR) {
-            ALOGW("Can't set SCHED_OTHER for primeCache");
-        }
-
-        mRenderEnginePrimeCacheFuture = getRenderEngine().primeCache();
-
-        if (setSchedFifo(true) != NO_ERROR) {
-            ALOGW("Can't set SCHED_OTHER for primeCache");
-        }
-    }
-
     onActiveDisplaySizeChanged(display);
 
     // Inform native graphics APIs whether the present timestamp is supported:
@@ -1856,7 +1876,8 @@ void SurfaceFlinger::scheduleRepaint() {
 }
 
 void SurfaceFlinger::scheduleSample() {
-    static_cast<void>(mScheduler->schedule([this] { sample(); }));
+    // Sampling is housekeeping: defer it so it never delays commit.
+    static_cast<void>(mScheduler->scheduleDeferred([this] { sample(); }));
 }
 
 nsecs_t SurfaceFlinger::getVsyncPeriodFromHWC() const {
@@ -1870,7 +1891,7 @@ nsecs_t SurfaceFlinger::getVsyncPeriodFromHWC() const {
 void SurfaceFlinger::onComposerHalVsync(hal::HWDisplayId hwcDisplayId, int64_t timestamp,
                                         std::optional<hal::VsyncPeriodNanos> vsyncPeriod) {
     const std::string tracePeriod = [vsyncPeriod]() {
-        if (ATRACE_ENABLED() && vsyncPeriod) {
+        if (isTracingEnabled() && vsyncPeriod) {
             std::stringstream ss;
             ss << "(" << *vsyncPeriod << ")";
             return ss.str();
@@ -2021,7 +2042,7 @@ bool SurfaceFlinger::commit(nsecs_t frameTime, int64_t vsyncId, nsecs_t expected
     mScheduledPresentTime = expectedVsyncTime;
 
     const auto vsyncIn = [&] {
-        if (!ATRACE_ENABLED()) return 0.f;
+        if (!isTracingEnabled()) return 0.f;
         return (mExpectedPresentTime - systemTime()) / 1e6f;
     }();
     ATRACE_FORMAT("%s %" PRId64 " vsyncIn %.2fms%s", __func__, vsyncId, vsyncIn,
@@ -2464,6 +2485,12 @@ void SurfaceFlinger::postComposition() {
     mPreviousPresentFences[0].fenceTime =
             std::make_shared<FenceTime>(mPreviousPresentFences[0].fence);
 
+    // TimeStats and FrameTimeline both poll these fences. Hand them to the
+    // process-wide watcher so each one is resolved with a single ioctl when
+    // it signals and every later query hits the FenceTime cache.
+    FenceWatcher::getInstance().watch(glCompositionDoneFenceTime);
+    FenceWatcher::getInstance().watch(mPreviousPresentFences[0].fenceTime);
+
     nsecs_t now = systemTime();
 
     // Set presentation information before calling Layer::releasePendingBuffer, such that jank
@@ -2627,7 +2654,7 @@ void SurfaceFlinger::postComposition() {
 
     // Even though ATRACE_INT64 already checks if tracing is enabled, it doesn't prevent the
     // side-effect of getTotalSize(), so we check that again here
-    if (ATRACE_ENABLED()) {
+    if (isTracingEnabled()) {
         // getTotalSize returns the total number of buffers that were allocated by SurfaceFlinger
         ATRACE_INT64("Total Buffer Size", GraphicBufferAllocator::get().getTotalSize());
     }
@@ -2764,6 +2791,23 @@ std::pair<DisplayModes, DisplayModePtr> SurfaceFlinger::loadDisplayModes(
 }
 
 void SurfaceFlinger::processDisplayHotplugEventsLocked() {
+    // When several displays connect at once, e.g. during boot, overlap their identification
+    // data fetches (EDID reads through the composer HAL) so the serial processing below
+    // finds the data already cached.
+    if (mPendingHotplugEvents.size() > 1) {
+        std::vector<std::future<void>> fetches;
+        for (const auto& event : mPendingHotplugEvents) {
+            if (event.connection == hal::Connection::CONNECTED) {
+                fetches.push_back(std::async(std::launch::async, [this, id = event.hwcDisplayId] {
+                    getHwComposer().prefetchDisplayIdentificationData(id);
+                }));
+            }
+        }
+        for (auto& fetch : fetches) {
+            fetch.wait();
+        }
+    }
+
     for (const auto& event : mPendingHotplugEvents) {
         std::optional<DisplayIdentificationInfo> info =
                 getHwComposer().onHotplug(event.hwcDisplayId, event.connection);
@@ -3125,6 +3169,9 @@ void SurfaceFlinger::processDisplayChanged(const wp<IBinder>& displayToken,
 }
 void SurfaceFlinger::updateInternalDisplayVsyncLocked(const sp<DisplayDevice>& activeDisplay) {
     mVsyncConfiguration->reset();
+    // The reset wiped the cache, so rebuild it for the new active display's modes before any
+    // mode switch needs them.
+    mVsyncConfiguration->cacheConfigsForRefreshRates(getSupportedRefreshRates(activeDisplay));
     const Fps refreshRate = activeDisplay->refreshRateConfigs().getActiveMode()->getFps();
     updatePhaseConfiguration(refreshRate);
     mRefreshRateStats->setRefreshRate(refreshRate);
@@ -3298,7 +3345,7 @@ void SurfaceFlinger::updateInputFlinger() {
         for (const auto& focusRequest : inputWindowCommands.focusRequests) {
             inputFlinger->setFocusedWindow(focusRequest);
         }
-    }});
+    }}, BackgroundExecutor::kWindowInfoTag);
 
     mInputWindowCommands.clear();
 }
@@ -3440,6 +3487,9 @@ void SurfaceFlinger::initScheduler(const sp<DisplayDevice>& display) {
                                                                       hal::PowerMode::OFF);
 
     mVsyncConfiguration = getFactory().createVsyncConfiguration(currRefreshRate);
+    // Precompute the configs for every supported mode now, so a later mode switch is a cache
+    // lookup instead of an offset computation on the switch path.
+    mVsyncConfiguration->cacheConfigsForRefreshRates(getSupportedRefreshRates(display));
     mVsyncModulator = sp<VsyncModulator>::make(mVsyncConfiguration->getCurrentConfigs());
 
     using Feature = scheduler::Feature;
@@ -3567,6 +3617,19 @@ void SurfaceFlinger::doCommitTransactions() {
     if (mNumClones > 0) {
         mDrawingState.traverse([&](Layer* layer) { layer->updateMirrorInfo(); });
     }
+
+    // The drawing hierarchy is final for this commit; flatten it so the
+    // remaining per-frame traversals iterate a contiguous array.
+    mDrawingState.rebuildTraversalCache();
+
+    publishDrawingLayersSnapshot();
+}
+
+void SurfaceFlinger::publishDrawingLayersSnapshot() {
+    auto snapshot = std::make_shared<std::vector<sp<Layer>>>();
+    mDrawingState.traverseInZOrder([&](Layer* layer) { snapshot->emplace_back(layer); });
+    std::lock_guard lock(mDrawingLayersSnapshotLock);
+    mDrawingLayersSnapshot = std::move(snapshot);
 }
 
 void SurfaceFlinger::commitOffscreenLayers() {
@@ -4051,12 +4114,15 @@ auto SurfaceFlinger::transactionIsReadyToBeApplied(TransactionState& transaction
 
     bool fenceUnsignaled = false;
     auto queueProcessTime = systemTime();
-    for (const ComposerState& state : states) {
+    for (size_t i = 0; i < states.size(); i++) {
+        const ComposerState& state = states[i];
         const layer_state_t& s = state.state;
 
         sp<Layer> layer = nullptr;
         if (s.surface) {
-            layer = fromHandle(s.surface).promote();
+            // Use the layer resolved when the transaction was queued, if available.
+            layer = i < transaction.resolvedLayers.size() ? transaction.resolvedLayers[i].promote()
+                                                          : fromHandle(s.surface).promote();
         } else if (s.hasBufferChanges()) {
             ALOGW("Transaction with buffer, but no Layer?");
             continue;
@@ -4084,9 +4150,17 @@ auto SurfaceFlinger::transactionIsReadyToBeApplied(TransactionState& transaction
         const bool acquireFenceChanged = s.bufferData &&
                 s.bufferData->flags.test(BufferData::BufferDataChange::fenceChanged) &&
                 s.bufferData->acquireFence;
-        fenceUnsignaled = fenceUnsignaled ||
-                (acquireFenceChanged &&
-                 s.bufferData->acquireFence->getStatus() == Fence::Status::Unsignaled);
+        if (acquireFenceChanged && !fenceUnsignaled) {
+            // Prefer the FenceTime registered with the FenceWatcher when the transaction was
+            // queued: once the fence signals, this is a cached read rather than an ioctl.
+            std::shared_ptr<FenceTime> fenceTime;
+            if (i < transaction.queuedAcquireFenceTimes.size()) {
+                fenceTime = transaction.queuedAcquireFenceTimes[i];
+            }
+            fenceUnsignaled = fenceTime != nullptr
+                    ? fenceTime->getSignalTime() == Fence::SIGNAL_TIME_PENDING
+                    : s.bufferData->acquireFence->getStatus() == Fence::Status::Unsignaled;
+        }
 
         if (fenceUnsignaled && !allowLatchUnsignaled) {
             if (!transaction.sentFenceTimeoutWarning &&
@@ -4119,6 +4193,25 @@ auto SurfaceFlinger::transactionIsReadyToBeApplied(TransactionState& transaction
 void SurfaceFlinger::queueTransaction(TransactionState& state) {
     state.queueTime = systemTime();
 
+    // Pre-resolve the layer for each state on the calling thread, outside the queue lock.
+    // By the time a client queues a transaction it already holds the layer handle, so any
+    // layer that would be found at apply time is found here too. Changed acquire fences are
+    // wrapped in FenceTimes and registered with the FenceWatcher here as well, so their
+    // signal status resolves on the watcher thread and the main thread's readiness checks
+    // pick up already-resolved fences.
+    state.resolvedLayers.reserve(state.states.size());
+    state.queuedAcquireFenceTimes.reserve(state.states.size());
+    for (const auto& [s] : state.states) {
+        state.resolvedLayers.push_back(fromHandle(s.surface));
+        std::shared_ptr<FenceTime> fenceTime;
+        if (s.bufferData && s.bufferData->flags.test(BufferData::BufferDataChange::fenceChanged) &&
+            s.bufferData->acquireFence && s.bufferData->acquireFence->isValid()) {
+            fenceTime = std::make_shared<FenceTime>(s.bufferData->acquireFence);
+            FenceWatcher::getInstance().watch(fenceTime);
+        }
+        state.queuedAcquireFenceTimes.push_back(std::move(fenceTime));
+    }
+
     Mutex::Autolock lock(mQueueLock);
 
     // Generate a CountDownLatch pending state if this is a synchronous transaction.
@@ -5024,25 +5117,37 @@ status_t SurfaceFlinger::doDump(int fd, const DumpArgs& args, bool asProto) {
         StringAppendF(&result, "Permission Denial: can't dump SurfaceFlinger from pid=%d, uid=%d\n",
                       pid, uid);
     } else {
+        // These dumpers only consume the published drawing-layers snapshot or
+        // state with its own synchronization, so they run without mStateLock
+        // and cannot stall commit.
+        static const std::unordered_map<std::string, Dumper> lockFreeDumpers = {
+                {"--latency"s, argsDumper(&SurfaceFlinger::dumpStats)},
+                {"--latency-clear"s, argsDumper(&SurfaceFlinger::clearStats)},
+                {"--list"s, dumper(&SurfaceFlinger::listLayers)},
+                {"--timestats"s, protoDumper(&SurfaceFlinger::dumpTimeStats)},
+                {"--frametimeline"s, argsDumper(&SurfaceFlinger::dumpFrameTimeline)},
+        };
+
         static const std::unordered_map<std::string, Dumper> dumpers = {
                 {"--comp-displays"s, dumper(&SurfaceFlinger::dumpCompositionDisplays)},
                 {"--display-id"s, dumper(&SurfaceFlinger::dumpDisplayIdentificationData)},
                 {"--displays"s, dumper(&SurfaceFlinger::dumpDisplays)},
                 {"--dispsync"s, dumper([this](std::string& s) { mScheduler->dumpVsync(s); })},
                 {"--edid"s, argsDumper(&SurfaceFlinger::dumpRawDisplayIdentificationData)},
-                {"--latency"s, argsDumper(&SurfaceFlinger::dumpStatsLocked)},
-                {"--latency-clear"s, argsDumper(&SurfaceFlinger::clearStatsLocked)},
-                {"--list"s, dumper(&SurfaceFlinger::listLayersLocked)},
                 {"--planner"s, argsDumper(&SurfaceFlinger::dumpPlannerInfo)},
                 {"--static-screen"s, dumper(&SurfaceFlinger::dumpStaticScreenStats)},
-                {"--timestats"s, protoDumper(&SurfaceFlinger::dumpTimeStats)},
                 {"--vsync"s, dumper(&SurfaceFlinger::dumpVSync)},
                 {"--wide-color"s, dumper(&SurfaceFlinger::dumpWideColorInfo)},
-                {"--frametimeline"s, argsDumper(&SurfaceFlinger::dumpFrameTimeline)},
         };
 
         const auto flag = args.empty() ? ""s : std::string(String8(args[0]));
 
+        if (const auto it = lockFreeDumpers.find(flag); it != lockFreeDumpers.end()) {
+            (it->second)(args, asProto, result);
+            write(fd, result.c_str(), result.size());
+            return NO_ERROR;
+        }
+
         // Traversal of drawing state must happen on the main thread.
         // Otherwise, SortedVector may have shared ownership during concurrent
         // traversals, which can result in use-after-frees.
@@ -5111,35 +5216,47 @@ status_t SurfaceFlinger::dumpCritical(int fd, const DumpArgs&, bool asProto) {
     return doDump(fd, DumpArgs(), asProto);
 }
 
-void SurfaceFlinger::listLayersLocked(std::string& result) const {
-    mCurrentState.traverseInZOrder(
-            [&](Layer* layer) { StringAppendF(&result, "%s\n", layer->getDebugName()); });
+void SurfaceFlinger::listLayers(std::string& result) const {
+    if (const auto snapshot = getDrawingLayersSnapshot()) {
+        for (const sp<Layer>& layer : *snapshot) {
+            StringAppendF(&result, "%s\n", layer->getDebugName());
+        }
+    }
 }
 
-void SurfaceFlinger::dumpStatsLocked(const DumpArgs& args, std::string& result) const {
-    StringAppendF(&result, "%" PRId64 "\n", getVsyncPeriodFromHWC());
+void SurfaceFlinger::dumpStats(const DumpArgs& args, std::string& result) const {
+    {
+        // Only the vsync period needs live state; the lock is dropped before the
+        // layer walk so a long stats dump cannot stall commit.
+        Mutex::Autolock lock(mStateLock);
+        StringAppendF(&result, "%" PRId64 "\n", getVsyncPeriodFromHWC());
+    }
 
     if (args.size() > 1) {
         const auto name = String8(args[1]);
-        mCurrentState.traverseInZOrder([&](Layer* layer) {
-            if (layer->getName() == name.string()) {
-                layer->dumpFrameStats(result);
+        if (const auto snapshot = getDrawingLayersSnapshot()) {
+            for (const sp<Layer>& layer : *snapshot) {
+                if (layer->getName() == name.string()) {
+                    layer->dumpFrameStats(result);
+                }
             }
-        });
+        }
     } else {
         mAnimFrameTracker.dumpStats(result);
     }
 }
 
-void SurfaceFlinger::clearStatsLocked(const DumpArgs& args, std::string&) {
+void SurfaceFlinger::clearStats(const DumpArgs& args, std::string&) {
     const bool clearAll = args.size() < 2;
     const auto name = clearAll ? String8() : String8(args[1]);
 
-    mCurrentState.traverse([&](Layer* layer) {
-        if (clearAll || layer->getName() == name.string()) {
-            layer->clearFrameStats();
+    if (const auto snapshot = getDrawingLayersSnapshot()) {
+        for (const sp<Layer>& layer : *snapshot) {
+            if (clearAll || layer->getName() == name.string()) {
+                layer->clearFrameStats();
+            }
         }
-    });
+    }
 
     mAnimFrameTracker.clearStats();
 }
@@ -5184,6 +5301,8 @@ void SurfaceFlinger::dumpVSync(std::string& result) const {
                   "      present offset: %9" PRId64 " ns\t     VSYNC period: %9" PRId64 " ns\n\n",
                   dispSyncPresentTimeOffset, getVsyncPeriodFromHWC());
 
+    mVsyncModulator->dump(result);
+
     StringAppendF(&result, "(mode override by backdoor: %s)\n\n",
                   mDebugDisplayModeSetByBackdoor ? "yes" : "no");
 
@@ -5307,11 +5426,56 @@ void SurfaceFlinger::dumpWideColorInfo(std::string& result) const {
 }
 
 LayersProto SurfaceFlinger::dumpDrawingStateProto(uint32_t traceFlags) const {
-    LayersProto layersProto;
+    // Flatten the hierarchy first so serialization can be sharded across
+    // workers; the resulting order matches the recursive writeToProto() walk.
+    std::vector<Layer*> layers;
     for (const sp<Layer>& layer : mDrawingState.layersSortedByZ) {
-        layer->writeToProto(layersProto, traceFlags);
+        layer->appendDrawingHierarchy(layers);
+    }
+
+    // Below this size the fork/join overhead outweighs the parallelism.
+    static constexpr size_t kLayersPerShard = 32;
+    const size_t maxShards = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t numShards =
+            std::min(std::max<size_t>(layers.size() / kLayersPerShard, 1), maxShards);
+
+    if (numShards == 1) {
+        LayersProto layersProto;
+        for (Layer* layer : layers) {
+            layer->writeSelfToProto(layersProto, traceFlags);
+        }
+        return layersProto;
     }
 
+    // Serializing a layer only reads state owned by this (the main) thread,
+    // which is parked here until every worker is done, so the workers can read
+    // it concurrently. Each shard fills its own proto; the shards are spliced
+    // back together in z order below.
+    const size_t shardSize = (layers.size() + numShards - 1) / numShards;
+    std::vector<LayersProto> shards(numShards);
+    const auto serializeShard = [&](size_t shard) {
+        const size_t begin = shard * shardSize;
+        const size_t end = std::min(begin + shardSize, layers.size());
+        for (size_t i = begin; i < end; i++) {
+            layers[i]->writeSelfToProto(shards[shard], traceFlags);
+        }
+    };
+    std::vector<std::future<void>> futures;
+    futures.reserve(numShards - 1);
+    for (size_t shard = 1; shard < numShards; shard++) {
+        futures.push_back(std::async(std::launch::async, serializeShard, shard));
+    }
+    serializeShard(0);
+    for (auto& future : futures) {
+        future.wait();
+    }
+
+    LayersProto layersProto = std::move(shards[0]);
+    for (size_t shard = 1; shard < numShards; shard++) {
+        for (LayerProto& layerProto : *shards[shard].mutable_layers()) {
+            layersProto.add_layers()->Swap(&layerProto);
+        }
+    }
     return layersProto;
 }
 
@@ -5730,9 +5894,9 @@ status_t SurfaceFlinger::CheckTransactCodeCredentials(uint32_t code) {
         code == IBinder::SYSPROPS_TRANSACTION) {
         return OK;
     }
-    // Numbers from 1000 to 1042 are currently used for backdoors. The code
+    // Numbers from 1000 to 1043 are currently used for backdoors. The code
     // in onTransact verifies that the user is root, and has access to use SF.
-    if (code >= 1000 && code <= 1042) {
+    if (code >= 1000 && code <= 1043) {
         ALOGV("Accessing SurfaceFlinger through backdoor code: %u", code);
         return OK;
     }
@@ -6209,6 +6373,20 @@ status_t SurfaceFlinger::onTransact(uint32_t code, const Parcel& data, Parcel* r
                 reply->writeInt32(NO_ERROR);
                 return NO_ERROR;
             }
+            case 1043: { // Trim GPU memory. Used by tests and as a memory pressure hook: the
+                         // staged levels let callers reclaim cached GPU resources without the
+                         // re-upload cost of destroying the contexts.
+                using TrimMemoryLevel = renderengine::RenderEngine::TrimMemoryLevel;
+                const int32_t level = data.readInt32();
+                if (level < static_cast<int32_t>(TrimMemoryLevel::WATERMARK) ||
+                    level > static_cast<int32_t>(TrimMemoryLevel::ALL)) {
+                    reply->writeInt32(BAD_VALUE);
+                    return BAD_VALUE;
+                }
+                getRenderEngine().trimGpuMemory(static_cast<TrimMemoryLevel>(level));
+                reply->writeInt32(NO_ERROR);
+                return NO_ERROR;
+            }
         }
     }
     return err;
@@ -6648,6 +6826,219 @@ status_t SurfaceFlinger::captureLayers(const LayerCaptureArgs& args,
     return fenceStatus(future.get());
 }
 
+namespace {
+
+// Forwards capture-session results to the client and returns the pool buffer to the free
+// list if the capture failed, since the client never sees (and thus never releases) the
+// buffer in that case.
+class CaptureSessionFrameListener : public gui::BnScreenCaptureListener {
+public:
+    CaptureSessionFrameListener(sp<SurfaceFlinger> flinger, int32_t sessionId, uint64_t bufferId,
+                                sp<gui::IScreenCaptureListener> listener)
+          : mFlinger(std::move(flinger)),
+            mSessionId(sessionId),
+            mBufferId(bufferId),
+            mListener(std::move(listener)) {}
+
+    binder::Status onScreenCaptureCompleted(const gui::ScreenCaptureResults& results) override {
+        if (results.result != OK) {
+            mFlinger->releaseCaptureSessionBuffer(mSessionId, mBufferId);
+        }
+        return mListener->onScreenCaptureCompleted(results);
+    }
+
+private:
+    const sp<SurfaceFlinger> mFlinger;
+    const int32_t mSessionId;
+    const uint64_t mBufferId;
+    const sp<gui::IScreenCaptureListener> mListener;
+};
+
+class CaptureSessionDeathRecipient : public IBinder::DeathRecipient {
+public:
+    CaptureSessionDeathRecipient(sp<SurfaceFlinger> flinger, int32_t sessionId)
+          : mFlinger(std::move(flinger)), mSessionId(sessionId) {}
+
+    void binderDied(const wp<IBinder>& /* who */) override {
+        mFlinger->destroyCaptureSession(mSessionId);
+    }
+
+private:
+    const sp<SurfaceFlinger> mFlinger;
+    const int32_t mSessionId;
+};
+
+// True for the session owner as well as for calls surfaceflinger makes to itself, e.g.
+// from the session death recipient or a failed-capture cleanup.
+bool canManageCaptureSession(uid_t ownerUid) {
+    const uid_t uid = IPCThreadState::self()->getCallingUid();
+    return uid == ownerUid || uid == AID_ROOT || uid == AID_GRAPHICS || uid == AID_SYSTEM;
+}
+
+} // namespace
+
+status_t SurfaceFlinger::createDisplayCaptureSession(
+        const DisplayCaptureArgs& args, const std::vector<sp<GraphicBuffer>>& buffers,
+        const sp<IScreenCaptureListener>& captureListener, int32_t* outSessionId) {
+    ATRACE_CALL();
+
+    status_t validate = validateScreenshotPermissions(args);
+    if (validate != OK) {
+        return validate;
+    }
+
+    if (!args.displayToken) return BAD_VALUE;
+    if (captureListener == nullptr || outSessionId == nullptr) return BAD_VALUE;
+    if (buffers.empty()) {
+        ALOGE("%s: capture session requires at least one pool buffer", __func__);
+        return BAD_VALUE;
+    }
+
+    CaptureSession session;
+    session.args = args;
+    session.listener = captureListener;
+    session.ownerUid = IPCThreadState::self()->getCallingUid();
+    session.pool.reserve(buffers.size());
+    for (const sp<GraphicBuffer>& buffer : buffers) {
+        if (buffer == nullptr || buffer->initCheck() != OK) {
+            ALOGE("%s: invalid pool buffer", __func__);
+            return BAD_VALUE;
+        }
+        if (exceedsMaxRenderTargetSize(buffer->getWidth(), buffer->getHeight())) {
+            ALOGE("%s: pool buffer size (%" PRIu32 ", %" PRIu32
+                  ") exceeds render target size limit.",
+                  __func__, buffer->getWidth(), buffer->getHeight());
+            return BAD_VALUE;
+        }
+        CaptureSession::PoolBuffer poolBuffer;
+        poolBuffer.texture = std::make_shared<
+                renderengine::impl::ExternalTexture>(buffer, getRenderEngine(),
+                                                     renderengine::impl::ExternalTexture::Usage::
+                                                             WRITEABLE);
+        session.pool.emplace_back(std::move(poolBuffer));
+    }
+
+    int32_t sessionId;
+    sp<IBinder::DeathRecipient> deathRecipient;
+    {
+        std::lock_guard lock(mCaptureSessionLock);
+        sessionId = mNextCaptureSessionId++;
+        deathRecipient = new CaptureSessionDeathRecipient(this, sessionId);
+        session.deathRecipient = deathRecipient;
+        mCaptureSessions.emplace(sessionId, std::move(session));
+    }
+
+    sp<IBinder> listenerBinder = IInterface::asBinder(captureListener);
+    if (listenerBinder->remoteBinder() != nullptr) {
+        listenerBinder->linkToDeath(deathRecipient);
+    }
+
+    *outSessionId = sessionId;
+    return NO_ERROR;
+}
+
+status_t SurfaceFlinger::captureSessionFrame(int32_t sessionId) {
+    ATRACE_CALL();
+
+    DisplayCaptureArgs args;
+    sp<IScreenCaptureListener> listener;
+    std::shared_ptr<renderengine::ExternalTexture> texture;
+    {
+        std::lock_guard lock(mCaptureSessionLock);
+        const auto it = mCaptureSessions.find(sessionId);
+        if (it == mCaptureSessions.end()) return NAME_NOT_FOUND;
+        CaptureSession& session = it->second;
+        if (!canManageCaptureSession(session.ownerUid)) return PERMISSION_DENIED;
+
+        const auto poolIt =
+                std::find_if(session.pool.begin(), session.pool.end(),
+                             [](const CaptureSession::PoolBuffer& buffer) { return buffer.free; });
+        if (poolIt == session.pool.end()) {
+            ALOGW("%s: all pool buffers for session %d are in flight", __func__, sessionId);
+            return WOULD_BLOCK;
+        }
+        poolIt->free = false;
+        texture = poolIt->texture;
+        args = session.args;
+        listener = session.listener;
+    }
+
+    wp<const DisplayDevice> displayWeak;
+    ui::LayerStack layerStack;
+    ui::Dataspace dataspace;
+    const ui::Size reqSize(texture->getWidth(), texture->getHeight());
+    {
+        Mutex::Autolock lock(mStateLock);
+        sp<DisplayDevice> display = getDisplayDeviceLocked(args.displayToken);
+        if (!display) {
+            releaseCaptureSessionBuffer(sessionId, texture->getBuffer()->getId());
+            return NAME_NOT_FOUND;
+        }
+        displayWeak = display;
+        layerStack = display->getLayerStack();
+
+        dataspace = args.dataspace;
+        if (dataspace == ui::Dataspace::UNKNOWN) {
+            const ui::ColorMode colorMode = display->getCompositionDisplay()->getState().colorMode;
+            dataspace = pickDataspaceFromColorMode(colorMode);
+        }
+    }
+
+    RenderAreaFuture renderAreaFuture = ftl::defer([=] {
+        return DisplayRenderArea::create(displayWeak, args.sourceCrop, reqSize, dataspace,
+                                         args.useIdentityTransform, args.captureSecureLayers);
+    });
+
+    auto traverseLayers = [this, args, layerStack](const LayerVector::Visitor& visitor) {
+        traverseLayersInLayerStack(layerStack, args.uid, visitor);
+    };
+
+    const sp<IScreenCaptureListener> frameListener =
+            new CaptureSessionFrameListener(this, sessionId, texture->getBuffer()->getId(),
+                                            listener);
+    auto future = captureScreenCommon(std::move(renderAreaFuture), traverseLayers, texture,
+                                      false /* regionSampling */, args.grayscale, frameListener);
+    return fenceStatus(future.get());
+}
+
+status_t SurfaceFlinger::releaseCaptureSessionBuffer(int32_t sessionId, uint64_t bufferId) {
+    std::lock_guard lock(mCaptureSessionLock);
+    const auto it = mCaptureSessions.find(sessionId);
+    if (it == mCaptureSessions.end()) return NAME_NOT_FOUND;
+    CaptureSession& session = it->second;
+    if (!canManageCaptureSession(session.ownerUid)) return PERMISSION_DENIED;
+
+    for (CaptureSession::PoolBuffer& poolBuffer : session.pool) {
+        if (poolBuffer.texture->getBuffer()->getId() == bufferId) {
+            poolBuffer.free = true;
+            return NO_ERROR;
+        }
+    }
+
+    ALOGE("%s: buffer %" PRIu64 " does not belong to session %d", __func__, bufferId, sessionId);
+    return BAD_VALUE;
+}
+
+status_t SurfaceFlinger::destroyCaptureSession(int32_t sessionId) {
+    sp<IScreenCaptureListener> listener;
+    sp<IBinder::DeathRecipient> deathRecipient;
+    {
+        std::lock_guard lock(mCaptureSessionLock);
+        const auto it = mCaptureSessions.find(sessionId);
+        if (it == mCaptureSessions.end()) return NAME_NOT_FOUND;
+        if (!canManageCaptureSession(it->second.ownerUid)) return PERMISSION_DENIED;
+        listener = std::move(it->second.listener);
+        deathRecipient = std::move(it->second.deathRecipient);
+        mCaptureSessions.erase(it);
+    }
+
+    sp<IBinder> listenerBinder = IInterface::asBinder(listener);
+    if (listenerBinder->remoteBinder() != nullptr) {
+        listenerBinder->unlinkToDeath(deathRecipient);
+    }
+    return NO_ERROR;
+}
+
 ftl::SharedFuture<FenceResult> SurfaceFlinger::captureScreenCommon(
         RenderAreaFuture renderAreaFuture, TraverseLayersFunction traverseLayers,
         ui::Size bufferSize, ui::PixelFormat reqPixelFormat, bool allowProtected, bool grayscale,
@@ -6927,9 +7318,24 @@ void SurfaceFlinger::windowInfosReported() {
 // ---------------------------------------------------------------------------
 
 void SurfaceFlinger::State::traverse(const LayerVector::Visitor& visitor) const {
+    // Iterating the flat snapshot also keeps the walk stable if a visitor
+    // attaches clone layers mid-traversal; those invalidate the cache for the
+    // next walk without affecting this one.
+    if (traversalCacheValid) {
+        for (Layer* layer : traversalCache) {
+            visitor(layer);
+        }
+        return;
+    }
     layersSortedByZ.traverse(visitor);
 }
 
+void SurfaceFlinger::State::rebuildTraversalCache() const {
+    traversalCache.clear();
+    layersSortedByZ.traverse([this](Layer* layer) { traversalCache.push_back(layer); });
+    traversalCacheValid = true;
+}
+
 void SurfaceFlinger::State::traverseInZOrder(const LayerVector::Visitor& visitor) const {
     layersSortedByZ.traverseInZOrder(stateSet, visitor);
 }
@@ -7617,6 +8023,31 @@ binder::Status SurfaceComposerAIDL::captureLayers(
     return binder::Status::fromStatusT(status);
 }
 
+binder::Status SurfaceComposerAIDL::createDisplayCaptureSession(
+        const DisplayCaptureArgs& args, const gui::ScreenCaptureSessionBuffers& buffers,
+        const sp<IScreenCaptureListener>& captureListener, int32_t* outSessionId) {
+    status_t status = mFlinger->createDisplayCaptureSession(args, buffers.buffers, captureListener,
+                                                            outSessionId);
+    return binder::Status::fromStatusT(status);
+}
+
+binder::Status SurfaceComposerAIDL::captureSessionFrame(int32_t sessionId) {
+    status_t status = mFlinger->captureSessionFrame(sessionId);
+    return binder::Status::fromStatusT(status);
+}
+
+binder::Status SurfaceComposerAIDL::releaseCaptureSessionBuffer(int32_t sessionId,
+                                                                int64_t bufferId) {
+    status_t status =
+            mFlinger->releaseCaptureSessionBuffer(sessionId, static_cast<uint64_t>(bufferId));
+    return binder::Status::fromStatusT(status);
+}
+
+binder::Status SurfaceComposerAIDL::destroyCaptureSession(int32_t sessionId) {
+    status_t status = mFlinger->destroyCaptureSession(sessionId);
+    return binder::Status::fromStatusT(status);
+}
+
 binder::Status SurfaceComposerAIDL::isWideColorDisplay(const sp<IBinder>& token,
                                                        bool* outIsWideColorDisplay) {
     status_t status = mFlinger->isWideColorDisplay(token, outIsWideColorDisplay);
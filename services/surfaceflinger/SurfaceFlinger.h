@@ -417,6 +417,10 @@ private:
             }
             globalShadowSettings = other.globalShadowSettings;
 
+            // The layer hierarchy was just replaced wholesale, so any
+            // flattened traversal order built from it is stale.
+            invalidateTraversalCache();
+
             return *this;
         }
 
@@ -432,6 +436,30 @@ private:
         void traverse(const LayerVector::Visitor& visitor) const;
         void traverseInZOrder(const LayerVector::Visitor& visitor) const;
         void traverseInReverseZOrder(const LayerVector::Visitor& visitor) const;
+
+        // Drops the flattened traversal order, making traverse fall back to
+        // the recursive walk. Must be called whenever the layer hierarchy
+        // this state describes changes. The array itself is left in place
+        // (rebuildTraversalCache replaces it) so a visitor invalidating the
+        // cache mid-traversal doesn't break the walk in progress.
+        void invalidateTraversalCache() const { traversalCacheValid = false; }
+
+        // Rebuilds the flattened traversal order. Only called for the drawing
+        // state, at the end of commitTransactionsLocked under mStateLock, so
+        // that traverse never has to write the cache itself: the drawing
+        // hierarchy changes at well-defined points (the state assignment in
+        // commitTransactionsLocked and clone layer attachment), while the
+        // current hierarchy mutates from many call sites.
+        void rebuildTraversalCache() const;
+
+        // Flattened hierarchy traversal order used by traverse, so that the
+        // many per-frame walks iterate a contiguous array instead of
+        // recursing through the layer tree with sp<> refcount traffic each
+        // time. The layers are kept alive by the sp<> references in
+        // layersSortedByZ and their child vectors for as long as the cache
+        // is valid.
+        mutable std::vector<Layer*> traversalCache;
+        mutable bool traversalCacheValid = false;
     };
 
     // Keeps track of pending buffers per layer handle in the transaction queue or current/drawing
@@ -561,6 +589,17 @@ private:
     status_t captureDisplay(DisplayId, const sp<IScreenCaptureListener>&);
     status_t captureLayers(const LayerCaptureArgs&, const sp<IScreenCaptureListener>&);
 
+    // Capture sessions render repeatedly into a caller-provided rotating buffer pool so
+    // continuous capture does not allocate per frame. Buffers are wrapped as render engine
+    // textures once at creation; each captureSessionFrame picks the next free buffer and
+    // results are delivered asynchronously through the session listener.
+    status_t createDisplayCaptureSession(const DisplayCaptureArgs&,
+                                         const std::vector<sp<GraphicBuffer>>& buffers,
+                                         const sp<IScreenCaptureListener>&, int32_t* outSessionId);
+    status_t captureSessionFrame(int32_t sessionId);
+    status_t releaseCaptureSessionBuffer(int32_t sessionId, uint64_t bufferId);
+    status_t destroyCaptureSession(int32_t sessionId);
+
     status_t getDisplayStats(const sp<IBinder>& displayToken, DisplayStatInfo* stats);
     status_t getDisplayState(const sp<IBinder>& displayToken, ui::DisplayState*)
             EXCLUDES(mStateLock);
@@ -881,6 +920,22 @@ private:
             const std::shared_ptr<renderengine::ExternalTexture>&, bool canCaptureBlackoutContent,
             bool regionSampling, bool grayscale, ScreenCaptureResults&) EXCLUDES(mStateLock);
 
+    // State for a repeated-capture session created via createDisplayCaptureSession.
+    struct CaptureSession {
+        struct PoolBuffer {
+            std::shared_ptr<renderengine::ExternalTexture> texture;
+            bool free = true;
+        };
+        DisplayCaptureArgs args;
+        sp<IScreenCaptureListener> listener;
+        sp<IBinder::DeathRecipient> deathRecipient;
+        std::vector<PoolBuffer> pool;
+        uid_t ownerUid;
+    };
+    std::mutex mCaptureSessionLock;
+    std::unordered_map<int32_t, CaptureSession> mCaptureSessions GUARDED_BY(mCaptureSessionLock);
+    int32_t mNextCaptureSessionId GUARDED_BY(mCaptureSessionLock) = 1;
+
     bool canAllocateHwcDisplayIdForVDS(uint64_t usage);
 
     // If the uid provided is not UNSET_UID, the traverse will skip any layers that don't have a
@@ -1095,9 +1150,11 @@ private:
                        std::string& result) const REQUIRES(mStateLock);
 
     void appendSfConfigString(std::string& result) const;
-    void listLayersLocked(std::string& result) const;
-    void dumpStatsLocked(const DumpArgs& args, std::string& result) const REQUIRES(mStateLock);
-    void clearStatsLocked(const DumpArgs& args, std::string& result);
+    // These read from the published drawing-layers snapshot rather than live state,
+    // so they run without mStateLock.
+    void listLayers(std::string& result) const EXCLUDES(mStateLock);
+    void dumpStats(const DumpArgs& args, std::string& result) const EXCLUDES(mStateLock);
+    void clearStats(const DumpArgs& args, std::string& result) EXCLUDES(mStateLock);
     void dumpTimeStats(const DumpArgs& args, bool asProto, std::string& result) const;
     void dumpFrameTimeline(const DumpArgs& args, std::string& result) const;
     void logFrameStats() REQUIRES(kMainThreadContext);
@@ -1208,6 +1265,23 @@ private:
     State mDrawingState{LayerVector::StateSet::Drawing};
     bool mVisibleRegionsDirty = false;
 
+    // RCU-style snapshot of the drawing-state layer list, republished by the main
+    // thread at the end of doCommitTransactions once the drawing hierarchy is final.
+    // Read-only consumers (dumpsys listings, frame stats) grab the shared_ptr and
+    // iterate without mStateLock, so diagnostics never stall commit. The sp<>
+    // references keep the layers alive even if the main thread removes them while a
+    // reader is iterating; readers must only consume state that is immutable or
+    // internally synchronized (layer names, frame trackers).
+    std::shared_ptr<const std::vector<sp<Layer>>> getDrawingLayersSnapshot() const
+            EXCLUDES(mDrawingLayersSnapshotLock) {
+        std::lock_guard lock(mDrawingLayersSnapshotLock);
+        return mDrawingLayersSnapshot;
+    }
+    void publishDrawingLayersSnapshot(); // main thread only
+    mutable std::mutex mDrawingLayersSnapshotLock;
+    std::shared_ptr<const std::vector<sp<Layer>>> mDrawingLayersSnapshot
+            GUARDED_BY(mDrawingLayersSnapshotLock);
+
     // VisibleRegions dirty is already cleared by postComp, but we need to track it to prevent
     // extra work in the HDR layer info listener.
     bool mVisibleRegionsWereDirtyThisFrame = false;
@@ -1482,6 +1556,13 @@ public:
     binder::Status captureDisplayById(int64_t, const sp<IScreenCaptureListener>&) override;
     binder::Status captureLayers(const LayerCaptureArgs&,
                                  const sp<IScreenCaptureListener>&) override;
+    binder::Status createDisplayCaptureSession(const DisplayCaptureArgs&,
+                                               const gui::ScreenCaptureSessionBuffers&,
+                                               const sp<IScreenCaptureListener>&,
+                                               int32_t* outSessionId) override;
+    binder::Status captureSessionFrame(int32_t sessionId) override;
+    binder::Status releaseCaptureSessionBuffer(int32_t sessionId, int64_t bufferId) override;
+    binder::Status destroyCaptureSession(int32_t sessionId) override;
     binder::Status isWideColorDisplay(const sp<IBinder>& token,
                                       bool* outIsWideColorDisplay) override;
     binder::Status getDisplayBrightnessSupport(const sp<IBinder>& displayToken,
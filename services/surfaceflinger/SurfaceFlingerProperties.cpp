@@ -21,6 +21,7 @@
 #include <utils/Log.h>
 
 #include <log/log.h>
+#include <atomic>
 #include <cstdlib>
 #include <tuple>
 
@@ -34,10 +35,130 @@ using android::hardware::graphics::common::V1_2::Dataspace;
 using android::hardware::graphics::common::V1_2::PixelFormat;
 using android::ui::DisplayPrimaries;
 
+namespace {
+
+#define DISPLAY_PRIMARY_SIZE 3
+
+constexpr float kSrgbRedX = 0.4123f;
+constexpr float kSrgbRedY = 0.2126f;
+constexpr float kSrgbRedZ = 0.0193f;
+constexpr float kSrgbGreenX = 0.3576f;
+constexpr float kSrgbGreenY = 0.7152f;
+constexpr float kSrgbGreenZ = 0.1192f;
+constexpr float kSrgbBlueX = 0.1805f;
+constexpr float kSrgbBlueY = 0.0722f;
+constexpr float kSrgbBlueZ = 0.9506f;
+constexpr float kSrgbWhiteX = 0.9505f;
+constexpr float kSrgbWhiteY = 1.0000f;
+constexpr float kSrgbWhiteZ = 1.0891f;
+
+DisplayPrimaries parseDisplayNativePrimaries() {
+    auto mDisplay_primary_red = SurfaceFlingerProperties::display_primary_red();
+    auto mDisplay_primary_green = SurfaceFlingerProperties::display_primary_green();
+    auto mDisplay_primary_blue = SurfaceFlingerProperties::display_primary_blue();
+    auto mDisplay_primary_white = SurfaceFlingerProperties::display_primary_white();
+    // To avoid null point exception.
+    mDisplay_primary_red.resize(DISPLAY_PRIMARY_SIZE);
+    mDisplay_primary_green.resize(DISPLAY_PRIMARY_SIZE);
+    mDisplay_primary_blue.resize(DISPLAY_PRIMARY_SIZE);
+    mDisplay_primary_white.resize(DISPLAY_PRIMARY_SIZE);
+    DisplayPrimaries primaries =
+            {{static_cast<float>(mDisplay_primary_red[0].value_or(kSrgbRedX)),
+              static_cast<float>(mDisplay_primary_red[1].value_or(kSrgbRedY)),
+              static_cast<float>(mDisplay_primary_red[2].value_or(kSrgbRedZ))},
+             {static_cast<float>(mDisplay_primary_green[0].value_or(kSrgbGreenX)),
+              static_cast<float>(mDisplay_primary_green[1].value_or(kSrgbGreenY)),
+              static_cast<float>(mDisplay_primary_green[2].value_or(kSrgbGreenZ))},
+             {static_cast<float>(mDisplay_primary_blue[0].value_or(kSrgbBlueX)),
+              static_cast<float>(mDisplay_primary_blue[1].value_or(kSrgbBlueY)),
+              static_cast<float>(mDisplay_primary_blue[2].value_or(kSrgbBlueZ))},
+             {static_cast<float>(mDisplay_primary_white[0].value_or(kSrgbWhiteX)),
+              static_cast<float>(mDisplay_primary_white[1].value_or(kSrgbWhiteY)),
+              static_cast<float>(mDisplay_primary_white[2].value_or(kSrgbWhiteZ))}};
+
+    return primaries;
+}
+
+std::shared_ptr<const PropertySnapshot> parsePropertySnapshot() {
+    auto snapshot = std::make_shared<PropertySnapshot>();
+    snapshot->vsyncEventPhaseOffsetNs = SurfaceFlingerProperties::vsync_event_phase_offset_ns();
+    snapshot->vsyncSfEventPhaseOffsetNs =
+            SurfaceFlingerProperties::vsync_sf_event_phase_offset_ns();
+    snapshot->useContextPriority = SurfaceFlingerProperties::use_context_priority();
+    snapshot->maxFrameBufferAcquiredBuffers =
+            SurfaceFlingerProperties::max_frame_buffer_acquired_buffers();
+    snapshot->maxGraphicsWidth = SurfaceFlingerProperties::max_graphics_width();
+    snapshot->maxGraphicsHeight = SurfaceFlingerProperties::max_graphics_height();
+    snapshot->hasWideColorDisplay = SurfaceFlingerProperties::has_wide_color_display();
+    snapshot->runningWithoutSyncFramework =
+            SurfaceFlingerProperties::running_without_sync_framework();
+    snapshot->hasHdrDisplay = SurfaceFlingerProperties::has_HDR_display();
+    snapshot->presentTimeOffsetFromVsyncNs =
+            SurfaceFlingerProperties::present_time_offset_from_vsync_ns();
+    snapshot->forceHwcCopyForVirtualDisplays =
+            SurfaceFlingerProperties::force_hwc_copy_for_virtual_displays();
+    snapshot->maxVirtualDisplayDimension =
+            SurfaceFlingerProperties::max_virtual_display_dimension();
+    snapshot->useVrFlinger = SurfaceFlingerProperties::use_vr_flinger();
+    snapshot->startGraphicsAllocatorService =
+            SurfaceFlingerProperties::start_graphics_allocator_service();
+    snapshot->primaryDisplayOrientation = SurfaceFlingerProperties::primary_display_orientation();
+    snapshot->defaultCompositionDataspace =
+            SurfaceFlingerProperties::default_composition_dataspace();
+    snapshot->defaultCompositionPixelFormat =
+            SurfaceFlingerProperties::default_composition_pixel_format();
+    snapshot->wcgCompositionDataspace = SurfaceFlingerProperties::wcg_composition_dataspace();
+    snapshot->wcgCompositionPixelFormat = SurfaceFlingerProperties::wcg_composition_pixel_format();
+    snapshot->colorSpaceAgnosticDataspace =
+            SurfaceFlingerProperties::color_space_agnostic_dataspace();
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+    snapshot->refreshRateSwitching = SurfaceFlingerProperties::refresh_rate_switching();
+    snapshot->useSmart90ForVideo = SurfaceFlingerProperties::use_smart_90_for_video();
+#pragma clang diagnostic pop
+    snapshot->setIdleTimerMs = SurfaceFlingerProperties::set_idle_timer_ms();
+    snapshot->setTouchTimerMs = SurfaceFlingerProperties::set_touch_timer_ms();
+    snapshot->setDisplayPowerTimerMs = SurfaceFlingerProperties::set_display_power_timer_ms();
+    snapshot->useContentDetectionForRefreshRate =
+            SurfaceFlingerProperties::use_content_detection_for_refresh_rate();
+    snapshot->enableProtectedContents = SurfaceFlingerProperties::enable_protected_contents();
+    snapshot->supportKernelIdleTimer = SurfaceFlingerProperties::support_kernel_idle_timer();
+    snapshot->displayUpdateImminentTimeoutMs =
+            SurfaceFlingerProperties::display_update_imminent_timeout_ms();
+    snapshot->displayNativePrimaries = parseDisplayNativePrimaries();
+    snapshot->updateDeviceProductInfoOnHotplugReconnect =
+            SurfaceFlingerProperties::update_device_product_info_on_hotplug_reconnect();
+    snapshot->enableFrameRateOverride = SurfaceFlingerProperties::enable_frame_rate_override();
+    snapshot->enableLayerCaching = SurfaceFlingerProperties::enable_layer_caching();
+    snapshot->enableSdrDimming = SurfaceFlingerProperties::enable_sdr_dimming();
+    snapshot->ignoreHdrCameraLayers = SurfaceFlingerProperties::ignore_hdr_camera_layers();
+    return snapshot;
+}
+
+// Written by refreshPropertySnapshot(), read with an atomic load everywhere else.
+std::shared_ptr<const PropertySnapshot> gPropertySnapshot;
+
+} // namespace
+
+std::shared_ptr<const PropertySnapshot> getPropertySnapshot() {
+    auto snapshot = std::atomic_load_explicit(&gPropertySnapshot, std::memory_order_acquire);
+    if (snapshot == nullptr) {
+        // Racing first-use parses are benign; the last one published wins.
+        refreshPropertySnapshot();
+        snapshot = std::atomic_load_explicit(&gPropertySnapshot, std::memory_order_acquire);
+    }
+    return snapshot;
+}
+
+void refreshPropertySnapshot() {
+    std::atomic_store_explicit(&gPropertySnapshot, parsePropertySnapshot(),
+                               std::memory_order_release);
+}
+
 // Keep logic in sync with WindowManagerService functions that query SurfaceFlinger properties.
 // Consider exposing properties via ISurfaceComposer instead.
 int64_t vsync_event_phase_offset_ns(int64_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::vsync_event_phase_offset_ns();
+    auto temp = getPropertySnapshot()->vsyncEventPhaseOffsetNs;
     if (temp.has_value()) {
         return *temp;
     }
@@ -46,7 +167,7 @@ int64_t vsync_event_phase_offset_ns(int64_t defaultValue) {
 }
 
 int64_t vsync_sf_event_phase_offset_ns(int64_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::vsync_sf_event_phase_offset_ns();
+    auto temp = getPropertySnapshot()->vsyncSfEventPhaseOffsetNs;
     if (temp.has_value()) {
         return *temp;
     }
@@ -55,7 +176,7 @@ int64_t vsync_sf_event_phase_offset_ns(int64_t defaultValue) {
 }
 
 bool use_context_priority(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::use_context_priority();
+    auto temp = getPropertySnapshot()->useContextPriority;
     if (temp.has_value()) {
         return *temp;
     }
@@ -64,7 +185,7 @@ bool use_context_priority(bool defaultValue) {
 }
 
 int64_t max_frame_buffer_acquired_buffers(int64_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::max_frame_buffer_acquired_buffers();
+    auto temp = getPropertySnapshot()->maxFrameBufferAcquiredBuffers;
     if (temp.has_value()) {
         return *temp;
     }
@@ -73,7 +194,7 @@ int64_t max_frame_buffer_acquired_buffers(int64_t defaultValue) {
 }
 
 int32_t max_graphics_width(int32_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::max_graphics_width();
+    auto temp = getPropertySnapshot()->maxGraphicsWidth;
     if (temp.has_value()) {
         return *temp;
     }
@@ -81,7 +202,7 @@ int32_t max_graphics_width(int32_t defaultValue) {
 }
 
 int32_t max_graphics_height(int32_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::max_graphics_height();
+    auto temp = getPropertySnapshot()->maxGraphicsHeight;
     if (temp.has_value()) {
         return *temp;
     }
@@ -89,7 +210,7 @@ int32_t max_graphics_height(int32_t defaultValue) {
 }
 
 bool has_wide_color_display(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::has_wide_color_display();
+    auto temp = getPropertySnapshot()->hasWideColorDisplay;
     if (temp.has_value()) {
         return *temp;
     }
@@ -98,7 +219,7 @@ bool has_wide_color_display(bool defaultValue) {
 }
 
 bool running_without_sync_framework(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::running_without_sync_framework();
+    auto temp = getPropertySnapshot()->runningWithoutSyncFramework;
     if (temp.has_value()) {
         return !(*temp);
     }
@@ -106,7 +227,7 @@ bool running_without_sync_framework(bool defaultValue) {
 }
 
 bool has_HDR_display(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::has_HDR_display();
+    auto temp = getPropertySnapshot()->hasHdrDisplay;
     if (temp.has_value()) {
         return *temp;
     }
@@ -114,7 +235,7 @@ bool has_HDR_display(bool defaultValue) {
 }
 
 int64_t present_time_offset_from_vsync_ns(int64_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::present_time_offset_from_vsync_ns();
+    auto temp = getPropertySnapshot()->presentTimeOffsetFromVsyncNs;
     if (temp.has_value()) {
         return *temp;
     }
@@ -123,7 +244,7 @@ int64_t present_time_offset_from_vsync_ns(int64_t defaultValue) {
 }
 
 bool force_hwc_copy_for_virtual_displays(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::force_hwc_copy_for_virtual_displays();
+    auto temp = getPropertySnapshot()->forceHwcCopyForVirtualDisplays;
     if (temp.has_value()) {
         return *temp;
     }
@@ -132,7 +253,7 @@ bool force_hwc_copy_for_virtual_displays(bool defaultValue) {
 }
 
 int64_t max_virtual_display_dimension(int64_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::max_virtual_display_dimension();
+    auto temp = getPropertySnapshot()->maxVirtualDisplayDimension;
     if (temp.has_value()) {
         return *temp;
     }
@@ -141,7 +262,7 @@ int64_t max_virtual_display_dimension(int64_t defaultValue) {
 }
 
 bool use_vr_flinger(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::use_vr_flinger();
+    auto temp = getPropertySnapshot()->useVrFlinger;
     if (temp.has_value()) {
         return *temp;
     }
@@ -149,7 +270,7 @@ bool use_vr_flinger(bool defaultValue) {
 }
 
 bool start_graphics_allocator_service(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::start_graphics_allocator_service();
+    auto temp = getPropertySnapshot()->startGraphicsAllocatorService;
     if (temp.has_value()) {
         return *temp;
     }
@@ -159,7 +280,7 @@ bool start_graphics_allocator_service(bool defaultValue) {
 
 SurfaceFlingerProperties::primary_display_orientation_values primary_display_orientation(
         SurfaceFlingerProperties::primary_display_orientation_values defaultValue) {
-    auto temp = SurfaceFlingerProperties::primary_display_orientation();
+    auto temp = getPropertySnapshot()->primaryDisplayOrientation;
     if (temp.has_value()) {
         return *temp;
     }
@@ -196,7 +317,7 @@ SurfaceFlingerProperties::primary_display_orientation_values primary_display_ori
 }
 
 int64_t default_composition_dataspace(Dataspace defaultValue) {
-    auto temp = SurfaceFlingerProperties::default_composition_dataspace();
+    auto temp = getPropertySnapshot()->defaultCompositionDataspace;
     if (temp.has_value()) {
         return *temp;
     }
@@ -204,7 +325,7 @@ int64_t default_composition_dataspace(Dataspace defaultValue) {
 }
 
 int32_t default_composition_pixel_format(PixelFormat defaultValue) {
-    auto temp = SurfaceFlingerProperties::default_composition_pixel_format();
+    auto temp = getPropertySnapshot()->defaultCompositionPixelFormat;
     if (temp.has_value()) {
         return *temp;
     }
@@ -212,7 +333,7 @@ int32_t default_composition_pixel_format(PixelFormat defaultValue) {
 }
 
 int64_t wcg_composition_dataspace(Dataspace defaultValue) {
-    auto temp = SurfaceFlingerProperties::wcg_composition_dataspace();
+    auto temp = getPropertySnapshot()->wcgCompositionDataspace;
     if (temp.has_value()) {
         return *temp;
     }
@@ -220,7 +341,7 @@ int64_t wcg_composition_dataspace(Dataspace defaultValue) {
 }
 
 int32_t wcg_composition_pixel_format(PixelFormat defaultValue) {
-    auto temp = SurfaceFlingerProperties::wcg_composition_pixel_format();
+    auto temp = getPropertySnapshot()->wcgCompositionPixelFormat;
     if (temp.has_value()) {
         return *temp;
     }
@@ -228,7 +349,7 @@ int32_t wcg_composition_pixel_format(PixelFormat defaultValue) {
 }
 
 int64_t color_space_agnostic_dataspace(Dataspace defaultValue) {
-    auto temp = SurfaceFlingerProperties::color_space_agnostic_dataspace();
+    auto temp = getPropertySnapshot()->colorSpaceAgnosticDataspace;
     if (temp.has_value()) {
         return *temp;
     }
@@ -236,10 +357,7 @@ int64_t color_space_agnostic_dataspace(Dataspace defaultValue) {
 }
 
 bool refresh_rate_switching(bool defaultValue) {
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated-declarations"
-    auto temp = SurfaceFlingerProperties::refresh_rate_switching();
-#pragma clang diagnostic pop
+    auto temp = getPropertySnapshot()->refreshRateSwitching;
     if (temp.has_value()) {
         ALOGW("Using deprecated refresh_rate_switching sysprop. Value: %d", *temp);
         return *temp;
@@ -248,7 +366,7 @@ bool refresh_rate_switching(bool defaultValue) {
 }
 
 int32_t set_idle_timer_ms(int32_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::set_idle_timer_ms();
+    auto temp = getPropertySnapshot()->setIdleTimerMs;
     if (temp.has_value()) {
         return *temp;
     }
@@ -256,7 +374,7 @@ int32_t set_idle_timer_ms(int32_t defaultValue) {
 }
 
 int32_t set_touch_timer_ms(int32_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::set_touch_timer_ms();
+    auto temp = getPropertySnapshot()->setTouchTimerMs;
     if (temp.has_value()) {
         return *temp;
     }
@@ -264,7 +382,7 @@ int32_t set_touch_timer_ms(int32_t defaultValue) {
 }
 
 int32_t set_display_power_timer_ms(int32_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::set_display_power_timer_ms();
+    auto temp = getPropertySnapshot()->setDisplayPowerTimerMs;
     if (temp.has_value()) {
         return *temp;
     }
@@ -272,16 +390,13 @@ int32_t set_display_power_timer_ms(int32_t defaultValue) {
 }
 
 bool use_content_detection_for_refresh_rate(bool defaultValue) {
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wdeprecated-declarations"
-    auto smart_90_deprecated = SurfaceFlingerProperties::use_smart_90_for_video();
-#pragma clang diagnostic pop
+    auto smart_90_deprecated = getPropertySnapshot()->useSmart90ForVideo;
     if (smart_90_deprecated.has_value()) {
         ALOGW("Using deprecated use_smart_90_for_video sysprop. Value: %d", *smart_90_deprecated);
         return *smart_90_deprecated;
     }
 
-    auto temp = SurfaceFlingerProperties::use_content_detection_for_refresh_rate();
+    auto temp = getPropertySnapshot()->useContentDetectionForRefreshRate;
     if (temp.has_value()) {
         return *temp;
     }
@@ -289,7 +404,7 @@ bool use_content_detection_for_refresh_rate(bool defaultValue) {
 }
 
 bool enable_protected_contents(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::enable_protected_contents();
+    auto temp = getPropertySnapshot()->enableProtectedContents;
     if (temp.has_value()) {
         return *temp;
     }
@@ -297,7 +412,7 @@ bool enable_protected_contents(bool defaultValue) {
 }
 
 bool support_kernel_idle_timer(bool defaultValue) {
-    auto temp = SurfaceFlingerProperties::support_kernel_idle_timer();
+    auto temp = getPropertySnapshot()->supportKernelIdleTimer;
     if (temp.has_value()) {
         return *temp;
     }
@@ -305,74 +420,35 @@ bool support_kernel_idle_timer(bool defaultValue) {
 }
 
 bool enable_sdr_dimming(bool defaultValue) {
-    return SurfaceFlingerProperties::enable_sdr_dimming().value_or(defaultValue);
+    return getPropertySnapshot()->enableSdrDimming.value_or(defaultValue);
 }
 
 int32_t display_update_imminent_timeout_ms(int32_t defaultValue) {
-    auto temp = SurfaceFlingerProperties::display_update_imminent_timeout_ms();
+    auto temp = getPropertySnapshot()->displayUpdateImminentTimeoutMs;
     if (temp.has_value()) {
         return *temp;
     }
     return defaultValue;
 }
 
-#define DISPLAY_PRIMARY_SIZE 3
-
-constexpr float kSrgbRedX = 0.4123f;
-constexpr float kSrgbRedY = 0.2126f;
-constexpr float kSrgbRedZ = 0.0193f;
-constexpr float kSrgbGreenX = 0.3576f;
-constexpr float kSrgbGreenY = 0.7152f;
-constexpr float kSrgbGreenZ = 0.1192f;
-constexpr float kSrgbBlueX = 0.1805f;
-constexpr float kSrgbBlueY = 0.0722f;
-constexpr float kSrgbBlueZ = 0.9506f;
-constexpr float kSrgbWhiteX = 0.9505f;
-constexpr float kSrgbWhiteY = 1.0000f;
-constexpr float kSrgbWhiteZ = 1.0891f;
-
 DisplayPrimaries getDisplayNativePrimaries() {
-    auto mDisplay_primary_red = SurfaceFlingerProperties::display_primary_red();
-    auto mDisplay_primary_green = SurfaceFlingerProperties::display_primary_green();
-    auto mDisplay_primary_blue = SurfaceFlingerProperties::display_primary_blue();
-    auto mDisplay_primary_white = SurfaceFlingerProperties::display_primary_white();
-    // To avoid null point exception.
-    mDisplay_primary_red.resize(DISPLAY_PRIMARY_SIZE);
-    mDisplay_primary_green.resize(DISPLAY_PRIMARY_SIZE);
-    mDisplay_primary_blue.resize(DISPLAY_PRIMARY_SIZE);
-    mDisplay_primary_white.resize(DISPLAY_PRIMARY_SIZE);
-    DisplayPrimaries primaries =
-            {{static_cast<float>(mDisplay_primary_red[0].value_or(kSrgbRedX)),
-              static_cast<float>(mDisplay_primary_red[1].value_or(kSrgbRedY)),
-              static_cast<float>(mDisplay_primary_red[2].value_or(kSrgbRedZ))},
-             {static_cast<float>(mDisplay_primary_green[0].value_or(kSrgbGreenX)),
-              static_cast<float>(mDisplay_primary_green[1].value_or(kSrgbGreenY)),
-              static_cast<float>(mDisplay_primary_green[2].value_or(kSrgbGreenZ))},
-             {static_cast<float>(mDisplay_primary_blue[0].value_or(kSrgbBlueX)),
-              static_cast<float>(mDisplay_primary_blue[1].value_or(kSrgbBlueY)),
-              static_cast<float>(mDisplay_primary_blue[2].value_or(kSrgbBlueZ))},
-             {static_cast<float>(mDisplay_primary_white[0].value_or(kSrgbWhiteX)),
-              static_cast<float>(mDisplay_primary_white[1].value_or(kSrgbWhiteY)),
-              static_cast<float>(mDisplay_primary_white[2].value_or(kSrgbWhiteZ))}};
-
-    return primaries;
+    return getPropertySnapshot()->displayNativePrimaries;
 }
 
 bool update_device_product_info_on_hotplug_reconnect(bool defaultValue) {
-    return SurfaceFlingerProperties::update_device_product_info_on_hotplug_reconnect().value_or(
-            defaultValue);
+    return getPropertySnapshot()->updateDeviceProductInfoOnHotplugReconnect.value_or(defaultValue);
 }
 
 bool enable_frame_rate_override(bool defaultValue) {
-    return SurfaceFlingerProperties::enable_frame_rate_override().value_or(defaultValue);
+    return getPropertySnapshot()->enableFrameRateOverride.value_or(defaultValue);
 }
 
 bool enable_layer_caching(bool defaultValue) {
-    return SurfaceFlingerProperties::enable_layer_caching().value_or(defaultValue);
+    return getPropertySnapshot()->enableLayerCaching.value_or(defaultValue);
 }
 
 bool ignore_hdr_camera_layers(bool defaultValue) {
-    return SurfaceFlingerProperties::ignore_hdr_camera_layers().value_or(defaultValue);
+    return getPropertySnapshot()->ignoreHdrCameraLayers.value_or(defaultValue);
 }
 
 } // namespace sysprop
@@ -23,12 +23,65 @@
 #include <ui/ConfigStoreTypes.h>
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <vector>
 
 namespace android {
 namespace sysprop {
 
+// Immutable snapshot of all SurfaceFlinger sysprops, parsed in one pass. The helpers below
+// used to re-query (and for some properties re-parse) the sysprop on every call, which showed
+// up in traces when they are consulted after init, e.g. during mode switches. They now serve
+// the sysprop values from this snapshot and only fall back to a configstore query when a
+// property is unset. The fields hold the raw optional values so each helper keeps its
+// defaultValue semantics.
+struct PropertySnapshot {
+    std::optional<int64_t> vsyncEventPhaseOffsetNs;
+    std::optional<int64_t> vsyncSfEventPhaseOffsetNs;
+    std::optional<bool> useContextPriority;
+    std::optional<int64_t> maxFrameBufferAcquiredBuffers;
+    std::optional<int32_t> maxGraphicsWidth;
+    std::optional<int32_t> maxGraphicsHeight;
+    std::optional<bool> hasWideColorDisplay;
+    std::optional<bool> runningWithoutSyncFramework;
+    std::optional<bool> hasHdrDisplay;
+    std::optional<int64_t> presentTimeOffsetFromVsyncNs;
+    std::optional<bool> forceHwcCopyForVirtualDisplays;
+    std::optional<int64_t> maxVirtualDisplayDimension;
+    std::optional<bool> useVrFlinger;
+    std::optional<bool> startGraphicsAllocatorService;
+    std::optional<SurfaceFlingerProperties::primary_display_orientation_values>
+            primaryDisplayOrientation;
+    std::optional<int64_t> defaultCompositionDataspace;
+    std::optional<int32_t> defaultCompositionPixelFormat;
+    std::optional<int64_t> wcgCompositionDataspace;
+    std::optional<int32_t> wcgCompositionPixelFormat;
+    std::optional<int64_t> colorSpaceAgnosticDataspace;
+    std::optional<bool> refreshRateSwitching;
+    std::optional<int32_t> setIdleTimerMs;
+    std::optional<int32_t> setTouchTimerMs;
+    std::optional<int32_t> setDisplayPowerTimerMs;
+    std::optional<bool> useSmart90ForVideo;
+    std::optional<bool> useContentDetectionForRefreshRate;
+    std::optional<bool> enableProtectedContents;
+    std::optional<bool> supportKernelIdleTimer;
+    std::optional<int32_t> displayUpdateImminentTimeoutMs;
+    android::ui::DisplayPrimaries displayNativePrimaries;
+    std::optional<bool> updateDeviceProductInfoOnHotplugReconnect;
+    std::optional<bool> enableFrameRateOverride;
+    std::optional<bool> enableLayerCaching;
+    std::optional<bool> enableSdrDimming;
+    std::optional<bool> ignoreHdrCameraLayers;
+};
+
+// Returns the process-wide snapshot, parsing all properties on first use.
+std::shared_ptr<const PropertySnapshot> getPropertySnapshot();
+
+// Re-parses the properties and atomically republishes the snapshot. The sysprops are
+// read-only in practice, so this is only needed from controlled points such as tests.
+void refreshPropertySnapshot();
+
 int64_t vsync_event_phase_offset_ns(int64_t defaultValue);
 
 int64_t vsync_sf_event_phase_offset_ns(int64_t defaultValue);
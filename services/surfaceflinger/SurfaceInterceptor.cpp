@@ -40,6 +40,87 @@ SurfaceInterceptor::~SurfaceInterceptor() = default;
 
 namespace impl {
 
+SurfaceInterceptor::~SurfaceInterceptor() {
+    {
+        std::scoped_lock lock(mPendingMutex);
+        mDone = true;
+    }
+    mPendingCondition.notify_all();
+    if (mDrainThread.joinable()) {
+        mDrainThread.join();
+    }
+}
+
+void SurfaceInterceptor::queueIncrement(PendingIncrement&& increment) {
+    {
+        std::scoped_lock lock(mPendingMutex);
+        if (mPendingIncrements.size() >= kMaxPendingIncrements) {
+            ALOGW("dropping interception increment, drain thread is %zu increments behind",
+                  mPendingIncrements.size());
+            return;
+        }
+        mPendingIncrements.push_back(std::move(increment));
+    }
+    mPendingCondition.notify_one();
+}
+
+void SurfaceInterceptor::drainPendingIncrements() {
+    std::unique_lock lock(mPendingMutex);
+    mDrainedCondition.wait(lock, [this]() REQUIRES(mPendingMutex) {
+        return mPendingIncrements.empty() && !mConverting;
+    });
+}
+
+void SurfaceInterceptor::drainThreadLoop() {
+    std::unique_lock lock(mPendingMutex);
+    while (!mDone) {
+        mPendingCondition.wait(lock, [this]() REQUIRES(mPendingMutex) {
+            return mDone || !mPendingIncrements.empty();
+        });
+        while (!mPendingIncrements.empty()) {
+            std::vector<PendingIncrement> pending = std::move(mPendingIncrements);
+            mPendingIncrements.clear();
+            mConverting = true;
+            lock.unlock();
+            {
+                ATRACE_NAME("converting interception increments");
+                std::scoped_lock protoGuard(mTraceMutex);
+                for (const PendingIncrement& increment : pending) {
+                    convertIncrementLocked(increment);
+                }
+            }
+            lock.lock();
+            mConverting = false;
+        }
+        mDrainedCondition.notify_all();
+    }
+}
+
+void SurfaceInterceptor::convertIncrementLocked(const PendingIncrement& pending) {
+    Increment* increment(createTraceIncrementLocked(pending.timeStamp));
+    std::visit([&](const auto& capture) {
+        using T = std::decay_t<decltype(capture)>;
+        if constexpr (std::is_same_v<T, TransactionCapture>) {
+            addTransactionLocked(increment, capture);
+        } else if constexpr (std::is_same_v<T, SurfaceCreationCapture>) {
+            addSurfaceCreationLocked(increment, capture);
+        } else if constexpr (std::is_same_v<T, SurfaceDeletionCapture>) {
+            addSurfaceDeletionLocked(increment, capture.layerId);
+        } else if constexpr (std::is_same_v<T, BufferUpdateCapture>) {
+            addBufferUpdateLocked(increment, capture.layerId, capture.w, capture.h,
+                                  capture.frameNumber);
+        } else if constexpr (std::is_same_v<T, VSyncCapture>) {
+            addVSyncUpdateLocked(increment, capture.timestamp);
+        } else if constexpr (std::is_same_v<T, DisplayCreationCapture>) {
+            addDisplayCreationLocked(increment, capture.info);
+        } else if constexpr (std::is_same_v<T, DisplayDeletionCapture>) {
+            addDisplayDeletionLocked(increment, capture.sequenceId);
+        } else if constexpr (std::is_same_v<T, PowerModeCapture>) {
+            addPowerModeUpdateLocked(increment, capture.sequenceId, capture.mode);
+        }
+    }, pending.capture);
+}
+
 void SurfaceInterceptor::addTransactionTraceListener(
         const sp<gui::ITransactionTraceListener>& listener) {
     sp<IBinder> asBinder = IInterface::asBinder(listener);
@@ -71,6 +152,9 @@ void SurfaceInterceptor::enable(const SortedVector<sp<Layer>>& layers,
             listener->onToggled(true);
         }
     }
+    if (!mDrainThread.joinable()) {
+        mDrainThread = std::thread(&SurfaceInterceptor::drainThreadLoop, this);
+    }
     mEnabled = true;
     std::scoped_lock<std::mutex> protoGuard(mTraceMutex);
     saveExistingDisplaysLocked(displays);
@@ -89,6 +173,9 @@ void SurfaceInterceptor::disable() {
         }
     }
     mEnabled = false;
+    // Let the drain thread finish converting everything captured while enabled before
+    // serializing the trace.
+    drainPendingIncrements();
     std::scoped_lock<std::mutex> protoGuard(mTraceMutex);
     status_t err(writeProtoFileLocked());
     ALOGE_IF(err == PERMISSION_DENIED, "Could not save the proto file! Permission denied");
@@ -115,7 +202,10 @@ void SurfaceInterceptor::saveExistingSurfacesLocked(const SortedVector<sp<Layer>
     ATRACE_CALL();
     for (const auto& l : layers) {
         l->traverseInZOrder(LayerVector::StateSet::Drawing, [this](Layer* layer) {
-            addSurfaceCreationLocked(createTraceIncrementLocked(), layer);
+            addSurfaceCreationLocked(createTraceIncrementLocked(),
+                                     SurfaceCreationCapture{getLayerId(layer), layer->getName(),
+                                                            layer->mDrawingState.active_legacy.w,
+                                                            layer->mDrawingState.active_legacy.h});
             addInitialSurfaceStateLocked(createTraceIncrementLocked(), layer);
         });
     }
@@ -210,8 +300,12 @@ int32_t SurfaceInterceptor::getLayerIdFromHandle(const sp<IBinder>& handle) cons
 }
 
 Increment* SurfaceInterceptor::createTraceIncrementLocked() {
+    return createTraceIncrementLocked(elapsedRealtimeNano());
+}
+
+Increment* SurfaceInterceptor::createTraceIncrementLocked(nsecs_t timeStamp) {
     Increment* increment(mTrace.add_increment());
-    increment->set_time_stamp(elapsedRealtimeNano());
+    increment->set_time_stamp(timeStamp);
     return increment;
 }
 
@@ -493,43 +587,37 @@ void SurfaceInterceptor::addDisplayChangesLocked(Transaction* transaction,
     }
 }
 
-void SurfaceInterceptor::addTransactionLocked(
-        Increment* increment, const Vector<ComposerState>& stateUpdates,
-        const DefaultKeyedVector<wp<IBinder>, DisplayDeviceState>& displays,
-        const Vector<DisplayState>& changedDisplays, uint32_t transactionFlags, int originPid,
-        int originUid, uint64_t transactionId) {
+void SurfaceInterceptor::addTransactionLocked(Increment* increment,
+                                              const TransactionCapture& capture) {
     Transaction* transaction(increment->mutable_transaction());
-    transaction->set_synchronous(transactionFlags & BnSurfaceComposer::eSynchronous);
-    transaction->set_animation(transactionFlags & BnSurfaceComposer::eAnimation);
-    setTransactionOriginLocked(transaction, originPid, originUid);
-    transaction->set_id(transactionId);
-    for (const auto& compState: stateUpdates) {
+    transaction->set_synchronous(capture.flags & BnSurfaceComposer::eSynchronous);
+    transaction->set_animation(capture.flags & BnSurfaceComposer::eAnimation);
+    setTransactionOriginLocked(transaction, capture.originPid, capture.originUid);
+    transaction->set_id(capture.transactionId);
+    for (const auto& compState: capture.stateUpdates) {
         addSurfaceChangesLocked(transaction, compState.state);
     }
-    for (const auto& disp: changedDisplays) {
-        ssize_t dpyIdx = displays.indexOfKey(disp.token);
-        if (dpyIdx >= 0) {
-            const DisplayDeviceState& dispState(displays.valueAt(dpyIdx));
-            addDisplayChangesLocked(transaction, disp, dispState.sequenceId);
+    for (size_t i = 0; i < capture.changedDisplays.size(); i++) {
+        if (capture.displaySequenceIds[i] >= 0) {
+            addDisplayChangesLocked(transaction, capture.changedDisplays[i],
+                                    capture.displaySequenceIds[i]);
         }
     }
 }
 
 void SurfaceInterceptor::addSurfaceCreationLocked(Increment* increment,
-        const sp<const Layer>& layer)
+        const SurfaceCreationCapture& capture)
 {
     SurfaceCreation* creation(increment->mutable_surface_creation());
-    creation->set_id(getLayerId(layer));
-    creation->set_name(layer->getName());
-    creation->set_w(layer->mDrawingState.active_legacy.w);
-    creation->set_h(layer->mDrawingState.active_legacy.h);
+    creation->set_id(capture.layerId);
+    creation->set_name(capture.name);
+    creation->set_w(capture.w);
+    creation->set_h(capture.h);
 }
 
-void SurfaceInterceptor::addSurfaceDeletionLocked(Increment* increment,
-        const sp<const Layer>& layer)
-{
+void SurfaceInterceptor::addSurfaceDeletionLocked(Increment* increment, int32_t layerId) {
     SurfaceDeletion* deletion(increment->mutable_surface_deletion());
-    deletion->set_id(getLayerId(layer));
+    deletion->set_id(layerId);
 }
 
 void SurfaceInterceptor::addBufferUpdateLocked(Increment* increment, int32_t layerId,
@@ -636,9 +724,22 @@ void SurfaceInterceptor::saveTransaction(
         return;
     }
     ATRACE_CALL();
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addTransactionLocked(createTraceIncrementLocked(), stateUpdates, displays, changedDisplays,
-                         flags, originPid, originUid, transactionId);
+    // The state vectors are copy-on-write, so this only snapshots references. Display
+    // sequence ids are resolved now since the display map is owned by the caller.
+    TransactionCapture capture;
+    capture.stateUpdates = stateUpdates;
+    capture.changedDisplays = changedDisplays;
+    capture.flags = flags;
+    capture.originPid = originPid;
+    capture.originUid = originUid;
+    capture.transactionId = transactionId;
+    capture.displaySequenceIds.reserve(changedDisplays.size());
+    for (const auto& disp : changedDisplays) {
+        const ssize_t dpyIdx = displays.indexOfKey(disp.token);
+        capture.displaySequenceIds.push_back(
+                dpyIdx >= 0 ? displays.valueAt(dpyIdx).sequenceId : -1);
+    }
+    queueIncrement({elapsedRealtimeNano(), std::move(capture)});
 }
 
 void SurfaceInterceptor::saveSurfaceCreation(const sp<const Layer>& layer) {
@@ -646,8 +747,10 @@ void SurfaceInterceptor::saveSurfaceCreation(const sp<const Layer>& layer) {
         return;
     }
     ATRACE_CALL();
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addSurfaceCreationLocked(createTraceIncrementLocked(), layer);
+    queueIncrement({elapsedRealtimeNano(),
+                    SurfaceCreationCapture{getLayerId(layer), layer->getName(),
+                                           layer->mDrawingState.active_legacy.w,
+                                           layer->mDrawingState.active_legacy.h}});
 }
 
 void SurfaceInterceptor::saveSurfaceDeletion(const sp<const Layer>& layer) {
@@ -655,8 +758,7 @@ void SurfaceInterceptor::saveSurfaceDeletion(const sp<const Layer>& layer) {
         return;
     }
     ATRACE_CALL();
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addSurfaceDeletionLocked(createTraceIncrementLocked(), layer);
+    queueIncrement({elapsedRealtimeNano(), SurfaceDeletionCapture{getLayerId(layer)}});
 }
 
 /**
@@ -673,16 +775,15 @@ void SurfaceInterceptor::saveBufferUpdate(int32_t layerId, uint32_t width,
         return;
     }
     ATRACE_CALL();
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addBufferUpdateLocked(createTraceIncrementLocked(), layerId, width, height, frameNumber);
+    queueIncrement({elapsedRealtimeNano(), BufferUpdateCapture{layerId, width, height,
+                                                               frameNumber}});
 }
 
 void SurfaceInterceptor::saveVSyncEvent(nsecs_t timestamp) {
     if (!mEnabled) {
         return;
     }
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addVSyncUpdateLocked(createTraceIncrementLocked(), timestamp);
+    queueIncrement({elapsedRealtimeNano(), VSyncCapture{timestamp}});
 }
 
 void SurfaceInterceptor::saveDisplayCreation(const DisplayDeviceState& info) {
@@ -690,8 +791,7 @@ void SurfaceInterceptor::saveDisplayCreation(const DisplayDeviceState& info) {
         return;
     }
     ATRACE_CALL();
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addDisplayCreationLocked(createTraceIncrementLocked(), info);
+    queueIncrement({elapsedRealtimeNano(), DisplayCreationCapture{info}});
 }
 
 void SurfaceInterceptor::saveDisplayDeletion(int32_t sequenceId) {
@@ -699,8 +799,7 @@ void SurfaceInterceptor::saveDisplayDeletion(int32_t sequenceId) {
         return;
     }
     ATRACE_CALL();
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addDisplayDeletionLocked(createTraceIncrementLocked(), sequenceId);
+    queueIncrement({elapsedRealtimeNano(), DisplayDeletionCapture{sequenceId}});
 }
 
 void SurfaceInterceptor::savePowerModeUpdate(int32_t sequenceId, int32_t mode) {
@@ -708,8 +807,7 @@ void SurfaceInterceptor::savePowerModeUpdate(int32_t sequenceId, int32_t mode) {
         return;
     }
     ATRACE_CALL();
-    std::lock_guard<std::mutex> protoGuard(mTraceMutex);
-    addPowerModeUpdateLocked(createTraceIncrementLocked(), sequenceId, mode);
+    queueIncrement({elapsedRealtimeNano(), PowerModeCapture{sequenceId, mode}});
 }
 
 } // namespace impl
@@ -19,7 +19,11 @@
 
 #include <frameworks/native/cmds/surfacereplayer/proto/src/trace.pb.h>
 
+#include <condition_variable>
 #include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
 
 #include <binder/IBinder.h>
 
@@ -89,11 +93,16 @@ namespace impl {
 /*
  * SurfaceInterceptor intercepts and stores incoming streams of window
  * properties on SurfaceFlinger.
+ *
+ * The save* entry points only snapshot the intercepted values into a bounded pending queue
+ * (transaction state vectors are copy-on-write, so the copies are cheap) and a drain thread
+ * performs the protobuf conversion, keeping interception armed without adding frame cost on
+ * the caller's thread.
  */
 class SurfaceInterceptor final : public android::SurfaceInterceptor {
 public:
     SurfaceInterceptor() = default;
-    ~SurfaceInterceptor() override = default;
+    ~SurfaceInterceptor() override;
 
     // Both vectors are used to capture the current state of SF as the initial snapshot in the trace
     void enable(const SortedVector<sp<Layer>>& layers,
@@ -123,6 +132,64 @@ public:
     void saveVSyncEvent(nsecs_t timestamp) override;
 
 private:
+    // Plain snapshots of the intercepted values, captured on the caller's thread and converted
+    // to protobuf increments by the drain thread.
+    struct TransactionCapture {
+        Vector<ComposerState> stateUpdates;
+        Vector<DisplayState> changedDisplays;
+        // Display sequence ids resolved at capture time, index-aligned with changedDisplays
+        // (-1 when the display token was unknown).
+        std::vector<int32_t> displaySequenceIds;
+        uint32_t flags;
+        int originPid;
+        int originUid;
+        uint64_t transactionId;
+    };
+    struct SurfaceCreationCapture {
+        int32_t layerId;
+        std::string name;
+        uint32_t w;
+        uint32_t h;
+    };
+    struct SurfaceDeletionCapture {
+        int32_t layerId;
+    };
+    struct BufferUpdateCapture {
+        int32_t layerId;
+        uint32_t w;
+        uint32_t h;
+        uint64_t frameNumber;
+    };
+    struct VSyncCapture {
+        nsecs_t timestamp;
+    };
+    struct DisplayCreationCapture {
+        DisplayDeviceState info;
+    };
+    struct DisplayDeletionCapture {
+        int32_t sequenceId;
+    };
+    struct PowerModeCapture {
+        int32_t sequenceId;
+        int32_t mode;
+    };
+
+    struct PendingIncrement {
+        nsecs_t timeStamp;
+        std::variant<TransactionCapture, SurfaceCreationCapture, SurfaceDeletionCapture,
+                     BufferUpdateCapture, VSyncCapture, DisplayCreationCapture,
+                     DisplayDeletionCapture, PowerModeCapture>
+                capture;
+    };
+
+    // Appends a capture to the pending queue and wakes the drain thread. Drops the capture
+    // with a warning if the queue is full, rather than blocking the caller.
+    void queueIncrement(PendingIncrement&& increment);
+    // Blocks until the drain thread has converted everything queued so far.
+    void drainPendingIncrements();
+    void drainThreadLoop();
+    void convertIncrementLocked(const PendingIncrement& pending);
+
     // The creation increments of Surfaces and Displays do not contain enough information to capture
     // the initial state of each object, so a transaction with all of the missing properties is
     // performed at the initial snapshot for each display and surface.
@@ -139,8 +206,9 @@ private:
     int32_t getLayerIdFromHandle(const sp<IBinder>& weakHandle) const;
 
     Increment* createTraceIncrementLocked();
-    void addSurfaceCreationLocked(Increment* increment, const sp<const Layer>& layer);
-    void addSurfaceDeletionLocked(Increment* increment, const sp<const Layer>& layer);
+    Increment* createTraceIncrementLocked(nsecs_t timeStamp);
+    void addSurfaceCreationLocked(Increment* increment, const SurfaceCreationCapture& capture);
+    void addSurfaceDeletionLocked(Increment* increment, int32_t layerId);
     void addBufferUpdateLocked(Increment* increment, int32_t layerId, uint32_t width,
             uint32_t height, uint64_t frameNumber);
     void addVSyncUpdateLocked(Increment* increment, nsecs_t timestamp);
@@ -168,11 +236,7 @@ private:
     void addBlurRegionsLocked(Transaction* transaction, int32_t layerId,
                               const std::vector<BlurRegion>& effectRegions);
     void addSurfaceChangesLocked(Transaction* transaction, const layer_state_t& state);
-    void addTransactionLocked(Increment* increment, const Vector<ComposerState>& stateUpdates,
-                              const DefaultKeyedVector<wp<IBinder>, DisplayDeviceState>& displays,
-                              const Vector<DisplayState>& changedDisplays,
-                              uint32_t transactionFlags, int originPid, int originUid,
-                              uint64_t transactionId);
+    void addTransactionLocked(Increment* increment, const TransactionCapture& capture);
     void addReparentLocked(Transaction* transaction, int32_t layerId, int32_t parentId);
     void addRelativeParentLocked(Transaction* transaction, int32_t layerId, int32_t parentId,
                                  int z);
@@ -199,6 +263,20 @@ private:
     std::string mOutputFileName {DEFAULT_FILENAME};
     std::mutex mTraceMutex {};
     Trace mTrace {};
+
+    // Bound on the pending queue so a stalled drain thread cannot grow it without limit;
+    // captures beyond it are dropped with a warning.
+    static constexpr size_t kMaxPendingIncrements = 4096;
+
+    std::mutex mPendingMutex;
+    std::condition_variable mPendingCondition;
+    std::condition_variable mDrainedCondition;
+    std::vector<PendingIncrement> mPendingIncrements GUARDED_BY(mPendingMutex);
+    bool mConverting GUARDED_BY(mPendingMutex) {false};
+    bool mDone GUARDED_BY(mPendingMutex) {false};
+    // Started lazily on the first enable(), joined in the destructor.
+    std::thread mDrainThread;
+
     std::mutex mListenersMutex;
     std::map<wp<IBinder>, sp<gui::ITransactionTraceListener>> mTraceToggledListeners
             GUARDED_BY(mListenersMutex);
@@ -140,6 +140,10 @@ bool TimeStats::populateGlobalAtom(std::string* pulledData) {
 }
 
 bool TimeStats::populateLayerAtom(std::string* pulledData) {
+    // Pending per-layer records are dropped outside of mMutex, since
+    // clearLayerRecords takes the shard locks.
+    clearLayerRecords();
+
     std::lock_guard<std::mutex> lock(mMutex);
 
     std::vector<TimeStatsHelper::TimeStatsLayer*> dumpStats;
@@ -297,7 +301,7 @@ std::string TimeStats::miniDump() {
     std::string result = "TimeStats miniDump:\n";
     std::lock_guard<std::mutex> lock(mMutex);
     android::base::StringAppendF(&result, "Number of layers currently being tracked is %zu\n",
-                                 mTimeStatsTracker.size());
+                                 mTrackedLayers.load());
     android::base::StringAppendF(&result, "Number of layers in the stats pool is %zu\n",
                                  mTimeStats.stats.size());
     return result;
@@ -439,97 +443,113 @@ static int32_t clampToNearestBucket(Fps fps, size_t bucketWidth) {
     return std::round(fps.getValue() / bucketWidth) * bucketWidth;
 }
 
-void TimeStats::flushAvailableRecordsToStatsLocked(int32_t layerId, Fps displayRefreshRate,
-                                                   std::optional<Fps> renderRate,
-                                                   SetFrameRateVote frameRateVote,
-                                                   GameMode gameMode) {
+TimeStats::PendingStats TimeStats::popAvailableRecordsLocked(int32_t layerId,
+                                                             LayerRecord& layerRecord) {
     ATRACE_CALL();
-    ALOGV("[%d]-flushAvailableRecordsToStatsLocked", layerId);
+    ALOGV("[%d]-popAvailableRecordsLocked", layerId);
 
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    PendingStats pending;
     TimeRecord& prevTimeRecord = layerRecord.prevTimeRecord;
     std::deque<TimeRecord>& timeRecords = layerRecord.timeRecords;
-    const int32_t refreshRateBucket =
-            clampToNearestBucket(displayRefreshRate, REFRESH_RATE_BUCKET_WIDTH);
-    const int32_t renderRateBucket =
-            clampToNearestBucket(renderRate ? *renderRate : displayRefreshRate,
-                                 RENDER_RATE_BUCKET_WIDTH);
     while (!timeRecords.empty()) {
         if (!recordReadyLocked(layerId, &timeRecords[0])) break;
         ALOGV("[%d]-[%" PRIu64 "]-presentFenceTime[%" PRId64 "]", layerId,
               timeRecords[0].frameTime.frameNumber, timeRecords[0].frameTime.presentTime);
 
         if (prevTimeRecord.ready) {
-            uid_t uid = layerRecord.uid;
-            const std::string& layerName = layerRecord.layerName;
-            TimeStatsHelper::TimelineStatsKey timelineKey = {refreshRateBucket, renderRateBucket};
-            if (!mTimeStats.stats.count(timelineKey)) {
-                mTimeStats.stats[timelineKey].key = timelineKey;
-            }
-
-            TimeStatsHelper::TimelineStats& displayStats = mTimeStats.stats[timelineKey];
-
-            TimeStatsHelper::LayerStatsKey layerKey = {uid, layerName, gameMode};
-            if (!displayStats.stats.count(layerKey)) {
-                displayStats.stats[layerKey].displayRefreshRateBucket = refreshRateBucket;
-                displayStats.stats[layerKey].renderRateBucket = renderRateBucket;
-                displayStats.stats[layerKey].uid = uid;
-                displayStats.stats[layerKey].layerName = layerName;
-                displayStats.stats[layerKey].gameMode = gameMode;
-            }
-            if (frameRateVote.frameRate > 0.0f) {
-                displayStats.stats[layerKey].setFrameRateVote = frameRateVote;
-            }
-            TimeStatsHelper::TimeStatsLayer& timeStatsLayer = displayStats.stats[layerKey];
-            timeStatsLayer.totalFrames++;
-            timeStatsLayer.droppedFrames += layerRecord.droppedFrames;
-            timeStatsLayer.lateAcquireFrames += layerRecord.lateAcquireFrames;
-            timeStatsLayer.badDesiredPresentFrames += layerRecord.badDesiredPresentFrames;
-
-            layerRecord.droppedFrames = 0;
-            layerRecord.lateAcquireFrames = 0;
-            layerRecord.badDesiredPresentFrames = 0;
-
-            const int32_t postToAcquireMs = msBetween(timeRecords[0].frameTime.postTime,
-                                                      timeRecords[0].frameTime.acquireTime);
+            FrameDeltas deltas;
+            deltas.postToAcquireMs = msBetween(timeRecords[0].frameTime.postTime,
+                                               timeRecords[0].frameTime.acquireTime);
             ALOGV("[%d]-[%" PRIu64 "]-post2acquire[%d]", layerId,
-                  timeRecords[0].frameTime.frameNumber, postToAcquireMs);
-            timeStatsLayer.deltas["post2acquire"].insert(postToAcquireMs);
+                  timeRecords[0].frameTime.frameNumber, deltas.postToAcquireMs);
 
-            const int32_t postToPresentMs = msBetween(timeRecords[0].frameTime.postTime,
-                                                      timeRecords[0].frameTime.presentTime);
+            deltas.postToPresentMs = msBetween(timeRecords[0].frameTime.postTime,
+                                               timeRecords[0].frameTime.presentTime);
             ALOGV("[%d]-[%" PRIu64 "]-post2present[%d]", layerId,
-                  timeRecords[0].frameTime.frameNumber, postToPresentMs);
-            timeStatsLayer.deltas["post2present"].insert(postToPresentMs);
+                  timeRecords[0].frameTime.frameNumber, deltas.postToPresentMs);
 
-            const int32_t acquireToPresentMs = msBetween(timeRecords[0].frameTime.acquireTime,
-                                                         timeRecords[0].frameTime.presentTime);
+            deltas.acquireToPresentMs = msBetween(timeRecords[0].frameTime.acquireTime,
+                                                  timeRecords[0].frameTime.presentTime);
             ALOGV("[%d]-[%" PRIu64 "]-acquire2present[%d]", layerId,
-                  timeRecords[0].frameTime.frameNumber, acquireToPresentMs);
-            timeStatsLayer.deltas["acquire2present"].insert(acquireToPresentMs);
+                  timeRecords[0].frameTime.frameNumber, deltas.acquireToPresentMs);
 
-            const int32_t latchToPresentMs = msBetween(timeRecords[0].frameTime.latchTime,
-                                                       timeRecords[0].frameTime.presentTime);
+            deltas.latchToPresentMs = msBetween(timeRecords[0].frameTime.latchTime,
+                                                timeRecords[0].frameTime.presentTime);
             ALOGV("[%d]-[%" PRIu64 "]-latch2present[%d]", layerId,
-                  timeRecords[0].frameTime.frameNumber, latchToPresentMs);
-            timeStatsLayer.deltas["latch2present"].insert(latchToPresentMs);
+                  timeRecords[0].frameTime.frameNumber, deltas.latchToPresentMs);
 
-            const int32_t desiredToPresentMs = msBetween(timeRecords[0].frameTime.desiredTime,
-                                                         timeRecords[0].frameTime.presentTime);
+            deltas.desiredToPresentMs = msBetween(timeRecords[0].frameTime.desiredTime,
+                                                  timeRecords[0].frameTime.presentTime);
             ALOGV("[%d]-[%" PRIu64 "]-desired2present[%d]", layerId,
-                  timeRecords[0].frameTime.frameNumber, desiredToPresentMs);
-            timeStatsLayer.deltas["desired2present"].insert(desiredToPresentMs);
+                  timeRecords[0].frameTime.frameNumber, deltas.desiredToPresentMs);
 
-            const int32_t presentToPresentMs = msBetween(prevTimeRecord.frameTime.presentTime,
-                                                         timeRecords[0].frameTime.presentTime);
+            deltas.presentToPresentMs = msBetween(prevTimeRecord.frameTime.presentTime,
+                                                  timeRecords[0].frameTime.presentTime);
             ALOGV("[%d]-[%" PRIu64 "]-present2present[%d]", layerId,
-                  timeRecords[0].frameTime.frameNumber, presentToPresentMs);
-            timeStatsLayer.deltas["present2present"].insert(presentToPresentMs);
+                  timeRecords[0].frameTime.frameNumber, deltas.presentToPresentMs);
+
+            pending.deltas.push_back(deltas);
         }
         prevTimeRecord = timeRecords[0];
         timeRecords.pop_front();
         layerRecord.waitData--;
     }
+
+    if (!pending.deltas.empty()) {
+        pending.uid = layerRecord.uid;
+        pending.layerName = layerRecord.layerName;
+        pending.droppedFrames = layerRecord.droppedFrames;
+        pending.lateAcquireFrames = layerRecord.lateAcquireFrames;
+        pending.badDesiredPresentFrames = layerRecord.badDesiredPresentFrames;
+        layerRecord.droppedFrames = 0;
+        layerRecord.lateAcquireFrames = 0;
+        layerRecord.badDesiredPresentFrames = 0;
+    }
+    return pending;
+}
+
+void TimeStats::flushPendingStatsToStatsLocked(const PendingStats& pending, Fps displayRefreshRate,
+                                               std::optional<Fps> renderRate,
+                                               SetFrameRateVote frameRateVote, GameMode gameMode) {
+    ATRACE_CALL();
+
+    const int32_t refreshRateBucket =
+            clampToNearestBucket(displayRefreshRate, REFRESH_RATE_BUCKET_WIDTH);
+    const int32_t renderRateBucket =
+            clampToNearestBucket(renderRate ? *renderRate : displayRefreshRate,
+                                 RENDER_RATE_BUCKET_WIDTH);
+    TimeStatsHelper::TimelineStatsKey timelineKey = {refreshRateBucket, renderRateBucket};
+    if (!mTimeStats.stats.count(timelineKey)) {
+        mTimeStats.stats[timelineKey].key = timelineKey;
+    }
+
+    TimeStatsHelper::TimelineStats& displayStats = mTimeStats.stats[timelineKey];
+
+    TimeStatsHelper::LayerStatsKey layerKey = {pending.uid, pending.layerName, gameMode};
+    if (!displayStats.stats.count(layerKey)) {
+        displayStats.stats[layerKey].displayRefreshRateBucket = refreshRateBucket;
+        displayStats.stats[layerKey].renderRateBucket = renderRateBucket;
+        displayStats.stats[layerKey].uid = pending.uid;
+        displayStats.stats[layerKey].layerName = pending.layerName;
+        displayStats.stats[layerKey].gameMode = gameMode;
+    }
+    if (frameRateVote.frameRate > 0.0f) {
+        displayStats.stats[layerKey].setFrameRateVote = frameRateVote;
+    }
+    TimeStatsHelper::TimeStatsLayer& timeStatsLayer = displayStats.stats[layerKey];
+    timeStatsLayer.droppedFrames += pending.droppedFrames;
+    timeStatsLayer.lateAcquireFrames += pending.lateAcquireFrames;
+    timeStatsLayer.badDesiredPresentFrames += pending.badDesiredPresentFrames;
+
+    for (const FrameDeltas& deltas : pending.deltas) {
+        timeStatsLayer.totalFrames++;
+        timeStatsLayer.deltas["post2acquire"].insert(deltas.postToAcquireMs);
+        timeStatsLayer.deltas["post2present"].insert(deltas.postToPresentMs);
+        timeStatsLayer.deltas["acquire2present"].insert(deltas.acquireToPresentMs);
+        timeStatsLayer.deltas["latch2present"].insert(deltas.latchToPresentMs);
+        timeStatsLayer.deltas["desired2present"].insert(deltas.desiredToPresentMs);
+        timeStatsLayer.deltas["present2present"].insert(deltas.presentToPresentMs);
+    }
 }
 
 static constexpr const char* kPopupWindowPrefix = "PopupWindow";
@@ -563,22 +583,36 @@ void TimeStats::setPostTime(int32_t layerId, uint64_t frameNumber, const std::st
     ALOGV("[%d]-[%" PRIu64 "]-[%s]-PostTime[%" PRId64 "]", layerId, frameNumber, layerName.c_str(),
           postTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!canAddNewAggregatedStats(uid, layerName, gameMode)) {
-        return;
-    }
-    if (!mTimeStatsTracker.count(layerId) && mTimeStatsTracker.size() < MAX_NUM_LAYER_RECORDS &&
-        layerNameIsValid(layerName)) {
-        mTimeStatsTracker[layerId].uid = uid;
-        mTimeStatsTracker[layerId].layerName = layerName;
-        mTimeStatsTracker[layerId].gameMode = gameMode;
+    LayerShard& shard = shardForLayer(layerId);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) {
+        if (mTrackedLayers.load() >= MAX_NUM_LAYER_RECORDS || !layerNameIsValid(layerName)) {
+            return;
+        }
+        // The aggregated stats pool (and mMutex) is only consulted when a
+        // layer starts being tracked; per-frame updates for tracked layers
+        // stay on the shard lock.
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> statsLock(mMutex);
+            if (!canAddNewAggregatedStats(uid, layerName, gameMode)) {
+                return;
+            }
+        }
+        lock.lock();
+        if (!shard.tracker.count(layerId)) {
+            shard.tracker[layerId].uid = uid;
+            shard.tracker[layerId].layerName = layerName;
+            shard.tracker[layerId].gameMode = gameMode;
+            mTrackedLayers++;
+        }
     }
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerRecord& layerRecord = shard.tracker[layerId];
     if (layerRecord.timeRecords.size() == MAX_NUM_TIME_RECORDS) {
         ALOGE("[%d]-[%s]-timeRecords is at its maximum size[%zu]. Ignore this when unittesting.",
               layerId, layerRecord.layerName.c_str(), MAX_NUM_TIME_RECORDS);
-        mTimeStatsTracker.erase(layerId);
+        shard.tracker.erase(layerId);
+        mTrackedLayers--;
         return;
     }
     // For most media content, the acquireFence is invalid because the buffer is
@@ -606,9 +640,10 @@ void TimeStats::setLatchTime(int32_t layerId, uint64_t frameNumber, nsecs_t latc
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-LatchTime[%" PRId64 "]", layerId, frameNumber, latchTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -625,9 +660,10 @@ void TimeStats::incrementLatchSkipped(int32_t layerId, LatchSkipReason reason) {
     ALOGV("[%d]-LatchSkipped-Reason[%d]", layerId,
           static_cast<std::underlying_type<LatchSkipReason>::type>(reason));
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
 
     switch (reason) {
         case LatchSkipReason::LateAcquire:
@@ -642,9 +678,10 @@ void TimeStats::incrementBadDesiredPresent(int32_t layerId) {
     ATRACE_CALL();
     ALOGV("[%d]-BadDesiredPresent", layerId);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     layerRecord.badDesiredPresentFrames++;
 }
 
@@ -654,9 +691,10 @@ void TimeStats::setDesiredTime(int32_t layerId, uint64_t frameNumber, nsecs_t de
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-DesiredTime[%" PRId64 "]", layerId, frameNumber, desiredTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -672,9 +710,10 @@ void TimeStats::setAcquireTime(int32_t layerId, uint64_t frameNumber, nsecs_t ac
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-AcquireTime[%" PRId64 "]", layerId, frameNumber, acquireTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -692,9 +731,10 @@ void TimeStats::setAcquireFence(int32_t layerId, uint64_t frameNumber,
     ALOGV("[%d]-[%" PRIu64 "]-AcquireFenceTime[%" PRId64 "]", layerId, frameNumber,
           acquireFence->getSignalTime());
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -712,9 +752,10 @@ void TimeStats::setPresentTime(int32_t layerId, uint64_t frameNumber, nsecs_t pr
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-PresentTime[%" PRId64 "]", layerId, frameNumber, presentTime);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -725,8 +766,12 @@ void TimeStats::setPresentTime(int32_t layerId, uint64_t frameNumber, nsecs_t pr
         layerRecord.waitData++;
     }
 
-    flushAvailableRecordsToStatsLocked(layerId, displayRefreshRate, renderRate, frameRateVote,
-                                       gameMode);
+    const PendingStats pending = popAvailableRecordsLocked(layerId, layerRecord);
+    if (pending.deltas.empty()) return;
+
+    std::lock_guard<std::mutex> statsLock(mMutex);
+    flushPendingStatsToStatsLocked(pending, displayRefreshRate, renderRate, frameRateVote,
+                                   gameMode);
 }
 
 void TimeStats::setPresentFence(int32_t layerId, uint64_t frameNumber,
@@ -739,9 +784,10 @@ void TimeStats::setPresentFence(int32_t layerId, uint64_t frameNumber,
     ALOGV("[%d]-[%" PRIu64 "]-PresentFenceTime[%" PRId64 "]", layerId, frameNumber,
           presentFence->getSignalTime());
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     if (layerRecord.waitData < 0 ||
         layerRecord.waitData >= static_cast<int32_t>(layerRecord.timeRecords.size()))
         return;
@@ -752,8 +798,12 @@ void TimeStats::setPresentFence(int32_t layerId, uint64_t frameNumber,
         layerRecord.waitData++;
     }
 
-    flushAvailableRecordsToStatsLocked(layerId, displayRefreshRate, renderRate, frameRateVote,
-                                       gameMode);
+    const PendingStats pending = popAvailableRecordsLocked(layerId, layerRecord);
+    if (pending.deltas.empty()) return;
+
+    std::lock_guard<std::mutex> statsLock(mMutex);
+    flushPendingStatsToStatsLocked(pending, displayRefreshRate, renderRate, frameRateVote,
+                                   gameMode);
 }
 
 static const constexpr int32_t kValidJankyReason = JankType::DisplayHAL |
@@ -854,8 +904,11 @@ void TimeStats::incrementJankyFrames(const JankyFramesInfo& info) {
 void TimeStats::onDestroy(int32_t layerId) {
     ATRACE_CALL();
     ALOGV("[%d]-onDestroy", layerId);
-    std::lock_guard<std::mutex> lock(mMutex);
-    mTimeStatsTracker.erase(layerId);
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.tracker.erase(layerId) > 0) {
+        mTrackedLayers--;
+    }
 }
 
 void TimeStats::removeTimeRecord(int32_t layerId, uint64_t frameNumber) {
@@ -864,9 +917,10 @@ void TimeStats::removeTimeRecord(int32_t layerId, uint64_t frameNumber) {
     ATRACE_CALL();
     ALOGV("[%d]-[%" PRIu64 "]-removeTimeRecord", layerId, frameNumber);
 
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (!mTimeStatsTracker.count(layerId)) return;
-    LayerRecord& layerRecord = mTimeStatsTracker[layerId];
+    LayerShard& shard = shardForLayer(layerId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (!shard.tracker.count(layerId)) return;
+    LayerRecord& layerRecord = shard.tracker[layerId];
     size_t removeAt = 0;
     for (const TimeRecord& record : layerRecord.timeRecords) {
         if (record.frameTime.frameNumber == frameNumber) break;
@@ -1035,6 +1089,7 @@ void TimeStats::disable() {
 }
 
 void TimeStats::clearAll() {
+    clearLayerRecords();
     std::lock_guard<std::mutex> lock(mMutex);
     mTimeStats.stats.clear();
     clearGlobalLocked();
@@ -1072,14 +1127,23 @@ void TimeStats::clearGlobalLocked() {
 void TimeStats::clearLayersLocked() {
     ATRACE_CALL();
 
-    mTimeStatsTracker.clear();
-
     for (auto& globalRecord : mTimeStats.stats) {
         globalRecord.second.stats.clear();
     }
     ALOGD("Cleared layer stats");
 }
 
+void TimeStats::clearLayerRecords() {
+    ATRACE_CALL();
+
+    for (LayerShard& shard : mLayerShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.tracker.clear();
+    }
+    mTrackedLayers = 0;
+    ALOGD("Cleared layer records");
+}
+
 bool TimeStats::isEnabled() {
     return mEnabled.load();
 }
@@ -16,12 +16,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include <android/hardware/graphics/composer/2.4/IComposerClient.h>
 #include <gui/JankInfo.h>
@@ -220,6 +222,40 @@ class TimeStats : public android::TimeStats {
         std::deque<TimeRecord> timeRecords;
     };
 
+    // Time deltas for one frame whose fences have all signaled, computed
+    // under the owning shard's lock and aggregated into mTimeStats under
+    // mMutex afterwards.
+    struct FrameDeltas {
+        int32_t postToAcquireMs = 0;
+        int32_t postToPresentMs = 0;
+        int32_t acquireToPresentMs = 0;
+        int32_t latchToPresentMs = 0;
+        int32_t desiredToPresentMs = 0;
+        int32_t presentToPresentMs = 0;
+    };
+
+    // Data popped from a layer's shard once records are ready so that the
+    // aggregated stats can be updated without holding the shard lock.
+    struct PendingStats {
+        uid_t uid = 0;
+        std::string layerName;
+        uint32_t droppedFrames = 0;
+        uint32_t lateAcquireFrames = 0;
+        uint32_t badDesiredPresentFrames = 0;
+        std::vector<FrameDeltas> deltas;
+    };
+
+    // Layer records are sharded by layerId so that per-frame timestamp
+    // updates for different layers contend on separate locks instead of
+    // funneling through mMutex. mMutex still guards the aggregated stats and
+    // is only taken when ready records are flushed, when a layer starts being
+    // tracked, and at dump time.
+    struct LayerShard {
+        std::mutex mutex;
+        // Hashmap for LayerRecord with layerId as the hash key
+        std::unordered_map<int32_t, LayerRecord> tracker;
+    };
+
     struct PowerTime {
         PowerMode powerMode = PowerMode::OFF;
         nsecs_t prevTime = 0;
@@ -292,10 +328,15 @@ public:
 private:
     bool populateGlobalAtom(std::string* pulledData);
     bool populateLayerAtom(std::string* pulledData);
+    LayerShard& shardForLayer(int32_t layerId) {
+        return mLayerShards[static_cast<size_t>(layerId) % NUM_LAYER_SHARDS];
+    }
     bool recordReadyLocked(int32_t layerId, TimeRecord* timeRecord);
-    void flushAvailableRecordsToStatsLocked(int32_t layerId, Fps displayRefreshRate,
-                                            std::optional<Fps> renderRate, SetFrameRateVote,
-                                            GameMode);
+    // Pops every ready record off a layer and computes its frame deltas.
+    // Called with the layer's shard lock held.
+    PendingStats popAvailableRecordsLocked(int32_t layerId, LayerRecord& layerRecord);
+    void flushPendingStatsToStatsLocked(const PendingStats& pending, Fps displayRefreshRate,
+                                        std::optional<Fps> renderRate, SetFrameRateVote, GameMode);
     void flushPowerTimeLocked();
     void flushAvailableGlobalRecordsToStatsLocked();
     bool canAddNewAggregatedStats(uid_t uid, const std::string& layerName, GameMode);
@@ -305,13 +346,18 @@ private:
     void clearAll();
     void clearGlobalLocked();
     void clearLayersLocked();
+    // Clears the per-layer records in every shard. Takes the shard locks, so
+    // it must not be called with mMutex held.
+    void clearLayerRecords();
     void dump(bool asProto, std::optional<uint32_t> maxLayers, std::string& result);
 
     std::atomic<bool> mEnabled = false;
     std::mutex mMutex;
     TimeStatsHelper::TimeStatsGlobal mTimeStats;
-    // Hashmap for LayerRecord with layerId as the hash key
-    std::unordered_map<int32_t, LayerRecord> mTimeStatsTracker;
+    static constexpr size_t NUM_LAYER_SHARDS = 8;
+    LayerShard mLayerShards[NUM_LAYER_SHARDS];
+    // Number of layers currently tracked across all shards.
+    std::atomic<size_t> mTrackedLayers = 0;
     PowerTime mPowerTime;
     GlobalRecord mGlobalRecord;
 
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <functional>
@@ -23,6 +24,7 @@
 
 #include <cutils/compiler.h>
 #include <utils/Trace.h>
+#include <utils/misc.h>
 
 namespace std {
 template <class Rep, class Period>
@@ -33,6 +35,44 @@ bool signbit(std::chrono::duration<Rep, Period> v) {
 
 namespace android {
 
+#ifdef SF_TRACING_DISABLED
+
+// Compile-time opt-out for builds that must not pay any per-site cost: every
+// gated trace site folds to a constant and the compiler drops the tracing code.
+constexpr bool isTracingEnabled() {
+    return false;
+}
+
+#else
+
+namespace trace_detail {
+inline std::atomic<bool> gTraceEnabled(false);
+
+inline void updateTraceEnabled() {
+    atrace_update_tags();
+    gTraceEnabled.store(ATRACE_ENABLED(), std::memory_order_relaxed);
+}
+} // namespace trace_detail
+
+// Process-cached snapshot of ATRACE_ENABLED(). The macro funnels through
+// atrace_get_enabled_tags(), which pays an init guard and a 64-bit tag mask on
+// every call; hot paths that query tracing state thousands of times per second
+// read one relaxed atomic instead. The snapshot is refreshed by the sysprop
+// change notification (see report_sysprop_change()) that fires after `atrace`
+// flips debug.atrace.tags.enableflags, the same signal that refreshes the
+// atrace tags themselves.
+inline bool isTracingEnabled() {
+    static const bool sRegistered = [] {
+        trace_detail::gTraceEnabled.store(ATRACE_ENABLED(), std::memory_order_relaxed);
+        add_sysprop_change_callback(trace_detail::updateTraceEnabled, 0 /* priority */);
+        return true;
+    }();
+    (void)sRegistered;
+    return trace_detail::gTraceEnabled.load(std::memory_order_relaxed);
+}
+
+#endif // SF_TRACING_DISABLED
+
 namespace {
 template <typename T>
 int64_t to_int64(T v) {
@@ -73,10 +113,11 @@ public:
 
 private:
     void trace() {
-        if (CC_LIKELY(!ATRACE_ENABLED())) {
+        if (CC_LIKELY(!isTracingEnabled())) {
             return;
         }
 
+        // The negative counter name is only formatted once tracing is on.
         if (mNameNegative.empty()) {
             mNameNegative = mName + "Negative";
         }
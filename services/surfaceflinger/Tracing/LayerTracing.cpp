@@ -33,30 +33,85 @@ LayerTracing::LayerTracing(SurfaceFlinger& flinger) : mFlinger(flinger) {
     mBuffer = std::make_unique<RingBuffer<LayersTraceFileProto, LayersTraceProto>>();
 }
 
-LayerTracing::~LayerTracing() = default;
+LayerTracing::~LayerTracing() {
+    stopWorkerThread();
+}
 
-bool LayerTracing::enable() {
+bool LayerTracing::enable(bool continuous) {
     std::scoped_lock lock(mTraceLock);
     if (mEnabled) {
         return false;
     }
-    mBuffer->setSize(mBufferSizeInBytes);
+    mContinuous = continuous;
+    // Continuous mode is meant to stay on in the field, so it keeps a much smaller buffer
+    // and defers serialization to a dedicated thread.
+    mBuffer->setSize(continuous ? CONTINUOUS_TRACING_BUFFER_SIZE : mBufferSizeInBytes);
     mEnabled = true;
+    if (continuous) {
+        startWorkerThread();
+    }
     return true;
 }
 
 bool LayerTracing::disable(std::string filename) {
+    // Join the tracing thread first so any pending entries are drained into the buffer
+    // before it is written out. The thread takes mTraceLock to fill the buffer, so it
+    // cannot be stopped while the lock is held.
+    stopWorkerThread();
     std::scoped_lock lock(mTraceLock);
     if (!mEnabled) {
         return false;
     }
     mEnabled = false;
+    mContinuous = false;
     LayersTraceFileProto fileProto = createTraceFileProto();
     mBuffer->writeToFile(fileProto, filename);
     mBuffer->reset();
     return true;
 }
 
+void LayerTracing::startWorkerThread() {
+    std::scoped_lock lock(mThreadLock);
+    mDone = false;
+    mThread = std::thread(&LayerTracing::loop, this);
+}
+
+void LayerTracing::stopWorkerThread() {
+    std::thread thread;
+    {
+        std::scoped_lock lock(mThreadLock);
+        if (!mThread.joinable()) {
+            return;
+        }
+        mDone = true;
+        thread = std::move(mThread);
+    }
+    mEntriesAvailableCv.notify_one();
+    thread.join();
+}
+
+void LayerTracing::loop() {
+    bool done = false;
+    while (!done) {
+        {
+            std::unique_lock<std::mutex> lock(mThreadLock);
+            mEntriesAvailableCv.wait(lock, [&]() REQUIRES(mThreadLock) {
+                return mDone || mEntriesAvailable;
+            });
+            mEntriesAvailable = false;
+            done = mDone;
+        }
+
+        // Serialize pending snapshots and retire replaced entries off the main thread.
+        LayersTraceProto* entry;
+        while ((entry = mPendingEntries.pop()) != nullptr) {
+            std::unique_ptr<LayersTraceProto> scopedEntry(entry);
+            std::scoped_lock lock(mTraceLock);
+            mBuffer->emplace(std::move(*scopedEntry));
+        }
+    }
+}
+
 bool LayerTracing::isEnabled() const {
     std::scoped_lock lock(mTraceLock);
     return mEnabled;
@@ -129,7 +184,19 @@ void LayerTracing::notify(bool visibleRegionDirty, int64_t time) {
         entry.set_excludes_composition_state(true);
     }
     mFlinger.dumpDisplayProto(entry);
-    mBuffer->emplace(std::move(entry));
+
+    if (mContinuous) {
+        // Hand the snapshot to the tracing thread; serializing it and evicting old entries
+        // is not cheap enough for the main thread when tracing is always on.
+        mPendingEntries.push(new LayersTraceProto(std::move(entry)));
+        {
+            std::scoped_lock threadLock(mThreadLock);
+            mEntriesAvailable = true;
+        }
+        mEntriesAvailableCv.notify_one();
+    } else {
+        mBuffer->emplace(std::move(entry));
+    }
 }
 
 } // namespace android
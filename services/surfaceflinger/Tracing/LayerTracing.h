@@ -22,8 +22,12 @@
 #include <utils/StrongPointer.h>
 #include <utils/Timers.h>
 
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <thread>
+
+#include "LocklessStack.h"
 
 using namespace android::surfaceflinger;
 
@@ -37,12 +41,17 @@ class SurfaceFlinger;
 /*
  * LayerTracing records layer states during surface flinging. Manages tracing state and
  * configuration.
+ *
+ * In continuous mode the main thread only generates the snapshot proto and pushes it to a
+ * lockless stack; serialization and ring buffer eviction happen on a dedicated tracing
+ * thread so tracing can stay enabled in the field with a small buffer and the trace can be
+ * attached to bug reports.
  */
 class LayerTracing {
 public:
     LayerTracing(SurfaceFlinger& flinger);
     ~LayerTracing();
-    bool enable();
+    bool enable(bool continuous = false);
     bool disable(std::string filename = FILE_NAME);
     bool isEnabled() const;
     status_t writeToFile();
@@ -62,16 +71,32 @@ public:
     void setBufferSize(size_t bufferSizeInBytes);
     void dump(std::string&) const;
 
+    static constexpr auto CONTINUOUS_TRACING_BUFFER_SIZE = 512 * 1024;
+
 private:
     static constexpr auto FILE_NAME = "/data/misc/wmtrace/layers_trace.winscope";
 
+    void startWorkerThread() EXCLUDES(mThreadLock);
+    void stopWorkerThread() EXCLUDES(mThreadLock);
+    void loop();
+
     SurfaceFlinger& mFlinger;
     uint32_t mFlags = TRACE_INPUT;
     mutable std::mutex mTraceLock;
     bool mEnabled GUARDED_BY(mTraceLock) = false;
+    bool mContinuous GUARDED_BY(mTraceLock) = false;
     std::unique_ptr<RingBuffer<LayersTraceFileProto, LayersTraceProto>> mBuffer
             GUARDED_BY(mTraceLock);
     size_t mBufferSizeInBytes GUARDED_BY(mTraceLock) = 20 * 1024 * 1024;
+
+    // Entries generated on the main thread in continuous mode, waiting to be serialized and
+    // added to the ring buffer by the tracing thread.
+    LocklessStack<LayersTraceProto> mPendingEntries;
+    std::mutex mThreadLock;
+    std::thread mThread GUARDED_BY(mThreadLock);
+    bool mDone GUARDED_BY(mThreadLock) = false;
+    bool mEntriesAvailable GUARDED_BY(mThreadLock) = false;
+    std::condition_variable mEntriesAvailableCv;
 };
 
 } // namespace android
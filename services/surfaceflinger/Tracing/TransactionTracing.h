@@ -39,11 +39,11 @@ class TransactionTracingTest;
 /*
  * Records all committed transactions into a ring bufffer.
  *
- * Transactions come in via the binder thread. They are serialized to proto
- * and stored in a map using the transaction id as key. Main thread will
- * pass the list of transaction ids that are committed every vsync and notify
- * the tracing thread. The tracing thread will then wake up and add the
- * committed transactions to the ring buffer.
+ * Transactions come in via the binder thread. A flat copy of the transaction
+ * is pushed to a lockless queue. Main thread will pass the list of transaction
+ * ids that are committed every vsync and notify the tracing thread. The
+ * tracing thread will then wake up, serialize the queued transactions to proto
+ * and add the committed ones to the ring buffer.
  *
  * When generating SF dump state, we will flush the buffer to a file which
  * will then be included in the bugreport.
@@ -79,7 +79,10 @@ private:
     size_t mBufferSizeInBytes GUARDED_BY(mTraceLock) = CONTINUOUS_TRACING_BUFFER_SIZE;
     std::unordered_map<uint64_t, proto::TransactionState> mQueuedTransactions
             GUARDED_BY(mTraceLock);
-    LocklessStack<proto::TransactionState> mTransactionQueue;
+    // Transactions pushed from the binder thread. Only a flat copy of the incoming state is
+    // taken there; proto conversion is deferred to the tracing thread so the binder thread
+    // never allocates proto messages or touches the tracing lock.
+    LocklessStack<TransactionState> mTransactionQueue;
     nsecs_t mStartingTimestamp GUARDED_BY(mTraceLock);
     std::vector<proto::LayerCreationArgs> mCreatedLayers GUARDED_BY(mTraceLock);
     std::unordered_map<BBinder* /* layerHandle */, int32_t /* layerId */> mLayerHandles
@@ -87,9 +90,6 @@ private:
     std::vector<int32_t /* layerId */> mRemovedLayerHandles GUARDED_BY(mTraceLock);
     std::map<int32_t /* layerId */, TracingLayerState> mStartingStates GUARDED_BY(mTraceLock);
     TransactionProtoParser mProtoParser GUARDED_BY(mTraceLock);
-    // Parses the transaction to proto without holding any tracing locks so we can generate proto
-    // in the binder thread without any contention.
-    TransactionProtoParser mLockfreeProtoParser;
 
     // We do not want main thread to block so main thread will try to acquire mMainThreadLock,
     // otherwise will push data to temporary container.
@@ -182,6 +182,14 @@ void TransactionCallbackInvoker::addPresentFence(const sp<Fence>& presentFence)
     mPresentFence = presentFence;
 }
 
+void TransactionCallbackInvoker::addBufferRelease(
+        const sp<ITransactionCompletedListener>& listener, ReleaseBufferStats stats) {
+    if (!listener) {
+        return;
+    }
+    mBufferReleases[IInterface::asBinder(listener)].emplace_back(std::move(stats));
+}
+
 void TransactionCallbackInvoker::sendCallbacks(bool onCommitOnly) {
     // For each listener
     auto completedTransactionsItr = mCompletedTransactions.begin();
@@ -229,11 +237,27 @@ void TransactionCallbackInvoker::sendCallbacks(bool onCommitOnly) {
         completedTransactionsItr++;
     }
 
+    // Flush the queued buffer releases, one batched onReleaseBuffers call per listener. These
+    // are sent on every flush, regardless of onCommitOnly, so that clients learn their buffers
+    // are reusable at the earliest flush point in the frame.
+    for (auto& [listenerBinder, releases] : mBufferReleases) {
+        if (releases.empty() || !listenerBinder->isBinderAlive()) {
+            continue;
+        }
+        sp<IBinder> listener = listenerBinder;
+        callbacks.emplace_back([listener, releases = std::move(releases)]() mutable {
+            interface_cast<ITransactionCompletedListener>(listener)->onReleaseBuffers(
+                    std::move(releases));
+        });
+    }
+    mBufferReleases.clear();
+
     if (mPresentFence) {
         mPresentFence.clear();
     }
 
-    BackgroundExecutor::getInstance().sendCallbacks(std::move(callbacks));
+    BackgroundExecutor::getInstance().sendCallbacks(std::move(callbacks),
+                                                    BackgroundExecutor::kTransactionCallbackTag);
 }
 
 // -----------------------------------------------------------------------
@@ -72,6 +72,12 @@ public:
 
     void addPresentFence(const sp<Fence>& presentFence);
 
+    // Queues a buffer release for the listener. All releases queued for the same listener are
+    // delivered in a single onReleaseBuffers binder transaction on the next sendCallbacks,
+    // instead of one transaction per released buffer. Main thread only.
+    void addBufferRelease(const sp<ITransactionCompletedListener>& listener,
+                          ReleaseBufferStats stats);
+
     void sendCallbacks(bool onCommitOnly);
     void clearCompletedTransactions() {
         mCompletedTransactions.clear();
@@ -89,6 +95,9 @@ private:
     std::unordered_map<sp<IBinder>, std::deque<TransactionStats>, IListenerHash>
         mCompletedTransactions;
 
+    std::unordered_map<sp<IBinder>, std::vector<ReleaseBufferStats>, IListenerHash>
+        mBufferReleases;
+
     sp<Fence> mPresentFence;
 };
 
@@ -23,10 +23,12 @@
 
 #include <gui/LayerState.h>
 #include <system/window.h>
+#include <ui/FenceTime.h>
 
 namespace android {
 
 class CountDownLatch;
+class Layer;
 
 struct TransactionState {
     TransactionState() = default;
@@ -100,6 +102,17 @@ struct TransactionState {
     std::shared_ptr<CountDownLatch> transactionCommittedSignal;
     int64_t queueTime = 0;
     bool sentFenceTimeoutWarning = false;
+
+    // Layers resolved from states[i].state.surface, index-aligned with states. Populated once
+    // on the binder thread when the transaction is queued so that the main thread's repeated
+    // readiness checks don't redo the handle lookup on every flush attempt.
+    std::vector<wp<Layer>> resolvedLayers;
+
+    // Acquire fence times for states with a changed buffer fence, index-aligned with states
+    // (null for the rest). Created at queue time and handed to the FenceWatcher, so by the
+    // time the main thread checks transaction readiness the signal status is usually a cached
+    // read instead of a per-fence ioctl.
+    std::vector<std::shared_ptr<FenceTime>> queuedAcquireFenceTimes;
 };
 
 class CountDownLatch {
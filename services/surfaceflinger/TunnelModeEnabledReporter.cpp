@@ -20,6 +20,7 @@
 
 #include <algorithm>
 
+#include "BackgroundExecutor.h"
 #include "Layer.h"
 #include "SurfaceFlinger.h"
 #include "TunnelModeEnabledReporter.h"
@@ -34,13 +35,37 @@ void TunnelModeEnabledReporter::updateTunnelModeStatus() {
 }
 
 void TunnelModeEnabledReporter::dispatchTunnelModeEnabled(bool tunnelModeEnabled) {
-    std::vector<sp<gui::ITunnelModeEnabledListener>> localListeners;
     {
         std::scoped_lock lock(mMutex);
         if (mTunnelModeEnabled == tunnelModeEnabled) {
             return;
         }
         mTunnelModeEnabled = tunnelModeEnabled;
+        if (mDispatchPending) {
+            // The queued dispatch will pick up the state stored above.
+            return;
+        }
+        mDispatchPending = true;
+    }
+
+    BackgroundExecutor::getInstance()
+            .sendCallbacks({[reporter = sp<TunnelModeEnabledReporter>::fromExisting(this)]() {
+                               reporter->dispatchPendingState();
+                           }},
+                           BackgroundExecutor::kTunnelModeTag);
+}
+
+void TunnelModeEnabledReporter::dispatchPendingState() {
+    bool tunnelModeEnabled = false;
+    std::vector<sp<gui::ITunnelModeEnabledListener>> localListeners;
+    {
+        std::scoped_lock lock(mMutex);
+        mDispatchPending = false;
+        tunnelModeEnabled = mTunnelModeEnabled;
+        if (mLastDispatchedState == tunnelModeEnabled) {
+            return;
+        }
+        mLastDispatchedState = tunnelModeEnabled;
 
         std::transform(mListeners.begin(), mListeners.end(), std::back_inserter(localListeners),
                        [](const std::pair<wp<IBinder>, sp<gui::ITunnelModeEnabledListener>>&
@@ -39,7 +39,9 @@ public:
     // method.
     void updateTunnelModeStatus();
 
-    // Dispatches tunnelModeEnabled to all registered listeners
+    // Publishes tunnelModeEnabled and queues the listener fan-out onto a background
+    // worker, so the binder calls happen off the calling (main) thread. Rapid
+    // enabled/disabled flapping collapses into a single listener update.
     void dispatchTunnelModeEnabled(bool tunnelModeEnabled);
 
     // Override for IBinder::DeathRecipient
@@ -55,11 +57,18 @@ public:
     inline void decrementTunnelModeCount() { mTunnelModeCount--; }
 
 private:
+    // Runs on a background worker; delivers the latest published state to the listeners.
+    void dispatchPendingState();
+
     mutable std::mutex mMutex;
 
     std::unordered_map<wp<IBinder>, sp<gui::ITunnelModeEnabledListener>, WpHash> mListeners
             GUARDED_BY(mMutex);
     bool mTunnelModeEnabled GUARDED_BY(mMutex) = false;
+    // The state the listeners last heard about. Skips the fan-out when the state has
+    // flapped back by the time the queued dispatch runs.
+    bool mLastDispatchedState GUARDED_BY(mMutex) = false;
+    bool mDispatchPending GUARDED_BY(mMutex) = false;
     uint32_t mTunnelModeCount = 0;
 };
 
@@ -14,6 +14,11 @@
  * limitations under the License.
  */
 
+#define LOG_TAG "WindowInfosListenerInvoker"
+
+#include <android/gui/BnWindowInfosListener.h>
+#include <binder/IInterface.h>
+#include <binder/Parcel.h>
 #include <ftl/small_vector.h>
 #include <gui/ISurfaceComposer.h>
 
@@ -77,9 +82,38 @@ void WindowInfosListenerInvoker::windowInfosChanged(const std::vector<WindowInfo
 
     mCallbacksPending = windowInfosListeners.size();
 
+    // The window and display info are identical for every listener, so
+    // serialize them once and send the same parcel to each one. This keeps
+    // the fan-out cost proportional to the number of listeners instead of
+    // listeners times windows.
+    Parcel data;
+    status_t status = data.writeInterfaceToken(gui::IWindowInfosListener::descriptor);
+    if (status == OK) {
+        status = data.writeParcelableVector(windowInfos);
+    }
+    if (status == OK) {
+        status = data.writeParcelableVector(displayInfos);
+    }
+    if (status == OK) {
+        status = data.writeStrongBinder(
+                shouldSync ? IInterface::asBinder(mWindowInfosReportedListener) : nullptr);
+    }
+
+    if (status != OK) {
+        // Fall back to marshaling per listener through the generated proxy.
+        ALOGE("Failed to serialize window infos (%d), falling back to per-listener dispatch",
+              status);
+        for (const auto& listener : windowInfosListeners) {
+            listener->onWindowInfosChanged(windowInfos, displayInfos,
+                                           shouldSync ? mWindowInfosReportedListener : nullptr);
+        }
+        return;
+    }
+
     for (const auto& listener : windowInfosListeners) {
-        listener->onWindowInfosChanged(windowInfos, displayInfos,
-                                       shouldSync ? mWindowInfosReportedListener : nullptr);
+        IInterface::asBinder(listener)
+                ->transact(gui::BnWindowInfosListener::TRANSACTION_onWindowInfosChanged, data,
+                           nullptr, IBinder::FLAG_ONEWAY);
     }
 }
 
@@ -279,6 +279,7 @@ private:
     // MessageQueue overrides:
     void scheduleFrame() override {}
     void postMessage(sp<MessageHandler>&&) override {}
+    void postMessageDeferred(sp<MessageHandler>&&) override {}
 };
 
 } // namespace scheduler
@@ -439,12 +440,12 @@ public:
         std::string result = fdp->ConsumeRandomLengthString().c_str();
         mFlinger->appendSfConfigString(result);
         result = fdp->ConsumeRandomLengthString().c_str();
-        mFlinger->listLayersLocked(result);
+        mFlinger->listLayers(result);
 
         using DumpArgs = Vector<String16>;
         DumpArgs dumpArgs;
         dumpArgs.push_back(String16(fdp->ConsumeRandomLengthString().c_str()));
-        mFlinger->clearStatsLocked(dumpArgs, result);
+        mFlinger->clearStats(dumpArgs, result);
 
         mFlinger->dumpTimeStats(dumpArgs, fdp->ConsumeBool(), result);
         FTL_FAKE_GUARD(kMainThreadContext, mFlinger->logFrameStats());
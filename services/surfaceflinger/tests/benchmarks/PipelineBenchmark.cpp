@@ -0,0 +1,398 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// TODO(b/129481165): remove the #pragma below and fix conversion issues
+#include "renderengine/ExternalTexture.h"
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wconversion"
+#pragma clang diagnostic ignored "-Wextra"
+
+#undef LOG_TAG
+#define LOG_TAG "PipelineBenchmark"
+
+#include <algorithm>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <compositionengine/Display.h>
+#include <compositionengine/mock/DisplaySurface.h>
+#include <gmock/gmock.h>
+#include <gui/LayerMetadata.h>
+#include <gui/LayerState.h>
+#include <log/log.h>
+#include <renderengine/mock/RenderEngine.h>
+#include <system/window.h>
+#include <ui/GraphicBuffer.h>
+
+#include "BufferStateLayer.h"
+#include "EffectLayer.h"
+#include "Layer.h"
+#include "TestableSurfaceFlinger.h"
+#include "mock/DisplayHardware/MockComposer.h"
+#include "mock/DisplayHardware/MockPowerAdvisor.h"
+#include "mock/MockEventThread.h"
+#include "mock/MockTimeStats.h"
+#include "mock/MockVsyncController.h"
+#include "mock/system/window/MockNativeWindow.h"
+
+namespace android {
+namespace {
+
+namespace hal = android::hardware::graphics::composer::hal;
+
+using hal::Error;
+using hal::PowerMode;
+
+using aidl::android::hardware::graphics::composer3::Capability;
+
+using testing::_;
+using testing::DoAll;
+using testing::Mock;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+using testing::SetArgPointee;
+
+using FakeHwcDisplayInjector = TestableSurfaceFlinger::FakeHwcDisplayInjector;
+using FakeDisplayDeviceInjector = TestableSurfaceFlinger::FakeDisplayDeviceInjector;
+
+constexpr hal::HWDisplayId HWC_DISPLAY = FakeHwcDisplayInjector::DEFAULT_HWC_DISPLAY_ID;
+
+constexpr PhysicalDisplayId DEFAULT_DISPLAY_ID = PhysicalDisplayId::fromPort(42u);
+constexpr int DEFAULT_DISPLAY_WIDTH = 1920;
+constexpr int DEFAULT_DISPLAY_HEIGHT = 1024;
+constexpr ui::LayerStack LAYER_STACK{7000u};
+
+// Number of buffers each layer cycles through in the buffer rotation workload,
+// mimicking a BLAST queue in steady state.
+constexpr size_t kBuffersPerLayer = 3;
+
+// Synthetic per-frame workloads. Each one drives a different transaction shape
+// through setTransactionState() so the apply/commit/composite stages see the
+// corresponding latch and invalidate work.
+enum class Workload {
+    PositionUpdates, // every layer moves each frame
+    ColorUpdates,    // every layer changes alpha and color each frame
+    BufferRotation,  // every layer gets a new buffer each frame
+};
+
+// Drives synthetic workloads through the real SurfaceFlinger commit/composite
+// code against the mock HWC and RenderEngine from tests/unittests. The setup
+// mirrors CompositionTest, with ON_CALL defaults instead of expectations since
+// nothing is being asserted here.
+class PipelineHarness {
+public:
+    PipelineHarness(size_t layerCount, Workload workload) : mWorkload(workload) {
+        setupScheduler();
+
+        ON_CALL(*mNativeWindow, query(NATIVE_WINDOW_WIDTH, _))
+                .WillByDefault(DoAll(SetArgPointee<1>(DEFAULT_DISPLAY_WIDTH), Return(0)));
+        ON_CALL(*mNativeWindow, query(NATIVE_WINDOW_HEIGHT, _))
+                .WillByDefault(DoAll(SetArgPointee<1>(DEFAULT_DISPLAY_HEIGHT), Return(0)));
+
+        mFlinger.setupRenderEngine(std::unique_ptr<renderengine::RenderEngine>(mRenderEngine));
+        mFlinger.setupTimeStats(std::shared_ptr<TimeStats>(mTimeStats));
+
+        mComposer = new NiceMock<Hwc2::mock::Composer>();
+        mPowerAdvisor = new NiceMock<Hwc2::mock::PowerAdvisor>();
+        mFlinger.setupComposer(std::unique_ptr<Hwc2::Composer>(mComposer));
+        mFlinger.setupPowerAdvisor(std::unique_ptr<Hwc2::PowerAdvisor>(mPowerAdvisor));
+        mFlinger.mutableMaxRenderTargetSize() = 16384;
+
+        setupDisplay();
+        createLayers(layerCount);
+    }
+
+    ~PipelineHarness() {
+        mDisplay->getCompositionDisplay()->clearOutputLayers();
+        mFlinger.mutableCurrentState().layersSortedByZ.clear();
+        mFlinger.mutableDrawingState().layersSortedByZ.clear();
+        // Unregister the layers from the scheduler before they are destroyed.
+        mFlinger.commit();
+        mHandles.clear();
+        mLayers.clear();
+    }
+
+    void applyTransactions(size_t transactionCount) {
+        mFrame++;
+        for (size_t i = 0; i < transactionCount; i++) {
+            Vector<ComposerState> states;
+            for (size_t l = 0; l < mLayers.size(); l++) {
+                states.add(makeLayerState(l));
+            }
+            Vector<DisplayState> displays;
+            std::vector<ListenerCallbacks> callbacks;
+            mFlinger.setTransactionState(FrameTimelineInfo{}, states, displays, 0 /* flags */,
+                                         mApplyToken, InputWindowCommands{},
+                                         0 /* desiredPresentTime */, true /* isAutoTimestamp */,
+                                         {} /* uncacheBuffer */, false /* hasListenerCallbacks */,
+                                         callbacks, mNextTransactionId++);
+        }
+    }
+
+    nsecs_t commit() { return mFlinger.commit(); }
+
+    void composite(nsecs_t frameTime) { mFlinger.composite(frameTime); }
+
+private:
+    void setupScheduler() {
+        auto eventThread = std::make_unique<NiceMock<mock::EventThread>>();
+        auto sfEventThread = std::make_unique<NiceMock<mock::EventThread>>();
+
+        ON_CALL(*eventThread, createEventConnection(_, _))
+                .WillByDefault(Return(new EventThreadConnection(eventThread.get(),
+                                                                /*callingUid=*/0,
+                                                                ResyncCallback())));
+        ON_CALL(*sfEventThread, createEventConnection(_, _))
+                .WillByDefault(Return(new EventThreadConnection(sfEventThread.get(),
+                                                                /*callingUid=*/0,
+                                                                ResyncCallback())));
+
+        auto vsyncController = std::make_unique<NiceMock<mock::VsyncController>>();
+        auto vsyncTracker = std::make_unique<NiceMock<mock::VSyncTracker>>();
+
+        ON_CALL(*vsyncTracker, nextAnticipatedVSyncTimeFrom(_)).WillByDefault(Return(0));
+        ON_CALL(*vsyncTracker, currentPeriod())
+                .WillByDefault(Return(FakeHwcDisplayInjector::DEFAULT_VSYNC_PERIOD));
+
+        mFlinger.setupScheduler(std::move(vsyncController), std::move(vsyncTracker),
+                                std::move(eventThread), std::move(sfEventThread),
+                                TestableSurfaceFlinger::SchedulerCallbackImpl::kNoOp,
+                                TestableSurfaceFlinger::kTwoDisplayModes, true /* useNiceMock */);
+    }
+
+    void setupDisplay() {
+        FakeHwcDisplayInjector(DEFAULT_DISPLAY_ID, hal::DisplayType::PHYSICAL, true /* isPrimary */)
+                .setCapabilities(&mDefaultCapabilities)
+                .setPowerMode(PowerMode::ON)
+                .inject(&mFlinger, mComposer);
+        Mock::VerifyAndClear(mComposer);
+
+        auto ceDisplayArgs = compositionengine::DisplayCreationArgsBuilder()
+                                     .setId(DEFAULT_DISPLAY_ID)
+                                     .setPixels({DEFAULT_DISPLAY_WIDTH, DEFAULT_DISPLAY_HEIGHT})
+                                     .setIsSecure(true)
+                                     .setPowerAdvisor(mPowerAdvisor)
+                                     .setName("Injected display for pipeline benchmark")
+                                     .build();
+
+        auto compositionDisplay =
+                compositionengine::impl::createDisplay(mFlinger.getCompositionEngine(),
+                                                       ceDisplayArgs);
+
+        mDisplay = FakeDisplayDeviceInjector(mFlinger, compositionDisplay,
+                                             ui::DisplayConnectionType::Internal, HWC_DISPLAY,
+                                             true /* isPrimary */)
+                           .setDisplaySurface(mDisplaySurface)
+                           .setNativeWindow(mNativeWindow)
+                           .setSecure(true)
+                           .setPowerMode(PowerMode::ON)
+                           .inject();
+        mDisplay->setLayerStack(LAYER_STACK);
+
+        ON_CALL(*mComposer, createLayer(HWC_DISPLAY, _))
+                .WillByDefault([this](hal::HWDisplayId, hal::HWLayerId* outLayer) {
+                    *outLayer = mNextHwcLayerId++;
+                    return Error::NONE;
+                });
+        ON_CALL(*mDisplaySurface, getClientTargetAcquireFence())
+                .WillByDefault(ReturnRef(mClientTargetAcquireFence));
+        ON_CALL(*mRenderEngine, drawLayers)
+                .WillByDefault([](const renderengine::DisplaySettings&,
+                                  const std::vector<renderengine::LayerSettings>&,
+                                  const std::shared_ptr<renderengine::ExternalTexture>&, const bool,
+                                  base::unique_fd&&)
+                                       -> std::future<renderengine::RenderEngineResult> {
+                    std::promise<renderengine::RenderEngineResult> resultPromise;
+                    auto resultFuture = resultPromise.get_future();
+                    resultPromise.set_value({NO_ERROR, base::unique_fd()});
+                    return resultFuture;
+                });
+    }
+
+    void createLayers(size_t layerCount) {
+        for (size_t i = 0; i < layerCount; i++) {
+            const std::string name = "bench-layer-" + std::to_string(i);
+            sp<Layer> layer;
+            if (mWorkload == Workload::BufferRotation) {
+                layer = new BufferStateLayer(LayerCreationArgs(mFlinger.flinger(), sp<Client>(),
+                                                               name, 0 /* flags */,
+                                                               LayerMetadata()));
+                std::vector<sp<GraphicBuffer>> buffers;
+                for (size_t b = 0; b < kBuffersPerLayer; b++) {
+                    buffers.push_back(new GraphicBuffer());
+                }
+                mBuffers.push_back(std::move(buffers));
+            } else {
+                layer = new EffectLayer(LayerCreationArgs(mFlinger.flinger(), sp<Client>(), name,
+                                                          0 /* flags */, LayerMetadata()));
+            }
+
+            auto& layerDrawingState = mFlinger.mutableLayerDrawingState(layer);
+            layerDrawingState.layerStack = LAYER_STACK;
+            layerDrawingState.width = 100;
+            layerDrawingState.height = 100;
+            layerDrawingState.color = half4(1.f, 1.f, 1.f, 1.f);
+            layerDrawingState.crop = Rect(0, 0, 100, 100);
+            layer->computeBounds(FloatRect(0, 0, 100, 100), ui::Transform(),
+                                 0.f /* shadowRadius */);
+
+            auto outputLayer = mDisplay->getCompositionDisplay()->injectOutputLayerForTest(
+                    layer->getCompositionEngineLayerFE());
+            outputLayer->editState().visibleRegion = Region(Rect(0, 0, 100, 100));
+            outputLayer->editState().outputSpaceVisibleRegion = Region(Rect(0, 0, 100, 100));
+
+            // Transactions latch through the current state, so the layer has
+            // to be in both lists for commitTransactionsLocked() to see it.
+            mFlinger.mutableCurrentState().layersSortedByZ.add(layer);
+            mFlinger.mutableDrawingState().layersSortedByZ.add(layer);
+
+            mHandles.push_back(layer->getHandle());
+            mLayers.push_back(layer);
+        }
+    }
+
+    ComposerState makeLayerState(size_t layerIndex) {
+        ComposerState composerState;
+        layer_state_t& s = composerState.state;
+        s.surface = mHandles[layerIndex];
+        switch (mWorkload) {
+            case Workload::PositionUpdates:
+                s.what = layer_state_t::ePositionChanged;
+                s.x = static_cast<float>(mFrame % 32);
+                s.y = static_cast<float>((mFrame + layerIndex) % 32);
+                break;
+            case Workload::ColorUpdates:
+                s.what = layer_state_t::eAlphaChanged | layer_state_t::eColorChanged;
+                s.alpha = 0.5f + 0.5f / static_cast<float>(mFrame % 7 + 1);
+                s.color = half3(s.alpha, 1.f - s.alpha, 0.5f);
+                break;
+            case Workload::BufferRotation: {
+                s.what = layer_state_t::eBufferChanged;
+                auto bufferData = std::make_shared<BufferData>();
+                bufferData->buffer = mBuffers[layerIndex][mFrame % kBuffersPerLayer];
+                bufferData->acquireFence = Fence::NO_FENCE;
+                bufferData->frameNumber = mFrame;
+                bufferData->flags |= BufferData::BufferDataChange::fenceChanged;
+                bufferData->flags |= BufferData::BufferDataChange::frameNumberChanged;
+                s.bufferData = std::move(bufferData);
+                break;
+            }
+        }
+        return composerState;
+    }
+
+    TestableSurfaceFlinger mFlinger;
+    sp<DisplayDevice> mDisplay;
+    sp<compositionengine::mock::DisplaySurface> mDisplaySurface =
+            new NiceMock<compositionengine::mock::DisplaySurface>();
+    mock::NativeWindow* mNativeWindow = new NiceMock<mock::NativeWindow>();
+    Hwc2::mock::Composer* mComposer = nullptr;
+    renderengine::mock::RenderEngine* mRenderEngine =
+            new NiceMock<renderengine::mock::RenderEngine>();
+    mock::TimeStats* mTimeStats = new NiceMock<mock::TimeStats>();
+    Hwc2::mock::PowerAdvisor* mPowerAdvisor = nullptr;
+
+    std::unordered_set<Capability> mDefaultCapabilities = {Capability::SIDEBAND_STREAM};
+    sp<Fence> mClientTargetAcquireFence = Fence::NO_FENCE;
+    sp<IBinder> mApplyToken = new BBinder();
+
+    const Workload mWorkload;
+    hal::HWLayerId mNextHwcLayerId = 5000;
+    uint64_t mNextTransactionId = 1;
+    uint64_t mFrame = 0;
+    std::vector<sp<Layer>> mLayers;
+    std::vector<sp<IBinder>> mHandles;
+    std::vector<std::vector<sp<GraphicBuffer>>> mBuffers;
+};
+
+void reportPercentiles(benchmark::State& state, const std::string& stage,
+                       std::vector<nsecs_t>& samples) {
+    if (samples.empty()) {
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](double p) {
+        const auto index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return static_cast<double>(samples[std::min(index, samples.size() - 1)]) / 1e3;
+    };
+    state.counters[stage + "_p50_us"] = percentile(0.50);
+    state.counters[stage + "_p90_us"] = percentile(0.90);
+    state.counters[stage + "_p99_us"] = percentile(0.99);
+}
+
+void runPipeline(benchmark::State& state, Workload workload) {
+    const auto layerCount = static_cast<size_t>(state.range(0));
+    const auto transactionsPerFrame = static_cast<size_t>(state.range(1));
+    PipelineHarness harness(layerCount, workload);
+
+    std::vector<nsecs_t> applySamples;
+    std::vector<nsecs_t> commitSamples;
+    std::vector<nsecs_t> compositeSamples;
+
+    for (auto _ : state) {
+        const nsecs_t applyStart = systemTime();
+        harness.applyTransactions(transactionsPerFrame);
+        const nsecs_t commitStart = systemTime();
+        const nsecs_t frameTime = harness.commit();
+        const nsecs_t compositeStart = systemTime();
+        harness.composite(frameTime);
+        const nsecs_t compositeEnd = systemTime();
+
+        applySamples.push_back(commitStart - applyStart);
+        commitSamples.push_back(compositeStart - commitStart);
+        compositeSamples.push_back(compositeEnd - compositeStart);
+    }
+
+    reportPercentiles(state, "apply", applySamples);
+    reportPercentiles(state, "commit", commitSamples);
+    // Composition and present are timed together: the mock composer returns
+    // immediately, so there is no separate present stage to observe.
+    reportPercentiles(state, "composite", compositeSamples);
+}
+
+void BM_positionUpdates(benchmark::State& state) {
+    runPipeline(state, Workload::PositionUpdates);
+}
+
+void BM_colorUpdates(benchmark::State& state) {
+    runPipeline(state, Workload::ColorUpdates);
+}
+
+void BM_bufferRotation(benchmark::State& state) {
+    runPipeline(state, Workload::BufferRotation);
+}
+
+// {layers per frame, transactions per frame}
+BENCHMARK(BM_positionUpdates)->ArgsProduct({{1, 16, 64}, {1, 4}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_colorUpdates)->ArgsProduct({{1, 16, 64}, {1, 4}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_bufferRotation)->ArgsProduct({{1, 16, 64}, {1}})->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace android
+
+// gmock here only provides the fakes borrowed from tests/unittests; route its
+// chatter away from the benchmark output and let uninteresting calls take
+// their default actions.
+int main(int argc, char** argv) {
+    ::testing::GMOCK_FLAG(verbose) = "error";
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
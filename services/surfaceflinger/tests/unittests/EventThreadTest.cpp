@@ -541,6 +541,28 @@ TEST_F(EventThreadTest, setVsyncRateTwoPostsEveryOtherEventToThatConnection) {
     expectVsyncEventReceivedByConnection(101112, 4u);
 }
 
+TEST_F(EventThreadTest, setVsyncRateZeroAfterNonzeroStopsEventsToThatConnection) {
+    mThread->setVsyncRate(1, mConnection);
+
+    // EventThread should enable vsync callbacks.
+    expectVSyncSetEnabledCallReceived(true);
+
+    // The first event is seen by the interceptor and the connection.
+    mCallback->onVSyncEvent(123, {456, 789});
+    expectInterceptCallReceived(123);
+    expectVsyncEventReceivedByConnection(123, 1u);
+
+    // Setting the rate back to zero removes the connection from the active set
+    // and disables vsync callbacks.
+    mThread->setVsyncRate(0, mConnection);
+    expectVSyncSetEnabledCallReceived(false);
+
+    // A subsequent event is seen by the interceptor, and not the connection.
+    mCallback->onVSyncEvent(456, {123, 0});
+    expectInterceptCallReceived(456);
+    EXPECT_FALSE(mConnectionEventCallRecorder.waitForUnexpectedCall().has_value());
+}
+
 TEST_F(EventThreadTest, connectionsRemovedIfInstanceDestroyed) {
     mThread->setVsyncRate(1, mConnection);
 
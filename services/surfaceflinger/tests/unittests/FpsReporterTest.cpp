@@ -24,6 +24,7 @@
 #include <gtest/gtest.h>
 #include <gui/LayerMetadata.h>
 
+#include "BackgroundExecutor.h"
 #include "BufferQueueLayer.h"
 #include "BufferStateLayer.h"
 #include "EffectLayer.h"
@@ -82,6 +83,13 @@ protected:
     void setupScheduler();
     sp<BufferStateLayer> createBufferStateLayer(LayerMetadata metadata);
 
+    // Listener invocations run on a background worker, so flush it before asserting on the
+    // values the listener received.
+    void dispatchLayerFpsAndFlush() {
+        mFpsReporter->dispatchLayerFps();
+        BackgroundExecutor::getInstance().flushQueue(BackgroundExecutor::kFpsReporterTag);
+    }
+
     TestableSurfaceFlinger mFlinger;
     mock::FrameTimeline mFrameTimeline =
             mock::FrameTimeline(std::make_shared<impl::TimeStats>(), 0);
@@ -176,13 +184,13 @@ TEST_F(FpsReporterTest, callsListeners) {
 
     mFpsReporter->addListener(mFpsListener, kTaskId);
     mClock->advanceTime(600ms);
-    mFpsReporter->dispatchLayerFps();
+    dispatchLayerFpsAndFlush();
     EXPECT_EQ(expectedFps, mFpsListener->lastReportedFps);
     mFpsReporter->removeListener(mFpsListener);
     Mock::VerifyAndClearExpectations(&mFrameTimeline);
 
     EXPECT_CALL(mFrameTimeline, computeFps(_)).Times(0);
-    mFpsReporter->dispatchLayerFps();
+    dispatchLayerFpsAndFlush();
 }
 
 TEST_F(FpsReporterTest, rateLimits) {
@@ -201,16 +209,16 @@ TEST_F(FpsReporterTest, rateLimits) {
 
     mFpsReporter->addListener(mFpsListener, kTaskId);
     mClock->advanceTime(600ms);
-    mFpsReporter->dispatchLayerFps();
+    dispatchLayerFpsAndFlush();
     EXPECT_EQ(firstFps, mFpsListener->lastReportedFps);
     mClock->advanceTime(200ms);
-    mFpsReporter->dispatchLayerFps();
+    dispatchLayerFpsAndFlush();
     EXPECT_EQ(firstFps, mFpsListener->lastReportedFps);
     mClock->advanceTime(200ms);
-    mFpsReporter->dispatchLayerFps();
+    dispatchLayerFpsAndFlush();
     EXPECT_EQ(firstFps, mFpsListener->lastReportedFps);
     mClock->advanceTime(200ms);
-    mFpsReporter->dispatchLayerFps();
+    dispatchLayerFpsAndFlush();
     EXPECT_EQ(secondFps, mFpsListener->lastReportedFps);
 }
 
@@ -116,7 +116,7 @@ public:
         for (size_t i = 0; i < maxTokens; i++) {
             mTokenManager->generateTokenForPredictions({});
         }
-        EXPECT_EQ(getPredictions().size(), maxTokens);
+        EXPECT_EQ(getPredictionCount(), maxTokens);
     }
 
     SurfaceFrame& getSurfaceFrame(size_t displayFrameIdx, size_t surfaceFrameIdx) {
@@ -135,8 +135,14 @@ public:
                 a.presentTime == b.presentTime;
     }
 
-    const std::map<int64_t, TimelineItem>& getPredictions() const {
-        return mTokenManager->mPredictions;
+    size_t getPredictionCount() const {
+        size_t count = 0;
+        for (const auto& slot : mTokenManager->mTokenRing) {
+            if (slot.token.load() != FrameTimelineInfo::INVALID_VSYNC_ID) {
+                count++;
+            }
+        }
+        return count;
     }
 
     uint32_t getNumberOfDisplayFrames() const {
@@ -181,7 +187,7 @@ constexpr GameMode sGameMode = GameMode::Unsupported;
 
 TEST_F(FrameTimelineTest, tokenManagerRemovesStalePredictions) {
     int64_t token1 = mTokenManager->generateTokenForPredictions({0, 0, 0});
-    EXPECT_EQ(getPredictions().size(), 1u);
+    EXPECT_EQ(getPredictionCount(), 1u);
     flushTokens();
     int64_t token2 = mTokenManager->generateTokenForPredictions({10, 20, 30});
     std::optional<TimelineItem> predictions = mTokenManager->getPredictionsForToken(token1);
@@ -58,6 +58,7 @@ struct TestableRefreshRateConfigs : RefreshRateConfigs {
 
     const std::vector<Fps>& knownFrameRates() const { return mKnownFrameRates; }
 
+    using RefreshRateConfigs::fingerprintArguments;
     using RefreshRateConfigs::GetBestRefreshRateCache;
     auto& mutableGetBestRefreshRateCache() { return mGetBestRefreshRateCache; }
 
@@ -1721,7 +1722,8 @@ TEST_F(RefreshRateConfigsTest, getBestRefreshRate_ReadsCache) {
                                      GlobalSignals{.touch = true, .idle = true});
     const auto result = std::make_pair(kMode90, GlobalSignals{.touch = true});
 
-    configs.mutableGetBestRefreshRateCache() = {args, result};
+    configs.mutableGetBestRefreshRateCache() =
+            {TestableRefreshRateConfigs::fingerprintArguments(args.first, args.second), result};
 
     EXPECT_EQ(result, configs.getBestRefreshRateAndSignals(args.first, args.second));
 }
@@ -1739,7 +1741,8 @@ TEST_F(RefreshRateConfigsTest, getBestRefreshRate_WritesCache) {
     const auto& cache = configs.mutableGetBestRefreshRateCache();
     ASSERT_TRUE(cache);
 
-    EXPECT_EQ(cache->arguments, std::make_pair(layers, globalSignals));
+    EXPECT_EQ(cache->fingerprint,
+              TestableRefreshRateConfigs::fingerprintArguments(layers, globalSignals));
     EXPECT_EQ(cache->result, result);
 }
 
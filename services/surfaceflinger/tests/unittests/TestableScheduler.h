@@ -48,10 +48,16 @@ public:
             // Execute task to prevent broken promise exception on destruction.
             handler->handleMessage(Message());
         });
+
+        ON_CALL(*this, postMessageDeferred).WillByDefault([](sp<MessageHandler>&& handler) {
+            // Execute task to prevent broken promise exception on destruction.
+            handler->handleMessage(Message());
+        });
     }
 
     MOCK_METHOD(void, scheduleFrame, (), (override));
     MOCK_METHOD(void, postMessage, (sp<MessageHandler>&&), (override));
+    MOCK_METHOD(void, postMessageDeferred, (sp<MessageHandler>&&), (override));
 
     // Used to inject mock event thread.
     ConnectionHandle createConnection(std::unique_ptr<EventThread> eventThread) {
@@ -361,6 +361,8 @@ public:
 
     void commitAndComposite() { mFlinger->composite(commit(), kVsyncId); }
 
+    void composite(const nsecs_t frameTime) { mFlinger->composite(frameTime, kVsyncId); }
+
     auto createDisplay(const String8& displayName, bool secure) {
         return mFlinger->createDisplay(displayName, secure);
     }
@@ -22,6 +22,7 @@
 #include <gtest/gtest.h>
 #include <gui/LayerMetadata.h>
 
+#include "BackgroundExecutor.h"
 #include "BufferStateLayer.h"
 #include "TestableSurfaceFlinger.h"
 #include "TunnelModeEnabledReporter.h"
@@ -66,6 +67,18 @@ protected:
     void setupComposer(uint32_t virtualDisplayCount);
     sp<BufferStateLayer> createBufferStateLayer(LayerMetadata metadata);
 
+    // Listener invocations run on a background worker, so flush it before asserting on the
+    // values the listener received.
+    void dispatchTunnelModeEnabledAndFlush(bool tunnelModeEnabled) {
+        mTunnelModeEnabledReporter->dispatchTunnelModeEnabled(tunnelModeEnabled);
+        BackgroundExecutor::getInstance().flushQueue(BackgroundExecutor::kTunnelModeTag);
+    }
+
+    void updateTunnelModeStatusAndFlush() {
+        mTunnelModeEnabledReporter->updateTunnelModeStatus();
+        BackgroundExecutor::getInstance().flushQueue(BackgroundExecutor::kTunnelModeTag);
+    }
+
     TestableSurfaceFlinger mFlinger;
     Hwc2::mock::Composer* mComposer = nullptr;
 
@@ -84,14 +97,14 @@ TunnelModeEnabledReporterTest::TunnelModeEnabledReporterTest() {
     setupScheduler();
     mFlinger.setupComposer(std::make_unique<Hwc2::mock::Composer>());
     mFlinger.flinger()->mTunnelModeEnabledReporter = mTunnelModeEnabledReporter;
-    mTunnelModeEnabledReporter->dispatchTunnelModeEnabled(false);
+    dispatchTunnelModeEnabledAndFlush(false);
 }
 
 TunnelModeEnabledReporterTest::~TunnelModeEnabledReporterTest() {
     const ::testing::TestInfo* const test_info =
             ::testing::UnitTest::GetInstance()->current_test_info();
     ALOGD("**** Tearing down after %s.%s\n", test_info->test_case_name(), test_info->name());
-    mTunnelModeEnabledReporter->dispatchTunnelModeEnabled(false);
+    dispatchTunnelModeEnabledAndFlush(false);
     mTunnelModeEnabledReporter->removeListener(mTunnelModeEnabledListener);
 }
 
@@ -133,22 +146,22 @@ TEST_F(TunnelModeEnabledReporterTest, callsAddedListeners) {
     mTunnelModeEnabledReporter->addListener(mTunnelModeEnabledListener);
 
     bool expectedTunnelModeEnabled = false;
-    mTunnelModeEnabledReporter->dispatchTunnelModeEnabled(expectedTunnelModeEnabled);
+    dispatchTunnelModeEnabledAndFlush(expectedTunnelModeEnabled);
     EXPECT_EQ(expectedTunnelModeEnabled, mTunnelModeEnabledListener->mTunnelModeEnabled);
 
     expectedTunnelModeEnabled = true;
-    mTunnelModeEnabledReporter->dispatchTunnelModeEnabled(expectedTunnelModeEnabled);
+    dispatchTunnelModeEnabledAndFlush(expectedTunnelModeEnabled);
     EXPECT_EQ(expectedTunnelModeEnabled, mTunnelModeEnabledListener->mTunnelModeEnabled);
 
     mTunnelModeEnabledReporter->removeListener(mTunnelModeEnabledListener);
 
-    mTunnelModeEnabledReporter->dispatchTunnelModeEnabled(false);
+    dispatchTunnelModeEnabledAndFlush(false);
     EXPECT_EQ(expectedTunnelModeEnabled, mTunnelModeEnabledListener->mTunnelModeEnabled);
 }
 
 TEST_F(TunnelModeEnabledReporterTest, callsNewListenerImmediately) {
     bool expectedTunnelModeEnabled = false;
-    mTunnelModeEnabledReporter->dispatchTunnelModeEnabled(expectedTunnelModeEnabled);
+    dispatchTunnelModeEnabledAndFlush(expectedTunnelModeEnabled);
 
     mTunnelModeEnabledReporter->addListener(mTunnelModeEnabledListener);
     EXPECT_EQ(expectedTunnelModeEnabled, mTunnelModeEnabledListener->mTunnelModeEnabled);
@@ -161,14 +174,14 @@ TEST_F(TunnelModeEnabledReporterTest, callsNewListenerWithFreshInformation) {
                                  false);
     layer->setSidebandStream(stream);
     mFlinger.mutableCurrentState().layersSortedByZ.add(layer);
-    mTunnelModeEnabledReporter->updateTunnelModeStatus();
+    updateTunnelModeStatusAndFlush();
     mTunnelModeEnabledReporter->addListener(mTunnelModeEnabledListener);
     EXPECT_EQ(true, mTunnelModeEnabledListener->mTunnelModeEnabled);
     mTunnelModeEnabledReporter->removeListener(mTunnelModeEnabledListener);
     mFlinger.mutableCurrentState().layersSortedByZ.remove(layer);
     layer = nullptr;
 
-    mTunnelModeEnabledReporter->updateTunnelModeStatus();
+    updateTunnelModeStatusAndFlush();
     mTunnelModeEnabledReporter->addListener(mTunnelModeEnabledListener);
 
     EXPECT_EQ(false, mTunnelModeEnabledListener->mTunnelModeEnabled);
@@ -187,12 +200,12 @@ TEST_F(TunnelModeEnabledReporterTest, layerWithSidebandStreamTriggersUpdate) {
 
     mFlinger.mutableCurrentState().layersSortedByZ.add(simpleLayer);
     mFlinger.mutableCurrentState().layersSortedByZ.add(layerWithSidebandStream);
-    mTunnelModeEnabledReporter->updateTunnelModeStatus();
+    updateTunnelModeStatusAndFlush();
     EXPECT_EQ(true, mTunnelModeEnabledListener->mTunnelModeEnabled);
 
     mFlinger.mutableCurrentState().layersSortedByZ.remove(layerWithSidebandStream);
     layerWithSidebandStream = nullptr;
-    mTunnelModeEnabledReporter->updateTunnelModeStatus();
+    updateTunnelModeStatusAndFlush();
     EXPECT_EQ(false, mTunnelModeEnabledListener->mTunnelModeEnabled);
 }
 
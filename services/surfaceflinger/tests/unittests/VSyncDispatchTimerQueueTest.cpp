@@ -969,6 +969,21 @@ TEST_F(VSyncDispatchTimerQueueTest, updatesVsyncTimeForCloseWakeupTime) {
     EXPECT_THAT(cb.mReadyTime[0], Eq(2000));
 }
 
+TEST_F(VSyncDispatchTimerQueueTest, reportsWakeupAccuracyInDump) {
+    std::string dump;
+    mDispatch.dump(dump);
+    EXPECT_THAT(dump, Not(HasSubstr("Wakeup accuracy")));
+
+    CountingCallback cb(mDispatch);
+    mDispatch.schedule(cb, {.workDuration = 100, .readyDuration = 0, .earliestVsync = 1000});
+    advanceToNextCallback();
+    ASSERT_THAT(cb.mCalls.size(), Eq(1));
+
+    dump.clear();
+    mDispatch.dump(dump);
+    EXPECT_THAT(dump, HasSubstr("Wakeup accuracy over last 1 of 1 wakeups"));
+}
+
 class VSyncDispatchTimerQueueEntryTest : public testing::Test {
 protected:
     nsecs_t const mPeriod = 1000;
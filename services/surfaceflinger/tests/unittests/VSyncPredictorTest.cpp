@@ -532,6 +532,39 @@ TEST_F(VSyncPredictorTest, robustToDuplicateTimestamps_60hzRealTraceData) {
     EXPECT_THAT(intercept, IsCloseTo(expectedIntercept, mMaxRoundingError));
 }
 
+TEST_F(VSyncPredictorTest, reportsPredictionConfidence) {
+    EXPECT_EQ(0.f, tracker.getPredictionConfidence());
+
+    for (auto i = 0u; i < kHistorySize; i++) {
+        tracker.addVsyncTimestamp(mNow += mPeriod);
+    }
+
+    EXPECT_THAT(tracker.getPredictionConfidence(), Ge(0.99f));
+
+    tracker.resetModel();
+    EXPECT_EQ(0.f, tracker.getPredictionConfidence());
+}
+
+TEST_F(VSyncPredictorTest, predictionConfidenceIsLowerForJitterySamples) {
+    for (auto i = 0u; i < kHistorySize; i++) {
+        tracker.addVsyncTimestamp(mNow += mPeriod);
+    }
+    auto const cleanConfidence = tracker.getPredictionConfidence();
+
+    VSyncPredictor jitteryTracker{mPeriod, kHistorySize, kMinimumSamplesForPrediction,
+                                  kOutlierTolerancePercent};
+    auto const jitter = 100;
+    auto now = 0;
+    for (auto i = 0u; i < kHistorySize; i++) {
+        now += mPeriod;
+        jitteryTracker.addVsyncTimestamp(now + (i % 2 ? jitter : -jitter));
+    }
+
+    auto const jitteryConfidence = jitteryTracker.getPredictionConfidence();
+    EXPECT_GT(jitteryConfidence, 0.f);
+    EXPECT_LT(jitteryConfidence, cleanConfidence);
+}
+
 } // namespace android::scheduler
 
 // TODO(b/129481165): remove the #pragma below and fix conversion issues
@@ -46,12 +46,12 @@ class VsyncModulatorTest : public testing::Test {
         HWC_MIN_WORK_DURATION,
     };
 
+protected:
     static VsyncModulator::TimePoint Now() {
         static VsyncModulator::TimePoint now;
         return now += VsyncModulator::MIN_EARLY_TRANSACTION_TIME;
     }
 
-protected:
     static constexpr auto MIN_EARLY_TRANSACTION_FRAMES =
             VsyncModulator::MIN_EARLY_TRANSACTION_FRAMES;
 
@@ -200,6 +200,37 @@ TEST_F(VsyncModulatorTest, EarlyStartDifferentClients) {
     CHECK_REFRESH(1, kLate, kLate);
 }
 
+TEST_F(VsyncModulatorTest, PredictedEarlyHoldAcrossBursts) {
+    const auto token = sp<BBinder>::make();
+
+    // Teach the modulator the cadence of periodic early-wakeup bursts.
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(kEarly, mVsyncModulator->setTransactionSchedule(Schedule::EarlyStart, token));
+        CHECK_COMMIT(kEarly, kEarly);
+        EXPECT_EQ(kEarly, mVsyncModulator->setTransactionSchedule(Schedule::EarlyEnd, token));
+        CHECK_COMMIT(kEarly, kEarly);
+
+        if (i < 3) {
+            // Idle gap between bursts.
+            for (int j = 0; j < 8; j++) {
+                Now();
+            }
+        }
+    }
+
+    // After the last EarlyEnd the early offsets outlast the usual decay, held for the
+    // predicted next burst...
+    CHECK_REFRESH(MIN_EARLY_TRANSACTION_FRAMES, kEarly, kEarly);
+    CHECK_REFRESH(8, std::nullopt, kEarly);
+
+    // ...until the predicted burst fails to arrive, which ends the hold and counts as a miss.
+    CHECK_REFRESH(1, kLate, kLate);
+
+    std::string dump;
+    mVsyncModulator->dump(dump);
+    EXPECT_TRUE(dump.find("misses=1") != std::string::npos) << dump;
+}
+
 TEST_F(VsyncModulatorTest, EarlyStartWithBinderDeath) {
     const auto token = sp<BBinder>::make();
     EXPECT_EQ(kEarly, mVsyncModulator->setTransactionSchedule(Schedule::EarlyStart, token));
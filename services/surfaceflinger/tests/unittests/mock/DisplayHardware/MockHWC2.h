@@ -40,8 +40,8 @@ public:
     MOCK_METHOD((base::expected<std::shared_ptr<HWC2::Layer>, hal::Error>), createLayer, (),
                 (override));
     MOCK_METHOD(hal::Error, getChangedCompositionTypes,
-                ((std::unordered_map<Layer *,
-                                     aidl::android::hardware::graphics::composer3::Composition> *)),
+                ((std::vector<std::pair<
+                         Layer *, aidl::android::hardware::graphics::composer3::Composition>> *)),
                 (override));
     MOCK_METHOD(hal::Error, getColorModes, (std::vector<hal::ColorMode> *), (const, override));
     MOCK_METHOD(int32_t, getSupportedPerFrameMetadata, (), (const, override));
@@ -51,7 +51,7 @@ public:
                 (override));
     MOCK_METHOD(hal::Error, getName, (std::string *), (const, override));
     MOCK_METHOD(hal::Error, getRequests,
-                (hal::DisplayRequest *, (std::unordered_map<Layer *, hal::LayerRequest> *)),
+                (hal::DisplayRequest *, (std::vector<std::pair<Layer *, hal::LayerRequest>> *)),
                 (override));
     MOCK_METHOD(hal::Error, getConnectionType, (ui::DisplayConnectionType *), (const, override));
     MOCK_METHOD(hal::Error, supportsDoze, (bool *), (const, override));
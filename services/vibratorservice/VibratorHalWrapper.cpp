@@ -187,6 +187,31 @@ HalResult<Capabilities> HalWrapper::getCapabilities() {
 
 HalResult<std::vector<milliseconds>> HalWrapper::getPrimitiveDurations() {
     std::lock_guard<std::mutex> lock(mInfoMutex);
+    loadPrimitiveDurationsLocked();
+    return mInfoCache.mPrimitiveDurations;
+}
+
+milliseconds HalWrapper::getComposedEffectDuration(const std::vector<CompositeEffect>& primitives) {
+    std::lock_guard<std::mutex> lock(mInfoMutex);
+    loadPrimitiveDurationsLocked();
+    const std::vector<milliseconds>* durations =
+            mInfoCache.mPrimitiveDurations.isOk() ? &mInfoCache.mPrimitiveDurations.value()
+                                                  : nullptr;
+    milliseconds duration(0);
+    for (const auto& effect : primitives) {
+        auto primitiveIdx = static_cast<size_t>(effect.primitive);
+        if (durations != nullptr && primitiveIdx < durations->size()) {
+            duration += (*durations)[primitiveIdx];
+        } else {
+            // Make sure the returned duration is positive to indicate successful vibration.
+            duration += milliseconds(1);
+        }
+        duration += milliseconds(effect.delayMs);
+    }
+    return duration;
+}
+
+void HalWrapper::loadPrimitiveDurationsLocked() {
     if (mInfoCache.mSupportedPrimitives.isFailed()) {
         mInfoCache.mSupportedPrimitives = getSupportedPrimitivesInternal();
         if (mInfoCache.mSupportedPrimitives.isUnsupported()) {
@@ -197,7 +222,6 @@ HalResult<std::vector<milliseconds>> HalWrapper::getPrimitiveDurations() {
         mInfoCache.mPrimitiveDurations =
                 getPrimitiveDurationsInternal(mInfoCache.mSupportedPrimitives.value());
     }
-    return mInfoCache.mPrimitiveDurations;
 }
 
 HalResult<std::vector<Effect>> HalWrapper::getSupportedEffectsInternal() {
@@ -343,20 +367,7 @@ HalResult<milliseconds> AidlHalWrapper::performComposedEffect(
         const std::function<void()>& completionCallback) {
     // This method should always support callbacks, so no need to double check.
     auto cb = new HalCallbackWrapper(completionCallback);
-
-    auto durations = getPrimitiveDurations().valueOr({});
-    milliseconds duration(0);
-    for (const auto& effect : primitives) {
-        auto primitiveIdx = static_cast<size_t>(effect.primitive);
-        if (primitiveIdx < durations.size()) {
-            duration += durations[primitiveIdx];
-        } else {
-            // Make sure the returned duration is positive to indicate successful vibration.
-            duration += milliseconds(1);
-        }
-        duration += milliseconds(effect.delayMs);
-    }
-
+    milliseconds duration = getComposedEffectDuration(primitives);
     return HalResult<milliseconds>::fromStatus(getHal()->compose(primitives, cb), duration);
 }
 
@@ -301,6 +301,12 @@ protected:
     HalResult<Capabilities> getCapabilities();
     HalResult<std::vector<std::chrono::milliseconds>> getPrimitiveDurations();
 
+    // Estimate the duration of a composition from the cached primitive durations, without
+    // copying the cached list. Called on the performComposedEffect hot path, which can repeat
+    // the same short composition at high frequency (e.g. keyboard haptics).
+    std::chrono::milliseconds getComposedEffectDuration(
+            const std::vector<hardware::vibrator::CompositeEffect>& primitives);
+
     // Request vibrator info to HAL skipping cache.
     virtual HalResult<Capabilities> getCapabilitiesInternal() = 0;
     virtual HalResult<std::vector<hardware::vibrator::Effect>> getSupportedEffectsInternal();
@@ -322,6 +328,9 @@ protected:
 private:
     std::mutex mInfoMutex;
     InfoCache mInfoCache GUARDED_BY(mInfoMutex);
+
+    // Load the primitive durations into the cache, retrying previous failures.
+    void loadPrimitiveDurationsLocked() REQUIRES(mInfoMutex);
 };
 
 // Wrapper for the AIDL Vibrator HAL.